@@ -22,6 +22,8 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <aspect/blocked_timing/profiler.h>
+#include <aspect/blocked_timing/scheduler.h>
 #include <core/exception.h>
 #include <core/threading/thread.h>
 
@@ -36,6 +38,14 @@ namespace fawkes {
  * Your thread must run in Thread::OPMODE_WAITFORWAKEUP mode, otherwise it
  * is not started. This is a requirement for having the BlockedTimingAspect.
  *
+ * Threads may declare the interfaces they read and write with
+ * blocked_timing_reads() and blocked_timing_writes(), typically in their
+ * constructor. If the main loop runs with a dataflow scheduler, a thread
+ * which declared its data flow is started as soon as the threads of
+ * earlier hooks writing its inputs have finished, rather than waiting
+ * for all threads of all earlier hooks. Threads without declarations are
+ * assumed to read and write everything and therefore run in hook order.
+ *
  * @see Thread::OpMode
  * @ingroup Aspects
  * @author Tim Niemueller
@@ -54,8 +64,12 @@ BlockedTimingAspect::BlockedTimingAspect(WakeupHook wakeup_hook)
                   blocked_timing_hook_to_end_syncpoint(wakeup_hook))
 {
 	add_aspect("BlockedTimingAspect");
-	wakeup_hook_   = wakeup_hook;
-	loop_listener_ = new BlockedTimingLoopListener();
+	wakeup_hook_       = wakeup_hook;
+	loop_listener_     = new BlockedTimingLoopListener();
+	scheduler_         = NULL;
+	profiler_          = NULL;
+	profile_           = NULL;
+	declares_dataflow_ = false;
 }
 
 /** Virtual empty destructor. */
@@ -67,10 +81,23 @@ BlockedTimingAspect::~BlockedTimingAspect()
 /** Init BlockedTiming aspect.
  * This intializes the aspect and adds the loop listener to the thread.
  * @param thread thread which uses this aspect
+ * @param scheduler scheduler which decides when the thread runs, if NULL
+ * the thread waits for the start syncpoint of its wakeup hook
+ * @param profiler profiler which records the timing of each loop, may be NULL
  */
 void
-BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread)
+BlockedTimingAspect::init_BlockedTimingAspect(Thread *                thread,
+                                              BlockedTimingScheduler *scheduler,
+                                              BlockedTimingProfiler * profiler)
 {
+	scheduler_ = scheduler;
+	if (scheduler_) {
+		scheduler_->add_thread(thread, this);
+	}
+	profiler_ = profiler;
+	if (profiler_) {
+		profile_ = profiler_->add_thread(thread, wakeup_hook_);
+	}
 	thread->add_loop_listener(loop_listener_);
 	thread->wakeup();
 }
@@ -83,6 +110,15 @@ void
 BlockedTimingAspect::finalize_BlockedTimingAspect(Thread *thread)
 {
 	thread->remove_loop_listener(loop_listener_);
+	if (scheduler_) {
+		scheduler_->remove_thread(thread, this);
+		scheduler_ = NULL;
+	}
+	if (profiler_) {
+		profiler_->remove_thread(profile_);
+		profiler_ = NULL;
+		profile_  = NULL;
+	}
 }
 
 /** Get the wakeup hook.
@@ -96,6 +132,98 @@ BlockedTimingAspect::blockedTimingAspectHook() const
 	return wakeup_hook_;
 }
 
+/** Declare an input of the thread.
+ * Call this in the constructor of your thread for each interface that
+ * is read in the loop. The dataflow scheduler runs the thread only after
+ * all threads of earlier hooks which write a matching interface.
+ * @param type interface type, may contain shell-like wildcards
+ * @param id interface ID, may contain shell-like wildcards
+ */
+void
+BlockedTimingAspect::blocked_timing_reads(const char *type, const char *id)
+{
+	inputs_.push_back(std::string(type) + "::" + id);
+	declares_dataflow_ = true;
+}
+
+/** Declare an output of the thread.
+ * Call this in the constructor of your thread for each interface that
+ * is written in the loop. A thread which only declares outputs is
+ * considered to depend on no other thread.
+ * @param type interface type, may contain shell-like wildcards
+ * @param id interface ID, may contain shell-like wildcards
+ */
+void
+BlockedTimingAspect::blocked_timing_writes(const char *type, const char *id)
+{
+	outputs_.push_back(std::string(type) + "::" + id);
+	declares_dataflow_ = true;
+}
+
+/** Get declared inputs.
+ * @return list of interface UID patterns (type::id) the thread reads
+ */
+const std::list<std::string> &
+BlockedTimingAspect::blocked_timing_inputs() const
+{
+	return inputs_;
+}
+
+/** Get declared outputs.
+ * @return list of interface UID patterns (type::id) the thread writes
+ */
+const std::list<std::string> &
+BlockedTimingAspect::blocked_timing_outputs() const
+{
+	return outputs_;
+}
+
+/** Check if the thread declared its data flow.
+ * @return true if blocked_timing_reads() or blocked_timing_writes() has
+ * been called, false otherwise
+ */
+bool
+BlockedTimingAspect::blocked_timing_declares_dataflow() const
+{
+	return declares_dataflow_;
+}
+
+/** Wait until the thread may run.
+ * Waits for the scheduler if one is set, for the start syncpoint of
+ * the wakeup hook otherwise. The start of the loop is recorded by the
+ * profiler, if any.
+ * @param thread thread which uses this aspect and whose loop() will be called
+ */
+void
+BlockedTimingAspect::pre_loop(Thread *thread)
+{
+	if (scheduler_) {
+		scheduler_->wait_for_inputs(thread, this);
+	} else {
+		SyncPointAspect::pre_loop(thread);
+	}
+	if (profiler_) {
+		profiler_->loop_started(profile_);
+	}
+}
+
+/** Signal that the loop has finished.
+ * The end syncpoint of the wakeup hook is emitted in any case, such that
+ * other components waiting for it keep working with a scheduler.
+ * @param thread thread which uses this aspect and whose loop() just returned
+ */
+void
+BlockedTimingAspect::post_loop(Thread *thread)
+{
+	if (profiler_) {
+		profiler_->loop_finished(profile_);
+	}
+	if (scheduler_) {
+		scheduler_->outputs_written(thread, this);
+	}
+	SyncPointAspect::post_loop(thread);
+}
+
 /** Get string for wakeup hook.
  * @param hook wakeup hook to get string for
  * @return string representation of hook
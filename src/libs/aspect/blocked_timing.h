@@ -28,11 +28,16 @@
 #include <aspect/syncpoint.h>
 #include <core/threading/thread_loop_listener.h>
 
+#include <list>
 #include <map>
 #include <string>
 
 namespace fawkes {
 
+class BlockedTimingScheduler;
+class BlockedTimingProfiler;
+class BlockedTimingThreadProfile;
+
 /** @class BlockedTimingLoopListener
  * Loop Listener of the BlockedTimingAspect.
  * This loop listener immediately wakes up the thread after loop returned.
@@ -78,19 +83,38 @@ public:
 	static std::string blocked_timing_hook_to_start_syncpoint(WakeupHook hook);
 	static std::string blocked_timing_hook_to_end_syncpoint(WakeupHook hook);
 
-	void init_BlockedTimingAspect(Thread *thread);
+	void init_BlockedTimingAspect(Thread *                thread,
+	                              BlockedTimingScheduler *scheduler = 0,
+	                              BlockedTimingProfiler * profiler  = 0);
 	void finalize_BlockedTimingAspect(Thread *thread);
 
 	WakeupHook blockedTimingAspectHook() const;
 
+	const std::list<std::string> &blocked_timing_inputs() const;
+	const std::list<std::string> &blocked_timing_outputs() const;
+	bool                          blocked_timing_declares_dataflow() const;
+
+	void pre_loop(Thread *thread);
+	void post_loop(Thread *thread);
+
 	/** Translation from WakeupHooks to SyncPoints. Each WakeupHook corresponds to
    *  exactly one SyncPoint, e.g., WAKEUP_HOOK_PRE_LOOP becomes /preloop.
    */
 	static const std::map<const WakeupHook, const std::string> hook_to_syncpoint;
 
+protected:
+	void blocked_timing_reads(const char *type, const char *id = "*");
+	void blocked_timing_writes(const char *type, const char *id = "*");
+
 private:
-	WakeupHook                 wakeup_hook_;
-	BlockedTimingLoopListener *loop_listener_;
+	WakeupHook                  wakeup_hook_;
+	BlockedTimingLoopListener * loop_listener_;
+	BlockedTimingScheduler *    scheduler_;
+	BlockedTimingProfiler *     profiler_;
+	BlockedTimingThreadProfile *profile_;
+	std::list<std::string>      inputs_;
+	std::list<std::string>      outputs_;
+	bool                        declares_dataflow_;
 };
 
 } // end namespace fawkes
@@ -77,6 +77,16 @@ namespace fawkes {
  *
  */
 
+/** Get profiler.
+ * An executor may profile the threads it runs.
+ * @return profiler of the executed threads, NULL if not profiled
+ */
+BlockedTimingProfiler *
+BlockedTimingExecutor::profiler()
+{
+	return NULL;
+}
+
 /** Virtual empty destructor. */
 BlockedTimingExecutor::~BlockedTimingExecutor()
 {
@@ -32,6 +32,7 @@
 namespace fawkes {
 
 class Barrier;
+class BlockedTimingProfiler;
 
 class BlockedTimingExecutor
 {
@@ -47,6 +48,8 @@ public:
 	virtual bool timed_threads_exist()         = 0;
 	virtual void wait_for_timed_threads()      = 0;
 	virtual void interrupt_timed_thread_wait() = 0;
+
+	virtual BlockedTimingProfiler *profiler();
 };
 
 } // end namespace fawkes
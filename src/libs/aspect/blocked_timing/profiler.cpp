@@ -0,0 +1,422 @@
+/***************************************************************************
+ *  profiler.cpp - Always-on profiler for BlockedTimingAspect threads
+ *
+ *  Created: Mon Oct 19 10:02:18 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing/profiler.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+
+#include <algorithm>
+#include <ctime>
+
+namespace fawkes {
+
+/** @class BlockedTimingProfiler <aspect/blocked_timing/profiler.h>
+ * Always-on profiler for threads with the BlockedTimingAspect.
+ * The profiler is owned by the BlockedTimingExecutor and is fed by the
+ * main loop and the timed threads themselves. For every timed thread it
+ * records into histograms:
+ * - the wake-to-start latency, i.e. the time from the start of the
+ *   thread's hook (or the start of the cycle if the thread has been
+ *   started earlier by a dataflow scheduler) until its loop() starts
+ * - the duration of loop()
+ * - the barrier wait, i.e. the time from the end of loop() until all
+ *   threads of the hook have finished. It is recorded when the thread
+ *   is woken up for the next time.
+ * Additionally the duration of each cycle and hook is recorded and
+ * traces of the slowest cycles are kept, listing the threads which ran
+ * longest in these cycles.
+ *
+ * All recording is lock-free, except for adding or removing threads and
+ * for keeping a trace, which only happens if the cycle is one of the
+ * slowest seen so far. The recording methods of the main loop must only
+ * be called by a single thread.
+ * @author Tim Niemueller
+ */
+
+/** @class BlockedTimingThreadProfile <aspect/blocked_timing/profiler.h>
+ * Profile of a single timed thread.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param name name of the thread
+ * @param hook wakeup hook of the thread
+ */
+BlockedTimingThreadProfile::BlockedTimingThreadProfile(const char *                    name,
+                                                       BlockedTimingAspect::WakeupHook hook)
+: name_(name), hook_(hook)
+{
+	loop_start_usec_ = 0;
+	loop_end_usec_   = 0;
+	started_cycle_   = 0;
+	finished_cycle_  = 0;
+}
+
+/** Get thread name.
+ * @return name of the profiled thread
+ */
+const std::string &
+BlockedTimingThreadProfile::name() const
+{
+	return name_;
+}
+
+/** Get wakeup hook.
+ * @return wakeup hook of the profiled thread
+ */
+BlockedTimingAspect::WakeupHook
+BlockedTimingThreadProfile::hook() const
+{
+	return hook_;
+}
+
+/** Get wake-to-start latency.
+ * @return histogram of the time from the thread being released until loop() started
+ */
+const LatencyHistogram &
+BlockedTimingThreadProfile::wake_latency() const
+{
+	return wake_latency_;
+}
+
+/** Get loop time.
+ * @return histogram of the duration of loop()
+ */
+const LatencyHistogram &
+BlockedTimingThreadProfile::loop_time() const
+{
+	return loop_time_;
+}
+
+/** Get barrier wait.
+ * @return histogram of the time from the end of loop() until the hook finished
+ */
+const LatencyHistogram &
+BlockedTimingThreadProfile::barrier_wait() const
+{
+	return barrier_wait_;
+}
+
+/** Constructor.
+ * @param num_traces number of slowest cycles to keep traces for
+ * @param num_trace_threads maximum number of threads listed per trace
+ */
+BlockedTimingProfiler::BlockedTimingProfiler(unsigned int num_traces,
+                                             unsigned int num_trace_threads)
+{
+	mutex_             = new Mutex();
+	num_traces_        = num_traces;
+	num_trace_threads_ = num_trace_threads;
+	traces_min_usec_   = 0;
+
+	cycle_            = 0;
+	cycle_start_usec_ = 0;
+	timerclear(&cycle_start_);
+	for (unsigned int i = 0; i < NUM_HOOKS; ++i) {
+		hook_start_usec_[i]  = 0;
+		hook_start_cycle_[i] = 0;
+		hook_end_usec_[i]    = 0;
+		hook_end_cycle_[i]   = 0;
+	}
+}
+
+/** Destructor. */
+BlockedTimingProfiler::~BlockedTimingProfiler()
+{
+	for (std::list<BlockedTimingThreadProfile *>::iterator i = profiles_.begin();
+	     i != profiles_.end();
+	     ++i) {
+		delete *i;
+	}
+	delete mutex_;
+}
+
+/** Get current time.
+ * @return monotonic time in microseconds
+ */
+uint64_t
+BlockedTimingProfiler::now_usec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/** Add a thread.
+ * Called when the thread is initialized.
+ * @param thread thread to profile
+ * @param hook wakeup hook of the thread
+ * @return profile to pass to loop_started() and loop_finished()
+ */
+BlockedTimingThreadProfile *
+BlockedTimingProfiler::add_thread(Thread *thread, BlockedTimingAspect::WakeupHook hook)
+{
+	BlockedTimingThreadProfile *profile = new BlockedTimingThreadProfile(thread->name(), hook);
+	MutexLocker                 lock(mutex_);
+	profiles_.push_back(profile);
+	return profile;
+}
+
+/** Remove a thread.
+ * Called when the thread is finalized. It must not run anymore.
+ * @param profile profile returned by add_thread(), deleted by this call
+ */
+void
+BlockedTimingProfiler::remove_thread(BlockedTimingThreadProfile *profile)
+{
+	MutexLocker lock(mutex_);
+	profiles_.remove(profile);
+	delete profile;
+}
+
+/** Mark start of a main loop cycle. */
+void
+BlockedTimingProfiler::cycle_started()
+{
+	gettimeofday(&cycle_start_, NULL);
+	__atomic_store_n(&cycle_start_usec_, now_usec(), __ATOMIC_RELAXED);
+	__atomic_add_fetch(&cycle_, 1, __ATOMIC_RELEASE);
+}
+
+/** Mark end of a main loop cycle.
+ * Records the cycle time and keeps a trace if the cycle is one of the
+ * slowest cycles seen so far.
+ */
+void
+BlockedTimingProfiler::cycle_finished()
+{
+	uint64_t now        = now_usec();
+	uint64_t cycle_usec = now - cycle_start_usec_;
+	cycle_time_.record(cycle_usec);
+	if (cycle_usec > __atomic_load_n(&traces_min_usec_, __ATOMIC_RELAXED)) {
+		trace_cycle(now, cycle_usec);
+	}
+}
+
+/** Mark start of a hook.
+ * Must be called before the threads of the hook are woken up.
+ * @param hook hook which is started
+ */
+void
+BlockedTimingProfiler::hook_started(BlockedTimingAspect::WakeupHook hook)
+{
+	__atomic_store_n(&hook_start_usec_[hook], now_usec(), __ATOMIC_RELAXED);
+	__atomic_store_n(&hook_start_cycle_[hook], cycle_, __ATOMIC_RELEASE);
+}
+
+/** Mark end of a hook.
+ * Call when all threads of the hook have finished.
+ * @param hook hook which finished
+ */
+void
+BlockedTimingProfiler::hook_finished(BlockedTimingAspect::WakeupHook hook)
+{
+	uint64_t now = now_usec();
+	__atomic_store_n(&hook_end_usec_[hook], now, __ATOMIC_RELAXED);
+	__atomic_store_n(&hook_end_cycle_[hook], cycle_, __ATOMIC_RELEASE);
+	if (hook_start_cycle_[hook] == cycle_) {
+		hook_time_[hook].record(now - hook_start_usec_[hook]);
+	}
+}
+
+/** Mark start of a thread's loop.
+ * Called by the thread itself right before loop().
+ * @param profile profile of the thread
+ */
+void
+BlockedTimingProfiler::loop_started(BlockedTimingThreadProfile *profile)
+{
+	uint64_t                        now   = now_usec();
+	unsigned int                    cycle = __atomic_load_n(&cycle_, __ATOMIC_ACQUIRE);
+	BlockedTimingAspect::WakeupHook hook  = profile->hook_;
+
+	// the hook has finished in the meantime if the previous loop did not overrun
+	if (profile->loop_end_usec_ > 0
+	    && __atomic_load_n(&hook_end_cycle_[hook], __ATOMIC_ACQUIRE) == profile->finished_cycle_) {
+		uint64_t hook_end = __atomic_load_n(&hook_end_usec_[hook], __ATOMIC_RELAXED);
+		if (hook_end >= profile->loop_end_usec_) {
+			profile->barrier_wait_.record(hook_end - profile->loop_end_usec_);
+		}
+	}
+
+	// a dataflow scheduler may start a thread before its hook is started
+	uint64_t wake;
+	if (__atomic_load_n(&hook_start_cycle_[hook], __ATOMIC_ACQUIRE) == cycle) {
+		wake = __atomic_load_n(&hook_start_usec_[hook], __ATOMIC_RELAXED);
+	} else {
+		wake = __atomic_load_n(&cycle_start_usec_, __ATOMIC_RELAXED);
+	}
+	if (wake > 0 && now >= wake) {
+		profile->wake_latency_.record(now - wake);
+	}
+
+	__atomic_store_n(&profile->loop_start_usec_, now, __ATOMIC_RELAXED);
+	__atomic_store_n(&profile->started_cycle_, cycle, __ATOMIC_RELEASE);
+}
+
+/** Mark end of a thread's loop.
+ * Called by the thread itself right after loop() returned.
+ * @param profile profile of the thread
+ */
+void
+BlockedTimingProfiler::loop_finished(BlockedTimingThreadProfile *profile)
+{
+	uint64_t now = now_usec();
+	profile->loop_time_.record(now - profile->loop_start_usec_);
+	__atomic_store_n(&profile->loop_end_usec_, now, __ATOMIC_RELAXED);
+	__atomic_store_n(&profile->finished_cycle_, profile->started_cycle_, __ATOMIC_RELEASE);
+}
+
+/** Keep trace of the current cycle.
+ * @param now time at which the cycle finished
+ * @param cycle_usec duration of the cycle
+ */
+void
+BlockedTimingProfiler::trace_cycle(uint64_t now, uint64_t cycle_usec)
+{
+	CycleTrace trace;
+	trace.cycle      = cycle_;
+	trace.start      = cycle_start_;
+	trace.cycle_usec = cycle_usec;
+	for (unsigned int i = 0; i < NUM_HOOKS; ++i) {
+		if (hook_start_cycle_[i] == cycle_ && hook_end_cycle_[i] == cycle_) {
+			trace.hook_usec[i] = hook_end_usec_[i] - hook_start_usec_[i];
+		} else {
+			trace.hook_usec[i] = 0;
+		}
+	}
+
+	MutexLocker lock(mutex_);
+	for (std::list<BlockedTimingThreadProfile *>::iterator i = profiles_.begin();
+	     i != profiles_.end();
+	     ++i) {
+		BlockedTimingThreadProfile *p = *i;
+		if (__atomic_load_n(&p->started_cycle_, __ATOMIC_ACQUIRE) != cycle_)
+			continue;
+
+		ThreadSample sample;
+		sample.thread   = p->name_;
+		sample.hook     = p->hook_;
+		sample.finished = (__atomic_load_n(&p->finished_cycle_, __ATOMIC_ACQUIRE) == cycle_);
+		uint64_t start  = __atomic_load_n(&p->loop_start_usec_, __ATOMIC_RELAXED);
+		uint64_t end    = sample.finished ? __atomic_load_n(&p->loop_end_usec_, __ATOMIC_RELAXED) : now;
+		sample.loop_usec = (end >= start) ? end - start : 0;
+		trace.threads.push_back(sample);
+	}
+	std::sort(trace.threads.begin(),
+	          trace.threads.end(),
+	          [](const ThreadSample &a, const ThreadSample &b) { return a.loop_usec > b.loop_usec; });
+	if (trace.threads.size() > num_trace_threads_) {
+		trace.threads.resize(num_trace_threads_);
+	}
+
+	std::list<CycleTrace>::iterator t = traces_.begin();
+	while (t != traces_.end() && t->cycle_usec >= cycle_usec)
+		++t;
+	traces_.insert(t, trace);
+	if (traces_.size() > num_traces_) {
+		traces_.pop_back();
+	}
+	if (traces_.size() == num_traces_) {
+		__atomic_store_n(&traces_min_usec_, traces_.back().cycle_usec, __ATOMIC_RELAXED);
+	}
+}
+
+/** Get number of cycles.
+ * @return number of cycles started since the profiler was created
+ */
+unsigned int
+BlockedTimingProfiler::num_cycles() const
+{
+	return __atomic_load_n(&cycle_, __ATOMIC_RELAXED);
+}
+
+/** Get cycle time histogram.
+ * @return copy of the histogram of main loop cycle durations
+ */
+LatencyHistogram
+BlockedTimingProfiler::cycle_time() const
+{
+	return cycle_time_;
+}
+
+/** Get hook time histogram.
+ * @param hook hook to get the histogram for
+ * @return copy of the histogram of the time from start of the hook until
+ * all of its threads finished
+ */
+LatencyHistogram
+BlockedTimingProfiler::hook_time(BlockedTimingAspect::WakeupHook hook) const
+{
+	return hook_time_[hook];
+}
+
+/** Get profiles of all timed threads.
+ * @return copies of the current thread profiles
+ */
+std::list<BlockedTimingThreadProfile>
+BlockedTimingProfiler::thread_profiles() const
+{
+	std::list<BlockedTimingThreadProfile> rv;
+	MutexLocker                           lock(mutex_);
+	for (std::list<BlockedTimingThreadProfile *>::const_iterator i = profiles_.begin();
+	     i != profiles_.end();
+	     ++i) {
+		rv.push_back(**i);
+	}
+	return rv;
+}
+
+/** Get traces of the slowest cycles.
+ * @return traces of the slowest cycles, slowest first
+ */
+std::list<BlockedTimingProfiler::CycleTrace>
+BlockedTimingProfiler::worst_cycles() const
+{
+	MutexLocker lock(mutex_);
+	return traces_;
+}
+
+/** Reset all histograms and traces.
+ * For example to discard the startup phase.
+ */
+void
+BlockedTimingProfiler::reset()
+{
+	MutexLocker lock(mutex_);
+	cycle_time_.reset();
+	for (unsigned int i = 0; i < NUM_HOOKS; ++i) {
+		hook_time_[i].reset();
+	}
+	for (std::list<BlockedTimingThreadProfile *>::iterator i = profiles_.begin();
+	     i != profiles_.end();
+	     ++i) {
+		(*i)->wake_latency_.reset();
+		(*i)->loop_time_.reset();
+		(*i)->barrier_wait_.reset();
+	}
+	traces_.clear();
+	__atomic_store_n(&traces_min_usec_, 0, __ATOMIC_RELAXED);
+}
+
+} // end namespace fawkes
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *  profiler.h - Always-on profiler for BlockedTimingAspect threads
+ *
+ *  Created: Mon Oct 19 10:02:18 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_BLOCKED_TIMING_PROFILER_H_
+#define _ASPECT_BLOCKED_TIMING_PROFILER_H_
+
+#include <aspect/blocked_timing.h>
+#include <utils/time/latency_histogram.h>
+
+#include <sys/time.h>
+
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class Thread;
+
+class BlockedTimingThreadProfile
+{
+public:
+	BlockedTimingThreadProfile(const char *name, BlockedTimingAspect::WakeupHook hook);
+
+	const std::string &             name() const;
+	BlockedTimingAspect::WakeupHook hook() const;
+
+	const LatencyHistogram &wake_latency() const;
+	const LatencyHistogram &loop_time() const;
+	const LatencyHistogram &barrier_wait() const;
+
+private:
+	friend class BlockedTimingProfiler;
+
+	std::string                     name_;
+	BlockedTimingAspect::WakeupHook hook_;
+
+	LatencyHistogram wake_latency_;
+	LatencyHistogram loop_time_;
+	LatencyHistogram barrier_wait_;
+
+	uint64_t     loop_start_usec_;
+	uint64_t     loop_end_usec_;
+	unsigned int started_cycle_;
+	unsigned int finished_cycle_;
+};
+
+class BlockedTimingProfiler
+{
+public:
+	/** Number of wakeup hooks. */
+	static const unsigned int NUM_HOOKS = BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP + 1;
+
+	/** Loop of a single thread within a traced cycle. */
+	typedef struct
+	{
+		std::string                     thread;    /**< thread name */
+		BlockedTimingAspect::WakeupHook hook;      /**< wakeup hook of the thread */
+		uint64_t                        loop_usec; /**< loop() duration in usec */
+		bool                            finished;  /**< false if still running at cycle end */
+	} ThreadSample;
+
+	/** Trace of one of the slowest main loop cycles. */
+	typedef struct
+	{
+		unsigned int              cycle;                /**< cycle number */
+		struct timeval            start;                /**< wall clock time of cycle start */
+		uint64_t                  cycle_usec;           /**< duration of the cycle in usec */
+		uint64_t                  hook_usec[NUM_HOOKS]; /**< duration of each hook in usec */
+		std::vector<ThreadSample> threads;              /**< slowest threads, slowest first */
+	} CycleTrace;
+
+	BlockedTimingProfiler(unsigned int num_traces = 10, unsigned int num_trace_threads = 10);
+	~BlockedTimingProfiler();
+
+	BlockedTimingThreadProfile *add_thread(Thread *thread, BlockedTimingAspect::WakeupHook hook);
+	void                        remove_thread(BlockedTimingThreadProfile *profile);
+
+	void cycle_started();
+	void cycle_finished();
+	void hook_started(BlockedTimingAspect::WakeupHook hook);
+	void hook_finished(BlockedTimingAspect::WakeupHook hook);
+
+	void loop_started(BlockedTimingThreadProfile *profile);
+	void loop_finished(BlockedTimingThreadProfile *profile);
+
+	unsigned int                          num_cycles() const;
+	LatencyHistogram                      cycle_time() const;
+	LatencyHistogram                      hook_time(BlockedTimingAspect::WakeupHook hook) const;
+	std::list<BlockedTimingThreadProfile> thread_profiles() const;
+	std::list<CycleTrace>                 worst_cycles() const;
+
+	void reset();
+
+	static uint64_t now_usec();
+
+private:
+	void trace_cycle(uint64_t now, uint64_t cycle_usec);
+
+private:
+	Mutex *mutex_;
+
+	unsigned int num_traces_;
+	unsigned int num_trace_threads_;
+
+	std::list<BlockedTimingThreadProfile *> profiles_;
+	std::list<CycleTrace>                   traces_;
+	uint64_t                                traces_min_usec_;
+
+	unsigned int     cycle_;
+	uint64_t         cycle_start_usec_;
+	struct timeval   cycle_start_;
+	LatencyHistogram cycle_time_;
+
+	uint64_t         hook_start_usec_[NUM_HOOKS];
+	unsigned int     hook_start_cycle_[NUM_HOOKS];
+	uint64_t         hook_end_usec_[NUM_HOOKS];
+	unsigned int     hook_end_cycle_[NUM_HOOKS];
+	LatencyHistogram hook_time_[NUM_HOOKS];
+};
+
+} // end namespace fawkes
+
+#endif
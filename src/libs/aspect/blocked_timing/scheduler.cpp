@@ -0,0 +1,71 @@
+
+/***************************************************************************
+ *  scheduler.cpp - Interface to schedule BlockedTimingAspect threads
+ *
+ *  Created: Sun Oct 18 21:04:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing/scheduler.h>
+
+namespace fawkes {
+
+/** @class BlockedTimingScheduler <aspect/blocked_timing/scheduler.h>
+ * Blocked timing scheduler.
+ * By default threads with the BlockedTimingAspect wait for the start
+ * syncpoint of their wakeup hook, such that all threads of a hook run
+ * after all threads of the previous hooks have finished. If a scheduler
+ * is set, threads instead ask the scheduler when to run. This allows for
+ * example to run a thread as soon as the threads that write the
+ * interfaces it reads have finished.
+ * @author Tim Niemueller
+ *
+ * @fn void BlockedTimingScheduler::add_thread(Thread *thread, BlockedTimingAspect *aspect)
+ * Add a thread to the schedule.
+ * Called when the thread is initialized. The thread is run for the
+ * first time in the cycle following the call.
+ * @param thread thread to add
+ * @param aspect blocked timing aspect of the thread
+ *
+ * @fn void BlockedTimingScheduler::remove_thread(Thread *thread, BlockedTimingAspect *aspect)
+ * Remove a thread from the schedule.
+ * Called when the thread is finalized, it has already been stopped.
+ * @param thread thread to remove
+ * @param aspect blocked timing aspect of the thread
+ *
+ * @fn void BlockedTimingScheduler::wait_for_inputs(Thread *thread, BlockedTimingAspect *aspect)
+ * Wait until the thread may run.
+ * Called by the thread itself before each loop. Blocks until the
+ * scheduler decides that the thread runs in the current cycle.
+ * @param thread thread about to run its loop
+ * @param aspect blocked timing aspect of the thread
+ *
+ * @fn void BlockedTimingScheduler::outputs_written(Thread *thread, BlockedTimingAspect *aspect)
+ * Notify that the thread finished its loop.
+ * Called by the thread itself after each loop. Threads depending on
+ * the data written by the thread may be started.
+ * @param thread thread whose loop just returned
+ * @param aspect blocked timing aspect of the thread
+ */
+
+/** Virtual empty destructor. */
+BlockedTimingScheduler::~BlockedTimingScheduler()
+{
+}
+
+} // end namespace fawkes
@@ -0,0 +1,46 @@
+
+/***************************************************************************
+ *  scheduler.h - Interface to schedule BlockedTimingAspect threads
+ *
+ *  Created: Sun Oct 18 21:04:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_BLOCKED_TIMING_SCHEDULER_H_
+#define _ASPECT_BLOCKED_TIMING_SCHEDULER_H_
+
+namespace fawkes {
+
+class Thread;
+class BlockedTimingAspect;
+
+class BlockedTimingScheduler
+{
+public:
+	virtual ~BlockedTimingScheduler();
+
+	virtual void add_thread(Thread *thread, BlockedTimingAspect *aspect) = 0;
+	virtual void remove_thread(Thread *thread, BlockedTimingAspect *aspect) = 0;
+
+	virtual void wait_for_inputs(Thread *thread, BlockedTimingAspect *aspect)  = 0;
+	virtual void outputs_written(Thread *thread, BlockedTimingAspect *aspect) = 0;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,64 @@
+
+/***************************************************************************
+ *  blocked_timing_profiler.cpp - Aspect to access the main loop profiler
+ *
+ *  Created: Mon Oct 19 11:31:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing_profiler.h>
+
+namespace fawkes {
+
+/** @class BlockedTimingProfilerAspect <aspect/blocked_timing_profiler.h>
+ * Thread aspect to access the main loop profiler.
+ * Give this aspect to your thread to read the timing statistics which
+ * are recorded for all threads with the BlockedTimingAspect.
+ *
+ * @ingroup Aspects
+ * @author Tim Niemueller
+ */
+
+/** @var BlockedTimingProfiler *BlockedTimingProfilerAspect::blocked_timing_profiler
+ * Profiler of the main loop. It is set when the thread starts.
+ */
+
+/** Constructor. */
+BlockedTimingProfilerAspect::BlockedTimingProfilerAspect()
+{
+	add_aspect("BlockedTimingProfilerAspect");
+	blocked_timing_profiler = 0;
+}
+
+/** Virtual empty destructor. */
+BlockedTimingProfilerAspect::~BlockedTimingProfilerAspect()
+{
+}
+
+/** Init profiler aspect.
+ * This sets the profiler. It is guaranteed that this is called for a
+ * BlockedTimingProfilerAspect thread before Thread::start() is called.
+ * @param profiler main loop profiler
+ */
+void
+BlockedTimingProfilerAspect::init_BlockedTimingProfilerAspect(BlockedTimingProfiler *profiler)
+{
+	blocked_timing_profiler = profiler;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,46 @@
+
+/***************************************************************************
+ *  blocked_timing_profiler.h - Aspect to access the main loop profiler
+ *
+ *  Created: Mon Oct 19 11:31:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_BLOCKED_TIMING_PROFILER_ASPECT_H_
+#define _ASPECT_BLOCKED_TIMING_PROFILER_ASPECT_H_
+
+#include <aspect/aspect.h>
+#include <aspect/blocked_timing/profiler.h>
+
+namespace fawkes {
+
+class BlockedTimingProfilerAspect : public virtual Aspect
+{
+public:
+	BlockedTimingProfilerAspect();
+	virtual ~BlockedTimingProfilerAspect();
+
+	void init_BlockedTimingProfilerAspect(BlockedTimingProfiler *profiler);
+
+protected:
+	BlockedTimingProfiler *blocked_timing_profiler;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -32,9 +32,17 @@ namespace fawkes {
  * @author Tim Niemueller
  */
 
-/** Constructor. */
-BlockedTimingAspectIniFin::BlockedTimingAspectIniFin() : AspectIniFin("BlockedTimingAspect")
+/** Constructor.
+ * @param scheduler scheduler passed to initialized threads, if NULL
+ * threads are woken up by the start syncpoint of their hook
+ * @param profiler profiler passed to initialized threads, may be NULL
+ */
+BlockedTimingAspectIniFin::BlockedTimingAspectIniFin(BlockedTimingScheduler *scheduler,
+                                                     BlockedTimingProfiler * profiler)
+: AspectIniFin("BlockedTimingAspect")
 {
+	scheduler_ = scheduler;
+	profiler_  = profiler;
 }
 
 void
@@ -56,7 +64,7 @@ BlockedTimingAspectIniFin::init(Thread *thread)
 		                                      thread->name());
 	}
 
-	blocked_timing_thread->init_BlockedTimingAspect(thread);
+	blocked_timing_thread->init_BlockedTimingAspect(thread, scheduler_, profiler_);
 }
 
 void
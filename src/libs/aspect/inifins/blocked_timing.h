@@ -28,13 +28,21 @@
 
 namespace fawkes {
 
+class BlockedTimingScheduler;
+class BlockedTimingProfiler;
+
 class BlockedTimingAspectIniFin : public AspectIniFin
 {
 public:
-	BlockedTimingAspectIniFin();
+	BlockedTimingAspectIniFin(BlockedTimingScheduler *scheduler = 0,
+	                          BlockedTimingProfiler * profiler  = 0);
 
 	virtual void init(Thread *thread);
 	virtual void finalize(Thread *thread);
+
+private:
+	BlockedTimingScheduler *scheduler_;
+	BlockedTimingProfiler * profiler_;
 };
 
 } // end namespace fawkes
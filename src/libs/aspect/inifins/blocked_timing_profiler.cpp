@@ -0,0 +1,71 @@
+
+/***************************************************************************
+ *  blocked_timing_profiler.cpp - BlockedTimingProfilerAspect initializer/finalizer
+ *
+ *  Created: Mon Oct 19 11:38:47 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing_profiler.h>
+#include <aspect/inifins/blocked_timing_profiler.h>
+
+namespace fawkes {
+
+/** @class BlockedTimingProfilerAspectIniFin <aspect/inifins/blocked_timing_profiler.h>
+ * Initializer/finalizer for the BlockedTimingProfilerAspect.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param profiler main loop profiler to pass to threads, if NULL
+ * threads with the aspect cannot be initialized
+ */
+BlockedTimingProfilerAspectIniFin::BlockedTimingProfilerAspectIniFin(
+  BlockedTimingProfiler *profiler)
+: AspectIniFin("BlockedTimingProfilerAspect")
+{
+	profiler_ = profiler;
+}
+
+void
+BlockedTimingProfilerAspectIniFin::init(Thread *thread)
+{
+	BlockedTimingProfilerAspect *profiler_thread;
+	profiler_thread = dynamic_cast<BlockedTimingProfilerAspect *>(thread);
+	if (profiler_thread == NULL) {
+		throw CannotInitializeThreadException("Thread '%s' claims to have the "
+		                                      "BlockedTimingProfilerAspect, but RTTI says it "
+		                                      "has not. ",
+		                                      thread->name());
+	}
+
+	if (profiler_ == NULL) {
+		throw CannotInitializeThreadException("Thread '%s' has the BlockedTimingProfilerAspect, "
+		                                      "but the main loop is not profiled",
+		                                      thread->name());
+	}
+
+	profiler_thread->init_BlockedTimingProfilerAspect(profiler_);
+}
+
+void
+BlockedTimingProfilerAspectIniFin::finalize(Thread *thread)
+{
+}
+
+} // end namespace fawkes
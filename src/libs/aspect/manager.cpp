@@ -21,9 +21,11 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <aspect/blocked_timing/executor.h>
 #include <aspect/inifins/aspect_provider.h>
 #include <aspect/inifins/blackboard.h>
 #include <aspect/inifins/blocked_timing.h>
+#include <aspect/inifins/blocked_timing_profiler.h>
 #include <aspect/inifins/clock.h>
 #include <aspect/inifins/configurable.h>
 #include <aspect/inifins/fawkes_network.h>
@@ -215,37 +217,43 @@ AspectManager::prepare_finalize(Thread *thread)
  * @param fnethub Fawkes network hub for FawkesNetworkAspect
  * @param mloop_employer Main loop employer for MainLoopAspect
  * @param logger_employer logger employer for LoggerAspect
- * @param btexec blocked timing executor for MainLoopAspect
+ * @param btexec blocked timing executor for MainLoopAspect, its profiler is
+ * passed to BlockedTimingAspect and BlockedTimingProfilerAspect threads
  * @param nnresolver network name resolver for NetworkAspect
  * @param service_publisher service publisher for NetworkAspect
  * @param service_browser service browser for NetworkAspect
  * @param pmanager plugin manager for PluginDirectorAspect
  * @param tf_listener transformer for TransformAspect
  * @param syncpoint_manager manager for SyncPointManagerAspect
+ * @param btsched scheduler for BlockedTimingAspect threads, NULL to wake
+ * them in hook order
  */
 void
-AspectManager::register_default_inifins(BlackBoard *           blackboard,
-                                        ThreadCollector *      collector,
-                                        Configuration *        config,
-                                        Logger *               logger,
-                                        Clock *                clock,
-                                        FawkesNetworkHub *     fnethub,
-                                        MainLoopEmployer *     mloop_employer,
-                                        LoggerEmployer *       logger_employer,
-                                        BlockedTimingExecutor *btexec,
-                                        NetworkNameResolver *  nnresolver,
-                                        ServicePublisher *     service_publisher,
-                                        ServiceBrowser *       service_browser,
-                                        PluginManager *        pmanager,
-                                        tf::Transformer *      tf_listener,
-                                        SyncPointManager *     syncpoint_manager)
+AspectManager::register_default_inifins(BlackBoard *            blackboard,
+                                        ThreadCollector *       collector,
+                                        Configuration *         config,
+                                        Logger *                logger,
+                                        Clock *                 clock,
+                                        FawkesNetworkHub *      fnethub,
+                                        MainLoopEmployer *      mloop_employer,
+                                        LoggerEmployer *        logger_employer,
+                                        BlockedTimingExecutor * btexec,
+                                        NetworkNameResolver *   nnresolver,
+                                        ServicePublisher *      service_publisher,
+                                        ServiceBrowser *        service_browser,
+                                        PluginManager *         pmanager,
+                                        tf::Transformer *       tf_listener,
+                                        SyncPointManager *      syncpoint_manager,
+                                        BlockedTimingScheduler *btsched)
 {
 	if (!default_inifins_.empty())
 		return;
 
+	BlockedTimingProfiler *btprof = btexec ? btexec->profiler() : NULL;
+
 	AspectProviderAspectIniFin *prov_aif   = new AspectProviderAspectIniFin(this);
 	BlackBoardAspectIniFin *    bb_aif     = new BlackBoardAspectIniFin(blackboard);
-	BlockedTimingAspectIniFin * bt_aif     = new BlockedTimingAspectIniFin();
+	BlockedTimingAspectIniFin * bt_aif     = new BlockedTimingAspectIniFin(btsched, btprof);
 	ClockAspectIniFin *         clock_aif  = new ClockAspectIniFin(clock);
 	ConfigurableAspectIniFin *  conf_aif   = new ConfigurableAspectIniFin(config);
 	FawkesNetworkAspectIniFin * fnet_aif   = new FawkesNetworkAspectIniFin(fnethub);
@@ -261,6 +269,8 @@ AspectManager::register_default_inifins(BlackBoard *           blackboard,
 	VisionAspectIniFin *          vis_aif  = new VisionAspectIniFin(vm_aif);
 	SyncPointManagerAspectIniFin *spm_aif  = new SyncPointManagerAspectIniFin(syncpoint_manager);
 	SyncPointAspectIniFin *       sp_aif   = new SyncPointAspectIniFin(syncpoint_manager);
+
+	BlockedTimingProfilerAspectIniFin *btp_aif = new BlockedTimingProfilerAspectIniFin(btprof);
 #ifdef HAVE_WEBVIEW
 	WebviewAspectIniFin *web_aif = new WebviewAspectIniFin();
 #endif
@@ -288,6 +298,7 @@ AspectManager::register_default_inifins(BlackBoard *           blackboard,
 	default_inifins_[vis_aif->get_aspect_name()]    = vis_aif;
 	default_inifins_[spm_aif->get_aspect_name()]    = spm_aif;
 	default_inifins_[sp_aif->get_aspect_name()]     = sp_aif;
+	default_inifins_[btp_aif->get_aspect_name()]    = btp_aif;
 #ifdef HAVE_WEBVIEW
 	default_inifins_[web_aif->get_aspect_name()] = web_aif;
 #endif
@@ -54,6 +54,7 @@ private:
 	bool                  has_output_syncpoint_;
 	RefPtr<SyncPoint>     sp_in_;
 	RefPtr<SyncPoint>     sp_out_;
+	unsigned int          component_id_;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,408 @@
+
+/***************************************************************************
+ *  dataflow_scheduler.cpp - Dependency-graph scheduler for timed threads
+ *
+ *  Created: Sun Oct 18 21:27:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <baseapp/dataflow_scheduler.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+
+#include <fnmatch.h>
+#include <pthread.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static bool
+glob_match(const std::string &a, const std::string &b)
+{
+	return (fnmatch(a.c_str(), b.c_str(), 0) == 0) || (fnmatch(b.c_str(), a.c_str(), 0) == 0);
+}
+
+static void
+add_usec(struct timespec &ts, unsigned int usec)
+{
+	ts.tv_sec += usec / 1000000;
+	ts.tv_nsec += (usec % 1000000) * 1000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec += 1;
+		ts.tv_nsec -= 1000000000;
+	}
+}
+/// @endcond
+
+/** @class DataflowScheduler <baseapp/dataflow_scheduler.h>
+ * Dependency-graph scheduler for threads with the BlockedTimingAspect.
+ * Instead of running all threads of a hook only after all threads of
+ * all earlier hooks have finished, a thread is started as soon as the
+ * threads it depends on have finished in the current cycle.
+ *
+ * A thread depends on a thread of an earlier hook if the latter writes
+ * an interface the former reads, as declared with
+ * BlockedTimingAspect::blocked_timing_reads() and
+ * BlockedTimingAspect::blocked_timing_writes(). Threads which did not
+ * declare their data flow are assumed to read and write everything.
+ * Threads of the same hook never depend on each other, they run in
+ * parallel just as with the barrier-based main loop. Since dependencies
+ * only point from earlier to later hooks, the graph is acyclic.
+ *
+ * The graph is rebuilt at the start of a cycle if threads have been added
+ * or removed. The main thread starts a cycle with start_cycle(), then
+ * waits for the hooks in order with wait_for_hook() to keep emitting the
+ * hook syncpoints. If the cycle deadline passes, release_hooks() starts
+ * the remaining threads in hook order regardless of their dependencies.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+DataflowScheduler::DataflowScheduler()
+{
+	mutex_         = new Mutex();
+	hook_waitcond_ = new WaitCondition(mutex_);
+
+	graph_dirty_        = false;
+	num_dependencies_   = 0;
+	cycle_              = 0;
+	cycle_has_deadline_ = false;
+	for (unsigned int i = 0; i <= BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP; ++i) {
+		hook_remaining_[i] = 0;
+	}
+}
+
+/** Destructor. */
+DataflowScheduler::~DataflowScheduler()
+{
+	for (std::vector<Node *>::iterator n = nodes_.begin(); n != nodes_.end(); ++n) {
+		delete (*n)->waitcond;
+		delete *n;
+	}
+	delete hook_waitcond_;
+	delete mutex_;
+}
+
+void
+DataflowScheduler::add_thread(Thread *thread, BlockedTimingAspect *aspect)
+{
+	MutexLocker lock(mutex_);
+
+	Node *node             = new Node();
+	node->thread           = thread;
+	node->aspect           = aspect;
+	node->hook             = aspect->blockedTimingAspectHook();
+	node->num_dependencies = 0;
+	node->remaining        = 0;
+	// the thread takes part from the next cycle on
+	node->dispatched_cycle = cycle_;
+	node->run_cycle        = cycle_;
+	node->done             = true;
+	node->removed          = false;
+	node->waitcond         = new WaitCondition(mutex_);
+
+	nodes_.push_back(node);
+	node_map_[aspect] = node;
+	graph_dirty_      = true;
+}
+
+void
+DataflowScheduler::remove_thread(Thread *thread, BlockedTimingAspect *aspect)
+{
+	MutexLocker                                      lock(mutex_);
+	std::map<BlockedTimingAspect *, Node *>::iterator n = node_map_.find(aspect);
+	if (n == node_map_.end())
+		return;
+
+	Node *node = n->second;
+	// do not leave the threads depending on this one waiting
+	complete(node);
+	node->removed = true;
+	node_map_.erase(n);
+	// the node itself is deleted when the graph is rebuilt
+	graph_dirty_ = true;
+}
+
+void
+DataflowScheduler::wait_for_inputs(Thread *thread, BlockedTimingAspect *aspect)
+{
+	mutex_->lock();
+	std::map<BlockedTimingAspect *, Node *>::iterator n = node_map_.find(aspect);
+	if (n == node_map_.end()) {
+		mutex_->unlock();
+		return;
+	}
+	Node *node = n->second;
+
+	pthread_cleanup_push(cleanup_mutex, mutex_);
+	while (node->dispatched_cycle == node->run_cycle) {
+		node->waitcond->wait();
+	}
+	pthread_cleanup_pop(0);
+	node->run_cycle = node->dispatched_cycle;
+	mutex_->unlock();
+}
+
+void
+DataflowScheduler::outputs_written(Thread *thread, BlockedTimingAspect *aspect)
+{
+	MutexLocker                                      lock(mutex_);
+	std::map<BlockedTimingAspect *, Node *>::iterator n = node_map_.find(aspect);
+	// a thread that overran finishes a previous cycle, it is dispatched
+	// again once its inputs of the current cycle are ready
+	if (n != node_map_.end() && n->second->run_cycle == cycle_) {
+		complete(n->second);
+	}
+}
+
+/** Start a new cycle.
+ * Rebuilds the dependency graph if threads have been added or removed and
+ * starts all threads that do not depend on any other thread.
+ * @param deadline_usec time in microseconds after which wait_for_hook()
+ * returns false, 0 to wait forever
+ */
+void
+DataflowScheduler::start_cycle(unsigned int deadline_usec)
+{
+	MutexLocker lock(mutex_);
+	if (graph_dirty_) {
+		rebuild_graph();
+	}
+
+	cycle_ += 1;
+	cycle_has_deadline_ = (deadline_usec > 0);
+	if (cycle_has_deadline_) {
+		clock_gettime(CLOCK_REALTIME, &cycle_deadline_);
+		add_usec(cycle_deadline_, deadline_usec);
+	}
+
+	for (unsigned int i = 0; i <= BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP; ++i) {
+		hook_remaining_[i] = 0;
+	}
+	for (std::vector<Node *>::iterator n = nodes_.begin(); n != nodes_.end(); ++n) {
+		(*n)->done      = false;
+		(*n)->remaining = (*n)->num_dependencies;
+		hook_remaining_[(*n)->hook] += 1;
+	}
+	for (std::vector<Node *>::iterator n = nodes_.begin(); n != nodes_.end(); ++n) {
+		if ((*n)->remaining == 0) {
+			dispatch(*n);
+		}
+	}
+}
+
+/** Wait until all threads up to the given hook have finished.
+ * Waits at most until the deadline given to start_cycle().
+ * @param hook last hook whose threads must have finished
+ * @return true if all threads of the given and all earlier hooks have
+ * finished, false if the cycle deadline has passed
+ */
+bool
+DataflowScheduler::wait_for_hook(BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(mutex_);
+	if (!cycle_has_deadline_) {
+		while (!hooks_done(hook)) {
+			hook_waitcond_->wait();
+		}
+		return true;
+	}
+	return wait_until(hook, cycle_deadline_);
+}
+
+/** Wait until all threads up to the given hook have finished.
+ * @param hook last hook whose threads must have finished
+ * @param timeout_usec maximum time to wait in microseconds
+ * @return true if all threads of the given and all earlier hooks have
+ * finished, false if the timeout has been reached
+ */
+bool
+DataflowScheduler::wait_for_hook(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
+{
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	add_usec(deadline, timeout_usec);
+
+	MutexLocker lock(mutex_);
+	return wait_until(hook, deadline);
+}
+
+/** Start threads regardless of their dependencies.
+ * All threads of the given and earlier hooks which have not been started
+ * in the current cycle are started now. This is used to fall back to the
+ * hook order if a cycle misses its deadline.
+ * @param hook last hook whose threads to start
+ */
+void
+DataflowScheduler::release_hooks(BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(mutex_);
+	for (std::vector<Node *>::iterator n = nodes_.begin(); n != nodes_.end(); ++n) {
+		if (((*n)->hook <= hook) && !(*n)->done && ((*n)->dispatched_cycle != cycle_)) {
+			dispatch(*n);
+		}
+	}
+}
+
+/** Get number of scheduled threads.
+ * @return number of threads taking part in the current cycle
+ */
+unsigned int
+DataflowScheduler::num_threads()
+{
+	MutexLocker lock(mutex_);
+	return node_map_.size();
+}
+
+/** Get number of dependencies.
+ * @return number of edges in the dependency graph of the current cycle
+ */
+unsigned int
+DataflowScheduler::num_dependencies()
+{
+	MutexLocker lock(mutex_);
+	return num_dependencies_;
+}
+
+/** Check if two interface UID patterns may refer to the same interface.
+ * Both patterns have the form type::id and may contain shell-like
+ * wildcards. Type and ID are compared separately, each matches if either
+ * pattern matches the other one. This is exact if at most one of them
+ * contains wildcards, and errs towards a dependency otherwise.
+ * @param pattern_a first pattern
+ * @param pattern_b second pattern
+ * @return true if the patterns match
+ */
+bool
+DataflowScheduler::uid_patterns_match(const std::string &pattern_a, const std::string &pattern_b)
+{
+	std::string::size_type sep_a = pattern_a.find("::");
+	std::string::size_type sep_b = pattern_b.find("::");
+	if (sep_a == std::string::npos || sep_b == std::string::npos) {
+		return glob_match(pattern_a, pattern_b);
+	}
+
+	return glob_match(pattern_a.substr(0, sep_a), pattern_b.substr(0, sep_b))
+	       && glob_match(pattern_a.substr(sep_a + 2), pattern_b.substr(sep_b + 2));
+}
+
+bool
+DataflowScheduler::depends_on(const Node *reader, const Node *writer)
+{
+	if (writer->hook >= reader->hook)
+		return false;
+
+	if (!reader->aspect->blocked_timing_declares_dataflow()
+	    || !writer->aspect->blocked_timing_declares_dataflow()) {
+		return true;
+	}
+
+	const std::list<std::string> &inputs  = reader->aspect->blocked_timing_inputs();
+	const std::list<std::string> &outputs = writer->aspect->blocked_timing_outputs();
+	for (std::list<std::string>::const_iterator i = inputs.begin(); i != inputs.end(); ++i) {
+		for (std::list<std::string>::const_iterator o = outputs.begin(); o != outputs.end(); ++o) {
+			if (uid_patterns_match(*i, *o))
+				return true;
+		}
+	}
+	return false;
+}
+
+void
+DataflowScheduler::rebuild_graph()
+{
+	std::vector<Node *> nodes;
+	for (std::vector<Node *>::iterator n = nodes_.begin(); n != nodes_.end(); ++n) {
+		if ((*n)->removed) {
+			delete (*n)->waitcond;
+			delete *n;
+		} else {
+			(*n)->dependents.clear();
+			(*n)->num_dependencies = 0;
+			nodes.push_back(*n);
+		}
+	}
+	nodes_.swap(nodes);
+
+	num_dependencies_ = 0;
+	for (std::vector<Node *>::iterator r = nodes_.begin(); r != nodes_.end(); ++r) {
+		for (std::vector<Node *>::iterator w = nodes_.begin(); w != nodes_.end(); ++w) {
+			if (depends_on(*r, *w)) {
+				(*w)->dependents.push_back(*r);
+				(*r)->num_dependencies += 1;
+				num_dependencies_ += 1;
+			}
+		}
+	}
+	graph_dirty_ = false;
+}
+
+void
+DataflowScheduler::dispatch(Node *node)
+{
+	node->dispatched_cycle = cycle_;
+	node->waitcond->wake_all();
+}
+
+void
+DataflowScheduler::complete(Node *node)
+{
+	if (node->done)
+		return;
+
+	node->done = true;
+	for (std::vector<Node *>::iterator d = node->dependents.begin(); d != node->dependents.end();
+	     ++d) {
+		Node *dep = *d;
+		if (dep->removed || dep->done || dep->remaining == 0)
+			continue;
+		dep->remaining -= 1;
+		if (dep->remaining == 0 && dep->dispatched_cycle != cycle_) {
+			dispatch(dep);
+		}
+	}
+
+	hook_remaining_[node->hook] -= 1;
+	if (hook_remaining_[node->hook] == 0) {
+		hook_waitcond_->wake_all();
+	}
+}
+
+bool
+DataflowScheduler::hooks_done(BlockedTimingAspect::WakeupHook hook) const
+{
+	for (unsigned int i = 0; i <= (unsigned int)hook; ++i) {
+		if (hook_remaining_[i] > 0)
+			return false;
+	}
+	return true;
+}
+
+bool
+DataflowScheduler::wait_until(BlockedTimingAspect::WakeupHook hook, const struct timespec &deadline)
+{
+	while (!hooks_done(hook)) {
+		if (!hook_waitcond_->abstimed_wait(deadline.tv_sec, deadline.tv_nsec)) {
+			return hooks_done(hook);
+		}
+	}
+	return true;
+}
+
+} // end namespace fawkes
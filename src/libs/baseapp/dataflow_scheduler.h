@@ -0,0 +1,103 @@
+
+/***************************************************************************
+ *  dataflow_scheduler.h - Dependency-graph scheduler for timed threads
+ *
+ *  Created: Sun Oct 18 21:27:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_DATAFLOW_SCHEDULER_H_
+#define _LIBS_BASEAPP_DATAFLOW_SCHEDULER_H_
+
+#include <aspect/blocked_timing.h>
+#include <aspect/blocked_timing/scheduler.h>
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+
+class DataflowScheduler : public BlockedTimingScheduler
+{
+public:
+	DataflowScheduler();
+	virtual ~DataflowScheduler();
+
+	virtual void add_thread(Thread *thread, BlockedTimingAspect *aspect);
+	virtual void remove_thread(Thread *thread, BlockedTimingAspect *aspect);
+	virtual void wait_for_inputs(Thread *thread, BlockedTimingAspect *aspect);
+	virtual void outputs_written(Thread *thread, BlockedTimingAspect *aspect);
+
+	void start_cycle(unsigned int deadline_usec);
+	bool wait_for_hook(BlockedTimingAspect::WakeupHook hook);
+	bool wait_for_hook(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec);
+	void release_hooks(BlockedTimingAspect::WakeupHook hook);
+
+	unsigned int num_threads();
+	unsigned int num_dependencies();
+
+	static bool uid_patterns_match(const std::string &pattern_a, const std::string &pattern_b);
+
+private:
+	/// @cond INTERNALS
+	typedef struct Node
+	{
+		Thread *                        thread;
+		BlockedTimingAspect *           aspect;
+		BlockedTimingAspect::WakeupHook hook;
+		std::vector<struct Node *>      dependents;
+		unsigned int                    num_dependencies;
+		unsigned int                    remaining;
+		unsigned int                    dispatched_cycle;
+		unsigned int                    run_cycle;
+		bool                            done;
+		bool                            removed;
+		WaitCondition *                 waitcond;
+	} Node;
+	/// @endcond
+
+	void        rebuild_graph();
+	void        dispatch(Node *node);
+	void        complete(Node *node);
+	bool        hooks_done(BlockedTimingAspect::WakeupHook hook) const;
+	bool        wait_until(BlockedTimingAspect::WakeupHook hook, const struct timespec &deadline);
+	static bool depends_on(const Node *reader, const Node *writer);
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *hook_waitcond_;
+
+	std::vector<Node *>                     nodes_;
+	std::map<BlockedTimingAspect *, Node *> node_map_;
+	bool                                    graph_dirty_;
+	unsigned int                            num_dependencies_;
+
+	unsigned int    cycle_;
+	struct timespec cycle_deadline_;
+	bool            cycle_has_deadline_;
+	unsigned int    hook_remaining_[BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP + 1];
+};
+
+} // end namespace fawkes
+
+#endif
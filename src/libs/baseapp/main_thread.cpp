@@ -21,7 +21,9 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <aspect/blocked_timing/profiler.h>
 #include <aspect/manager.h>
+#include <baseapp/dataflow_scheduler.h>
 #include <baseapp/main_thread.h>
 #include <config/config.h>
 #include <core/exceptions/system.h>
@@ -42,6 +44,47 @@
 
 namespace fawkes {
 
+/// @cond INTERNALS
+/* Closes the profiler timing of a cycle and of the hook still being
+ * waited for, also if waiting for a hook throws an exception. */
+class ProfiledCycle
+{
+public:
+	ProfiledCycle(BlockedTimingProfiler *profiler) : profiler_(profiler), hook_open_(false)
+	{
+		profiler_->cycle_started();
+	}
+
+	~ProfiledCycle()
+	{
+		if (hook_open_) {
+			profiler_->hook_finished(hook_);
+		}
+		profiler_->cycle_finished();
+	}
+
+	void
+	hook_started(BlockedTimingAspect::WakeupHook hook)
+	{
+		profiler_->hook_started(hook);
+		hook_      = hook;
+		hook_open_ = true;
+	}
+
+	void
+	hook_finished()
+	{
+		hook_open_ = false;
+		profiler_->hook_finished(hook_);
+	}
+
+private:
+	BlockedTimingProfiler *         profiler_;
+	BlockedTimingAspect::WakeupHook hook_;
+	bool                            hook_open_;
+};
+/// @endcond
+
 /** @class FawkesMainThread <baseapp/main_thread.h>
  * Fawkes default main thread.
  * This thread initializes all important stuff like the BlackBoard,
@@ -76,6 +119,8 @@ FawkesMainThread::FawkesMainThread(Configuration *   config,
 	multi_logger_      = multi_logger;
 	config_            = config;
 
+	syncpoint_component_id_ = 0;
+
 	mainloop_thread_  = NULL;
 	mainloop_mutex_   = new Mutex();
 	mainloop_barrier_ = new InterruptibleBarrier(mainloop_mutex_, 2);
@@ -124,6 +169,34 @@ FawkesMainThread::FawkesMainThread(Configuration *   config,
 	} catch (Exception &e) {
 		enable_looptime_warnings_ = true;
 	}
+
+	profiler_ = thread_manager_->profiler();
+
+	dataflow_scheduler_ = NULL;
+	try {
+		dataflow_deadline_usec_ = config_->get_uint("/fawkes/mainapp/dataflow_deadline");
+	} catch (Exception &e) {
+		// by default allow for as much time as the barriers would
+		dataflow_deadline_usec_ = desired_loop_time_usec_;
+		if (dataflow_deadline_usec_ == 0) {
+			dataflow_deadline_usec_ =
+			  max_thread_time_usec_ * (BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP + 1);
+		}
+	}
+
+	cycle_histogram_start_ = new Time(clock_);
+	cycle_histogram_start_->stamp_systime();
+	cycle_histogram_count_ = 0;
+	cycle_histogram_sum_   = 0.;
+	cycle_histogram_max_   = 0.;
+	for (unsigned int i = 0; i < CYCLE_HISTOGRAM_BINS; ++i) {
+		cycle_histogram_[i] = 0;
+	}
+	try {
+		cycle_histogram_interval_sec_ = config_->get_float("/fawkes/mainapp/cycle_histogram_interval");
+	} catch (Exception &e) {
+		cycle_histogram_interval_sec_ = 0.;
+	}
 }
 
 /** Destructor. */
@@ -181,11 +254,25 @@ FawkesMainThread::destruct()
 	delete time_wait_;
 	delete loop_start_;
 	delete loop_end_;
+	delete cycle_histogram_start_;
 
 	delete mainloop_barrier_;
 	delete mainloop_mutex_;
 }
 
+/** Set dataflow scheduler.
+ * If set, threads with the BlockedTimingAspect are started by the given
+ * scheduler as soon as their inputs have been written instead of waiting
+ * for all threads of earlier hooks. Must be set before the thread is
+ * started, and the scheduler must also be passed to the aspect manager.
+ * @param scheduler dataflow scheduler, NULL to run the hooks as barriers
+ */
+void
+FawkesMainThread::set_dataflow_scheduler(DataflowScheduler *scheduler)
+{
+	dataflow_scheduler_ = scheduler;
+}
+
 /** Start the thread and wait until once() completes.
  * This is useful to assure that all plugins are loaded before assuming that
  * startup is complete.
@@ -206,21 +293,22 @@ void
 FawkesMainThread::once()
 {
 	// register to all syncpoints of the main loop
-	std::vector<BlockedTimingAspect::WakeupHook> hooks;
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_THINK);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SKILL);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT_EXEC);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
+	hooks_.clear();
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SKILL);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT_EXEC);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
 
 	try {
-		for (std::vector<BlockedTimingAspect::WakeupHook>::const_iterator it = hooks.begin();
-		     it != hooks.end();
+		syncpoint_component_id_ = SyncPoint::component_id("FawkesMainThread");
+		for (std::vector<BlockedTimingAspect::WakeupHook>::const_iterator it = hooks_.begin();
+		     it != hooks_.end();
 		     it++) {
 			syncpoints_start_hook_.push_back(syncpoint_manager_->get_syncpoint(
 			  "FawkesMainThread", BlockedTimingAspect::blocked_timing_hook_to_start_syncpoint(*it)));
@@ -326,34 +414,45 @@ FawkesMainThread::loop()
 		set_cancel_state(CANCEL_DISABLED, &old_state);
 
 		mainloop_mutex_->lock();
-
-		if (unlikely(mainloop_thread_ != NULL)) {
-			try {
-				if (likely(mainloop_thread_ != NULL)) {
-					mainloop_thread_->wakeup(mainloop_barrier_);
-					mainloop_barrier_->wait();
+		{
+			ProfiledCycle cycle(profiler_);
+
+			if (unlikely(mainloop_thread_ != NULL)) {
+				try {
+					if (likely(mainloop_thread_ != NULL)) {
+						mainloop_thread_->wakeup(mainloop_barrier_);
+						mainloop_barrier_->wait();
+					}
+				} catch (Exception &e) {
+					multi_logger_->log_warn("FawkesMainThread", e);
 				}
-			} catch (Exception &e) {
-				multi_logger_->log_warn("FawkesMainThread", e);
-			}
-		} else {
-			uint num_hooks = syncpoints_start_hook_.size();
-			if (syncpoints_end_hook_.size() != num_hooks) {
-				multi_logger_->log_error(
-				  "FawkesMainThread",
-				  "Hook syncpoints are not initialized properly, not waking up any threads!");
 			} else {
-				for (uint i = 0; i < num_hooks; i++) {
-					syncpoints_start_hook_[i]->emit("FawkesMainThread");
-					syncpoints_end_hook_[i]->reltime_wait_for_all("FawkesMainThread",
-					                                              0,
-					                                              max_thread_time_nanosec_);
+				uint num_hooks = syncpoints_start_hook_.size();
+				if (syncpoints_end_hook_.size() != num_hooks) {
+					multi_logger_->log_error(
+					  "FawkesMainThread",
+					  "Hook syncpoints are not initialized properly, not waking up any threads!");
+				} else if (dataflow_scheduler_) {
+					run_dataflow_cycle();
+				} else {
+					for (uint i = 0; i < num_hooks; i++) {
+						cycle.hook_started(hooks_[i]);
+						syncpoints_start_hook_[i]->emit(syncpoint_component_id_);
+						syncpoints_end_hook_[i]->wait(syncpoint_component_id_,
+						                              SyncPoint::WAIT_FOR_ALL,
+						                              0,
+						                              max_thread_time_nanosec_);
+						cycle.hook_finished();
+					}
 				}
 			}
 		}
 		mainloop_mutex_->unlock();
 		set_cancel_state(old_state);
 
+		loop_end_->stamp_systime();
+		record_cycle_time(*loop_end_ - loop_start_);
+
 		test_cancel();
 
 		thread_manager_->try_recover(recovered_threads_);
@@ -422,6 +521,101 @@ FawkesMainThread::loop()
 	// at least needs to be rethrown.
 }
 
+/** Run one main loop cycle with the dataflow scheduler.
+ * The scheduler starts each thread once its inputs have been written.
+ * The hooks are still waited for in order to emit their start syncpoints
+ * for other components. If the cycle deadline passes, the remaining
+ * threads are started hook by hook as in the barrier mode.
+ */
+void
+FawkesMainThread::run_dataflow_cycle()
+{
+	dataflow_scheduler_->start_cycle(dataflow_deadline_usec_);
+
+	bool in_hook_order = false;
+	for (uint i = 0; i <= hooks_.size(); i++) {
+		if (i > 0) {
+			BlockedTimingAspect::WakeupHook prev_hook = hooks_[i - 1];
+			if (!in_hook_order) {
+				if (dataflow_scheduler_->wait_for_hook(prev_hook)) {
+					profiler_->hook_finished(prev_hook);
+				} else {
+					in_hook_order = true;
+					if (enable_looptime_warnings_) {
+						multi_logger_->log_warn("FawkesMainThread",
+						                        "Dataflow deadline of %u usec exceeded at hook %s, "
+						                        "running remaining threads in hook order",
+						                        dataflow_deadline_usec_,
+						                        BlockedTimingAspect::blocked_timing_hook_to_string(prev_hook));
+					}
+				}
+			}
+			if (in_hook_order) {
+				dataflow_scheduler_->release_hooks(prev_hook);
+				if (dataflow_scheduler_->wait_for_hook(prev_hook, max_thread_time_usec_)) {
+					profiler_->hook_finished(prev_hook);
+				}
+			}
+		}
+		if (i < hooks_.size()) {
+			profiler_->hook_started(hooks_[i]);
+			syncpoints_start_hook_[i]->emit(syncpoint_component_id_);
+		}
+	}
+}
+
+/** Record the time of one main loop cycle.
+ * If a histogram interval is configured, a histogram of the cycle times
+ * is logged periodically. This allows to compare scheduling modes.
+ * @param cycle_time time in seconds it took to run all hooks
+ */
+void
+FawkesMainThread::record_cycle_time(float cycle_time)
+{
+	if (cycle_histogram_interval_sec_ <= 0.)
+		return;
+
+	// bins: < 1, 2, 5, 10, 20, 50, 100, 200, 500 ms, and larger
+	static const float bin_limits_ms[CYCLE_HISTOGRAM_BINS - 1] =
+	  {1., 2., 5., 10., 20., 50., 100., 200., 500.};
+	float        cycle_time_ms = cycle_time * 1000.;
+	unsigned int bin           = 0;
+	while (bin < CYCLE_HISTOGRAM_BINS - 1 && cycle_time_ms >= bin_limits_ms[bin]) {
+		++bin;
+	}
+	cycle_histogram_[bin] += 1;
+	cycle_histogram_count_ += 1;
+	cycle_histogram_sum_ += cycle_time;
+	if (cycle_time > cycle_histogram_max_) {
+		cycle_histogram_max_ = cycle_time;
+	}
+
+	if ((*loop_end_ - cycle_histogram_start_) >= cycle_histogram_interval_sec_) {
+		std::string bins;
+		for (unsigned int i = 0; i < CYCLE_HISTOGRAM_BINS; ++i) {
+			char tmp[32];
+			if (i < CYCLE_HISTOGRAM_BINS - 1) {
+				snprintf(tmp, sizeof(tmp), " <%.0fms:%u", bin_limits_ms[i], cycle_histogram_[i]);
+			} else {
+				snprintf(tmp, sizeof(tmp), " >=%.0fms:%u", bin_limits_ms[i - 1], cycle_histogram_[i]);
+			}
+			bins += tmp;
+			cycle_histogram_[i] = 0;
+		}
+		multi_logger_->log_info("FawkesMainThread",
+		                        "%s cycles: %u  avg: %.2f ms  max: %.2f ms |%s",
+		                        dataflow_scheduler_ ? "Dataflow" : "Barrier",
+		                        cycle_histogram_count_,
+		                        cycle_histogram_sum_ * 1000. / cycle_histogram_count_,
+		                        cycle_histogram_max_ * 1000.,
+		                        bins.c_str());
+		cycle_histogram_count_  = 0;
+		cycle_histogram_sum_    = 0.;
+		cycle_histogram_max_    = 0.;
+		*cycle_histogram_start_ = *loop_end_;
+	}
+}
+
 /** Get logger.
  * @return logger
  */
@@ -37,6 +37,9 @@
 #include <string>
 #include <vector>
 
+/** Number of bins of the main loop cycle time histogram. */
+#define CYCLE_HISTOGRAM_BINS 10
+
 namespace fawkes {
 class Configuration;
 class Configuration;
@@ -54,6 +57,8 @@ class Mutex;
 class ThreadManager;
 class SyncPointManager;
 class FawkesNetworkManager;
+class DataflowScheduler;
+class BlockedTimingProfiler;
 
 class FawkesMainThread : public Thread, public MainLoopEmployer
 {
@@ -74,6 +79,8 @@ public:
 
 	void full_start();
 
+	void set_dataflow_scheduler(DataflowScheduler *scheduler);
+
 	MultiLogger *logger() const;
 
 	class Runner : public SignalHandler
@@ -103,6 +110,8 @@ protected:
 
 private:
 	void destruct();
+	void run_dataflow_cycle();
+	void record_cycle_time(float cycle_time);
 
 	inline void
 	safe_wake(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
@@ -145,8 +154,21 @@ private:
 	Time *                 loop_end_;
 	bool                   enable_looptime_warnings_;
 
-	std::vector<RefPtr<SyncPoint>> syncpoints_start_hook_;
-	std::vector<RefPtr<SyncPoint>> syncpoints_end_hook_;
+	std::vector<BlockedTimingAspect::WakeupHook> hooks_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_start_hook_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_end_hook_;
+	unsigned int                                 syncpoint_component_id_;
+
+	BlockedTimingProfiler *profiler_;
+	DataflowScheduler *    dataflow_scheduler_;
+	unsigned int           dataflow_deadline_usec_;
+
+	float        cycle_histogram_interval_sec_;
+	Time *       cycle_histogram_start_;
+	unsigned int cycle_histogram_[CYCLE_HISTOGRAM_BINS];
+	unsigned int cycle_histogram_count_;
+	float        cycle_histogram_sum_;
+	float        cycle_histogram_max_;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,343 @@
+/***************************************************************************
+ *  qa_dataflow_scheduler.cpp - QA for the dependency-graph scheduler
+ *
+ *  Created: Sun Oct 18 22:41:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <aspect/blocked_timing.h>
+#include <baseapp/dataflow_scheduler.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <utils/time/time.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace std;
+
+#define TIMEOUT_SEC 60
+
+static Mutex        seq_mutex;
+static unsigned int seq = 0;
+
+static unsigned int
+next_seq()
+{
+	MutexLocker lock(&seq_mutex);
+	return ++seq;
+}
+
+/* Thread which runs its loop as BlockedTimingAspect::pre_loop() and
+ * post_loop() would with a scheduler, without needing a syncpoint manager.
+ * Every run records a global sequence number at start and end. */
+class QaFlowThread : public Thread, public BlockedTimingAspect
+{
+public:
+	QaFlowThread(const char *        name,
+	             WakeupHook          hook,
+	             DataflowScheduler * scheduler,
+	             unsigned int        work_usec)
+	: Thread(name, Thread::OPMODE_CONTINUOUS), BlockedTimingAspect(hook)
+	{
+		scheduler_ = scheduler;
+		work_usec_ = work_usec;
+		runs       = 0;
+		start_seq  = 0;
+		end_seq    = 0;
+	}
+
+	void
+	reads(const char *type, const char *id)
+	{
+		blocked_timing_reads(type, id);
+	}
+
+	void
+	writes(const char *type, const char *id)
+	{
+		blocked_timing_writes(type, id);
+	}
+
+	virtual void
+	loop()
+	{
+		scheduler_->wait_for_inputs(this, this);
+		start_seq = next_seq();
+		if (work_usec_ > 0) {
+			usleep(work_usec_);
+		}
+		end_seq = next_seq();
+		runs += 1;
+		scheduler_->outputs_written(this, this);
+	}
+
+	volatile unsigned int runs;
+	volatile unsigned int start_seq;
+	volatile unsigned int end_seq;
+
+private:
+	DataflowScheduler *scheduler_;
+	unsigned int       work_usec_;
+};
+
+static void
+start_threads(DataflowScheduler *scheduler, vector<QaFlowThread *> &threads)
+{
+	for (unsigned int i = 0; i < threads.size(); ++i) {
+		scheduler->add_thread(threads[i], threads[i]);
+		threads[i]->start();
+	}
+}
+
+static void
+stop_threads(DataflowScheduler *scheduler, vector<QaFlowThread *> &threads)
+{
+	for (unsigned int i = 0; i < threads.size(); ++i) {
+		threads[i]->cancel();
+		threads[i]->join();
+		scheduler->remove_thread(threads[i], threads[i]);
+		delete threads[i];
+	}
+	threads.clear();
+}
+
+static unsigned int
+check(bool condition, const char *what)
+{
+	if (!condition) {
+		printf("  FAILED: %s\n", what);
+		return 1;
+	}
+	return 0;
+}
+
+/* A reader of an interface must only start after the writer of an earlier
+ * hook has finished, a thread whose inputs nobody writes starts right away,
+ * and a thread without declarations waits for all earlier hooks. */
+static unsigned int
+check_dependency_order()
+{
+	unsigned int      errors = 0;
+	DataflowScheduler scheduler;
+
+	QaFlowThread *writer = new QaFlowThread("Writer",
+	                                        BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE,
+	                                        &scheduler,
+	                                        20000);
+	writer->writes("Position3DInterface", "Pose");
+	QaFlowThread *reader = new QaFlowThread("Reader",
+	                                        BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE,
+	                                        &scheduler,
+	                                        1000);
+	reader->reads("Position3DInterface", "Pose");
+	QaFlowThread *independent = new QaFlowThread("Independent",
+	                                             BlockedTimingAspect::WAKEUP_HOOK_THINK,
+	                                             &scheduler,
+	                                             1000);
+	independent->reads("SwitchInterface", "*");
+	QaFlowThread *undeclared = new QaFlowThread("Undeclared",
+	                                            BlockedTimingAspect::WAKEUP_HOOK_SKILL,
+	                                            &scheduler,
+	                                            0);
+
+	vector<QaFlowThread *> threads;
+	threads.push_back(writer);
+	threads.push_back(reader);
+	threads.push_back(independent);
+	threads.push_back(undeclared);
+	start_threads(&scheduler, threads);
+
+	const unsigned int num_cycles = 20;
+	for (unsigned int c = 1; c <= num_cycles; ++c) {
+		scheduler.start_cycle(0);
+		errors += check(scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP),
+		                "cycle without deadline did not finish");
+
+		errors += check(reader->start_seq > writer->end_seq, "reader started before writer finished");
+		errors += check(independent->start_seq < writer->end_seq,
+		                "independent thread waited for unrelated writer");
+		errors += check(undeclared->start_seq > writer->end_seq
+		                  && undeclared->start_seq > reader->end_seq
+		                  && undeclared->start_seq > independent->end_seq,
+		                "undeclared thread started before earlier hooks finished");
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			errors += check(threads[i]->runs == c, "thread did not run exactly once per cycle");
+		}
+	}
+
+	// Reader <- Writer, and Undeclared <- each of the other three
+	errors += check(scheduler.num_threads() == 4, "wrong number of threads");
+	errors += check(scheduler.num_dependencies() == 4, "wrong number of dependencies");
+
+	stop_threads(&scheduler, threads);
+	printf("Dependency order: %u cycles, %u errors\n", num_cycles, errors);
+	return errors;
+}
+
+/* Once the deadline passes, wait_for_hook() gives up and release_hooks()
+ * starts the remaining threads in hook order, even though their inputs
+ * have not been written yet. */
+static unsigned int
+check_deadline_fallback()
+{
+	unsigned int      errors = 0;
+	DataflowScheduler scheduler;
+
+	QaFlowThread *slow = new QaFlowThread("Slow",
+	                                      BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE,
+	                                      &scheduler,
+	                                      200000);
+	slow->writes("Laser360Interface", "*");
+	QaFlowThread *consumer = new QaFlowThread("Consumer",
+	                                          BlockedTimingAspect::WAKEUP_HOOK_THINK,
+	                                          &scheduler,
+	                                          0);
+	consumer->reads("Laser360Interface", "Laser");
+
+	vector<QaFlowThread *> threads;
+	threads.push_back(slow);
+	threads.push_back(consumer);
+	start_threads(&scheduler, threads);
+
+	Time start;
+	scheduler.start_cycle(20000);
+	bool  in_time = scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE);
+	float waited  = Time() - &start;
+	errors += check(!in_time, "deadline did not expire while slow thread was running");
+	errors += check(waited >= 0.015 && waited < 0.15, "wait did not end at the deadline");
+
+	errors += check(consumer->runs == 0, "consumer ran before its input was written");
+	scheduler.release_hooks(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	errors += check(scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK, 2000000),
+	                "hooks did not finish after release");
+	errors += check(consumer->runs == 1 && consumer->start_seq < slow->end_seq,
+	                "consumer was not released before slow thread finished");
+	errors += check(slow->runs == 1, "slow thread did not run exactly once");
+
+	// the next cycle without deadline is back to dependency order
+	scheduler.start_cycle(0);
+	errors += check(scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP),
+	                "cycle after fallback did not finish");
+	errors += check(consumer->runs == 2 && slow->runs == 2, "threads did not run in second cycle");
+	errors += check(consumer->start_seq > slow->end_seq,
+	                "consumer started before its input was written after fallback");
+
+	stop_threads(&scheduler, threads);
+	printf("Deadline fallback: waited %.1f ms, %u errors\n", waited * 1000., errors);
+	return errors;
+}
+
+/* Releasing the hooks while a wave is in flight must start the waiting
+ * threads once, must not restart running ones, and the threads finishing
+ * afterwards must not dispatch their dependents again. */
+static unsigned int
+check_release_in_flight()
+{
+	unsigned int      errors = 0;
+	DataflowScheduler scheduler;
+
+	QaFlowThread *first = new QaFlowThread("First",
+	                                       BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE,
+	                                       &scheduler,
+	                                       50000);
+	first->writes("ObjectPositionInterface", "Ball");
+	QaFlowThread *second = new QaFlowThread("Second",
+	                                        BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE,
+	                                        &scheduler,
+	                                        30000);
+	second->reads("ObjectPositionInterface", "Ball");
+	second->writes("ObjectPositionInterface", "WM Ball");
+	QaFlowThread *third = new QaFlowThread("Third",
+	                                       BlockedTimingAspect::WAKEUP_HOOK_THINK,
+	                                       &scheduler,
+	                                       0);
+	third->reads("ObjectPositionInterface", "WM Ball");
+
+	vector<QaFlowThread *> threads;
+	threads.push_back(first);
+	threads.push_back(second);
+	threads.push_back(third);
+	start_threads(&scheduler, threads);
+
+	const unsigned int num_cycles = 10;
+	for (unsigned int c = 1; c <= num_cycles; ++c) {
+		scheduler.start_cycle(0);
+		usleep(10000);
+		// first is running, second and third are waiting for their inputs
+		scheduler.release_hooks(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
+		errors += check(scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP, 2000000),
+		                "hooks did not finish after release in flight");
+		errors += check(third->start_seq < first->end_seq && second->start_seq < first->end_seq,
+		                "waiting threads were not released");
+
+		// a late release after the wave must not start anything
+		scheduler.release_hooks(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
+		usleep(10000);
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			errors += check(threads[i]->runs == c, "thread did not run exactly once per cycle");
+		}
+	}
+
+	// without release, the chain runs in order again
+	scheduler.start_cycle(0);
+	errors += check(scheduler.wait_for_hook(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP),
+	                "cycle after release did not finish");
+	errors += check(second->start_seq > first->end_seq && third->start_seq > second->end_seq,
+	                "chain out of order after release");
+	for (unsigned int i = 0; i < threads.size(); ++i) {
+		errors += check(threads[i]->runs == num_cycles + 1, "thread did not run in final cycle");
+	}
+
+	stop_threads(&scheduler, threads);
+	printf("Release in flight: %u cycles, %u errors\n", num_cycles, errors);
+	return errors;
+}
+
+static void
+timeout_handler(int signum)
+{
+	const char *msg = "Timeout, a thread was never dispatched\nQA FAILED\n";
+	if (write(STDOUT_FILENO, msg, strlen(msg)) < 0) {
+		// exiting anyway
+	}
+	_exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	signal(SIGALRM, timeout_handler);
+	alarm(TIMEOUT_SEC);
+
+	unsigned int errors = 0;
+	errors += check_dependency_order();
+	errors += check_deadline_fallback();
+	errors += check_release_in_flight();
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -22,6 +22,7 @@
  */
 
 #include <baseapp/daemonize.h>
+#include <baseapp/dataflow_scheduler.h>
 #include <baseapp/main_thread.h>
 #include <baseapp/run.h>
 #include <baseapp/thread_manager.h>
@@ -82,25 +83,26 @@ class FawkesNetworkManager;
 
 namespace runtime {
 
-ArgumentParser *       argument_parser   = NULL;
-FawkesMainThread *     main_thread       = NULL;
-MultiLogger *          logger            = NULL;
-NetworkLogger *        network_logger    = NULL;
-BlackBoard *           blackboard        = NULL;
-Configuration *        config            = NULL;
-PluginManager *        plugin_manager    = NULL;
-AspectManager *        aspect_manager    = NULL;
-ThreadManager *        thread_manager    = NULL;
-FawkesNetworkManager * network_manager   = NULL;
-ConfigNetworkHandler * nethandler_config = NULL;
-PluginNetworkHandler * nethandler_plugin = NULL;
-Clock *                clock             = NULL;
+ArgumentParser *       argument_parser    = NULL;
+FawkesMainThread *     main_thread        = NULL;
+MultiLogger *          logger             = NULL;
+NetworkLogger *        network_logger     = NULL;
+BlackBoard *           blackboard         = NULL;
+Configuration *        config             = NULL;
+PluginManager *        plugin_manager     = NULL;
+AspectManager *        aspect_manager     = NULL;
+ThreadManager *        thread_manager     = NULL;
+FawkesNetworkManager * network_manager    = NULL;
+ConfigNetworkHandler * nethandler_config  = NULL;
+PluginNetworkHandler * nethandler_plugin  = NULL;
+Clock *                clock              = NULL;
 SharedMemoryRegistry * shm_registry;
-InitOptions *          init_options      = NULL;
-tf::Transformer *      tf_transformer    = NULL;
-tf::TransformListener *tf_listener       = NULL;
-Time *                 start_time        = NULL;
-SyncPointManager *     syncpoint_manager = NULL;
+InitOptions *          init_options       = NULL;
+tf::Transformer *      tf_transformer     = NULL;
+tf::TransformListener *tf_listener        = NULL;
+Time *                 start_time         = NULL;
+SyncPointManager *     syncpoint_manager  = NULL;
+DataflowScheduler *    dataflow_scheduler = NULL;
 #ifdef HAVE_LOGGING_FD_REDIRECT
 LogFileDescriptorToLog *log_fd_redirect_stderr_ = NULL;
 LogFileDescriptorToLog *log_fd_redirect_stdout_ = NULL;
@@ -316,6 +318,7 @@ init(const InitOptions &options, int &retval)
 	std::string  listen_ipv6;
 	unsigned int net_tcp_port     = 1910;
 	std::string  net_service_name = "Fawkes on %h";
+	unsigned int net_io_threads   = 0;
 	if (options.has_net_tcp_port()) {
 		net_tcp_port = options.net_tcp_port();
 	} else {
@@ -334,6 +337,11 @@ init(const InitOptions &options, int &retval)
 		} // ignore, we stick with the default
 	}
 
+	try {
+		net_io_threads = config->get_uint("/network/fawkes/io_threads");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+
 	if (net_tcp_port > 65535) {
 		logger->log_warn("FawkesMainThread", "Invalid port '%u', using 1910", net_tcp_port);
 		net_tcp_port = 1910;
@@ -399,11 +407,32 @@ init(const InitOptions &options, int &retval)
 		SharedMemoryRegistry::cleanup();
 	}
 
+	bool bb_size_classes = false;
+	try {
+		std::string bb_allocator = config->get_string("/fawkes/mainapp/blackboard_allocator");
+		if (bb_allocator == "size-class") {
+			bb_size_classes = true;
+		} else if (bb_allocator != "best-fit") {
+			logger->log_warn("FawkesMainApp",
+			                 "Unknown BlackBoard allocator '%s', using best-fit",
+			                 bb_allocator.c_str());
+		}
+	} catch (Exception &e) {
+		// ignore, use best-fit allocator
+	}
+
 	LocalBlackBoard *lbb = NULL;
 	if (bb_magic_token == "") {
-		lbb = new LocalBlackBoard(bb_size);
+		lbb = new LocalBlackBoard(bb_size, bb_size_classes);
 	} else {
-		lbb = new LocalBlackBoard(bb_size, bb_magic_token.c_str());
+		lbb = new LocalBlackBoard(bb_size, bb_magic_token.c_str(), true, bb_size_classes);
+	}
+	try {
+		std::vector<std::string> seqlock_types =
+		  config->get_strings("/fawkes/mainapp/blackboard_seqlock_types");
+		lbb->set_seqlock_types(std::list<std::string>(seqlock_types.begin(), seqlock_types.end()));
+	} catch (Exception &e) {
+		// ignore, use read/write locks for all interfaces
 	}
 	blackboard = lbb;
 #endif
@@ -417,6 +446,26 @@ init(const InitOptions &options, int &retval)
 	thread_manager = new ThreadManager(aspect_manager, aspect_manager);
 
 	syncpoint_manager = new SyncPointManager(logger);
+	try {
+		syncpoint_manager->set_call_stats_enabled(
+		  config->get_bool("/fawkes/mainapp/syncpoint_call_stats"));
+	} catch (Exception &e) {
+		// ignore, record calls
+	}
+
+	try {
+		std::string scheduler = config->get_string("/fawkes/mainapp/scheduler");
+		if (scheduler == "dataflow") {
+			dataflow_scheduler = new DataflowScheduler();
+			logger->log_info("FawkesMainApp", "Scheduling timed threads by their data flow");
+		} else if (scheduler != "barrier") {
+			logger->log_warn("FawkesMainApp",
+			                 "Unknown scheduler '%s', using barrier",
+			                 scheduler.c_str());
+		}
+	} catch (Exception &e) {
+		// ignore, run hooks as barriers
+	}
 
 	plugin_manager = new PluginManager(thread_manager,
 	                                   config,
@@ -430,7 +479,8 @@ init(const InitOptions &options, int &retval)
 	                                           listen_ipv4,
 	                                           listen_ipv6,
 	                                           net_tcp_port,
-	                                           net_service_name.c_str());
+	                                           net_service_name.c_str(),
+	                                           net_io_threads);
 #	ifdef HAVE_CONFIG_NETWORK_HANDLER
 	nethandler_config = new ConfigNetworkHandler(config, network_manager->hub());
 #	endif
@@ -459,6 +509,7 @@ init(const InitOptions &options, int &retval)
 	                                           plugin_manager,
 	                                           options.load_plugin_list(),
 	                                           options.default_plugin());
+	main_thread->set_dataflow_scheduler(dataflow_scheduler);
 
 	aspect_manager->register_default_inifins(blackboard,
 	                                         thread_manager->aspect_collector(),
@@ -484,7 +535,8 @@ init(const InitOptions &options, int &retval)
 #endif
 	                                         plugin_manager,
 	                                         tf_transformer,
-	                                         syncpoint_manager);
+	                                         syncpoint_manager,
+	                                         dataflow_scheduler);
 
 	retval = 0;
 	return true;
@@ -535,6 +587,8 @@ cleanup()
 	delete network_manager;
 #endif
 	delete thread_manager;
+	// threads are finalized by the thread manager, they use the scheduler
+	delete dataflow_scheduler;
 	delete aspect_manager;
 	delete shm_registry;
 #ifdef HAVE_LOGGING_FD_REDIRECT
@@ -542,18 +596,19 @@ cleanup()
 	delete log_fd_redirect_stdout_;
 #endif
 
-	main_thread       = NULL;
-	argument_parser   = NULL;
-	init_options      = NULL;
-	nethandler_config = NULL;
-	nethandler_plugin = NULL;
-	plugin_manager    = NULL;
-	network_manager   = NULL;
-	config            = NULL;
-	thread_manager    = NULL;
-	aspect_manager    = NULL;
-	shm_registry      = NULL;
-	blackboard        = NULL;
+	main_thread        = NULL;
+	argument_parser    = NULL;
+	init_options       = NULL;
+	nethandler_config  = NULL;
+	nethandler_plugin  = NULL;
+	plugin_manager     = NULL;
+	network_manager    = NULL;
+	config             = NULL;
+	thread_manager     = NULL;
+	dataflow_scheduler = NULL;
+	aspect_manager     = NULL;
+	shm_registry       = NULL;
+	blackboard         = NULL;
 #ifdef HAVE_LOGGING_FD_REDIRECT
 	log_fd_redirect_stderr_ = NULL;
 	log_fd_redirect_stdout_ = NULL;
@@ -638,7 +693,8 @@ print_usage(const char *progname)
 	       "config (console logger if unset). Format is:\n"
 	       "                           logger:args[;logger2:args2[!...]]\n"
 	       "                           Currently supported:\n"
-	       "                           console, file:file.log, network logger always added\n"
+	       "                           console, file:file.log, async-file:file.log,\n"
+	       "                           network logger always added\n"
 	       "  -p plugins               List of plugins to load on startup in given order\n"
 	       "  -P port                  TCP port to listen on for Fawkes network connections.\n"
 	       "  --net-service-name=name  mDNS service name to use.\n"
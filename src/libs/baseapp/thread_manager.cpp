@@ -22,6 +22,7 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <aspect/blocked_timing/profiler.h>
 #include <baseapp/thread_manager.h>
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
@@ -47,6 +48,9 @@ namespace fawkes {
  * (RTTI) supplied by C++ can be used to initialize threads if appropriate
  * (if the thread has certain aspects that need special treatment).
  *
+ * The thread manager owns a profiler which records the timing of all
+ * threads with the BlockedTimingAspect, see profiler().
+ *
  * @author Tim Niemueller
  */
 
@@ -139,6 +143,7 @@ ThreadManager::ThreadManager()
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	profiler_                    = new BlockedTimingProfiler();
 }
 
 /** Constructor.
@@ -155,6 +160,7 @@ ThreadManager::ThreadManager(ThreadInitializer *initializer, ThreadFinalizer *fi
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	profiler_                    = new BlockedTimingProfiler();
 	set_inifin(initializer, finalizer);
 }
 
@@ -177,6 +183,7 @@ ThreadManager::~ThreadManager()
 
 	delete waitcond_timedthreads_;
 	delete aspect_collector_;
+	delete profiler_;
 }
 
 /** Set initializer/finalizer.
@@ -550,7 +557,9 @@ ThreadManager::wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned in
 
 	// Note that the following lines might throw an exception, we just pass it on
 	if (threads_.find(hook) != threads_.end()) {
+		profiler_->hook_started(hook);
 		threads_[hook].wakeup_and_wait(timeout_sec, timeout_usec * 1000);
+		profiler_->hook_finished(hook);
 	}
 }
 
@@ -605,6 +614,18 @@ ThreadManager::interrupt_timed_thread_wait()
 	waitcond_timedthreads_->wake_all();
 }
 
+/** Get profiler.
+ * The profiler is always enabled. It is fed by the threads which have
+ * been initialized with it by the BlockedTimingAspect initializer and by
+ * the main loop, which records the start and end of cycles and hooks.
+ * @return profiler of the threads with the BlockedTimingAspect
+ */
+BlockedTimingProfiler *
+ThreadManager::profiler()
+{
+	return profiler_;
+}
+
 /** Get a thread collector to be used for an aspect initializer.
  * @return thread collector instance to use for ThreadProducerAspect.
  */
@@ -83,6 +83,8 @@ public:
 	virtual void wait_for_timed_threads();
 	virtual void interrupt_timed_thread_wait();
 
+	virtual BlockedTimingProfiler *profiler();
+
 	ThreadCollector *aspect_collector() const;
 
 private:
@@ -123,6 +125,7 @@ private:
 
 	ThreadManagerAspectCollector *aspect_collector_;
 	bool                          interrupt_timed_thread_wait_;
+	BlockedTimingProfiler *       profiler_;
 };
 
 } // end namespace fawkes
@@ -24,10 +24,14 @@
 #ifndef _BLACKBOARD_BBCONFIG_H_
 #define _BLACKBOARD_BBCONFIG_H_
 
-#define BLACKBOARD_VERSION 1
+#define BLACKBOARD_VERSION 4
 
 // Can be used as useful defaults
 #define BLACKBOARD_MEMSIZE 2 * 1024 * 1024
 #define BLACKBOARD_MAGIC_TOKEN "FawkesBlackBoard"
 
+// Asynchronous listener dispatch
+#define BLACKBOARD_ASYNC_THREADS 2
+#define BLACKBOARD_ASYNC_QUEUE_SIZE 64
+
 #endif
@@ -190,6 +190,9 @@ BlackBoard::register_listener(BlackBoardInterfaceListener *listener, ListenerReg
 }
 
 /** Update BB event listener.
+ * An asynchronous listener stays asynchronous if updated without
+ * BBIL_FLAG_ASYNC, it is reverted to synchronous delivery only when
+ * unregistered.
  * @param listener BlackBoard event listener to update
  * @param flag flags what to update for
  */
@@ -90,6 +90,7 @@ public:
 		BBIL_FLAG_READER   = 4,  ///< consider reader events
 		BBIL_FLAG_WRITER   = 8,  ///< consider writer events
 		BBIL_FLAG_ALL      = 15, ///< consider all events
+		BBIL_FLAG_ASYNC    = 16, ///< deliver data events asynchronously
 	} ListenerRegisterFlag;
 
 	virtual void register_listener(BlackBoardInterfaceListener *listener,
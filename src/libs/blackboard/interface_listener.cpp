@@ -22,6 +22,7 @@
  */
 
 #include <blackboard/interface_listener.h>
+#include <blackboard/internal/async_dispatcher.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
@@ -74,6 +75,19 @@ namespace fawkes {
  * the instance is deleted and afterwards an event for that very interface
  * happens. A warning is reported via the LibLogger whenever you forget this.
  *
+ * Data change events are delivered synchronously by default, i.e. the
+ * listener is called from within the writer's Interface::write(). If the
+ * listener is registered with BlackBoard::BBIL_FLAG_ASYNC the event is
+ * only put into a bounded per-listener queue and the listener is called
+ * later from a dispatcher thread. This decouples slow listeners (loggers,
+ * synchronization to remote blackboards) from the writing thread. When the
+ * callback is executed the interface may already have been written again,
+ * listeners must therefore always read() the current data and not count
+ * on seeing every single update. The queue size and overflow policy can be
+ * set with bbil_set_async_queue() before registration, queue length and lag
+ * are available through the bbil_async_* accessors for monitoring.
+ * Message, reader and writer events are always delivered synchronously.
+ *
  * @author Tim Niemueller
  * @see BlackBoardInterfaceManager::register_listener()
  * @see BlackBoardInterfaceManager::unregister_listener()
@@ -94,6 +108,9 @@ BlackBoardInterfaceListener::BlackBoardInterfaceListener(const char *name_format
 
 	bbil_queue_mutex_ = new Mutex();
 	bbil_maps_mutex_  = new Mutex();
+
+	bbil_async_       = false;
+	bbil_async_queue_ = NULL;
 }
 
 /** Destructor. */
@@ -103,6 +120,7 @@ BlackBoardInterfaceListener::~BlackBoardInterfaceListener()
 
 	delete bbil_queue_mutex_;
 	delete bbil_maps_mutex_;
+	delete bbil_async_queue_;
 }
 
 /** Get BBIL name.
@@ -508,4 +526,87 @@ BlackBoardInterfaceListener::bbil_writer_interface(const char *iuid) throw()
 	return bbil_find_interface(iuid, bbil_maps_.writer);
 }
 
+/** Set asynchronous event queue parameters.
+ * This only has an effect if the listener is registered with
+ * BlackBoard::BBIL_FLAG_ASYNC and must be called before the listener is
+ * registered. If not called a queue of BLACKBOARD_ASYNC_QUEUE_SIZE
+ * entries with the ASYNC_COALESCE policy is used. Be careful with
+ * ASYNC_BLOCK, a listener which writes to an interface it listens to
+ * from within its callback can dead-lock itself.
+ * @param size maximum number of pending events
+ * @param policy policy to apply if the queue is full
+ */
+void
+BlackBoardInterfaceListener::bbil_set_async_queue(unsigned int size, AsyncOverflowPolicy policy)
+{
+	if (bbil_async_) {
+		throw Exception("BBIL[%s]: cannot change async queue while registered", name_);
+	}
+	delete bbil_async_queue_;
+	bbil_async_queue_ = new BlackBoardAsyncQueue(size, policy);
+}
+
+/** Check if data change events are delivered asynchronously.
+ * @return true if the listener is registered for asynchronous delivery
+ */
+bool
+BlackBoardInterfaceListener::bbil_async() const
+{
+	return bbil_async_;
+}
+
+/** Get asynchronous event queue size.
+ * @return maximum number of pending events, 0 if no async queue exists
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_queue_size() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->size() : 0;
+}
+
+/** Get asynchronous event queue length.
+ * @return number of currently pending events
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_queue_length() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->length() : 0;
+}
+
+/** Get asynchronous delivery lag.
+ * @return age in seconds of the oldest pending event
+ */
+float
+BlackBoardInterfaceListener::bbil_async_lag() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->lag() : 0.;
+}
+
+/** Get maximum asynchronous delivery lag.
+ * @return maximum time in seconds an event was pending before delivery
+ */
+float
+BlackBoardInterfaceListener::bbil_async_max_lag() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->max_lag() : 0.;
+}
+
+/** Get number of dropped asynchronous events.
+ * @return number of events dropped because the queue was full
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_num_dropped() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->num_dropped() : 0;
+}
+
+/** Get number of coalesced asynchronous events.
+ * @return number of events merged with an already pending event
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_num_coalesced() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->num_coalesced() : 0;
+}
+
 } // end namespace fawkes
@@ -37,10 +37,13 @@ namespace fawkes {
 class Interface;
 class Message;
 class BlackBoardNotifier;
+class BlackBoardAsyncQueue;
+class BlackBoardAsyncDispatcher;
 
 class BlackBoardInterfaceListener
 {
 	friend BlackBoardNotifier;
+	friend BlackBoardAsyncDispatcher;
 
 public:
 	/** Queue entry type. */
@@ -65,6 +68,13 @@ public:
 	/** Map of currently active event subscriptions. */
 	typedef std::map<std::string, Interface *> InterfaceMap;
 
+	/** Overflow policy for asynchronous data change delivery. */
+	typedef enum {
+		ASYNC_COALESCE,    ///< keep at most one pending event per interface
+		ASYNC_DROP_OLDEST, ///< drop the oldest pending event
+		ASYNC_BLOCK        ///< block the writer until there is space
+	} AsyncOverflowPolicy;
+
 	/** Structure to hold maps for active subscriptions. */
 	typedef struct
 	{
@@ -79,6 +89,14 @@ public:
 
 	const char *bbil_name() const;
 
+	bool         bbil_async() const;
+	unsigned int bbil_async_queue_size() const;
+	unsigned int bbil_async_queue_length() const;
+	float        bbil_async_lag() const;
+	float        bbil_async_max_lag() const;
+	unsigned int bbil_async_num_dropped() const;
+	unsigned int bbil_async_num_coalesced() const;
+
 	virtual void bb_interface_data_changed(Interface *interface) throw();
 	virtual bool bb_interface_message_received(Interface *interface, Message *message) throw();
 	virtual void bb_interface_writer_added(Interface *  interface,
@@ -106,6 +124,8 @@ protected:
 	Interface *bbil_reader_interface(const char *iuid) throw();
 	Interface *bbil_writer_interface(const char *iuid) throw();
 
+	void bbil_set_async_queue(unsigned int size, AsyncOverflowPolicy policy);
+
 private:
 	void       bbil_queue_add(QueueEntryType type,
 	                          bool           op,
@@ -127,6 +147,9 @@ private:
 	InterfaceMaps  bbil_maps_;
 	InterfaceQueue bbil_queue_;
 
+	bool                  bbil_async_;
+	BlackBoardAsyncQueue *bbil_async_queue_;
+
 	char *name_;
 };
 
@@ -0,0 +1,430 @@
+
+/***************************************************************************
+ *  async_dispatcher.cpp - BlackBoard asynchronous listener dispatcher
+ *
+ *  Created: Sun Oct 18 16:21:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/internal/async_dispatcher.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <logging/liblogger.h>
+
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
+
+/** Maximum number of events delivered to one listener before the worker
+ * moves on to the next ready listener. */
+#define BBAD_MAX_BATCH 16
+
+namespace fawkes {
+
+/** @class BlackBoardAsyncQueue <blackboard/internal/async_dispatcher.h>
+ * Bounded per-listener event queue for asynchronous data change delivery.
+ * The queue is a preallocated ring of interface UIDs and enqueue
+ * times. Writers push events from within Interface::write(), the
+ * dispatcher pops them from a worker thread. Access is guarded by a
+ * per-listener mutex which is held only for the duration of the copy,
+ * never during the listener callback.
+ *
+ * What happens if the queue is full depends on the overflow policy:
+ * with ASYNC_COALESCE there is at most one pending event per interface
+ * (the listener will read the latest data anyway) and the oldest event
+ * is dropped if more distinct interfaces are pending than slots are
+ * available, with ASYNC_DROP_OLDEST the oldest event is dropped, and
+ * with ASYNC_BLOCK the writer waits until the dispatcher made room.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param size maximum number of pending events
+ * @param policy overflow policy
+ */
+BlackBoardAsyncQueue::BlackBoardAsyncQueue(unsigned int                                     size,
+                                           BlackBoardInterfaceListener::AsyncOverflowPolicy policy)
+{
+	if (size == 0)
+		size = 1;
+
+	mutex_  = new Mutex();
+	cond_   = new WaitCondition(mutex_);
+	policy_ = policy;
+	events_ = new Event[size];
+	size_   = size;
+	head_   = 0;
+	length_ = 0;
+
+	scheduled_   = false;
+	dispatching_ = false;
+	closed_      = true;
+
+	num_dropped_   = 0;
+	num_coalesced_ = 0;
+	max_lag_       = 0.;
+}
+
+/** Destructor. */
+BlackBoardAsyncQueue::~BlackBoardAsyncQueue()
+{
+	delete[] events_;
+	delete cond_;
+	delete mutex_;
+}
+
+/** Get maximum number of pending events.
+ * @return queue capacity
+ */
+unsigned int
+BlackBoardAsyncQueue::size() const
+{
+	return size_;
+}
+
+/** Get number of currently pending events.
+ * @return queue length
+ */
+unsigned int
+BlackBoardAsyncQueue::length() const
+{
+	MutexLocker lock(mutex_);
+	return length_;
+}
+
+/** Get current lag.
+ * @return age of the oldest pending event in seconds, 0 if the queue is empty
+ */
+float
+BlackBoardAsyncQueue::lag() const
+{
+	MutexLocker lock(mutex_);
+	if (length_ == 0)
+		return 0.;
+	Time now;
+	return now - &events_[head_].enqueued;
+}
+
+/** Get maximum lag.
+ * @return maximum time in seconds an event was pending before delivery
+ */
+float
+BlackBoardAsyncQueue::max_lag() const
+{
+	MutexLocker lock(mutex_);
+	return max_lag_;
+}
+
+/** Get number of dropped events.
+ * @return number of events dropped due to overflow
+ */
+unsigned int
+BlackBoardAsyncQueue::num_dropped() const
+{
+	MutexLocker lock(mutex_);
+	return num_dropped_;
+}
+
+/** Get number of coalesced events.
+ * @return number of events merged with an already pending event
+ */
+unsigned int
+BlackBoardAsyncQueue::num_coalesced() const
+{
+	MutexLocker lock(mutex_);
+	return num_coalesced_;
+}
+
+/** Get overflow policy.
+ * @return overflow policy
+ */
+BlackBoardInterfaceListener::AsyncOverflowPolicy
+BlackBoardAsyncQueue::policy() const
+{
+	return policy_;
+}
+
+/** Push event, mutex must be locked.
+ * @param uid UID of interface which has changed
+ * @return true if the event has been queued, false if it was coalesced
+ * or the queue is closed
+ */
+bool
+BlackBoardAsyncQueue::push(const char *uid)
+{
+	if (policy_ == BlackBoardInterfaceListener::ASYNC_COALESCE) {
+		for (unsigned int i = 0; i < length_; ++i) {
+			if (strcmp(events_[(head_ + i) % size_].uid, uid) == 0) {
+				++num_coalesced_;
+				return false;
+			}
+		}
+	}
+
+	while (!closed_ && length_ == size_
+	       && policy_ == BlackBoardInterfaceListener::ASYNC_BLOCK) {
+		cond_->wait();
+	}
+	if (closed_)
+		return false;
+
+	if (length_ == size_) {
+		head_ = (head_ + 1) % size_;
+		--length_;
+		++num_dropped_;
+	}
+
+	Event &e = events_[(head_ + length_) % size_];
+	strncpy(e.uid, uid, INTERFACE_UID_SIZE_);
+	e.uid[INTERFACE_UID_SIZE_] = 0;
+	e.enqueued.stamp();
+	++length_;
+	return true;
+}
+
+/** Pop oldest event, mutex must be locked.
+ * @param uid upon successful return contains the UID of the changed interface,
+ * must be at least INTERFACE_UID_SIZE_ + 1 bytes
+ * @return true if an event was available, false otherwise
+ */
+bool
+BlackBoardAsyncQueue::pop(char *uid)
+{
+	if (closed_ || length_ == 0)
+		return false;
+
+	Event &e = events_[head_];
+	strcpy(uid, e.uid);
+	Time  now;
+	float lag = now - &e.enqueued;
+	if (lag > max_lag_)
+		max_lag_ = lag;
+
+	head_ = (head_ + 1) % size_;
+	--length_;
+	if (policy_ == BlackBoardInterfaceListener::ASYNC_BLOCK) {
+		cond_->wake_all();
+	}
+	return true;
+}
+
+/// @cond INTERNALS
+class BlackBoardAsyncDispatcher::WorkerThread : public Thread
+{
+public:
+	WorkerThread(BlackBoardAsyncDispatcher *dispatcher, unsigned int num)
+	: Thread("BlackBoardAsyncDispatcher", Thread::OPMODE_CONTINUOUS)
+	{
+		set_name("BlackBoardAsyncDispatcher %u", num);
+		dispatcher_ = dispatcher;
+	}
+
+	virtual void
+	loop()
+	{
+		dispatcher_->dispatch_next();
+	}
+
+private:
+	BlackBoardAsyncDispatcher *dispatcher_;
+};
+/// @endcond
+
+/** @class BlackBoardAsyncDispatcher <blackboard/internal/async_dispatcher.h>
+ * Dispatcher for asynchronous data change events.
+ * Listeners registered with BlackBoard::BBIL_FLAG_ASYNC are not called
+ * from within Interface::write(). Instead the event is pushed to the
+ * listener's BlackBoardAsyncQueue and the listener is marked ready. A
+ * small pool of worker threads picks ready listeners and delivers their
+ * pending events. A listener is handled by at most one worker at a time,
+ * hence events for one listener are delivered in order and callbacks of
+ * one listener never run concurrently. To keep one busy listener from
+ * starving the others a worker delivers at most a small batch of events
+ * before the listener is put back at the end of the ready list.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_threads number of worker threads to start
+ */
+BlackBoardAsyncDispatcher::BlackBoardAsyncDispatcher(unsigned int num_threads)
+{
+	mutex_ = new Mutex();
+	cond_  = new WaitCondition(mutex_);
+
+	for (unsigned int i = 0; i < std::max(num_threads, 1u); ++i) {
+		WorkerThread *t = new WorkerThread(this, i);
+		workers_.push_back(t);
+		t->start();
+	}
+}
+
+/** Destructor.
+ * Stops all worker threads, pending events are discarded.
+ */
+BlackBoardAsyncDispatcher::~BlackBoardAsyncDispatcher()
+{
+	for (unsigned int i = 0; i < workers_.size(); ++i) {
+		workers_[i]->cancel();
+		workers_[i]->join();
+		delete workers_[i];
+	}
+	workers_.clear();
+
+	delete cond_;
+	delete mutex_;
+}
+
+/** Enable asynchronous delivery for listener.
+ * @param listener listener whose queue to open, must have an async queue
+ */
+void
+BlackBoardAsyncDispatcher::add(BlackBoardInterfaceListener *listener)
+{
+	BlackBoardAsyncQueue *q = listener->bbil_async_queue_;
+	MutexLocker           lock(q->mutex_);
+	q->closed_ = false;
+}
+
+/** Enqueue data change event.
+ * @param listener listener to notify
+ * @param uid UID of the interface which has changed
+ */
+void
+BlackBoardAsyncDispatcher::enqueue(BlackBoardInterfaceListener *listener, const char *uid)
+{
+	BlackBoardAsyncQueue *q = listener->bbil_async_queue_;
+
+	q->mutex_->lock();
+	bool schedule = false;
+	if (q->push(uid) && !q->scheduled_ && !q->dispatching_) {
+		q->scheduled_ = true;
+		schedule      = true;
+	}
+	q->mutex_->unlock();
+
+	if (schedule) {
+		// lock order is always dispatcher before queue
+		MutexLocker lock(mutex_);
+		q->mutex_->lock();
+		if (q->scheduled_ && !q->closed_) {
+			ready_.push_back(listener);
+			cond_->wake_one();
+		}
+		q->mutex_->unlock();
+	}
+}
+
+/** Remove listener.
+ * Pending events are discarded. If a worker is currently delivering an
+ * event to the listener this method waits until the callback returned.
+ * Afterwards no more events will be delivered to the listener.
+ * @param listener listener to remove
+ */
+void
+BlackBoardAsyncDispatcher::remove(BlackBoardInterfaceListener *listener)
+{
+	BlackBoardAsyncQueue *q = listener->bbil_async_queue_;
+
+	mutex_->lock();
+	ready_.remove(listener);
+	q->mutex_->lock();
+	q->closed_    = true;
+	q->scheduled_ = false;
+	q->head_      = 0;
+	q->length_    = 0;
+	q->cond_->wake_all();
+	mutex_->unlock();
+
+	if (!workers_.empty()) {
+		for (unsigned int i = 0; i < workers_.size(); ++i) {
+			if (workers_[i]->thread_id() == Thread::current_thread_id()) {
+				// removed from within own callback, cannot wait for ourselves
+				q->mutex_->unlock();
+				return;
+			}
+		}
+	}
+	while (q->dispatching_) {
+		q->cond_->wait();
+	}
+	q->mutex_->unlock();
+}
+
+/** Wait for a ready listener and deliver its pending events.
+ * Called by the worker threads.
+ */
+void
+BlackBoardAsyncDispatcher::dispatch_next()
+{
+	mutex_->lock();
+	pthread_cleanup_push(cleanup_mutex, mutex_);
+	while (ready_.empty()) {
+		cond_->wait();
+	}
+	pthread_cleanup_pop(0);
+	BlackBoardInterfaceListener *listener = ready_.front();
+	ready_.pop_front();
+	BlackBoardAsyncQueue *q = listener->bbil_async_queue_;
+	q->mutex_->lock();
+	q->scheduled_   = false;
+	q->dispatching_ = true;
+	q->mutex_->unlock();
+	mutex_->unlock();
+
+	Thread::CancelState old_state;
+	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &old_state);
+
+	char uid[INTERFACE_UID_SIZE_ + 1];
+	for (unsigned int i = 0; i < BBAD_MAX_BATCH; ++i) {
+		q->mutex_->lock();
+		bool have_event = q->pop(uid);
+		q->mutex_->unlock();
+		if (!have_event)
+			break;
+
+		Interface *iface = listener->bbil_data_interface(uid);
+		if (iface != NULL) {
+			listener->bb_interface_data_changed(iface);
+		} else {
+			LibLogger::log_warn("BlackBoardAsyncDispatcher",
+			                    "BBIL[%s] registered for data change events "
+			                    "for '%s' but has no such interface",
+			                    listener->bbil_name(),
+			                    uid);
+		}
+	}
+
+	mutex_->lock();
+	q->mutex_->lock();
+	q->dispatching_ = false;
+	if (!q->closed_ && q->length_ > 0) {
+		q->scheduled_ = true;
+		ready_.push_back(listener);
+		cond_->wake_one();
+	}
+	q->cond_->wake_all();
+	q->mutex_->unlock();
+	mutex_->unlock();
+
+	Thread::set_cancel_state(old_state);
+}
+
+} // end namespace fawkes
@@ -0,0 +1,111 @@
+
+/***************************************************************************
+ *  async_dispatcher.h - BlackBoard asynchronous listener dispatcher
+ *
+ *  Created: Sun Oct 18 16:21:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_INTERNAL_ASYNC_DISPATCHER_H_
+#define _BLACKBOARD_INTERNAL_ASYNC_DISPATCHER_H_
+
+#include <blackboard/interface_listener.h>
+#include <interface/interface.h>
+#include <utils/time/time.h>
+
+#include <list>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+
+class BlackBoardAsyncQueue
+{
+	friend class BlackBoardAsyncDispatcher;
+
+public:
+	BlackBoardAsyncQueue(unsigned int size, BlackBoardInterfaceListener::AsyncOverflowPolicy policy);
+	~BlackBoardAsyncQueue();
+
+	unsigned int size() const;
+	unsigned int length() const;
+	float        lag() const;
+	float        max_lag() const;
+	unsigned int num_dropped() const;
+	unsigned int num_coalesced() const;
+
+	BlackBoardInterfaceListener::AsyncOverflowPolicy policy() const;
+
+private:
+	bool push(const char *uid);
+	bool pop(char *uid);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		char uid[INTERFACE_UID_SIZE_ + 1];
+		Time enqueued;
+	} Event;
+	/// @endcond
+
+	Mutex *        mutex_;
+	WaitCondition *cond_;
+
+	BlackBoardInterfaceListener::AsyncOverflowPolicy policy_;
+
+	Event *      events_;
+	unsigned int size_;
+	unsigned int head_;
+	unsigned int length_;
+
+	bool scheduled_;
+	bool dispatching_;
+	bool closed_;
+
+	unsigned int num_dropped_;
+	unsigned int num_coalesced_;
+	float        max_lag_;
+};
+
+class BlackBoardAsyncDispatcher
+{
+public:
+	BlackBoardAsyncDispatcher(unsigned int num_threads);
+	~BlackBoardAsyncDispatcher();
+
+	void add(BlackBoardInterfaceListener *listener);
+	void enqueue(BlackBoardInterfaceListener *listener, const char *uid);
+	void remove(BlackBoardInterfaceListener *listener);
+
+private:
+	class WorkerThread;
+	void dispatch_next();
+
+private:
+	Mutex *                                  mutex_;
+	WaitCondition *                          cond_;
+	std::list<BlackBoardInterfaceListener *> ready_;
+	std::vector<WorkerThread *>              workers_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -45,6 +45,29 @@
 
 namespace fawkes {
 
+/** Calculate index key for interface.
+ * This is a 32 bit FNV-1a hash over type and identifier. The strings are
+ * considered up to the maximum interface type and ID lengths, just like
+ * they are stored in the interface header.
+ * @param type type of the interface
+ * @param identifier identifier of the interface
+ * @return index key for the given interface
+ */
+static unsigned int
+interface_key(const char *type, const char *identifier)
+{
+	uint32_t h = 2166136261u;
+	for (size_t i = 0; (i < INTERFACE_TYPE_SIZE_) && (type[i] != 0); ++i) {
+		h = (h ^ (unsigned char)type[i]) * 16777619u;
+	}
+	// separator, avoids collisions for different splits of type and ID
+	h = (h ^ (unsigned char)':') * 16777619u;
+	for (size_t i = 0; (i < INTERFACE_ID_SIZE_) && (identifier[i] != 0); ++i) {
+		h = (h ^ (unsigned char)identifier[i]) * 16777619u;
+	}
+	return h;
+}
+
 /** @class BlackBoardInterfaceManager <blackboard/internal/interface_manager.h>
  * BlackBoard interface manager.
  * This class is used by the BlackBoard to manage interfaces stored in the
@@ -69,6 +92,7 @@ BlackBoardInterfaceManager::BlackBoardInterfaceManager(BlackBoardMemoryManager *
 	notifier = bb_notifier;
 
 	instance_serial  = 1;
+	mem_serial       = 1;
 	instance_factory = new BlackBoardInstanceFactory();
 	mutex            = new Mutex();
 
@@ -131,6 +155,9 @@ BlackBoardInterfaceManager::delete_interface_instance(Interface *interface)
 }
 
 /** search memory chunks if the desired interface has been allocated already.
+ * Interface chunks are indexed by the memory manager with a hash of type
+ * and identifier, therefore only the chunks with a matching hash have to
+ * be compared.
  * @param type type of the interface to look for
  * @param identifier identifier of the interface to look for
  * @return a pointer to the memory of the interface or NULL if not found
@@ -138,14 +165,15 @@ BlackBoardInterfaceManager::delete_interface_instance(Interface *interface)
 void *
 BlackBoardInterfaceManager::find_interface_in_memory(const char *type, const char *identifier)
 {
-	interface_header_t *                   ih;
-	BlackBoardMemoryManager::ChunkIterator cit;
-	for (cit = memmgr->begin(); cit != memmgr->end(); ++cit) {
-		ih = (interface_header_t *)*cit;
+	unsigned int key    = interface_key(type, identifier);
+	unsigned int cookie = 0;
+	void *       ptr;
+	while ((ptr = memmgr->find(key, cookie)) != NULL) {
+		interface_header_t *ih = (interface_header_t *)ptr;
 		if ((strncmp(ih->type, type, INTERFACE_TYPE_SIZE_) == 0)
 		    && (strncmp(ih->id, identifier, INTERFACE_ID_SIZE_) == 0)) {
 			// found it!
-			return *cit;
+			return ptr;
 		}
 	}
 
@@ -153,22 +181,14 @@ BlackBoardInterfaceManager::find_interface_in_memory(const char *type, const cha
 }
 
 /** Get next mem serial.
+ * Only the master creates interfaces, therefore serials are simply counted
+ * up and never re-used during the lifetime of the BlackBoard.
  * @return next unique memory serial
  */
 unsigned int
 BlackBoardInterfaceManager::next_mem_serial()
 {
-	unsigned int                           serial = 1;
-	interface_header_t *                   ih;
-	BlackBoardMemoryManager::ChunkIterator cit;
-	for (cit = memmgr->begin(); cit != memmgr->end(); ++cit) {
-		ih = (interface_header_t *)*cit;
-		if (ih->serial >= serial) {
-			serial = ih->serial + 1;
-		}
-	}
-
-	return serial;
+	return mem_serial++;
 }
 
 /** Get next instance serial.
@@ -207,7 +227,8 @@ BlackBoardInterfaceManager::create_interface(const char *type,
 	// create new interface and allocate appropriate chunk
 	interface = new_interface_instance(type, identifier, owner);
 	try {
-		ptr = memmgr->alloc_nolock(interface->datasize() + sizeof(interface_header_t));
+		ptr = memmgr->alloc_nolock(interface->datasize() + sizeof(interface_header_t),
+		                           interface_key(type, identifier));
 		ih  = (interface_header_t *)ptr;
 	} catch (OutOfMemoryException &e) {
 		e.append(
@@ -226,10 +247,32 @@ BlackBoardInterfaceManager::create_interface(const char *type,
 	ih->refcount           = 0;
 	ih->serial             = next_mem_serial();
 	ih->flag_writer_active = 0;
+	ih->flag_seqlock       = 0;
 	ih->num_readers        = 0;
+	ih->seqlock            = 0;
 	rwlocks[ih->serial]    = new RefCountRWLock();
 
+	for (std::list<std::string>::iterator t = seqlock_types_.begin(); t != seqlock_types_.end();
+	     ++t) {
+		if (fnmatch(t->c_str(), type, 0) == 0) {
+			ih->flag_seqlock = 1;
+			break;
+		}
+	}
+
+	set_memory(interface, ptr);
+}
+
+/** Assign interface memory to interface instance.
+ * @param interface interface to assign memory to
+ * @param ptr pointer to the interface memory chunk
+ */
+void
+BlackBoardInterfaceManager::set_memory(Interface *interface, void *ptr)
+{
+	interface_header_t *ih = (interface_header_t *)ptr;
 	interface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+	interface->set_seqlock(ih->flag_seqlock ? &ih->seqlock : NULL);
 }
 
 /** Open interface for reading.
@@ -276,7 +319,7 @@ BlackBoardInterfaceManager::open_for_reading(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			set_memory(iface, ptr);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -356,7 +399,7 @@ BlackBoardInterfaceManager::open_multiple_for_reading(const char *type_pattern,
 
 			void *ptr = *cit;
 			iface     = new_interface_instance(ih->type, ih->id, owner);
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			set_memory(iface, ptr);
 
 			if ((iface->hash_size() != INTERFACE_HASH_SIZE_)
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
@@ -445,7 +488,7 @@ BlackBoardInterfaceManager::open_for_writing(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			set_memory(iface, ptr);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -693,6 +736,22 @@ BlackBoardInterfaceManager::writer(const Interface *interface) const
 	return rv;
 }
 
+/** Set interface types that use a seqlock.
+ * Interfaces of a type matching any of the given patterns that are created
+ * afterwards guard their data in the shared memory by a seqlock instead of
+ * a read/write lock. Readers then never block the writer, which benefits
+ * interfaces that are read at a high rate by many readers. Interfaces
+ * which already exist keep their current mode.
+ * @param type_patterns list of type patterns, may contain shell-like
+ * wildcards, cf. man fnmatch(). Pass "*" to use seqlocks for all types.
+ */
+void
+BlackBoardInterfaceManager::set_seqlock_types(const std::list<std::string> &type_patterns)
+{
+	MutexLocker lock(mutex);
+	seqlock_types_ = type_patterns;
+}
+
 /** Get owners of interfaces who opened for reading.
  * @param uid UID of interface to query for
  * @return list of readers for this interface
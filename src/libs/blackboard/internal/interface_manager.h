@@ -76,6 +76,8 @@ public:
 	std::list<std::string> readers(const std::string &uid) const;
 	std::string            writer(const std::string &uid) const;
 
+	void set_seqlock_types(const std::list<std::string> &type_patterns);
+
 private:
 	const BlackBoardMemoryManager *memory_manager() const;
 
@@ -92,9 +94,11 @@ private:
 	                              void *&     ptr);
 
 	Interface *writer_for_mem_serial(unsigned int mem_serial);
+	void       set_memory(Interface *interface, void *ptr);
 
 private:
 	unsigned int instance_serial;
+	unsigned int mem_serial;
 
 	BlackBoardMemoryManager *  memmgr;
 	BlackBoardMessageManager * msgmgr;
@@ -102,6 +106,8 @@ private:
 	BlackBoardInstanceFactory *instance_factory;
 	BlackBoardNotifier *       notifier;
 
+	std::list<std::string> seqlock_types_;
+
 	LockMap<unsigned int, Interface *>      writer_interfaces;
 	LockMap<unsigned int, RefCountRWLock *> rwlocks;
 
@@ -39,10 +39,12 @@ typedef struct
 	char          id[INTERFACE_ID_SIZE_];     /**< interface identifier */
 	unsigned char hash[INTERFACE_HASH_SIZE_]; /**< interface type version hash */
 	uint16_t      flag_writer_active : 1;     /**< 1 if there is a writer, 0 otherwise */
-	uint16_t      flag_reserved : 15;         /**< reserved for future use */
+	uint16_t      flag_seqlock : 1;           /**< 1 if data is guarded by seqlock, 0 for rwlock */
+	uint16_t      flag_reserved : 14;         /**< reserved for future use */
 	uint16_t      num_readers;                /**< number of active readers */
 	uint32_t      refcount;                   /**< reference count */
 	uint32_t      serial;                     /**< memory serial */
+	uint32_t      seqlock;                    /**< seqlock sequence counter, odd while writing */
 } interface_header_t;
 
 } // end namespace fawkes
@@ -44,6 +44,16 @@
  */
 #define BBMM_MIN_FREE_CHUNK_SIZE sizeof(chunk_list_t)
 
+/** Size class of chunks too big for the fixed size classes. */
+#define BBMM_SC_HUGE (BBMM_NUM_SIZE_CLASSES - 1)
+/** Sizes of chunks in the huge size class are rounded up to this many bytes. */
+#define BBMM_SC_HUGE_GRANULARITY 4096
+/** Flag marking a free chunk of the size class allocator. */
+#define BBMM_CHUNK_FREE 1
+/** Flag marking a chunk of the size class allocator whose predecessor in
+ * memory is free, the predecessor's size is then stored in front of the chunk. */
+#define BBMM_CHUNK_PREV_FREE 2
+
 // shortcuts
 #define chunk_ptr(a) (shmem_ ? (chunk_list_t *)shmem_->ptr(a) : a)
 #define chunk_addr(a) (shmem_ ? (chunk_list_t *)shmem_->addr(a) : a)
@@ -80,6 +90,37 @@ namespace fawkes {
  * of free memory are merged to one. Afterwards the free chunks list will contain
  * non-ajdacent free memory regions of maximum size between allocated chunks.
  *
+ * Chunks can optionally be allocated with a key, for example a hash of the
+ * interface type and ID. Such chunks are recorded in the chunk index, an
+ * open-addressing hash table with linear probing that is kept next to the
+ * list heads (in the shared memory header if shared memory is used, so that
+ * it is available to all processes attaching to the segment). It allows to
+ * find an allocated chunk by its key in constant time instead of walking
+ * the allocated chunks list. The index is maintained by alloc() and free().
+ *
+ * Alternatively the memory manager can use segregated size classes
+ * (ALLOCATOR_SIZE_CLASS). Requested sizes are rounded up to the next size
+ * class: multiples of 16 bytes up to 256 bytes, and four classes per power
+ * of two beyond that. Chunks are carved from the wilderness, i.e. the not
+ * yet used memory at the end of the segment. A free chunk is kept in the
+ * free list of the largest class it can serve. An allocation takes a chunk
+ * from the free list of the class, from the wilderness, or, if memory is
+ * exhausted, from the smallest non-empty larger class. If the chunk is big
+ * enough the remainder is split off as a new free chunk. When a chunk is
+ * freed it is merged with free neighbours, and a free chunk at the end of
+ * the chunk area is given back to the wilderness, so that alloc/free churn
+ * does not fragment the segment. Free chunks store their size at their end
+ * and the chunk following a free chunk is flagged, therefore both neighbours
+ * are found in constant time, and the free lists are doubly linked through
+ * the data area of free chunks to remove a neighbour in constant time.
+ * Chunks too large for the fixed classes are kept in a single list searched
+ * first-fit. The bytes lost by rounding up to the class size are reported
+ * as overhanging bytes. As free chunks are not on an address-ordered list
+ * in this mode, the ChunkIterator walks the chunks in memory and skips free
+ * ones, hence allocated chunks are still visited in ascending address order.
+ * All list heads are stored as shared memory addresses, and the wilderness
+ * as an offset.
+ *
  * The memory manager is thread-safe as all appropriate operations are protected
  * by a mutex.
  *
@@ -94,11 +135,91 @@ namespace fawkes {
  * @see Mutex
  */
 
+/** Get size class for the given size.
+ * @param size requested chunk size
+ * @return size class, BBMM_SC_HUGE if the size exceeds all fixed classes
+ */
+static unsigned int
+sc_class(unsigned int size)
+{
+	if (size <= 256) {
+		return (size > 0) ? (size + 15) / 16 - 1 : 0;
+	}
+	// four classes per power of two, size in (2^p, 2^(p+1)]
+	unsigned int p    = 31 - __builtin_clz(size - 1);
+	unsigned int step = 1u << (p - 2);
+	unsigned int j    = (size - (1u << p) + step - 1) / step - 1;
+	unsigned int c    = 16 + 4 * (p - 8) + j;
+	return (c < BBMM_SC_HUGE) ? c : BBMM_SC_HUGE;
+}
+
+/** Get chunk size of a fixed size class.
+ * @param size_class size class, must be smaller than BBMM_SC_HUGE
+ * @return size of chunks in the given class
+ */
+static unsigned int
+sc_class_size(unsigned int size_class)
+{
+	if (size_class < 16) {
+		return (size_class + 1) * 16;
+	}
+	unsigned int base = 256u << ((size_class - 16) / 4);
+	return base + ((size_class - 16) % 4 + 1) * (base / 4);
+}
+
+/** Get size class whose free list holds a free chunk of the given size.
+ * This is the largest class whose chunk size does not exceed the given
+ * size, so that any chunk in a free list can serve its class.
+ * @param size chunk size, at least the size of the smallest class
+ * @return size class, BBMM_SC_HUGE if the size exceeds all fixed classes
+ */
+static unsigned int
+sc_free_class(unsigned int size)
+{
+	unsigned int c = sc_class(size);
+	if ((c < BBMM_SC_HUGE) && (sc_class_size(c) > size)) {
+		--c;
+	}
+	return c;
+}
+
+/** Get chunk following the given one in memory.
+ * @param chunk chunk
+ * @return chunk directly behind the data of the given chunk
+ */
+static inline chunk_list_t *
+sc_next_chunk(chunk_list_t *chunk)
+{
+	return (chunk_list_t *)((char *)chunk + sizeof(chunk_list_t) + chunk->size);
+}
+
+/** Get previous free list element of a free chunk.
+ * It is stored at the beginning of the data of the free chunk.
+ * @param chunk free chunk
+ * @return reference to the shared memory address of the previous element
+ */
+static inline chunk_list_t *&
+sc_prev_link(chunk_list_t *chunk)
+{
+	return *(chunk_list_t **)((char *)chunk + sizeof(chunk_list_t));
+}
+
+/** Get size stored at the end of a free chunk.
+ * @param next chunk following the free chunk
+ * @return reference to the size of the free chunk in front of next
+ */
+static inline unsigned int &
+sc_prev_size(chunk_list_t *next)
+{
+	return *(unsigned int *)((char *)next - sizeof(unsigned int));
+}
+
 /** Heap Memory Constructor.
  * Constructs a memory segment on the heap.
  * @param memsize memory size
+ * @param allocator allocation strategy
  */
-BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
+BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize, Allocator allocator)
 {
 	shmem_        = NULL;
 	shmem_header_ = NULL;
@@ -106,18 +227,29 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
 	memory_       = malloc(memsize);
 	mutex_        = new Mutex();
 	master_       = true;
+	allocator_    = allocator;
+	memset(&sc_heap_, 0, sizeof(sc_heap_));
 
 	// Lock memory to RAM to avoid swapping
 	mlock(memory_, memsize_);
 
-	chunk_list_t *f = (chunk_list_t *)memory_;
-	f->ptr          = (char *)f + sizeof(chunk_list_t);
-	f->size         = memsize_ - sizeof(chunk_list_t);
-	f->overhang     = 0;
-	f->next         = NULL;
+	if (allocator_ == ALLOCATOR_BEST_FIT) {
+		chunk_list_t *f = (chunk_list_t *)memory_;
+		f->ptr          = (char *)f + sizeof(chunk_list_t);
+		f->size         = memsize_ - sizeof(chunk_list_t);
+		f->overhang     = 0;
+		f->key          = 0;
+		f->flags        = 0;
+		f->next         = NULL;
 
-	free_list_head_  = f;
+		free_list_head_ = f;
+	} else {
+		free_list_head_ = NULL;
+	}
 	alloc_list_head_ = NULL;
+
+	index_         = (chunk_index_t *)calloc(BBMM_INDEX_SIZE, sizeof(chunk_index_t));
+	index_entries_ = 0;
 }
 
 /** Shared Memory Constructor
@@ -126,6 +258,8 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
  * @param version version of the BlackBoard
  * @param master master mode, this memory manager has to be owner of shared memory segment
  * @param shmem_token shared memory token, passed to SharedMemory
+ * @param allocator allocation strategy, only used in master mode, otherwise
+ * the strategy of the existing segment is used
  * @exception BBMemMgrNotMasterException A matching shared memory segment
  * has already been created.
  * @see SharedMemory::SharedMemory()
@@ -133,11 +267,15 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
 BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
                                                  unsigned int version,
                                                  bool         master,
-                                                 const char * shmem_token)
+                                                 const char * shmem_token,
+                                                 Allocator    allocator)
 {
-	memory_  = NULL;
-	memsize_ = memsize;
-	master_  = master;
+	memory_        = NULL;
+	memsize_       = memsize;
+	master_        = master;
+	index_         = NULL;
+	index_entries_ = 0;
+	memset(&sc_heap_, 0, sizeof(sc_heap_));
 
 	// open shared memory segment, if it exists try to aquire exclusive
 	// semaphore, if that fails, throw an exception
@@ -182,15 +320,23 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
 		// ressource limit for this process!
 		shmem_->set_swapable(false);
 
-		chunk_list_t *f = (chunk_list_t *)shmem_->memptr();
-		f->ptr          = shmem_->addr((char *)f + sizeof(chunk_list_t));
-		f->size         = memsize_ - sizeof(chunk_list_t);
-		f->overhang     = 0;
-		f->next         = NULL;
-
-		shmem_header_->set_free_list_head(f);
+		shmem_header_->set_allocator(allocator);
+		if (allocator == ALLOCATOR_BEST_FIT) {
+			chunk_list_t *f = (chunk_list_t *)shmem_->memptr();
+			f->ptr          = shmem_->addr((char *)f + sizeof(chunk_list_t));
+			f->size         = memsize_ - sizeof(chunk_list_t);
+			f->overhang     = 0;
+			f->key          = 0;
+			f->flags        = 0;
+			f->next         = NULL;
+
+			shmem_header_->set_free_list_head(f);
+		} else {
+			shmem_header_->set_free_list_head(NULL);
+		}
 		shmem_header_->set_alloc_list_head(NULL);
 	}
+	allocator_ = (Allocator)shmem_header_->allocator();
 
 	mutex_ = new Mutex();
 }
@@ -204,6 +350,9 @@ BlackBoardMemoryManager::~BlackBoardMemoryManager()
 	if (memory_) {
 		::free(memory_);
 	}
+	if (index_) {
+		::free(index_);
+	}
 	delete mutex_;
 }
 
@@ -219,6 +368,10 @@ BlackBoardMemoryManager::~BlackBoardMemoryManager()
 void *
 BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		return sc_alloc(num_bytes);
+	}
+
 	// search for smallest chunk just big enough for desired size
 	chunk_list_t *l = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
 
@@ -264,6 +417,8 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 		                  : (char *)nfc + sizeof(chunk_list_t);
 		nfc->size     = f->size - num_bytes - sizeof(chunk_list_t);
 		nfc->overhang = 0;
+		nfc->key      = 0;
+		nfc->flags    = 0;
 
 		if (shmem_) {
 			shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), nfc));
@@ -278,6 +433,7 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 		// this is only informational!
 		f->overhang = f->size - num_bytes;
 	}
+	f->key = 0;
 
 	// alloc new chunk
 	if (shmem_) {
@@ -289,6 +445,31 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 	}
 }
 
+/** Allocate indexed memory.
+ * Like alloc_nolock(unsigned int), but additionally records the chunk with the
+ * given key in the chunk index. Note: this method does NOT lock the shared memory
+ * system. Chaos and havoc will come down upon you if you do not ensure locking!
+ * @exception OutOfMemoryException thrown if not enough free memory is available to
+ *                                 accommodate a chunk of the desired size or if
+ *                                 the chunk index is full
+ * @param num_bytes number of bytes to allocate
+ * @param key key to record the chunk with in the index
+ * @return pointer to the memory chunk
+ */
+void *
+BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes, unsigned int key)
+{
+	unsigned int entries = shmem_ ? shmem_header_->index_entries() : index_entries_;
+	// keep at least one slot empty, probing relies on it for termination
+	if (entries >= BBMM_INDEX_SIZE - 1) {
+		throw OutOfMemoryException("BlackBoard chunk index is full");
+	}
+
+	void *ptr = alloc_nolock(num_bytes);
+	index_insert((chunk_list_t *)((char *)ptr - sizeof(chunk_list_t)), key);
+	return ptr;
+}
+
 /** Allocate memory.
  * This will allocate memory in the shared memory segment. The strategy is described
  * in the class description.
@@ -318,6 +499,38 @@ BlackBoardMemoryManager::alloc(unsigned int num_bytes)
 	return ptr;
 }
 
+/** Allocate indexed memory.
+ * This will allocate memory in the shared memory segment and record it with
+ * the given key in the chunk index. The chunk can then be found with find().
+ * Keys need not be unique, but many chunks with the same key degrade lookups.
+ * @exception OutOfMemoryException thrown if not enough free memory is available to
+ *                                 accommodate a chunk of the desired size or if
+ *                                 the chunk index is full
+ * @param num_bytes number of bytes to allocate
+ * @param key key to record the chunk with in the index
+ * @return pointer to the memory chunk
+ */
+void *
+BlackBoardMemoryManager::alloc(unsigned int num_bytes, unsigned int key)
+{
+	void *ptr;
+	mutex_->lock();
+	if (shmem_)
+		shmem_->lock_for_write();
+	try {
+		ptr = alloc_nolock(num_bytes, key);
+	} catch (Exception &e) {
+		if (shmem_)
+			shmem_->unlock();
+		mutex_->unlock();
+		throw;
+	}
+	if (shmem_)
+		shmem_->unlock();
+	mutex_->unlock();
+	return ptr;
+}
+
 /** Free a memory chunk.
  * Frees a previously allocated chunk. Not that you have to give the exact pointer
  * that was returned by alloc(). You may not give a pointer inside a memory chunk or
@@ -332,7 +545,20 @@ void
 BlackBoardMemoryManager::free(void *ptr)
 {
 	mutex_->lock();
-	if (shmem_) {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		if (shmem_)
+			shmem_->lock_for_write();
+		try {
+			sc_free(ptr);
+		} catch (Exception &e) {
+			if (shmem_)
+				shmem_->unlock();
+			mutex_->unlock();
+			throw;
+		}
+		if (shmem_)
+			shmem_->unlock();
+	} else if (shmem_) {
 		shmem_->lock_for_write();
 
 		// find chunk in alloc_chunks
@@ -341,8 +567,9 @@ BlackBoardMemoryManager::free(void *ptr)
 			throw BlackBoardMemMgrInvalidPointerException();
 		}
 
-		// remove from alloc_chunks
+		// remove from alloc_chunks and index
 		shmem_header_->set_alloc_list_head(list_remove(shmem_header_->alloc_list_head(), ac));
+		index_remove(ac);
 
 		// reclaim as free memory
 		ac->overhang = 0;
@@ -359,8 +586,9 @@ BlackBoardMemoryManager::free(void *ptr)
 			throw BlackBoardMemMgrInvalidPointerException();
 		}
 
-		// remove from alloc_chunks
+		// remove from alloc_chunks and index
 		alloc_list_head_ = list_remove(alloc_list_head_, ac);
+		index_remove(ac);
 
 		// reclaim as free memory
 		ac->overhang    = 0;
@@ -373,6 +601,44 @@ BlackBoardMemoryManager::free(void *ptr)
 	mutex_->unlock();
 }
 
+/** Find indexed chunk by key.
+ * Looks up chunks which have been allocated with the given key. Since keys
+ * need not be unique (e.g. in case of hash collisions) this may be called
+ * repeatedly to get all chunks with the given key. Initialize the cookie to
+ * zero before the first call and pass it unmodified to subsequent calls.
+ * @code
+ * unsigned int cookie = 0;
+ * void *       ptr;
+ * while ((ptr = memmgr->find(key, cookie)) != NULL) {
+ *   // check if ptr is the chunk you are looking for
+ * }
+ * @endcode
+ * Note: this method does NOT lock the memory, use lock() and unlock()
+ * around the lookup and the usage of the resulting chunk.
+ * @param key key to search for
+ * @param cookie lookup state, must be zero on the first call
+ * @return pointer to the memory chunk, or NULL if there are no (more)
+ * chunks with the given key
+ */
+void *
+BlackBoardMemoryManager::find(unsigned int key, unsigned int &cookie) const
+{
+	chunk_index_t *idx = index();
+
+	for (; cookie < BBMM_INDEX_SIZE; ++cookie) {
+		chunk_index_t &e = idx[(key + cookie) & (BBMM_INDEX_SIZE - 1)];
+		if (e.chunk == NULL)
+			break;
+		if (e.key == key) {
+			chunk_list_t *c = chunk_ptr(e.chunk);
+			++cookie;
+			return shmem_ ? shmem_->ptr(c->ptr) : c->ptr;
+		}
+	}
+	cookie = BBMM_INDEX_SIZE;
+	return NULL;
+}
+
 /** Check memory consistency.
  * This method checks the consistency of the memory segment. It controls whether
  * all the memory is covered by the free and allocated chunks lists and if there is
@@ -383,6 +649,11 @@ BlackBoardMemoryManager::free(void *ptr)
 void
 BlackBoardMemoryManager::check()
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		sc_check();
+		return;
+	}
+
 	chunk_list_t *f = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
 	chunk_list_t *a = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
 	chunk_list_t *t = NULL;
@@ -457,7 +728,22 @@ BlackBoardMemoryManager::is_master() const
 void
 BlackBoardMemoryManager::print_free_chunks_info() const
 {
-	list_print_info(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		size_class_heap_t *h = sc_heap();
+		for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+			if (h->heads[i]) {
+				if (i < BBMM_SC_HUGE) {
+					printf("Size class %2u (%u bytes):\n", i, sc_class_size(i));
+				} else {
+					printf("Size class %2u (huge):\n", i);
+				}
+				list_print_info(chunk_ptr(h->heads[i]));
+			}
+		}
+		printf("Wilderness: %u bytes\n", (unsigned int)(memsize_ - h->top));
+	} else {
+		list_print_info(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
+	}
 }
 
 /** Print out info about allocated chunks.
@@ -466,7 +752,18 @@ BlackBoardMemoryManager::print_free_chunks_info() const
 void
 BlackBoardMemoryManager::print_allocated_chunks_info() const
 {
-	list_print_info(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		unsigned int i = 0;
+		for (ChunkIterator c(shmem_, sc_base(), sc_top()); c != ChunkIterator(); ++c) {
+			printf("Chunk %3u:  0x%x   size=%10u bytes   overhang=%10u bytes\n",
+			       ++i,
+			       (unsigned int)(size_t)c.cur_->ptr,
+			       c.size(),
+			       c.overhang());
+		}
+	} else {
+		list_print_info(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
+	}
 }
 
 /** Prints out performance info.
@@ -478,8 +775,8 @@ void
 BlackBoardMemoryManager::print_performance_info() const
 {
 	printf("free chunks: %6u, alloc chunks: %6u, max free: %10u, max alloc: %10u, overhang: %10u\n",
-	       list_length(shmem_ ? shmem_header_->free_list_head() : free_list_head_),
-	       list_length(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_),
+	       num_free_chunks(),
+	       num_allocated_chunks(),
 	       max_free_size(),
 	       max_allocated_size(),
 	       overhang_size());
@@ -493,6 +790,22 @@ BlackBoardMemoryManager::print_performance_info() const
 unsigned int
 BlackBoardMemoryManager::max_free_size() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		size_class_heap_t *h = sc_heap();
+		unsigned int       m = 0;
+		if (memsize_ - h->top > sizeof(chunk_list_t)) {
+			m = memsize_ - h->top - sizeof(chunk_list_t);
+		}
+		// the biggest chunk is in the highest non-empty list
+		if (h->bitmap) {
+			chunk_list_t *b = list_get_biggest(chunk_ptr(h->heads[63 - __builtin_clzll(h->bitmap)]));
+			if (b->size > m) {
+				m = b->size;
+			}
+		}
+		return m;
+	}
+
 	chunk_list_t *m = list_get_biggest(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
 	if (m == NULL) {
 		return 0;
@@ -511,6 +824,20 @@ BlackBoardMemoryManager::max_free_size() const
 unsigned int
 BlackBoardMemoryManager::free_size() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		size_class_heap_t *h         = sc_heap();
+		unsigned int       free_size = 0;
+		if (memsize_ - h->top > sizeof(chunk_list_t)) {
+			free_size = memsize_ - h->top - sizeof(chunk_list_t);
+		}
+		for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+			for (chunk_list_t *l = chunk_ptr(h->heads[i]); l; l = chunk_ptr(l->next)) {
+				free_size += l->size;
+			}
+		}
+		return free_size;
+	}
+
 	unsigned int  free_size = 0;
 	chunk_list_t *l         = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
 	while (l) {
@@ -527,6 +854,14 @@ BlackBoardMemoryManager::free_size() const
 unsigned int
 BlackBoardMemoryManager::allocated_size() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		unsigned int alloc_size = 0;
+		for (ChunkIterator c(shmem_, sc_base(), sc_top()); c != ChunkIterator(); ++c) {
+			alloc_size += c.size();
+		}
+		return alloc_size;
+	}
+
 	unsigned int  alloc_size = 0;
 	chunk_list_t *l          = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
 	while (l) {
@@ -542,15 +877,39 @@ BlackBoardMemoryManager::allocated_size() const
 unsigned int
 BlackBoardMemoryManager::num_allocated_chunks() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		unsigned int num = 0;
+		for (ChunkIterator c(shmem_, sc_base(), sc_top()); c != ChunkIterator(); ++c) {
+			++num;
+		}
+		return num;
+	}
 	return list_length(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
 }
 
+/** Get number of indexed chunks.
+ * @return number of allocated memory chunks recorded in the chunk index
+ */
+unsigned int
+BlackBoardMemoryManager::num_indexed_chunks() const
+{
+	return shmem_ ? shmem_header_->index_entries() : index_entries_;
+}
+
 /** Get number of free chunks.
  * @return number of free memory chunks
  */
 unsigned int
 BlackBoardMemoryManager::num_free_chunks() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		size_class_heap_t *h   = sc_heap();
+		unsigned int       num = (memsize_ - h->top > sizeof(chunk_list_t)) ? 1 : 0;
+		for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+			num += list_length(chunk_ptr(h->heads[i]));
+		}
+		return num;
+	}
 	return list_length(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
 }
 
@@ -573,6 +932,15 @@ BlackBoardMemoryManager::version() const
 	return shmem_ ? shmem_header_->version() : 0;
 }
 
+/** Get allocation strategy.
+ * @return allocation strategy used for this memory segment
+ */
+BlackBoardMemoryManager::Allocator
+BlackBoardMemoryManager::allocator() const
+{
+	return allocator_;
+}
+
 /** Lock memory.
  * Locks the whole memory segment used and managed by the memory manager. Will
  * aquire local mutex lock and global semaphore lock in shared memory segment.
@@ -628,6 +996,15 @@ BlackBoardMemoryManager::unlock()
 unsigned int
 BlackBoardMemoryManager::max_allocated_size() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		unsigned int m = 0;
+		for (ChunkIterator c(shmem_, sc_base(), sc_top()); c != ChunkIterator(); ++c) {
+			if (c.size() > m)
+				m = c.size();
+		}
+		return m;
+	}
+
 	chunk_list_t *m = list_get_biggest(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
 	if (m == NULL) {
 		return 0;
@@ -644,6 +1021,14 @@ BlackBoardMemoryManager::max_allocated_size() const
 unsigned int
 BlackBoardMemoryManager::overhang_size() const
 {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		unsigned int overhang = 0;
+		for (ChunkIterator c(shmem_, sc_base(), sc_top()); c != ChunkIterator(); ++c) {
+			overhang += c.overhang();
+		}
+		return overhang;
+	}
+
 	unsigned int  overhang = 0;
 	chunk_list_t *a        = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
 	while (a) {
@@ -681,6 +1066,363 @@ BlackBoardMemoryManager::cleanup_free_chunks()
 	}
 }
 
+/** Get size class free lists.
+ * @return size class free lists, in the shared memory header if shared
+ * memory is used
+ */
+size_class_heap_t *
+BlackBoardMemoryManager::sc_heap() const
+{
+	return shmem_ ? shmem_header_->size_class_heap() : (size_class_heap_t *)&sc_heap_;
+}
+
+/** Get first chunk in memory.
+ * @return local pointer to the begin of the managed memory
+ */
+chunk_list_t *
+BlackBoardMemoryManager::sc_base() const
+{
+	return (chunk_list_t *)(shmem_ ? shmem_->memptr() : memory_);
+}
+
+/** Get wilderness.
+ * @return local pointer to the first byte that has not yet been carved into
+ * a chunk, this is the end of the chunk area
+ */
+chunk_list_t *
+BlackBoardMemoryManager::sc_top() const
+{
+	return (chunk_list_t *)((char *)sc_base() + sc_heap()->top);
+}
+
+/** Put chunk into the free list of its size class.
+ * The chunk must neither have a free predecessor nor a free successor and
+ * must not be the last chunk before the wilderness.
+ * @param chunk chunk to add
+ */
+void
+BlackBoardMemoryManager::sc_push(chunk_list_t *chunk)
+{
+	size_class_heap_t *h = sc_heap();
+	unsigned int       c = sc_free_class(chunk->size);
+
+	chunk->flags        = BBMM_CHUNK_FREE;
+	chunk->overhang     = 0;
+	chunk->key          = 0;
+	chunk->next         = h->heads[c];
+	sc_prev_link(chunk) = NULL;
+	if (h->heads[c]) {
+		sc_prev_link(chunk_ptr(h->heads[c])) = chunk_addr(chunk);
+	}
+	h->heads[c] = chunk_addr(chunk);
+	h->bitmap |= 1ull << c;
+
+	chunk_list_t *next = sc_next_chunk(chunk);
+	sc_prev_size(next) = chunk->size;
+	next->flags |= BBMM_CHUNK_PREV_FREE;
+}
+
+/** Remove free chunk from the free list of its size class.
+ * The chunk stays marked as free.
+ * @param chunk chunk to remove
+ */
+void
+BlackBoardMemoryManager::sc_unlink(chunk_list_t *chunk)
+{
+	size_class_heap_t *h    = sc_heap();
+	unsigned int       c    = sc_free_class(chunk->size);
+	chunk_list_t *     prev = sc_prev_link(chunk);
+
+	if (prev) {
+		chunk_ptr(prev)->next = chunk->next;
+	} else {
+		h->heads[c] = chunk->next;
+		if (h->heads[c] == NULL) {
+			h->bitmap &= ~(1ull << c);
+		}
+	}
+	if (chunk->next) {
+		sc_prev_link(chunk_ptr(chunk->next)) = prev;
+	}
+}
+
+/** Take chunk from its free list for allocation.
+ * The chunk is removed from the free list and marked as allocated.
+ * @param chunk free chunk
+ */
+void
+BlackBoardMemoryManager::sc_take(chunk_list_t *chunk)
+{
+	sc_unlink(chunk);
+	chunk->flags = 0;
+	sc_next_chunk(chunk)->flags &= ~BBMM_CHUNK_PREV_FREE;
+}
+
+/** Take first chunk from the free list of a size class.
+ * @param size_class size class, the free list must not be empty
+ * @return chunk removed from the list
+ */
+chunk_list_t *
+BlackBoardMemoryManager::sc_pop(unsigned int size_class)
+{
+	chunk_list_t *chunk = chunk_ptr(sc_heap()->heads[size_class]);
+	sc_take(chunk);
+	return chunk;
+}
+
+/** Allocate memory using the size class allocator.
+ * Note: this method does NOT lock the shared memory system.
+ * @param num_bytes number of bytes to allocate
+ * @return pointer to the memory chunk
+ * @exception OutOfMemoryException thrown if not enough free memory is available
+ */
+void *
+BlackBoardMemoryManager::sc_alloc(unsigned int num_bytes)
+{
+	size_class_heap_t *h = sc_heap();
+	unsigned int       c = sc_class(num_bytes);
+	unsigned int       size;
+	chunk_list_t *     f = NULL;
+
+	if (c < BBMM_SC_HUGE) {
+		size = sc_class_size(c);
+		if (h->bitmap & (1ull << c)) {
+			f = sc_pop(c);
+		}
+	} else {
+		size = (num_bytes + BBMM_SC_HUGE_GRANULARITY - 1) & ~(BBMM_SC_HUGE_GRANULARITY - 1);
+		// huge chunks have individual sizes, search first fit
+		for (chunk_list_t *l = chunk_ptr(h->heads[c]); l; l = chunk_ptr(l->next)) {
+			if (l->size >= size) {
+				sc_take(l);
+				f = l;
+				break;
+			}
+		}
+	}
+
+	if ((f == NULL) && (memsize_ - h->top >= sizeof(chunk_list_t) + size)) {
+		// carve from wilderness
+		f = sc_top();
+		h->top += sizeof(chunk_list_t) + size;
+		f->ptr   = shmem_ ? shmem_->addr((char *)f + sizeof(chunk_list_t))
+		                  : (char *)f + sizeof(chunk_list_t);
+		f->size  = size;
+		f->flags = 0;
+	}
+
+	if ((f == NULL) && (c < BBMM_SC_HUGE)) {
+		// memory exhausted, use a chunk from the smallest bigger class
+		unsigned long long bigger = h->bitmap & ~((2ull << c) - 1);
+		if (bigger) {
+			f = sc_pop(__builtin_ctzll(bigger));
+		}
+	}
+
+	if (f == NULL) {
+		throw OutOfMemoryException("BlackBoard ran out of memory");
+	}
+
+	if (f->size >= size + sizeof(chunk_list_t) + sc_class_size(0)) {
+		// split off the remainder of a merged or bigger chunk
+		chunk_list_t *r = (chunk_list_t *)((char *)f + sizeof(chunk_list_t) + size);
+		r->ptr          = shmem_ ? shmem_->addr((char *)r + sizeof(chunk_list_t))
+		                         : (char *)r + sizeof(chunk_list_t);
+		r->size         = f->size - size - sizeof(chunk_list_t);
+		f->size         = size;
+		sc_push(r);
+	}
+
+	f->next     = NULL;
+	f->key      = 0;
+	f->overhang = f->size - num_bytes;
+
+	return shmem_ ? shmem_->ptr(f->ptr) : f->ptr;
+}
+
+/** Free memory allocated with the size class allocator.
+ * Note: this method does NOT lock the shared memory system.
+ * @param ptr pointer to the chunk of memory
+ * @exception BlackBoardMemMgrInvalidPointerException thrown if the pointer
+ * has not been returned by alloc() or has already been freed
+ */
+void
+BlackBoardMemoryManager::sc_free(void *ptr)
+{
+	chunk_list_t *c = (chunk_list_t *)((char *)ptr - sizeof(chunk_list_t));
+	if (((char *)ptr < (char *)sc_base() + sizeof(chunk_list_t)) || (c >= sc_top())
+	    || (c->flags & BBMM_CHUNK_FREE) || (c->ptr != (shmem_ ? shmem_->addr(ptr) : ptr))) {
+		throw BlackBoardMemMgrInvalidPointerException();
+	}
+
+	index_remove(c);
+
+	// merge with free neighbours, there are never two free chunks in a row
+	chunk_list_t *next = sc_next_chunk(c);
+	if ((next < sc_top()) && (next->flags & BBMM_CHUNK_FREE)) {
+		sc_unlink(next);
+		c->size += sizeof(chunk_list_t) + next->size;
+	}
+	if (c->flags & BBMM_CHUNK_PREV_FREE) {
+		chunk_list_t *prev = (chunk_list_t *)((char *)c - sc_prev_size(c) - sizeof(chunk_list_t));
+		sc_unlink(prev);
+		prev->size += sizeof(chunk_list_t) + c->size;
+		c = prev;
+	}
+
+	if (sc_next_chunk(c) == sc_top()) {
+		// last chunk, give back to wilderness
+		sc_heap()->top -= sizeof(chunk_list_t) + c->size;
+	} else {
+		sc_push(c);
+	}
+}
+
+/** Check consistency of size class allocator memory.
+ * @exception BBInconsistentMemoryException thrown if the memory segment has been
+ * corrupted. Contains descriptive message.
+ */
+void
+BlackBoardMemoryManager::sc_check()
+{
+	size_class_heap_t *h        = sc_heap();
+	chunk_list_t *     top      = sc_top();
+	unsigned int       num_free = 0;
+
+	if (h->top > memsize_) {
+		throw BBInconsistentMemoryException("wilderness beyond end of memory");
+	}
+
+	chunk_list_t *c         = sc_base();
+	bool          prev_free = false;
+	while (c < top) {
+		void *data = (char *)c + sizeof(chunk_list_t);
+		if (chunk_ptr(c->ptr) != data) {
+			throw BBInconsistentMemoryException("chunk data pointer does not match chunk");
+		}
+		if (prev_free != ((c->flags & BBMM_CHUNK_PREV_FREE) != 0)) {
+			throw BBInconsistentMemoryException("chunk flag does not match free predecessor");
+		}
+		if (c->flags & BBMM_CHUNK_FREE) {
+			if (prev_free) {
+				throw BBInconsistentMemoryException("adjacent free chunks not merged");
+			}
+			if (sc_prev_size(sc_next_chunk(c)) != c->size) {
+				throw BBInconsistentMemoryException("free chunk size tag does not match");
+			}
+			++num_free;
+		}
+		prev_free = (c->flags & BBMM_CHUNK_FREE) != 0;
+		c         = (chunk_list_t *)((char *)data + c->size);
+	}
+	if (prev_free) {
+		throw BBInconsistentMemoryException("free chunk not given back to wilderness");
+	}
+	if (c != top) {
+		throw BBInconsistentMemoryException("chunks do not end at wilderness");
+	}
+
+	unsigned int num_listed = 0;
+	for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+		if ((h->heads[i] != NULL) != ((h->bitmap & (1ull << i)) != 0)) {
+			throw BBInconsistentMemoryException("size class bitmap does not match free lists");
+		}
+		for (chunk_list_t *l = chunk_ptr(h->heads[i]); l; l = chunk_ptr(l->next)) {
+			if ((l < sc_base()) || (l >= top) || !(l->flags & BBMM_CHUNK_FREE)) {
+				throw BBInconsistentMemoryException("invalid chunk in free list");
+			}
+			if (sc_free_class(l->size) != i) {
+				throw BBInconsistentMemoryException("chunk in free list of wrong size class");
+			}
+			if (++num_listed > num_free) {
+				throw BBInconsistentMemoryException("more chunks in free lists than free chunks");
+			}
+		}
+	}
+	if (num_listed != num_free) {
+		throw BBInconsistentMemoryException("free chunks missing from free lists");
+	}
+}
+
+/** Get the chunk index.
+ * @return pointer to the first slot of the chunk index
+ */
+chunk_index_t *
+BlackBoardMemoryManager::index() const
+{
+	return shmem_ ? shmem_header_->chunk_index() : index_;
+}
+
+/** Record chunk in index.
+ * The chunk is placed in the first free slot at or after the slot
+ * determined by the key (linear probing). The caller must ensure that
+ * there is at least one free slot left.
+ * @param chunk chunk to add
+ * @param key key to record the chunk with
+ */
+void
+BlackBoardMemoryManager::index_insert(chunk_list_t *chunk, unsigned int key)
+{
+	chunk_index_t *idx = index();
+	unsigned int   i   = key & (BBMM_INDEX_SIZE - 1);
+	while (idx[i].chunk != NULL) {
+		i = (i + 1) & (BBMM_INDEX_SIZE - 1);
+	}
+	chunk->key   = key;
+	idx[i].chunk = chunk_addr(chunk);
+	idx[i].key   = key;
+
+	if (shmem_) {
+		shmem_header_->set_index_entries(shmem_header_->index_entries() + 1);
+	} else {
+		++index_entries_;
+	}
+}
+
+/** Remove chunk from index.
+ * Subsequent entries of the probe sequence are shifted back into the freed
+ * slot so that no tombstones are required. If the chunk has not been
+ * indexed this is a no-op.
+ * @param chunk chunk to remove
+ */
+void
+BlackBoardMemoryManager::index_remove(chunk_list_t *chunk)
+{
+	const unsigned int mask = BBMM_INDEX_SIZE - 1;
+	chunk_index_t *    idx  = index();
+	chunk_list_t *     addr = chunk_addr(chunk);
+
+	unsigned int i = chunk->key & mask;
+	while (idx[i].chunk != addr) {
+		if (idx[i].chunk == NULL)
+			return; // not indexed
+		i = (i + 1) & mask;
+	}
+
+	// backward shift deletion
+	unsigned int j = i;
+	while (true) {
+		j = (j + 1) & mask;
+		if (idx[j].chunk == NULL)
+			break;
+		unsigned int k = idx[j].key & mask;
+		// move entry j to i unless its home slot k lies cyclically in (i, j]
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+			continue;
+		idx[i] = idx[j];
+		i      = j;
+	}
+	idx[i].chunk = NULL;
+	idx[i].key   = 0;
+	chunk->key   = 0;
+
+	if (shmem_) {
+		shmem_header_->set_index_entries(shmem_header_->index_entries() - 1);
+	} else {
+		--index_entries_;
+	}
+}
+
 /** Remove an element from a list.
  * @param list list to remove the element from
  * @param rmel element to remove
@@ -849,7 +1591,9 @@ BlackBoardMemoryManager::list_get_biggest(const chunk_list_t *list) const
 BlackBoardMemoryManager::ChunkIterator
 BlackBoardMemoryManager::begin()
 {
-	if (shmem_) {
+	if (allocator_ == ALLOCATOR_SIZE_CLASS) {
+		return BlackBoardMemoryManager::ChunkIterator(shmem_, sc_base(), sc_top());
+	} else if (shmem_) {
 		return BlackBoardMemoryManager::ChunkIterator(shmem_, shmem_header_->alloc_list_head());
 	} else {
 		return BlackBoardMemoryManager::ChunkIterator(alloc_list_head_);
@@ -880,6 +1624,7 @@ BlackBoardMemoryManager::ChunkIterator::ChunkIterator()
 {
 	shmem_ = NULL;
 	cur_   = NULL;
+	end_   = NULL;
 }
 
 /** Constructor
@@ -890,6 +1635,7 @@ BlackBoardMemoryManager::ChunkIterator::ChunkIterator(SharedMemory *shmem, chunk
 {
 	shmem_ = shmem;
 	cur_   = cur;
+	end_   = NULL;
 }
 
 /** Constructor
@@ -899,6 +1645,27 @@ BlackBoardMemoryManager::ChunkIterator::ChunkIterator(chunk_list_t *cur)
 {
 	shmem_ = NULL;
 	cur_   = cur;
+	end_   = NULL;
+}
+
+/** Constructor for size class allocator memory.
+ * Walks the chunks as they are laid out in memory and skips free chunks.
+ * @param shmem shared memory segment, NULL for heap memory
+ * @param cur first chunk in memory
+ * @param end end of chunk area, i.e. the wilderness
+ */
+BlackBoardMemoryManager::ChunkIterator::ChunkIterator(SharedMemory *shmem,
+                                                      chunk_list_t *cur,
+                                                      chunk_list_t *end)
+{
+	shmem_ = shmem;
+	cur_   = cur;
+	end_   = end;
+	if (cur_ >= end_) {
+		cur_ = NULL;
+	} else if (cur_->flags & BBMM_CHUNK_FREE) {
+		advance();
+	}
 }
 
 /** Copy constructor.
@@ -908,6 +1675,25 @@ BlackBoardMemoryManager::ChunkIterator::ChunkIterator(const ChunkIterator &it)
 {
 	shmem_ = it.shmem_;
 	cur_   = it.cur_;
+	end_   = it.end_;
+}
+
+/** Advance to next allocated chunk. */
+void
+BlackBoardMemoryManager::ChunkIterator::advance()
+{
+	if (cur_ == NULL)
+		return;
+
+	if (end_ == NULL) {
+		cur_ = chunk_ptr(cur_->next);
+	} else {
+		do {
+			cur_ = (chunk_list_t *)((char *)cur_ + sizeof(chunk_list_t) + cur_->size);
+		} while ((cur_ < end_) && (cur_->flags & BBMM_CHUNK_FREE));
+		if (cur_ >= end_)
+			cur_ = NULL;
+	}
 }
 
 /** Increment iterator.
@@ -923,8 +1709,7 @@ BlackBoardMemoryManager::ChunkIterator::ChunkIterator(const ChunkIterator &it)
 BlackBoardMemoryManager::ChunkIterator &
 BlackBoardMemoryManager::ChunkIterator::operator++()
 {
-	if (cur_ != NULL)
-		cur_ = chunk_ptr(cur_->next);
+	advance();
 
 	return *this;
 }
@@ -948,8 +1733,7 @@ BlackBoardMemoryManager::ChunkIterator
 BlackBoardMemoryManager::ChunkIterator::operator++(int inc)
 {
 	ChunkIterator rv(*this);
-	if (cur_ != NULL)
-		cur_ = chunk_ptr(cur_->next);
+	advance();
 
 	return rv;
 }
@@ -966,8 +1750,7 @@ BlackBoardMemoryManager::ChunkIterator &
 BlackBoardMemoryManager::ChunkIterator::operator+(unsigned int i)
 {
 	for (unsigned int j = 0; (cur_ != NULL) && (j < i); ++j) {
-		if (cur_ != NULL)
-			cur_ = chunk_ptr(cur_->next);
+		advance();
 	}
 	return *this;
 }
@@ -982,8 +1765,7 @@ BlackBoardMemoryManager::ChunkIterator &
 BlackBoardMemoryManager::ChunkIterator::operator+=(unsigned int i)
 {
 	for (unsigned int j = 0; (cur_ != NULL) && (j < i); ++j) {
-		if (cur_ != NULL)
-			cur_ = chunk_ptr(cur_->next);
+		advance();
 	}
 	return *this;
 }
@@ -1036,6 +1818,7 @@ BlackBoardMemoryManager::ChunkIterator::operator=(const ChunkIterator &c)
 {
 	shmem_ = c.shmem_;
 	cur_   = c.cur_;
+	end_   = c.end_;
 	return *this;
 }
 
@@ -48,6 +48,38 @@ struct chunk_list_t
 	unsigned int  size;     /**< total size of chunk, including overhanging bytes,
 				 * excluding header */
 	unsigned int  overhang; /**< number of overhanging bytes in this chunk */
+	unsigned int  key;      /**< index key, only meaningful for indexed chunks */
+	unsigned int  flags;    /**< chunk flags, only used by the size class allocator */
+};
+
+/** Number of size classes of the size class allocator. The last class
+ * holds all chunks too big for any of the fixed size classes. */
+#define BBMM_NUM_SIZE_CLASSES 64
+
+/** Free lists of the size class allocator as stored in the BlackBoard
+ * shared memory segment. Chunks are carved from the unused memory at the
+ * end of the segment, the so-called wilderness. Freed chunks are merged
+ * with free neighbours and put into the free list of the largest size class
+ * they can serve, or given back to the wilderness if at the end.
+ */
+struct size_class_heap_t
+{
+	unsigned int       top;    /**< offset of the wilderness from begin of memory */
+	unsigned long long bitmap; /**< bit i is set if free list i is non-empty */
+	chunk_list_t *     heads[BBMM_NUM_SIZE_CLASSES]; /**< offsets of free list heads */
+};
+
+/** Number of slots in the chunk index. Must be a power of two. */
+#define BBMM_INDEX_SIZE 8192
+
+/** Entry of the chunk index as stored in the BlackBoard shared memory segment.
+ * The index is an open-addressing hash table with linear probing which maps
+ * a user-supplied key to the allocated chunk.
+ */
+struct chunk_index_t
+{
+	chunk_list_t *chunk; /**< offset of indexed chunk, NULL if slot is empty */
+	unsigned int  key;   /**< key of the indexed chunk */
 };
 
 // May be added later if we want/need per chunk semaphores
@@ -60,16 +92,26 @@ class BlackBoardMemoryManager
 	friend BlackBoardInterfaceManager;
 
 public:
-	BlackBoardMemoryManager(size_t memsize);
+	/** Memory allocation strategy. */
+	typedef enum {
+		ALLOCATOR_BEST_FIT,   ///< best-fit allocation from an address-ordered free list
+		ALLOCATOR_SIZE_CLASS, ///< constant time allocation from segregated size classes
+	} Allocator;
+
+	BlackBoardMemoryManager(size_t memsize, Allocator allocator = ALLOCATOR_BEST_FIT);
 	BlackBoardMemoryManager(size_t       memsize,
 	                        unsigned int version,
 	                        bool         use_shmem,
-	                        const char * shmem_token = "FawkesBlackBoard");
+	                        const char * shmem_token = "FawkesBlackBoard",
+	                        Allocator    allocator   = ALLOCATOR_BEST_FIT);
 	~BlackBoardMemoryManager();
 
 	void *alloc(unsigned int num_bytes);
+	void *alloc(unsigned int num_bytes, unsigned int key);
 	void  free(void *chunk_ptr);
 
+	void *find(unsigned int key, unsigned int &cookie) const;
+
 	void check();
 
 	bool is_master() const;
@@ -83,9 +125,11 @@ public:
 
 	unsigned int num_free_chunks() const;
 	unsigned int num_allocated_chunks() const;
+	unsigned int num_indexed_chunks() const;
 
 	unsigned int memory_size() const;
 	unsigned int version() const;
+	Allocator    allocator() const;
 
 	void print_free_chunks_info() const;
 	void print_allocated_chunks_info() const;
@@ -108,6 +152,7 @@ public:
 	private:
 		ChunkIterator(SharedMemory *shmem, chunk_list_t *cur);
 		ChunkIterator(chunk_list_t *cur);
+		ChunkIterator(SharedMemory *shmem, chunk_list_t *cur, chunk_list_t *end);
 
 	public:
 		ChunkIterator();
@@ -124,9 +169,13 @@ public:
 		unsigned int size() const;
 		unsigned int overhang() const;
 
+	private:
+		void advance();
+
 	private:
 		SharedMemory *shmem_;
 		chunk_list_t *cur_;
+		chunk_list_t *end_;
 	};
 
 	ChunkIterator begin();
@@ -144,7 +193,23 @@ private:
 
 	void list_print_info(const chunk_list_t *list) const;
 
+	size_class_heap_t *sc_heap() const;
+	chunk_list_t *     sc_base() const;
+	chunk_list_t *     sc_top() const;
+	void *             sc_alloc(unsigned int num_bytes);
+	void               sc_free(void *ptr);
+	void               sc_push(chunk_list_t *chunk);
+	void               sc_unlink(chunk_list_t *chunk);
+	void               sc_take(chunk_list_t *chunk);
+	chunk_list_t *     sc_pop(unsigned int size_class);
+	void               sc_check();
+
 	void *alloc_nolock(unsigned int num_bytes);
+	void *alloc_nolock(unsigned int num_bytes, unsigned int key);
+
+	chunk_index_t *index() const;
+	void           index_insert(chunk_list_t *chunk, unsigned int key);
+	void           index_remove(chunk_list_t *chunk);
 
 private:
 	bool master_;
@@ -162,6 +227,13 @@ private:
 	void *        memory_;
 	chunk_list_t *free_list_head_;  /**< offset of the free chunks list head */
 	chunk_list_t *alloc_list_head_; /**< offset of the allocated chunks list head */
+
+	// Used for heap memory, with shmem the index is stored in the header
+	chunk_index_t *index_;         /**< chunk index */
+	unsigned int   index_entries_; /**< number of used chunk index slots */
+
+	Allocator         allocator_;
+	size_class_heap_t sc_heap_; /**< size class free lists for heap memory */
 };
 
 } // end namespace fawkes
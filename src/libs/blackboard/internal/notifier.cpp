@@ -21,9 +21,11 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <blackboard/bbconfig.h>
 #include <blackboard/blackboard.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
+#include <blackboard/internal/async_dispatcher.h>
 #include <blackboard/internal/notifier.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
@@ -60,6 +62,9 @@ BlackBoardNotifier::BlackBoardNotifier()
 	bbil_data_events_ = 0;
 	bbil_data_mutex_  = new Mutex();
 
+	bbil_async_mutex_      = new Mutex();
+	bbil_async_dispatcher_ = NULL;
+
 	bbil_messages_events_ = 0;
 	bbil_messages_mutex_  = new Mutex();
 
@@ -70,6 +75,9 @@ BlackBoardNotifier::BlackBoardNotifier()
 /** Destructor */
 BlackBoardNotifier::~BlackBoardNotifier()
 {
+	delete bbil_async_dispatcher_;
+	delete bbil_async_mutex_;
+
 	delete bbil_writer_mutex_;
 	delete bbil_reader_mutex_;
 	delete bbil_data_mutex_;
@@ -91,6 +99,9 @@ BlackBoardNotifier::register_listener(BlackBoardInterfaceListener *    listener,
 }
 
 /** Update BB event listener.
+ * Asynchronous delivery of data events is enabled if BBIL_FLAG_ASYNC is
+ * given. It is not disabled by updates without the flag, a listener stays
+ * asynchronous until it is unregistered.
  * @param listener BlackBoard event listener to update subscriptions of
  * @param flag concatenation of flags denoting which queue entries should be
  * processed
@@ -99,6 +110,10 @@ void
 BlackBoardNotifier::update_listener(BlackBoardInterfaceListener *    listener,
                                     BlackBoard::ListenerRegisterFlag flag)
 {
+	if ((flag & BlackBoard::BBIL_FLAG_DATA) && (flag & BlackBoard::BBIL_FLAG_ASYNC)) {
+		update_async(listener, true);
+	}
+
 	const BlackBoardInterfaceListener::InterfaceQueue &queue = listener->bbil_acquire_queue();
 
 	BlackBoardInterfaceListener::InterfaceQueue::const_iterator i = queue.begin();
@@ -160,6 +175,36 @@ BlackBoardNotifier::update_listener(BlackBoardInterfaceListener *    listener,
 	listener->bbil_release_queue(flag);
 }
 
+/** Switch data change delivery of a listener between sync and async mode.
+ * The dispatcher is created on first use such that no threads are
+ * spawned unless there actually is an asynchronous listener.
+ * @param listener listener to update
+ * @param async true to enable asynchronous delivery, false to disable
+ */
+void
+BlackBoardNotifier::update_async(BlackBoardInterfaceListener *listener, bool async)
+{
+	MutexLocker lock(bbil_async_mutex_);
+	if (async == listener->bbil_async_)
+		return;
+
+	if (async) {
+		if (!bbil_async_dispatcher_) {
+			bbil_async_dispatcher_ = new BlackBoardAsyncDispatcher(BLACKBOARD_ASYNC_THREADS);
+		}
+		if (!listener->bbil_async_queue_) {
+			listener->bbil_async_queue_ =
+			  new BlackBoardAsyncQueue(BLACKBOARD_ASYNC_QUEUE_SIZE,
+			                           BlackBoardInterfaceListener::ASYNC_COALESCE);
+		}
+		bbil_async_dispatcher_->add(listener);
+		listener->bbil_async_ = true;
+	} else {
+		listener->bbil_async_ = false;
+		bbil_async_dispatcher_->remove(listener);
+	}
+}
+
 void
 BlackBoardNotifier::proc_listener_maybe_queue(bool                         op,
                                               Interface *                  interface,
@@ -245,6 +290,8 @@ BlackBoardNotifier::unregister_listener(BlackBoardInterfaceListener *listener)
 	}
 
 	listener->bbil_release_maps();
+
+	update_async(listener, false);
 }
 
 /** Add listener for specified map.
@@ -695,6 +742,10 @@ BlackBoardNotifier::notify_of_data_change(const Interface *interface)
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_data_queue_, uid, bbil)) {
+			if (bbil->bbil_async_) {
+				bbil_async_dispatcher_->enqueue(bbil, uid);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_data_interface(uid);
 			if (bbil_iface != NULL) {
 				bbil->bb_interface_data_changed(bbil_iface);
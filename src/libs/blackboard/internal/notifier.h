@@ -38,6 +38,7 @@ namespace fawkes {
 class Interface;
 class Message;
 class Mutex;
+class BlackBoardAsyncDispatcher;
 
 class BlackBoardNotifier
 {
@@ -120,6 +121,8 @@ private:
 	void process_data_queue();
 	void process_bbio_queue();
 
+	void update_async(BlackBoardInterfaceListener *listener, bool async);
+
 	bool is_in_queue(bool op, BBilQueue &queue, const char *uid, BlackBoardInterfaceListener *bbil);
 
 	BBilMap bbil_data_;
@@ -142,6 +145,9 @@ private:
 	unsigned int bbil_data_events_;
 	BBilQueue    bbil_data_queue_;
 
+	Mutex *                    bbil_async_mutex_;
+	BlackBoardAsyncDispatcher *bbil_async_dispatcher_;
+
 	Mutex *      bbil_messages_mutex_;
 	unsigned int bbil_messages_events_;
 	BBilQueue    bbil_messages_queue_;
@@ -51,10 +51,21 @@ namespace fawkes {
  * @param memsize size of memory in bytes
  * @param magic_token magic token used for shared memory segment
  * @param master true to operate in master mode, false otherwise
+ * @param size_class_allocator true to use the constant time size class
+ * allocator instead of the best-fit allocator, only used in master mode
  */
-LocalBlackBoard::LocalBlackBoard(size_t memsize, const char *magic_token, bool master)
+LocalBlackBoard::LocalBlackBoard(size_t      memsize,
+                                 const char *magic_token,
+                                 bool        master,
+                                 bool        size_class_allocator)
 {
-	memmgr_ = new BlackBoardMemoryManager(memsize, BLACKBOARD_VERSION, master);
+	memmgr_ =
+	  new BlackBoardMemoryManager(memsize,
+	                              BLACKBOARD_VERSION,
+	                              master,
+	                              BLACKBOARD_MAGIC_TOKEN,
+	                              size_class_allocator ? BlackBoardMemoryManager::ALLOCATOR_SIZE_CLASS
+	                                                   : BlackBoardMemoryManager::ALLOCATOR_BEST_FIT);
 
 	msgmgr_ = new BlackBoardMessageManager(notifier_);
 	im_     = new BlackBoardInterfaceManager(memmgr_, msgmgr_, notifier_);
@@ -66,10 +77,15 @@ LocalBlackBoard::LocalBlackBoard(size_t memsize, const char *magic_token, bool m
 
 /** Heap Memory Constructor.
  * @param memsize size of memory in bytes
+ * @param size_class_allocator true to use the constant time size class
+ * allocator instead of the best-fit allocator
  */
-LocalBlackBoard::LocalBlackBoard(size_t memsize)
+LocalBlackBoard::LocalBlackBoard(size_t memsize, bool size_class_allocator)
 {
-	memmgr_ = new BlackBoardMemoryManager(memsize);
+	memmgr_ = new BlackBoardMemoryManager(memsize,
+	                                      size_class_allocator
+	                                        ? BlackBoardMemoryManager::ALLOCATOR_SIZE_CLASS
+	                                        : BlackBoardMemoryManager::ALLOCATOR_BEST_FIT);
 
 	msgmgr_ = new BlackBoardMessageManager(notifier_);
 	im_     = new BlackBoardInterfaceManager(memmgr_, msgmgr_, notifier_);
@@ -200,4 +216,18 @@ LocalBlackBoard::start_nethandler(FawkesNetworkHub *hub)
 	nethandler_->start();
 }
 
+/** Set interface types that use a seqlock.
+ * Interfaces of matching types created afterwards protect their shared data
+ * by a seqlock instead of a read/write lock, so that readers never block
+ * the writer. This is beneficial for interfaces which are read at a high
+ * rate, for example laser data. The API of the interfaces is not affected.
+ * @param type_patterns list of type patterns, may contain shell-like
+ * wildcards, cf. man fnmatch(). Pass "*" to use seqlocks for all types.
+ */
+void
+LocalBlackBoard::set_seqlock_types(const std::list<std::string> &type_patterns)
+{
+	im_->set_seqlock_types(type_patterns);
+}
+
 } // end namespace fawkes
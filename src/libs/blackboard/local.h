@@ -27,6 +27,7 @@
 #include <core/exceptions/software.h>
 
 #include <list>
+#include <string>
 
 namespace fawkes {
 
@@ -44,8 +45,11 @@ class FawkesNetworkHub;
 class LocalBlackBoard : public BlackBoard
 {
 public:
-	LocalBlackBoard(size_t memsize);
-	LocalBlackBoard(size_t memsize, const char *magic_token, bool master = true);
+	LocalBlackBoard(size_t memsize, bool size_class_allocator = false);
+	LocalBlackBoard(size_t      memsize,
+	                const char *magic_token,
+	                bool        master               = true,
+	                bool        size_class_allocator = false);
 	virtual ~LocalBlackBoard();
 
 	virtual Interface *
@@ -65,6 +69,8 @@ public:
 
 	virtual void start_nethandler(FawkesNetworkHub *hub);
 
+	void set_seqlock_types(const std::list<std::string> &type_patterns);
+
 	static void cleanup(const char *magic_token, bool use_lister = false);
 
 	/* for debugging only */
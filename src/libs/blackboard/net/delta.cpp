@@ -0,0 +1,330 @@
+
+/***************************************************************************
+ *  delta.cpp - BlackBoard network delta encoding of interface data
+ *
+ *  Created: Wed Oct 21 10:31:02 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <arpa/inet.h>
+#include <blackboard/net/delta.h>
+#include <blackboard/net/messages.h>
+#include <core/exception.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifdef HAVE_ZLIB
+#	include <zlib.h>
+#endif
+
+namespace fawkes {
+
+/** @class BlackBoardDeltaEncoder <blackboard/net/delta.h>
+ * Delta encoder for interface data updates.
+ * The encoder keeps a copy of the data chunk last sent. For each new update
+ * it marks the blocks of BB_DELTA_BLOCK_SIZE bytes which changed in a bitmap
+ * and only transmits those blocks. The first update, every
+ * keyframe_interval-th update, and any update for which the delta would not
+ * be smaller than the data chunk are sent as keyframe containing the full
+ * data. Optionally the payload is deflate compressed.
+ *
+ * The Fawkes network protocol runs over TCP, therefore updates are received
+ * in order and the previously sent update is the one acknowledged by the
+ * peer. Keyframes allow a decoder to re-synchronize should it ever have
+ * dropped an update.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param data_size size in bytes of the interface data chunk
+ * @param flags blackboard_delta_caps_t flags, BB_DELTA_CAP_COMPRESSION is
+ * ignored if compression is not supported
+ * @param keyframe_interval number of delta updates after which a keyframe
+ * is sent
+ */
+BlackBoardDeltaEncoder::BlackBoardDeltaEncoder(size_t       data_size,
+                                               unsigned int flags,
+                                               unsigned int keyframe_interval)
+{
+	data_size_         = data_size;
+	num_blocks_        = (data_size + BB_DELTA_BLOCK_SIZE - 1) / BB_DELTA_BLOCK_SIZE;
+	bitmap_size_       = (num_blocks_ + 7) / 8;
+	flags_             = flags & capabilities();
+	keyframe_interval_ = keyframe_interval;
+	seq_               = 0;
+	since_keyframe_    = 0;
+	have_last_         = false;
+
+	last_   = (char *)calloc(1, data_size_);
+	buffer_ = (char *)malloc(bitmap_size_ + data_size_);
+}
+
+/** Destructor. */
+BlackBoardDeltaEncoder::~BlackBoardDeltaEncoder()
+{
+	free(last_);
+	free(buffer_);
+}
+
+/** Get supported capabilities.
+ * @return blackboard_delta_caps_t flags supported by this build
+ */
+unsigned int
+BlackBoardDeltaEncoder::capabilities()
+{
+#ifdef HAVE_ZLIB
+	return BB_DELTA_CAP_ENCODING | BB_DELTA_CAP_COMPRESSION;
+#else
+	return BB_DELTA_CAP_ENCODING;
+#endif
+}
+
+/** Get active flags.
+ * @return blackboard_delta_caps_t flags used by this encoder
+ */
+unsigned int
+BlackBoardDeltaEncoder::flags() const
+{
+	return flags_;
+}
+
+/** Send a keyframe with the next update. */
+void
+BlackBoardDeltaEncoder::force_keyframe()
+{
+	have_last_ = false;
+}
+
+/** Encode data update.
+ * @param serial instance serial of the interface
+ * @param data current interface data chunk of the size given to the
+ * constructor
+ * @param payload_size upon return contains the size in bytes of the returned
+ * payload
+ * @return payload for an MSG_BB_DATA_DELTA message starting with a
+ * bb_idelta_msg_t, allocated with malloc(), ownership is passed to the caller
+ */
+void *
+BlackBoardDeltaEncoder::encode(unsigned int serial, const void *data, size_t &payload_size)
+{
+	const char * cdata    = (const char *)data;
+	const char * raw      = cdata;
+	size_t       raw_size = data_size_;
+	bool         keyframe = !have_last_ || (since_keyframe_ >= keyframe_interval_);
+	unsigned int flags    = 0;
+
+	if (!keyframe) {
+		memset(buffer_, 0, bitmap_size_);
+		char *p = buffer_ + bitmap_size_;
+		for (size_t b = 0; b < num_blocks_; ++b) {
+			size_t offset = b * BB_DELTA_BLOCK_SIZE;
+			size_t len    = std::min((size_t)BB_DELTA_BLOCK_SIZE, data_size_ - offset);
+			if (memcmp(cdata + offset, last_ + offset, len) != 0) {
+				buffer_[b >> 3] |= (char)(1 << (b & 7));
+				memcpy(p, cdata + offset, len);
+				p += len;
+			}
+		}
+		raw_size = p - buffer_;
+		if (raw_size >= data_size_) {
+			keyframe = true;
+			raw_size = data_size_;
+		} else {
+			raw = buffer_;
+		}
+	}
+
+	if (keyframe) {
+		flags |= BB_DELTA_FLAG_KEYFRAME;
+		since_keyframe_ = 0;
+	} else {
+		++since_keyframe_;
+	}
+	memcpy(last_, cdata, data_size_);
+	have_last_ = true;
+
+	size_t max_body_size = raw_size;
+#ifdef HAVE_ZLIB
+	if (flags_ & BB_DELTA_CAP_COMPRESSION) {
+		max_body_size = std::max(max_body_size, (size_t)compressBound(raw_size));
+	}
+#endif
+
+	void *           payload   = malloc(sizeof(bb_idelta_msg_t) + max_body_size);
+	bb_idelta_msg_t *dm        = (bb_idelta_msg_t *)payload;
+	char *           body      = (char *)payload + sizeof(bb_idelta_msg_t);
+	size_t           body_size = raw_size;
+
+#ifdef HAVE_ZLIB
+	if ((flags_ & BB_DELTA_CAP_COMPRESSION) && (raw_size >= BB_DELTA_COMPRESS_MIN_SIZE)) {
+		uLongf dest_len = max_body_size;
+		if ((compress2((Bytef *)body, &dest_len, (const Bytef *)raw, raw_size, Z_BEST_SPEED) == Z_OK)
+		    && (dest_len < raw_size)) {
+			flags |= BB_DELTA_FLAG_COMPRESSED;
+			body_size = dest_len;
+		}
+	}
+#endif
+	if (!(flags & BB_DELTA_FLAG_COMPRESSED)) {
+		memcpy(body, raw, raw_size);
+	}
+
+	dm->serial       = htonl(serial);
+	dm->seq          = htonl(seq_++);
+	dm->flags        = htons(flags);
+	dm->reserved     = 0;
+	dm->data_size    = htonl(data_size_);
+	dm->raw_size     = htonl(raw_size);
+	dm->payload_size = htonl(body_size);
+
+	payload_size = sizeof(bb_idelta_msg_t) + body_size;
+	return payload;
+}
+
+/** @class BlackBoardDeltaDecoder <blackboard/net/delta.h>
+ * Delta decoder for interface data updates.
+ * Counterpart to the BlackBoardDeltaEncoder. It keeps the last decoded data
+ * chunk and applies delta updates to it. Updates are only applied after they
+ * have been fully validated. If an update is missing, all further deltas are
+ * rejected until the next keyframe is received.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param data_size size in bytes of the interface data chunk
+ */
+BlackBoardDeltaDecoder::BlackBoardDeltaDecoder(size_t data_size)
+{
+	data_size_   = data_size;
+	num_blocks_  = (data_size + BB_DELTA_BLOCK_SIZE - 1) / BB_DELTA_BLOCK_SIZE;
+	bitmap_size_ = (num_blocks_ + 7) / 8;
+	next_seq_    = 0;
+	synced_      = false;
+
+	data_   = (char *)calloc(1, data_size_);
+	buffer_ = (char *)malloc(bitmap_size_ + data_size_);
+}
+
+/** Destructor. */
+BlackBoardDeltaDecoder::~BlackBoardDeltaDecoder()
+{
+	free(data_);
+	free(buffer_);
+}
+
+/** Decode data update.
+ * @param payload payload of an MSG_BB_DATA_DELTA message
+ * @param payload_size size in bytes of the payload
+ * @return pointer to the internal buffer holding the updated data chunk, it
+ * is valid until the next call to decode()
+ * @exception Exception thrown if the update is malformed or cannot be applied
+ * because a previous update is missing
+ */
+const void *
+BlackBoardDeltaDecoder::decode(const void *payload, size_t payload_size)
+{
+	if (payload_size < sizeof(bb_idelta_msg_t)) {
+		throw Exception("Delta message too short (%zu bytes)", payload_size);
+	}
+
+	const bb_idelta_msg_t *dm        = (const bb_idelta_msg_t *)payload;
+	const char *           body      = (const char *)payload + sizeof(bb_idelta_msg_t);
+	size_t                 body_size = ntohl(dm->payload_size);
+	size_t                 raw_size  = ntohl(dm->raw_size);
+	unsigned int           seq       = ntohl(dm->seq);
+	unsigned int           flags     = ntohs(dm->flags);
+
+	if (ntohl(dm->data_size) != data_size_) {
+		throw Exception("Delta data size mismatch, expected %zu, but got %u",
+		                data_size_,
+		                ntohl(dm->data_size));
+	}
+	if (sizeof(bb_idelta_msg_t) + body_size != payload_size) {
+		throw Exception("Delta payload size mismatch, expected %zu, but got %zu",
+		                body_size,
+		                payload_size - sizeof(bb_idelta_msg_t));
+	}
+	if (raw_size > bitmap_size_ + data_size_) {
+		throw Exception("Delta size %zu exceeds maximum of %zu", raw_size, bitmap_size_ + data_size_);
+	}
+	if (!(flags & BB_DELTA_FLAG_KEYFRAME) && (!synced_ || (seq != next_seq_))) {
+		synced_ = false;
+		throw Exception("Delta %u out of sequence (expected %u), waiting for keyframe",
+		                seq,
+		                next_seq_);
+	}
+
+	const char *raw = body;
+	if (flags & BB_DELTA_FLAG_COMPRESSED) {
+#ifdef HAVE_ZLIB
+		uLongf dest_len = raw_size;
+		if ((uncompress((Bytef *)buffer_, &dest_len, (const Bytef *)body, body_size) != Z_OK)
+		    || (dest_len != raw_size)) {
+			synced_ = false;
+			throw Exception("Failed to decompress delta %u", seq);
+		}
+		raw = buffer_;
+#else
+		synced_ = false;
+		throw Exception("Received compressed delta, but compression is not supported");
+#endif
+	} else if (body_size != raw_size) {
+		throw Exception("Delta size mismatch, expected %zu, but got %zu", raw_size, body_size);
+	}
+
+	if (flags & BB_DELTA_FLAG_KEYFRAME) {
+		if (raw_size != data_size_) {
+			throw Exception("Keyframe size mismatch, expected %zu, but got %zu", data_size_, raw_size);
+		}
+		memcpy(data_, raw, data_size_);
+	} else {
+		if (raw_size < bitmap_size_) {
+			synced_ = false;
+			throw Exception("Delta %u too short for bitmap", seq);
+		}
+
+		size_t changed_size = 0;
+		for (size_t b = 0; b < num_blocks_; ++b) {
+			if (raw[b >> 3] & (1 << (b & 7))) {
+				changed_size +=
+				  std::min((size_t)BB_DELTA_BLOCK_SIZE, data_size_ - b * BB_DELTA_BLOCK_SIZE);
+			}
+		}
+		if (bitmap_size_ + changed_size != raw_size) {
+			synced_ = false;
+			throw Exception("Delta %u size does not match bitmap", seq);
+		}
+
+		const char *p = raw + bitmap_size_;
+		for (size_t b = 0; b < num_blocks_; ++b) {
+			if (raw[b >> 3] & (1 << (b & 7))) {
+				size_t offset = b * BB_DELTA_BLOCK_SIZE;
+				size_t len    = std::min((size_t)BB_DELTA_BLOCK_SIZE, data_size_ - offset);
+				memcpy(data_ + offset, p, len);
+				p += len;
+			}
+		}
+	}
+
+	synced_   = true;
+	next_seq_ = seq + 1;
+	return data_;
+}
+
+} // end namespace fawkes
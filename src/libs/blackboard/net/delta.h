@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  delta.h - BlackBoard network delta encoding of interface data
+ *
+ *  Created: Wed Oct 21 10:14:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_NET_DELTA_H_
+#define _BLACKBOARD_NET_DELTA_H_
+
+#include <cstddef>
+
+/** Size in bytes of a block of the data chunk tracked in the delta bitmap. */
+#define BB_DELTA_BLOCK_SIZE 8
+/** Number of delta updates after which a keyframe is sent. */
+#define BB_DELTA_KEYFRAME_INTERVAL 100
+/** Minimum payload size in bytes for which compression is attempted. */
+#define BB_DELTA_COMPRESS_MIN_SIZE 128
+
+namespace fawkes {
+
+class BlackBoardDeltaEncoder
+{
+public:
+	BlackBoardDeltaEncoder(size_t       data_size,
+	                       unsigned int flags,
+	                       unsigned int keyframe_interval = BB_DELTA_KEYFRAME_INTERVAL);
+	~BlackBoardDeltaEncoder();
+
+	void *encode(unsigned int serial, const void *data, size_t &payload_size);
+	void  force_keyframe();
+
+	unsigned int flags() const;
+
+	static unsigned int capabilities();
+
+private:
+	size_t       data_size_;
+	size_t       num_blocks_;
+	size_t       bitmap_size_;
+	unsigned int flags_;
+	unsigned int keyframe_interval_;
+	unsigned int seq_;
+	unsigned int since_keyframe_;
+	bool         have_last_;
+
+	char *last_;
+	char *buffer_;
+};
+
+class BlackBoardDeltaDecoder
+{
+public:
+	BlackBoardDeltaDecoder(size_t data_size);
+	~BlackBoardDeltaDecoder();
+
+	const void *decode(const void *payload, size_t payload_size);
+
+private:
+	size_t       data_size_;
+	size_t       num_blocks_;
+	size_t       bitmap_size_;
+	unsigned int next_seq_;
+	bool         synced_;
+
+	char *data_;
+	char *buffer_;
+};
+
+} // end namespace fawkes
+
+#endif
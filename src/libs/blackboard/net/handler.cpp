@@ -24,6 +24,7 @@
 #include <arpa/inet.h>
 #include <blackboard/blackboard.h>
 #include <blackboard/exceptions.h>
+#include <blackboard/net/delta.h>
 #include <blackboard/net/handler.h>
 #include <blackboard/net/ilist_content.h>
 #include <blackboard/net/interface_listener.h>
@@ -45,6 +46,11 @@ namespace fawkes {
  * This class provides a network handler that can be registered with the
  * FawkesServerThread to handle client requests to a BlackBoard instance.
  *
+ * Data changes of interfaces opened by clients are collected and sent once
+ * per loop, i.e. multiple writes to an interface in between are coalesced
+ * into a single update. Clients can request delta encoding of updates, which
+ * is announced in the open success message.
+ *
  * @author Tim Niemueller
  */
 
@@ -169,8 +175,10 @@ BlackBoardNetworkHandler::loop()
 					interfaces_[iface->serial()] = iface;
 					client_interfaces_[clid].push_back(iface);
 					serial_to_clid_[iface->serial()] = clid;
+					listeners_.lock();
 					listeners_[iface->serial()] =
-					  new BlackBoardNetHandlerInterfaceListener(bb_, iface, nhub_, clid);
+					  new BlackBoardNetHandlerInterfaceListener(bb_, iface, nhub_, clid, this);
+					listeners_.unlock();
 					send_opensuccess(clid, iface);
 				}
 			} catch (BlackBoardInterfaceNotFoundException &nfe) {
@@ -231,8 +239,10 @@ BlackBoardNetworkHandler::loop()
 					                     "Remote %u closing interface %s",
 					                     clid,
 					                     interfaces_[sm_serial]->uid());
+					listeners_.lock();
 					delete listeners_[sm_serial];
 					listeners_.erase(sm_serial);
+					listeners_.unlock();
 					bb_->close(interfaces_[sm_serial]);
 					interfaces_.erase(sm_serial);
 					interfaces_.unlock();
@@ -279,6 +289,57 @@ BlackBoardNetworkHandler::loop()
 			}
 		} break;
 
+		case MSG_BB_DATA_DELTA: {
+			bb_idelta_msg_t *dm        = (bb_idelta_msg_t *)msg->payload();
+			unsigned int     dm_serial = ntohl(dm->serial);
+			if (interfaces_.find(dm_serial) != interfaces_.end()) {
+				listeners_.lock();
+				try {
+					if (listeners_.find(dm_serial) == listeners_.end()) {
+						throw Exception("No listener for interface %u", dm_serial);
+					}
+					const void *data = listeners_[dm_serial]->decode_data_delta(msg);
+					interfaces_[dm_serial]->set_from_chunk((void *)data);
+					interfaces_[dm_serial]->write();
+				} catch (Exception &e) {
+					LibLogger::log_error("BlackBoardNetworkHandler",
+					                     "DATA_DELTA: Failed to apply update for %s, ignoring.",
+					                     interfaces_[dm_serial]->uid());
+					LibLogger::log_error("BlackBoardNetworkHandler", e);
+				}
+				listeners_.unlock();
+			} else {
+				LibLogger::log_error("BlackBoardNetworkHandler",
+				                     "DATA_DELTA: Interface with "
+				                     "serial %u not found, ignoring.",
+				                     dm_serial);
+			}
+		} break;
+
+		case MSG_BB_DELTA_REQUEST: {
+			bb_idelta_req_msg_t *rm        = msg->msg<bb_idelta_req_msg_t>();
+			unsigned int         rm_serial = ntohl(rm->serial);
+			unsigned int         flags     = ntohl(rm->flags) & BlackBoardDeltaEncoder::capabilities();
+			listeners_.lock();
+			if ((serial_to_clid_.find(rm_serial) != serial_to_clid_.end())
+			    && (serial_to_clid_[rm_serial] == clid)
+			    && (listeners_.find(rm_serial) != listeners_.end())) {
+				LibLogger::log_debug("BlackBoardNetworkHandler",
+				                     "Remote %u requested delta encoding (flags %x) for %s",
+				                     clid,
+				                     flags,
+				                     interfaces_[rm_serial]->uid());
+				listeners_[rm_serial]->set_delta_flags(flags);
+			} else {
+				LibLogger::log_warn("BlackBoardNetworkHandler",
+				                    "Client %u requested delta encoding for "
+				                    "interface with serial %u which it has not opened",
+				                    clid,
+				                    rm_serial);
+			}
+			listeners_.unlock();
+		} break;
+
 		case MSG_BB_INTERFACE_MESSAGE: {
 			void *             payload   = msg->payload();
 			bb_imessage_msg_t *mm        = (bb_imessage_msg_t *)payload;
@@ -331,15 +392,47 @@ BlackBoardNetworkHandler::loop()
 		msg->unref();
 		inbound_queue_.pop_locked();
 	}
+
+	send_pending_data();
+}
+
+/** Schedule sending data of an interface.
+ * Called by the interface listeners on data changes. The data is sent in the
+ * next loop, coalescing any further changes until then.
+ * @param serial instance serial of the changed interface
+ */
+void
+BlackBoardNetworkHandler::schedule_data_send(unsigned int serial)
+{
+	pending_data_.push_locked(serial);
+	wakeup();
+}
+
+/** Send data of all interfaces which have been scheduled. */
+void
+BlackBoardNetworkHandler::send_pending_data()
+{
+	while (!pending_data_.empty()) {
+		unsigned int serial = pending_data_.front();
+		pending_data_.pop_locked();
+
+		listeners_.lock();
+		if ((lit_ = listeners_.find(serial)) != listeners_.end()) {
+			lit_->second->send_data();
+		}
+		listeners_.unlock();
+	}
 }
 
 void
 BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interface)
 {
-	void *              payload = calloc(1, sizeof(bb_iopensucc_msg_t) + interface->datasize());
-	bb_iopensucc_msg_t *osm     = (bb_iopensucc_msg_t *)payload;
-	osm->serial                 = htonl(interface->serial());
-	osm->writer_readers         = htonl(interface->num_readers());
+	size_t payload_size = sizeof(bb_iopensucc_msg_t) + interface->datasize() + sizeof(uint32_t);
+	void * payload      = calloc(1, payload_size);
+
+	bb_iopensucc_msg_t *osm = (bb_iopensucc_msg_t *)payload;
+	osm->serial             = htonl(interface->serial());
+	osm->writer_readers     = htonl(interface->num_readers());
 	if (interface->has_writer()) {
 		osm->writer_readers |= htonl(0x80000000);
 	} else {
@@ -355,12 +448,14 @@ BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interfa
 	       interface->datachunk(),
 	       interface->datasize());
 
-	FawkesNetworkMessage *omsg =
-	  new FawkesNetworkMessage(clid,
-	                           FAWKES_CID_BLACKBOARD,
-	                           MSG_BB_OPEN_SUCCESS,
-	                           payload,
-	                           sizeof(bb_iopensucc_msg_t) + interface->datasize());
+	// announce delta encoding, older clients ignore the trailing field
+	uint32_t caps = htonl(BlackBoardDeltaEncoder::capabilities());
+	memcpy((char *)payload + sizeof(bb_iopensucc_msg_t) + interface->datasize(),
+	       &caps,
+	       sizeof(uint32_t));
+
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+	  clid, FAWKES_CID_BLACKBOARD, MSG_BB_OPEN_SUCCESS, payload, payload_size);
 	try {
 		nhub_->send(omsg);
 	} catch (Exception &e) {
@@ -434,8 +529,10 @@ BlackBoardNetworkHandler::client_disconnected(unsigned int clid)
 			unsigned int serial = (*ciit_)->serial();
 			serial_to_clid_.erase(serial);
 			interfaces_.erase_locked(serial);
+			listeners_.lock();
 			delete listeners_[serial];
 			listeners_.erase(serial);
+			listeners_.unlock();
 			bb_->close(*ciit_);
 		}
 		client_interfaces_.erase(clid);
@@ -51,6 +51,8 @@ public:
 	virtual void client_disconnected(unsigned int clid);
 	virtual void loop();
 
+	void schedule_data_send(unsigned int serial);
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -62,16 +64,20 @@ protected:
 private:
 	void send_opensuccess(unsigned int clid, Interface *interface);
 	void send_openfailure(unsigned int clid, unsigned int error_code);
+	void send_pending_data();
 
 	BlackBoard *                      bb_;
 	LockQueue<FawkesNetworkMessage *> inbound_queue_;
 
+	// Instance serials of interfaces with data changes to send
+	LockQueue<unsigned int> pending_data_;
+
 	// All interfaces, key is the instance serial, value the interface
 	LockMap<unsigned int, Interface *>           interfaces_;
 	LockMap<unsigned int, Interface *>::iterator iit_;
 
-	std::map<unsigned int, BlackBoardNetHandlerInterfaceListener *>           listeners_;
-	std::map<unsigned int, BlackBoardNetHandlerInterfaceListener *>::iterator lit_;
+	LockMap<unsigned int, BlackBoardNetHandlerInterfaceListener *>           listeners_;
+	LockMap<unsigned int, BlackBoardNetHandlerInterfaceListener *>::iterator lit_;
 
 	BlackBoardNetHandlerInterfaceObserver *observer_;
 
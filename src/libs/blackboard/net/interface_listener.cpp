@@ -23,8 +23,12 @@
 
 #include <arpa/inet.h>
 #include <blackboard/blackboard.h>
+#include <blackboard/net/delta.h>
+#include <blackboard/net/handler.h>
 #include <blackboard/net/interface_listener.h>
 #include <blackboard/net/messages.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/component_ids.h>
@@ -41,6 +45,12 @@ namespace fawkes {
  * Interface listener for network handler.
  * This class is used by the BlackBoardNetworkHandler to track interface changes and
  * send out notifications timely.
+ *
+ * Data changes are not sent immediately. The interface is only marked as
+ * dirty and scheduled with the network handler, which sends the then current
+ * data with send_data(). Multiple writes that happen before the handler gets
+ * to run are thereby coalesced into a single update. If the client requested
+ * delta encoding, updates are sent as MSG_BB_DATA_DELTA.
  * @author Tim Niemueller
  */
 
@@ -49,11 +59,14 @@ namespace fawkes {
  * @param interface interface to care about
  * @param hub Fawkes network hub to use to send messages
  * @param clid client ID of the client which opened this interface
+ * @param handler network handler which sends data updates
  */
-BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(BlackBoard *blackboard,
-                                                                             Interface * interface,
-                                                                             FawkesNetworkHub *hub,
-                                                                             unsigned int      clid)
+BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(
+  BlackBoard *              blackboard,
+  Interface *               interface,
+  FawkesNetworkHub *        hub,
+  unsigned int              clid,
+  BlackBoardNetworkHandler *handler)
 : BlackBoardInterfaceListener("NetIL/%s", interface->uid())
 {
 	bbil_add_data_interface(interface);
@@ -67,6 +80,12 @@ BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(Bla
 	interface_  = interface;
 	fnh_        = hub;
 	clid_       = clid;
+	handler_    = handler;
+
+	mutex_   = new Mutex();
+	dirty_   = false;
+	encoder_ = NULL;
+	decoder_ = NULL;
 
 	blackboard_->register_listener(this);
 }
@@ -75,29 +94,101 @@ BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(Bla
 BlackBoardNetHandlerInterfaceListener::~BlackBoardNetHandlerInterfaceListener()
 {
 	blackboard_->unregister_listener(this);
+	delete encoder_;
+	delete decoder_;
+	delete mutex_;
 }
 
+/** Enable delta encoding.
+ * Called when the client sent an MSG_BB_DELTA_REQUEST. The next update is sent
+ * as keyframe.
+ * @param flags blackboard_delta_caps_t flags, unsupported flags are ignored
+ */
 void
-BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) throw()
+BlackBoardNetHandlerInterfaceListener::set_delta_flags(unsigned int flags)
+{
+	MutexLocker lock(mutex_);
+	delete encoder_;
+	delete decoder_;
+	encoder_ = NULL;
+	decoder_ = NULL;
+	if (flags & BB_DELTA_CAP_ENCODING) {
+		encoder_ = new BlackBoardDeltaEncoder(interface_->datasize(), flags);
+		decoder_ = new BlackBoardDeltaDecoder(interface_->datasize());
+	}
+}
+
+/** Decode delta update sent by the client.
+ * @param msg MSG_BB_DATA_DELTA message
+ * @return decoded data chunk, valid until the next call
+ * @exception Exception thrown if delta encoding has not been requested or
+ * if the update cannot be decoded
+ */
+const void *
+BlackBoardNetHandlerInterfaceListener::decode_data_delta(FawkesNetworkMessage *msg)
+{
+	MutexLocker lock(mutex_);
+	if (!decoder_) {
+		throw Exception("Received delta for %s, but delta encoding not requested", interface_->uid());
+	}
+	return decoder_->decode(msg->payload(), msg->payload_size());
+}
+
+/** Send pending data change.
+ * Reads the interface and sends its current data if it has changed since the
+ * last update that has been sent.
+ */
+void
+BlackBoardNetHandlerInterfaceListener::send_data()
 {
-	// send out data changed notification
-	interface->read();
+	MutexLocker lock(mutex_);
+	if (!dirty_)
+		return;
+	dirty_ = false;
 
-	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
-	void *          payload      = malloc(payload_size);
-	bb_idata_msg_t *dm           = (bb_idata_msg_t *)payload;
-	dm->serial                   = htonl(interface->serial());
-	dm->data_size                = htonl(interface->datasize());
-	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface->datachunk(), interface->datasize());
+	interface_->read();
+
+	unsigned int msgid;
+	size_t       payload_size;
+	void *       payload;
+	if (encoder_) {
+		msgid   = MSG_BB_DATA_DELTA;
+		payload = encoder_->encode(interface_->serial(), interface_->datachunk(), payload_size);
+	} else {
+		msgid        = MSG_BB_DATA_CHANGED;
+		payload_size = sizeof(bb_idata_msg_t) + interface_->datasize();
+		payload      = malloc(payload_size);
+
+		bb_idata_msg_t *dm = (bb_idata_msg_t *)payload;
+		dm->serial         = htonl(interface_->serial());
+		dm->data_size      = htonl(interface_->datasize());
+		memcpy((char *)payload + sizeof(bb_idata_msg_t),
+		       interface_->datachunk(),
+		       interface_->datasize());
+	}
 
 	try {
-		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_CHANGED, payload, payload_size);
+		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, msgid, payload, payload_size);
 	} catch (Exception &e) {
 		LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data, exception follows");
 		LibLogger::log_warn(bbil_name(), e);
 	}
 }
 
+void
+BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) throw()
+{
+	// only schedule, the handler sends the data in its next cycle
+	mutex_->lock();
+	bool scheduled = dirty_;
+	dirty_         = true;
+	mutex_->unlock();
+
+	if (!scheduled) {
+		handler_->schedule_data_send(interface->serial());
+	}
+}
+
 bool
 BlackBoardNetHandlerInterfaceListener::bb_interface_message_received(Interface *interface,
                                                                      Message *  message) throw()
@@ -129,6 +220,9 @@ BlackBoardNetHandlerInterfaceListener::send_event_serial(Interface *  interface,
                                                          unsigned int msg_id,
                                                          unsigned int event_serial)
 {
+	// keep order with respect to data updates which have not been sent, yet
+	send_data();
+
 	bb_ieventserial_msg_t *esm = (bb_ieventserial_msg_t *)malloc(sizeof(bb_ieventserial_msg_t));
 	esm->serial                = htonl(interface->serial());
 	esm->event_serial          = htonl(event_serial);
@@ -29,17 +29,27 @@
 namespace fawkes {
 
 class FawkesNetworkHub;
+class FawkesNetworkMessage;
 class BlackBoard;
+class BlackBoardNetworkHandler;
+class BlackBoardDeltaEncoder;
+class BlackBoardDeltaDecoder;
+class Mutex;
 
 class BlackBoardNetHandlerInterfaceListener : public BlackBoardInterfaceListener
 {
 public:
-	BlackBoardNetHandlerInterfaceListener(BlackBoard *      blackboard,
-	                                      Interface *       interface,
-	                                      FawkesNetworkHub *hub,
-	                                      unsigned int      clid);
+	BlackBoardNetHandlerInterfaceListener(BlackBoard *              blackboard,
+	                                      Interface *               interface,
+	                                      FawkesNetworkHub *        hub,
+	                                      unsigned int              clid,
+	                                      BlackBoardNetworkHandler *handler);
 	virtual ~BlackBoardNetHandlerInterfaceListener();
 
+	void        set_delta_flags(unsigned int flags);
+	void        send_data();
+	const void *decode_data_delta(FawkesNetworkMessage *msg);
+
 	virtual void bb_interface_data_changed(Interface *interface) throw();
 	virtual bool bb_interface_message_received(Interface *interface, Message *message) throw();
 	virtual void bb_interface_writer_added(Interface *  interface,
@@ -54,11 +64,17 @@ public:
 private:
 	void send_event_serial(Interface *interface, unsigned int msg_id, unsigned int event_serial);
 
-	BlackBoard *      blackboard_;
-	Interface *       interface_;
-	FawkesNetworkHub *fnh_;
+	BlackBoard *              blackboard_;
+	Interface *               interface_;
+	FawkesNetworkHub *        fnh_;
+	BlackBoardNetworkHandler *handler_;
 
 	unsigned int clid_;
+
+	Mutex *                 mutex_;
+	bool                    dirty_;
+	BlackBoardDeltaEncoder *encoder_;
+	BlackBoardDeltaDecoder *decoder_;
 };
 
 } // end namespace fawkes
@@ -25,6 +25,7 @@
 #include <blackboard/internal/instance_factory.h>
 #include <blackboard/internal/interface_mem_header.h>
 #include <blackboard/internal/notifier.h>
+#include <blackboard/net/delta.h>
 #include <blackboard/net/interface_proxy.h>
 #include <blackboard/net/messages.h>
 #include <core/threading/refc_rwlock.h>
@@ -41,6 +42,8 @@ namespace fawkes {
  * Interface proxy for remote BlackBoard.
  * This proxy is used internally by RemoteBlackBoard to interact with an interface
  * on the one side and the remote BlackBoard on the other side.
+ * If the remote BlackBoard supports it, data updates can be delta encoded in
+ * both directions after calling enable_delta().
  * @author Tim Niemueller
  */
 
@@ -74,12 +77,21 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 	data_size_       = ntohl(osm->data_size);
 	clid_            = msg->clid();
 	next_msg_id_     = 1;
+	delta_caps_      = 0;
+	encoder_         = NULL;
+	decoder_         = NULL;
 
 	if (interface->datasize() != data_size_) {
 		// Boom, sizes do not match
 		throw Exception("Network message does not carry chunk of expected size");
 	}
 
+	if (msg->payload_size() >= sizeof(bb_iopensucc_msg_t) + data_size_ + sizeof(uint32_t)) {
+		uint32_t caps;
+		memcpy(&caps, (char *)payload + sizeof(bb_iopensucc_msg_t) + data_size_, sizeof(uint32_t));
+		delta_caps_ = ntohl(caps);
+	}
+
 	rwlock_     = new RefCountRWLock();
 	mem_chunk_  = malloc(sizeof(interface_header_t) + data_size_);
 	data_chunk_ = (char *)mem_chunk_ + sizeof(interface_header_t);
@@ -104,9 +116,47 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 /** Destructor. */
 BlackBoardInterfaceProxy::~BlackBoardInterfaceProxy()
 {
+	delete encoder_;
+	delete decoder_;
 	free(mem_chunk_);
 }
 
+/** Get delta encoding capabilities of remote BlackBoard.
+ * @return blackboard_delta_caps_t flags announced by the remote BlackBoard,
+ * zero if it does not support delta encoding
+ */
+unsigned int
+BlackBoardInterfaceProxy::delta_capabilities() const
+{
+	return delta_caps_;
+}
+
+/** Enable delta encoding of data updates.
+ * Sends a request to the remote BlackBoard. Has no effect if the remote
+ * BlackBoard does not support delta encoding. Must be called before the
+ * interface is used.
+ * @param flags requested blackboard_delta_caps_t flags, only flags supported
+ * by both sides are enabled
+ */
+void
+BlackBoardInterfaceProxy::enable_delta(unsigned int flags)
+{
+	flags &= delta_caps_ & BlackBoardDeltaEncoder::capabilities();
+	if (!(flags & BB_DELTA_CAP_ENCODING) || encoder_)
+		return;
+
+	bb_idelta_req_msg_t *rm = (bb_idelta_req_msg_t *)malloc(sizeof(bb_idelta_req_msg_t));
+	rm->serial              = htonl(instance_serial_);
+	rm->flags               = htonl(flags);
+
+	encoder_ = new BlackBoardDeltaEncoder(data_size_, flags);
+	decoder_ = new BlackBoardDeltaDecoder(data_size_);
+
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+	  clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DELTA_REQUEST, rm, sizeof(bb_idelta_req_msg_t));
+	fnc_->enqueue(omsg);
+}
+
 /** Process MSG_BB_DATA_CHANGED message.
  * @param msg message to process.
  */
@@ -146,6 +196,53 @@ BlackBoardInterfaceProxy::process_data_changed(FawkesNetworkMessage *msg)
 	notifier_->notify_of_data_change(interface_);
 }
 
+/** Process MSG_BB_DATA_DELTA message.
+ * @param msg message to process.
+ */
+void
+BlackBoardInterfaceProxy::process_data_delta(FawkesNetworkMessage *msg)
+{
+	if (msg->msgid() != MSG_BB_DATA_DELTA) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Expected data delta BB message, but "
+		                     "received message of type %u, ignoring.",
+		                     msg->msgid());
+		return;
+	}
+
+	if (!decoder_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Received data delta for %s, but delta "
+		                     "encoding has not been enabled, ignoring.",
+		                     interface_->uid());
+		return;
+	}
+
+	bb_idelta_msg_t *dm = (bb_idelta_msg_t *)msg->payload();
+	if (msg->payload_size() < sizeof(bb_idelta_msg_t)) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Data delta message too short, ignoring.");
+		return;
+	}
+	if (ntohl(dm->serial) != instance_serial_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Serial mismatch (delta), expected %u, "
+		                     "but got %u, ignoring.",
+		                     instance_serial_,
+		                     ntohl(dm->serial));
+		return;
+	}
+
+	try {
+		memcpy(data_chunk_, decoder_->decode(msg->payload(), msg->payload_size()), data_size_);
+	} catch (Exception &e) {
+		LibLogger::log_error("BlackBoardInterfaceProxy", e);
+		return;
+	}
+
+	notifier_->notify_of_data_change(interface_);
+}
+
 /** Process MSG_BB_INTERFACE message.
  * @param msg message to process.
  */
@@ -312,6 +409,16 @@ BlackBoardInterfaceProxy::writer(const Interface *interface) const
 void
 BlackBoardInterfaceProxy::notify_of_data_change(const Interface *interface)
 {
+	if (encoder_) {
+		size_t payload_size;
+		void * payload = encoder_->encode(interface->serial(), interface->datachunk(), payload_size);
+
+		FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+		  clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_DELTA, payload, payload_size);
+		fnc_->enqueue(omsg);
+		return;
+	}
+
 	// need to send write message
 	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
 	void *          payload      = malloc(payload_size);
@@ -35,6 +35,8 @@ class FawkesNetworkClient;
 class FawkesNetworkMessage;
 class RefCountRWLock;
 class BlackBoardNotifier;
+class BlackBoardDeltaEncoder;
+class BlackBoardDeltaDecoder;
 class Interface;
 
 class BlackBoardInterfaceProxy : public InterfaceMediator, public MessageMediator
@@ -48,6 +50,7 @@ public:
 	~BlackBoardInterfaceProxy();
 
 	void process_data_changed(FawkesNetworkMessage *msg);
+	void process_data_delta(FawkesNetworkMessage *msg);
 	void process_interface_message(FawkesNetworkMessage *msg);
 	void reader_added(unsigned int event_serial);
 	void reader_removed(unsigned int event_serial);
@@ -58,6 +61,9 @@ public:
 	unsigned int clid() const;
 	Interface *  interface() const;
 
+	unsigned int delta_capabilities() const;
+	void         enable_delta(unsigned int flags);
+
 	/* InterfaceMediator */
 	virtual bool                   exists_writer(const Interface *interface) const;
 	virtual unsigned int           num_readers(const Interface *interface) const;
@@ -91,6 +97,10 @@ private:
 	unsigned int   num_readers_;
 	bool           has_writer_;
 	unsigned int   clid_;
+
+	unsigned int            delta_caps_;
+	BlackBoardDeltaEncoder *encoder_;
+	BlackBoardDeltaDecoder *decoder_;
 };
 
 } // end namespace fawkes
@@ -51,9 +51,27 @@ typedef enum {
 	MSG_BB_WRITER_REMOVED      = 13,
 	MSG_BB_INTERFACE_CREATED   = 14,
 	MSG_BB_INTERFACE_DESTROYED = 15,
-	MSG_BB_LIST                = 16
+	MSG_BB_LIST                = 16,
+	MSG_BB_DELTA_REQUEST       = 17,
+	MSG_BB_DATA_DELTA          = 18
 } blackboard_msgid_t;
 
+/** Delta encoding capabilities.
+ * These flags are announced by the server after the data chunk of an
+ * MSG_BB_OPEN_SUCCESS message and requested by the client with an
+ * MSG_BB_DELTA_REQUEST message.
+ */
+typedef enum {
+	BB_DELTA_CAP_ENCODING    = 1, /**< changed-block delta encoding of data updates */
+	BB_DELTA_CAP_COMPRESSION = 2  /**< deflate compression of data updates */
+} blackboard_delta_caps_t;
+
+/** Flags of a delta encoded data update. */
+typedef enum {
+	BB_DELTA_FLAG_KEYFRAME   = 1, /**< payload contains the full data chunk */
+	BB_DELTA_FLAG_COMPRESSED = 2  /**< payload is deflate compressed */
+} blackboard_delta_flags_t;
+
 /** Error codes */
 typedef enum {
 	BB_ERR_UNKNOWN_ERR,   /**< Unknown error occured. Check log. */
@@ -136,6 +154,9 @@ typedef struct
  * BlackBoard.
  * This message struct is always followed by a data chunk that is of the
  * size data_size. It contains the current content of the interface.
+ * If the BlackBoard supports delta encoding, the data chunk is followed by
+ * a uint32_t with the supported blackboard_delta_caps_t flags (big endian).
+ * Older clients ignore this trailing field.
  */
 typedef struct
 {
@@ -166,6 +187,35 @@ typedef struct
 	uint32_t data_size; /**< size in bytes of the following data. */
 } bb_idata_msg_t;
 
+/** Delta encoding request.
+ * Sent by the client for MSG_BB_DELTA_REQUEST after the open success message
+ * announced delta encoding capabilities. From then on data updates for the
+ * instance are sent as MSG_BB_DATA_DELTA in both directions.
+ */
+typedef struct
+{
+	uint32_t serial; /**< instance serial to unique identify this instance */
+	uint32_t flags;  /**< requested blackboard_delta_caps_t flags (big endian) */
+} bb_idelta_req_msg_t;
+
+/** Delta encoded interface data message.
+ * This message struct is always followed by a payload of the size payload_size.
+ * For a keyframe the (uncompressed) payload is the full data chunk. Otherwise
+ * it is a bitmap with one bit per block of BB_DELTA_BLOCK_SIZE bytes of the
+ * data chunk, followed by the content of all blocks marked as changed
+ * compared to the previous update. This message is sent for MSG_BB_DATA_DELTA.
+ */
+typedef struct
+{
+	uint32_t serial;       /**< instance serial to unique identify this instance */
+	uint32_t seq;          /**< sequence number of this update */
+	uint16_t flags;        /**< blackboard_delta_flags_t flags */
+	uint16_t reserved;     /**< reserved for future use */
+	uint32_t data_size;    /**< size in bytes of the interface data chunk */
+	uint32_t raw_size;     /**< size in bytes of the uncompressed payload */
+	uint32_t payload_size; /**< size in bytes of the following payload */
+} bb_idelta_msg_t;
+
 /** Interface message.
  * This type is used to transport interface messages. This struct is always followed
  * by a data chunk of the size data_size that transports the message data.
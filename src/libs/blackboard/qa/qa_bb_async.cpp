@@ -0,0 +1,204 @@
+
+/***************************************************************************
+ *  qa_bb_async.cpp - BlackBoard asynchronous listener dispatch QA
+ *
+ *  Created: Sun Oct 18 17:05:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/interface_listener.h>
+#include <blackboard/local.h>
+#include <core/exceptions/system.h>
+#include <core/threading/thread.h>
+#include <interfaces/TestInterface.h>
+#include <logging/liblogger.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace fawkes;
+
+#define NUM_WRITES 200
+#define LISTENER_DELAY_USEC 200
+
+class QaSlowListener : public BlackBoardInterfaceListener
+{
+public:
+	QaSlowListener(Interface *i1, Interface *i2)
+	: BlackBoardInterfaceListener("QaSlowListener"), count(0), count_in_writer(0)
+	{
+		bbil_add_data_interface(i1);
+		if (i2)
+			bbil_add_data_interface(i2);
+		writer_thread = pthread_self();
+	}
+
+	void
+	add_interface(Interface *interface)
+	{
+		bbil_add_data_interface(interface);
+	}
+
+	void
+	set_queue(unsigned int size, AsyncOverflowPolicy policy)
+	{
+		bbil_set_async_queue(size, policy);
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *interface) throw()
+	{
+		interface->read();
+		usleep(LISTENER_DELAY_USEC);
+		if (pthread_equal(pthread_self(), writer_thread))
+			++count_in_writer;
+		++count;
+	}
+
+	volatile unsigned int count;
+	volatile unsigned int count_in_writer;
+	pthread_t             writer_thread;
+};
+
+static void
+run(BlackBoard *bb, TestInterface *w1, TestInterface *w2, const char *mode, int policy)
+{
+	TestInterface *r1 = bb->open_for_reading<TestInterface>("Async 1");
+	TestInterface *r2 = bb->open_for_reading<TestInterface>("Async 2");
+
+	QaSlowListener l(r1, r2);
+	if (policy >= 0) {
+		l.set_queue(8, (BlackBoardInterfaceListener::AsyncOverflowPolicy)policy);
+		bb->register_listener(&l, BlackBoard::BBIL_FLAG_DATA | BlackBoard::BBIL_FLAG_ASYNC);
+	} else {
+		bb->register_listener(&l, BlackBoard::BBIL_FLAG_DATA);
+	}
+
+	Time start;
+	for (unsigned int i = 0; i < NUM_WRITES; ++i) {
+		TestInterface *w = (i % 2) ? w1 : w2;
+		w->set_test_int(i);
+		w->write();
+	}
+	Time end;
+	float lag = l.bbil_async_lag();
+	usleep(100000);
+
+	printf("%-10s  write: %8.3f ms  delivered: %3u  dropped: %3u  coalesced: %3u  "
+	       "lag: %6.2f ms  max lag: %6.2f ms\n",
+	       mode,
+	       (end - &start) * 1000.,
+	       l.count,
+	       l.bbil_async_num_dropped(),
+	       l.bbil_async_num_coalesced(),
+	       lag * 1000.,
+	       l.bbil_async_max_lag() * 1000.);
+
+	bb->unregister_listener(&l);
+	bb->close(r1);
+	bb->close(r2);
+}
+
+/* Adding an interface to an async listener and updating it for data
+ * events only must keep the listener asynchronous. */
+static unsigned int
+run_update(BlackBoard *bb, TestInterface *w1, TestInterface *w2)
+{
+	unsigned int   errors = 0;
+	TestInterface *r1     = bb->open_for_reading<TestInterface>("Async 1");
+	TestInterface *r2     = bb->open_for_reading<TestInterface>("Async 2");
+
+	QaSlowListener l(r1, NULL);
+	bb->register_listener(&l, BlackBoard::BBIL_FLAG_DATA | BlackBoard::BBIL_FLAG_ASYNC);
+	l.add_interface(r2);
+	bb->update_listener(&l, BlackBoard::BBIL_FLAG_DATA);
+	if (!l.bbil_async()) {
+		printf("update     listener no longer asynchronous after update\n");
+		++errors;
+	}
+
+	for (unsigned int i = 0; i < 10; ++i) {
+		TestInterface *w = (i % 2) ? w1 : w2;
+		w->set_test_int(i);
+		w->write();
+	}
+	usleep(100000);
+
+	printf("update     delivered: %3u  in writer thread: %3u\n", l.count, l.count_in_writer);
+	if (l.count_in_writer > 0) {
+		printf("update     events delivered synchronously after update\n");
+		++errors;
+	}
+	if (l.count == 0) {
+		printf("update     no events delivered\n");
+		++errors;
+	}
+
+	bb->unregister_listener(&l);
+	if (l.bbil_async()) {
+		printf("update     listener still asynchronous after unregistering\n");
+		++errors;
+	}
+	bb->close(r1);
+	bb->close(r2);
+	return errors;
+}
+
+int
+main(int argc, char **argv)
+{
+	LibLogger::init();
+	Thread::init_main();
+
+	BlackBoard * bb     = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+	unsigned int errors = 0;
+
+	try {
+		TestInterface *w1 = bb->open_for_writing<TestInterface>("Async 1");
+		TestInterface *w2 = bb->open_for_writing<TestInterface>("Async 2");
+
+		run(bb, w1, w2, "sync", -1);
+		run(bb, w1, w2, "coalesce", BlackBoardInterfaceListener::ASYNC_COALESCE);
+		run(bb, w1, w2, "drop", BlackBoardInterfaceListener::ASYNC_DROP_OLDEST);
+		run(bb, w1, w2, "block", BlackBoardInterfaceListener::ASYNC_BLOCK);
+		errors += run_update(bb, w1, w2);
+
+		bb->close(w1);
+		bb->close(w2);
+	} catch (Exception &e) {
+		printf("QA failed! Aborting\n");
+		e.print_trace();
+		exit(1);
+	}
+
+	delete bb;
+	Thread::destroy_main();
+	LibLogger::finalize();
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,195 @@
+
+/***************************************************************************
+ *  qa_bb_delta.cpp - BlackBoard network delta encoding QA
+ *
+ *  Created: Wed Oct 21 14:52:19 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/local.h>
+#include <blackboard/net/delta.h>
+#include <blackboard/net/messages.h>
+#include <blackboard/remote.h>
+#include <core/exception.h>
+#include <interfaces/TestInterface.h>
+#include <netcomm/fawkes/server_thread.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define NUM_UPDATES 1000
+
+static bool
+test_codec(unsigned int flags)
+{
+	size_t data_size = 1000;
+	char * data      = (char *)calloc(1, data_size);
+
+	BlackBoardDeltaEncoder enc(data_size, flags, 50);
+	BlackBoardDeltaDecoder dec(data_size);
+
+	size_t full_bytes = 0, sent_bytes = 0;
+	for (unsigned int i = 0; i < NUM_UPDATES; ++i) {
+		// mostly small changes, sometimes larger ones
+		unsigned int num_changes = (i % 97 == 0) ? 500 : (rand() % 4);
+		for (unsigned int c = 0; c < num_changes; ++c) {
+			data[rand() % data_size] = (char)rand();
+		}
+
+		size_t payload_size;
+		void * payload = enc.encode(1, data, payload_size);
+		full_bytes += sizeof(bb_idata_msg_t) + data_size;
+		sent_bytes += payload_size;
+
+		try {
+			const void *decoded = dec.decode(payload, payload_size);
+			if (memcmp(decoded, data, data_size) != 0) {
+				printf("Update %u decoded incorrectly\n", i);
+				free(payload);
+				free(data);
+				return false;
+			}
+		} catch (Exception &e) {
+			e.print_trace();
+			free(payload);
+			free(data);
+			return false;
+		}
+		free(payload);
+	}
+
+	// a missing update must be detected and recovered from with a keyframe
+	size_t payload_size;
+	free(enc.encode(1, data, payload_size));
+	data[0]       = ~data[0];
+	void *payload = enc.encode(1, data, payload_size);
+	bool  caught  = false;
+	try {
+		dec.decode(payload, payload_size);
+	} catch (Exception &e) {
+		caught = true;
+	}
+	free(payload);
+	enc.force_keyframe();
+	payload = enc.encode(1, data, payload_size);
+	bool recovered =
+	  caught && (memcmp(dec.decode(payload, payload_size), data, data_size) == 0);
+	free(payload);
+	free(data);
+
+	printf("Codec (flags %x): %zu bytes instead of %zu (%.1f%%), gap %s\n",
+	       flags,
+	       sent_bytes,
+	       full_bytes,
+	       100. * sent_bytes / full_bytes,
+	       recovered ? "detected and recovered" : "NOT handled");
+	return recovered;
+}
+
+static bool
+wait_for_value(TestInterface *reader, int value)
+{
+	for (unsigned int i = 0; i < 200; ++i) {
+		reader->read();
+		if (reader->test_int() == value)
+			return true;
+		usleep(10000);
+	}
+	printf("%s: expected %i, got %i\n", reader->uid(), value, reader->test_int());
+	return false;
+}
+
+static bool
+test_remote()
+{
+	LocalBlackBoard *llbb = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+	BlackBoard *     lbb  = llbb;
+
+	FawkesNetworkServerThread *fns = new FawkesNetworkServerThread(true, false, "", "", 1921);
+	fns->start();
+	llbb->start_nethandler(fns);
+
+	RemoteBlackBoard *rbb_delta = new RemoteBlackBoard("localhost", 1921);
+	RemoteBlackBoard *rbb_full  = new RemoteBlackBoard("localhost", 1921);
+	rbb_delta->set_delta_encoding(true, true);
+	rbb_full->set_delta_encoding(false);
+	BlackBoard *dbb = rbb_delta;
+	BlackBoard *fbb = rbb_full;
+
+	TestInterface *lwriter  = lbb->open_for_writing<TestInterface>("Delta");
+	TestInterface *rdreader = dbb->open_for_reading<TestInterface>("Delta");
+	TestInterface *rfreader = fbb->open_for_reading<TestInterface>("Delta");
+	TestInterface *rdwriter = dbb->open_for_writing<TestInterface>("DeltaRemote");
+	TestInterface *lreader  = lbb->open_for_reading<TestInterface>("DeltaRemote");
+
+	bool ok = true;
+	for (int i = 1; ok && (i <= NUM_UPDATES); ++i) {
+		lwriter->set_test_int(i);
+		lwriter->write();
+		rdwriter->set_test_int(-i);
+		if (i % 100 == 0) {
+			rdwriter->set_test_string("changed");
+		}
+		rdwriter->write();
+		if (i % 250 == 0) {
+			ok = wait_for_value(rdreader, i) && wait_for_value(rfreader, i)
+			     && wait_for_value(lreader, -i);
+		}
+	}
+	if (ok && (strcmp(lreader->test_string(), "changed") != 0)) {
+		printf("String not transmitted\n");
+		ok = false;
+	}
+
+	rbb_delta->close(rdreader);
+	rbb_delta->close(rdwriter);
+	rbb_full->close(rfreader);
+	lbb->close(lwriter);
+	lbb->close(lreader);
+
+	delete rbb_delta;
+	delete rbb_full;
+	delete llbb;
+	fns->cancel();
+	fns->join();
+	delete fns;
+
+	printf("Remote updates %s\n", ok ? "passed" : "FAILED");
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+	srand(42);
+
+	bool ok = test_codec(BB_DELTA_CAP_ENCODING)
+	          && test_codec(BB_DELTA_CAP_ENCODING | BB_DELTA_CAP_COMPRESSION) && test_remote();
+
+	printf("QA %s\n", ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,224 @@
+
+/***************************************************************************
+ *  qa_bb_memchurn.cpp - BlackBoard memory manager plugin churn QA
+ *
+ *  Created: Sun Oct 18 18:32:10 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/exceptions.h>
+#include <blackboard/internal/memory_manager.h>
+#include <core/exceptions/system.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+using namespace fawkes;
+
+#define NUM_PLUGINS 40
+#define MAX_INTERFACES_PER_PLUGIN 12
+#define NUM_ROUNDS 20000
+#define REPORT_INTERVAL 2000
+#define BLACKBOARD_MEMORY_SIZE 2 * 1024 * 1024
+
+// A plugin opens a fixed set of interfaces whenever it is loaded
+typedef struct
+{
+	vector<unsigned int> sizes;
+	vector<void *>       chunks;
+	bool                 loaded;
+} Plugin;
+
+static void
+churn(BlackBoardMemoryManager::Allocator allocator, const char *name, unsigned int rounds)
+{
+	BlackBoardMemoryManager *mm = new BlackBoardMemoryManager(BLACKBOARD_MEMORY_SIZE, allocator);
+
+	srand(42);
+	vector<Plugin> plugins(NUM_PLUGINS);
+	for (unsigned int p = 0; p < NUM_PLUGINS; ++p) {
+		unsigned int num_interfaces = 1 + rand() % MAX_INTERFACES_PER_PLUGIN;
+		for (unsigned int i = 0; i < num_interfaces; ++i) {
+			// most interfaces are small, some carry larger arrays (laser, objects)
+			unsigned int size = (rand() % 10 == 0) ? 4000 + rand() % 60000 : 100 + rand() % 2000;
+			plugins[p].sizes.push_back(size);
+		}
+		plugins[p].loaded = false;
+	}
+
+	printf("%s allocator\n", name);
+	printf("%8s %7s %7s %7s %10s %10s %10s %9s %9s %5s\n",
+	       "round",
+	       "plugins",
+	       "alloc",
+	       "free",
+	       "free size",
+	       "max free",
+	       "overhang",
+	       "alloc us",
+	       "free us",
+	       "oom");
+
+	unsigned int num_allocs = 0, num_frees = 0, num_oom = 0;
+	double       alloc_time = 0., free_time = 0.;
+
+	for (unsigned int r = 1; r <= rounds; ++r) {
+		Plugin &p = plugins[rand() % NUM_PLUGINS];
+		if (p.loaded) {
+			Time start;
+			for (unsigned int i = 0; i < p.chunks.size(); ++i) {
+				mm->free(p.chunks[i]);
+			}
+			Time end;
+			free_time += end - &start;
+			num_frees += p.chunks.size();
+			p.chunks.clear();
+			p.loaded = false;
+		} else {
+			Time start;
+			try {
+				for (unsigned int i = 0; i < p.sizes.size(); ++i) {
+					p.chunks.push_back(mm->alloc(p.sizes[i]));
+				}
+				p.loaded = true;
+			} catch (OutOfMemoryException &e) {
+				// plugin fails to load, release what it got so far
+				++num_oom;
+				for (unsigned int i = 0; i < p.chunks.size(); ++i) {
+					mm->free(p.chunks[i]);
+				}
+				p.chunks.clear();
+			}
+			Time end;
+			alloc_time += end - &start;
+			num_allocs += p.sizes.size();
+		}
+
+		if (r % REPORT_INTERVAL == 0) {
+			try {
+				mm->check();
+			} catch (BBInconsistentMemoryException &e) {
+				printf("Inconsistent memory found, aborting\n");
+				e.print_trace();
+				exit(1);
+			}
+
+			unsigned int num_loaded = 0;
+			for (unsigned int i = 0; i < NUM_PLUGINS; ++i) {
+				if (plugins[i].loaded)
+					++num_loaded;
+			}
+			printf("%8u %7u %7u %7u %10u %10u %10u %9.3f %9.3f %5u\n",
+			       r,
+			       num_loaded,
+			       mm->num_allocated_chunks(),
+			       mm->num_free_chunks(),
+			       mm->free_size(),
+			       mm->max_free_size(),
+			       mm->overhang_size(),
+			       num_allocs ? alloc_time * 1000000. / num_allocs : 0.,
+			       num_frees ? free_time * 1000000. / num_frees : 0.,
+			       num_oom);
+		}
+	}
+	printf("\n");
+
+	delete mm;
+}
+
+/* Fill the memory with small chunks and free all but the last one in
+ * interleaved order. The freed chunks must be merged, such that a chunk
+ * of half the memory size can be allocated, and everything must be given
+ * back to the wilderness once the last chunk is freed. */
+static unsigned int
+check_coalesce(BlackBoardMemoryManager::Allocator allocator, const char *name)
+{
+	unsigned int             errors = 0;
+	BlackBoardMemoryManager *mm = new BlackBoardMemoryManager(BLACKBOARD_MEMORY_SIZE, allocator);
+
+	vector<void *> chunks;
+	try {
+		while (true) {
+			chunks.push_back(mm->alloc(100 + chunks.size() % 200));
+		}
+	} catch (OutOfMemoryException &e) {
+		// memory is full
+	}
+	void *last = chunks.back();
+	chunks.pop_back();
+	for (unsigned int odd = 0; odd < 2; ++odd) {
+		for (unsigned int i = odd; i < chunks.size(); i += 2) {
+			mm->free(chunks[i]);
+		}
+	}
+
+	try {
+		mm->check();
+		mm->free(mm->alloc(BLACKBOARD_MEMORY_SIZE / 2));
+	} catch (Exception &e) {
+		printf("%s: allocating half the memory after freeing %zu chunks failed\n",
+		       name,
+		       chunks.size());
+		e.print_trace();
+		++errors;
+	}
+
+	mm->free(last);
+	if (mm->num_free_chunks() != 1) {
+		printf("%s: %u free chunks remain in empty memory\n", name, mm->num_free_chunks());
+		++errors;
+	}
+	try {
+		mm->check();
+	} catch (BBInconsistentMemoryException &e) {
+		printf("%s: inconsistent memory after freeing all chunks\n", name);
+		e.print_trace();
+		++errors;
+	}
+	printf("%s: freed %zu chunks, %u free chunks, max free %u\n",
+	       name,
+	       chunks.size() + 1,
+	       mm->num_free_chunks(),
+	       mm->max_free_size());
+
+	delete mm;
+	return errors;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int rounds = (argc > 1) ? atoi(argv[1]) : NUM_ROUNDS;
+	unsigned int errors = 0;
+
+	churn(BlackBoardMemoryManager::ALLOCATOR_BEST_FIT, "Best-fit", rounds);
+	churn(BlackBoardMemoryManager::ALLOCATOR_SIZE_CLASS, "Size class", rounds);
+
+	errors += check_coalesce(BlackBoardMemoryManager::ALLOCATOR_BEST_FIT, "Best-fit");
+	errors += check_coalesce(BlackBoardMemoryManager::ALLOCATOR_SIZE_CLASS, "Size class");
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
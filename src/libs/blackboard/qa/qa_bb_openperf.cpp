@@ -0,0 +1,112 @@
+
+/***************************************************************************
+ *  qa_bb_openperf.cpp - BlackBoard interface open/close performance QA
+ *
+ *  Created: Sun Oct 18 10:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/exceptions.h>
+#include <blackboard/local.h>
+#include <core/exceptions/system.h>
+#include <interfaces/TestInterface.h>
+#include <logging/liblogger.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+using namespace fawkes;
+
+#define NUM_INTERFACES 5000
+#define BB_MEMSIZE 16 * 1024 * 1024
+
+int
+main(int argc, char **argv)
+{
+	LibLogger::init();
+	BlackBoard *bb = new LocalBlackBoard(BB_MEMSIZE);
+
+	unsigned int num_interfaces = NUM_INTERFACES;
+	if (argc > 1) {
+		num_interfaces = atoi(argv[1]);
+	}
+
+	vector<TestInterface *> writers(num_interfaces, NULL);
+	vector<TestInterface *> readers(num_interfaces, NULL);
+	char                    id[INTERFACE_ID_SIZE_];
+
+	try {
+		Time start;
+		for (unsigned int i = 0; i < num_interfaces; ++i) {
+			snprintf(id, INTERFACE_ID_SIZE_, "Perf %u", i);
+			writers[i] = bb->open_for_writing<TestInterface>(id);
+		}
+		Time opened_writers;
+		for (unsigned int i = 0; i < num_interfaces; ++i) {
+			snprintf(id, INTERFACE_ID_SIZE_, "Perf %u", i);
+			readers[i] = bb->open_for_reading<TestInterface>(id);
+		}
+		Time opened_readers;
+		std::list<Interface *> multi = bb->open_multiple_for_reading("TestInterface", "Perf 1*");
+		Time opened_multi;
+		for (std::list<Interface *>::iterator i = multi.begin(); i != multi.end(); ++i) {
+			bb->close(*i);
+		}
+		Time closed_multi;
+		for (unsigned int i = 0; i < num_interfaces; ++i) {
+			bb->close(readers[i]);
+		}
+		Time closed_readers;
+		for (unsigned int i = 0; i < num_interfaces; ++i) {
+			bb->close(writers[i]);
+		}
+		Time closed_writers;
+
+		printf("Interfaces:     %u\n", num_interfaces);
+		printf("Open writers:   %8.3f ms (%6.2f usec/interface)\n",
+		       (opened_writers - &start) * 1000.,
+		       (opened_writers - &start) * 1000000. / num_interfaces);
+		printf("Open readers:   %8.3f ms (%6.2f usec/interface)\n",
+		       (opened_readers - &opened_writers) * 1000.,
+		       (opened_readers - &opened_writers) * 1000000. / num_interfaces);
+		printf("Open multiple:  %8.3f ms (%zu interfaces)\n",
+		       (opened_multi - &opened_readers) * 1000.,
+		       multi.size());
+		printf("Close multiple: %8.3f ms\n", (closed_multi - &opened_multi) * 1000.);
+		printf("Close readers:  %8.3f ms (%6.2f usec/interface)\n",
+		       (closed_readers - &closed_multi) * 1000.,
+		       (closed_readers - &closed_multi) * 1000000. / num_interfaces);
+		printf("Close writers:  %8.3f ms (%6.2f usec/interface)\n",
+		       (closed_writers - &closed_readers) * 1000.,
+		       (closed_writers - &closed_readers) * 1000000. / num_interfaces);
+	} catch (Exception &e) {
+		printf("Benchmark failed! Aborting\n");
+		e.print_trace();
+		exit(1);
+	}
+
+	delete bb;
+	LibLogger::finalize();
+}
+
+/// @endcond
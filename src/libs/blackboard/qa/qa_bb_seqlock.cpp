@@ -0,0 +1,201 @@
+
+/***************************************************************************
+ *  qa_bb_seqlock.cpp - BlackBoard seqlock contention QA
+ *
+ *  Created: Sun Oct 18 14:02:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/local.h>
+#include <core/exceptions/system.h>
+#include <core/threading/thread.h>
+#include <interfaces/Laser360Interface.h>
+#include <logging/liblogger.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace fawkes;
+
+#define BB_MEMSIZE 2 * 1024 * 1024
+
+class QaSeqlockWriterThread : public Thread
+{
+public:
+	QaSeqlockWriterThread(BlackBoard *bb)
+	: Thread("QaSeqlockWriterThread", Thread::OPMODE_CONTINUOUS), count(0)
+	{
+		iface_ = bb->open_for_writing<Laser360Interface>("Laser");
+		bb_    = bb;
+	}
+
+	virtual ~QaSeqlockWriterThread()
+	{
+		bb_->close(iface_);
+	}
+
+	virtual void
+	loop()
+	{
+		for (unsigned int i = 0; i < iface_->maxlenof_distances(); ++i) {
+			iface_->set_distances(i, (float)(count % 1000 + i));
+		}
+		iface_->write();
+		++count;
+	}
+
+	unsigned long count;
+
+private:
+	BlackBoard *       bb_;
+	Laser360Interface *iface_;
+};
+
+class QaSeqlockReaderThread : public Thread
+{
+public:
+	QaSeqlockReaderThread(BlackBoard *bb, bool view)
+	: Thread("QaSeqlockReaderThread", Thread::OPMODE_CONTINUOUS), count(0), torn(0), view_(view)
+	{
+		iface_ = bb->open_for_reading<Laser360Interface>("Laser");
+		bb_    = bb;
+	}
+
+	virtual ~QaSeqlockReaderThread()
+	{
+		bb_->close(iface_);
+	}
+
+	virtual void
+	loop()
+	{
+		float first, last;
+		if (view_) {
+			// only inspect the values needed in place, no copy
+			unsigned int version;
+			do {
+				version        = iface_->view_begin();
+				const float *d = iface_->view_distances();
+				first          = d[0];
+				last           = d[iface_->maxlenof_distances() - 1];
+			} while (!iface_->view_end(version));
+		} else {
+			iface_->read();
+			float *d = iface_->distances();
+			first    = d[0];
+			last     = d[iface_->maxlenof_distances() - 1];
+		}
+		// all values are written with the same offset, detect torn reads
+		if (last - first != iface_->maxlenof_distances() - 1) {
+			++torn;
+		}
+		++count;
+	}
+
+	unsigned long count;
+	unsigned long torn;
+
+private:
+	BlackBoard *       bb_;
+	Laser360Interface *iface_;
+	bool               view_;
+};
+
+static void
+run(const char * mode,
+    bool         seqlock,
+    bool         view,
+    unsigned int num_readers,
+    unsigned int duration_sec)
+{
+	LocalBlackBoard *bb = new LocalBlackBoard(BB_MEMSIZE);
+	if (seqlock) {
+		std::list<std::string> types;
+		types.push_back("*");
+		bb->set_seqlock_types(types);
+	}
+
+	QaSeqlockWriterThread *         writer = new QaSeqlockWriterThread(bb);
+	vector<QaSeqlockReaderThread *> readers;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers.push_back(new QaSeqlockReaderThread(bb, view));
+	}
+
+	Time start;
+	writer->start();
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers[i]->start();
+	}
+	sleep(duration_sec);
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers[i]->cancel();
+		readers[i]->join();
+	}
+	writer->cancel();
+	writer->join();
+	Time   end;
+	double secs = end - &start;
+
+	unsigned long reads = 0, torn = 0;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		reads += readers[i]->count;
+		torn += readers[i]->torn;
+		delete readers[i];
+	}
+	printf("%-13s readers: %2u  writes/s: %10.0f  reads/s: %10.0f  torn reads: %lu\n",
+	       mode,
+	       num_readers,
+	       writer->count / secs,
+	       reads / secs,
+	       torn);
+
+	delete writer;
+	delete bb;
+}
+
+int
+main(int argc, char **argv)
+{
+	LibLogger::init();
+
+	unsigned int max_readers  = (argc > 1) ? atoi(argv[1]) : 8;
+	unsigned int duration_sec = (argc > 2) ? atoi(argv[2]) : 2;
+
+	try {
+		for (unsigned int n = 1; n <= max_readers; n *= 2) {
+			run("rwlock", false, false, n, duration_sec);
+			run("rwlock view", false, true, n, duration_sec);
+			run("seqlock", true, false, n, duration_sec);
+			run("seqlock view", true, true, n, duration_sec);
+		}
+	} catch (Exception &e) {
+		printf("Benchmark failed! Aborting\n");
+		e.print_trace();
+		exit(1);
+	}
+
+	LibLogger::finalize();
+}
+
+/// @endcond
@@ -47,6 +47,10 @@ namespace fawkes {
  * This class implements the access to a remote BlackBoard using the Fawkes
  * network protocol.
  *
+ * If supported by the remote BlackBoard, interface data updates are delta
+ * encoded, i.e. only the parts of the data that changed since the last update
+ * are transmitted. This can be configured with set_delta_encoding().
+ *
  * @author Tim Niemueller
  */
 
@@ -72,6 +76,9 @@ RemoteBlackBoard::RemoteBlackBoard(FawkesNetworkClient *client)
 
 	inbound_thread_ = NULL;
 	m_              = NULL;
+
+	delta_encoding_    = true;
+	delta_compression_ = false;
 }
 
 /** Constructor.
@@ -106,6 +113,9 @@ RemoteBlackBoard::RemoteBlackBoard(const char *hostname, unsigned short int port
 
 	inbound_thread_ = NULL;
 	m_              = NULL;
+
+	delta_encoding_    = true;
+	delta_compression_ = false;
 }
 
 /** Destructor. */
@@ -128,6 +138,22 @@ RemoteBlackBoard::~RemoteBlackBoard()
 	delete wait_mutex_;
 }
 
+/** Configure delta encoding of interface data updates.
+ * The setting applies to interfaces opened afterwards. Delta encoding is
+ * only used if the remote BlackBoard supports it, otherwise full data
+ * updates are transmitted. It is enabled without compression by default.
+ * @param enabled true to request delta encoding, false to always send and
+ * receive full data updates
+ * @param compress true to additionally request compression of updates,
+ * which reduces the bandwidth further at the cost of CPU time on both sides
+ */
+void
+RemoteBlackBoard::set_delta_encoding(bool enabled, bool compress)
+{
+	delta_encoding_    = enabled;
+	delta_compression_ = compress;
+}
+
 bool
 RemoteBlackBoard::is_alive() const throw()
 {
@@ -220,6 +246,10 @@ RemoteBlackBoard::open_interface(const char *type,
 		BlackBoardInterfaceProxy *proxy =
 		  new BlackBoardInterfaceProxy(fnc_, m_, notifier_, iface, writer);
 		proxies_[proxy->serial()] = proxy;
+		if (delta_encoding_) {
+			proxy->enable_delta(BB_DELTA_CAP_ENCODING
+			                    | (delta_compression_ ? BB_DELTA_CAP_COMPRESSION : 0));
+		}
 	} else if (m_->msgid() == MSG_BB_OPEN_FAILURE) {
 		bb_iopenfail_msg_t *fm    = m_->msg<bb_iopenfail_msg_t>();
 		unsigned int        error = ntohl(fm->error_code);
@@ -463,6 +493,11 @@ RemoteBlackBoard::inbound_received(FawkesNetworkMessage *m, unsigned int id) thr
 				if (proxies_.find(serial) != proxies_.end()) {
 					proxies_[serial]->process_data_changed(m);
 				}
+			} else if (msgid == MSG_BB_DATA_DELTA) {
+				unsigned int serial = ntohl(((unsigned int *)m->payload())[0]);
+				if (proxies_.find(serial) != proxies_.end()) {
+					proxies_[serial]->process_data_delta(m);
+				}
 			} else if (msgid == MSG_BB_INTERFACE_MESSAGE) {
 				unsigned int serial = ntohl(((unsigned int *)m->payload())[0]);
 				if (proxies_.find(serial) != proxies_.end()) {
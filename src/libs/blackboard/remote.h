@@ -74,6 +74,7 @@ public:
 	virtual void connection_established(unsigned int id) throw();
 
 	/* extensions for RemoteBlackBoard */
+	void set_delta_encoding(bool enabled, bool compress = false);
 
 private: /* methods */
 	void open_interface(const char *type,
@@ -100,6 +101,9 @@ private: /* members */
 	WaitCondition *wait_cond_;
 
 	const char *inbound_thread_;
+
+	bool delta_encoding_;
+	bool delta_compression_;
 };
 
 } // end namespace fawkes
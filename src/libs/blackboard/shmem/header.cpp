@@ -25,6 +25,7 @@
 #include <utils/ipc/shm.h>
 
 #include <cstddef>
+#include <cstring>
 
 namespace fawkes {
 
@@ -32,9 +33,9 @@ namespace fawkes {
  * BlackBoard Shared Memory Header.
  * This class is used identify BlackBoard shared memory headers and
  * to interact with the management data in the shared memory segment.
- * The basic options stored in the header is a version identifier
- * and pointers to the list heads of the free and allocated chunk
- * lists.
+ * The basic options stored in the header is a version identifier,
+ * pointers to the list heads of the free and allocated chunk
+ * lists, and the chunk index which maps keys to allocated chunks.
  *
  * @author Tim Niemueller
  * @see SharedMemoryHeader
@@ -149,6 +150,10 @@ BlackBoardSharedMemoryHeader::initialize(void *memptr)
 	data->shm_addr        = memptr;
 	data->free_list_head  = NULL;
 	data->alloc_list_head = NULL;
+	data->index_entries   = 0;
+	memset(data->index, 0, sizeof(data->index));
+	data->allocator = 0;
+	memset(&data->sc_heap, 0, sizeof(data->sc_heap));
 }
 
 /** Set data of this header
@@ -217,6 +222,64 @@ BlackBoardSharedMemoryHeader::set_alloc_list_head(chunk_list_t *alh)
 	data->alloc_list_head = (chunk_list_t *)shmem->addr(alh);
 }
 
+/** Get the chunk index.
+ * @return pointer to the first slot of the chunk index in the shared
+ * memory segment. Note that the chunk pointers stored in the index are
+ * shared memory addresses which must be transformed before use.
+ */
+chunk_index_t *
+BlackBoardSharedMemoryHeader::chunk_index()
+{
+	return data->index;
+}
+
+/** Get number of used chunk index slots.
+ * @return number of used chunk index slots
+ */
+unsigned int
+BlackBoardSharedMemoryHeader::index_entries() const
+{
+	return data->index_entries;
+}
+
+/** Set number of used chunk index slots.
+ * @param entries new number of used chunk index slots
+ */
+void
+BlackBoardSharedMemoryHeader::set_index_entries(unsigned int entries)
+{
+	data->index_entries = entries;
+}
+
+/** Get allocation strategy.
+ * @return allocation strategy, a BlackBoardMemoryManager::Allocator value
+ */
+unsigned int
+BlackBoardSharedMemoryHeader::allocator() const
+{
+	return data->allocator;
+}
+
+/** Set allocation strategy.
+ * @param allocator allocation strategy, a BlackBoardMemoryManager::Allocator value
+ */
+void
+BlackBoardSharedMemoryHeader::set_allocator(unsigned int allocator)
+{
+	data->allocator = allocator;
+}
+
+/** Get the size class allocator free lists.
+ * @return pointer to the size class free lists in the shared memory segment.
+ * Note that the list heads are shared memory addresses which must be
+ * transformed before use.
+ */
+size_class_heap_t *
+BlackBoardSharedMemoryHeader::size_class_heap()
+{
+	return &data->sc_heap;
+}
+
 /** Get BlackBoard version.
  * @return BlackBoard version
  */
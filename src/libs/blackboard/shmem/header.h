@@ -38,10 +38,14 @@ private:
    */
 	typedef struct
 	{
-		unsigned int  version;         /**< version of the BB */
-		void *        shm_addr;        /**< base addr of shared memory */
-		chunk_list_t *free_list_head;  /**< offset of the free chunks list head */
-		chunk_list_t *alloc_list_head; /**< offset of the allocated chunks list head */
+		unsigned int  version;                /**< version of the BB */
+		void *        shm_addr;               /**< base addr of shared memory */
+		chunk_list_t *free_list_head;         /**< offset of the free chunks list head */
+		chunk_list_t *alloc_list_head;        /**< offset of the allocated chunks list head */
+		unsigned int  index_entries;          /**< number of used chunk index slots */
+		chunk_index_t index[BBMM_INDEX_SIZE]; /**< chunk index hash table */
+		unsigned int      allocator; /**< allocation strategy of the memory manager */
+		size_class_heap_t sc_heap;   /**< free lists of the size class allocator */
 	} BlackBoardSharedMemoryHeaderData;
 
 public:
@@ -62,6 +66,12 @@ public:
 	chunk_list_t *              alloc_list_head();
 	void                        set_free_list_head(chunk_list_t *flh);
 	void                        set_alloc_list_head(chunk_list_t *alh);
+	chunk_index_t *             chunk_index();
+	unsigned int                index_entries() const;
+	void                        set_index_entries(unsigned int entries);
+	unsigned int                allocator() const;
+	void                        set_allocator(unsigned int allocator);
+	size_class_heap_t *         size_class_heap();
 
 	unsigned int version() const;
 
@@ -47,6 +47,12 @@ namespace firevision {
  * locking times so that the interference between the two processes is
  * minimal.
  *
+ * If the writer uses the shared memory image buffer in ring mode, the
+ * deep copy is made without locking, and the writer is never blocked
+ * by a reader. Without deep copy, the image captured last is only
+ * valid until the writer has written as many images as there are slots
+ * in the ring.
+ *
  * @author Tim Niemueller
  */
 
@@ -112,11 +118,12 @@ void
 SharedMemoryCamera::init()
 {
 	deep_buffer_  = NULL;
+	shm_image_    = NULL;
 	capture_time_ = NULL;
 	try {
 		shm_buffer_ = new SharedMemoryImageBuffer(image_id_);
 		if (deep_copy_) {
-			deep_buffer_ = (unsigned char *)malloc(shm_buffer_->data_size());
+			deep_buffer_ = (unsigned char *)malloc(shm_buffer_->slot_data_size());
 			if (!deep_buffer_) {
 				throw OutOfMemoryException("SharedMemoryCamera: Cannot allocate deep buffer");
 			}
@@ -153,12 +160,19 @@ void
 SharedMemoryCamera::capture()
 {
 	if (deep_copy_) {
-		shm_buffer_->lock_for_read();
-		memcpy(deep_buffer_, shm_buffer_->buffer(), shm_buffer_->data_size());
-		capture_time_->set_time(shm_buffer_->capture_time());
-		shm_buffer_->unlock();
-	} else
+		if (shm_buffer_->num_slots() > 1) {
+			shm_buffer_->read_latest(deep_buffer_, capture_time_);
+		} else {
+			// writers may fill a single image without end_write()
+			shm_buffer_->lock_for_read();
+			memcpy(deep_buffer_, shm_buffer_->buffer(), shm_buffer_->slot_data_size());
+			capture_time_->set_time(shm_buffer_->capture_time());
+			shm_buffer_->unlock();
+		}
+	} else {
+		shm_image_ = shm_buffer_->buffer();
 		capture_time_->set_time(shm_buffer_->capture_time());
+	}
 }
 
 unsigned char *
@@ -167,7 +181,7 @@ SharedMemoryCamera::buffer()
 	if (deep_copy_) {
 		return deep_buffer_;
 	} else {
-		return shm_buffer_->buffer();
+		return shm_image_ ? shm_image_ : shm_buffer_->buffer();
 	}
 }
 
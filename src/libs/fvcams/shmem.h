@@ -78,6 +78,7 @@ private:
 	SharedMemoryImageBuffer *shm_buffer_;
 
 	unsigned char *deep_buffer_;
+	unsigned char *shm_image_;
 
 	fawkes::Time *capture_time_;
 };
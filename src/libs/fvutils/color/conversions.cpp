@@ -26,6 +26,7 @@
 #include <fvutils/color/bayer.h>
 #include <fvutils/color/rgb.h>
 #include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/simd.h>
 #include <fvutils/color/yuv.h>
 #include <fvutils/color/yuvrgb.h>
 
@@ -35,7 +36,9 @@ namespace firevision {
 
 /** Convert image from one colorspace to another.
  * This is a convenience method for unified access to all conversion routines
- * available in FireVision.
+ * available in FireVision. If a SIMD kernel for the conversion is available
+ * for the current SIMD level (see simd_level()), it is used instead of the
+ * plain C implementation. Both produce identical results.
  * @param from colorspace of the src buffer
  * @param to colorspace to convert to
  * @param src source buffer
@@ -53,10 +56,14 @@ convert(colorspace_t         from,
         unsigned int         width,
         unsigned int         height)
 {
+	conversion_func_t simd_func = simd_conversion(from, to);
+
 	if (from == to) {
 		if (src != dst) {
 			memcpy(dst, src, colorspace_buffer_size(from, width, height));
 		}
+	} else if (simd_func) {
+		simd_func(src, dst, width, height);
 	} else if ((from == YUV422_PACKED) && (to == YUV422_PLANAR)) {
 		yuv422packed_to_yuv422planar(src, dst, width, height);
 	} else if ((from == YUY2) && (to == YUV422_PLANAR_QUARTER)) {
@@ -120,10 +127,14 @@ convert(colorspace_t         from,
 		yuv422planar_to_bgr_with_alpha_plainc(src, dst, width, height);
 	} else if ((from == YUV422_PACKED) && (to == BGR_WITH_ALPHA)) {
 		yuv422packed_to_bgr_with_alpha_plainc(src, dst, width, height);
+	} else if ((from == YUV422_PACKED) && ((to == GRAY8) || (to == MONO8))) {
+		grayscale_yuv422packed(src, dst, width, height);
 	} else if ((from == BAYER_MOSAIC_GBRG) && (to == YUV422_PLANAR)) {
 		bayerGBRG_to_yuv422planar_bilinear(src, dst, width, height);
 	} else if ((from == BAYER_MOSAIC_GRBG) && (to == YUV422_PLANAR)) {
 		bayerGRBG_to_yuv422planar_nearest_neighbour(src, dst, width, height);
+	} else if ((from == BAYER_MOSAIC_RGGB) && (to == YUV422_PLANAR)) {
+		bayerRGGB_to_yuv422planar_nearest_neighbour(src, dst, width, height);
 	} else if ((from == BAYER_MOSAIC_GRBG) && (to == YUV422_PLANAR)) {
 		bayerGRBG_to_yuv422planar_bilinear(src, dst, width, height);
 	} else if ((from == YUV444_PACKED) && (to == YUV422_PLANAR)) {
@@ -0,0 +1,343 @@
+
+/***************************************************************************
+ *  fused_converter.cpp - Convert an image to multiple colorspaces at once
+ *
+ *  Created: Tue Oct 27 09:41:17 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/conversions.h>
+#include <fvutils/color/fused_converter.h>
+
+#include <algorithm>
+#include <cstring>
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
+
+namespace firevision {
+
+/** Get plane layout of a colorspace for conversion in stripes.
+ * @param cspace colorspace
+ * @param width width of image in pixels
+ * @param row_bytes upon return contains the number of bytes of one image
+ * row in each plane, must have room for three elements
+ * @return number of planes, zero if images of the colorspace cannot be
+ * split into stripes
+ */
+static unsigned int
+stripe_planes(colorspace_t cspace, unsigned int width, size_t *row_bytes)
+{
+	switch (cspace) {
+	case YUV422_PLANAR:
+		if (width % 2 != 0)
+			return 0;
+		row_bytes[0] = width;
+		row_bytes[1] = row_bytes[2] = width / 2;
+		return 3;
+
+	case RGB_PLANAR: row_bytes[0] = row_bytes[1] = row_bytes[2] = width; return 3;
+
+	case RGB:
+	case BGR:
+	case RGB_WITH_ALPHA:
+	case BGR_WITH_ALPHA:
+	case YUV444_PACKED:
+	case YVU444_PACKED:
+	case YUY2:
+	case YVY2:
+	case YUV422_PACKED:
+	case GRAY8:
+	case MONO8:
+	case BAYER_MOSAIC_RGGB:
+	case BAYER_MOSAIC_GRBG: row_bytes[0] = colorspace_buffer_size(cspace, width, 1); return 1;
+
+	default: return 0;
+	}
+}
+
+/** Copy planes of a stripe of an image to a stripe buffer.
+ * @param image image buffer
+ * @param stripe stripe buffer, planes are stored consecutively
+ * @param planes number of planes
+ * @param row_bytes bytes of one row per plane
+ * @param height height of the image
+ * @param row first row of the stripe
+ * @param rows number of rows of the stripe
+ */
+static void
+gather_stripe(const unsigned char *image,
+              unsigned char *      stripe,
+              unsigned int         planes,
+              const size_t *       row_bytes,
+              unsigned int         height,
+              unsigned int         row,
+              unsigned int         rows)
+{
+	for (unsigned int p = 0; p < planes; ++p) {
+		memcpy(stripe, image + row * row_bytes[p], rows * row_bytes[p]);
+		image += height * row_bytes[p];
+		stripe += rows * row_bytes[p];
+	}
+}
+
+/** Copy planes of a stripe buffer to a stripe of an image.
+ * @param stripe stripe buffer, planes are stored consecutively
+ * @param image image buffer
+ * @param planes number of planes
+ * @param row_bytes bytes of one row per plane
+ * @param height height of the image
+ * @param row first row of the stripe
+ * @param rows number of rows of the stripe
+ */
+static void
+scatter_stripe(const unsigned char *stripe,
+               unsigned char *      image,
+               unsigned int         planes,
+               const size_t *       row_bytes,
+               unsigned int         height,
+               unsigned int         row,
+               unsigned int         rows)
+{
+	for (unsigned int p = 0; p < planes; ++p) {
+		memcpy(image + row * row_bytes[p], stripe, rows * row_bytes[p]);
+		image += height * row_bytes[p];
+		stripe += rows * row_bytes[p];
+	}
+}
+
+/** @class FusedConverter <fvutils/color/fused_converter.h>
+ * Convert an image to multiple colorspaces in one pass.
+ * Calling convert() once per target colorspace reads the whole source
+ * image for each target. For images larger than the CPU cache this means
+ * that the source image is read from main memory over and over again.
+ * This class instead splits the image into horizontal stripes of a few
+ * rows and converts each stripe to all targets before moving on to the
+ * next stripe, so that the source is read from main memory only once.
+ *
+ * Planar colorspaces are gathered into, or scattered from, a small stripe
+ * buffer which stays in the cache. Conversions which need rows beyond the
+ * current stripe (e.g. bilinear demosaicing) or involve colorspaces which
+ * cannot be split into stripes are done for the whole image at once.
+ *
+ * If built with OpenMP support, stripes can be converted in parallel, see
+ * set_parallel().
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param from colorspace of source images
+ * @param width width of images in pixels
+ * @param height height of images in pixels
+ * @param stripe_height number of rows converted in one go, rounded up to
+ * an even number as some conversions work on pairs of rows
+ */
+FusedConverter::FusedConverter(colorspace_t from,
+                               unsigned int width,
+                               unsigned int height,
+                               unsigned int stripe_height)
+: from_(from), width_(width), height_(height), parallel_(false)
+{
+	stripe_height_ = std::max(2u, stripe_height + (stripe_height % 2));
+	src_planes_    = stripe_planes(from_, width_, src_row_bytes_);
+}
+
+/** Destructor. */
+FusedConverter::~FusedConverter()
+{
+}
+
+/** Get source colorspace.
+ * @return colorspace of source images
+ */
+colorspace_t
+FusedConverter::from() const
+{
+	return from_;
+}
+
+/** Get image width.
+ * @return width of images in pixels
+ */
+unsigned int
+FusedConverter::width() const
+{
+	return width_;
+}
+
+/** Get image height.
+ * @return height of images in pixels
+ */
+unsigned int
+FusedConverter::height() const
+{
+	return height_;
+}
+
+/** Get stripe height.
+ * @return number of rows converted in one go
+ */
+unsigned int
+FusedConverter::stripe_height() const
+{
+	return stripe_height_;
+}
+
+/** Enable or disable parallel conversion of stripes.
+ * Without OpenMP support this setting has no effect.
+ * @param parallel true to convert stripes in parallel
+ */
+void
+FusedConverter::set_parallel(bool parallel)
+{
+	parallel_ = parallel;
+}
+
+/** Check if stripes are converted in parallel.
+ * @return true if parallel conversion has been enabled
+ */
+bool
+FusedConverter::parallel() const
+{
+	return parallel_;
+}
+
+/** Check if conversion to a colorspace can be done in stripes.
+ * @param to colorspace to convert to
+ * @return true if images are converted to the given colorspace stripe by
+ * stripe, false if they are converted at once
+ */
+bool
+FusedConverter::supports_stripes(colorspace_t to) const
+{
+	size_t row_bytes[3];
+	return (src_planes_ > 0) && (stripe_planes(to, width_, row_bytes) > 0);
+}
+
+/** Convert image to multiple colorspaces.
+ * @param src source image buffer
+ * @param num_targets number of target colorspaces
+ * @param to array of num_targets colorspaces to convert to
+ * @param dst array of num_targets destination buffers, one for each
+ * element of to, must not overlap with src
+ * @exception Exception thrown if a conversion is not supported, cf.
+ * firevision::convert()
+ */
+void
+FusedConverter::convert(const unsigned char *src,
+                        unsigned int         num_targets,
+                        const colorspace_t * to,
+                        unsigned char *const *dst)
+{
+	stripe_targets_.clear();
+	size_t dst_scratch_size = 0;
+	for (unsigned int i = 0; i < num_targets; ++i) {
+		size_t row_bytes[3];
+		if (!supports_stripes(to[i])) {
+			firevision::convert(from_, to[i], src, dst[i], width_, height_);
+		} else {
+			stripe_targets_.push_back(i);
+			if (stripe_planes(to[i], width_, row_bytes) > 1) {
+				dst_scratch_size =
+				  std::max(dst_scratch_size, colorspace_buffer_size(to[i], width_, stripe_height_));
+			}
+		}
+	}
+	if (stripe_targets_.empty())
+		return;
+	if ((stripe_targets_.size() == 1) && !parallel_) {
+		// nothing to share between targets, avoid the per stripe overhead
+		const unsigned int t = stripe_targets_[0];
+		firevision::convert(from_, to[t], src, dst[t], width_, height_);
+		return;
+	}
+
+	// one set of stripe buffers per thread, allocated once
+#ifdef _OPENMP
+	const unsigned int num_threads = parallel_ ? omp_get_max_threads() : 1;
+#else
+	const unsigned int num_threads = 1;
+#endif
+	if (scratch_.size() < num_threads)
+		scratch_.resize(num_threads);
+	const size_t src_scratch_size =
+	  (src_planes_ > 1) ? colorspace_buffer_size(from_, width_, stripe_height_) : 0;
+	for (unsigned int t = 0; t < num_threads; ++t) {
+		if (scratch_[t].src.size() < src_scratch_size)
+			scratch_[t].src.resize(src_scratch_size);
+		if (scratch_[t].dst.size() < dst_scratch_size)
+			scratch_[t].dst.resize(dst_scratch_size);
+	}
+
+	// The first stripe is always converted in the calling thread so that
+	// unsupported conversions throw before entering the parallel section
+	convert_stripe(0, src, to, dst, scratch_[0]);
+
+	const int num_stripes = (height_ + stripe_height_ - 1) / stripe_height_;
+	int       s;
+#ifdef _OPENMP
+#	pragma omp parallel for if (parallel_) num_threads(num_threads) private(s) schedule(static)
+#endif
+	for (s = 1; s < num_stripes; ++s) {
+#ifdef _OPENMP
+		scratch_t &scratch = scratch_[omp_get_thread_num()];
+#else
+		scratch_t &scratch = scratch_[0];
+#endif
+		convert_stripe(s * stripe_height_, src, to, dst, scratch);
+	}
+}
+
+/** Convert one stripe to all targets which support stripes.
+ * @param row first row of the stripe
+ * @param src source image buffer
+ * @param to colorspaces to convert to
+ * @param dst destination buffers
+ * @param scratch stripe buffers of the calling thread
+ */
+void
+FusedConverter::convert_stripe(unsigned int         row,
+                               const unsigned char *src,
+                               const colorspace_t * to,
+                               unsigned char *const *dst,
+                               scratch_t &          scratch)
+{
+	const unsigned int rows = std::min(stripe_height_, height_ - row);
+
+	const unsigned char *stripe_src;
+	if (src_planes_ == 1) {
+		stripe_src = src + row * src_row_bytes_[0];
+	} else {
+		gather_stripe(src, &scratch.src[0], src_planes_, src_row_bytes_, height_, row, rows);
+		stripe_src = &scratch.src[0];
+	}
+
+	for (size_t i = 0; i < stripe_targets_.size(); ++i) {
+		const unsigned int t = stripe_targets_[i];
+		size_t             row_bytes[3];
+		unsigned int       planes = stripe_planes(to[t], width_, row_bytes);
+		if (planes == 1) {
+			firevision::convert(from_, to[t], stripe_src, dst[t] + row * row_bytes[0], width_, rows);
+		} else {
+			firevision::convert(from_, to[t], stripe_src, &scratch.dst[0], width_, rows);
+			scatter_stripe(&scratch.dst[0], dst[t], planes, row_bytes, height_, row, rows);
+		}
+	}
+}
+
+} // end namespace firevision
@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  fused_converter.h - Convert an image to multiple colorspaces at once
+ *
+ *  Created: Tue Oct 27 09:41:17 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef FIREVISION_UTILS_COLOR_FUSED_CONVERTER_H_
+#define FIREVISION_UTILS_COLOR_FUSED_CONVERTER_H_
+
+#include <fvutils/color/colorspaces.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace firevision {
+
+class FusedConverter
+{
+public:
+	FusedConverter(colorspace_t from,
+	               unsigned int width,
+	               unsigned int height,
+	               unsigned int stripe_height = 16);
+	~FusedConverter();
+
+	colorspace_t from() const;
+	unsigned int width() const;
+	unsigned int height() const;
+	unsigned int stripe_height() const;
+
+	void set_parallel(bool parallel);
+	bool parallel() const;
+
+	bool supports_stripes(colorspace_t to) const;
+
+	void convert(const unsigned char *src,
+	             unsigned int         num_targets,
+	             const colorspace_t * to,
+	             unsigned char *const *dst);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::vector<unsigned char> src;
+		std::vector<unsigned char> dst;
+	} scratch_t;
+	/// @endcond
+
+	void convert_stripe(unsigned int         row,
+	                    const unsigned char *src,
+	                    const colorspace_t * to,
+	                    unsigned char *const *dst,
+	                    scratch_t &          scratch);
+
+	colorspace_t from_;
+	unsigned int width_;
+	unsigned int height_;
+	unsigned int stripe_height_;
+	bool         parallel_;
+
+	unsigned int src_planes_;
+	size_t       src_row_bytes_[3];
+
+	std::vector<unsigned int> stripe_targets_;
+	std::vector<scratch_t>    scratch_;
+};
+
+} // end namespace firevision
+
+#endif
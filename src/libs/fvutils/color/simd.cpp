@@ -0,0 +1,167 @@
+
+/***************************************************************************
+ *  simd.cpp - SIMD colorspace conversion dispatch
+ *
+ *  Created: Sun Oct 25 14:20:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <fvutils/color/simd.h>
+
+#include <cstring>
+
+namespace firevision {
+
+// defined in simd_sse2.cpp and simd_avx2.cpp, respectively
+const simd_conversion_t *simd_conversions_sse2();
+const simd_conversion_t *simd_conversions_avx2();
+
+/// @cond INTERNALS
+class SimdDispatchTable
+{
+public:
+	SimdDispatchTable()
+	{
+		memset(funcs, 0, sizeof(funcs));
+		supported = detect();
+		level     = supported;
+
+		add(SIMD_SSE2, simd_conversions_sse2());
+		add(SIMD_AVX2, simd_conversions_sse2());
+		add(SIMD_AVX2, simd_conversions_avx2());
+	}
+
+	static simd_level_t
+	detect()
+	{
+#if defined __x86_64__ || defined __i386__
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return SIMD_AVX2;
+		if (__builtin_cpu_supports("sse2"))
+			return SIMD_SSE2;
+#elif defined __ARM_NEON || defined __ARM_NEON__
+		return SIMD_NEON;
+#endif
+		return SIMD_NONE;
+	}
+
+	void
+	add(simd_level_t l, const simd_conversion_t *conversions)
+	{
+		for (const simd_conversion_t *c = conversions; c->func; ++c) {
+			funcs[l][c->from][c->to] = c->func;
+		}
+	}
+
+	conversion_func_t funcs[SIMD_N][COLORSPACE_N][COLORSPACE_N];
+	simd_level_t      supported;
+	simd_level_t      level;
+};
+/// @endcond
+
+static SimdDispatchTable &
+dispatch_table()
+{
+	static SimdDispatchTable table;
+	return table;
+}
+
+/** Get best SIMD level supported by the CPU.
+ * @return best supported SIMD level
+ */
+simd_level_t
+simd_level_supported()
+{
+	return dispatch_table().supported;
+}
+
+/** Get SIMD level used for conversions.
+ * This is the best supported level unless changed with set_simd_level().
+ * @return SIMD level used by convert()
+ */
+simd_level_t
+simd_level()
+{
+	return __atomic_load_n(&dispatch_table().level, __ATOMIC_RELAXED);
+}
+
+/** Set SIMD level used for conversions.
+ * This is meant to compare kernels, e.g. to benchmark them or to check
+ * them against the plain C implementation. The setting applies to all
+ * threads of the process.
+ * @param level SIMD level to use
+ * @exception Exception thrown if the CPU does not support the level
+ */
+void
+set_simd_level(simd_level_t level)
+{
+	SimdDispatchTable &table = dispatch_table();
+	if ((level != SIMD_NONE) && (level != table.supported)
+	    && !((level == SIMD_SSE2) && (table.supported == SIMD_AVX2))) {
+		throw fawkes::Exception("SIMD level %s is not supported, best is %s",
+		                        simd_level_to_string(level),
+		                        simd_level_to_string(table.supported));
+	}
+	__atomic_store_n(&table.level, level, __ATOMIC_RELAXED);
+}
+
+/** Get string for SIMD level.
+ * @param level SIMD level
+ * @return human-readable name of the level
+ */
+const char *
+simd_level_to_string(simd_level_t level)
+{
+	switch (level) {
+	case SIMD_NONE: return "plain C";
+	case SIMD_SSE2: return "SSE2";
+	case SIMD_AVX2: return "AVX2";
+	case SIMD_NEON: return "NEON";
+	default: return "unknown";
+	}
+}
+
+/** Get SIMD conversion kernel.
+ * @param from colorspace of the source buffer
+ * @param to colorspace to convert to
+ * @return kernel for the current SIMD level, NULL if there is none
+ */
+conversion_func_t
+simd_conversion(colorspace_t from, colorspace_t to)
+{
+	return simd_conversion(from, to, simd_level());
+}
+
+/** Get SIMD conversion kernel of a specific level.
+ * @param from colorspace of the source buffer
+ * @param to colorspace to convert to
+ * @param level SIMD level, the CPU must support it
+ * @return kernel for the given SIMD level, NULL if there is none
+ */
+conversion_func_t
+simd_conversion(colorspace_t from, colorspace_t to, simd_level_t level)
+{
+	if ((from >= COLORSPACE_N) || (to >= COLORSPACE_N) || (level >= SIMD_N)) {
+		return NULL;
+	}
+	return dispatch_table().funcs[level][from][to];
+}
+
+} // end namespace firevision
@@ -0,0 +1,72 @@
+
+/***************************************************************************
+ *  simd.h - SIMD colorspace conversion dispatch
+ *
+ *  Created: Sun Oct 25 14:20:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef FIREVISION_UTILS_COLOR_SIMD_H_
+#define FIREVISION_UTILS_COLOR_SIMD_H_
+
+#include <fvutils/color/colorspaces.h>
+
+namespace firevision {
+
+/** SIMD instruction set levels.
+ * Levels are ordered, a level includes the kernels of all lower levels
+ * of the same architecture.
+ */
+typedef enum {
+	SIMD_NONE = 0, /**< plain C implementation only */
+	SIMD_SSE2 = 1, /**< x86 SSE2 */
+	SIMD_AVX2 = 2, /**< x86 AVX2 (implies SSSE3) */
+	SIMD_NEON = 3, /**< ARM NEON */
+	SIMD_N    = 4  /**< number of SIMD levels */
+} simd_level_t;
+
+/** Colorspace conversion function.
+ * @param src source buffer
+ * @param dst destination buffer, must not overlap with src
+ * @param width width of image in pixels
+ * @param height height of image in pixels
+ */
+typedef void (*conversion_func_t)(const unsigned char *src,
+                                  unsigned char *      dst,
+                                  unsigned int         width,
+                                  unsigned int         height);
+
+/** SIMD conversion kernel description. */
+typedef struct
+{
+	colorspace_t      from; /**< colorspace of the source buffer */
+	colorspace_t      to;   /**< colorspace of the destination buffer */
+	conversion_func_t func; /**< conversion kernel */
+} simd_conversion_t;
+
+simd_level_t simd_level_supported();
+simd_level_t simd_level();
+void         set_simd_level(simd_level_t level);
+const char * simd_level_to_string(simd_level_t level);
+
+conversion_func_t simd_conversion(colorspace_t from, colorspace_t to);
+conversion_func_t simd_conversion(colorspace_t from, colorspace_t to, simd_level_t level);
+
+} // end namespace firevision
+
+#endif
@@ -0,0 +1,650 @@
+
+/***************************************************************************
+ *  simd_avx2.cpp - AVX2 colorspace conversion kernels
+ *
+ *  Created: Sun Oct 25 16:38:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/simd.h>
+
+// This file is compiled with -mavx2 on x86, see Makefile. Do not use
+// inline functions from other headers here, the linker might otherwise
+// pick the AVX2 instance of such a function for all callers.
+#ifdef __AVX2__
+#	include <fvutils/color/bayer.h>
+#	include <fvutils/color/rgb.h>
+#	include <fvutils/color/rgbyuv.h>
+#	include <fvutils/color/yuv.h>
+#	include <fvutils/color/yuvrgb.h>
+
+#	include <immintrin.h>
+#endif
+
+/* The kernels are the 256 bit equivalents of those in simd_sse2.cpp,
+ * see the notes there. Packing and unpacking instructions of AVX2 work
+ * within 128 bit lanes, hence the permutations after interleaving or
+ * deinterleaving. Pixels with three bytes are shuffled per 128 bit
+ * lane with SSSE3 instructions. */
+
+namespace firevision {
+
+#ifdef __AVX2__
+
+/// @cond INTERNALS
+
+enum { OUT_RGB, OUT_BGR, OUT_RGBA, OUT_BGRA };
+
+enum { C_EVEN, C_ODD, O_EVEN, O_ODD };
+
+/* Multiplier for _mm256_madd_epi16 of pairs (a, b), i.e. a * c0 + b * c1 */
+static inline __m256i
+coeffs(short c0, short c1)
+{
+	return _mm256_set1_epi32((int)(((unsigned int)(unsigned short)c1 << 16) | (unsigned short)c0));
+}
+
+/* floor((a * c0 + b * c1) / 2^S) for 16 16-bit lanes */
+template <int S>
+static inline __m256i
+dot2(__m256i a, __m256i b, __m256i c01)
+{
+	__m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), c01);
+	__m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), c01);
+	return _mm256_packs_epi32(_mm256_srai_epi32(lo, S), _mm256_srai_epi32(hi, S));
+}
+
+/* floor((a * c0 + b * c1 + c * c2) / 2^S) for 16 16-bit lanes */
+template <int S>
+static inline __m256i
+dot3(__m256i a, __m256i b, __m256i c, __m256i c01, __m256i c2)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i       lo   = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), c01),
+                                    _mm256_madd_epi16(_mm256_unpacklo_epi16(c, zero), c2));
+	__m256i       hi   = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), c01),
+                                    _mm256_madd_epi16(_mm256_unpackhi_epi16(c, zero), c2));
+	return _mm256_packs_epi32(_mm256_srai_epi32(lo, S), _mm256_srai_epi32(hi, S));
+}
+
+static inline void
+yuv_to_rgb_epi16(__m256i yt, __m256i ut, __m256i vt, __m256i &r, __m256i &g, __m256i &b)
+{
+	r = _mm256_add_epi16(_mm256_add_epi16(yt, _mm256_add_epi16(vt, vt)),
+	                     dot2<16>(yt, vt, coeffs(10748, -26477)));
+	g = _mm256_add_epi16(_mm256_sub_epi16(yt, vt),
+	                     dot3<16>(yt, ut, vt, coeffs(10748, -25625), coeffs(12255, 0)));
+	b = _mm256_add_epi16(_mm256_add_epi16(yt, _mm256_add_epi16(ut, ut)),
+	                     dot2<16>(yt, ut, coeffs(10748, 1180)));
+}
+
+/* YUV to RGB for 32 pixels, u and v with 16 values each */
+static inline void
+yuv_to_rgb(__m256i y, __m128i u, __m128i v, __m256i &r, __m256i &g, __m256i &b)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c16  = _mm256_set1_epi16(16);
+	const __m256i c128 = _mm256_set1_epi16(128);
+
+	// duplicate U and V for the pixels of each pair, in the order of y
+	__m256i ud = _mm256_set_m128i(_mm_unpackhi_epi8(u, u), _mm_unpacklo_epi8(u, u));
+	__m256i vd = _mm256_set_m128i(_mm_unpackhi_epi8(v, v), _mm_unpacklo_epi8(v, v));
+
+	__m256i rl, gl, bl, rh, gh, bh;
+	yuv_to_rgb_epi16(_mm256_sub_epi16(_mm256_unpacklo_epi8(y, zero), c16),
+	                 _mm256_sub_epi16(_mm256_unpacklo_epi8(ud, zero), c128),
+	                 _mm256_sub_epi16(_mm256_unpacklo_epi8(vd, zero), c128),
+	                 rl,
+	                 gl,
+	                 bl);
+	yuv_to_rgb_epi16(_mm256_sub_epi16(_mm256_unpackhi_epi8(y, zero), c16),
+	                 _mm256_sub_epi16(_mm256_unpackhi_epi8(ud, zero), c128),
+	                 _mm256_sub_epi16(_mm256_unpackhi_epi8(vd, zero), c128),
+	                 rh,
+	                 gh,
+	                 bh);
+	r = _mm256_packus_epi16(rl, rh);
+	g = _mm256_packus_epi16(gl, gh);
+	b = _mm256_packus_epi16(bl, bh);
+}
+
+static inline void
+rgb_to_yuv_epi16(__m256i r, __m256i g, __m256i b, __m256i &y, __m256i &u, __m256i &v)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c128 = _mm256_set1_epi16(128);
+	const __m256i c255 = _mm256_set1_epi16(255);
+
+	y = dot3<10>(r, g, b, coeffs(306, 601), coeffs(117, 0));
+	u = _mm256_add_epi16(dot3<10>(r, g, b, coeffs(-172, -340), coeffs(512, 0)), c128);
+	v = _mm256_add_epi16(dot3<10>(r, g, b, coeffs(512, -429), coeffs(-83, 0)), c128);
+	u = _mm256_max_epi16(_mm256_min_epi16(u, c255), zero);
+	v = _mm256_max_epi16(_mm256_min_epi16(v, c255), zero);
+}
+
+/* RGB to YUV422 for 32 pixel pairs, cf. simd_sse2.cpp */
+static inline void
+rgb_pairs_to_yuv(__m256i  r1,
+                 __m256i  g1,
+                 __m256i  b1,
+                 __m256i  r2,
+                 __m256i  g2,
+                 __m256i  b2,
+                 __m256i &y1,
+                 __m256i &y2,
+                 __m256i &u,
+                 __m256i &v)
+{
+	const __m256i zero = _mm256_setzero_si256();
+
+	__m256i y1l, u1l, v1l, y2l, u2l, v2l, y1h, u1h, v1h, y2h, u2h, v2h;
+	rgb_to_yuv_epi16(_mm256_unpacklo_epi8(r1, zero),
+	                 _mm256_unpacklo_epi8(g1, zero),
+	                 _mm256_unpacklo_epi8(b1, zero),
+	                 y1l,
+	                 u1l,
+	                 v1l);
+	rgb_to_yuv_epi16(_mm256_unpacklo_epi8(r2, zero),
+	                 _mm256_unpacklo_epi8(g2, zero),
+	                 _mm256_unpacklo_epi8(b2, zero),
+	                 y2l,
+	                 u2l,
+	                 v2l);
+	rgb_to_yuv_epi16(_mm256_unpackhi_epi8(r1, zero),
+	                 _mm256_unpackhi_epi8(g1, zero),
+	                 _mm256_unpackhi_epi8(b1, zero),
+	                 y1h,
+	                 u1h,
+	                 v1h);
+	rgb_to_yuv_epi16(_mm256_unpackhi_epi8(r2, zero),
+	                 _mm256_unpackhi_epi8(g2, zero),
+	                 _mm256_unpackhi_epi8(b2, zero),
+	                 y2h,
+	                 u2h,
+	                 v2h);
+
+	y1 = _mm256_packus_epi16(y1l, y1h);
+	y2 = _mm256_packus_epi16(y2l, y2h);
+	u  = _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(u1l, u2l), 1),
+                          _mm256_srli_epi16(_mm256_add_epi16(u1h, u2h), 1));
+	v  = _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(v1l, v2l), 1),
+                          _mm256_srli_epi16(_mm256_add_epi16(v1h, v2h), 1));
+}
+
+/* Store 64 Y values of pixel pairs given as 32 values each */
+static inline void
+store_y_pairs(unsigned char *dst, __m256i y1, __m256i y2)
+{
+	__m256i lo = _mm256_unpacklo_epi8(y1, y2);
+	__m256i hi = _mm256_unpackhi_epi8(y1, y2);
+	_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+	_mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+/* Even and odd bytes of 64 bytes */
+static inline void
+split_even_odd(const unsigned char *src, __m256i &even, __m256i &odd)
+{
+	const __m256i mask = _mm256_set1_epi16(0x00FF);
+	__m256i       a    = _mm256_loadu_si256((const __m256i *)src);
+	__m256i       b    = _mm256_loadu_si256((const __m256i *)(src + 32));
+	even = _mm256_permute4x64_epi64(
+	  _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask)), 0xD8);
+	odd = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)),
+	                               0xD8);
+}
+
+/* Even and odd bytes of 32 bytes, 16 each */
+static inline void
+split_even_odd(__m256i x, __m128i &even, __m128i &odd)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i mask = _mm256_set1_epi16(0x00FF);
+	even               = _mm256_castsi256_si128(
+    _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(x, mask), zero), 0xD8));
+	odd = _mm256_castsi256_si128(
+	  _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(x, 8), zero), 0xD8));
+}
+
+/* Interleave 16 pixels of three channels */
+static inline void
+store_3ch(unsigned char *dst, __m128i c0, __m128i c1, __m128i c2)
+{
+	const __m128i m00 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+	const __m128i m01 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+	const __m128i m02 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+	const __m128i m10 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+	const __m128i m11 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+	const __m128i m12 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+	const __m128i m20 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+	const __m128i m21 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+	const __m128i m22 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+
+	_mm_storeu_si128((__m128i *)dst,
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m00), _mm_shuffle_epi8(c1, m01)),
+	                              _mm_shuffle_epi8(c2, m02)));
+	_mm_storeu_si128((__m128i *)(dst + 16),
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m10), _mm_shuffle_epi8(c1, m11)),
+	                              _mm_shuffle_epi8(c2, m12)));
+	_mm_storeu_si128((__m128i *)(dst + 32),
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m20), _mm_shuffle_epi8(c1, m21)),
+	                              _mm_shuffle_epi8(c2, m22)));
+}
+
+/* Deinterleave 16 pixels of three channels */
+static inline void
+load_3ch(const unsigned char *src, __m128i &c0, __m128i &c1, __m128i &c2)
+{
+	const __m128i m00 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m01 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+	const __m128i m02 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+	const __m128i m10 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m11 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+	const __m128i m12 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+	const __m128i m20 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m21 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+	const __m128i m22 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+
+	__m128i a0 = _mm_loadu_si128((const __m128i *)src);
+	__m128i a1 = _mm_loadu_si128((const __m128i *)(src + 16));
+	__m128i a2 = _mm_loadu_si128((const __m128i *)(src + 32));
+	c0         = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m00), _mm_shuffle_epi8(a1, m01)),
+                    _mm_shuffle_epi8(a2, m02));
+	c1         = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m10), _mm_shuffle_epi8(a1, m11)),
+                    _mm_shuffle_epi8(a2, m12));
+	c2         = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, m20), _mm_shuffle_epi8(a1, m21)),
+                    _mm_shuffle_epi8(a2, m22));
+}
+
+/* Store 16 pixels with four bytes each */
+static inline void
+store_4ch(unsigned char *dst, __m128i c0, __m128i c1, __m128i c2, __m128i c3)
+{
+	__m128i c01l = _mm_unpacklo_epi8(c0, c1);
+	__m128i c01h = _mm_unpackhi_epi8(c0, c1);
+	__m128i c23l = _mm_unpacklo_epi8(c2, c3);
+	__m128i c23h = _mm_unpackhi_epi8(c2, c3);
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(c01l, c23l));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(c01l, c23l));
+	_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(c01h, c23h));
+	_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(c01h, c23h));
+}
+
+template <int Format>
+static inline void
+store_pixels(unsigned char *dst, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i alpha = _mm_set1_epi8((char)0xFF);
+	switch (Format) {
+	case OUT_RGB: store_3ch(dst, r, g, b); break;
+	case OUT_BGR: store_3ch(dst, b, g, r); break;
+	case OUT_RGBA: store_4ch(dst, r, g, b, alpha); break;
+	case OUT_BGRA: store_4ch(dst, b, g, r, alpha); break;
+	}
+}
+
+/* Store 32 pixels */
+template <int Format>
+static inline void
+store_pixels(unsigned char *dst, __m256i r, __m256i g, __m256i b)
+{
+	const size_t bpp = (Format == OUT_RGB || Format == OUT_BGR) ? 3 : 4;
+	store_pixels<Format>(dst,
+	                     _mm256_castsi256_si128(r),
+	                     _mm256_castsi256_si128(g),
+	                     _mm256_castsi256_si128(b));
+	store_pixels<Format>(dst + 16 * bpp,
+	                     _mm256_extracti128_si256(r, 1),
+	                     _mm256_extracti128_si256(g, 1),
+	                     _mm256_extracti128_si256(b, 1));
+}
+
+template <int Format, conversion_func_t Plain>
+static void
+yuv422planar_to_rgb_avx2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const size_t         bpp = (Format == OUT_RGB || Format == OUT_BGR) ? 3 : 4;
+	const unsigned char *yp  = src;
+	const unsigned char *up  = src + n;
+	const unsigned char *vp  = up + n / 2;
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t p = (i + 32 <= n) ? i : n - 32;
+		__m256i      r, g, b;
+		yuv_to_rgb(_mm256_loadu_si256((const __m256i *)(yp + p)),
+		           _mm_loadu_si128((const __m128i *)(up + p / 2)),
+		           _mm_loadu_si128((const __m128i *)(vp + p / 2)),
+		           r,
+		           g,
+		           b);
+		store_pixels<Format>(dst + p * bpp, r, g, b);
+	}
+}
+
+template <int Format, conversion_func_t Plain>
+static void
+yuv422packed_to_rgb_avx2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const size_t bpp = (Format == OUT_RGB || Format == OUT_BGR) ? 3 : 4;
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t p = (i + 32 <= n) ? i : n - 32;
+		__m256i      uv, y, r, g, b;
+		__m128i      u, v;
+		split_even_odd(src + 2 * p, uv, y);
+		split_even_odd(uv, u, v);
+		yuv_to_rgb(y, u, v, r, g, b);
+		store_pixels<Format>(dst + p * bpp, r, g, b);
+	}
+}
+
+template <bool YOdd, bool UFirst, conversion_func_t Plain>
+static void
+yuv422packed_to_planar_avx2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	unsigned char *yp = dst;
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t p = (i + 32 <= n) ? i : n - 32;
+		__m256i      even, odd;
+		__m128i      first, last;
+		split_even_odd(src + 2 * p, even, odd);
+		split_even_odd(YOdd ? even : odd, first, last);
+		_mm256_storeu_si256((__m256i *)(yp + p), YOdd ? odd : even);
+		_mm_storeu_si128((__m128i *)(up + p / 2), UFirst ? first : last);
+		_mm_storeu_si128((__m128i *)(vp + p / 2), UFirst ? last : first);
+	}
+}
+
+/* Even and odd pixels of one channel of 32 pixels given as two halves */
+static inline void
+split_pixels(__m128i a, __m128i b, __m128i &even, __m128i &odd)
+{
+	const __m128i mask = _mm_set1_epi16(0x00FF);
+	even               = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+	odd                = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+template <bool BGR, conversion_func_t Plain>
+static void
+rgb_to_yuv422planar_avx2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 64) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	unsigned char *yp = dst;
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+	for (size_t i = 0; i < n; i += 64) {
+		const size_t p = (i + 64 <= n) ? i : n - 64;
+
+		// channels of pixels 1 and 2 of pairs for pixels 0-31 and 32-63
+		__m128i c[3][4], c1[3][2], c2[3][2];
+		for (unsigned int k = 0; k < 4; ++k) {
+			load_3ch(src + 3 * (p + 16 * k), c[0][k], c[1][k], c[2][k]);
+		}
+		for (unsigned int ch = 0; ch < 3; ++ch) {
+			split_pixels(c[ch][0], c[ch][1], c1[ch][0], c2[ch][0]);
+			split_pixels(c[ch][2], c[ch][3], c1[ch][1], c2[ch][1]);
+		}
+
+		const unsigned int ri = BGR ? 2 : 0, bi = BGR ? 0 : 2;
+		__m256i            y1, y2, u, v;
+		rgb_pairs_to_yuv(_mm256_set_m128i(c1[ri][1], c1[ri][0]),
+		                 _mm256_set_m128i(c1[1][1], c1[1][0]),
+		                 _mm256_set_m128i(c1[bi][1], c1[bi][0]),
+		                 _mm256_set_m128i(c2[ri][1], c2[ri][0]),
+		                 _mm256_set_m128i(c2[1][1], c2[1][0]),
+		                 _mm256_set_m128i(c2[bi][1], c2[bi][0]),
+		                 y1,
+		                 y2,
+		                 u,
+		                 v);
+		store_y_pairs(yp + p, y1, y2);
+		_mm256_storeu_si256((__m256i *)(up + p / 2), u);
+		_mm256_storeu_si256((__m256i *)(vp + p / 2), v);
+	}
+}
+
+template <int R1, int G1, int B1, int R2, int G2, int B2>
+static inline void
+bayer_nn_row_avx2(const unsigned char *cur,
+                  const unsigned char *other,
+                  unsigned char *      yp,
+                  unsigned char *      up,
+                  unsigned char *      vp,
+                  unsigned int         width)
+{
+	for (unsigned int i = 0; i < width; i += 64) {
+		const unsigned int p = (i + 64 <= width) ? i : width - 64;
+		__m256i            s[4];
+		split_even_odd(cur + p, s[C_EVEN], s[C_ODD]);
+		split_even_odd(other + p, s[O_EVEN], s[O_ODD]);
+
+		__m256i y1, y2, u, v;
+		rgb_pairs_to_yuv(s[R1], s[G1], s[B1], s[R2], s[G2], s[B2], y1, y2, u, v);
+		store_y_pairs(yp + p, y1, y2);
+		_mm256_storeu_si256((__m256i *)(up + p / 2), u);
+		_mm256_storeu_si256((__m256i *)(vp + p / 2), v);
+	}
+}
+
+static void
+bayerGRBG_to_yuv422planar_nearest_neighbour_avx2(const unsigned char *bayer,
+                                                 unsigned char *      yuv,
+                                                 unsigned int         width,
+                                                 unsigned int         height)
+{
+	if (width < 64) {
+		bayerGRBG_to_yuv422planar_nearest_neighbour(bayer, yuv, width, height);
+		return;
+	}
+
+	unsigned char *u = YUV422_PLANAR_U_PLANE(yuv, width, height);
+	unsigned char *v = YUV422_PLANAR_V_PLANE(yuv, width, height);
+	for (unsigned int h = 0; h < height; h += 2) {
+		const unsigned char *even = bayer + (size_t)h * width;
+		const unsigned char *odd  = even + width;
+		const size_t         yo   = (size_t)h * width;
+		// g  r  ... line
+		bayer_nn_row_avx2<C_ODD, O_EVEN, C_EVEN, C_ODD, C_EVEN, O_EVEN>(
+		  even, odd, yuv + yo, u + yo / 2, v + yo / 2, width);
+		// b  g  ... line
+		bayer_nn_row_avx2<O_ODD, C_ODD, C_EVEN, O_ODD, C_ODD, C_EVEN>(
+		  odd, even, yuv + yo + width, u + (yo + width) / 2, v + (yo + width) / 2, width);
+	}
+}
+
+static void
+bayerRGGB_to_yuv422planar_nearest_neighbour_avx2(const unsigned char *bayer,
+                                                 unsigned char *      yuv,
+                                                 unsigned int         width,
+                                                 unsigned int         height)
+{
+	if (width < 64) {
+		bayerRGGB_to_yuv422planar_nearest_neighbour(bayer, yuv, width, height);
+		return;
+	}
+
+	unsigned char *u = YUV422_PLANAR_U_PLANE(yuv, width, height);
+	unsigned char *v = YUV422_PLANAR_V_PLANE(yuv, width, height);
+	for (unsigned int h = 0; h < height; h += 2) {
+		const unsigned char *even = bayer + (size_t)h * width;
+		const unsigned char *odd  = even + width;
+		const size_t         yo   = (size_t)h * width;
+		// r  g  ... line
+		bayer_nn_row_avx2<C_EVEN, C_ODD, O_ODD, C_EVEN, C_ODD, O_ODD>(
+		  even, odd, yuv + yo, u + yo / 2, v + yo / 2, width);
+		// g  b  ... line
+		bayer_nn_row_avx2<O_EVEN, C_EVEN, C_ODD, O_EVEN, C_EVEN, C_ODD>(
+		  odd, even, yuv + yo + width, u + (yo + width) / 2, v + (yo + width) / 2, width);
+	}
+}
+
+template <bool YOdd, conversion_func_t Plain>
+static void
+gray8_to_yuv422packed_avx2(const unsigned char *src,
+                           unsigned char *      dst,
+                           unsigned int         width,
+                           unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const __m256i c128 = _mm256_set1_epi8((char)128);
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t  p  = (i + 32 <= n) ? i : n - 32;
+		const __m256i y  = _mm256_loadu_si256((const __m256i *)(src + p));
+		const __m256i lo = YOdd ? _mm256_unpacklo_epi8(c128, y) : _mm256_unpacklo_epi8(y, c128);
+		const __m256i hi = YOdd ? _mm256_unpackhi_epi8(c128, y) : _mm256_unpackhi_epi8(y, c128);
+		_mm256_storeu_si256((__m256i *)(dst + 2 * p), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 2 * p + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+}
+
+static void
+gray8_to_rgb_avx2(const unsigned char *src,
+                  unsigned char *      dst,
+                  unsigned int         width,
+                  unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		gray8_to_rgb_plainc(src, dst, width, height);
+		return;
+	}
+
+	const __m128i m0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+	const __m128i m1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+	const __m128i m2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t   p = (i + 16 <= n) ? i : n - 16;
+		const __m128i  g = _mm_loadu_si128((const __m128i *)(src + p));
+		unsigned char *d = dst + 3 * p;
+		_mm_storeu_si128((__m128i *)d, _mm_shuffle_epi8(g, m0));
+		_mm_storeu_si128((__m128i *)(d + 16), _mm_shuffle_epi8(g, m1));
+		_mm_storeu_si128((__m128i *)(d + 32), _mm_shuffle_epi8(g, m2));
+	}
+}
+
+static void
+grayscale_yuv422packed_avx2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		grayscale_yuv422packed(src, dst, width, height);
+		return;
+	}
+
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t p = (i + 32 <= n) ? i : n - 32;
+		__m256i      uv, y;
+		split_even_odd(src + 2 * p, uv, y);
+		_mm256_storeu_si256((__m256i *)(dst + p), y);
+	}
+}
+
+/// @endcond
+
+/** Get AVX2 conversion kernels.
+ * @return conversion kernels, terminated by an entry without function
+ */
+const simd_conversion_t *
+simd_conversions_avx2()
+{
+	static const simd_conversion_t conversions[] = {
+	  {YUV422_PLANAR, RGB, yuv422planar_to_rgb_avx2<OUT_RGB, yuv422planar_to_rgb_plainc>},
+	  {YUV422_PLANAR, BGR, yuv422planar_to_rgb_avx2<OUT_BGR, yuv422planar_to_bgr_plainc>},
+	  {YUV422_PLANAR,
+	   RGB_WITH_ALPHA,
+	   yuv422planar_to_rgb_avx2<OUT_RGBA, yuv422planar_to_rgb_with_alpha_plainc>},
+	  {YUV422_PLANAR,
+	   BGR_WITH_ALPHA,
+	   yuv422planar_to_rgb_avx2<OUT_BGRA, yuv422planar_to_bgr_with_alpha_plainc>},
+	  {YUV422_PACKED, RGB, yuv422packed_to_rgb_avx2<OUT_RGB, yuv422packed_to_rgb_plainc>},
+	  {YUV422_PACKED,
+	   BGR_WITH_ALPHA,
+	   yuv422packed_to_rgb_avx2<OUT_BGRA, yuv422packed_to_bgr_with_alpha_plainc>},
+	  {YUV422_PACKED,
+	   YUV422_PLANAR,
+	   yuv422packed_to_planar_avx2<true, true, yuv422packed_to_yuv422planar>},
+	  {YUY2, YUV422_PLANAR, yuv422packed_to_planar_avx2<false, true, yuy2_to_yuv422planar>},
+	  {YVY2, YUV422_PLANAR, yuv422packed_to_planar_avx2<false, false, yvy2_to_yuv422planar>},
+	  {RGB, YUV422_PLANAR, rgb_to_yuv422planar_avx2<false, rgb_to_yuv422planar_plainc>},
+	  {BGR, YUV422_PLANAR, rgb_to_yuv422planar_avx2<true, bgr_to_yuv422planar_plainc>},
+	  {BAYER_MOSAIC_GRBG, YUV422_PLANAR, bayerGRBG_to_yuv422planar_nearest_neighbour_avx2},
+	  {BAYER_MOSAIC_RGGB, YUV422_PLANAR, bayerRGGB_to_yuv422planar_nearest_neighbour_avx2},
+	  {GRAY8, YUY2, gray8_to_yuv422packed_avx2<false, gray8_to_yuy2>},
+	  {MONO8, YUV422_PACKED, gray8_to_yuv422packed_avx2<true, gray8_to_yuv422packed_plainc>},
+	  {MONO8, RGB, gray8_to_rgb_avx2},
+	  {YUV422_PACKED, GRAY8, grayscale_yuv422packed_avx2},
+	  {YUV422_PACKED, MONO8, grayscale_yuv422packed_avx2},
+	  {CS_UNKNOWN, CS_UNKNOWN, NULL}};
+	return conversions;
+}
+
+#else
+
+const simd_conversion_t *
+simd_conversions_avx2()
+{
+	static const simd_conversion_t conversions[] = {{CS_UNKNOWN, CS_UNKNOWN, NULL}};
+	return conversions;
+}
+
+#endif
+
+} // end namespace firevision
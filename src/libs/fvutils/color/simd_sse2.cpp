@@ -0,0 +1,566 @@
+
+/***************************************************************************
+ *  simd_sse2.cpp - SSE2 colorspace conversion kernels
+ *
+ *  Created: Sun Oct 25 15:02:47 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/simd.h>
+
+#ifdef __SSE2__
+#	include <fvutils/color/bayer.h>
+#	include <fvutils/color/rgbyuv.h>
+#	include <fvutils/color/yuv.h>
+#	include <fvutils/color/yuvrgb.h>
+
+#	include <emmintrin.h>
+#endif
+
+/* The kernels produce exactly the same output as the plain C functions
+ * they replace, i.e. they use the same fixed point arithmetic. Images
+ * are processed in blocks of a fixed number of pixels. The last block
+ * of an image (or of a row for Bayer images) is moved back to end at
+ * the last pixel and hence overlaps with the one before, so there is no
+ * need for separate code for the remaining pixels. Images smaller than
+ * a single block are passed to the plain C functions.
+ */
+
+namespace firevision {
+
+#ifdef __SSE2__
+
+/// @cond INTERNALS
+
+enum { OUT_RGB, OUT_BGR, OUT_RGBA, OUT_BGRA };
+
+enum { C_EVEN, C_ODD, O_EVEN, O_ODD };
+
+/* Multiplier for _mm_madd_epi16 of pairs (a, b), i.e. a * c0 + b * c1 */
+static inline __m128i
+coeffs(short c0, short c1)
+{
+	return _mm_set1_epi32((int)(((unsigned int)(unsigned short)c1 << 16) | (unsigned short)c0));
+}
+
+/* floor((a * c0 + b * c1) / 2^S) for eight 16-bit lanes */
+template <int S>
+static inline __m128i
+dot2(__m128i a, __m128i b, __m128i c01)
+{
+	__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c01);
+	__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c01);
+	return _mm_packs_epi32(_mm_srai_epi32(lo, S), _mm_srai_epi32(hi, S));
+}
+
+/* floor((a * c0 + b * c1 + c * c2) / 2^S) for eight 16-bit lanes */
+template <int S>
+static inline __m128i
+dot3(__m128i a, __m128i b, __m128i c, __m128i c01, __m128i c2)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i       lo   = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), c01),
+                                 _mm_madd_epi16(_mm_unpacklo_epi16(c, zero), c2));
+	__m128i       hi   = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), c01),
+                                 _mm_madd_epi16(_mm_unpackhi_epi16(c, zero), c2));
+	return _mm_packs_epi32(_mm_srai_epi32(lo, S), _mm_srai_epi32(hi, S));
+}
+
+/* YUV to RGB for eight 16-bit lanes, y - 16, u - 128, v - 128 given.
+ * The coefficients of the plain C code exceed 16 bit, their multiples
+ * of 2^16 are added separately, e.g. 76284 = 65536 + 10748. */
+static inline void
+yuv_to_rgb_epi16(__m128i yt, __m128i ut, __m128i vt, __m128i &r, __m128i &g, __m128i &b)
+{
+	r = _mm_add_epi16(_mm_add_epi16(yt, _mm_add_epi16(vt, vt)),
+	                  dot2<16>(yt, vt, coeffs(10748, -26477)));
+	g = _mm_add_epi16(_mm_sub_epi16(yt, vt),
+	                  dot3<16>(yt, ut, vt, coeffs(10748, -25625), coeffs(12255, 0)));
+	b = _mm_add_epi16(_mm_add_epi16(yt, _mm_add_epi16(ut, ut)),
+	                  dot2<16>(yt, ut, coeffs(10748, 1180)));
+}
+
+/* YUV to RGB for 16 pixels, u and v in the lower eight bytes */
+static inline void
+yuv_to_rgb(__m128i y, __m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c16  = _mm_set1_epi16(16);
+	const __m128i c128 = _mm_set1_epi16(128);
+
+	u = _mm_sub_epi16(_mm_unpacklo_epi8(u, zero), c128);
+	v = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), c128);
+
+	__m128i rl, gl, bl, rh, gh, bh;
+	yuv_to_rgb_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(y, zero), c16),
+	                 _mm_unpacklo_epi16(u, u),
+	                 _mm_unpacklo_epi16(v, v),
+	                 rl,
+	                 gl,
+	                 bl);
+	yuv_to_rgb_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(y, zero), c16),
+	                 _mm_unpackhi_epi16(u, u),
+	                 _mm_unpackhi_epi16(v, v),
+	                 rh,
+	                 gh,
+	                 bh);
+	r = _mm_packus_epi16(rl, rh);
+	g = _mm_packus_epi16(gl, gh);
+	b = _mm_packus_epi16(bl, bh);
+}
+
+/* RGB to YUV for eight 16-bit lanes, as RGB2YUV, u and v clipped */
+static inline void
+rgb_to_yuv_epi16(__m128i r, __m128i g, __m128i b, __m128i &y, __m128i &u, __m128i &v)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c128 = _mm_set1_epi16(128);
+	const __m128i c255 = _mm_set1_epi16(255);
+
+	y = dot3<10>(r, g, b, coeffs(306, 601), coeffs(117, 0));
+	u = _mm_add_epi16(dot3<10>(r, g, b, coeffs(-172, -340), coeffs(512, 0)), c128);
+	v = _mm_add_epi16(dot3<10>(r, g, b, coeffs(512, -429), coeffs(-83, 0)), c128);
+	u = _mm_max_epi16(_mm_min_epi16(u, c255), zero);
+	v = _mm_max_epi16(_mm_min_epi16(v, c255), zero);
+}
+
+/* RGB to YUV422 for 16 pixel pairs, pixels 1 and 2 of the pairs given
+ * separately. y1 and y2 are the Y values of the pixels, u and v are
+ * averaged over each pair. */
+static inline void
+rgb_pairs_to_yuv(__m128i  r1,
+                 __m128i  g1,
+                 __m128i  b1,
+                 __m128i  r2,
+                 __m128i  g2,
+                 __m128i  b2,
+                 __m128i &y1,
+                 __m128i &y2,
+                 __m128i &u,
+                 __m128i &v)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i y1l, u1l, v1l, y2l, u2l, v2l, y1h, u1h, v1h, y2h, u2h, v2h;
+	rgb_to_yuv_epi16(_mm_unpacklo_epi8(r1, zero),
+	                 _mm_unpacklo_epi8(g1, zero),
+	                 _mm_unpacklo_epi8(b1, zero),
+	                 y1l,
+	                 u1l,
+	                 v1l);
+	rgb_to_yuv_epi16(_mm_unpacklo_epi8(r2, zero),
+	                 _mm_unpacklo_epi8(g2, zero),
+	                 _mm_unpacklo_epi8(b2, zero),
+	                 y2l,
+	                 u2l,
+	                 v2l);
+	rgb_to_yuv_epi16(_mm_unpackhi_epi8(r1, zero),
+	                 _mm_unpackhi_epi8(g1, zero),
+	                 _mm_unpackhi_epi8(b1, zero),
+	                 y1h,
+	                 u1h,
+	                 v1h);
+	rgb_to_yuv_epi16(_mm_unpackhi_epi8(r2, zero),
+	                 _mm_unpackhi_epi8(g2, zero),
+	                 _mm_unpackhi_epi8(b2, zero),
+	                 y2h,
+	                 u2h,
+	                 v2h);
+
+	y1 = _mm_packus_epi16(y1l, y1h);
+	y2 = _mm_packus_epi16(y2l, y2h);
+	u  = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(u1l, u2l), 1),
+                       _mm_srli_epi16(_mm_add_epi16(u1h, u2h), 1));
+	v  = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(v1l, v2l), 1),
+                       _mm_srli_epi16(_mm_add_epi16(v1h, v2h), 1));
+}
+
+/* Even and odd bytes of 32 bytes */
+static inline void
+split_even_odd(const unsigned char *src, __m128i &even, __m128i &odd)
+{
+	const __m128i mask = _mm_set1_epi16(0x00FF);
+	__m128i       a    = _mm_loadu_si128((const __m128i *)src);
+	__m128i       b    = _mm_loadu_si128((const __m128i *)(src + 16));
+	even               = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+	odd                = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+/* Store 16 pixels with three bytes each, SSE2 lacks byte shuffles */
+static inline void
+store_3ch(unsigned char *dst, __m128i c0, __m128i c1, __m128i c2)
+{
+	unsigned char t0[16] __attribute__((aligned(16)));
+	unsigned char t1[16] __attribute__((aligned(16)));
+	unsigned char t2[16] __attribute__((aligned(16)));
+	_mm_store_si128((__m128i *)t0, c0);
+	_mm_store_si128((__m128i *)t1, c1);
+	_mm_store_si128((__m128i *)t2, c2);
+	for (unsigned int i = 0; i < 16; ++i) {
+		*dst++ = t0[i];
+		*dst++ = t1[i];
+		*dst++ = t2[i];
+	}
+}
+
+/* Store 16 pixels with four bytes each */
+static inline void
+store_4ch(unsigned char *dst, __m128i c0, __m128i c1, __m128i c2, __m128i c3)
+{
+	__m128i c01l = _mm_unpacklo_epi8(c0, c1);
+	__m128i c01h = _mm_unpackhi_epi8(c0, c1);
+	__m128i c23l = _mm_unpacklo_epi8(c2, c3);
+	__m128i c23h = _mm_unpackhi_epi8(c2, c3);
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(c01l, c23l));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(c01l, c23l));
+	_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(c01h, c23h));
+	_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(c01h, c23h));
+}
+
+template <int Format>
+static inline void
+store_pixels(unsigned char *dst, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i alpha = _mm_set1_epi8((char)0xFF);
+	switch (Format) {
+	case OUT_RGB: store_3ch(dst, r, g, b); break;
+	case OUT_BGR: store_3ch(dst, b, g, r); break;
+	case OUT_RGBA: store_4ch(dst, r, g, b, alpha); break;
+	case OUT_BGRA: store_4ch(dst, b, g, r, alpha); break;
+	}
+}
+
+template <int Format, conversion_func_t Plain>
+static void
+yuv422planar_to_rgb_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const size_t         bpp = (Format == OUT_RGB || Format == OUT_BGR) ? 3 : 4;
+	const unsigned char *yp  = src;
+	const unsigned char *up  = src + n;
+	const unsigned char *vp  = up + n / 2;
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t p = (i + 16 <= n) ? i : n - 16;
+		__m128i      r, g, b;
+		yuv_to_rgb(_mm_loadu_si128((const __m128i *)(yp + p)),
+		           _mm_loadl_epi64((const __m128i *)(up + p / 2)),
+		           _mm_loadl_epi64((const __m128i *)(vp + p / 2)),
+		           r,
+		           g,
+		           b);
+		store_pixels<Format>(dst + p * bpp, r, g, b);
+	}
+}
+
+template <int Format, conversion_func_t Plain>
+static void
+yuv422packed_to_rgb_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi16(0x00FF);
+	const size_t  bpp  = (Format == OUT_RGB || Format == OUT_BGR) ? 3 : 4;
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t p = (i + 16 <= n) ? i : n - 16;
+		__m128i      uv, y, r, g, b;
+		split_even_odd(src + 2 * p, uv, y);
+		yuv_to_rgb(y,
+		           _mm_packus_epi16(_mm_and_si128(uv, mask), zero),
+		           _mm_packus_epi16(_mm_srli_epi16(uv, 8), zero),
+		           r,
+		           g,
+		           b);
+		store_pixels<Format>(dst + p * bpp, r, g, b);
+	}
+}
+
+/* Packed YUV422 to planar, Y at odd or even bytes, U or V first */
+template <bool YOdd, bool UFirst, conversion_func_t Plain>
+static void
+yuv422packed_to_planar_sse2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const __m128i  zero = _mm_setzero_si128();
+	const __m128i  mask = _mm_set1_epi16(0x00FF);
+	unsigned char *yp   = dst;
+	unsigned char *up   = dst + n;
+	unsigned char *vp   = up + n / 2;
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t p = (i + 16 <= n) ? i : n - 16;
+		__m128i      even, odd;
+		split_even_odd(src + 2 * p, even, odd);
+		const __m128i y     = YOdd ? odd : even;
+		const __m128i c     = YOdd ? even : odd;
+		const __m128i first = _mm_packus_epi16(_mm_and_si128(c, mask), zero);
+		const __m128i last  = _mm_packus_epi16(_mm_srli_epi16(c, 8), zero);
+		_mm_storeu_si128((__m128i *)(yp + p), y);
+		_mm_storel_epi64((__m128i *)(up + p / 2), UFirst ? first : last);
+		_mm_storel_epi64((__m128i *)(vp + p / 2), UFirst ? last : first);
+	}
+}
+
+template <bool BGR, conversion_func_t Plain>
+static void
+rgb_to_yuv422planar_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 32) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	unsigned char *yp = dst;
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+
+	unsigned char c[6][16] __attribute__((aligned(16)));
+	for (size_t i = 0; i < n; i += 32) {
+		const size_t         p = (i + 32 <= n) ? i : n - 32;
+		const unsigned char *s = src + 3 * p;
+		// SSE2 lacks byte shuffles, gather channels of pixels 1 and 2
+		for (unsigned int k = 0; k < 16; ++k, s += 6) {
+			c[0][k] = s[0];
+			c[1][k] = s[1];
+			c[2][k] = s[2];
+			c[3][k] = s[3];
+			c[4][k] = s[4];
+			c[5][k] = s[5];
+		}
+		__m128i c1_0 = _mm_load_si128((const __m128i *)c[0]);
+		__m128i g1   = _mm_load_si128((const __m128i *)c[1]);
+		__m128i c1_2 = _mm_load_si128((const __m128i *)c[2]);
+		__m128i c2_0 = _mm_load_si128((const __m128i *)c[3]);
+		__m128i g2   = _mm_load_si128((const __m128i *)c[4]);
+		__m128i c2_2 = _mm_load_si128((const __m128i *)c[5]);
+
+		__m128i y1, y2, u, v;
+		if (BGR) {
+			rgb_pairs_to_yuv(c1_2, g1, c1_0, c2_2, g2, c2_0, y1, y2, u, v);
+		} else {
+			rgb_pairs_to_yuv(c1_0, g1, c1_2, c2_0, g2, c2_2, y1, y2, u, v);
+		}
+		_mm_storeu_si128((__m128i *)(yp + p), _mm_unpacklo_epi8(y1, y2));
+		_mm_storeu_si128((__m128i *)(yp + p + 16), _mm_unpackhi_epi8(y1, y2));
+		_mm_storeu_si128((__m128i *)(up + p / 2), u);
+		_mm_storeu_si128((__m128i *)(vp + p / 2), v);
+	}
+}
+
+/* Nearest neighbour demosaicing of a Bayer row. The other row is the
+ * next row for even and the previous row for odd rows. Template
+ * parameters select the source of the R, G, and B values for the two
+ * pixels of each pair from the even or odd columns of the current or
+ * other row. */
+template <int R1, int G1, int B1, int R2, int G2, int B2>
+static inline void
+bayer_nn_row_sse2(const unsigned char *cur,
+                  const unsigned char *other,
+                  unsigned char *      yp,
+                  unsigned char *      up,
+                  unsigned char *      vp,
+                  unsigned int         width)
+{
+	for (unsigned int i = 0; i < width; i += 32) {
+		const unsigned int p = (i + 32 <= width) ? i : width - 32;
+		__m128i            s[4];
+		split_even_odd(cur + p, s[C_EVEN], s[C_ODD]);
+		split_even_odd(other + p, s[O_EVEN], s[O_ODD]);
+
+		__m128i y1, y2, u, v;
+		rgb_pairs_to_yuv(s[R1], s[G1], s[B1], s[R2], s[G2], s[B2], y1, y2, u, v);
+		_mm_storeu_si128((__m128i *)(yp + p), _mm_unpacklo_epi8(y1, y2));
+		_mm_storeu_si128((__m128i *)(yp + p + 16), _mm_unpackhi_epi8(y1, y2));
+		_mm_storeu_si128((__m128i *)(up + p / 2), u);
+		_mm_storeu_si128((__m128i *)(vp + p / 2), v);
+	}
+}
+
+static void
+bayerGRBG_to_yuv422planar_nearest_neighbour_sse2(const unsigned char *bayer,
+                                                 unsigned char *      yuv,
+                                                 unsigned int         width,
+                                                 unsigned int         height)
+{
+	if (width < 32) {
+		bayerGRBG_to_yuv422planar_nearest_neighbour(bayer, yuv, width, height);
+		return;
+	}
+
+	unsigned char *u = YUV422_PLANAR_U_PLANE(yuv, width, height);
+	unsigned char *v = YUV422_PLANAR_V_PLANE(yuv, width, height);
+	for (unsigned int h = 0; h < height; h += 2) {
+		const unsigned char *even = bayer + (size_t)h * width;
+		const unsigned char *odd  = even + width;
+		const size_t         yo   = (size_t)h * width;
+		// g  r  ... line
+		bayer_nn_row_sse2<C_ODD, O_EVEN, C_EVEN, C_ODD, C_EVEN, O_EVEN>(
+		  even, odd, yuv + yo, u + yo / 2, v + yo / 2, width);
+		// b  g  ... line
+		bayer_nn_row_sse2<O_ODD, C_ODD, C_EVEN, O_ODD, C_ODD, C_EVEN>(
+		  odd, even, yuv + yo + width, u + (yo + width) / 2, v + (yo + width) / 2, width);
+	}
+}
+
+static void
+bayerRGGB_to_yuv422planar_nearest_neighbour_sse2(const unsigned char *bayer,
+                                                 unsigned char *      yuv,
+                                                 unsigned int         width,
+                                                 unsigned int         height)
+{
+	if (width < 32) {
+		bayerRGGB_to_yuv422planar_nearest_neighbour(bayer, yuv, width, height);
+		return;
+	}
+
+	unsigned char *u = YUV422_PLANAR_U_PLANE(yuv, width, height);
+	unsigned char *v = YUV422_PLANAR_V_PLANE(yuv, width, height);
+	for (unsigned int h = 0; h < height; h += 2) {
+		const unsigned char *even = bayer + (size_t)h * width;
+		const unsigned char *odd  = even + width;
+		const size_t         yo   = (size_t)h * width;
+		// r  g  ... line
+		bayer_nn_row_sse2<C_EVEN, C_ODD, O_ODD, C_EVEN, C_ODD, O_ODD>(
+		  even, odd, yuv + yo, u + yo / 2, v + yo / 2, width);
+		// g  b  ... line
+		bayer_nn_row_sse2<O_EVEN, C_EVEN, C_ODD, O_EVEN, C_EVEN, C_ODD>(
+		  odd, even, yuv + yo + width, u + (yo + width) / 2, v + (yo + width) / 2, width);
+	}
+}
+
+/* Gray to packed YUV422, gray values at odd (U Y V Y) or even bytes (Y U Y V) */
+template <bool YOdd, conversion_func_t Plain>
+static void
+gray8_to_yuv422packed_sse2(const unsigned char *src,
+                           unsigned char *      dst,
+                           unsigned int         width,
+                           unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		Plain(src, dst, width, height);
+		return;
+	}
+
+	const __m128i c128 = _mm_set1_epi8((char)128);
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t  p = (i + 16 <= n) ? i : n - 16;
+		const __m128i y = _mm_loadu_si128((const __m128i *)(src + p));
+		_mm_storeu_si128((__m128i *)(dst + 2 * p),
+		                 YOdd ? _mm_unpacklo_epi8(c128, y) : _mm_unpacklo_epi8(y, c128));
+		_mm_storeu_si128((__m128i *)(dst + 2 * p + 16),
+		                 YOdd ? _mm_unpackhi_epi8(c128, y) : _mm_unpackhi_epi8(y, c128));
+	}
+}
+
+static void
+grayscale_yuv422packed_sse2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height)
+{
+	const size_t n = (size_t)width * height;
+	if (n < 16) {
+		grayscale_yuv422packed(src, dst, width, height);
+		return;
+	}
+
+	for (size_t i = 0; i < n; i += 16) {
+		const size_t p = (i + 16 <= n) ? i : n - 16;
+		__m128i      uv, y;
+		split_even_odd(src + 2 * p, uv, y);
+		_mm_storeu_si128((__m128i *)(dst + p), y);
+	}
+}
+
+/// @endcond
+
+/** Get SSE2 conversion kernels.
+ * @return conversion kernels, terminated by an entry without function
+ */
+const simd_conversion_t *
+simd_conversions_sse2()
+{
+	static const simd_conversion_t conversions[] = {
+	  {YUV422_PLANAR, RGB, yuv422planar_to_rgb_sse2<OUT_RGB, yuv422planar_to_rgb_plainc>},
+	  {YUV422_PLANAR, BGR, yuv422planar_to_rgb_sse2<OUT_BGR, yuv422planar_to_bgr_plainc>},
+	  {YUV422_PLANAR,
+	   RGB_WITH_ALPHA,
+	   yuv422planar_to_rgb_sse2<OUT_RGBA, yuv422planar_to_rgb_with_alpha_plainc>},
+	  {YUV422_PLANAR,
+	   BGR_WITH_ALPHA,
+	   yuv422planar_to_rgb_sse2<OUT_BGRA, yuv422planar_to_bgr_with_alpha_plainc>},
+	  {YUV422_PACKED, RGB, yuv422packed_to_rgb_sse2<OUT_RGB, yuv422packed_to_rgb_plainc>},
+	  {YUV422_PACKED,
+	   BGR_WITH_ALPHA,
+	   yuv422packed_to_rgb_sse2<OUT_BGRA, yuv422packed_to_bgr_with_alpha_plainc>},
+	  {YUV422_PACKED,
+	   YUV422_PLANAR,
+	   yuv422packed_to_planar_sse2<true, true, yuv422packed_to_yuv422planar>},
+	  {YUY2, YUV422_PLANAR, yuv422packed_to_planar_sse2<false, true, yuy2_to_yuv422planar>},
+	  {YVY2, YUV422_PLANAR, yuv422packed_to_planar_sse2<false, false, yvy2_to_yuv422planar>},
+	  {RGB, YUV422_PLANAR, rgb_to_yuv422planar_sse2<false, rgb_to_yuv422planar_plainc>},
+	  {BGR, YUV422_PLANAR, rgb_to_yuv422planar_sse2<true, bgr_to_yuv422planar_plainc>},
+	  {BAYER_MOSAIC_GRBG, YUV422_PLANAR, bayerGRBG_to_yuv422planar_nearest_neighbour_sse2},
+	  {BAYER_MOSAIC_RGGB, YUV422_PLANAR, bayerRGGB_to_yuv422planar_nearest_neighbour_sse2},
+	  {GRAY8, YUY2, gray8_to_yuv422packed_sse2<false, gray8_to_yuy2>},
+	  {MONO8, YUV422_PACKED, gray8_to_yuv422packed_sse2<true, gray8_to_yuv422packed_plainc>},
+	  {YUV422_PACKED, GRAY8, grayscale_yuv422packed_sse2},
+	  {YUV422_PACKED, MONO8, grayscale_yuv422packed_sse2},
+	  {CS_UNKNOWN, CS_UNKNOWN, NULL}};
+	return conversions;
+}
+
+#else
+
+const simd_conversion_t *
+simd_conversions_sse2()
+{
+	static const simd_conversion_t conversions[] = {{CS_UNKNOWN, CS_UNKNOWN, NULL}};
+	return conversions;
+}
+
+#endif
+
+} // end namespace firevision
@@ -0,0 +1,467 @@
+
+/***************************************************************************
+ *  compressed_image_cache.cpp - Process-wide cache of compressed images
+ *
+ *  Created: Wed Oct 28 10:14:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/compression/compressed_image_cache.h>
+#include <fvutils/compression/jpeg_compressor.h>
+#include <fvutils/ipc/shm_image.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/// @cond INTERNALS
+class CompressedImageCacheWorkerThread : public Thread
+{
+public:
+	CompressedImageCacheWorkerThread(CompressedImageCache *cache, unsigned int index)
+	: Thread("CompressedImageCacheWorkerThread", Thread::OPMODE_CONTINUOUS), cache_(cache)
+	{
+		set_name("CompressedImageCacheWorkerThread[%u]", index);
+	}
+
+	virtual ~CompressedImageCacheWorkerThread()
+	{
+		for (auto &i : images_) {
+			delete i.second;
+		}
+		for (auto &c : compressors_) {
+			delete c.second;
+		}
+	}
+
+	virtual void
+	loop()
+	{
+		// the locker releases the mutex if cancelled while waiting
+		MutexLocker lock(cache_->mutex_);
+		while (cache_->jobs_.empty()) {
+			cache_->job_waitcond_->wait();
+		}
+		CompressedImageCache::Key key = cache_->jobs_.front();
+		cache_->jobs_.pop_front();
+		lock.unlock();
+
+		// do not leave waiting clients behind when being cancelled
+		CancelState old_cancel_state;
+		set_cancel_state(CANCEL_DISABLED, &old_cancel_state);
+
+		std::shared_ptr<const CompressedImageCache::Frame> frame;
+		std::string                                        error;
+		try {
+			frame = compress(key);
+		} catch (Exception &e) {
+			error = e.what_no_backtrace();
+		}
+
+		lock.relock();
+		CompressedImageCache::Entry &entry = cache_->entries_[key];
+		entry.pending                      = false;
+		if (frame) {
+			entry.frame = frame;
+			++cache_->num_compressions_;
+		} else {
+			entry.error = error;
+		}
+		cache_->done_waitcond_->wake_all();
+		lock.unlock();
+
+		set_cancel_state(old_cancel_state);
+	}
+
+private:
+	std::shared_ptr<const CompressedImageCache::Frame>
+	compress(const CompressedImageCache::Key &key)
+	{
+		SharedMemoryImageBuffer *shm = image(key.image_id);
+		const unsigned int       width  = shm->width();
+		const unsigned int       height = shm->height();
+
+		raw_.resize(shm->slot_data_size());
+		Time     capture_time(0, 0);
+		uint64_t frame_number = 0;
+		if (!shm->read_latest(&raw_[0], &capture_time, &frame_number)) {
+			throw Exception("No image has been written, yet");
+		}
+
+		unsigned char *yuv = &raw_[0];
+		if (shm->colorspace() != YUV422_PLANAR) {
+			yuv_.resize(colorspace_buffer_size(YUV422_PLANAR, width, height));
+			convert(shm->colorspace(), YUV422_PLANAR, &raw_[0], &yuv_[0], width, height);
+			yuv = &yuv_[0];
+		}
+
+		JpegImageCompressor *jpeg = compressor(key.quality, key.vflip);
+		jpeg->set_image_dimensions(width, height);
+		jpeg->set_image_buffer(YUV422_PLANAR, yuv);
+
+		// The recommended size is exceeded by detailed images, in which case
+		// the compressor silently wraps around. The uncompressed size is safe.
+		size_t size = std::max(jpeg->recommended_compressed_buffer_size(),
+		                       colorspace_buffer_size(RGB, width, height));
+		unsigned char *buffer = (unsigned char *)malloc(size);
+		jpeg->set_destination_buffer(buffer, size);
+		try {
+			jpeg->compress();
+		} catch (Exception &e) {
+			free(buffer);
+			throw;
+		}
+		size = jpeg->compressed_size();
+
+		// the buffer is much larger than the usual result
+		unsigned char *shrunk = (unsigned char *)realloc(buffer, size);
+		if (shrunk)
+			buffer = shrunk;
+
+		return std::make_shared<CompressedImageCache::Frame>(
+		  buffer, size, width, height, frame_number, capture_time.get_sec(), capture_time.get_usec());
+	}
+
+	SharedMemoryImageBuffer *
+	image(const std::string &image_id)
+	{
+		auto i = images_.find(image_id);
+		if (i != images_.end())
+			return i->second;
+		SharedMemoryImageBuffer *shm = new SharedMemoryImageBuffer(image_id.c_str());
+		images_[image_id]            = shm;
+		return shm;
+	}
+
+	JpegImageCompressor *
+	compressor(unsigned int quality, bool vflip)
+	{
+		std::pair<unsigned int, bool> key(quality, vflip);
+		auto                          c = compressors_.find(key);
+		if (c != compressors_.end())
+			return c->second;
+		JpegImageCompressor *jpeg = new JpegImageCompressor(quality);
+		jpeg->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
+		if (jpeg->supports_vflip())
+			jpeg->set_vflip(vflip);
+		compressors_[key] = jpeg;
+		return jpeg;
+	}
+
+private:
+	CompressedImageCache *                                        cache_;
+	std::map<std::string, SharedMemoryImageBuffer *>              images_;
+	std::map<std::pair<unsigned int, bool>, JpegImageCompressor *> compressors_;
+	std::vector<unsigned char>                                    raw_;
+	std::vector<unsigned char>                                    yuv_;
+};
+
+bool
+CompressedImageCache::Key::operator<(const Key &k) const
+{
+	if (image_id != k.image_id)
+		return image_id < k.image_id;
+	if (format != k.format)
+		return format < k.format;
+	if (quality != k.quality)
+		return quality < k.quality;
+	return vflip < k.vflip;
+}
+/// @endcond
+
+/** @class CompressedImageCache::Frame <fvutils/compression/compressed_image_cache.h>
+ * Compressed image.
+ * Frames are immutable and shared among all users of the cache.
+ */
+
+/** Constructor.
+ * @param data compressed image data, ownership is transferred to the frame,
+ * the buffer must have been allocated with malloc()
+ * @param size size in bytes of @p data
+ * @param width width of the image in pixels
+ * @param height height of the image in pixels
+ * @param frame_number frame number of the source image
+ * @param capture_sec seconds part of the capture time of the source image
+ * @param capture_usec microseconds part of the capture time of the source image
+ */
+CompressedImageCache::Frame::Frame(unsigned char *data,
+                                   size_t         size,
+                                   unsigned int   width,
+                                   unsigned int   height,
+                                   uint64_t       frame_number,
+                                   long int       capture_sec,
+                                   long int       capture_usec)
+: data_(data),
+  size_(size),
+  width_(width),
+  height_(height),
+  frame_number_(frame_number),
+  capture_sec_(capture_sec),
+  capture_usec_(capture_usec)
+{
+}
+
+/** Destructor. */
+CompressedImageCache::Frame::~Frame()
+{
+	free(data_);
+}
+
+/** Get compressed data.
+ * @return compressed image data
+ */
+const unsigned char *
+CompressedImageCache::Frame::data() const
+{
+	return data_;
+}
+
+/** Get size of compressed data.
+ * @return size in bytes of the compressed data
+ */
+size_t
+CompressedImageCache::Frame::size() const
+{
+	return size_;
+}
+
+/** Get image width.
+ * @return width of the image in pixels
+ */
+unsigned int
+CompressedImageCache::Frame::width() const
+{
+	return width_;
+}
+
+/** Get image height.
+ * @return height of the image in pixels
+ */
+unsigned int
+CompressedImageCache::Frame::height() const
+{
+	return height_;
+}
+
+/** Get frame number.
+ * @return frame number of the source image, cf.
+ * SharedMemoryImageBuffer::frame_number()
+ */
+uint64_t
+CompressedImageCache::Frame::frame_number() const
+{
+	return frame_number_;
+}
+
+/** Get capture time.
+ * @param sec upon return contains the seconds part of the capture time
+ * @param usec upon return contains the microseconds part of the capture time
+ */
+void
+CompressedImageCache::Frame::capture_time(long int *sec, long int *usec) const
+{
+	*sec  = capture_sec_;
+	*usec = capture_usec_;
+}
+
+/** @class CompressedImageCache <fvutils/compression/compressed_image_cache.h>
+ * Process-wide cache of compressed images.
+ * Clients like FUSE servers or MJPEG streams which send compressed images
+ * of shared memory image buffers would otherwise each compress the same
+ * image. This cache compresses each image only once per combination of
+ * image ID, format, and compression parameters, and shares the resulting
+ * frame among all requesters until the next image has been written to the
+ * buffer.
+ *
+ * Images are compressed by a pool of worker threads. A client requesting
+ * an image which is currently being compressed waits for the result
+ * instead of compressing it again. The number of workers bounds the number
+ * of concurrent compressions, no matter how many clients request images.
+ *
+ * A new image is detected by its frame number and capture time, cf.
+ * SharedMemoryImageBuffer::end_write(). Writers which update neither will
+ * have the first compressed image served forever.
+ *
+ * There is one instance per process, get it with instance(). It is
+ * destroyed when the last user releases its reference.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_workers number of worker threads compressing images
+ */
+CompressedImageCache::CompressedImageCache(unsigned int num_workers)
+: num_compressions_(0), num_hits_(0)
+{
+	mutex_         = new Mutex();
+	done_waitcond_ = new WaitCondition(mutex_);
+	job_waitcond_  = new WaitCondition(mutex_);
+
+	for (unsigned int i = 0; i < std::max(1u, num_workers); ++i) {
+		CompressedImageCacheWorkerThread *worker = new CompressedImageCacheWorkerThread(this, i);
+		worker->start();
+		workers_.push_back(worker);
+	}
+}
+
+/** Destructor. */
+CompressedImageCache::~CompressedImageCache()
+{
+	for (auto w : workers_) {
+		w->cancel();
+		w->join();
+		delete w;
+	}
+	for (auto &i : images_) {
+		delete i.second;
+	}
+	delete job_waitcond_;
+	delete done_waitcond_;
+	delete mutex_;
+}
+
+/** Get cache instance.
+ * @param num_workers number of worker threads, only used if the instance
+ * is created by this call
+ * @return shared instance, keep it as long as the cache is used
+ */
+std::shared_ptr<CompressedImageCache>
+CompressedImageCache::instance(unsigned int num_workers)
+{
+	static Mutex                               instance_mutex;
+	static std::weak_ptr<CompressedImageCache> instance;
+
+	MutexLocker                           lock(&instance_mutex);
+	std::shared_ptr<CompressedImageCache> cache = instance.lock();
+	if (!cache) {
+		cache.reset(new CompressedImageCache(num_workers));
+		instance = cache;
+	}
+	return cache;
+}
+
+/** Get compressed image.
+ * Returns the cached frame if no new image has been written to the shared
+ * memory image buffer since it was compressed. Otherwise the image is
+ * compressed by a worker thread and the call blocks until it is done.
+ * @param image_id ID of the shared memory image buffer
+ * @param format compression format
+ * @param quality compression quality, cf. JpegImageCompressor
+ * @param vflip true to flip the image vertically, only applied if
+ * supported by the compressor
+ * @return compressed image
+ * @exception Exception thrown if the image buffer does not exist or the
+ * image could not be compressed
+ */
+std::shared_ptr<const CompressedImageCache::Frame>
+CompressedImageCache::get(const char *image_id, format_t format, unsigned int quality, bool vflip)
+{
+	Key key;
+	key.image_id = image_id;
+	key.format   = format;
+	key.quality  = quality;
+	key.vflip    = vflip;
+
+	MutexLocker lock(mutex_);
+
+	SharedMemoryImageBuffer *shm          = image(key.image_id);
+	uint64_t                 frame_number = shm->frame_number();
+	long int                 sec, usec;
+	shm->capture_time(&sec, &usec);
+
+	Entry &entry = entries_[key];
+	if (!entry.pending && entry.frame && (entry.frame->frame_number() == frame_number)) {
+		long int frame_sec, frame_usec;
+		entry.frame->capture_time(&frame_sec, &frame_usec);
+		if ((frame_sec == sec) && (frame_usec == usec)) {
+			++num_hits_;
+			return entry.frame;
+		}
+	}
+
+	if (entry.pending) {
+		// someone else requested it, share the result
+		++num_hits_;
+	} else {
+		entry.pending = true;
+		entry.error.clear();
+		jobs_.push_back(key);
+		job_waitcond_->wake_one();
+	}
+	while (entry.pending) {
+		done_waitcond_->wait();
+	}
+
+	if (!entry.error.empty()) {
+		throw Exception("Cannot compress image %s: %s", image_id, entry.error.c_str());
+	}
+	return entry.frame;
+}
+
+/** Get number of worker threads.
+ * @return number of worker threads
+ */
+unsigned int
+CompressedImageCache::num_workers() const
+{
+	return workers_.size();
+}
+
+/** Get number of compressions.
+ * @return number of images compressed since the cache was created
+ */
+unsigned long
+CompressedImageCache::num_compressions() const
+{
+	MutexLocker lock(mutex_);
+	return num_compressions_;
+}
+
+/** Get number of cache hits.
+ * @return number of requests served without compressing an image for them
+ */
+unsigned long
+CompressedImageCache::num_hits() const
+{
+	MutexLocker lock(mutex_);
+	return num_hits_;
+}
+
+SharedMemoryImageBuffer *
+CompressedImageCache::image(const std::string &image_id)
+{
+	auto i = images_.find(image_id);
+	if (i != images_.end())
+		return i->second;
+	SharedMemoryImageBuffer *shm = new SharedMemoryImageBuffer(image_id.c_str());
+	images_[image_id]            = shm;
+	return shm;
+}
+
+} // end namespace firevision
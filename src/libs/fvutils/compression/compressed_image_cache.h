@@ -0,0 +1,139 @@
+
+/***************************************************************************
+ *  compressed_image_cache.h - Process-wide cache of compressed images
+ *
+ *  Created: Wed Oct 28 10:14:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_UTILS_COMPRESSION_COMPRESSED_IMAGE_CACHE_H_
+#define _FIREVISION_UTILS_COMPRESSION_COMPRESSED_IMAGE_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
+
+namespace firevision {
+
+class SharedMemoryImageBuffer;
+class CompressedImageCacheWorkerThread;
+
+class CompressedImageCache
+{
+	friend class CompressedImageCacheWorkerThread;
+
+public:
+	/** Compression format. */
+	typedef enum {
+		FORMAT_JPEG /**< JPEG */
+	} format_t;
+
+	class Frame
+	{
+	public:
+		Frame(unsigned char *data,
+		      size_t         size,
+		      unsigned int   width,
+		      unsigned int   height,
+		      uint64_t       frame_number,
+		      long int       capture_sec,
+		      long int       capture_usec);
+		~Frame();
+
+		const unsigned char *data() const;
+		size_t               size() const;
+		unsigned int         width() const;
+		unsigned int         height() const;
+		uint64_t             frame_number() const;
+		void                 capture_time(long int *sec, long int *usec) const;
+
+	private:
+		unsigned char *data_;
+		size_t         size_;
+		unsigned int   width_;
+		unsigned int   height_;
+		uint64_t       frame_number_;
+		long int       capture_sec_;
+		long int       capture_usec_;
+	};
+
+	static std::shared_ptr<CompressedImageCache> instance(unsigned int num_workers = 2);
+	~CompressedImageCache();
+
+	std::shared_ptr<const Frame>
+	get(const char *image_id, format_t format, unsigned int quality, bool vflip = false);
+
+	unsigned int  num_workers() const;
+	unsigned long num_compressions() const;
+	unsigned long num_hits() const;
+
+private:
+	explicit CompressedImageCache(unsigned int num_workers);
+
+	/// @cond INTERNALS
+	struct Key
+	{
+		std::string  image_id;
+		format_t     format;
+		unsigned int quality;
+		bool         vflip;
+
+		bool operator<(const Key &k) const;
+	};
+
+	class Entry
+	{
+	public:
+		Entry() : pending(false)
+		{
+		}
+
+		std::shared_ptr<const Frame> frame;
+		bool                         pending;
+		std::string                  error;
+	};
+	/// @endcond
+
+	SharedMemoryImageBuffer *image(const std::string &image_id);
+
+	fawkes::Mutex *        mutex_;
+	fawkes::WaitCondition *done_waitcond_;
+	fawkes::WaitCondition *job_waitcond_;
+
+	std::map<Key, Entry>                             entries_;
+	std::list<Key>                                   jobs_;
+	std::map<std::string, SharedMemoryImageBuffer *> images_;
+
+	std::vector<CompressedImageCacheWorkerThread *> workers_;
+
+	unsigned long num_compressions_;
+	unsigned long num_hits_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -28,11 +28,14 @@
 #include <utils/misc/strndup.h>
 #include <utils/system/console_colors.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <sched.h>
 
 using namespace std;
 using namespace fawkes;
@@ -42,6 +45,26 @@ namespace firevision {
 /** @class SharedMemoryImageBuffer <fvutils/ipc/shm_image.h>
  * Shared memory image buffer.
  * Write images to or retrieve images from a shared memory segment.
+ *
+ * By default the segment holds a single image which is guarded by the
+ * semaphore read/write lock of the shared memory segment. Alternatively,
+ * the writer can create the buffer with multiple image slots that are
+ * used as a ring. The writer fills the slot after the latest image
+ * without taking any lock and then publishes it as the latest image.
+ * Each slot has a sequence counter which is odd while the slot is
+ * being written, and the capture time and a frame number of the image
+ * it contains. Readers copy the latest image, or the image closest to a
+ * given time, with read_latest() or read_closest() and retry if the
+ * slot has been overwritten meanwhile. Hence slow readers never stall
+ * the writer. With three or more slots a reader has more than a whole
+ * frame period to complete its copy before a retry becomes necessary.
+ *
+ * The writer should use begin_write() and end_write(), and readers
+ * read_latest() or read_closest(), which work in either mode. In ring
+ * mode, buffer() returns the latest image slot. Readers that use it
+ * with the read lock, as for a single image, remain valid. The lock no
+ * longer protects the image, though, but it will only be overwritten
+ * after num_slots() - 1 more images have been written.
  * @author Tim Niemueller
  */
 
@@ -57,17 +80,26 @@ namespace firevision {
  * @param cspace colorspace
  * @param width image width
  * @param height image height
+ * @param num_slots number of image slots, 1 for a single image guarded
+ * by the read/write lock, more to use the buffer as a ring of at most
+ * FIREVISION_SHM_IMAGE_MAX_SLOTS images
  */
 SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char * image_id,
                                                  colorspace_t cspace,
                                                  unsigned int width,
-                                                 unsigned int height)
+                                                 unsigned int height,
+                                                 unsigned int num_slots)
 : SharedMemory(FIREVISION_SHM_IMAGE_MAGIC_TOKEN,
                /* read-only */ false,
                /* create */ true,
                /* destroy on delete */ true)
 {
-	constructor(image_id, cspace, width, height, false);
+	if ((num_slots == 0) || (num_slots > FIREVISION_SHM_IMAGE_MAX_SLOTS)) {
+		throw Exception("SharedMemoryImageBuffer: invalid number of slots %u (1..%u)",
+		                num_slots,
+		                FIREVISION_SHM_IMAGE_MAX_SLOTS);
+	}
+	constructor(image_id, cspace, width, height, num_slots, false);
 	add_semaphore();
 }
 
@@ -87,7 +119,7 @@ SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char *image_id, bool is_r
                /* create */ false,
                /* destroy */ false)
 {
-	constructor(image_id, CS_UNKNOWN, 0, 0, is_read_only);
+	constructor(image_id, CS_UNKNOWN, 0, 0, 1, is_read_only);
 }
 
 void
@@ -95,6 +127,7 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
                                      colorspace_t cspace,
                                      unsigned int width,
                                      unsigned int height,
+                                     unsigned int num_slots,
                                      bool         is_read_only)
 {
 	_image_id     = strdup(image_id);
@@ -103,8 +136,10 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
 	_colorspace = cspace;
 	_width      = width;
 	_height     = height;
+	_write_slot = 0;
 
-	priv_header = new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height);
+	priv_header =
+	  new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height, num_slots);
 	_header     = priv_header;
 	try {
 		attach();
@@ -222,14 +257,241 @@ SharedMemoryImageBuffer::set_capture_time(long int sec, long int usec)
 }
 
 /** Get image buffer.
+ * In ring mode this is the slot of the latest image at the time of the
+ * call.
  * @return image buffer.
  */
 unsigned char *
 SharedMemoryImageBuffer::buffer() const
 {
+	if (raw_header->num_slots > 1) {
+		return slot_buffer(__atomic_load_n(&raw_header->latest_slot, __ATOMIC_ACQUIRE));
+	}
 	return (unsigned char *)_memptr;
 }
 
+/** Get size of a single image.
+ * In ring mode the shared memory segment holds num_slots() images of
+ * this size.
+ * @return image size in bytes
+ */
+size_t
+SharedMemoryImageBuffer::slot_data_size() const
+{
+	return colorspace_buffer_size(colorspace(), width(), height());
+}
+
+/** Get number of image slots.
+ * @return number of image slots, 1 if the buffer holds a single image
+ */
+unsigned int
+SharedMemoryImageBuffer::num_slots() const
+{
+	return (raw_header->num_slots > 1) ? raw_header->num_slots : 1;
+}
+
+/** Get buffer of an image slot.
+ * @param slot slot index, must be less than num_slots()
+ * @return buffer of the given slot
+ */
+unsigned char *
+SharedMemoryImageBuffer::slot_buffer(unsigned int slot) const
+{
+	return (unsigned char *)_memptr + (size_t)slot * slot_data_size();
+}
+
+/** Get number of the latest image.
+ * The number is incremented for every image written with end_write().
+ * @return frame number of the latest image, 0 if no image has been written
+ */
+uint64_t
+SharedMemoryImageBuffer::frame_number() const
+{
+	return __atomic_load_n(&raw_header->frame_number, __ATOMIC_ACQUIRE);
+}
+
+/** Start writing an image.
+ * For a single image this acquires the write lock and returns the image
+ * buffer. In ring mode this selects the slot after the latest image,
+ * marks it as being written, and returns its buffer without blocking.
+ * Only one writer may use the buffer at a time. Every call must be
+ * followed by a call to end_write().
+ * @return buffer to write the image to
+ */
+unsigned char *
+SharedMemoryImageBuffer::begin_write()
+{
+	if (_is_read_only) {
+		throw Exception("Buffer is read-only. Cannot write image.");
+	}
+
+	if (raw_header->num_slots <= 1) {
+		lock_for_write();
+		return (unsigned char *)_memptr;
+	}
+
+	_write_slot =
+	  (__atomic_load_n(&raw_header->latest_slot, __ATOMIC_RELAXED) + 1) % raw_header->num_slots;
+	SharedMemoryImageBuffer_slot_t &slot = raw_header->slots[_write_slot];
+	uint32_t                        seq  = __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot.sequence, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return slot_buffer(_write_slot);
+}
+
+/** Finish writing an image.
+ * Publishes the image written since begin_write() as the latest image.
+ * @param capture_time capture time of the image, if NULL the capture
+ * time of the buffer is not changed
+ */
+void
+SharedMemoryImageBuffer::end_write(const fawkes::Time *capture_time)
+{
+	uint64_t frame_number = raw_header->frame_number + 1;
+
+	if (capture_time) {
+		const timeval *t              = capture_time->get_timeval();
+		raw_header->capture_time_sec  = t->tv_sec;
+		raw_header->capture_time_usec = t->tv_usec;
+	}
+
+	if (raw_header->num_slots <= 1) {
+		raw_header->slots[0].capture_time_sec  = raw_header->capture_time_sec;
+		raw_header->slots[0].capture_time_usec = raw_header->capture_time_usec;
+		raw_header->slots[0].frame_number      = frame_number;
+		raw_header->frame_number               = frame_number;
+		unlock();
+		return;
+	}
+
+	SharedMemoryImageBuffer_slot_t &slot = raw_header->slots[_write_slot];
+	slot.capture_time_sec                = raw_header->capture_time_sec;
+	slot.capture_time_usec               = raw_header->capture_time_usec;
+	slot.frame_number                    = frame_number;
+	__atomic_store_n(&slot.sequence, slot.sequence + 1, __ATOMIC_RELEASE);
+
+	__atomic_store_n(&raw_header->latest_slot, _write_slot, __ATOMIC_RELEASE);
+	__atomic_store_n(&raw_header->frame_number, frame_number, __ATOMIC_RELEASE);
+}
+
+/** Copy image from a slot, guarded by its sequence counter.
+ * @param slot slot to copy from
+ * @param dest destination buffer, must be at least slot_data_size() bytes
+ * @param capture_time if not NULL set to the image's capture time
+ * @param frame_number if not NULL set to the image's frame number
+ * @return true if a complete image has been copied, false if the slot
+ * has not been written, yet, or if it was written to while copying
+ */
+bool
+SharedMemoryImageBuffer::read_slot(unsigned int   slot,
+                                   unsigned char *dest,
+                                   fawkes::Time * capture_time,
+                                   uint64_t *     frame_number)
+{
+	SharedMemoryImageBuffer_slot_t &s         = raw_header->slots[slot];
+	uint32_t                        seq_begin = __atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE);
+	if (seq_begin & 1)
+		return false;
+
+	uint64_t fnum = s.frame_number;
+	long int sec  = s.capture_time_sec;
+	long int usec = s.capture_time_usec;
+	memcpy(dest, slot_buffer(slot), slot_data_size());
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if ((__atomic_load_n(&s.sequence, __ATOMIC_RELAXED) != seq_begin) || (fnum == 0))
+		return false;
+
+	if (capture_time)
+		capture_time->set_time(sec, usec);
+	if (frame_number)
+		*frame_number = fnum;
+	return true;
+}
+
+/** Copy the latest image.
+ * For a single image the copy is done while holding the read lock. In
+ * ring mode the copy is done without locking and is retried if the
+ * writer reached the slot while copying.
+ * @param dest destination buffer, must be at least slot_data_size() bytes
+ * @param capture_time if not NULL set to the image's capture time
+ * @param frame_number if not NULL set to the image's frame number
+ * @return true if an image has been copied, false if no image has
+ * been written with end_write(), yet
+ */
+bool
+SharedMemoryImageBuffer::read_latest(unsigned char *dest,
+                                     fawkes::Time * capture_time,
+                                     uint64_t *     frame_number)
+{
+	if (raw_header->num_slots <= 1) {
+		if (this->frame_number() == 0)
+			return false;
+		lock_for_read();
+		memcpy(dest, _memptr, slot_data_size());
+		if (capture_time)
+			capture_time->set_time(raw_header->capture_time_sec, raw_header->capture_time_usec);
+		if (frame_number)
+			*frame_number = raw_header->frame_number;
+		unlock();
+		return true;
+	}
+
+	for (unsigned int tries = 0; this->frame_number() > 0; ++tries) {
+		unsigned int slot = __atomic_load_n(&raw_header->latest_slot, __ATOMIC_ACQUIRE);
+		if (read_slot(slot, dest, capture_time, frame_number))
+			return true;
+		// writer active on this slot, back off if it takes longer
+		if (tries > 100)
+			sched_yield();
+	}
+	return false;
+}
+
+/** Copy the image closest to a given time.
+ * In ring mode this selects among the images in all slots the one
+ * whose capture time is closest to the given time, e.g. to fuse the
+ * image with other sensor data. For a single image this is the same
+ * as read_latest().
+ * @param time time to which the capture time should be closest
+ * @param dest destination buffer, must be at least slot_data_size() bytes
+ * @param capture_time if not NULL set to the image's capture time
+ * @param frame_number if not NULL set to the image's frame number
+ * @return true if an image has been copied, false if no image has
+ * been written, yet
+ */
+bool
+SharedMemoryImageBuffer::read_closest(const fawkes::Time &time,
+                                      unsigned char *     dest,
+                                      fawkes::Time *      capture_time,
+                                      uint64_t *          frame_number)
+{
+	if (raw_header->num_slots <= 1) {
+		return read_latest(dest, capture_time, frame_number);
+	}
+
+	for (unsigned int tries = 0; this->frame_number() > 0; ++tries) {
+		int    best_slot = -1;
+		double best_diff = 0.;
+		for (unsigned int i = 0; i < raw_header->num_slots; ++i) {
+			SharedMemoryImageBuffer_slot_t &s   = raw_header->slots[i];
+			uint32_t                        seq = __atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE);
+			if ((seq & 1) || (s.frame_number == 0))
+				continue;
+			Time   slot_time(s.capture_time_sec, s.capture_time_usec);
+			double diff = fabs(slot_time - &time);
+			if ((best_slot < 0) || (diff < best_diff)) {
+				best_slot = i;
+				best_diff = diff;
+			}
+		}
+		if ((best_slot >= 0) && read_slot(best_slot, dest, capture_time, frame_number))
+			return true;
+		if (tries > 100)
+			sched_yield();
+	}
+	return false;
+}
+
 /** Get color space.
  * @return colorspace
  */
@@ -547,14 +809,16 @@ SharedMemoryImageBuffer::wipe(const char *image_id)
 /** Constructor. */
 SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
 {
-	_colorspace    = CS_UNKNOWN;
-	_image_id      = NULL;
-	_frame_id      = NULL;
-	_width         = 0;
-	_height        = 0;
-	_header        = NULL;
-	_orig_image_id = NULL;
-	_orig_frame_id = NULL;
+	_colorspace     = CS_UNKNOWN;
+	_image_id       = NULL;
+	_frame_id       = NULL;
+	_width          = 0;
+	_height         = 0;
+	_num_slots      = 1;
+	_header         = NULL;
+	_orig_image_id  = NULL;
+	_orig_frame_id  = NULL;
+	_orig_num_slots = 1;
 }
 
 /** Constructor.
@@ -562,16 +826,19 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
  * @param colorspace colorspace
  * @param width width
  * @param height height
+ * @param num_slots number of image slots
  */
 SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_id,
                                                              colorspace_t colorspace,
                                                              unsigned int width,
-                                                             unsigned int height)
+                                                             unsigned int height,
+                                                             unsigned int num_slots)
 {
 	_image_id   = strdup(image_id);
 	_colorspace = colorspace;
 	_width      = width;
 	_height     = height;
+	_num_slots  = num_slots;
 	_header     = NULL;
 	_frame_id   = NULL;
 
@@ -580,6 +847,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_
 	_orig_width      = 0;
 	_orig_height     = 0;
 	_orig_colorspace = CS_UNKNOWN;
+	_orig_num_slots  = 1;
 }
 
 /** Copy constructor.
@@ -600,6 +868,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const SharedMemoryI
 	_colorspace = h->_colorspace;
 	_width      = h->_width;
 	_height     = h->_height;
+	_num_slots  = h->_num_slots;
 	_header     = h->_header;
 
 	_orig_image_id   = NULL;
@@ -607,6 +876,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const SharedMemoryI
 	_orig_width      = 0;
 	_orig_height     = 0;
 	_orig_colorspace = CS_UNKNOWN;
+	_orig_num_slots  = 1;
 }
 
 /** Destructor. */
@@ -637,13 +907,7 @@ SharedMemoryImageBufferHeader::clone() const
 size_t
 SharedMemoryImageBufferHeader::data_size()
 {
-	if (_header == NULL) {
-		return colorspace_buffer_size(_colorspace, _width, _height);
-	} else {
-		return colorspace_buffer_size((colorspace_t)_header->colorspace,
-		                              _header->width,
-		                              _header->height);
-	}
+	return colorspace_buffer_size(colorspace(), width(), height()) * num_slots();
 }
 
 bool
@@ -657,7 +921,7 @@ SharedMemoryImageBufferHeader::matches(void *memptr)
 	} else if (strncmp(h->image_id, _image_id, IMAGE_ID_MAX_LENGTH) == 0) {
 		if ((_colorspace == CS_UNKNOWN)
 		    || (((colorspace_t)h->colorspace == _colorspace) && (h->width == _width)
-		        && (h->height == _height)
+		        && (h->height == _height) && (std::max(h->num_slots, 1u) == _num_slots)
 		        && (!_frame_id || (strncmp(h->frame_id, _frame_id, FRAME_ID_MAX_LENGTH) == 0)))) {
 			return true;
 		} else {
@@ -686,7 +950,8 @@ SharedMemoryImageBufferHeader::operator==(const SharedMemoryHeader &s) const
 	} else {
 		return ((strncmp(_image_id, h->_image_id, IMAGE_ID_MAX_LENGTH) == 0)
 		        && (!_frame_id || (strncmp(_frame_id, h->_frame_id, FRAME_ID_MAX_LENGTH) == 0))
-		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height));
+		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height)
+		        && (_num_slots == h->_num_slots));
 	}
 }
 
@@ -736,6 +1001,9 @@ SharedMemoryImageBufferHeader::initialize(void *memptr)
 	header->colorspace = _colorspace;
 	header->width      = _width;
 	header->height     = _height;
+	header->num_slots  = _num_slots;
+	// the first image goes to slot 0
+	header->latest_slot = _num_slots - 1;
 
 	_header = header;
 }
@@ -763,6 +1031,7 @@ SharedMemoryImageBufferHeader::set(void *memptr)
 	_orig_width      = _width;
 	_orig_height     = _height;
 	_orig_colorspace = _colorspace;
+	_orig_num_slots  = _num_slots;
 	_header          = header;
 
 	_image_id   = strndup(header->image_id, IMAGE_ID_MAX_LENGTH);
@@ -770,6 +1039,7 @@ SharedMemoryImageBufferHeader::set(void *memptr)
 	_width      = header->width;
 	_height     = header->height;
 	_colorspace = (colorspace_t)header->colorspace;
+	_num_slots  = std::max(header->num_slots, 1u);
 }
 
 void
@@ -792,6 +1062,7 @@ SharedMemoryImageBufferHeader::reset()
 	_width      = _orig_width;
 	_height     = _orig_height;
 	_colorspace = _orig_colorspace;
+	_num_slots  = _orig_num_slots;
 	_header     = NULL;
 }
 
@@ -831,6 +1102,18 @@ SharedMemoryImageBufferHeader::height() const
 		return _height;
 }
 
+/** Get number of image slots.
+ * @return number of image slots
+ */
+unsigned int
+SharedMemoryImageBufferHeader::num_slots() const
+{
+	if (_header)
+		return std::max(_header->num_slots, 1u);
+	else
+		return _num_slots;
+}
+
 /** Get image number
  * @return image number
  */
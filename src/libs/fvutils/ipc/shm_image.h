@@ -30,13 +30,26 @@
 #include <utils/ipc/shm_lister.h>
 #include <utils/time/time.h>
 
+#include <stdint.h>
 #include <string>
 
 // Magic token to identify FireVision shared memory images
 #define FIREVISION_SHM_IMAGE_MAGIC_TOKEN "FireVision Image"
+// Maximum number of image slots in ring mode
+#define FIREVISION_SHM_IMAGE_MAX_SLOTS 8
 
 namespace firevision {
 
+/** Shared memory meta data of a single image slot in ring mode. */
+typedef struct
+{
+	uint32_t sequence;          /**< sequence counter, odd while the slot is written */
+	uint32_t reserved;          /**< reserved for future use */
+	int64_t  capture_time_sec;  /**< capture time of the image in the slot, seconds */
+	int64_t  capture_time_usec; /**< addendum to capture_time_sec in micro seconds */
+	uint64_t frame_number;      /**< number of the image in the slot, 0 if never written */
+} SharedMemoryImageBuffer_slot_t;
+
 // Not that there is a relation to ITPimage_packet_header_t
 /** Shared memory header struct for FireVision images. */
 typedef struct
@@ -61,6 +74,11 @@ typedef struct
 	unsigned int flag_circle_found : 1; /**< 1 if circle found */
 	unsigned int flag_image_ready : 1;  /**< 1 if image ready */
 	unsigned int flag_reserved : 30;    /**< reserved for future use */
+	unsigned int num_slots;             /**< number of image slots, 1 for a single image */
+	unsigned int latest_slot;           /**< slot of the latest completely written image */
+	uint64_t     frame_number;          /**< number of the latest image */
+
+	SharedMemoryImageBuffer_slot_t slots[FIREVISION_SHM_IMAGE_MAX_SLOTS]; /**< slot meta data */
 } SharedMemoryImageBuffer_header_t;
 
 class SharedMemoryImageBufferHeader : public fawkes::SharedMemoryHeader
@@ -70,7 +88,8 @@ public:
 	SharedMemoryImageBufferHeader(const char * image_id,
 	                              colorspace_t colorspace,
 	                              unsigned int width,
-	                              unsigned int height);
+	                              unsigned int height,
+	                              unsigned int num_slots = 1);
 	SharedMemoryImageBufferHeader(const SharedMemoryImageBufferHeader *h);
 	virtual ~SharedMemoryImageBufferHeader();
 
@@ -90,6 +109,7 @@ public:
 	colorspace_t colorspace() const;
 	unsigned int width() const;
 	unsigned int height() const;
+	unsigned int num_slots() const;
 	const char * image_id() const;
 	const char * frame_id() const;
 
@@ -101,12 +121,14 @@ private:
 	colorspace_t _colorspace;
 	unsigned int _width;
 	unsigned int _height;
+	unsigned int _num_slots;
 
 	char *       _orig_image_id;
 	char *       _orig_frame_id;
 	colorspace_t _orig_colorspace;
 	unsigned int _orig_width;
 	unsigned int _orig_height;
+	unsigned int _orig_num_slots;
 
 	SharedMemoryImageBuffer_header_t *_header;
 };
@@ -186,13 +208,29 @@ public:
 	SharedMemoryImageBuffer(const char * image_id,
 	                        colorspace_t cspace,
 	                        unsigned int width,
-	                        unsigned int height);
+	                        unsigned int height,
+	                        unsigned int num_slots = 1);
 	SharedMemoryImageBuffer(const char *image_id, bool is_read_only = true);
 	~SharedMemoryImageBuffer();
 
 	const char *   image_id() const;
 	const char *   frame_id() const;
 	unsigned char *buffer() const;
+	size_t         slot_data_size() const;
+
+	unsigned int   num_slots() const;
+	unsigned char *slot_buffer(unsigned int slot) const;
+	uint64_t       frame_number() const;
+	unsigned char *begin_write();
+	void           end_write(const fawkes::Time *capture_time = NULL);
+	bool           read_latest(unsigned char *dest,
+	                           fawkes::Time * capture_time = NULL,
+	                           uint64_t *     frame_number = NULL);
+	bool           read_closest(const fawkes::Time &time,
+	                            unsigned char *     dest,
+	                            fawkes::Time *      capture_time = NULL,
+	                            uint64_t *          frame_number = NULL);
+
 	colorspace_t   colorspace() const;
 	unsigned int   width() const;
 	unsigned int   height() const;
@@ -234,7 +272,12 @@ private:
 	                 colorspace_t cspace,
 	                 unsigned int width,
 	                 unsigned int height,
+	                 unsigned int num_slots,
 	                 bool         is_read_only);
+	bool read_slot(unsigned int   slot,
+	               unsigned char *dest,
+	               fawkes::Time * capture_time,
+	               uint64_t *     frame_number);
 
 	SharedMemoryImageBufferHeader *   priv_header;
 	SharedMemoryImageBuffer_header_t *raw_header;
@@ -243,6 +286,7 @@ private:
 	colorspace_t _colorspace;
 	unsigned int _width;
 	unsigned int _height;
+	unsigned int _write_slot;
 };
 
 } // end namespace firevision
@@ -22,7 +22,7 @@
  */
 
 #include <core/exceptions/system.h>
-#include <fvutils/compression/jpeg_compressor.h>
+#include <fvutils/compression/compressed_image_cache.h>
 #include <fvutils/ipc/shm_image.h>
 #include <fvutils/ipc/shm_lut.h>
 #include <fvutils/net/fuse_image_content.h>
@@ -62,9 +62,9 @@ namespace firevision {
 FuseServerClientThread::FuseServerClientThread(FuseServer *fuse_server, StreamSocket *s)
 : Thread("FuseServerClientThread")
 {
-	fuse_server_     = fuse_server;
-	socket_          = s;
-	jpeg_compressor_ = NULL;
+	fuse_server_ = fuse_server;
+	socket_      = s;
+	image_cache_ = CompressedImageCache::instance();
 
 	inbound_queue_  = new FuseNetworkMessageQueue();
 	outbound_queue_ = new FuseNetworkMessageQueue();
@@ -82,7 +82,6 @@ FuseServerClientThread::FuseServerClientThread(FuseServer *fuse_server, StreamSo
 FuseServerClientThread::~FuseServerClientThread()
 {
 	delete socket_;
-	delete jpeg_compressor_;
 
 	for (bit_ = buffers_.begin(); bit_ != buffers_.end(); ++bit_) {
 		delete bit_->second;
@@ -197,33 +196,30 @@ FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 		FuseImageContent *im = new FuseImageContent(b);
 		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
 	} else if (irm->format == FUSE_IF_JPEG) {
-		if (!jpeg_compressor_) {
-			jpeg_compressor_ = new JpegImageCompressor();
-			jpeg_compressor_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
+		// compressed once per image and shared among all clients
+		std::shared_ptr<const CompressedImageCache::Frame> frame;
+		try {
+			frame = image_cache_->get(b->image_id(), CompressedImageCache::FORMAT_JPEG, 80);
+		} catch (Exception &e) {
+			FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_GET_IMAGE_FAILED,
+			                                                m->payload(),
+			                                                m->payload_size(),
+			                                                /* copy payload */ true);
+			outbound_queue_->push(nm);
+			return;
 		}
-		b->lock_for_read();
-		jpeg_compressor_->set_image_dimensions(b->width(), b->height());
-		jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
-		unsigned char *compressed_buffer =
-		  (unsigned char *)malloc(jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->set_destination_buffer(
-		  compressed_buffer, jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->compress();
-		b->unlock();
-		size_t   compressed_buffer_size = jpeg_compressor_->compressed_size();
 		long int sec = 0, usec = 0;
-		b->capture_time(&sec, &usec);
+		frame->capture_time(&sec, &usec);
 		FuseImageContent *im = new FuseImageContent(FUSE_IF_JPEG,
 		                                            b->image_id(),
-		                                            compressed_buffer,
-		                                            compressed_buffer_size,
+		                                            const_cast<unsigned char *>(frame->data()),
+		                                            frame->size(),
 		                                            CS_UNKNOWN,
-		                                            b->width(),
-		                                            b->height(),
+		                                            frame->width(),
+		                                            frame->height(),
 		                                            sec,
 		                                            usec);
 		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
-		free(compressed_buffer);
 	} else {
 		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_GET_IMAGE_FAILED,
 		                                                m->payload(),
@@ -27,6 +27,7 @@
 #include <core/threading/thread.h>
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace fawkes {
@@ -39,7 +40,7 @@ class FuseNetworkMessageQueue;
 class FuseNetworkMessage;
 class SharedMemoryImageBuffer;
 class SharedMemoryLookupTable;
-class JpegImageCompressor;
+class CompressedImageCache;
 
 class FuseServerClientThread : public fawkes::Thread
 {
@@ -69,7 +70,7 @@ private:
 	FuseNetworkMessageQueue *outbound_queue_;
 	FuseNetworkMessageQueue *inbound_queue_;
 
-	JpegImageCompressor *jpeg_compressor_;
+	std::shared_ptr<CompressedImageCache> image_cache_;
 
 	std::map<std::string, SharedMemoryImageBuffer *>           buffers_;
 	std::map<std::string, SharedMemoryImageBuffer *>::iterator bit_;
@@ -0,0 +1,132 @@
+
+/***************************************************************************
+ *  qa_fusedconv.cpp - QA for fused conversion to multiple colorspaces
+ *
+ *  Created: Tue Oct 27 11:02:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/color/fused_converter.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define MAX_TARGETS 4
+
+typedef struct
+{
+	colorspace_t from;
+	unsigned int num_targets;
+	colorspace_t to[MAX_TARGETS];
+} testcase_t;
+
+static const testcase_t testcases[] = {
+  {YUV422_PACKED, 3, {YUV422_PLANAR, RGB, GRAY8}},
+  {YUY2, 2, {YUV422_PLANAR, YUV422_PLANAR_QUARTER}},
+  {YUV422_PLANAR, 3, {RGB, BGR_WITH_ALPHA, YUV422_PACKED}},
+  {BAYER_MOSAIC_GRBG, 1, {YUV422_PLANAR}},
+  {MONO8, 3, {YUV422_PLANAR, YUV422_PACKED, RGB}}};
+
+int
+main(int argc, char **argv)
+{
+	unsigned int runs   = (argc > 1) ? atoi(argv[1]) : 20;
+	unsigned int stripe_height = (argc > 2) ? atoi(argv[2]) : 16;
+	unsigned int errors = 0;
+
+	for (size_t c = 0; c < sizeof(testcases) / sizeof(testcases[0]); ++c) {
+		const testcase_t &tc = testcases[c];
+
+		unsigned char *src = malloc_buffer(tc.from, WIDTH, HEIGHT);
+		for (size_t i = 0; i < colorspace_buffer_size(tc.from, WIDTH, HEIGHT); ++i) {
+			src[i] = rand() & 0xFF;
+		}
+		unsigned char *expected[MAX_TARGETS];
+		unsigned char *dst[MAX_TARGETS];
+		for (unsigned int t = 0; t < tc.num_targets; ++t) {
+			expected[t] = malloc_buffer(tc.to[t], WIDTH, HEIGHT);
+			dst[t]      = malloc_buffer(tc.to[t], WIDTH, HEIGHT);
+			memset(expected[t], 0, colorspace_buffer_size(tc.to[t], WIDTH, HEIGHT));
+			memset(dst[t], 0, colorspace_buffer_size(tc.to[t], WIDTH, HEIGHT));
+		}
+
+		FusedConverter fc(tc.from, WIDTH, HEIGHT, stripe_height);
+
+		printf("%s ->", colorspace_to_string(tc.from));
+		for (unsigned int t = 0; t < tc.num_targets; ++t) {
+			printf(" %s%s", colorspace_to_string(tc.to[t]), fc.supports_stripes(tc.to[t]) ? "" : "*");
+		}
+		printf("\n");
+
+		Time start;
+		for (unsigned int r = 0; r < runs; ++r) {
+			for (unsigned int t = 0; t < tc.num_targets; ++t) {
+				convert(tc.from, tc.to[t], src, expected[t], WIDTH, HEIGHT);
+			}
+		}
+		Time   end;
+		double sequential_ms = (end - &start) * 1000. / runs;
+
+		start.stamp();
+		for (unsigned int r = 0; r < runs; ++r) {
+			fc.convert(src, tc.num_targets, tc.to, dst);
+		}
+		end.stamp();
+		double fused_ms = (end - &start) * 1000. / runs;
+
+		fc.set_parallel(true);
+		start.stamp();
+		for (unsigned int r = 0; r < runs; ++r) {
+			fc.convert(src, tc.num_targets, tc.to, dst);
+		}
+		end.stamp();
+		double parallel_ms = (end - &start) * 1000. / runs;
+
+		printf("  sequential %7.2f ms  fused %7.2f ms  fused parallel %7.2f ms\n",
+		       sequential_ms,
+		       fused_ms,
+		       parallel_ms);
+
+		for (unsigned int t = 0; t < tc.num_targets; ++t) {
+			if (memcmp(dst[t], expected[t], colorspace_buffer_size(tc.to[t], WIDTH, HEIGHT)) != 0) {
+				printf("  %s: fused result differs\n", colorspace_to_string(tc.to[t]));
+				++errors;
+			}
+			free(expected[t]);
+			free(dst[t]);
+		}
+		free(src);
+	}
+
+	printf("(* converted at once)\n");
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
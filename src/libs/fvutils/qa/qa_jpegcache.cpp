@@ -0,0 +1,181 @@
+
+/***************************************************************************
+ *  qa_jpegcache.cpp - QA for the shared compressed image cache
+ *
+ *  Created: Thu Oct 29 14:21:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <core/threading/thread.h>
+#include <fvutils/compression/compressed_image_cache.h>
+#include <fvutils/ipc/shm_image.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_ID "QA jpeg cache image"
+#define WIDTH 640
+#define HEIGHT 480
+
+class QaJpegCacheWriterThread : public Thread
+{
+public:
+	QaJpegCacheWriterThread(SharedMemoryImageBuffer *buf)
+	: Thread("QaJpegCacheWriterThread", Thread::OPMODE_CONTINUOUS), count(0), buf_(buf)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		unsigned char *img = buf_->begin_write();
+		++count;
+		for (size_t i = 0; i < buf_->slot_data_size(); ++i) {
+			img[i] = (i + count) & 0xFF;
+		}
+		Time t(count, 0);
+		buf_->end_write(&t);
+		usleep(20000);
+	}
+
+	unsigned long count;
+
+private:
+	SharedMemoryImageBuffer *buf_;
+};
+
+class QaJpegCacheReaderThread : public Thread
+{
+public:
+	QaJpegCacheReaderThread(CompressedImageCache *cache, unsigned int quality)
+	: Thread("QaJpegCacheReaderThread", Thread::OPMODE_CONTINUOUS),
+	  count(0),
+	  errors(0),
+	  cache_(cache),
+	  quality_(quality),
+	  last_frame_number_(0)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		try {
+			std::shared_ptr<const CompressedImageCache::Frame> frame =
+			  cache_->get(IMAGE_ID, CompressedImageCache::FORMAT_JPEG, quality_);
+			++count;
+			long int sec, usec;
+			frame->capture_time(&sec, &usec);
+			// frames never go back in time, and the JPEG starts with an SOI marker
+			if ((frame->frame_number() < last_frame_number_) || ((uint64_t)sec != frame->frame_number())
+			    || (frame->size() < 2) || (frame->data()[0] != 0xFF) || (frame->data()[1] != 0xD8)
+			    || (frame->width() != WIDTH) || (frame->height() != HEIGHT)) {
+				++errors;
+			}
+			last_frame_number_ = frame->frame_number();
+		} catch (Exception &e) {
+			// no image has been written, yet
+		}
+		usleep(5000);
+	}
+
+	unsigned long count;
+	unsigned long errors;
+
+private:
+	CompressedImageCache *cache_;
+	unsigned int          quality_;
+	uint64_t              last_frame_number_;
+};
+
+int
+main(int argc, char **argv)
+{
+	unsigned int duration_sec = (argc > 1) ? atoi(argv[1]) : 2;
+	unsigned int num_readers  = (argc > 2) ? atoi(argv[2]) : 6;
+	bool         ok           = true;
+
+	SharedMemoryImageBuffer *buf =
+	  new SharedMemoryImageBuffer(IMAGE_ID, YUV422_PLANAR, WIDTH, HEIGHT, 2);
+
+	std::shared_ptr<CompressedImageCache> cache = CompressedImageCache::instance();
+	if (cache != CompressedImageCache::instance()) {
+		printf("Got different cache instances\n");
+		ok = false;
+	}
+
+	// readers use two different qualities, each quality is compressed once
+	QaJpegCacheWriterThread *              writer = new QaJpegCacheWriterThread(buf);
+	std::vector<QaJpegCacheReaderThread *> readers;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers.push_back(new QaJpegCacheReaderThread(cache.get(), (i % 2) ? 60 : 80));
+	}
+
+	writer->start();
+	for (size_t i = 0; i < readers.size(); ++i) {
+		readers[i]->start();
+	}
+	sleep(duration_sec);
+	unsigned long served = 0;
+	unsigned long errors = 0;
+	for (size_t i = 0; i < readers.size(); ++i) {
+		readers[i]->cancel();
+		readers[i]->join();
+		served += readers[i]->count;
+		errors += readers[i]->errors;
+		delete readers[i];
+	}
+	writer->cancel();
+	writer->join();
+
+	printf("Written: %lu  served: %lu  compressed: %lu  hits: %lu  errors: %lu\n",
+	       writer->count,
+	       served,
+	       cache->num_compressions(),
+	       cache->num_hits(),
+	       errors);
+	ok = ok && (errors == 0) && (served > 0);
+	if (cache->num_compressions() > 2 * writer->count) {
+		printf("Compressed more than once per frame and quality\n");
+		ok = false;
+	}
+	// readers may be cancelled while waiting for a frame they requested
+	if (cache->num_compressions() + cache->num_hits() < served) {
+		printf("Served frames neither compressed nor cached\n");
+		ok = false;
+	}
+
+	delete writer;
+	cache.reset();
+	delete buf;
+
+	printf("QA %s\n", ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,184 @@
+
+/***************************************************************************
+ *  qa_shmimg_ring.cpp - QA for shared memory image ring mode
+ *
+ *  Created: Sat Oct 24 10:12:41 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/threading/thread.h>
+#include <fvutils/ipc/shm_image.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_ID "QA ring image"
+#define WIDTH 640
+#define HEIGHT 480
+
+class QaShmImgWriterThread : public Thread
+{
+public:
+	QaShmImgWriterThread(SharedMemoryImageBuffer *buf)
+	: Thread("QaShmImgWriterThread", Thread::OPMODE_CONTINUOUS), count(0), buf_(buf)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		unsigned char *img = buf_->begin_write();
+		// frame n is filled with byte n, its capture time is n seconds
+		++count;
+		memset(img, count & 0xFF, buf_->slot_data_size());
+		Time t(count, 0);
+		buf_->end_write(&t);
+	}
+
+	unsigned long count;
+
+private:
+	SharedMemoryImageBuffer *buf_;
+};
+
+class QaShmImgReaderThread : public Thread
+{
+public:
+	QaShmImgReaderThread(SharedMemoryImageBuffer *buf)
+	: Thread("QaShmImgReaderThread", Thread::OPMODE_CONTINUOUS),
+	  count(0),
+	  errors(0),
+	  buf_(buf),
+	  img_(buf->slot_data_size())
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		Time     t(0, 0);
+		uint64_t frame_number;
+		if (!buf_->read_latest(&img_[0], &t, &frame_number))
+			return;
+		++count;
+		if (!check(t, frame_number))
+			++errors;
+	}
+
+	unsigned long count;
+	unsigned long errors;
+
+private:
+	bool
+	check(const Time &t, uint64_t frame_number)
+	{
+		if ((uint64_t)t.get_sec() != frame_number)
+			return false;
+		const unsigned char expected = frame_number & 0xFF;
+		for (size_t i = 0; i < img_.size(); ++i) {
+			if (img_[i] != expected)
+				return false;
+		}
+		return true;
+	}
+
+	SharedMemoryImageBuffer *  buf_;
+	std::vector<unsigned char> img_;
+};
+
+int
+main(int argc, char **argv)
+{
+	unsigned int duration_sec = (argc > 1) ? atoi(argv[1]) : 2;
+	bool         ok           = true;
+
+	SharedMemoryImageBuffer *wbuf = new SharedMemoryImageBuffer(IMAGE_ID, RGB, WIDTH, HEIGHT, 3);
+	SharedMemoryImageBuffer *rbuf = new SharedMemoryImageBuffer(IMAGE_ID);
+
+	printf("Slots: %u  image size: %zu\n", rbuf->num_slots(), rbuf->slot_data_size());
+	std::vector<unsigned char> img(rbuf->slot_data_size());
+	if (rbuf->read_latest(&img[0])) {
+		printf("Got image before anything was written\n");
+		ok = false;
+	}
+
+	QaShmImgWriterThread *writer = new QaShmImgWriterThread(wbuf);
+	QaShmImgReaderThread *reader = new QaShmImgReaderThread(rbuf);
+	writer->start();
+	reader->start();
+	sleep(duration_sec);
+	reader->cancel();
+	reader->join();
+	writer->cancel();
+	writer->join();
+
+	printf("Written: %lu  read: %lu  errors: %lu\n", writer->count, reader->count, reader->errors);
+	ok = ok && (reader->errors == 0);
+
+	// the ring holds the last three images, with capture times equal to
+	// their frame numbers
+	uint64_t last = rbuf->frame_number();
+	for (uint64_t f = last - 2; f <= last; ++f) {
+		Time     t(0, 0);
+		uint64_t frame_number = 0;
+		if (!rbuf->read_closest(Time(f, 100000), &img[0], &t, &frame_number)
+		    || (frame_number != f) || (img[0] != (f & 0xFF))) {
+			printf("Closest image for %llu is %llu\n",
+			       (unsigned long long)f,
+			       (unsigned long long)frame_number);
+			ok = false;
+		}
+	}
+
+	delete reader;
+	delete writer;
+	delete rbuf;
+	delete wbuf;
+
+	// a single image buffer has no image before the first end_write()
+	wbuf = new SharedMemoryImageBuffer(IMAGE_ID, RGB, WIDTH, HEIGHT);
+	rbuf = new SharedMemoryImageBuffer(IMAGE_ID);
+	if (rbuf->read_latest(&img[0])) {
+		printf("Got single image before anything was written\n");
+		ok = false;
+	}
+	memset(wbuf->begin_write(), 42, wbuf->slot_data_size());
+	Time t(7, 0);
+	wbuf->end_write(&t);
+	uint64_t frame_number = 0;
+	if (!rbuf->read_latest(&img[0], &t, &frame_number) || (frame_number != 1) || (img[0] != 42)) {
+		printf("Single image not read after it was written\n");
+		ok = false;
+	}
+	delete rbuf;
+	delete wbuf;
+
+	printf("QA %s\n", ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
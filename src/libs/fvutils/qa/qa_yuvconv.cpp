@@ -1,9 +1,9 @@
 
 /***************************************************************************
- *  qa_yuvconv.h - QA for YUV conversion
+ *  qa_yuvconv.cpp - QA for colorspace conversion
  *
  *  Created: Wed Jun 27 13:49:25 2007
- *  Copyright  2005-2007  Tim Niemueller [www.niemueller.de]
+ *  Copyright  2005-2026  Tim Niemueller [www.niemueller.de]
  *
  ****************************************************************************/
 
@@ -24,32 +24,155 @@
 /// @cond QA
 
 #include <fvutils/color/colorspaces.h>
-#include <fvutils/color/yuv.h>
-#include <fvutils/ipc/shm_image.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/color/simd.h>
+#include <utils/time/time.h>
 
-#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-using namespace std;
+using namespace fawkes;
 using namespace firevision;
 
 #define WIDTH 748
 #define HEIGHT 572
 
+static const colorspace_t conversions[][2] = {{YUV422_PLANAR, RGB},
+                                              {YUV422_PLANAR, BGR},
+                                              {YUV422_PLANAR, RGB_WITH_ALPHA},
+                                              {YUV422_PLANAR, BGR_WITH_ALPHA},
+                                              {YUV422_PACKED, RGB},
+                                              {YUV422_PACKED, BGR_WITH_ALPHA},
+                                              {YUV422_PACKED, YUV422_PLANAR},
+                                              {YUY2, YUV422_PLANAR},
+                                              {YVY2, YUV422_PLANAR},
+                                              {RGB, YUV422_PLANAR},
+                                              {BGR, YUV422_PLANAR},
+                                              {BAYER_MOSAIC_GRBG, YUV422_PLANAR},
+                                              {BAYER_MOSAIC_RGGB, YUV422_PLANAR},
+                                              {GRAY8, YUY2},
+                                              {MONO8, YUV422_PACKED},
+                                              {MONO8, RGB},
+                                              {YUV422_PACKED, GRAY8},
+                                              {YUV422_PACKED, MONO8}};
+
+// image sizes to check, including some not a multiple of the block sizes
+static const unsigned int sizes[][2] = {{WIDTH, HEIGHT}, {2, 2}, {34, 6}, {66, 4}, {130, 10}};
+
+static void
+fill_random(unsigned char *buf, size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		buf[i] = rand() & 0xFF;
+	}
+}
+
+static double
+benchmark(colorspace_t         from,
+          colorspace_t         to,
+          const unsigned char *src,
+          unsigned char *      dst,
+          unsigned int         runs)
+{
+	Time start;
+	for (unsigned int i = 0; i < runs; ++i) {
+		convert(from, to, src, dst, WIDTH, HEIGHT);
+	}
+	Time   end;
+	double sec = end - &start;
+	return (double)WIDTH * HEIGHT * runs / sec / 1000000.;
+}
+
 int
 main(int argc, char **argv)
 {
-	unsigned char *yuv422_packed = malloc_buffer(YUV422_PACKED, WIDTH, HEIGHT);
+	unsigned int runs   = (argc > 1) ? atoi(argv[1]) : 100;
+	unsigned int errors = 0;
+
+	const simd_level_t supported = simd_level_supported();
+	printf("SIMD support: %s\n", simd_level_to_string(supported));
+
+	// Kernels of lower levels are included in higher levels, hence we can
+	// check all levels up to the supported one. NEON is not ordered with
+	// the x86 levels.
+	simd_level_t levels[SIMD_N];
+	unsigned int num_levels = 0;
+	for (int l = SIMD_NONE; l < SIMD_N; ++l) {
+		if ((l == SIMD_NONE) || (l == supported) || ((supported != SIMD_NEON) && (l < supported))) {
+			levels[num_levels++] = (simd_level_t)l;
+		}
+	}
+
+	printf("%-36s", "Conversion (MPix/s)");
+	for (unsigned int l = 0; l < num_levels; ++l) {
+		printf("%10s", simd_level_to_string(levels[l]));
+	}
+	printf("\n");
+
+	for (size_t c = 0; c < sizeof(conversions) / sizeof(conversions[0]); ++c) {
+		const colorspace_t from = conversions[c][0];
+		const colorspace_t to   = conversions[c][1];
+
+		// check all levels against plain C
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+			const unsigned int w        = sizes[s][0];
+			const unsigned int h        = sizes[s][1];
+			size_t             src_size = colorspace_buffer_size(from, w, h);
+			size_t             dst_size = colorspace_buffer_size(to, w, h);
+			unsigned char *    src      = malloc_buffer(from, w, h);
+			unsigned char *    expected = malloc_buffer(to, w, h);
+			unsigned char *    dst      = malloc_buffer(to, w, h);
+			fill_random(src, src_size);
+
+			set_simd_level(SIMD_NONE);
+			convert(from, to, src, expected, w, h);
+			for (unsigned int l = 1; l < num_levels; ++l) {
+				set_simd_level(levels[l]);
+				memset(dst, 0, dst_size);
+				convert(from, to, src, dst, w, h);
+				if (memcmp(dst, expected, dst_size) != 0) {
+					printf("%s -> %s (%ux%u): %s result differs from plain C\n",
+					       colorspace_to_string(from),
+					       colorspace_to_string(to),
+					       w,
+					       h,
+					       simd_level_to_string(levels[l]));
+					++errors;
+				}
+			}
+
+			free(src);
+			free(expected);
+			free(dst);
+		}
+
+		unsigned char *src = malloc_buffer(from, WIDTH, HEIGHT);
+		unsigned char *dst = malloc_buffer(to, WIDTH, HEIGHT);
+		fill_random(src, colorspace_buffer_size(from, WIDTH, HEIGHT));
 
-	//  unsigned char *yuv422_planar = malloc_buffer(YUV422_PLANAR, WIDTH, HEIGHT);
-	SharedMemoryImageBuffer *shm =
-	  new SharedMemoryImageBuffer("fv_qa_yuvconv", YUV422_PLANAR, WIDTH, HEIGHT);
-	unsigned char *yuv422_planar = shm->buffer();
+		char name[64];
+		snprintf(name, sizeof(name), "%s -> %s", colorspace_to_string(from), colorspace_to_string(to));
+		printf("%-36s", name);
+		for (unsigned int l = 0; l < num_levels; ++l) {
+			if ((levels[l] != SIMD_NONE) && !simd_conversion(from, to, levels[l])) {
+				printf("%10s", "-");
+				continue;
+			}
+			set_simd_level(levels[l]);
+			printf("%10.1f", benchmark(from, to, src, dst, runs));
+			fflush(stdout);
+		}
+		printf("\n");
 
-	yuv422packed_to_yuv422planar(yuv422_packed, yuv422_planar, WIDTH, HEIGHT);
+		free(src);
+		free(dst);
+	}
 
-	delete shm;
+	set_simd_level(supported);
 
-	return 0;
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
 }
 
 /// @endcond
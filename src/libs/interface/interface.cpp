@@ -36,6 +36,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <regex.h>
+#include <sched.h>
 #include <typeinfo>
 
 namespace fawkes {
@@ -136,12 +137,18 @@ InterfaceInvalidException::InterfaceInvalidException(const Interface *interface,
  * kind of access towards the shared memory section. At any point in
  * time there may at most exist one writer for an interface, but any
  * number of readers. The shared section is protected by a
- * ReadWriteLock. For a writer, a call to write() will copy the data
+ * ReadWriteLock, or, if the BlackBoard has been configured to do so
+ * for the interface type, by a seqlock. In the latter case readers
+ * never block the writer, but retry copying if the data was modified
+ * concurrently. For a writer, a call to write() will copy the data
  * from the private to the shared section. For a reader, a call to
  * read() will copy the data from the shared to the private
  * section. Upon opening the interface, the private section is copied
  * once from the shared section, even when opening a writer.
  *
+ * Readers that only need parts of the data can access the shared
+ * section in place using a view, see view_begin().
+ *
  * An interface has an internal timestamp. This timestamp indicates
  * when the data in the interface has been modified last. The
  * timestamp is usually automatically updated. But it some occasions
@@ -234,6 +241,7 @@ Interface::Interface()
 {
 	write_access_         = false;
 	rwlock_               = NULL;
+	seqlock_              = NULL;
 	valid_                = true;
 	next_message_id_      = 0;
 	num_fields_           = 0;
@@ -471,6 +479,20 @@ Interface::is_valid() const
 void
 Interface::read()
 {
+	if (seqlock_) {
+		data_mutex_->lock();
+		if (valid_) {
+			read_shared(data_ptr);
+			*local_read_timestamp_ = *timestamp_;
+			timestamp_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
+		} else {
+			data_mutex_->unlock();
+			throw InterfaceInvalidException(this, "read()");
+		}
+		data_mutex_->unlock();
+		return;
+	}
+
 	rwlock_->lock_for_read();
 	data_mutex_->lock();
 	if (valid_) {
@@ -497,7 +519,8 @@ Interface::write()
 		throw InterfaceWriteDeniedException(type_, id_, "Cannot write.");
 	}
 
-	rwlock_->lock_for_write();
+	if (!seqlock_)
+		rwlock_->lock_for_write();
 	data_mutex_->lock();
 	if (valid_) {
 		if (data_changed) {
@@ -509,18 +532,151 @@ Interface::write()
 			data_ts->timestamp_usec = usec;
 			data_changed            = false;
 		}
-		memcpy(mem_data_ptr_, data_ptr, data_size);
+		if (seqlock_) {
+			// there is only one writer, data_mutex_ serializes its threads
+			uint32_t seq = __atomic_load_n(seqlock_, __ATOMIC_RELAXED);
+			__atomic_store_n(seqlock_, seq + 1, __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+			__atomic_store_n(seqlock_, seq + 2, __ATOMIC_RELEASE);
+		} else {
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+		}
 	} else {
 		data_mutex_->unlock();
-		rwlock_->unlock();
+		if (!seqlock_)
+			rwlock_->unlock();
 		throw InterfaceInvalidException(this, "write()");
 	}
 	data_mutex_->unlock();
-	rwlock_->unlock();
+	if (!seqlock_)
+		rwlock_->unlock();
 
 	interface_mediator_->notify_of_data_change(this);
 }
 
+/** Copy shared memory data guarded by seqlock.
+ * Copies the data segment from the shared memory without taking any lock.
+ * The copy is retried if the writer modified the data while copying, so
+ * that on return dest contains a consistent snapshot. Must only be called
+ * if a seqlock has been set.
+ * @param dest destination to copy data to, must be at least of data size
+ */
+void
+Interface::read_shared(void *dest)
+{
+	unsigned int tries = 0;
+	uint32_t     seq_begin, seq_end;
+	do {
+		seq_begin = __atomic_load_n(seqlock_, __ATOMIC_ACQUIRE);
+		if (seq_begin & 1) {
+			// writer active, back off if it takes longer (e.g. preempted)
+			if (++tries > 100)
+				sched_yield();
+			seq_end = seq_begin + 1;
+			continue;
+		}
+		memcpy(dest, mem_data_ptr_, data_size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		seq_end = __atomic_load_n(seqlock_, __ATOMIC_RELAXED);
+	} while (seq_begin != seq_end);
+}
+
+/** Begin a zero-copy view of the shared data.
+ * A view allows to access the data in the shared memory section
+ * directly, without copying it to the private section first. This is
+ * useful for large interfaces of which only few fields are needed, or
+ * which are only inspected to decide whether a full read() is
+ * warranted. The data is accessed using the view_*() accessors of the
+ * generated interface class between view_begin() and view_end().
+ *
+ * If the interface is guarded by a seqlock the view does not block
+ * the writer. The data may therefore change while it is being
+ * inspected and must not be trusted before view_end() returned true.
+ * Otherwise the read lock is held until view_end() is called. In both
+ * cases pointers obtained from view accessors must not be used after
+ * view_end(). A typical view loop looks like this:
+ * @code
+ * unsigned int version;
+ * float        min_dist;
+ * do {
+ *   version = laser_if->view_begin();
+ *   const float *d = laser_if->view_distances();
+ *   min_dist = d[0];
+ *   for (unsigned int i = 1; i < laser_if->maxlenof_distances(); ++i) {
+ *     if (d[i] < min_dist)  min_dist = d[i];
+ *   }
+ * } while (! laser_if->view_end(version));
+ * @endcode
+ * Views must not be nested and the interface must not be read or
+ * written by the same thread between view_begin() and view_end().
+ * @return version to pass to view_end()
+ * @exception InterfaceInvalidException thrown if the interface has
+ * been marked invalid
+ */
+unsigned int
+Interface::view_begin()
+{
+	if (!valid_) {
+		throw InterfaceInvalidException(this, "view_begin()");
+	}
+
+	if (seqlock_) {
+		unsigned int tries = 0;
+		uint32_t     seq;
+		while ((seq = __atomic_load_n(seqlock_, __ATOMIC_ACQUIRE)) & 1) {
+			if (++tries > 100)
+				sched_yield();
+		}
+		return seq;
+	} else {
+		rwlock_->lock_for_read();
+		return 0;
+	}
+}
+
+/** End a zero-copy view of the shared data.
+ * @param version version as returned by view_begin()
+ * @return true if the data seen during the view was consistent, false
+ * if it has been modified concurrently and the view must be retried.
+ * Always true if the interface is not guarded by a seqlock.
+ * @see view_begin()
+ */
+bool
+Interface::view_end(unsigned int version)
+{
+	if (seqlock_) {
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (__atomic_load_n(seqlock_, __ATOMIC_RELAXED) == version);
+	} else {
+		rwlock_->unlock();
+		return true;
+	}
+}
+
+/** Get timestamp of shared data.
+ * Reads the timestamp directly from the shared memory section. Only
+ * valid between view_begin() and view_end().
+ * @return timestamp of the data currently in the shared memory section
+ */
+Time
+Interface::view_timestamp() const
+{
+	const interface_data_ts_t *ts = (const interface_data_ts_t *)mem_data_ptr_;
+	return Time(ts->timestamp_sec, ts->timestamp_usec);
+}
+
+/** Get pointer to shared data.
+ * Used by the view accessors of generated interfaces. Only valid
+ * between view_begin() and view_end().
+ * @return pointer to the data in the shared memory section
+ */
+const void *
+Interface::view_data() const
+{
+	return mem_data_ptr_;
+}
+
 /** Get data size.
  * @return size in bytes of data segment
  */
@@ -592,6 +748,21 @@ Interface::set_readwrite(bool write_access, RefCountRWLock *rwlock)
 	rwlock_       = rwlock;
 }
 
+/** Set seqlock for lock-free data access.
+ * If a seqlock is set, read() and write() do not acquire the read/write lock.
+ * Instead the writer increments the sequence counter before and after
+ * updating the shared memory and readers retry if the counter changed
+ * while copying or is odd (write in progress). All instances of an
+ * interface must agree on the mode.
+ * @param seqlock pointer to sequence counter in shared memory, NULL to use
+ * the read/write lock
+ */
+void
+Interface::set_seqlock(uint32_t *seqlock)
+{
+	seqlock_ = seqlock;
+}
+
 /** Set owner name for interface.
  * @param owner name of owner of interface
  */
@@ -1263,6 +1434,15 @@ Interface::copy_shared_to_buffer(unsigned int buffer)
 		throw OutOfBoundsException("Buffer ID out of bounds", buffer, 0, num_buffers_);
 	}
 
+	if (seqlock_) {
+		MutexLocker lock(data_mutex_);
+		if (!valid_) {
+			throw InterfaceInvalidException(this, "copy_shared_to_buffer()");
+		}
+		read_shared((char *)buffers_ + buffer * data_size);
+		return;
+	}
+
 	rwlock_->lock_for_read();
 	data_mutex_->lock();
 
@@ -120,6 +120,10 @@ public:
 	void read();
 	void write();
 
+	unsigned int view_begin();
+	bool         view_end(unsigned int version);
+	Time         view_timestamp() const;
+
 	bool                   has_writer() const;
 	unsigned int           num_readers() const;
 	std::string            writer() const;
@@ -221,6 +225,8 @@ protected:
 	                   const interface_enum_map_t *enum_map = 0);
 	void add_messageinfo(const char *name);
 
+	const void *view_data() const;
+
 	void *       data_ptr;
 	unsigned int data_size;
 	bool         data_changed;
@@ -233,8 +239,11 @@ private:
 	void set_mediators(InterfaceMediator *iface_mediator, MessageMediator *msg_mediator);
 	void set_memory(unsigned int serial, void *real_ptr, void *data_ptr);
 	void set_readwrite(bool write_access, RefCountRWLock *rwlock);
+	void set_seqlock(uint32_t *seqlock);
 	void set_owner(const char *owner);
 
+	void read_shared(void *dest);
+
 	inline unsigned int
 	next_msg_id()
 	{
@@ -261,6 +270,7 @@ private:
 
 	Mutex *         data_mutex_;
 	RefCountRWLock *rwlock_;
+	uint32_t *      seqlock_;
 
 	InterfaceMediator *interface_mediator_;
 	MessageMediator *  message_mediator_;
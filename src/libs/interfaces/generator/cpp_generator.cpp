@@ -241,6 +241,7 @@ CppInterfaceGenerator::write_cpp(FILE *f)
 	write_ctor_dtor_cpp(f, class_name, "Interface", "", data_fields, messages);
 	write_enum_constants_tostring_cpp(f);
 	write_methods_cpp(f, class_name, class_name, data_fields, pseudo_maps, "");
+	write_view_methods_cpp(f, class_name, data_fields);
 	write_basemethods_cpp(f);
 	write_messages_cpp(f);
 
@@ -967,8 +968,8 @@ CppInterfaceGenerator::write_methods_cpp(FILE *                      f,
 			  "%s%s\n"
 			  "%s%s::%s%s(unsigned int index) const\n"
 			  "{\n"
-			  "  if (index > %s) {\n"
-			  "    throw Exception(\"Index value %%u out of bounds (0..%s)\", index);\n"
+			  "  if (index >= %s) {\n"
+			  "    throw Exception(\"Index value %%u out of bounds (0..%s-1)\", index);\n"
 			  "  }\n"
 			  "  return %sdata->%s[index];\n"
 			  "}\n\n",
@@ -1054,8 +1055,8 @@ CppInterfaceGenerator::write_methods_cpp(FILE *                      f,
 			        "void\n"
 			        "%s%s::set_%s(unsigned int index, const %s new_%s)\n"
 			        "{\n"
-			        "  if (index > %s) {\n"
-			        "    throw Exception(\"Index value %%u out of bounds (0..%s)\", index);\n"
+			        "  if (index >= %s) {\n"
+			        "    throw Exception(\"Index value %%u out of bounds (0..%s-1)\", index);\n"
 			        "  }\n"
 			        "  data->%s[index] = new_%s;\n"
 			        "%s"
@@ -1167,6 +1168,83 @@ CppInterfaceGenerator::write_methods_cpp(FILE *                          f,
 	}
 }
 
+/** Write view methods to cpp file.
+ * View methods access the shared memory section of the interface
+ * directly and are only valid between Interface::view_begin() and
+ * Interface::view_end().
+ * @param f file to write to
+ * @param classname name of the interface class
+ * @param fields fields
+ */
+void
+CppInterfaceGenerator::write_view_methods_cpp(FILE *                      f,
+                                              std::string                 classname,
+                                              std::vector<InterfaceField> fields)
+{
+	fprintf(f, "/* Views */\n");
+	for (vector<InterfaceField>::iterator i = fields.begin(); i != fields.end(); ++i) {
+		bool        is_array = (i->getLengthValue() > 0) || (i->getType() == "string");
+		std::string type     = (i->isEnumType() ? (classname + "::") : std::string("")) + i->getAccessType();
+		std::string cast =
+		  i->isEnumType() ? (std::string("(") + (is_array ? "const " : "") + type + ")") : "";
+
+		fprintf(f,
+		        "/** Get %s value from shared memory.\n"
+		        " * %s\n"
+		        " * Only valid between view_begin() and view_end().\n"
+		        " * @return %s value in shared memory\n"
+		        " */\n"
+		        "%s%s\n"
+		        "%s::view_%s() const\n"
+		        "{\n"
+		        "  return %s((const %s_data_t *)view_data())->%s;\n"
+		        "}\n\n",
+		        i->getName().c_str(),
+		        i->getComment().c_str(),
+		        i->getName().c_str(),
+		        is_array ? "const " : "",
+		        type.c_str(),
+		        classname.c_str(),
+		        i->getName().c_str(),
+		        cast.c_str(),
+		        classname.c_str(),
+		        i->getName().c_str());
+
+		if ((i->getLengthValue() > 0) && (i->getType() != "string")) {
+			fprintf(f,
+			        "/** Get %s value at given index from shared memory.\n"
+			        " * %s\n"
+			        " * Only valid between view_begin() and view_end().\n"
+			        " * @param index index of value\n"
+			        " * @return %s value in shared memory\n"
+			        " * @exception Exception thrown if index is out of bounds\n"
+			        " */\n"
+			        "%s%s\n"
+			        "%s::view_%s(unsigned int index) const\n"
+			        "{\n"
+			        "  if (index >= %s) {\n"
+			        "    throw Exception(\"Index value %%u out of bounds (0..%s-1)\", index);\n"
+			        "  }\n"
+			        "  return %s((const %s_data_t *)view_data())->%s[index];\n"
+			        "}\n\n",
+			        i->getName().c_str(),
+			        i->getComment().c_str(),
+			        i->getName().c_str(),
+			        i->isEnumType() ? (classname + "::").c_str() : "",
+			        i->getPlainAccessType().c_str(),
+			        classname.c_str(),
+			        i->getName().c_str(),
+			        i->getLength().c_str(),
+			        i->getLength().c_str(),
+			        i->isEnumType()
+			          ? (std::string("(") + classname + "::" + i->getPlainAccessType() + ")").c_str()
+			          : "",
+			        classname.c_str(),
+			        i->getName().c_str());
+		}
+	}
+}
+
 /** Write methods to h file.
  * @param f file to write to
  * @param is indentation space.
@@ -1241,6 +1319,42 @@ CppInterfaceGenerator::write_methods_h(FILE *                          f,
 	}
 }
 
+/** Write view methods to h file.
+ * @param f file to write to
+ * @param is indentation space.
+ * @param fields fields to write view accessor methods for.
+ */
+void
+CppInterfaceGenerator::write_view_methods_h(FILE *                         f,
+                                            std::string /* indent space */ is,
+                                            std::vector<InterfaceField>    fields)
+{
+	fprintf(f, "%s/* Views */\n", is.c_str());
+	for (vector<InterfaceField>::iterator i = fields.begin(); i != fields.end(); ++i) {
+		if ((i->getLengthValue() > 0) || (i->getType() == "string")) {
+			fprintf(f,
+			        "%sconst %s view_%s() const;\n",
+			        is.c_str(),
+			        i->getAccessType().c_str(),
+			        i->getName().c_str());
+		} else {
+			fprintf(f,
+			        "%s%s view_%s() const;\n",
+			        is.c_str(),
+			        i->getAccessType().c_str(),
+			        i->getName().c_str());
+		}
+
+		if ((i->getLengthValue() > 0) && (i->getType() != "string")) {
+			fprintf(f,
+			        "%s%s view_%s(unsigned int index) const;\n",
+			        is.c_str(),
+			        i->getPlainAccessType().c_str(),
+			        i->getName().c_str());
+		}
+	}
+}
+
 /** Write base methods header entries.
  * @param f file to write to
  * @param is indentation string
@@ -1297,6 +1411,7 @@ CppInterfaceGenerator::write_h(FILE *f)
 	write_ctor_dtor_h(f, "  ", class_name);
 	fprintf(f, " public:\n");
 	write_methods_h(f, "  ", data_fields, pseudo_maps);
+	write_view_methods_h(f, "  ", data_fields);
 	write_basemethods_h(f, "  ");
 	fprintf(f, "\n};\n\n} // end namespace fawkes\n\n#endif\n");
 }
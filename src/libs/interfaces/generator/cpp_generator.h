@@ -107,6 +107,11 @@ public:
 	                       std::vector<InterfacePseudoMap> pseudo_maps,
 	                       std::string                     inclusion_prefix);
 
+	void write_view_methods_h(FILE *                         f,
+	                          std::string /* indent space */ is,
+	                          std::vector<InterfaceField>    fields);
+	void write_view_methods_cpp(FILE *f, std::string classname, std::vector<InterfaceField> fields);
+
 	void write_management_funcs_cpp(FILE *f);
 
 	void write_enum_map_population(FILE *f);
@@ -0,0 +1,899 @@
+
+/***************************************************************************
+ *  async_file.cpp - Asynchronous, batched file logger
+ *
+ *  Created: Sat Oct 31 10:05:48 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <logging/async_file.h>
+#include <logging/file.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdarg>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+// header of a record in a staging buffer, followed by the component and
+// the message, both null-terminated, and padding to 8 bytes
+typedef struct
+{
+	uint32_t size;
+	uint16_t component_len;
+	uint8_t  level;
+	uint8_t  flags;
+	uint32_t message_len;
+	uint32_t reserved;
+	int64_t  sec;
+	int64_t  usec;
+} async_record_header_t;
+
+#define RECORD_FLAG_PADDING 0x01
+#define RECORD_FLAG_EXCEPTION 0x02
+
+#define MAX_CRASH_LOGGERS 16
+
+static std::atomic<unsigned long>    async_logger_next_id(1);
+static std::atomic<AsyncFileLogger *> crash_loggers[MAX_CRASH_LOGGERS];
+
+class AsyncFileLoggerFlushThread : public Thread
+{
+public:
+	AsyncFileLoggerFlushThread(AsyncFileLogger *logger, unsigned int flush_interval_ms)
+	: Thread("AsyncFileLoggerFlushThread", Thread::OPMODE_CONTINUOUS),
+	  logger_(logger),
+	  flush_interval_us_(flush_interval_ms * 1000)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		usleep(flush_interval_us_);
+
+		CancelState old_cancel_state;
+		set_cancel_state(CANCEL_DISABLED, &old_cancel_state);
+		logger_->flush();
+		set_cancel_state(old_cancel_state);
+	}
+
+private:
+	AsyncFileLogger *logger_;
+	unsigned int     flush_interval_us_;
+};
+
+AsyncFileLogger::StagingBuffer::StagingBuffer(size_t size)
+: data(size), head(0), tail(0), dropped(0), orphaned(false)
+{
+}
+
+// only async-signal-safe calls from here, used by the crash handler
+static void
+crash_write_all(int fd, const char *data, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = write(fd, data, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return;
+		data += n;
+		len -= n;
+	}
+}
+
+static char *
+crash_put_digits(char *p, long int value, unsigned int num_digits)
+{
+	for (unsigned int i = num_digits; i > 0; --i) {
+		p[i - 1] = '0' + (value % 10);
+		value /= 10;
+	}
+	return p + num_digits;
+}
+
+static void
+crash_write_record(int fd, const async_record_header_t *h, long int utc_offset)
+{
+	long int day_sec = (h->sec + utc_offset) % 86400;
+	if (day_sec < 0)
+		day_sec += 86400;
+
+	// same format as write_record()
+	char  prefix[24];
+	char *p = prefix;
+	switch (h->level) {
+	case Logger::LL_DEBUG: *p++ = 'D'; break;
+	case Logger::LL_INFO: *p++ = 'I'; break;
+	case Logger::LL_WARN: *p++ = 'W'; break;
+	default: *p++ = 'E'; break;
+	}
+	*p++ = ' ';
+	p    = crash_put_digits(p, day_sec / 3600, 2);
+	*p++ = ':';
+	p    = crash_put_digits(p, (day_sec / 60) % 60, 2);
+	*p++ = ':';
+	p    = crash_put_digits(p, day_sec % 60, 2);
+	*p++ = '.';
+	p    = crash_put_digits(p, h->usec, 6);
+	*p++ = ' ';
+
+	const char *component = (const char *)(h + 1);
+	const char *separator = (h->flags & RECORD_FLAG_EXCEPTION) ? " [EXCEPTION]: " : ": ";
+	crash_write_all(fd, prefix, p - prefix);
+	crash_write_all(fd, component, h->component_len);
+	crash_write_all(fd, separator, strlen(separator));
+	crash_write_all(fd, component + h->component_len + 1, h->message_len);
+	crash_write_all(fd, "\n", 1);
+}
+/// @endcond
+
+/** @class AsyncFileLogger <logging/async_file.h>
+ * Asynchronous file logger.
+ * The FileLogger formats and writes each message on the calling thread
+ * while holding a global lock, so threads stall on disk I/O. This logger
+ * only formats the message text on the calling thread. It then appends a
+ * record with timestamp, level, component and text to a staging buffer
+ * of that thread, which is a lock-free single-producer ring buffer. A
+ * background thread periodically collects the records of all threads,
+ * orders them by time, formats the lines and writes them to the file in
+ * one batch.
+ *
+ * Memory use is bounded. Each thread gets a buffer of a fixed size, and
+ * only as many buffers are created as fit into the memory budget. One of
+ * them is shared by all threads which could not get a buffer of their
+ * own, appending to it is serialized by a mutex. Such threads get their
+ * own buffer once the buffers of exited threads have been released. If
+ * a buffer is full messages are dropped and counted. The number of
+ * dropped messages is logged with the next batch.
+ *
+ * Other loggers, e.g. a CacheLogger or a NetworkLogger, can be added as
+ * consumers. They are passed the same records from the background
+ * thread, with their original timestamps.
+ *
+ * Messages still in the staging buffers are lost if the process crashes.
+ * Call install_crash_handler() to flush them on fatal signals.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * The filename is generated from the filename pattern as described for
+ * FileLogger::open_file().
+ * @param filename_pattern the name pattern of the log-file
+ * @param min_level minimum log level
+ * @param buffer_size size in bytes of the staging buffer of each thread,
+ * rounded up to a power of two
+ * @param memory_budget maximum size in bytes of all staging buffers,
+ * at least one buffer is always created
+ * @param flush_interval_ms time in milliseconds between writing batches
+ */
+AsyncFileLogger::AsyncFileLogger(const char * filename_pattern,
+                                 LogLevel     min_level,
+                                 size_t       buffer_size,
+                                 size_t       memory_budget,
+                                 unsigned int flush_interval_ms)
+: Logger(min_level),
+  flushing_(false),
+  utc_offset_(0),
+  num_thread_buffers_(0),
+  dropped_released_(0),
+  dropped_reported_(0),
+  tm_sec_(-1)
+{
+	id_          = async_logger_next_id++;
+	buffer_size_ = 4096;
+	while (buffer_size_ < buffer_size) {
+		buffer_size_ *= 2;
+	}
+	max_buffers_ = std::max((size_t)1, memory_budget / buffer_size_);
+
+	log_file_ = FileLogger::open_file(filename_pattern);
+	log_fd_   = fileno(log_file_);
+
+	buffers_mutex_       = new Mutex();
+	flush_mutex_         = new Mutex();
+	shared_buffer_mutex_ = new Mutex();
+	shared_buffer_       = std::make_shared<StagingBuffer>(buffer_size_);
+	buffers_.push_back(shared_buffer_);
+
+	// the crash handler must not walk buffers_, it gets its own table
+	crash_buffers_ = new std::atomic<StagingBuffer *>[max_buffers_];
+	for (size_t i = 0; i < max_buffers_; ++i) {
+		crash_buffers_[i] = NULL;
+	}
+	crash_buffers_[0] = shared_buffer_.get();
+
+	time_t    now = time(NULL);
+	struct tm now_tm;
+	localtime_r(&now, &now_tm);
+	utc_offset_ = now_tm.tm_gmtoff;
+
+	for (unsigned int i = 0; i < MAX_CRASH_LOGGERS; ++i) {
+		AsyncFileLogger *expected = NULL;
+		if (crash_loggers[i].compare_exchange_strong(expected, this))
+			break;
+	}
+
+	flush_thread_ = new AsyncFileLoggerFlushThread(this, flush_interval_ms);
+	flush_thread_->start();
+}
+
+/** Destructor.
+ * Writes all remaining messages.
+ */
+AsyncFileLogger::~AsyncFileLogger()
+{
+	flush_thread_->cancel();
+	flush_thread_->join();
+	delete flush_thread_;
+
+	for (unsigned int i = 0; i < MAX_CRASH_LOGGERS; ++i) {
+		AsyncFileLogger *expected = this;
+		crash_loggers[i].compare_exchange_strong(expected, NULL);
+	}
+
+	flush();
+	fclose(log_file_);
+	delete[] crash_buffers_;
+	delete flush_mutex_;
+	delete buffers_mutex_;
+	delete shared_buffer_mutex_;
+}
+
+void
+AsyncFileLogger::log_debug(const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vlog_debug(component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::log_info(const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vlog_info(component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::log_warn(const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vlog_warn(component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::log_error(const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vlog_error(component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::vlog_debug(const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_DEBUG)
+		stage(LL_DEBUG, NULL, component, format, va);
+}
+
+void
+AsyncFileLogger::vlog_info(const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_INFO)
+		stage(LL_INFO, NULL, component, format, va);
+}
+
+void
+AsyncFileLogger::vlog_warn(const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_WARN)
+		stage(LL_WARN, NULL, component, format, va);
+}
+
+void
+AsyncFileLogger::vlog_error(const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_ERROR)
+		stage(LL_ERROR, NULL, component, format, va);
+}
+
+void
+AsyncFileLogger::log_debug(const char *component, Exception &e)
+{
+	if (log_level <= LL_DEBUG)
+		stage_exception(LL_DEBUG, NULL, component, e);
+}
+
+void
+AsyncFileLogger::log_info(const char *component, Exception &e)
+{
+	if (log_level <= LL_INFO)
+		stage_exception(LL_INFO, NULL, component, e);
+}
+
+void
+AsyncFileLogger::log_warn(const char *component, Exception &e)
+{
+	if (log_level <= LL_WARN)
+		stage_exception(LL_WARN, NULL, component, e);
+}
+
+void
+AsyncFileLogger::log_error(const char *component, Exception &e)
+{
+	if (log_level <= LL_ERROR)
+		stage_exception(LL_ERROR, NULL, component, e);
+}
+
+void
+AsyncFileLogger::tlog_debug(struct timeval *t, const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vtlog_debug(t, component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::tlog_info(struct timeval *t, const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vtlog_info(t, component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::tlog_warn(struct timeval *t, const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vtlog_warn(t, component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::tlog_error(struct timeval *t, const char *component, const char *format, ...)
+{
+	va_list arg;
+	va_start(arg, format);
+	vtlog_error(t, component, format, arg);
+	va_end(arg);
+}
+
+void
+AsyncFileLogger::tlog_debug(struct timeval *t, const char *component, Exception &e)
+{
+	if (log_level <= LL_DEBUG)
+		stage_exception(LL_DEBUG, t, component, e);
+}
+
+void
+AsyncFileLogger::tlog_info(struct timeval *t, const char *component, Exception &e)
+{
+	if (log_level <= LL_INFO)
+		stage_exception(LL_INFO, t, component, e);
+}
+
+void
+AsyncFileLogger::tlog_warn(struct timeval *t, const char *component, Exception &e)
+{
+	if (log_level <= LL_WARN)
+		stage_exception(LL_WARN, t, component, e);
+}
+
+void
+AsyncFileLogger::tlog_error(struct timeval *t, const char *component, Exception &e)
+{
+	if (log_level <= LL_ERROR)
+		stage_exception(LL_ERROR, t, component, e);
+}
+
+void
+AsyncFileLogger::vtlog_debug(struct timeval *t,
+                             const char *    component,
+                             const char *    format,
+                             va_list         va)
+{
+	if (log_level <= LL_DEBUG)
+		stage(LL_DEBUG, t, component, format, va);
+}
+
+void
+AsyncFileLogger::vtlog_info(struct timeval *t, const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_INFO)
+		stage(LL_INFO, t, component, format, va);
+}
+
+void
+AsyncFileLogger::vtlog_warn(struct timeval *t, const char *component, const char *format, va_list va)
+{
+	if (log_level <= LL_WARN)
+		stage(LL_WARN, t, component, format, va);
+}
+
+void
+AsyncFileLogger::vtlog_error(struct timeval *t,
+                             const char *    component,
+                             const char *    format,
+                             va_list         va)
+{
+	if (log_level <= LL_ERROR)
+		stage(LL_ERROR, t, component, format, va);
+}
+
+/** Add consumer.
+ * The logger is passed all records written to the file from the
+ * background thread. Its own log level still applies.
+ * @param logger logger to add, must not be this logger
+ */
+void
+AsyncFileLogger::add_consumer(Logger *logger)
+{
+	MutexLocker lock(flush_mutex_);
+	consumers_.push_back(logger);
+}
+
+/** Remove consumer.
+ * No records are passed to the logger after this method returns.
+ * @param logger logger to remove
+ */
+void
+AsyncFileLogger::remove_consumer(Logger *logger)
+{
+	MutexLocker lock(flush_mutex_);
+	consumers_.remove(logger);
+}
+
+/** Write all staged messages.
+ * This is done periodically by the background thread. Call it to make
+ * sure that all messages logged so far have been written.
+ */
+void
+AsyncFileLogger::flush()
+{
+	MutexLocker lock(flush_mutex_);
+	// the crash handler skips loggers which are writing a batch and sets
+	// the flag for good when it writes the records itself
+	if (flushing_.exchange(true))
+		return;
+	flush_locked();
+	flushing_ = false;
+}
+
+/** Get number of dropped messages.
+ * @return number of messages dropped because of full staging buffers
+ * since the logger was created
+ */
+unsigned long
+AsyncFileLogger::num_dropped() const
+{
+	MutexLocker   lock(buffers_mutex_);
+	unsigned long dropped = dropped_released_;
+	for (auto &b : buffers_) {
+		dropped += b->dropped;
+	}
+	return dropped;
+}
+
+/** Install handler to flush on fatal signals.
+ * On SIGSEGV, SIGBUS, SIGFPE, SIGILL, and SIGABRT all asynchronous file
+ * loggers write their staged messages before the signal is raised again
+ * with its default action. To be safe in a signal handler, the records
+ * are written with write(2) straight from the staging buffers. They are
+ * written buffer by buffer rather than sorted by time, and they are not
+ * passed to consumers. This is best effort, the process may be in a
+ * state where writing fails. Loggers in the middle of writing a batch
+ * are skipped.
+ */
+void
+AsyncFileLogger::install_crash_handler()
+{
+	static std::atomic<bool> installed(false);
+	if (installed.exchange(true))
+		return;
+
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = crash_handler;
+	sa.sa_flags   = SA_RESETHAND;
+	sigemptyset(&sa.sa_mask);
+	const int signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+	for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+		sigaction(signals[i], &sa, NULL);
+	}
+}
+
+/** Signal handler flushing all loggers.
+ * @param signum received signal
+ */
+void
+AsyncFileLogger::crash_handler(int signum)
+{
+	for (unsigned int i = 0; i < MAX_CRASH_LOGGERS; ++i) {
+		AsyncFileLogger *l = crash_loggers[i].load();
+		if (l && !l->flushing_.exchange(true)) {
+			l->crash_write();
+		}
+	}
+	// the default action has been restored
+	raise(signum);
+}
+
+/** Write staged records from the crash handler.
+ * Only calls async-signal-safe functions and does not allocate memory.
+ * The dropped message count is not reported.
+ */
+void
+AsyncFileLogger::crash_write()
+{
+	const long int utc_offset = utc_offset_.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < max_buffers_; ++i) {
+		StagingBuffer *b = crash_buffers_[i].load(std::memory_order_acquire);
+		if (!b)
+			continue;
+
+		const size_t mask = b->data.size() - 1;
+		size_t       tail = b->tail.load(std::memory_order_relaxed);
+		const size_t head = b->head.load(std::memory_order_acquire);
+		while (tail != head) {
+			const async_record_header_t *h = (const async_record_header_t *)&b->data[tail & mask];
+			if ((h->size == 0) || (h->size > head - tail))
+				break;
+			if (!(h->flags & RECORD_FLAG_PADDING)) {
+				crash_write_record(log_fd_, h, utc_offset);
+			}
+			tail += h->size;
+		}
+	}
+}
+
+/** Format message and stage it.
+ * @param level log level
+ * @param t time of the message, NULL to use the current time
+ * @param component component
+ * @param format format of the message
+ * @param va arguments for the format
+ */
+void
+AsyncFileLogger::stage(LogLevel              level,
+                       const struct timeval *t,
+                       const char *          component,
+                       const char *          format,
+                       va_list               va)
+{
+	// formatting is cheap compared to I/O, format now so that arguments
+	// need not stay valid until the message is written
+	static thread_local std::vector<char> message(1024);
+
+	va_list va_retry;
+	va_copy(va_retry, va);
+	int len = vsnprintf(&message[0], message.size(), format, va);
+	if ((len >= 0) && ((size_t)len >= message.size())) {
+		message.resize(len + 1);
+		len = vsnprintf(&message[0], message.size(), format, va_retry);
+	}
+	va_end(va_retry);
+	if (len < 0)
+		return;
+
+	stage_record(level, false, t, component, &message[0], len);
+}
+
+/** Stage messages of an exception.
+ * @param level log level
+ * @param t time of the message, NULL to use the current time
+ * @param component component
+ * @param e exception
+ */
+void
+AsyncFileLogger::stage_exception(LogLevel              level,
+                                 const struct timeval *t,
+                                 const char *          component,
+                                 Exception &           e)
+{
+	struct timeval now;
+	if (!t) {
+		gettimeofday(&now, NULL);
+		t = &now;
+	}
+	for (Exception::iterator i = e.begin(); i != e.end(); ++i) {
+		stage_record(level, true, t, component, *i, strlen(*i));
+	}
+}
+
+/** Append record to the staging buffer of the calling thread.
+ * Threads without a buffer of their own append to the shared buffer.
+ * The message is dropped if the buffer is full.
+ * @param level log level
+ * @param exception true if the message is part of an exception
+ * @param t time of the message, NULL to use the current time
+ * @param component component
+ * @param message message text
+ * @param message_len length of the message text
+ */
+void
+AsyncFileLogger::stage_record(LogLevel              level,
+                              bool                  exception,
+                              const struct timeval *t,
+                              const char *          component,
+                              const char *          message,
+                              size_t                message_len)
+{
+	struct timeval now;
+	if (!t) {
+		gettimeofday(&now, NULL);
+		t = &now;
+	}
+	if (!component)
+		component = "";
+
+	// the shared buffer has many producers, which must take turns
+	StagingBuffer *b = staging_buffer();
+	MutexLocker    shared_lock(shared_buffer_mutex_, false);
+	if (!b) {
+		b = shared_buffer_.get();
+		shared_lock.relock();
+	}
+
+	const size_t capacity      = b->data.size();
+	const size_t component_len = std::min(strlen(component), (size_t)255);
+	message_len                = std::min(message_len, capacity / 4);
+	const size_t size =
+	  (sizeof(async_record_header_t) + component_len + message_len + 2 + 7) & ~(size_t)7;
+
+	size_t       head       = b->head.load(std::memory_order_relaxed);
+	const size_t tail       = b->tail.load(std::memory_order_acquire);
+	size_t       pos        = head & (capacity - 1);
+	const size_t contiguous = capacity - pos;
+	const size_t required   = (contiguous < size) ? contiguous + size : size;
+	if (required > capacity - (head - tail)) {
+		b->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (contiguous < size) {
+		// skip the rest of the buffer, records are never split
+		async_record_header_t *padding = (async_record_header_t *)&b->data[pos];
+		padding->size                  = contiguous;
+		padding->flags                 = RECORD_FLAG_PADDING;
+		head += contiguous;
+		pos = 0;
+	}
+
+	async_record_header_t *h = (async_record_header_t *)&b->data[pos];
+	h->size                  = size;
+	h->component_len         = component_len;
+	h->level                 = level;
+	h->flags                 = exception ? RECORD_FLAG_EXCEPTION : 0;
+	h->message_len           = message_len;
+	h->sec                   = t->tv_sec;
+	h->usec                  = t->tv_usec;
+	char *data               = (char *)(h + 1);
+	memcpy(data, component, component_len);
+	data[component_len] = 0;
+	data += component_len + 1;
+	memcpy(data, message, message_len);
+	data[message_len] = 0;
+
+	b->head.store(head + size, std::memory_order_release);
+}
+
+/** Get staging buffer of the calling thread.
+ * The buffer is created on first use, if the memory budget permits.
+ * Otherwise creating it is tried again on the next call, which is cheap
+ * as long as no buffers have been released.
+ * @return staging buffer, NULL if the thread has none and none could be
+ * created, the shared buffer must be used then
+ */
+AsyncFileLogger::StagingBuffer *
+AsyncFileLogger::staging_buffer()
+{
+	// buffers of this thread per logger, marked as orphaned on thread exit
+	struct ThreadBuffers
+	{
+		~ThreadBuffers()
+		{
+			for (auto &b : buffers) {
+				if (b.second)
+					b.second->orphaned = true;
+			}
+		}
+
+		std::vector<std::pair<unsigned long, std::shared_ptr<StagingBuffer>>> buffers;
+	};
+	static thread_local ThreadBuffers thread_buffers;
+
+	for (auto &b : thread_buffers.buffers) {
+		if (b.first == id_)
+			return b.second.get();
+	}
+
+	// the shared buffer takes one place of the budget
+	if (num_thread_buffers_.load(std::memory_order_relaxed) + 1 >= max_buffers_)
+		return NULL;
+
+	std::shared_ptr<StagingBuffer> buffer;
+	MutexLocker                    lock(buffers_mutex_);
+	if (num_thread_buffers_ + 1 >= max_buffers_)
+		return NULL;
+	buffer = std::make_shared<StagingBuffer>(buffer_size_);
+	buffers_.push_back(buffer);
+	++num_thread_buffers_;
+	for (size_t i = 0; i < max_buffers_; ++i) {
+		if (!crash_buffers_[i].load(std::memory_order_relaxed)) {
+			crash_buffers_[i].store(buffer.get(), std::memory_order_release);
+			break;
+		}
+	}
+	lock.unlock();
+	thread_buffers.buffers.push_back(std::make_pair(id_, buffer));
+	return buffer.get();
+}
+
+/** Write all staged records.
+ * Must be called with the flush mutex locked.
+ */
+void
+AsyncFileLogger::flush_locked()
+{
+	std::vector<std::shared_ptr<StagingBuffer>> buffers;
+	buffers_mutex_->lock();
+	buffers.assign(buffers_.begin(), buffers_.end());
+	buffers_mutex_->unlock();
+
+	// collect records of all threads, they stay in place until written
+	std::vector<size_t> heads(buffers.size());
+	unsigned long       dropped = dropped_released_;
+	records_.clear();
+	for (size_t i = 0; i < buffers.size(); ++i) {
+		StagingBuffer &b    = *buffers[i];
+		size_t         tail = b.tail.load(std::memory_order_relaxed);
+		heads[i]            = b.head.load(std::memory_order_acquire);
+		dropped += b.dropped.load(std::memory_order_relaxed);
+		while (tail != heads[i]) {
+			const async_record_header_t *h =
+			  (const async_record_header_t *)&b.data[tail & (b.data.size() - 1)];
+			if (!(h->flags & RECORD_FLAG_PADDING)) {
+				record_t r;
+				r.sec       = h->sec;
+				r.usec      = h->usec;
+				r.level     = (LogLevel)h->level;
+				r.exception = (h->flags & RECORD_FLAG_EXCEPTION);
+				r.component = (const char *)(h + 1);
+				r.message   = r.component + h->component_len + 1;
+				records_.push_back(r);
+			}
+			tail += h->size;
+		}
+	}
+	std::stable_sort(records_.begin(), records_.end(), [](const record_t &a, const record_t &b) {
+		return (a.sec < b.sec) || ((a.sec == b.sec) && (a.usec < b.usec));
+	});
+
+	out_.clear();
+	for (size_t i = 0; i < records_.size(); ++i) {
+		write_record(records_[i]);
+	}
+	if (dropped > dropped_reported_) {
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		char message[64];
+		snprintf(message, sizeof(message), "Dropped %lu messages", dropped - dropped_reported_);
+		record_t r = {now.tv_sec, now.tv_usec, LL_WARN, false, "AsyncFileLogger", message};
+		write_record(r);
+		dropped_reported_ = dropped;
+	}
+	if (!out_.empty()) {
+		fwrite(out_.data(), 1, out_.size(), log_file_);
+		fflush(log_file_);
+	}
+
+	for (auto c : consumers_) {
+		for (size_t i = 0; i < records_.size(); ++i) {
+			const record_t &r  = records_[i];
+			struct timeval  tv = {r.sec, r.usec};
+			if (r.exception) {
+				Exception e("%s", r.message);
+				c->tlog(r.level, &tv, r.component, e);
+			} else {
+				c->tlog(r.level, &tv, r.component, "%s", r.message);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < buffers.size(); ++i) {
+		buffers[i]->tail.store(heads[i], std::memory_order_release);
+	}
+
+	// release buffers of threads which have exited
+	MutexLocker lock(buffers_mutex_);
+	for (auto b = buffers_.begin(); b != buffers_.end();) {
+		if ((*b)->orphaned && ((*b)->tail == (*b)->head)) {
+			dropped_released_ += (*b)->dropped;
+			for (size_t i = 0; i < max_buffers_; ++i) {
+				if (crash_buffers_[i].load(std::memory_order_relaxed) == b->get()) {
+					crash_buffers_[i].store(NULL, std::memory_order_release);
+					break;
+				}
+			}
+			b = buffers_.erase(b);
+			--num_thread_buffers_;
+		} else {
+			++b;
+		}
+	}
+}
+
+/** Format record and append it to the output buffer.
+ * @param r record to write
+ */
+void
+AsyncFileLogger::write_record(const record_t &r)
+{
+	if (r.sec != tm_sec_) {
+		time_t sec = r.sec;
+		localtime_r(&sec, &tm_);
+		tm_sec_ = r.sec;
+		utc_offset_.store(tm_.tm_gmtoff, std::memory_order_relaxed);
+	}
+
+	const char *level;
+	switch (r.level) {
+	case LL_DEBUG: level = "D"; break;
+	case LL_INFO: level = "I"; break;
+	case LL_WARN: level = "W"; break;
+	default: level = "E"; break;
+	}
+
+	char prefix[64];
+	snprintf(prefix,
+	         sizeof(prefix),
+	         "%s %02d:%02d:%02d.%06ld ",
+	         level,
+	         tm_.tm_hour,
+	         tm_.tm_min,
+	         tm_.tm_sec,
+	         (long)r.usec);
+	out_.append(prefix);
+	out_.append(r.component);
+	out_.append(r.exception ? " [EXCEPTION]: " : ": ");
+	out_.append(r.message);
+	out_.append("\n");
+}
+
+} // end namespace fawkes
@@ -0,0 +1,168 @@
+
+/***************************************************************************
+ *  async_file.h - Asynchronous, batched file logger
+ *
+ *  Created: Sat Oct 31 10:05:48 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_LOGGING_ASYNC_FILE_H_
+#define _UTILS_LOGGING_ASYNC_FILE_H_
+
+#include <logging/logger.h>
+
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class AsyncFileLoggerFlushThread;
+
+class AsyncFileLogger : public Logger
+{
+	friend class AsyncFileLoggerFlushThread;
+
+public:
+	AsyncFileLogger(const char * filename_pattern,
+	                LogLevel     min_level         = LL_DEBUG,
+	                size_t       buffer_size       = 256 * 1024,
+	                size_t       memory_budget     = 16 * 1024 * 1024,
+	                unsigned int flush_interval_ms = 50);
+	virtual ~AsyncFileLogger();
+
+	virtual void log_debug(const char *component, const char *format, ...);
+	virtual void log_info(const char *component, const char *format, ...);
+	virtual void log_warn(const char *component, const char *format, ...);
+	virtual void log_error(const char *component, const char *format, ...);
+
+	virtual void vlog_debug(const char *component, const char *format, va_list va);
+	virtual void vlog_info(const char *component, const char *format, va_list va);
+	virtual void vlog_warn(const char *component, const char *format, va_list va);
+	virtual void vlog_error(const char *component, const char *format, va_list va);
+
+	virtual void log_debug(const char *component, Exception &e);
+	virtual void log_info(const char *component, Exception &e);
+	virtual void log_warn(const char *component, Exception &e);
+	virtual void log_error(const char *component, Exception &e);
+
+	virtual void tlog_debug(struct timeval *t, const char *component, const char *format, ...);
+	virtual void tlog_info(struct timeval *t, const char *component, const char *format, ...);
+	virtual void tlog_warn(struct timeval *t, const char *component, const char *format, ...);
+	virtual void tlog_error(struct timeval *t, const char *component, const char *format, ...);
+
+	virtual void tlog_debug(struct timeval *t, const char *component, Exception &e);
+	virtual void tlog_info(struct timeval *t, const char *component, Exception &e);
+	virtual void tlog_warn(struct timeval *t, const char *component, Exception &e);
+	virtual void tlog_error(struct timeval *t, const char *component, Exception &e);
+
+	virtual void
+	             vtlog_debug(struct timeval *t, const char *component, const char *format, va_list va);
+	virtual void vtlog_info(struct timeval *t, const char *component, const char *format, va_list va);
+	virtual void vtlog_warn(struct timeval *t, const char *component, const char *format, va_list va);
+	virtual void
+	vtlog_error(struct timeval *t, const char *component, const char *format, va_list va);
+
+	void add_consumer(Logger *logger);
+	void remove_consumer(Logger *logger);
+
+	void          flush();
+	unsigned long num_dropped() const;
+
+	static void install_crash_handler();
+
+private:
+	/// @cond INTERNALS
+	class StagingBuffer
+	{
+	public:
+		StagingBuffer(size_t size);
+
+		std::vector<char>          data;
+		std::atomic<size_t>        head;
+		std::atomic<size_t>        tail;
+		std::atomic<unsigned long> dropped;
+		std::atomic<bool>          orphaned;
+	};
+
+	typedef struct
+	{
+		long int    sec;
+		long int    usec;
+		LogLevel    level;
+		bool        exception;
+		const char *component;
+		const char *message;
+	} record_t;
+	/// @endcond
+
+	void stage(LogLevel              level,
+	           const struct timeval *t,
+	           const char *          component,
+	           const char *          format,
+	           va_list               va);
+	void stage_exception(LogLevel level, const struct timeval *t, const char *component, Exception &e);
+	void stage_record(LogLevel              level,
+	                  bool                  exception,
+	                  const struct timeval *t,
+	                  const char *          component,
+	                  const char *          message,
+	                  size_t                message_len);
+	StagingBuffer *staging_buffer();
+	void           flush_locked();
+	void           write_record(const record_t &r);
+	void           crash_write();
+	static void    crash_handler(int signum);
+
+	unsigned long id_;
+	size_t        buffer_size_;
+	size_t        max_buffers_;
+	FILE *        log_file_;
+	int           log_fd_;
+
+	std::atomic<bool>             flushing_;
+	std::atomic<StagingBuffer *> *crash_buffers_;
+	std::atomic<long int>         utc_offset_;
+
+	mutable Mutex *                           buffers_mutex_;
+	std::list<std::shared_ptr<StagingBuffer>> buffers_;
+	std::atomic<size_t>                       num_thread_buffers_;
+	std::atomic<unsigned long>                dropped_released_;
+	unsigned long                             dropped_reported_;
+
+	Mutex *                        shared_buffer_mutex_;
+	std::shared_ptr<StagingBuffer> shared_buffer_;
+
+	Mutex *               flush_mutex_;
+	std::list<Logger *>   consumers_;
+	std::vector<record_t> records_;
+	std::string           out_;
+	long int              tm_sec_;
+	struct ::tm           tm_;
+
+	AsyncFileLoggerFlushThread *flush_thread_;
+};
+
+} // end namespace fawkes
+
+#endif
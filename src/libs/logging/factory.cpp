@@ -21,6 +21,7 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <logging/async_file.h>
 #include <logging/console.h>
 #include <logging/factory.h>
 #include <logging/file.h>
@@ -85,6 +86,7 @@ LoggerFactory::string_to_loglevel(const char *log_level)
  * Supported logger types:
  * - console, ConsoleLogger
  * - file, FileLogger
+ * - async-file, AsyncFileLogger, flushes on fatal signals
  * - syslog, SyslogLogger
  * NOT supported:
  * - NetworkLogger, needs a FawkesNetworkHub which cannot be passed by parameter
@@ -102,7 +104,7 @@ LoggerFactory::instance(const char *type, const char *as)
 	if (strcmp(type, "console") == 0) {
 		// no supported arguments
 		l = new ConsoleLogger();
-	} else if (strcmp(type, "file") == 0) {
+	} else if ((strcmp(type, "file") == 0) || (strcmp(type, "async-file") == 0)) {
 		char *      tmp = strdup(as);
 		char *      saveptr;
 		char *      r = strtok_r(tmp, ":", &saveptr);
@@ -113,7 +115,12 @@ LoggerFactory::instance(const char *type, const char *as)
 		} else {
 			file_name = r;
 		}
-		l = new FileLogger(file_name);
+		if (strcmp(type, "file") == 0) {
+			l = new FileLogger(file_name);
+		} else {
+			l = new AsyncFileLogger(file_name);
+			AsyncFileLogger::install_crash_handler();
+		}
 		free(tmp);
 	} else if (strcmp(type, "syslog") == 0) {
 		l = new SyslogLogger(as);
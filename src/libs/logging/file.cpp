@@ -54,19 +54,37 @@ namespace fawkes {
  */
 FileLogger::FileLogger(const char *filename_pattern, LogLevel log_level) : Logger(log_level)
 {
-	now_s = (struct tm *)malloc(sizeof(struct tm));
+	now_s    = (struct tm *)malloc(sizeof(struct tm));
+	log_file = open_file(filename_pattern);
+	// make buffer line-buffered
+	setvbuf(log_file, NULL, _IOLBF, 0);
+
+	mutex = new Mutex();
+}
+
+/** Open log file.
+ * The filename is generated from the filename pattern by replacing '$time' with
+ * the current time. In that case a symlink with '$time' replaced by 'latest'
+ * is updated to point to the new file.
+ * @param filename_pattern the name pattern of the log-file
+ * @return log file opened for appending
+ */
+FILE *
+FileLogger::open_file(const char *filename_pattern)
+{
+	struct tm      now_s;
 	struct timeval now;
 	gettimeofday(&now, NULL);
-	localtime_r(&now.tv_sec, now_s);
+	localtime_r(&now.tv_sec, &now_s);
 	char *start_time;
 	if (asprintf(&start_time,
 	             "%04d-%02d-%02d_%02d-%02d-%02d",
-	             1900 + now_s->tm_year,
-	             now_s->tm_mon + 1,
-	             now_s->tm_mday,
-	             now_s->tm_hour,
-	             now_s->tm_min,
-	             now_s->tm_sec)
+	             1900 + now_s.tm_year,
+	             now_s.tm_mon + 1,
+	             now_s.tm_mday,
+	             now_s.tm_hour,
+	             now_s.tm_min,
+	             now_s.tm_sec)
 	    == -1) {
 		throw Exception("Failed to print current time");
 	}
@@ -82,9 +100,7 @@ FileLogger::FileLogger(const char *filename_pattern, LogLevel log_level) : Logge
 	if (fd == -1) {
 		throw Exception(errno, "Failed to open log file %s", filename);
 	}
-	log_file = fdopen(fd, "a");
-	// make buffer line-buffered
-	setvbuf(log_file, NULL, _IOLBF, 0);
+	FILE *log_file = fdopen(fd, "a");
 
 	// create a symlink for the latest log if the filename has a time stamp
 	if (pos != std::string::npos) {
@@ -113,7 +129,7 @@ FileLogger::FileLogger(const char *filename_pattern, LogLevel log_level) : Logge
 		}
 	}
 
-	mutex = new Mutex();
+	return log_file;
 }
 
 /** Destructor. */
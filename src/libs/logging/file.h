@@ -72,6 +72,8 @@ public:
 	virtual void
 	vtlog_error(struct timeval *t, const char *component, const char *format, va_list va);
 
+	static FILE *open_file(const char *filename_pattern);
+
 private:
 	struct ::tm *now_s;
 
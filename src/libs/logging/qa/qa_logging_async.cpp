@@ -0,0 +1,262 @@
+
+/***************************************************************************
+ *  qa_logging_async.cpp - QA for the asynchronous file logger
+ *
+ *  Created: Sun Oct 18 20:48:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <logging/async_file.h>
+#include <logging/cache.h>
+
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define LOGFILE "/tmp/qa_logging_async.log"
+#define NUM_THREADS 16
+#define NUM_MESSAGES 500
+#define NUM_CRASH_MESSAGES 100
+#define BUFFER_SIZE 16384
+// one shared buffer and three buffers for threads
+#define NUM_BUFFERS 4
+
+static void
+log_messages(AsyncFileLogger *logger, unsigned int round, unsigned int thread)
+{
+	char component[16];
+	snprintf(component, sizeof(component), "R%uT%02u", round, thread);
+	for (unsigned int i = 0; i < NUM_MESSAGES; ++i) {
+		logger->log_info(component, "message %u", i);
+		if (i % 5 == 0)
+			usleep(500);
+	}
+}
+
+/* Check the messages the consumer got. Every thread must have delivered
+ * messages, those of one thread in the order they were logged, and all
+ * messages not counted as dropped must have arrived. */
+static unsigned int
+check_round(CacheLogger &cache, unsigned int round, unsigned long num_dropped)
+{
+	unsigned int                  errors = 0;
+	std::map<std::string, int>    last;
+	std::map<std::string, size_t> num;
+	char                          prefix[8];
+	snprintf(prefix, sizeof(prefix), "R%uT", round);
+
+	cache.lock();
+	std::list<CacheLogger::CacheEntry> &messages = cache.get_messages();
+	// newest message first
+	for (auto m = messages.rbegin(); m != messages.rend(); ++m) {
+		if (m->component.compare(0, strlen(prefix), prefix) != 0)
+			continue;
+		int seq = -1;
+		if (sscanf(m->message.c_str(), "message %i", &seq) != 1) {
+			printf("Unexpected message '%s'\n", m->message.c_str());
+			++errors;
+			continue;
+		}
+		if (last.find(m->component) != last.end() && seq <= last[m->component]) {
+			printf("%s: message %i after %i\n", m->component.c_str(), seq, last[m->component]);
+			++errors;
+		}
+		last[m->component] = seq;
+		num[m->component] += 1;
+	}
+	cache.unlock();
+
+	size_t delivered = 0;
+	for (unsigned int t = 0; t < NUM_THREADS; ++t) {
+		char component[16];
+		snprintf(component, sizeof(component), "R%uT%02u", round, t);
+		if (num[component] == 0) {
+			printf("%s: no message delivered\n", component);
+			++errors;
+		}
+		delivered += num[component];
+	}
+	printf("Round %u: %zu of %u messages delivered, %lu dropped\n",
+	       round,
+	       delivered,
+	       NUM_THREADS * NUM_MESSAGES,
+	       num_dropped);
+	if (delivered + num_dropped != NUM_THREADS * NUM_MESSAGES) {
+		printf("Round %u: messages lost without being counted as dropped\n", round);
+		++errors;
+	}
+	return errors;
+}
+
+/* Log from a child process which then aborts before the background
+ * thread has flushed. The crash handler must have written the staged
+ * messages in the same format as a regular flush. */
+static unsigned int
+check_crash()
+{
+	unsigned int   errors = 0;
+	struct timeval t      = {1000000000, 123456};
+
+	unlink(LOGFILE);
+	pid_t pid = fork();
+	if (pid == 0) {
+		AsyncFileLogger *logger =
+		  new AsyncFileLogger(LOGFILE, Logger::LL_DEBUG, BUFFER_SIZE, NUM_BUFFERS * BUFFER_SIZE, 60000);
+		AsyncFileLogger::install_crash_handler();
+		logger->tlog_info(&t, "Crash", "flushed");
+		logger->flush();
+		logger->tlog_info(&t, "Crash", "staged");
+		for (unsigned int i = 0; i < NUM_CRASH_MESSAGES; ++i) {
+			logger->log_warn("Crash", "message %u", i);
+		}
+		Exception e("exception message");
+		logger->log_error("Crash", e);
+		abort();
+	}
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+	if (!WIFSIGNALED(status) || (WTERMSIG(status) != SIGABRT)) {
+		printf("Crash: child did not abort\n");
+		++errors;
+	}
+
+	std::vector<std::string> lines;
+	FILE *                   f = fopen(LOGFILE, "r");
+	if (f) {
+		char line[256];
+		while (fgets(line, sizeof(line), f)) {
+			lines.push_back(line);
+		}
+		fclose(f);
+	}
+	unlink(LOGFILE);
+
+	if (lines.size() != NUM_CRASH_MESSAGES + 3) {
+		printf("Crash: %zu lines written, expected %u\n", lines.size(), NUM_CRASH_MESSAGES + 3);
+		return errors + 1;
+	}
+	// same time, so same prefix as the regular flush
+	std::string expected = lines[0].substr(0, lines[0].find("flushed")) + "staged\n";
+	if (lines[1] != expected) {
+		printf("Crash: got '%s' after '%s'\n", lines[1].c_str(), lines[0].c_str());
+		++errors;
+	}
+	for (unsigned int i = 0; i < NUM_CRASH_MESSAGES; ++i) {
+		char message[64];
+		snprintf(message, sizeof(message), "Crash: message %u\n", i);
+		const std::string &l = lines[i + 2];
+		if ((l[0] != 'W') || (l.size() != 18 + strlen(message)) || (l.substr(18) != message)) {
+			printf("Crash: unexpected line '%s'\n", l.c_str());
+			++errors;
+			break;
+		}
+	}
+	if (lines.back().find("E ") != 0
+	    || lines.back().find(" Crash [EXCEPTION]: exception message\n") == std::string::npos) {
+		printf("Crash: unexpected exception line '%s'\n", lines.back().c_str());
+		++errors;
+	}
+
+	printf("Crash: %zu lines written by the crash handler\n", lines.size() - 1);
+	return errors;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int errors = 0;
+
+	unlink(LOGFILE);
+	AsyncFileLogger *logger =
+	  new AsyncFileLogger(LOGFILE, Logger::LL_DEBUG, BUFFER_SIZE, NUM_BUFFERS * BUFFER_SIZE, 5);
+	CacheLogger cache(2 * NUM_THREADS * NUM_MESSAGES);
+	logger->add_consumer(&cache);
+
+	// more threads than buffers, most threads share a buffer; the threads
+	// of the second round can only get buffers of their own once the
+	// buffers of the first round have been released
+	unsigned long dropped = 0;
+	for (unsigned int round = 0; round < 2; ++round) {
+		std::vector<std::thread> threads;
+		for (unsigned int t = 0; t < NUM_THREADS; ++t) {
+			threads.push_back(std::thread(log_messages, logger, round, t));
+		}
+		for (auto &t : threads) {
+			t.join();
+		}
+		logger->flush();
+		// another flush releases the buffers of exited threads
+		logger->flush();
+
+		errors += check_round(cache, round, logger->num_dropped() - dropped);
+		dropped = logger->num_dropped();
+	}
+
+	logger->remove_consumer(&cache);
+	logger->log_info("QA", "not passed to the consumer");
+	delete logger;
+
+	cache.lock();
+	size_t num_cached = cache.get_messages().size();
+	cache.unlock();
+
+	// the file has all messages and reports of dropped ones
+	size_t num_lines = 0, num_dropped_lines = 0;
+	FILE * f         = fopen(LOGFILE, "r");
+	if (f) {
+		char line[256];
+		while (fgets(line, sizeof(line), f)) {
+			if (strstr(line, "AsyncFileLogger: Dropped"))
+				++num_dropped_lines;
+			else
+				++num_lines;
+		}
+		fclose(f);
+	}
+	if (num_lines != num_cached + 1) {
+		printf("Log file has %zu messages, consumer got %zu\n", num_lines, num_cached);
+		++errors;
+	}
+	if ((dropped > 0) && (num_dropped_lines == 0)) {
+		printf("Dropped messages not reported in log file\n");
+		++errors;
+	}
+	unlink(LOGFILE);
+
+	errors += check_crash();
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -26,6 +26,9 @@ using namespace std;
 
 namespace fawkes {
 
+/** Maximum number of computations with changes to remember. */
+#define MAX_CHANGES 32
+
 /** @class NavGraphConstraintRepo <navgraph/constraints/constraint_repo.h>
  * Constraint repository to maintain blocks on nodes.
  * @author Sebastian Reuter
@@ -35,7 +38,8 @@ namespace fawkes {
 /** Constructor. */
 NavGraphConstraintRepo::NavGraphConstraintRepo()
 {
-	modified_ = false;
+	modified_      = false;
+	change_serial_ = 0;
 }
 
 /** Destructor. */
@@ -51,6 +55,10 @@ NavGraphConstraintRepo::register_constraint(NavGraphNodeConstraint *constraint)
 {
 	modified_ = true;
 	node_constraints_.push_back(constraint);
+
+	change_t change;
+	change.known = false;
+	add_change(change);
 }
 
 /** Register a constraint.
@@ -61,6 +69,10 @@ NavGraphConstraintRepo::register_constraint(NavGraphEdgeConstraint *constraint)
 {
 	modified_ = true;
 	edge_constraints_.push_back(constraint);
+
+	change_t change;
+	change.known = false;
+	add_change(change);
 }
 
 /** Register an edge cost constraint.
@@ -71,6 +83,10 @@ NavGraphConstraintRepo::register_constraint(NavGraphEdgeCostConstraint *constrai
 {
 	modified_ = true;
 	edge_cost_constraints_.push_back(constraint);
+
+	change_t change;
+	change.known = false;
+	add_change(change);
 }
 
 /** Unregister a constraint by name.
@@ -104,6 +120,10 @@ NavGraphConstraintRepo::unregister_constraint(std::string name)
 	if (ecc != edge_cost_constraints_.end()) {
 		edge_cost_constraints_.erase(ecc);
 	}
+
+	change_t change;
+	change.known = false;
+	add_change(change);
 }
 
 /** Check by name if a constraint has been registered.
@@ -230,28 +250,107 @@ NavGraphConstraintRepo::has_constraints() const
 }
 
 /** Call compute method on all registered constraints.
+ * The nodes and edges reported as changed by the constraints are
+ * recorded, they can be retrieved with changes().
  * @return true if any constraint reported a change, false otherwise
  */
 bool
 NavGraphConstraintRepo::compute()
 {
-	bool modified = false;
+	bool                                             modified = false;
+	change_t                                         change;
+	std::vector<std::string>                         nodes;
+	std::vector<std::pair<std::string, std::string>> edges;
+	change.known = true;
+
 	for (fawkes::NavGraphNodeConstraint *c : node_constraints_) {
-		if (c->compute())
+		if (c->compute()) {
 			modified = true;
+			if (c->changed_nodes(nodes)) {
+				change.nodes.insert(change.nodes.end(), nodes.begin(), nodes.end());
+			} else {
+				change.known = false;
+			}
+		}
 	}
 	for (fawkes::NavGraphEdgeConstraint *c : edge_constraints_) {
-		if (c->compute())
+		if (c->compute()) {
 			modified = true;
+			if (c->changed_edges(edges)) {
+				change.edges.insert(change.edges.end(), edges.begin(), edges.end());
+			} else {
+				change.known = false;
+			}
+		}
 	}
 	for (fawkes::NavGraphEdgeCostConstraint *c : edge_cost_constraints_) {
-		if (c->compute())
+		if (c->compute()) {
 			modified = true;
+			if (c->changed_edges(edges)) {
+				change.edges.insert(change.edges.end(), edges.begin(), edges.end());
+			} else {
+				change.known = false;
+			}
+		}
 	}
 
+	if (modified)
+		add_change(change);
+
 	return modified;
 }
 
+/** Get nodes and edges changed by computations.
+ * This allows to update results of earlier searches incrementally.
+ * Changes are known for a limited number of computations only, and
+ * only if all changed constraints report the affected nodes and edges,
+ * cf. NavGraphNodeConstraint::changed_nodes(). Registering and
+ * unregistering constraints is an unknown change.
+ * @param serial serial of the last call, zero on the first call. Upon
+ * return contains the serial to pass on the next call.
+ * @param nodes upon return contains the names of nodes whose state
+ * has changed since the call which returned @p serial
+ * @param edges upon return contains the node name pairs of edges whose
+ * state has changed since the call which returned @p serial
+ * @return true if the changes are known, false if any node or edge may
+ * have changed
+ */
+bool
+NavGraphConstraintRepo::changes(unsigned int &                                    serial,
+                                std::vector<std::string> &                        nodes,
+                                std::vector<std::pair<std::string, std::string>> &edges) const
+{
+	nodes.clear();
+	edges.clear();
+	if (serial == change_serial_)
+		return true;
+
+	bool known =
+	  (serial < change_serial_) && !changes_.empty() && (changes_.front().serial <= serial + 1);
+	for (const change_t &c : changes_) {
+		if (c.serial > serial) {
+			known = known && c.known;
+			nodes.insert(nodes.end(), c.nodes.begin(), c.nodes.end());
+			edges.insert(edges.end(), c.edges.begin(), c.edges.end());
+		}
+	}
+	serial = change_serial_;
+	return known;
+}
+
+/** Record a change.
+ * @param change change to record, the serial is assigned
+ */
+void
+NavGraphConstraintRepo::add_change(change_t &change)
+{
+	change.serial = ++change_serial_;
+	changes_.push_back(change);
+	if (changes_.size() > MAX_CHANGES) {
+		changes_.pop_front();
+	}
+}
+
 /** Check if any constraint in the repo blocks the node.
  * @param node Node to check for a block
  * @return the (first) node constraint that blocked the node,
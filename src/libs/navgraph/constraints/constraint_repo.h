@@ -29,7 +29,9 @@
 
 #include <list>
 #include <map>
+#include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace fawkes {
@@ -87,11 +89,30 @@ public:
 
 	bool modified(bool reset_modified = false);
 
+	bool changes(unsigned int &                                    serial,
+	             std::vector<std::string> &                        nodes,
+	             std::vector<std::pair<std::string, std::string>> &edges) const;
+
 private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		unsigned int                                     serial;
+		bool                                             known;
+		std::vector<std::string>                         nodes;
+		std::vector<std::pair<std::string, std::string>> edges;
+	} change_t;
+	/// @endcond
+
+	void add_change(change_t &change);
+
 	NodeConstraintList     node_constraints_;
 	EdgeConstraintList     edge_constraints_;
 	EdgeCostConstraintList edge_cost_constraints_;
 	bool                   modified_;
+
+	unsigned int        change_serial_;
+	std::list<change_t> changes_;
 };
 } // namespace fawkes
 
@@ -103,6 +103,21 @@ NavGraphEdgeConstraint::compute(void) throw()
 	return false;
 }
 
+/** Get edges changed by the last computation.
+ * This is called after compute() returned true to determine which edges
+ * are affected by the change, for example for incremental re-planning.
+ * Constraints which cannot tell the affected edges keep this default
+ * implementation, in which case any edge may have changed.
+ * @param edges upon return contains pairs of node names of the edges
+ * whose state changed up to the last call of compute() which returned true
+ * @return true if the changed edges are known, false otherwise
+ */
+bool
+NavGraphEdgeConstraint::changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw()
+{
+	return false;
+}
+
 /** Check if constraint matches name.
  * @param name name string to compare this constraints name to
  * @return true if the given name is the same as this constraint's name,
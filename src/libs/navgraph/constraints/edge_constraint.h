@@ -25,6 +25,7 @@
 #include <navgraph/navgraph_node.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace fawkes {
@@ -42,6 +43,7 @@ public:
 
 	virtual bool compute(void) throw();
 	virtual bool blocks(const fawkes::NavGraphNode &from, const fawkes::NavGraphNode &to) throw() = 0;
+	virtual bool changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw();
 
 	bool operator==(const std::string &name) const;
 
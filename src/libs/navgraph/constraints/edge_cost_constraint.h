@@ -24,6 +24,7 @@
 #include <navgraph/navgraph_node.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace fawkes {
@@ -42,6 +43,7 @@ public:
 	virtual bool  compute(void) throw();
 	virtual float cost_factor(const fawkes::NavGraphNode &from,
 	                          const fawkes::NavGraphNode &to) throw() = 0;
+	virtual bool  changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw();
 
 	bool operator==(const std::string &name) const;
 
@@ -95,6 +95,21 @@ NavGraphNodeConstraint::compute(void) throw()
 	return false;
 }
 
+/** Get nodes changed by the last computation.
+ * This is called after compute() returned true to determine which nodes
+ * are affected by the change, for example for incremental re-planning.
+ * Constraints which cannot tell the affected nodes keep this default
+ * implementation, in which case any node may have changed.
+ * @param nodes upon return contains the names of the nodes whose state
+ * changed up to the last call of compute() which returned true
+ * @return true if the changed nodes are known, false otherwise
+ */
+bool
+NavGraphNodeConstraint::changed_nodes(std::vector<std::string> &nodes) throw()
+{
+	return false;
+}
+
 /** Check if constraint matches name.
  * @param name name string to compare this constraints name to
  * @return true if the given name is the same as this constraint's name,
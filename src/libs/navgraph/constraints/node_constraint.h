@@ -42,6 +42,7 @@ public:
 
 	virtual bool compute(void) throw();
 	virtual bool blocks(const fawkes::NavGraphNode &node) throw() = 0;
+	virtual bool changed_nodes(std::vector<std::string> &nodes) throw();
 
 	bool operator==(const std::string &name) const;
 
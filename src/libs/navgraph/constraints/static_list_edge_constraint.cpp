@@ -64,12 +64,22 @@ NavGraphStaticListEdgeConstraint::compute(void) throw()
 {
 	if (modified_) {
 		modified_ = false;
+		changed_edges_.swap(changes_);
+		changes_.clear();
 		return true;
 	} else {
 		return false;
 	}
 }
 
+bool
+NavGraphStaticListEdgeConstraint::changed_edges(
+  std::vector<std::pair<std::string, std::string>> &edges) throw()
+{
+	edges = changed_edges_;
+	return true;
+}
+
 /** Add a single edge to constraint list.
  * @param edge edge to add to constraint list
  */
@@ -79,6 +89,7 @@ NavGraphStaticListEdgeConstraint::add_edge(const fawkes::NavGraphEdge &edge)
 	if (!has_edge(edge)) {
 		modified_ = true;
 		edge_list_.push_back(edge);
+		changes_.push_back(std::make_pair(edge.from(), edge.to()));
 	}
 }
 
@@ -102,6 +113,7 @@ NavGraphStaticListEdgeConstraint::remove_edge(const fawkes::NavGraphEdge &edge)
 	std::vector<NavGraphEdge>::iterator e = std::find(edge_list_.begin(), edge_list_.end(), edge);
 	if (e != edge_list_.end()) {
 		modified_ = true;
+		changes_.push_back(std::make_pair(e->from(), e->to()));
 		edge_list_.erase(e);
 	}
 }
@@ -131,6 +143,9 @@ NavGraphStaticListEdgeConstraint::clear_edges()
 {
 	if (!edge_list_.empty()) {
 		modified_ = true;
+		for (const NavGraphEdge &e : edge_list_) {
+			changes_.push_back(std::make_pair(e.from(), e.to()));
+		}
 		edge_list_.clear();
 	}
 }
@@ -51,10 +51,13 @@ public:
 	virtual bool compute(void) throw();
 
 	virtual bool blocks(const fawkes::NavGraphNode &from, const fawkes::NavGraphNode &to) throw();
+	virtual bool changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw();
 
 private:
-	std::vector<fawkes::NavGraphEdge> edge_list_;
-	bool                              modified_;
+	std::vector<fawkes::NavGraphEdge>                 edge_list_;
+	bool                                              modified_;
+	std::vector<std::pair<std::string, std::string>> changes_;
+	std::vector<std::pair<std::string, std::string>> changed_edges_;
 };
 
 } // end namespace fawkes
@@ -52,6 +52,8 @@ NavGraphStaticListEdgeCostConstraint::compute(void) throw()
 		modified_ = false;
 		edge_cost_list_buffer_.lock();
 		edge_cost_list_ = edge_cost_list_buffer_;
+		changed_edges_.swap(changes_);
+		changes_.clear();
 		edge_cost_list_buffer_.unlock();
 		return true;
 	} else {
@@ -59,6 +61,14 @@ NavGraphStaticListEdgeCostConstraint::compute(void) throw()
 	}
 }
 
+bool
+NavGraphStaticListEdgeCostConstraint::changed_edges(
+  std::vector<std::pair<std::string, std::string>> &edges) throw()
+{
+	edges = changed_edges_;
+	return true;
+}
+
 /** Add a single edge to constraint list.
  * @param edge edge to add to constraint list
  * @param cost_factor cost factor for this edge, must be >= 1.00001
@@ -70,8 +80,11 @@ NavGraphStaticListEdgeCostConstraint::add_edge(const fawkes::NavGraphEdge &edge,
 		throw Exception("Invalid cost factor %f, must be >= 1.00001", cost_factor);
 	}
 	if (!has_edge(edge)) {
+		edge_cost_list_buffer_.lock();
 		modified_ = true;
-		edge_cost_list_buffer_.push_back_locked(std::make_pair(edge, cost_factor));
+		edge_cost_list_buffer_.push_back(std::make_pair(edge, cost_factor));
+		changes_.push_back(std::make_pair(edge.from(), edge.to()));
+		edge_cost_list_buffer_.unlock();
 	}
 }
 
@@ -101,8 +114,11 @@ NavGraphStaticListEdgeCostConstraint::remove_edge(const fawkes::NavGraphEdge &ed
 	               });
 
 	if (ec != edge_cost_list_buffer_.end()) {
+		edge_cost_list_buffer_.lock();
 		modified_ = true;
-		edge_cost_list_buffer_.erase_locked(ec);
+		changes_.push_back(std::make_pair(ec->first.from(), ec->first.to()));
+		edge_cost_list_buffer_.erase(ec);
+		edge_cost_list_buffer_.unlock();
 	}
 }
 
@@ -138,8 +154,13 @@ void
 NavGraphStaticListEdgeCostConstraint::clear_edges()
 {
 	if (!edge_cost_list_buffer_.empty()) {
+		edge_cost_list_buffer_.lock();
 		modified_ = true;
+		for (const std::pair<NavGraphEdge, float> &ec : edge_cost_list_buffer_) {
+			changes_.push_back(std::make_pair(ec.first.from(), ec.first.to()));
+		}
 		edge_cost_list_buffer_.clear();
+		edge_cost_list_buffer_.unlock();
 	}
 }
 
@@ -50,11 +50,14 @@ public:
 
 	virtual float cost_factor(const fawkes::NavGraphNode &from,
 	                          const fawkes::NavGraphNode &to) throw();
+	virtual bool  changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw();
 
 private:
 	std::vector<std::pair<fawkes::NavGraphEdge, float>>        edge_cost_list_;
 	fawkes::LockVector<std::pair<fawkes::NavGraphEdge, float>> edge_cost_list_buffer_;
 	bool                                                       modified_;
+	std::vector<std::pair<std::string, std::string>>           changes_;
+	std::vector<std::pair<std::string, std::string>>           changed_edges_;
 };
 
 } // end namespace fawkes
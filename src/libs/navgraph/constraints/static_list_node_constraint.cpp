@@ -63,12 +63,21 @@ NavGraphStaticListNodeConstraint::compute(void) throw()
 {
 	if (modified_) {
 		modified_ = false;
+		changed_nodes_.swap(changes_);
+		changes_.clear();
 		return true;
 	} else {
 		return false;
 	}
 }
 
+bool
+NavGraphStaticListNodeConstraint::changed_nodes(std::vector<std::string> &nodes) throw()
+{
+	nodes = changed_nodes_;
+	return true;
+}
+
 /** Add a single node to constraint list.
  * @param node node to add to constraint list
  */
@@ -78,6 +87,7 @@ NavGraphStaticListNodeConstraint::add_node(const fawkes::NavGraphNode &node)
 	if (!has_node(node)) {
 		modified_ = true;
 		node_list_.push_back(node);
+		changes_.push_back(node.name());
 	}
 }
 
@@ -101,6 +111,7 @@ NavGraphStaticListNodeConstraint::remove_node(const fawkes::NavGraphNode &node)
 	std::vector<NavGraphNode>::iterator n = std::find(node_list_.begin(), node_list_.end(), node);
 	if (n != node_list_.end()) {
 		modified_ = true;
+		changes_.push_back(n->name());
 		node_list_.erase(n);
 	}
 }
@@ -130,6 +141,9 @@ NavGraphStaticListNodeConstraint::clear_nodes()
 {
 	if (!node_list_.empty()) {
 		modified_ = true;
+		for (const NavGraphNode &n : node_list_) {
+			changes_.push_back(n.name());
+		}
 		node_list_.clear();
 	}
 }
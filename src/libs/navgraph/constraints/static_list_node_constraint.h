@@ -49,6 +49,7 @@ public:
 	bool has_node(const fawkes::NavGraphNode &node);
 
 	virtual bool compute(void) throw();
+	virtual bool changed_nodes(std::vector<std::string> &nodes) throw();
 
 	virtual bool
 	blocks(const fawkes::NavGraphNode &node) throw()
@@ -59,6 +60,10 @@ public:
 protected:
 	std::vector<fawkes::NavGraphNode> node_list_; ///< Node list
 	bool modified_; ///< Set to true if changes are made to the constraint.
+	std::vector<std::string> changes_; ///< Names of nodes changed since the last compute().
+
+private:
+	std::vector<std::string> changed_nodes_;
 };
 
 } // end namespace fawkes
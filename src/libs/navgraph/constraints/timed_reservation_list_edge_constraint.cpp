@@ -86,6 +86,7 @@ NavGraphTimedReservationListEdgeConstraint::compute(void) throw()
 		edge_time_list_.erase(std::remove(edge_time_list_.begin(), edge_time_list_.end(), ec),
 		                      edge_time_list_.end());
 		modified_ = true;
+		changes_.push_back(std::make_pair(ec.first.from(), ec.first.to()));
 		logger_->log_info("TimedEdgeConstraint",
 		                  "Deleted edge '%s_%s' from '%s' because it validity duration ran out",
 		                  ec.first.from().c_str(),
@@ -95,12 +96,22 @@ NavGraphTimedReservationListEdgeConstraint::compute(void) throw()
 
 	if (modified_) {
 		modified_ = false;
+		changed_edges_.swap(changes_);
+		changes_.clear();
 		return true;
 	} else {
 		return false;
 	}
 }
 
+bool
+NavGraphTimedReservationListEdgeConstraint::changed_edges(
+  std::vector<std::pair<std::string, std::string>> &edges) throw()
+{
+	edges = changed_edges_;
+	return true;
+}
+
 /** Add a single edge to constraint list.
  * @param edge edge to add to constraint list
  * @param valid_time valid time for this edge
@@ -121,6 +132,7 @@ NavGraphTimedReservationListEdgeConstraint::add_edge(const fawkes::NavGraphEdge
 	if (!has_edge(edge)) {
 		modified_ = true;
 		edge_time_list_.push_back(std::make_pair(edge, valid_time));
+		changes_.push_back(std::make_pair(edge.from(), edge.to()));
 		std::string txt = edge.from();
 		txt += "_";
 		txt += edge.to();
@@ -161,6 +173,7 @@ NavGraphTimedReservationListEdgeConstraint::remove_edge(const fawkes::NavGraphEd
 
 	if (ec != edge_time_list_.end()) {
 		modified_ = true;
+		changes_.push_back(std::make_pair(ec->first.from(), ec->first.to()));
 		edge_time_list_.erase(ec);
 	}
 }
@@ -208,6 +221,9 @@ NavGraphTimedReservationListEdgeConstraint::clear_edges()
 {
 	if (!edge_time_list_.empty()) {
 		modified_ = true;
+		for (const std::pair<NavGraphEdge, fawkes::Time> &ec : edge_time_list_) {
+			changes_.push_back(std::make_pair(ec.first.from(), ec.first.to()));
+		}
 		edge_time_list_.clear();
 	}
 }
@@ -58,10 +58,13 @@ public:
 
 	virtual bool compute(void) throw();
 	virtual bool blocks(const fawkes::NavGraphNode &from, const fawkes::NavGraphNode &to) throw();
+	virtual bool changed_edges(std::vector<std::pair<std::string, std::string>> &edges) throw();
 
 private:
 	std::vector<std::pair<fawkes::NavGraphEdge, fawkes::Time>> edge_time_list_;
 	bool                                                       modified_;
+	std::vector<std::pair<std::string, std::string>>           changes_;
+	std::vector<std::pair<std::string, std::string>>           changed_edges_;
 	Logger *                                                   logger_;
 	fawkes::Clock *                                            clock_;
 	std::string                                                constraint_name_;
@@ -85,6 +85,7 @@ NavGraphTimedReservationListNodeConstraint::compute(void) throw()
 		node_time_list_.erase(std::remove(node_time_list_.begin(), node_time_list_.end(), ec),
 		                      node_time_list_.end());
 		modified_ = true;
+		changes_.push_back(ec.first.name());
 		logger_->log_debug("TimedNodeConstraint",
 		                   "Deleted node '%s' from '%s' because its validity duration ran out",
 		                   ec.first.name().c_str(),
@@ -93,12 +94,21 @@ NavGraphTimedReservationListNodeConstraint::compute(void) throw()
 
 	if (modified_) {
 		modified_ = false;
+		changed_nodes_.swap(changes_);
+		changes_.clear();
 		return true;
 	} else {
 		return false;
 	}
 }
 
+bool
+NavGraphTimedReservationListNodeConstraint::changed_nodes(std::vector<std::string> &nodes) throw()
+{
+	nodes = changed_nodes_;
+	return true;
+}
+
 /** Add a single node to constraint list.
  * @param node node to add to constraint list
  * @param valid_time valid time for this node
@@ -119,6 +129,7 @@ NavGraphTimedReservationListNodeConstraint::add_node(const fawkes::NavGraphNode
 	if (!has_node(node)) {
 		modified_ = true;
 		node_time_list_.push_back(std::make_pair(node, valid_time));
+		changes_.push_back(node.name());
 		std::string txt = node.name();
 	}
 }
@@ -155,6 +166,7 @@ NavGraphTimedReservationListNodeConstraint::remove_node(const fawkes::NavGraphNo
 
 	if (ec != node_time_list_.end()) {
 		modified_ = true;
+		changes_.push_back(ec->first.name());
 		node_time_list_.erase(ec);
 	}
 }
@@ -200,6 +212,9 @@ NavGraphTimedReservationListNodeConstraint::clear_nodes()
 {
 	if (!node_time_list_.empty()) {
 		modified_ = true;
+		for (const std::pair<NavGraphNode, fawkes::Time> &ec : node_time_list_) {
+			changes_.push_back(ec.first.name());
+		}
 		node_time_list_.clear();
 	}
 }
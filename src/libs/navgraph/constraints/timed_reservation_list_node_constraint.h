@@ -58,10 +58,13 @@ public:
 
 	virtual bool compute(void) throw();
 	virtual bool blocks(const fawkes::NavGraphNode &node) throw();
+	virtual bool changed_nodes(std::vector<std::string> &nodes) throw();
 
 private:
 	std::vector<std::pair<fawkes::NavGraphNode, fawkes::Time>> node_time_list_;
 	bool                                                       modified_;
+	std::vector<std::string>                                   changes_;
+	std::vector<std::string>                                   changed_nodes_;
 	Logger *                                                   logger_;
 	fawkes::Clock *                                            clock_;
 	std::string                                                constraint_name_;
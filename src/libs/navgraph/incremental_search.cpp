@@ -0,0 +1,575 @@
+/***************************************************************************
+ *  incremental_search.cpp - Incremental path search under changing constraints
+ *
+ *  Created: Sun Oct 18 14:37:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/incremental_search.h>
+#include <navgraph/search_graph.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static const float INF = std::numeric_limits<float>::infinity();
+/// @endcond
+
+/** @class NavGraphIncrementalSearch <navgraph/incremental_search.h>
+ * Incremental path search under changing constraints.
+ * While a robot follows a path, constraints such as timed reservations
+ * or blocked clusters change the cost of a few edges every so often.
+ * Replanning with NavGraph::search_path() then searches the whole graph
+ * from scratch each time. This class implements D* Lite, which searches
+ * backwards from the goal and keeps the search tree between calls. On
+ * the next call for the same goal, only the nodes affected by changed
+ * arc costs and by the movement of the robot are repaired.
+ *
+ * Arc costs are evaluated when the search first reads them. On later
+ * calls, only arcs affected by the nodes and edges which the constraint
+ * repository reports as changed are evaluated again, cf.
+ * NavGraphConstraintRepo::changes(). If the changes are unknown, all arcs
+ * read by previous searches are evaluated again.
+ * The search tree is discarded if the goal or the graph change.
+ *
+ * If default search functions are used, the straight line distance is
+ * used as heuristic. With custom search functions, arc costs are
+ * determined by NavGraph::cost() and no heuristic is used.
+ *
+ * The graph must outlive this instance. It must not be modified
+ * concurrently to a search, lock it if it is shared.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param graph graph to search in, the instance registers as change listener
+ */
+NavGraphIncrementalSearch::NavGraphIncrementalSearch(NavGraph *graph)
+: graph_(graph),
+  graph_changed_(true),
+  default_search_(true),
+  initialized_(false),
+  start_(0),
+  goal_(0),
+  km_(0.),
+  constraint_repo_(NULL),
+  used_constraints_(false),
+  change_serial_(0),
+  search_stamp_(0),
+  last_duration_(0.),
+  last_full_search_(false),
+  last_changed_arcs_(0),
+  last_expansions_(0)
+{
+	graph_->add_change_listener(this);
+}
+
+/** Destructor. */
+NavGraphIncrementalSearch::~NavGraphIncrementalSearch()
+{
+	graph_->remove_change_listener(this);
+}
+
+void
+NavGraphIncrementalSearch::graph_changed() throw()
+{
+	graph_changed_ = true;
+}
+
+/** Discard the search tree.
+ * The next search will be a full search.
+ */
+void
+NavGraphIncrementalSearch::reset()
+{
+	initialized_ = false;
+}
+
+/** Search for a path between two nodes.
+ * The semantics are those of NavGraph::search_path() with the graph's
+ * current search functions. If the goal is the same as for the previous
+ * call, the previous search tree is repaired instead of searching anew.
+ * @param from node to search from
+ * @param to goal node
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return path from @p from to @p to, empty if no path could be found
+ */
+NavGraphPath
+NavGraphIncrementalSearch::search_path(const NavGraphNode &from,
+                                       const NavGraphNode &to,
+                                       bool                use_constraints,
+                                       bool                compute_constraints)
+{
+	Time start_time;
+
+	if (graph_changed_ || !search_graph_) {
+		search_graph_.reset(new NavGraphSearchGraph(graph_->nodes(), graph_->edges()));
+		graph_changed_ = false;
+		initialized_   = false;
+	}
+	if (default_search_ != graph_->uses_default_search()) {
+		default_search_ = graph_->uses_default_search();
+		initialized_    = false;
+	}
+
+	std::vector<NavGraphNode> path;
+	unsigned int              from_index, to_index;
+	if (!search_graph_->node_index(from.name(), from_index)
+	    || !search_graph_->node_index(to.name(), to_index)) {
+		return NavGraphPath(graph_, path, -1);
+	}
+
+	LockPtr<NavGraphConstraintRepo> constraint_repo = graph_->constraint_repo();
+	bool                            changes_known   = true;
+	constraint_repo_                                = NULL;
+	if (use_constraints) {
+		constraint_repo.lock();
+		if (compute_constraints && constraint_repo->has_constraints()) {
+			constraint_repo->compute();
+		}
+		changes_known = constraint_repo->changes(change_serial_, changed_nodes_, changed_edges_);
+		if (constraint_repo->has_constraints())
+			constraint_repo_ = *constraint_repo;
+	} else {
+		changed_nodes_.clear();
+		changed_edges_.clear();
+	}
+	if (used_constraints_ != use_constraints) {
+		used_constraints_ = use_constraints;
+		changes_known     = false;
+	}
+
+	if (++search_stamp_ == 0) {
+		std::fill(blocked_stamps_.begin(), blocked_stamps_.end(), 0);
+		search_stamp_ = 1;
+	}
+
+	last_full_search_  = !initialized_ || (to_index != goal_);
+	last_changed_arcs_ = 0;
+	last_expansions_   = 0;
+	if (last_full_search_) {
+		initialize(from_index, to_index);
+	} else {
+		if (from_index != start_) {
+			// the heuristic is relative to the start, adapt keys of queued nodes
+			km_ += heuristic(from_index);
+			start_ = from_index;
+		}
+		last_changed_arcs_ = update_costs(changes_known);
+	}
+	compute_shortest_path();
+
+	float cost = -1;
+	if (g_[start_] != INF) {
+		const NavGraphSearchGraph &sg = *search_graph_;
+		const unsigned int         num_nodes = sg.num_nodes();
+
+		path.push_back(from);
+		cost = 0.;
+		// follow the cheapest successors, the search tree is free of cycles
+		for (unsigned int node = start_; node != goal_;) {
+			unsigned int best_arc  = 0;
+			float        best_cost = INF;
+			for (unsigned int a = sg.arc_offsets_[node]; a < sg.arc_offsets_[node + 1]; ++a) {
+				const float c = arc_cost(a) + g_[sg.arc_targets_[a]];
+				if (c < best_cost) {
+					best_cost = c;
+					best_arc  = a;
+				}
+			}
+			if (best_cost == INF || path.size() > num_nodes) {
+				path.clear();
+				cost = -1;
+				break;
+			}
+			cost += arc_costs_[best_arc];
+			node = sg.arc_targets_[best_arc];
+			path.push_back(graph_->nodes()[node]);
+		}
+	}
+
+	if (use_constraints)
+		constraint_repo.unlock();
+	constraint_repo_ = NULL;
+
+	last_duration_ = Time() - &start_time;
+	return NavGraphPath(graph_, path, cost);
+}
+
+/** Get duration of the last search.
+ * This includes the evaluation of the constraints.
+ * @return duration of the last call to search_path() in seconds
+ */
+float
+NavGraphIncrementalSearch::last_duration() const
+{
+	return last_duration_;
+}
+
+/** Check if the last search was a full search.
+ * @return true if the last search started from scratch, false if the
+ * search tree of the previous search was repaired
+ */
+bool
+NavGraphIncrementalSearch::last_full_search() const
+{
+	return last_full_search_;
+}
+
+/** Get number of arcs whose cost changed for the last search.
+ * @return number of arcs whose cost changed since the previous search,
+ * zero for a full search
+ */
+unsigned int
+NavGraphIncrementalSearch::last_changed_arcs() const
+{
+	return last_changed_arcs_;
+}
+
+/** Get number of node expansions of the last search.
+ * @return number of nodes taken from the open list during the last search
+ */
+unsigned int
+NavGraphIncrementalSearch::last_expansions() const
+{
+	return last_expansions_;
+}
+
+/** Discard search tree and start a new search.
+ * @param start index of the start node
+ * @param goal index of the goal node
+ */
+void
+NavGraphIncrementalSearch::initialize(unsigned int start, unsigned int goal)
+{
+	const unsigned int num_nodes = search_graph_->num_nodes();
+
+	start_ = start;
+	goal_  = goal;
+	km_    = 0.;
+	g_.assign(num_nodes, INF);
+	rhs_.assign(num_nodes, INF);
+	open_.assign(num_nodes, false);
+	open_k1_.resize(num_nodes);
+	open_k2_.resize(num_nodes);
+	heap_.clear();
+
+	const unsigned int num_arcs = search_graph_->num_arcs();
+	arc_costs_.resize(num_arcs);
+	if (blocked_stamps_.size() != num_nodes) {
+		blocked_stamps_.assign(num_nodes, 0);
+		blocked_.resize(num_nodes);
+	}
+	arc_known_.assign(num_arcs, false);
+	known_arcs_.clear();
+
+	rhs_[goal_] = 0.;
+	update_vertex(goal_);
+	initialized_ = true;
+}
+
+/** Re-evaluate arcs and repair nodes affected by changes.
+ * Only arcs whose cost has been read by previous searches are
+ * evaluated, the search tree does not depend on other arcs.
+ * @param changes_known true if the changed nodes and edges reported by
+ * the constraint repository are complete, false to re-evaluate all arcs
+ * @return number of arcs whose costs changed
+ */
+unsigned int
+NavGraphIncrementalSearch::update_costs(bool changes_known)
+{
+	const NavGraphSearchGraph &sg = *search_graph_;
+
+	changed_arcs_.clear();
+	if (changes_known) {
+		unsigned int n;
+		for (const std::string &node : changed_nodes_) {
+			if (!sg.node_index(node, n))
+				continue;
+			for (unsigned int i = sg.in_arc_offsets_[n]; i < sg.in_arc_offsets_[n + 1]; ++i) {
+				update_arc(sg.in_arcs_[i]);
+			}
+		}
+		unsigned int from, to;
+		for (const std::pair<std::string, std::string> &edge : changed_edges_) {
+			if (!sg.node_index(edge.first, from) || !sg.node_index(edge.second, to))
+				continue;
+			for (unsigned int a = sg.arc_offsets_[from]; a < sg.arc_offsets_[from + 1]; ++a) {
+				if (sg.arc_targets_[a] == to)
+					update_arc(a);
+			}
+			for (unsigned int a = sg.arc_offsets_[to]; a < sg.arc_offsets_[to + 1]; ++a) {
+				if (sg.arc_targets_[a] == from)
+					update_arc(a);
+			}
+		}
+	} else {
+		for (unsigned int a : known_arcs_) {
+			update_arc(a);
+		}
+	}
+
+	// only update after all arcs have been evaluated, updating
+	// may read further arcs which then become known
+	for (unsigned int a : changed_arcs_) {
+		const unsigned int u = sg.arc_sources_[a];
+		update_rhs(u);
+		update_vertex(u);
+	}
+	return changed_arcs_.size();
+}
+
+/** Re-evaluate the cost of an arc.
+ * Arcs which have not been read yet are skipped, the arc is recorded
+ * as changed if its cost differs.
+ * @param arc index of the arc
+ */
+void
+NavGraphIncrementalSearch::update_arc(unsigned int arc)
+{
+	if (!arc_known_[arc])
+		return;
+
+	const float cost = evaluate_arc(arc);
+	if (cost != arc_costs_[arc]) {
+		arc_costs_[arc] = cost;
+		changed_arcs_.push_back(arc);
+	}
+}
+
+/** Get cost of an arc.
+ * The cost is evaluated when the arc is read for the first time.
+ * @param arc index of the arc
+ * @return cost of the arc, infinity if the arc is blocked
+ */
+float
+NavGraphIncrementalSearch::arc_cost(unsigned int arc)
+{
+	if (!arc_known_[arc]) {
+		arc_known_[arc] = true;
+		arc_costs_[arc] = evaluate_arc(arc);
+		known_arcs_.push_back(arc);
+	}
+	return arc_costs_[arc];
+}
+
+/** Evaluate cost of an arc under the current constraints.
+ * @param arc index of the arc
+ * @return cost of the arc, infinity if the arc is blocked
+ */
+float
+NavGraphIncrementalSearch::evaluate_arc(unsigned int arc)
+{
+	const NavGraphSearchGraph &      sg    = *search_graph_;
+	const std::vector<NavGraphNode> &nodes = graph_->nodes();
+	const unsigned int               u     = sg.arc_sources_[arc];
+	const unsigned int               v     = sg.arc_targets_[arc];
+
+	if (constraint_repo_ && (node_blocked(v) || constraint_repo_->blocks(nodes[u], nodes[v]))) {
+		return INF;
+	}
+
+	float cost = default_search_ ? sg.arc_costs_[arc] : graph_->cost(nodes[u], nodes[v]);
+	if (constraint_repo_) {
+		float cost_factor = 0.;
+		if (constraint_repo_->increases_cost(nodes[u], nodes[v], cost_factor)) {
+			cost *= cost_factor;
+		}
+	}
+	return cost;
+}
+
+/** Check if a node is blocked by a constraint.
+ * The result is determined once per search.
+ * @param node index of the node to check
+ * @return true if the node is blocked, false otherwise
+ */
+bool
+NavGraphIncrementalSearch::node_blocked(unsigned int node)
+{
+	if (blocked_stamps_[node] != search_stamp_) {
+		blocked_stamps_[node] = search_stamp_;
+		blocked_[node]        = (constraint_repo_->blocks(graph_->nodes()[node]) != NULL);
+	}
+	return blocked_[node];
+}
+
+/** Recalculate the one-step lookahead cost of a node.
+ * @param node index of the node
+ */
+void
+NavGraphIncrementalSearch::update_rhs(unsigned int node)
+{
+	if (node == goal_)
+		return;
+
+	const NavGraphSearchGraph &sg  = *search_graph_;
+	float                      rhs = INF;
+	for (unsigned int a = sg.arc_offsets_[node]; a < sg.arc_offsets_[node + 1]; ++a) {
+		rhs = std::min(rhs, arc_cost(a) + g_[sg.arc_targets_[a]]);
+	}
+	rhs_[node] = rhs;
+}
+
+/** Update open list entry of a node.
+ * The node is queued if it is inconsistent and removed otherwise.
+ * @param node index of the node
+ */
+void
+NavGraphIncrementalSearch::update_vertex(unsigned int node)
+{
+	if (g_[node] != rhs_[node]) {
+		const heap_entry_t k = key(node);
+		if (open_[node] && (open_k1_[node] == k.k1) && (open_k2_[node] == k.k2))
+			return;
+
+		open_[node]    = true;
+		open_k1_[node] = k.k1;
+		open_k2_[node] = k.k2;
+		heap_.push_back(k);
+		std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+		if (heap_.size() > 4 * open_.size() + 64)
+			compact_heap();
+	} else {
+		open_[node] = false;
+	}
+}
+
+/** Expand inconsistent nodes until the start node is consistent. */
+void
+NavGraphIncrementalSearch::compute_shortest_path()
+{
+	const NavGraphSearchGraph &sg = *search_graph_;
+
+	heap_entry_t top_entry;
+	while (top(top_entry) && (heap_greater(key(start_), top_entry) || (rhs_[start_] != g_[start_]))) {
+		std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+		heap_.pop_back();
+		const unsigned int node  = top_entry.node;
+		const heap_entry_t k_new = key(node);
+		open_[node]              = false;
+		++last_expansions_;
+
+		if (heap_greater(k_new, top_entry)) {
+			// key outdated by a change of the start node, re-queue
+			update_vertex(node);
+		} else if (g_[node] > rhs_[node]) {
+			g_[node] = rhs_[node];
+			for (unsigned int i = sg.in_arc_offsets_[node]; i < sg.in_arc_offsets_[node + 1]; ++i) {
+				const unsigned int a    = sg.in_arcs_[i];
+				const unsigned int pred = sg.arc_sources_[a];
+				if (pred != goal_) {
+					rhs_[pred] = std::min(rhs_[pred], arc_cost(a) + g_[node]);
+				}
+				update_vertex(pred);
+			}
+		} else {
+			const float g_old = g_[node];
+			g_[node]          = INF;
+			for (unsigned int i = sg.in_arc_offsets_[node]; i < sg.in_arc_offsets_[node + 1]; ++i) {
+				const unsigned int a    = sg.in_arcs_[i];
+				const unsigned int pred = sg.arc_sources_[a];
+				if (rhs_[pred] == arc_cost(a) + g_old) {
+					update_rhs(pred);
+				}
+				update_vertex(pred);
+			}
+			update_rhs(node);
+			update_vertex(node);
+		}
+	}
+}
+
+/** Get heuristic cost between the start node and a node.
+ * @param node index of the node
+ * @return straight line distance to the start node, zero if custom search
+ * functions are used
+ */
+float
+NavGraphIncrementalSearch::heuristic(unsigned int node) const
+{
+	if (!default_search_)
+		return 0.;
+
+	const NavGraphSearchGraph &sg = *search_graph_;
+	return sqrtf(powf(sg.x_[start_] - sg.x_[node], 2) + powf(sg.y_[start_] - sg.y_[node], 2));
+}
+
+/** Calculate open list key of a node.
+ * @param node index of the node
+ * @return open list entry for the node with its current key
+ */
+NavGraphIncrementalSearch::heap_entry_t
+NavGraphIncrementalSearch::key(unsigned int node) const
+{
+	const float min_g = std::min(g_[node], rhs_[node]);
+	return {min_g + heuristic(node) + km_, min_g, node};
+}
+
+/** Get top entry of the open list.
+ * Outdated entries are discarded.
+ * @param entry upon return contains the top entry
+ * @return true if an entry was returned, false if the open list is empty
+ */
+bool
+NavGraphIncrementalSearch::top(heap_entry_t &entry)
+{
+	while (!heap_.empty()) {
+		entry = heap_.front();
+		if (open_[entry.node] && (open_k1_[entry.node] == entry.k1)
+		    && (open_k2_[entry.node] == entry.k2)) {
+			return true;
+		}
+		std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+		heap_.pop_back();
+	}
+	return false;
+}
+
+/** Compare open list entries.
+ * @param a first entry
+ * @param b second entry
+ * @return true if the key of @p a is greater than the key of @p b
+ */
+bool
+NavGraphIncrementalSearch::heap_greater(const heap_entry_t &a, const heap_entry_t &b)
+{
+	return (a.k1 > b.k1) || ((a.k1 == b.k1) && (a.k2 > b.k2));
+}
+
+/** Remove outdated entries from the open list. */
+void
+NavGraphIncrementalSearch::compact_heap()
+{
+	heap_.clear();
+	for (unsigned int n = 0; n < open_.size(); ++n) {
+		if (open_[n])
+			heap_.push_back({open_k1_[n], open_k2_[n], n});
+	}
+	std::make_heap(heap_.begin(), heap_.end(), heap_greater);
+}
+
+} // end of namespace fawkes
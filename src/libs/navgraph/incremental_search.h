@@ -0,0 +1,128 @@
+/***************************************************************************
+ *  incremental_search.h - Incremental path search under changing constraints
+ *
+ *  Created: Sun Oct 18 14:37:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_INCREMENTAL_SEARCH_H_
+#define _LIBS_NAVGRAPH_INCREMENTAL_SEARCH_H_
+
+#include <navgraph/navgraph.h>
+#include <navgraph/navgraph_path.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphConstraintRepo;
+class NavGraphSearchGraph;
+
+class NavGraphIncrementalSearch : public NavGraph::ChangeListener
+{
+public:
+	NavGraphIncrementalSearch(NavGraph *graph);
+	virtual ~NavGraphIncrementalSearch();
+
+	NavGraphPath search_path(const NavGraphNode &from,
+	                         const NavGraphNode &to,
+	                         bool                use_constraints     = true,
+	                         bool                compute_constraints = true);
+
+	void reset();
+
+	float        last_duration() const;
+	bool         last_full_search() const;
+	unsigned int last_changed_arcs() const;
+	unsigned int last_expansions() const;
+
+	virtual void graph_changed() throw();
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		float        k1;
+		float        k2;
+		unsigned int node;
+	} heap_entry_t;
+	/// @endcond
+
+	void         initialize(unsigned int start, unsigned int goal);
+	unsigned int update_costs(bool changes_known);
+	void         update_arc(unsigned int arc);
+	float        arc_cost(unsigned int arc);
+	float        evaluate_arc(unsigned int arc);
+	bool         node_blocked(unsigned int node);
+	void         update_rhs(unsigned int node);
+	void         update_vertex(unsigned int node);
+	void         compute_shortest_path();
+	float        heuristic(unsigned int node) const;
+	heap_entry_t key(unsigned int node) const;
+	bool         top(heap_entry_t &entry);
+	void         compact_heap();
+
+	static bool heap_greater(const heap_entry_t &a, const heap_entry_t &b);
+
+	NavGraph *                           graph_;
+	bool                                 graph_changed_;
+	std::unique_ptr<NavGraphSearchGraph> search_graph_;
+	bool                                 default_search_;
+
+	bool         initialized_;
+	unsigned int start_;
+	unsigned int goal_;
+	float        km_;
+
+	std::vector<float> g_;
+	std::vector<float> rhs_;
+
+	// arc costs are evaluated when the search first reads them, afterwards
+	// only if the constraints report a change, node blocks once per search
+	NavGraphConstraintRepo *  constraint_repo_;
+	bool                      used_constraints_;
+	unsigned int              change_serial_;
+	unsigned int              search_stamp_;
+	std::vector<float>        arc_costs_;
+	std::vector<bool>         arc_known_;
+	std::vector<unsigned int> known_arcs_;
+	std::vector<unsigned int> changed_arcs_;
+	std::vector<unsigned int> blocked_stamps_;
+	std::vector<bool>         blocked_;
+
+	std::vector<std::string>                         changed_nodes_;
+	std::vector<std::pair<std::string, std::string>> changed_edges_;
+
+	// open list with lazy deletion, entries are only valid if they match the
+	// stored key of an open node
+	std::vector<heap_entry_t> heap_;
+	std::vector<bool>         open_;
+	std::vector<float>        open_k1_;
+	std::vector<float>        open_k2_;
+
+	float        last_duration_;
+	bool         last_full_search_;
+	unsigned int last_changed_arcs_;
+	unsigned int last_expansions_;
+};
+
+} // end of namespace fawkes
+
+#endif
@@ -21,11 +21,15 @@
  */
 
 #include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/navgraph.h>
+#include <navgraph/path_cache.h>
+#include <navgraph/search_graph.h>
 #include <navgraph/search_state.h>
+#include <navgraph/spatial_index.h>
 #include <utils/math/common.h>
-#include <utils/search/astar.h>
 
 #include <Eigen/Geometry>
 #include <algorithm>
@@ -72,6 +76,8 @@ NavGraph::NavGraph(const std::string &graph_name)
 	search_cost_func_      = NavGraphSearchState::euclidean_cost;
 	reachability_calced_   = false;
 	notifications_enabled_ = true;
+	search_mutex_          = new Mutex();
+	spatial_index_mutex_   = new Mutex();
 }
 
 /** Copy constructor.
@@ -88,11 +94,17 @@ NavGraph::NavGraph(const NavGraph &g)
 	nodes_ = g.nodes_;
 	edges_.clear();
 	edges_ = g.edges_;
+
+	search_mutex_        = new Mutex();
+	spatial_index_mutex_ = new Mutex();
 }
 
-/** Virtual empty destructor. */
+/** Virtual destructor. */
 NavGraph::~NavGraph()
 {
+	path_cache_.reset();
+	delete search_mutex_;
+	delete spatial_index_mutex_;
 }
 
 /** Assign/copy structures from another graph.
@@ -112,6 +124,9 @@ NavGraph::operator=(const NavGraph &g)
 	edges_.clear();
 	edges_ = g.edges_;
 
+	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 
 	return *this;
@@ -250,29 +265,16 @@ NavGraph::closest_node(float              pos_x,
                        bool               consider_unconnected,
                        const std::string &property) const
 {
-	std::vector<NavGraphNode> nodes = search_nodes(property);
-
-	float min_dist = std::numeric_limits<float>::max();
-
-	std::vector<NavGraphNode>::iterator i;
-	std::vector<NavGraphNode>::iterator elem = nodes.end();
-	for (i = nodes.begin(); i != nodes.end(); ++i) {
-		if (!consider_unconnected && i->unconnected())
-			continue;
-
-		float dx   = i->x() - pos_x;
-		float dy   = i->y() - pos_y;
-		float dist = sqrtf(dx * dx + dy * dy);
-		if (sqrtf(dx * dx + dy * dy) < min_dist) {
-			min_dist = dist;
-			elem     = i;
-		}
-	}
+	int closest =
+	  spatial_index()->closest_node(pos_x, pos_y, [&](const NavGraphNode &n) {
+		  return (consider_unconnected || !n.unconnected())
+		         && (property == "" || n.has_property(property));
+	  });
 
-	if (elem == nodes.end()) {
+	if (closest < 0) {
 		return NavGraphNode();
 	} else {
-		return *elem;
+		return nodes_[closest];
 	}
 }
 
@@ -291,30 +293,17 @@ NavGraph::closest_node_to(const std::string &node_name,
                           bool               consider_unconnected,
                           const std::string &property) const
 {
-	NavGraphNode              n     = node(node_name);
-	std::vector<NavGraphNode> nodes = search_nodes(property);
-
-	float min_dist = std::numeric_limits<float>::max();
-
-	std::vector<NavGraphNode>::iterator i;
-	std::vector<NavGraphNode>::iterator elem = nodes.begin();
-	for (i = nodes.begin(); i != nodes.end(); ++i) {
-		if (!consider_unconnected && i->unconnected())
-			continue;
+	NavGraphNode n = node(node_name);
 
-		float dx   = i->x() - n.x();
-		float dy   = i->y() - n.y();
-		float dist = sqrtf(dx * dx + dy * dy);
-		if ((sqrtf(dx * dx + dy * dy) < min_dist) && (i->name() != node_name)) {
-			min_dist = dist;
-			elem     = i;
-		}
-	}
+	int closest = spatial_index()->closest_node(n.x(), n.y(), [&](const NavGraphNode &c) {
+		return (consider_unconnected || !c.unconnected())
+		       && (property == "" || c.has_property(property)) && (c.name() != node_name);
+	});
 
-	if (elem == nodes.end()) {
+	if (closest < 0) {
 		return NavGraphNode();
 	} else {
-		return *elem;
+		return nodes_[closest];
 	}
 }
 
@@ -352,30 +341,13 @@ NavGraph::edge(const std::string &from, const std::string &to) const
 NavGraphEdge
 NavGraph::closest_edge(float pos_x, float pos_y) const
 {
-	float min_dist = std::numeric_limits<float>::max();
-
-	NavGraphEdge rv;
-
-	Eigen::Vector2f point(pos_x, pos_y);
-	for (const NavGraphEdge &edge : edges_) {
-		const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
-		const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
-		const Eigen::Vector2f direction(target - origin);
-		const Eigen::Vector2f direction_norm = direction.normalized();
-		const Eigen::Vector2f diff           = point - origin;
-		const float           t              = direction.dot(diff) / direction.squaredNorm();
-
-		if (t >= 0.0 && t <= 1.0) {
-			// projection of the point onto the edge is within the line segment
-			float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
-			if (distance < min_dist) {
-				min_dist = distance;
-				rv       = edge;
-			}
-		}
-	}
+	int closest = spatial_index()->closest_edge(pos_x, pos_y);
 
-	return rv;
+	if (closest < 0) {
+		return NavGraphEdge();
+	} else {
+		return edges_[closest];
+	}
 }
 
 /** Search nodes for given property.
@@ -465,6 +437,9 @@ NavGraph::add_node(const NavGraphNode &node)
 		nodes_.push_back(node);
 		apply_default_properties(nodes_.back());
 		reachability_calced_ = false;
+		search_graph_.reset();
+		if (spatial_index_)
+			spatial_index_->add_node(nodes_.size() - 1);
 		notify_of_change();
 	}
 }
@@ -597,10 +572,13 @@ NavGraph::add_edge(const NavGraphEdge &edge, NavGraph::EdgeMode mode, bool allow
 		case EDGE_FORCE:
 			edges_.push_back(edge);
 			edges_.back().set_nodes(node(edge.from()), node(edge.to()));
+			if (spatial_index_)
+				spatial_index_->add_edge(edges_.size() - 1);
 			break;
 		}
 
 		reachability_calced_ = false;
+		search_graph_.reset();
 		notify_of_change();
 	}
 }
@@ -619,6 +597,8 @@ NavGraph::remove_node(const NavGraphNode &node)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 }
 
@@ -641,6 +621,8 @@ NavGraph::remove_node(const std::string &node_name)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 }
 
@@ -685,6 +667,8 @@ NavGraph::remove_edge(const NavGraphEdge &edge)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 }
 
@@ -704,6 +688,8 @@ NavGraph::remove_edge(const std::string &from, const std::string &to)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 }
 
@@ -718,6 +704,9 @@ NavGraph::update_node(const NavGraphNode &node)
 	std::vector<NavGraphNode>::iterator n = std::find(nodes_.begin(), nodes_.end(), node);
 	if (n != nodes_.end()) {
 		*n = node;
+		search_graph_.reset();
+		spatial_index_.reset();
+		notify_of_change();
 	} else {
 		throw Exception("No node with name %s known", node.name().c_str());
 	}
@@ -735,6 +724,10 @@ NavGraph::update_edge(const NavGraphEdge &edge)
 	std::vector<NavGraphEdge>::iterator e = std::find(edges_.begin(), edges_.end(), edge);
 	if (e != edges_.end()) {
 		*e = edge;
+		reachability_calced_ = false;
+		search_graph_.reset();
+		spatial_index_.reset();
+		notify_of_change();
 	} else {
 		throw Exception("No edge from %s to %s is known", edge.from().c_str(), edge.to().c_str());
 	}
@@ -749,6 +742,9 @@ NavGraph::clear()
 	nodes_.clear();
 	edges_.clear();
 	default_properties_.clear();
+	reachability_calced_ = false;
+	search_graph_.reset();
+	spatial_index_.reset();
 	notify_of_change();
 }
 
@@ -956,6 +952,9 @@ NavGraph::unset_search_funcs()
  * distance between nodes. The cost is the sum of costs of all edges
  * along the way from one node to another. The estimate is the straight line
  * distance from any given node to the goal node (which is provably admissible).
+ * If the path cache is enabled and current, the default search functions
+ * are used, and there are no constraints (or they are not used), paths
+ * from the cache's source nodes are taken from the cache.
  * @param from node to search from
  * @param to goal node
  * @param use_constraints true to respect constraints imposed by the constraint
@@ -973,6 +972,10 @@ NavGraph::search_path(const NavGraphNode &from,
                       bool                use_constraints,
                       bool                compute_constraints)
 {
+	NavGraphPath path;
+	if (path_cache_ && search_path_cached(from, to, use_constraints, path))
+		return path;
+
 	return search_path(
 	  from, to, search_estimate_func_, search_cost_func_, use_constraints, compute_constraints);
 }
@@ -985,6 +988,7 @@ NavGraph::search_path(const NavGraphNode &from,
  * distance between nodes. The cost is the sum of costs of all edges
  * along the way from one node to another. The estimate is the straight line
  * distance from any given node to the goal node (which is provably admissible).
+ * Paths may be taken from the path cache as for the search by node.
  * @param from name of node to search from
  * @param to name of the goal node
  * @param use_constraints true to respect constraints imposed by the constraint
@@ -1002,8 +1006,9 @@ NavGraph::search_path(const std::string &from,
                       bool               use_constraints,
                       bool               compute_constraints)
 {
-	return search_path(
-	  from, to, search_estimate_func_, search_cost_func_, use_constraints, compute_constraints);
+	NavGraphNode from_node(node(from));
+	NavGraphNode to_node(node(to));
+	return search_path(from_node, to_node, use_constraints, compute_constraints);
 }
 
 /** Search for a path between two nodes.
@@ -1045,7 +1050,8 @@ NavGraph::search_path(const std::string &        from,
 
 /** Search for a path between two nodes.
  * This function executes an A* search to find an (optimal) path
- * from node @p from to node @p to.
+ * from node @p from to node @p to. Concurrent searches are run one
+ * after another, as they share the search state.
  * @param from node to search from
  * @param to goal node
  * @param estimate_func function to estimate the cost from any node to the goal.
@@ -1074,41 +1080,160 @@ NavGraph::search_path(const NavGraphNode &       from,
                       bool                       use_constraints,
                       bool                       compute_constraints)
 {
+	// the constraint repository is locked before the search, callers
+	// may already hold it, e.g. to replan after constraints changed
+	MutexLocker             constraints_lock(constraint_repo_.objmutex_ptr(), use_constraints);
+	NavGraphConstraintRepo *constraint_repo = NULL;
+	if (use_constraints) {
+		if (compute_constraints && constraint_repo_->has_constraints()) {
+			constraint_repo_->compute();
+		}
+		if (constraint_repo_->has_constraints())
+			constraint_repo = *constraint_repo_;
+	}
+
+	MutexLocker lock(search_mutex_);
 	if (!reachability_calced_)
 		calc_reachability(/* allow multi graph */ true);
+	if (!search_graph_)
+		search_graph_.reset(new NavGraphSearchGraph(nodes_, edges_));
+
+	std::vector<fawkes::NavGraphNode> path;
+	unsigned int                      from_index, to_index;
+	if (!search_graph_->node_index(from.name(), from_index)
+	    || !search_graph_->node_index(to.name(), to_index)) {
+		return NavGraphPath(this, path, -1);
+	}
 
-	AStar astar;
+	std::vector<unsigned int> path_indexes;
+	float                     cost = search_graph_->search(
+	  from_index, to_index, estimate_func, cost_func, constraint_repo, path_indexes);
 
-	std::vector<AStarState *> a_star_solution;
+	path.resize(path_indexes.size());
+	for (unsigned int i = 0; i < path_indexes.size(); ++i) {
+		path[i] = (i == 0) ? from : nodes_[path_indexes[i]];
+	}
 
+	return NavGraphPath(this, path, cost);
+}
+
+/** Get cached path.
+ * @param from node to search from
+ * @param to goal node
+ * @param use_constraints true if constraints are to be respected
+ * @param path upon return contains the path if it was found in the cache
+ * @return true if the path was found in the cache, false to search
+ */
+bool
+NavGraph::search_path_cached(const NavGraphNode &from,
+                             const NavGraphNode &to,
+                             bool                use_constraints,
+                             NavGraphPath &      path)
+{
+	if (!search_default_funcs_)
+		return false;
 	if (use_constraints) {
 		constraint_repo_.lock();
-		if (compute_constraints && constraint_repo_->has_constraints()) {
-			constraint_repo_->compute();
-		}
-
-		NavGraphSearchState *initial_state =
-		  new NavGraphSearchState(from, to, this, estimate_func, cost_func, *constraint_repo_);
-		a_star_solution = astar.solve(initial_state);
+		bool has_constraints = constraint_repo_->has_constraints();
 		constraint_repo_.unlock();
-	} else {
-		NavGraphSearchState *initial_state =
-		  new NavGraphSearchState(from, to, this, estimate_func, cost_func);
-		a_star_solution = astar.solve(initial_state);
+		if (has_constraints)
+			return false;
 	}
 
-	std::vector<fawkes::NavGraphNode> path(a_star_solution.size());
-	NavGraphSearchState *             solstate;
-	for (unsigned int i = 0; i < a_star_solution.size(); ++i) {
-		solstate = dynamic_cast<NavGraphSearchState *>(a_star_solution[i]);
-		path[i]  = solstate->node();
+	MutexLocker lock(search_mutex_);
+	if (!reachability_calced_)
+		calc_reachability(/* allow multi graph */ true);
+	if (!search_graph_)
+		search_graph_.reset(new NavGraphSearchGraph(nodes_, edges_));
+
+	unsigned int              from_index, to_index;
+	std::vector<unsigned int> path_indexes;
+	float                     cost;
+	if (!search_graph_->node_index(from.name(), from_index)
+	    || !search_graph_->node_index(to.name(), to_index)
+	    || !path_cache_->path(from_index, to_index, path_indexes, cost)) {
+		return false;
 	}
 
-	float cost = (!a_star_solution.empty())
-	               ? a_star_solution[a_star_solution.size() - 1]->total_estimated_cost
-	               : -1;
+	std::vector<fawkes::NavGraphNode> path_nodes(path_indexes.size());
+	for (unsigned int i = 0; i < path_indexes.size(); ++i) {
+		path_nodes[i] = (i == 0) ? from : nodes_[path_indexes[i]];
+	}
+	path = NavGraphPath(this, path_nodes, cost);
+	return true;
+}
+
+/** Search for the costs of paths between many nodes.
+ * This determines the cost of the cheapest path from each node in
+ * @p from to each node in @p to, for example to allocate tasks to
+ * robots. This is considerably faster than a search_path() call for
+ * each pair of nodes, as all costs from a node are determined by a
+ * single search. Costs from the path cache's source nodes are taken
+ * from the cache under the same conditions as for search_path().
+ * The current cost function is used, the estimate function is not
+ * needed.
+ * @param from names of the nodes to search from
+ * @param to names of the goal nodes
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return cost matrix, the cost from from[i] to to[j] is at [i][j], it
+ * is -1 if there is no path or one of the nodes does not exist
+ */
+std::vector<std::vector<float>>
+NavGraph::search_costs(const std::vector<std::string> &from,
+                       const std::vector<std::string> &to,
+                       bool                            use_constraints,
+                       bool                            compute_constraints)
+{
+	// locked in the same order as in search_path()
+	MutexLocker             constraints_lock(constraint_repo_.objmutex_ptr(), use_constraints);
+	NavGraphConstraintRepo *constraint_repo = NULL;
+	if (use_constraints) {
+		if (constraint_repo_->has_constraints()) {
+			if (compute_constraints)
+				constraint_repo_->compute();
+			constraint_repo = *constraint_repo_;
+		}
+	}
 
-	return NavGraphPath(this, path, cost);
+	MutexLocker lock(search_mutex_);
+	if (!reachability_calced_)
+		calc_reachability(/* allow multi graph */ true);
+	if (!search_graph_)
+		search_graph_.reset(new NavGraphSearchGraph(nodes_, edges_));
+
+	std::vector<std::vector<float>> costs(from.size(), std::vector<float>(to.size(), -1.));
+
+	std::vector<int> to_indexes(to.size(), -1);
+	for (unsigned int j = 0; j < to.size(); ++j) {
+		unsigned int to_index;
+		if (search_graph_->node_index(to[j], to_index))
+			to_indexes[j] = to_index;
+	}
+
+	const bool use_cache = path_cache_ && search_default_funcs_ && !constraint_repo;
+
+	std::vector<float>        tree_costs;
+	std::vector<unsigned int> tree_parents;
+	for (unsigned int i = 0; i < from.size(); ++i) {
+		unsigned int from_index;
+		if (!search_graph_->node_index(from[i], from_index))
+			continue;
+
+		if (!use_cache || !path_cache_->costs(from_index, tree_costs)) {
+			search_graph_->search_tree(
+			  from_index, search_cost_func_, constraint_repo, tree_costs, tree_parents);
+		}
+		for (unsigned int j = 0; j < to.size(); ++j) {
+			if (to_indexes[j] >= 0)
+				costs[i][j] = tree_costs[to_indexes[j]];
+		}
+	}
+
+	return costs;
 }
 
 /** Calculate cost between two adjacent nodes.
@@ -1125,6 +1250,69 @@ NavGraph::cost(const NavGraphNode &from, const NavGraphNode &to) const
 	return search_cost_func_(from, to);
 }
 
+/** Enable path cache.
+ * The cheapest paths from the given source nodes to all other nodes are
+ * then computed in the background and re-computed after the graph
+ * changes. Afterwards search_path() and search_costs() take paths from
+ * these nodes from the cache if the default search functions are used
+ * and there are no constraints, or they are ignored. Otherwise, or while
+ * the cache is computed, they search as usual. Enabling the cache again
+ * replaces the previous one.
+ * @param sources names of the nodes to cache paths from, for example
+ * stations of a fleet of robots. If empty, paths are cached from all
+ * nodes, which takes about eight bytes of memory for each pair of nodes.
+ * @see NavGraphPathCache
+ */
+void
+NavGraph::enable_path_cache(const std::vector<std::string> &sources)
+{
+	path_cache_.reset(new NavGraphPathCache(this, sources));
+	path_cache_->update();
+}
+
+/** Disable path cache. */
+void
+NavGraph::disable_path_cache()
+{
+	path_cache_.reset();
+}
+
+/** Check if the path cache can be used.
+ * @return true if the path cache is enabled and has been computed for
+ * the current graph, false otherwise
+ */
+bool
+NavGraph::path_cache_ready() const
+{
+	return path_cache_ && path_cache_->ready();
+}
+
+/** Wait until the path cache has been computed for the current graph.
+ * Returns immediately if the path cache is not enabled.
+ */
+void
+NavGraph::wait_path_cache_ready()
+{
+	if (path_cache_)
+		path_cache_->wait_ready();
+}
+
+/** Get spatial index, create it if necessary.
+ * Concurrent readers may call this, the index is built only once. Its
+ * queries do not modify it, and only the modifying methods, which must
+ * not run concurrently to readers anyway, reset it.
+ * @return spatial index over the current nodes and edges
+ */
+NavGraphSpatialIndex *
+NavGraph::spatial_index() const
+{
+	MutexLocker lock(spatial_index_mutex_);
+	if (!spatial_index_ || spatial_index_->needs_rebuild()) {
+		spatial_index_.reset(new NavGraphSpatialIndex(nodes_, edges_));
+	}
+	return spatial_index_.get();
+}
+
 /** Make sure each node in the edges exists. */
 void
 NavGraph::assert_valid_edges()
@@ -1423,6 +1611,7 @@ NavGraph::calc_reachability(bool allow_multi_graph)
 	for (e = edges_.begin(); e != edges_.end(); ++e) {
 		e->set_nodes(node(e->from()), node(e->to()));
 	}
+	spatial_index_.reset();
 
 	if (!allow_multi_graph)
 		assert_connected();
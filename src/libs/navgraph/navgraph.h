@@ -30,6 +30,7 @@
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -44,7 +45,11 @@ typedef std::function<float(const fawkes::NavGraphNode &, const fawkes::NavGraph
 extern const char *PROP_ORIENTATION;
 } // namespace navgraph
 
+class Mutex;
 class NavGraphConstraintRepo;
+class NavGraphPathCache;
+class NavGraphSearchGraph;
+class NavGraphSpatialIndex;
 
 class NavGraph
 {
@@ -146,6 +151,12 @@ public:
 	                                 bool                       use_constraints     = true,
 	                                 bool                       compute_constraints = true);
 
+	std::vector<std::vector<float>>
+	search_costs(const std::vector<std::string> &from,
+	             const std::vector<std::string> &to,
+	             bool                            use_constraints     = true,
+	             bool                            compute_constraints = true);
+
 	void add_node(const NavGraphNode &node);
 	void add_node_and_connect(const NavGraphNode &node, ConnectionMode conn_mode);
 	void connect_node_to_closest_node(const NavGraphNode &n);
@@ -201,6 +212,11 @@ public:
 
 	float cost(const NavGraphNode &from, const NavGraphNode &to) const;
 
+	void enable_path_cache(const std::vector<std::string> &sources = std::vector<std::string>());
+	void disable_path_cache();
+	bool path_cache_ready() const;
+	void wait_path_cache_ready();
+
 	static std::string format_name(const char *format, ...);
 	std::string        gen_unique_name(const char *prefix = "U-");
 
@@ -210,6 +226,13 @@ private:
 	void edge_add_no_intersection(const NavGraphEdge &edge);
 	void edge_add_split_intersection(const NavGraphEdge &edge);
 
+	NavGraphSpatialIndex *spatial_index() const;
+
+	bool search_path_cached(const NavGraphNode &from,
+	                        const NavGraphNode &to,
+	                        bool                use_constraints,
+	                        NavGraphPath &      path);
+
 private:
 	std::string                             graph_name_;
 	std::vector<NavGraphNode>               nodes_;
@@ -224,6 +247,12 @@ private:
 
 	bool reachability_calced_;
 
+	std::unique_ptr<NavGraphSearchGraph>          search_graph_;
+	Mutex *                                       search_mutex_;
+	mutable std::unique_ptr<NavGraphSpatialIndex> spatial_index_;
+	mutable Mutex *                               spatial_index_mutex_;
+	std::unique_ptr<NavGraphPathCache>            path_cache_;
+
 	bool notifications_enabled_;
 };
 
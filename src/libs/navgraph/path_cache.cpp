@@ -0,0 +1,318 @@
+/***************************************************************************
+ *  path_cache.cpp - Precomputed paths from a set of source nodes
+ *
+ *  Created: Sun Oct 18 16:12:43 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <navgraph/path_cache.h>
+#include <navgraph/search_graph.h>
+#include <navgraph/search_state.h>
+
+#include <algorithm>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+class NavGraphPathCacheThread : public Thread
+{
+public:
+	NavGraphPathCacheThread(NavGraphPathCache *cache)
+	: Thread("NavGraphPathCacheThread", Thread::OPMODE_WAITFORWAKEUP), cache_(cache)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		CancelState old_cancel_state;
+		set_cancel_state(CANCEL_DISABLED, &old_cancel_state);
+		cache_->compute();
+		set_cancel_state(old_cancel_state);
+	}
+
+private:
+	NavGraphPathCache *cache_;
+};
+/// @endcond
+
+/** @class NavGraphPathCache <navgraph/path_cache.h>
+ * Precomputed paths from a set of source nodes.
+ * Applications like a fleet manager ask for many paths and path costs
+ * between the same few stations. This cache computes the cheapest paths
+ * from each source node to all other nodes with a single search per
+ * source. Paths and costs from a source node can then be looked up
+ * without searching. If no sources are given, paths are computed from
+ * all nodes, i.e. for all pairs of nodes. Memory usage is about eight
+ * bytes per node and source.
+ *
+ * The paths are computed for the default euclidean costs and without
+ * constraints. The computation runs in a background thread on a copy of
+ * the graph. It is started by update(), which happens automatically on
+ * lookups while the cache is outdated. Lookups fail until the
+ * computation has finished, the caller then searches directly. Once the
+ * graph changes, the cache is outdated, including while a computation is
+ * running. NavGraph uses the cache in NavGraph::search_path() and
+ * NavGraph::search_costs(), cf. NavGraph::enable_path_cache().
+ *
+ * The graph must outlive this instance. Methods other than ready() and
+ * wait_ready() must not be called concurrently to graph modifications.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * The cache is outdated on construction, call update() to start computing.
+ * @param graph graph to compute paths for, must outlive this instance
+ * @param sources names of the nodes to compute paths from, empty to
+ * compute paths from all nodes
+ */
+NavGraphPathCache::NavGraphPathCache(NavGraph *graph, const std::vector<std::string> &sources)
+: graph_(graph), sources_(sources), serial_(1), requested_serial_(0), job_serial_(0)
+{
+	mutex_      = new Mutex();
+	ready_cond_ = new WaitCondition(mutex_);
+
+	graph_->add_change_listener(this);
+
+	thread_ = new NavGraphPathCacheThread(this);
+	thread_->start();
+}
+
+/** Destructor. */
+NavGraphPathCache::~NavGraphPathCache()
+{
+	graph_->remove_change_listener(this);
+
+	// let a running computation stop early
+	mutex_->lock();
+	++serial_;
+	mutex_->unlock();
+
+	thread_->cancel();
+	thread_->join();
+	delete thread_;
+
+	delete ready_cond_;
+	delete mutex_;
+}
+
+/** Get source nodes.
+ * @return names of the nodes to compute paths from, empty for all nodes
+ */
+const std::vector<std::string> &
+NavGraphPathCache::sources() const
+{
+	return sources_;
+}
+
+/** Start computation if the cache is outdated.
+ * The graph is copied and the paths are then computed in the background.
+ * Calling this while the cache is current or a computation for the
+ * current graph is running has no effect.
+ */
+void
+NavGraphPathCache::update()
+{
+	MutexLocker lock(mutex_);
+	if ((result_ && (result_->serial == serial_)) || (requested_serial_ == serial_))
+		return;
+
+	job_.reset(new NavGraphSearchGraph(graph_->nodes(), graph_->edges()));
+	job_serial_       = serial_;
+	requested_serial_ = serial_;
+
+	job_sources_.clear();
+	if (sources_.empty()) {
+		for (unsigned int i = 0; i < job_->num_nodes(); ++i) {
+			job_sources_.push_back(i);
+		}
+	} else {
+		for (const std::string &s : sources_) {
+			unsigned int index;
+			if (job_->node_index(s, index))
+				job_sources_.push_back(index);
+		}
+		std::sort(job_sources_.begin(), job_sources_.end());
+		job_sources_.erase(std::unique(job_sources_.begin(), job_sources_.end()), job_sources_.end());
+	}
+	lock.unlock();
+
+	thread_->wakeup();
+}
+
+/** Check if the cache is current.
+ * @return true if the paths for the current graph have been computed
+ */
+bool
+NavGraphPathCache::ready() const
+{
+	MutexLocker lock(mutex_);
+	return result_ && (result_->serial == serial_);
+}
+
+/** Compute paths and wait until the cache is current. */
+void
+NavGraphPathCache::wait_ready()
+{
+	update();
+	MutexLocker lock(mutex_);
+	while (!result_ || (result_->serial != serial_)) {
+		ready_cond_->wait();
+	}
+}
+
+/** Get cached path.
+ * @param from index of the start node in the graph's node vector
+ * @param to index of the goal node in the graph's node vector
+ * @param path upon return contains the indexes of the nodes along the
+ * path, empty if there is no path
+ * @param cost upon return contains the cost of the path, -1 if there is
+ * no path
+ * @return true if the path was found in the cache, false if the cache is
+ * outdated or @p from is not a source node
+ */
+bool
+NavGraphPathCache::path(unsigned int               from,
+                        unsigned int               to,
+                        std::vector<unsigned int> &path,
+                        float &                    cost)
+{
+	int                             row;
+	std::shared_ptr<const result_t> result = current_result(from, row);
+	if (!result || (to >= result->costs[row].size()))
+		return false;
+
+	path.clear();
+	cost = result->costs[row][to];
+	if (cost < 0.)
+		return true;
+
+	const std::vector<unsigned int> &parents = result->parents[row];
+	for (unsigned int n = to; n != from; n = parents[n]) {
+		path.push_back(n);
+	}
+	path.push_back(from);
+	std::reverse(path.begin(), path.end());
+	return true;
+}
+
+/** Get cached costs of the paths from a node to all nodes.
+ * @param from index of the start node in the graph's node vector
+ * @param costs upon return contains the cost of the path to each node,
+ * indexed like the graph's node vector, -1 if there is no path
+ * @return true if the costs were found in the cache, false if the cache is
+ * outdated or @p from is not a source node
+ */
+bool
+NavGraphPathCache::costs(unsigned int from, std::vector<float> &costs)
+{
+	int                             row;
+	std::shared_ptr<const result_t> result = current_result(from, row);
+	if (!result)
+		return false;
+
+	costs = result->costs[row];
+	return true;
+}
+
+/** Get current result with the row of a node.
+ * Starts the computation if the cache is outdated.
+ * @param from index of the node
+ * @param row upon return contains the row of @p from in the result
+ * @return result, NULL if the cache is outdated or @p from is not a source
+ */
+std::shared_ptr<const NavGraphPathCache::result_t>
+NavGraphPathCache::current_result(unsigned int from, int &row)
+{
+	std::shared_ptr<const result_t> result;
+	mutex_->lock();
+	if (result_ && (result_->serial == serial_))
+		result = result_;
+	mutex_->unlock();
+
+	if (!result) {
+		update();
+		return result;
+	}
+	if ((from >= result->rows.size()) || (result->rows[from] < 0))
+		return std::shared_ptr<const result_t>();
+
+	row = result->rows[from];
+	return result;
+}
+
+/** Compute paths for the last update() request.
+ * Called from the background thread.
+ */
+void
+NavGraphPathCache::compute()
+{
+	mutex_->lock();
+	std::shared_ptr<NavGraphSearchGraph> search_graph = job_;
+	unsigned int                         serial       = job_serial_;
+	std::vector<unsigned int>            sources;
+	job_.reset();
+	sources.swap(job_sources_);
+	mutex_->unlock();
+
+	if (!search_graph)
+		return;
+
+	std::shared_ptr<result_t> result(new result_t());
+	result->serial = serial;
+	result->rows.resize(search_graph->num_nodes(), -1);
+	result->costs.resize(sources.size());
+	result->parents.resize(sources.size());
+	for (unsigned int i = 0; i < sources.size(); ++i) {
+		// stop early if the graph has changed meanwhile
+		mutex_->lock();
+		bool outdated = (serial_ != serial);
+		mutex_->unlock();
+		if (outdated)
+			return;
+
+		// default costs without constraints, the nodes of the graph are not accessed
+		search_graph->search_tree(sources[i],
+		                          NavGraphSearchState::euclidean_cost,
+		                          NULL,
+		                          result->costs[i],
+		                          result->parents[i]);
+		result->rows[sources[i]] = i;
+	}
+
+	MutexLocker lock(mutex_);
+	if (serial_ == serial) {
+		result_ = result;
+		ready_cond_->wake_all();
+	}
+}
+
+/** Mark cache as outdated.
+ * The paths are computed again on the next update() or lookup.
+ */
+void
+NavGraphPathCache::graph_changed() throw()
+{
+	MutexLocker lock(mutex_);
+	++serial_;
+}
+
+} // end of namespace fawkes
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *  path_cache.h - Precomputed paths from a set of source nodes
+ *
+ *  Created: Sun Oct 18 16:12:43 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_PATH_CACHE_H_
+#define _LIBS_NAVGRAPH_PATH_CACHE_H_
+
+#include <navgraph/navgraph.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+class NavGraphSearchGraph;
+class NavGraphPathCacheThread;
+
+class NavGraphPathCache : public NavGraph::ChangeListener
+{
+	friend class NavGraphPathCacheThread;
+
+public:
+	NavGraphPathCache(NavGraph *graph, const std::vector<std::string> &sources);
+	virtual ~NavGraphPathCache();
+
+	const std::vector<std::string> &sources() const;
+
+	void update();
+	bool ready() const;
+	void wait_ready();
+
+	bool path(unsigned int from, unsigned int to, std::vector<unsigned int> &path, float &cost);
+	bool costs(unsigned int from, std::vector<float> &costs);
+
+	virtual void graph_changed() throw();
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		unsigned int                           serial;
+		std::vector<int>                       rows;
+		std::vector<std::vector<float>>        costs;
+		std::vector<std::vector<unsigned int>> parents;
+	} result_t;
+	/// @endcond
+
+	void                            compute();
+	std::shared_ptr<const result_t> current_result(unsigned int from, int &row);
+
+	NavGraph *               graph_;
+	std::vector<std::string> sources_;
+
+	NavGraphPathCacheThread *thread_;
+	Mutex *                  mutex_;
+	WaitCondition *          ready_cond_;
+
+	// the graph is copied to a search graph of its own on update() which
+	// the background thread then searches from each source node
+	unsigned int                         serial_;
+	unsigned int                         requested_serial_;
+	std::shared_ptr<NavGraphSearchGraph> job_;
+	unsigned int                         job_serial_;
+	std::vector<unsigned int>            job_sources_;
+	std::shared_ptr<const result_t>      result_;
+};
+
+} // end of namespace fawkes
+
+#endif
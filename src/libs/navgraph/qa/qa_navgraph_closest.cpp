@@ -0,0 +1,248 @@
+
+/***************************************************************************
+ *  qa_navgraph_closest.cpp - QA and benchmark for closest node/edge queries
+ *
+ *  Created: Sun Oct 18 12:04:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/yaml_navgraph.h>
+#include <utils/time/time.h>
+
+#include <Eigen/Geometry>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+using namespace fawkes;
+
+#define NUM_QUERIES 2000
+#define NUM_READERS 8
+#define NUM_ROUNDS 20
+
+// Closest node by linear scan in graph order
+static std::string
+linear_closest_node(NavGraph *graph, float x, float y, const std::string &property)
+{
+	float       min_dist = std::numeric_limits<float>::max();
+	std::string rv;
+	for (const NavGraphNode &n : graph->nodes()) {
+		if (n.unconnected() || (property != "" && !n.has_property(property)))
+			continue;
+		float dx = n.x() - x;
+		float dy = n.y() - y;
+		if (sqrtf(dx * dx + dy * dy) < min_dist) {
+			min_dist = sqrtf(dx * dx + dy * dy);
+			rv       = n.name();
+		}
+	}
+	return rv;
+}
+
+// Closest edge by linear scan in graph order
+static NavGraphEdge
+linear_closest_edge(NavGraph *graph, float x, float y)
+{
+	float           min_dist = std::numeric_limits<float>::max();
+	NavGraphEdge    rv;
+	Eigen::Vector2f point(x, y);
+	for (const NavGraphEdge &edge : graph->edges()) {
+		const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
+		const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
+		const Eigen::Vector2f direction(target - origin);
+		const Eigen::Vector2f direction_norm = direction.normalized();
+		const Eigen::Vector2f diff           = point - origin;
+		const float           t              = direction.dot(diff) / direction.squaredNorm();
+		if (t >= 0.0 && t <= 1.0) {
+			float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
+			if (distance < min_dist) {
+				min_dist = distance;
+				rv       = edge;
+			}
+		}
+	}
+	return rv;
+}
+
+int
+main(int argc, char **argv)
+{
+	NavGraph *graph;
+	try {
+		if (argc > 1) {
+			graph = load_yaml_navgraph(argv[1], /* allow multi graph */ true);
+		} else {
+			// shelf rows as generated by navgraph-generator, nodes added one by
+			// one to also exercise incremental index updates
+			graph = new NavGraph("warehouse");
+			graph->closest_node(0, 0);
+			for (unsigned int a = 0; a < 70; ++a) {
+				for (unsigned int r = 0; r < 72; ++r) {
+					NavGraphNode n(NavGraph::format_name("A%u-R%u", a, r),
+					               a * 2.5 + (rand() % 100) / 500.,
+					               r * 1.0 + (rand() % 100) / 500.);
+					if (rand() % 10 == 0)
+						n.set_property("shelf", true);
+					graph->add_node(n);
+					if (r > 0) {
+						graph->add_edge(NavGraphEdge(NavGraph::format_name("A%u-R%u", a, r - 1), n.name()),
+						                NavGraph::EDGE_FORCE);
+					}
+					if ((a > 0) && (r % 6 == 0)) {
+						graph->add_edge(NavGraphEdge(NavGraph::format_name("A%u-R%u", a - 1, r), n.name()),
+						                NavGraph::EDGE_FORCE);
+					}
+				}
+			}
+		}
+	} catch (Exception &e) {
+		printf("Failed to load graph: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+
+	printf("Graph '%s': %zu nodes, %zu edges\n",
+	       graph->name().c_str(),
+	       graph->nodes().size(),
+	       graph->edges().size());
+
+	float min_x = std::numeric_limits<float>::max(), max_x = -std::numeric_limits<float>::max();
+	float min_y = std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+	for (const NavGraphNode &n : graph->nodes()) {
+		min_x = std::min(min_x, n.x());
+		max_x = std::max(max_x, n.x());
+		min_y = std::min(min_y, n.y());
+		max_y = std::max(max_y, n.y());
+	}
+	std::vector<std::pair<float, float>> points;
+	for (unsigned int i = 0; i < NUM_QUERIES; ++i) {
+		// include points around the graph
+		float x = min_x - 10 + (max_x - min_x + 20) * (rand() / (float)RAND_MAX);
+		float y = min_y - 10 + (max_y - min_y + 20) * (rand() / (float)RAND_MAX);
+		points.push_back(std::make_pair(x, y));
+	}
+
+	unsigned int errors = 0;
+
+	const std::string properties[] = {"", "shelf"};
+	for (const std::string &property : properties) {
+		std::vector<std::string> expected(points.size());
+		Time                     start;
+		for (size_t i = 0; i < points.size(); ++i) {
+			expected[i] = linear_closest_node(graph, points[i].first, points[i].second, property);
+		}
+		Time   end;
+		double linear_us = (end - &start) * 1000000. / points.size();
+
+		std::vector<NavGraphNode> nodes(points.size());
+		start.stamp();
+		for (size_t i = 0; i < points.size(); ++i) {
+			nodes[i] = graph->closest_node(points[i].first, points[i].second, property);
+		}
+		end.stamp();
+		double index_us = (end - &start) * 1000000. / points.size();
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			if (nodes[i].name() != expected[i]) {
+				printf("  closest node (%f,%f): got %s, expected %s\n",
+				       points[i].first,
+				       points[i].second,
+				       nodes[i].name().c_str(),
+				       expected[i].c_str());
+				++errors;
+			}
+		}
+		printf("closest node %-9s linear %8.2f us  indexed %8.2f us\n",
+		       property != "" ? "(shelf):" : "(any):",
+		       linear_us,
+		       index_us);
+	}
+
+	std::vector<NavGraphEdge> expected_edges(points.size());
+	Time                      start;
+	for (size_t i = 0; i < points.size(); ++i) {
+		expected_edges[i] = linear_closest_edge(graph, points[i].first, points[i].second);
+	}
+	Time   end;
+	double linear_us = (end - &start) * 1000000. / points.size();
+
+	std::vector<NavGraphEdge> edges(points.size());
+	start.stamp();
+	for (size_t i = 0; i < points.size(); ++i) {
+		edges[i] = graph->closest_edge(points[i].first, points[i].second);
+	}
+	end.stamp();
+	double index_us = (end - &start) * 1000000. / points.size();
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		if (edges[i].from() != expected_edges[i].from() || edges[i].to() != expected_edges[i].to()) {
+			printf("  closest edge (%f,%f): got %s-%s, expected %s-%s\n",
+			       points[i].first,
+			       points[i].second,
+			       edges[i].from().c_str(),
+			       edges[i].to().c_str(),
+			       expected_edges[i].from().c_str(),
+			       expected_edges[i].to().c_str());
+			++errors;
+		}
+	}
+	printf("closest edge:        linear %8.2f us  indexed %8.2f us\n", linear_us, index_us);
+
+	// concurrent readers, the first query of each round builds the index
+	std::atomic<unsigned int> reader_errors(0);
+	for (unsigned int round = 0; round < NUM_ROUNDS; ++round) {
+		NavGraphNode moved = graph->nodes()[rand() % graph->nodes().size()];
+		moved.set_x(moved.x() + 0.01);
+		graph->update_node(moved);
+
+		std::vector<std::string> expected(points.size());
+		for (size_t i = 0; i < points.size(); ++i) {
+			expected[i] = linear_closest_node(graph, points[i].first, points[i].second, "");
+		}
+
+		std::vector<std::thread> readers;
+		for (unsigned int r = 0; r < NUM_READERS; ++r) {
+			readers.push_back(std::thread([&graph, &points, &expected, &reader_errors]() {
+				for (size_t i = 0; i < points.size(); ++i) {
+					if (graph->closest_node(points[i].first, points[i].second).name() != expected[i]) {
+						++reader_errors;
+					}
+				}
+			}));
+		}
+		for (std::thread &t : readers) {
+			t.join();
+		}
+	}
+	if (reader_errors > 0) {
+		printf("  concurrent readers: %u wrong closest nodes\n", reader_errors.load());
+		errors += reader_errors;
+	}
+	printf("closest node: %u concurrent readers in %u rounds\n", NUM_READERS, NUM_ROUNDS);
+
+	delete graph;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,200 @@
+
+/***************************************************************************
+ *  qa_navgraph_incremental.cpp - QA and benchmark for incremental replanning
+ *
+ *  Created: Sun Oct 18 15:26:08 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/constraints/static_list_edge_cost_constraint.h>
+#include <navgraph/constraints/static_list_node_constraint.h>
+#include <navgraph/incremental_search.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/yaml_navgraph.h>
+#include <utils/time/time.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace fawkes;
+
+#define NUM_EPISODES 50
+#define NUM_CHANGES 3
+#define MAX_COST_EDGES 100
+#define MOVE_EVERY 10
+
+// Warehouse-like graph as in qa_navgraph_search
+static NavGraph *
+generate_warehouse(unsigned int aisles, unsigned int rows, unsigned int cross_every)
+{
+	NavGraph *graph = new NavGraph("warehouse");
+	graph->set_notifications_enabled(false);
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			float x = a * 2.5 + (rand() % 100) / 500.;
+			float y = r * 1.0 + (rand() % 100) / 500.;
+			graph->add_node(NavGraphNode(NavGraph::format_name("A%u-R%u", a, r), x, y));
+		}
+	}
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			std::string n = NavGraph::format_name("A%u-R%u", a, r);
+			if (r + 1 < rows) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a, r + 1)),
+				                NavGraph::EDGE_FORCE);
+			}
+			if ((a + 1 < aisles) && (r % cross_every == 0)) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a + 1, r)),
+				                NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph->set_notifications_enabled(true);
+	return graph;
+}
+
+static bool
+path_valid(NavGraph *graph, const NavGraphPath &path)
+{
+	for (size_t i = 1; i < path.size(); ++i) {
+		if (!graph->edge_exists(path.nodes()[i - 1].name(), path.nodes()[i].name()))
+			return false;
+	}
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	NavGraph *graph;
+	try {
+		if (argc > 1) {
+			graph = load_yaml_navgraph(argv[1], /* allow multi graph */ true);
+		} else {
+			graph = generate_warehouse(70, 72, 6);
+		}
+	} catch (Exception &e) {
+		printf("Failed to load graph: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+	graph->calc_reachability(/* allow multi graph */ true);
+
+	const std::vector<NavGraphNode> &nodes = graph->nodes();
+	const std::vector<NavGraphEdge> &edges = graph->edges();
+	printf("Graph '%s': %zu nodes, %zu edges\n",
+	       graph->name().c_str(),
+	       nodes.size(),
+	       edges.size());
+
+	NavGraphStaticListNodeConstraint *blocked = new NavGraphStaticListNodeConstraint("qa-blocked");
+	NavGraphStaticListEdgeCostConstraint *costs =
+	  new NavGraphStaticListEdgeCostConstraint("qa-costs");
+	for (size_t i = 0; i < nodes.size() / 50; ++i) {
+		blocked->add_node(nodes[rand() % nodes.size()]);
+	}
+	graph->constraint_repo()->register_constraint(blocked);
+	graph->constraint_repo()->register_constraint(costs);
+
+	NavGraphIncrementalSearch *incremental = new NavGraphIncrementalSearch(graph);
+
+	unsigned int errors = 0, replans = 0, full_searches = 0, steps = 0;
+	double       full_s = 0., incremental_s = 0., incremental_full_s = 0.;
+	for (unsigned int e = 0; e < NUM_EPISODES; ++e) {
+		NavGraphNode current = nodes[rand() % nodes.size()];
+		NavGraphNode goal    = nodes[rand() % nodes.size()];
+
+		// move along the path towards the goal while constraints change
+		while (current.name() != goal.name()) {
+			Time         start;
+			NavGraphPath expected = graph->search_path(current, goal);
+			Time         end;
+			NavGraphPath path = incremental->search_path(current, goal);
+
+			if (path.empty() != expected.empty()
+			    || fabsf(path.cost() - expected.cost()) > 1e-3 * fabsf(expected.cost())
+			    || !path_valid(graph, path)) {
+				printf("  %s -> %s: cost %f, expected %f\n",
+				       current.name().c_str(),
+				       goal.name().c_str(),
+				       path.cost(),
+				       expected.cost());
+				++errors;
+			}
+
+			if (incremental->last_full_search()) {
+				incremental_full_s += incremental->last_duration();
+				++full_searches;
+			} else {
+				full_s += end - &start;
+				incremental_s += incremental->last_duration();
+				++replans;
+			}
+
+			if (path.size() < 2)
+				break;
+			current = path.nodes()[1];
+
+			// move some blocked nodes and expensive edges, like reservations of other robots
+			for (unsigned int c = 0; c < NUM_CHANGES; ++c) {
+				const NavGraphNode &n = nodes[rand() % nodes.size()];
+				if (n.name() != current.name() && n.name() != goal.name() && !blocked->has_node(n)) {
+					blocked->remove_node(blocked->node_list().front());
+					blocked->add_node(n);
+				}
+				const NavGraphEdge &edge = edges[rand() % edges.size()];
+				if (costs->edge_cost_list().size() >= MAX_COST_EDGES) {
+					costs->remove_edge(costs->edge_cost_list().front().first);
+				}
+				if (!costs->has_edge(edge)) {
+					costs->add_edge(edge, 1.5 + (rand() % 100) / 40.);
+				}
+			}
+
+			// shift a node now and then, e.g. when editing the graph at run-time
+			if (++steps % MOVE_EVERY == 0) {
+				NavGraphNode moved = nodes[rand() % nodes.size()];
+				moved.set_x(moved.x() + ((rand() % 100) - 50) / 100.);
+				graph->update_node(moved);
+				current = graph->node(current.name());
+				goal    = graph->node(goal.name());
+			}
+		}
+	}
+
+	printf("replans: %u  full search %8.3f ms  incremental %8.3f ms  (%u initial searches, %.3f ms)\n",
+	       replans,
+	       replans > 0 ? full_s * 1000. / replans : 0.,
+	       replans > 0 ? incremental_s * 1000. / replans : 0.,
+	       full_searches,
+	       full_searches > 0 ? incremental_full_s * 1000. / full_searches : 0.);
+
+	graph->constraint_repo()->unregister_constraint("qa-blocked");
+	graph->constraint_repo()->unregister_constraint("qa-costs");
+	delete incremental;
+	delete blocked;
+	delete costs;
+	delete graph;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
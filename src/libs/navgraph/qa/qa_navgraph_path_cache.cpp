@@ -0,0 +1,245 @@
+
+/***************************************************************************
+ *  qa_navgraph_path_cache.cpp - QA and benchmark for the path cache
+ *
+ *  Created: Sun Oct 18 17:02:19 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/constraints/static_list_node_constraint.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/search_state.h>
+#include <navgraph/yaml_navgraph.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace fawkes;
+
+#define NUM_STATIONS 20
+
+// Warehouse-like graph as in qa_navgraph_search
+static NavGraph *
+generate_warehouse(unsigned int aisles, unsigned int rows, unsigned int cross_every)
+{
+	NavGraph *graph = new NavGraph("warehouse");
+	graph->set_notifications_enabled(false);
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			float x = a * 2.5 + (rand() % 100) / 500.;
+			float y = r * 1.0 + (rand() % 100) / 500.;
+			graph->add_node(NavGraphNode(NavGraph::format_name("A%u-R%u", a, r), x, y));
+		}
+	}
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			std::string n = NavGraph::format_name("A%u-R%u", a, r);
+			if (r + 1 < rows) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a, r + 1)),
+				                NavGraph::EDGE_FORCE);
+			}
+			if ((a + 1 < aisles) && (r % cross_every == 0)) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a + 1, r)),
+				                NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph->set_notifications_enabled(true);
+	return graph;
+}
+
+static bool
+same_cost(float cost, float expected)
+{
+	return fabsf(cost - expected) <= 1e-3 * fabsf(expected) + 1e-4;
+}
+
+// Search all pairs of stations, optionally comparing to expected costs
+static double
+search_all(NavGraph *                             graph,
+           const std::vector<std::string> &       stations,
+           bool                                   live,
+           std::vector<std::vector<float>> &      costs,
+           const std::vector<std::vector<float>> *expected,
+           unsigned int &                         errors)
+{
+	std::vector<NavGraphPath> paths;
+	Time                      start;
+	for (size_t i = 0; i < stations.size(); ++i) {
+		for (size_t j = 0; j < stations.size(); ++j) {
+			if (live) {
+				// custom search functions bypass the path cache
+				paths.push_back(graph->search_path(stations[i],
+				                                   stations[j],
+				                                   NavGraphSearchState::straight_line_estimate,
+				                                   NavGraphSearchState::euclidean_cost));
+			} else {
+				paths.push_back(graph->search_path(stations[i], stations[j]));
+			}
+		}
+	}
+	Time end;
+
+	costs.assign(stations.size(), std::vector<float>(stations.size(), -1.));
+	for (size_t i = 0; i < stations.size(); ++i) {
+		for (size_t j = 0; j < stations.size(); ++j) {
+			const NavGraphPath &path = paths[i * stations.size() + j];
+			costs[i][j]              = path.cost();
+
+			bool valid = path.empty() || (path.nodes().front().name() == stations[i]
+			                              && path.nodes().back().name() == stations[j]);
+			for (size_t k = 1; k < path.size(); ++k) {
+				if (!graph->edge_exists(path.nodes()[k - 1].name(), path.nodes()[k].name()))
+					valid = false;
+			}
+			if (!valid || (expected && !same_cost(costs[i][j], (*expected)[i][j]))) {
+				printf("  %s -> %s: cost %f, expected %f%s\n",
+				       stations[i].c_str(),
+				       stations[j].c_str(),
+				       costs[i][j],
+				       expected ? (*expected)[i][j] : 0.,
+				       valid ? "" : " (invalid path)");
+				++errors;
+			}
+		}
+	}
+	return (end - &start) * 1000.;
+}
+
+static double
+search_batch(NavGraph *                             graph,
+             const std::vector<std::string> &       stations,
+             const std::vector<std::vector<float>> &expected,
+             unsigned int &                         errors)
+{
+	Time                            start;
+	std::vector<std::vector<float>> costs = graph->search_costs(stations, stations);
+	Time                            end;
+	for (size_t i = 0; i < stations.size(); ++i) {
+		for (size_t j = 0; j < stations.size(); ++j) {
+			if (!same_cost(costs[i][j], expected[i][j])) {
+				printf("  batch %s -> %s: cost %f, expected %f\n",
+				       stations[i].c_str(),
+				       stations[j].c_str(),
+				       costs[i][j],
+				       expected[i][j]);
+				++errors;
+			}
+		}
+	}
+	return (end - &start) * 1000.;
+}
+
+int
+main(int argc, char **argv)
+{
+	NavGraph *graph;
+	try {
+		if (argc > 1) {
+			graph = load_yaml_navgraph(argv[1], /* allow multi graph */ true);
+		} else {
+			graph = generate_warehouse(70, 72, 6);
+		}
+	} catch (Exception &e) {
+		printf("Failed to load graph: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+	graph->calc_reachability(/* allow multi graph */ true);
+
+	const std::vector<NavGraphNode> &nodes = graph->nodes();
+	printf("Graph '%s': %zu nodes, %zu edges\n",
+	       graph->name().c_str(),
+	       nodes.size(),
+	       graph->edges().size());
+
+	std::vector<std::string> stations;
+	for (unsigned int i = 0; i < NUM_STATIONS; ++i) {
+		stations.push_back(nodes[rand() % nodes.size()].name());
+	}
+
+	unsigned int                    errors = 0;
+	std::vector<std::vector<float>> expected, costs;
+
+	double live_ms  = search_all(graph, stations, true, expected, NULL, errors);
+	double batch_ms = search_batch(graph, stations, expected, errors);
+
+	Time start;
+	graph->enable_path_cache(stations);
+	graph->wait_path_cache_ready();
+	Time   end;
+	double compute_ms = (end - &start) * 1000.;
+
+	double cached_ms       = search_all(graph, stations, false, costs, &expected, errors);
+	double batch_cached_ms = search_batch(graph, stations, expected, errors);
+
+	printf("%u x %u stations: search %8.3f ms  cached %8.3f ms\n",
+	       NUM_STATIONS,
+	       NUM_STATIONS,
+	       live_ms,
+	       cached_ms);
+	printf("%u x %u stations: batch  %8.3f ms  cached %8.3f ms  (cache computed in %.3f ms)\n",
+	       NUM_STATIONS,
+	       NUM_STATIONS,
+	       batch_ms,
+	       batch_cached_ms,
+	       compute_ms);
+
+	// constraints fall back to searching
+	NavGraphStaticListNodeConstraint *blocked = new NavGraphStaticListNodeConstraint("qa-blocked");
+	for (size_t i = 0; i < nodes.size() / 20; ++i) {
+		const NavGraphNode &n = nodes[rand() % nodes.size()];
+		if (std::find(stations.begin(), stations.end(), n.name()) == stations.end()) {
+			blocked->add_node(n);
+		}
+	}
+	graph->constraint_repo()->register_constraint(blocked);
+	search_all(graph, stations, true, expected, NULL, errors);
+	search_all(graph, stations, false, costs, &expected, errors);
+	search_batch(graph, stations, expected, errors);
+	graph->constraint_repo()->unregister_constraint("qa-blocked");
+	delete blocked;
+
+	// shortcut between two stations, the cache is outdated until re-computed
+	std::string shortcut = stations[0] + "-" + stations[1];
+	graph->add_node(NavGraphNode(shortcut,
+	                             (nodes[0].x() + nodes[nodes.size() - 1].x()) / 2.,
+	                             (nodes[0].y() + nodes[nodes.size() - 1].y()) / 2.));
+	graph->add_edge(NavGraphEdge(stations[0], shortcut), NavGraph::EDGE_FORCE);
+	graph->add_edge(NavGraphEdge(shortcut, stations[1]), NavGraph::EDGE_FORCE);
+	if (graph->path_cache_ready()) {
+		printf("  path cache not outdated after graph change\n");
+		++errors;
+	}
+	search_all(graph, stations, true, expected, NULL, errors);
+	search_all(graph, stations, false, costs, &expected, errors);
+	graph->wait_path_cache_ready();
+	search_all(graph, stations, false, costs, &expected, errors);
+	search_batch(graph, stations, expected, errors);
+
+	delete graph;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,264 @@
+
+/***************************************************************************
+ *  qa_navgraph_search.cpp - QA and benchmark for NavGraph path search
+ *
+ *  Created: Sun Oct 18 10:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/constraints/static_list_node_constraint.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/search_state.h>
+#include <navgraph/yaml_navgraph.h>
+#include <utils/search/astar.h>
+#include <utils/time/time.h>
+
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define NUM_QUERIES 200
+#define NUM_SEARCHERS 8
+#define NUM_ROUNDS 10
+#define TIMEOUT_SEC 60
+
+// Warehouse-like graph: long aisles along Y, connected by cross aisles
+// every few rows, like the output of navgraph-generator for shelf rows.
+static NavGraph *
+generate_warehouse(unsigned int aisles, unsigned int rows, unsigned int cross_every)
+{
+	NavGraph *graph = new NavGraph("warehouse");
+	graph->set_notifications_enabled(false);
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			float x = a * 2.5 + (rand() % 100) / 500.;
+			float y = r * 1.0 + (rand() % 100) / 500.;
+			graph->add_node(NavGraphNode(NavGraph::format_name("A%u-R%u", a, r), x, y));
+		}
+	}
+	for (unsigned int a = 0; a < aisles; ++a) {
+		for (unsigned int r = 0; r < rows; ++r) {
+			std::string n = NavGraph::format_name("A%u-R%u", a, r);
+			if (r + 1 < rows) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a, r + 1)),
+				                NavGraph::EDGE_FORCE);
+			}
+			if ((a + 1 < aisles) && (r % cross_every == 0)) {
+				graph->add_edge(NavGraphEdge(n, NavGraph::format_name("A%u-R%u", a + 1, r)),
+				                NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph->set_notifications_enabled(true);
+	return graph;
+}
+
+// Path search as done before the compiled search graph
+static NavGraphPath
+legacy_search_path(NavGraph *graph, const NavGraphNode &from, const NavGraphNode &to, bool use_c)
+{
+	AStar                           astar;
+	LockPtr<NavGraphConstraintRepo> repo = graph->constraint_repo();
+	std::vector<AStarState *>       solution =
+	  astar.solve(new NavGraphSearchState(from, to, graph, use_c ? *repo : NULL));
+
+	std::vector<NavGraphNode> path(solution.size());
+	for (unsigned int i = 0; i < solution.size(); ++i) {
+		path[i] = dynamic_cast<NavGraphSearchState *>(solution[i])->node();
+	}
+	float cost = (!solution.empty()) ? solution.back()->total_estimated_cost : -1;
+	return NavGraphPath(graph, path, cost);
+}
+
+static bool
+path_valid(NavGraph *graph, const NavGraphPath &path)
+{
+	for (size_t i = 1; i < path.size(); ++i) {
+		if (!graph->edge_exists(path.nodes()[i - 1].name(), path.nodes()[i].name()))
+			return false;
+	}
+	return true;
+}
+
+static void
+timeout_handler(int signum)
+{
+	const char *msg = "Timeout, concurrent searches did not finish\nQA FAILED\n";
+	if (write(STDOUT_FILENO, msg, strlen(msg)) < 0) {
+		// exiting anyway
+	}
+	_exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	NavGraph *graph;
+	try {
+		if (argc > 1) {
+			graph = load_yaml_navgraph(argv[1], /* allow multi graph */ true);
+		} else {
+			graph = generate_warehouse(70, 72, 6);
+		}
+	} catch (Exception &e) {
+		printf("Failed to load graph: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+	graph->calc_reachability(/* allow multi graph */ true);
+
+	const std::vector<NavGraphNode> &nodes = graph->nodes();
+	printf("Graph '%s': %zu nodes, %zu edges\n",
+	       graph->name().c_str(),
+	       nodes.size(),
+	       graph->edges().size());
+
+	std::vector<std::pair<NavGraphNode, NavGraphNode>> queries;
+	for (unsigned int i = 0; i < NUM_QUERIES; ++i) {
+		queries.push_back(
+		  std::make_pair(nodes[rand() % nodes.size()], nodes[rand() % nodes.size()]));
+	}
+
+	NavGraphStaticListNodeConstraint *constraint =
+	  new NavGraphStaticListNodeConstraint("qa-blocked");
+	for (size_t i = 0; i < nodes.size() / 20; ++i) {
+		constraint->add_node(nodes[rand() % nodes.size()]);
+	}
+
+	unsigned int errors = 0;
+	for (unsigned int use_c = 0; use_c <= 1; ++use_c) {
+		if (use_c) {
+			graph->constraint_repo()->register_constraint(constraint);
+		}
+
+		std::vector<NavGraphPath> expected(queries.size());
+		Time                      start;
+		for (size_t q = 0; q < queries.size(); ++q) {
+			expected[q] = legacy_search_path(graph, queries[q].first, queries[q].second, use_c);
+		}
+		Time   end;
+		double legacy_ms = (end - &start) * 1000. / queries.size();
+
+		// first search builds the search graph
+		start.stamp();
+		graph->search_path(queries[0].first, queries[0].second, use_c);
+		end.stamp();
+		double build_ms = (end - &start) * 1000.;
+
+		std::vector<NavGraphPath> paths(queries.size());
+		start.stamp();
+		for (size_t q = 0; q < queries.size(); ++q) {
+			paths[q] = graph->search_path(queries[q].first, queries[q].second, use_c);
+		}
+		end.stamp();
+		double compiled_ms = (end - &start) * 1000. / queries.size();
+
+		unsigned int found = 0;
+		for (size_t q = 0; q < queries.size(); ++q) {
+			if (paths[q].empty() != expected[q].empty()
+			    || fabsf(paths[q].cost() - expected[q].cost()) > 1e-3 * fabsf(expected[q].cost())
+			    || !path_valid(graph, paths[q])) {
+				printf("  %s -> %s: cost %f, expected %f\n",
+				       queries[q].first.name().c_str(),
+				       queries[q].second.name().c_str(),
+				       paths[q].cost(),
+				       expected[q].cost());
+				++errors;
+			}
+			if (!paths[q].empty())
+				++found;
+		}
+
+		printf("%-21s legacy %8.3f ms  compiled %8.3f ms  (build %.3f ms, %u/%zu paths)\n",
+		       use_c ? "with constraints:" : "without constraints:",
+		       legacy_ms,
+		       compiled_ms,
+		       build_ms,
+		       found,
+		       queries.size());
+	}
+
+	// concurrent searches, the first search of each round builds the search graph,
+	// without constraints nothing else keeps the searches from running in parallel
+	signal(SIGALRM, timeout_handler);
+	alarm(TIMEOUT_SEC);
+	std::vector<std::string> cost_from, cost_to;
+	for (unsigned int i = 0; i < 10; ++i) {
+		cost_from.push_back(queries[i].first.name());
+		cost_to.push_back(queries[i].second.name());
+	}
+	std::atomic<unsigned int> searcher_errors(0);
+	for (unsigned int round = 0; round < NUM_ROUNDS; ++round) {
+		NavGraphNode moved = graph->nodes()[rand() % graph->nodes().size()];
+		moved.set_x(moved.x() + 0.01);
+		graph->update_node(moved);
+
+		std::vector<float> expected(queries.size());
+		for (size_t q = 0; q < queries.size(); ++q) {
+			expected[q] = graph->search_path(queries[q].first, queries[q].second, false).cost();
+		}
+		std::vector<std::vector<float>> expected_costs =
+		  graph->search_costs(cost_from, cost_to, false);
+		// drop the search graph again, the searchers build it concurrently
+		graph->update_node(moved);
+
+		std::vector<std::thread> searchers;
+		for (unsigned int s = 0; s < NUM_SEARCHERS; ++s) {
+			searchers.push_back(std::thread([&, s]() {
+				for (size_t q = s; q < queries.size(); q += 2) {
+					NavGraphPath path =
+					  graph->search_path(queries[q].first, queries[q].second, false);
+					if (fabsf(path.cost() - expected[q]) > 1e-3 * fabsf(expected[q])
+					    || !path_valid(graph, path)) {
+						++searcher_errors;
+					}
+				}
+				if ((s % 2 == 0)
+				    && (graph->search_costs(cost_from, cost_to, false) != expected_costs)) {
+					++searcher_errors;
+				}
+			}));
+		}
+		for (std::thread &t : searchers) {
+			t.join();
+		}
+	}
+	if (searcher_errors > 0) {
+		printf("  concurrent searches: %u wrong paths or costs\n", searcher_errors.load());
+		errors += searcher_errors;
+	}
+	alarm(0);
+	printf("path search: %u concurrent searchers in %u rounds\n", NUM_SEARCHERS, NUM_ROUNDS);
+
+	graph->constraint_repo()->unregister_constraint("qa-blocked");
+	delete constraint;
+	delete graph;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
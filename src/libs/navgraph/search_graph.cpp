@@ -0,0 +1,384 @@
+/***************************************************************************
+ *  search_graph.cpp - Compiled, index-based graph for path search
+ *
+ *  Created: Sun Oct 18 09:12:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/search_graph.h>
+#include <navgraph/search_state.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+typedef float (*search_func_t)(const NavGraphNode &, const NavGraphNode &);
+
+static bool
+is_search_func(const std::function<float(const NavGraphNode &, const NavGraphNode &)> &f,
+               search_func_t                                                         func)
+{
+	const search_func_t *target = f.target<search_func_t>();
+	return target && (*target == func);
+}
+/// @endcond
+
+/** @class NavGraphSearchGraph <navgraph/search_graph.h>
+ * Compiled, index-based graph for path search.
+ * Searching on a NavGraph with the generic AStar allocates a search state
+ * for each expansion, resolves neighbours by node name, and keeps closed
+ * states in a map. This class instead numbers the nodes and stores the
+ * outgoing arcs of all nodes as one compressed sparse row adjacency array
+ * with precomputed euclidean arc costs. A* then runs on flat arrays and a
+ * binary heap which are allocated once and reused for each search.
+ * Incoming arcs are indexed as well for backward searches, for example
+ * by NavGraphIncrementalSearch. search_tree() finds the cheapest paths
+ * from one node to all others, for example for NavGraphPathCache.
+ *
+ * The graph refers to the nodes of the NavGraph it was created from and
+ * must be re-created whenever that graph changes. NavGraph does this
+ * lazily on the next search.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param nodes nodes of the graph, must outlive this instance
+ * @param edges edges of the graph
+ */
+NavGraphSearchGraph::NavGraphSearchGraph(const std::vector<NavGraphNode> &nodes,
+                                         const std::vector<NavGraphEdge> &edges)
+: nodes_(&nodes), search_stamp_(0), constraint_repo_(NULL)
+{
+	const unsigned int num_nodes = nodes.size();
+	x_.resize(num_nodes);
+	y_.resize(num_nodes);
+	node_indexes_.reserve(num_nodes);
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		node_indexes_[nodes[i].name()] = i;
+		x_[i]                          = nodes[i].x();
+		y_[i]                          = nodes[i].y();
+	}
+
+	std::vector<std::pair<unsigned int, unsigned int>> arcs;
+	arcs.reserve(2 * edges.size());
+	for (const NavGraphEdge &e : edges) {
+		unsigned int from, to;
+		if (!node_index(e.from(), from) || !node_index(e.to(), to))
+			continue;
+		arcs.push_back(std::make_pair(from, to));
+		if (!e.is_directed())
+			arcs.push_back(std::make_pair(to, from));
+	}
+	std::sort(arcs.begin(), arcs.end());
+	arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+	arc_offsets_.resize(num_nodes + 1, 0);
+	arc_targets_.resize(arcs.size());
+	arc_costs_.resize(arcs.size());
+	arc_sources_.resize(arcs.size());
+	in_arc_offsets_.resize(num_nodes + 1, 0);
+	for (size_t a = 0; a < arcs.size(); ++a) {
+		arc_offsets_[arcs[a].first + 1] += 1;
+		in_arc_offsets_[arcs[a].second + 1] += 1;
+		arc_sources_[a] = arcs[a].first;
+		arc_targets_[a] = arcs[a].second;
+		arc_costs_[a] =
+		  NavGraphSearchState::euclidean_cost(nodes[arcs[a].first], nodes[arcs[a].second]);
+	}
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		arc_offsets_[i + 1] += arc_offsets_[i];
+		in_arc_offsets_[i + 1] += in_arc_offsets_[i];
+	}
+	in_arcs_.resize(arcs.size());
+	std::vector<unsigned int> in_arc_fill(in_arc_offsets_.begin(), in_arc_offsets_.end() - 1);
+	for (unsigned int a = 0; a < arcs.size(); ++a) {
+		in_arcs_[in_arc_fill[arcs[a].second]++] = a;
+	}
+
+	visited_stamps_.resize(num_nodes, 0);
+	closed_stamps_.resize(num_nodes, 0);
+	blocked_stamps_.resize(num_nodes, 0);
+	blocked_.resize(num_nodes, false);
+	g_.resize(num_nodes);
+	parents_.resize(num_nodes);
+	heap_.reserve(num_nodes);
+}
+
+/** Destructor. */
+NavGraphSearchGraph::~NavGraphSearchGraph()
+{
+}
+
+/** Get number of nodes.
+ * @return number of nodes
+ */
+unsigned int
+NavGraphSearchGraph::num_nodes() const
+{
+	return x_.size();
+}
+
+/** Get number of arcs.
+ * Undirected edges are represented by two arcs.
+ * @return number of directed arcs
+ */
+unsigned int
+NavGraphSearchGraph::num_arcs() const
+{
+	return arc_targets_.size();
+}
+
+/** Get index of a node.
+ * @param name name of the node
+ * @param index upon return contains the index of the node
+ * @return true if the node exists, false otherwise
+ */
+bool
+NavGraphSearchGraph::node_index(const std::string &name, unsigned int &index) const
+{
+	std::unordered_map<std::string, unsigned int>::const_iterator n = node_indexes_.find(name);
+	if (n == node_indexes_.end())
+		return false;
+	index = n->second;
+	return true;
+}
+
+/** Search for a path between two nodes.
+ * The semantics are those of the A* search in NavGraph::search_path().
+ * If the default cost function is passed the precomputed arc costs are
+ * used, otherwise the cost function is called for each arc. Constraints
+ * are only evaluated for nodes and arcs reached during the search, each
+ * node constraint once per search.
+ * @param from index of the start node
+ * @param to index of the goal node
+ * @param estimate_func function to estimate the cost from any node to the goal
+ * @param cost_func function to calculate the cost between adjacent nodes
+ * @param constraint_repo constraint repository, NULL to ignore constraints
+ * @param path upon return contains the indexes of the nodes along the path,
+ * empty if there is no path
+ * @return cost of the path, -1 if there is no path
+ */
+float
+NavGraphSearchGraph::search(unsigned int                      from,
+                            unsigned int                      to,
+                            const navgraph::EstimateFunction &estimate_func,
+                            const navgraph::CostFunction &    cost_func,
+                            NavGraphConstraintRepo *          constraint_repo,
+                            std::vector<unsigned int> &       path)
+{
+	const std::vector<NavGraphNode> &nodes = *nodes_;
+
+	const bool default_estimate =
+	  is_search_func(estimate_func, NavGraphSearchState::straight_line_estimate);
+	const bool default_cost = is_search_func(cost_func, NavGraphSearchState::euclidean_cost);
+
+	auto estimate = [&](unsigned int node) -> float {
+		if (default_estimate) {
+			return sqrtf(powf(x_[to] - x_[node], 2) + powf(y_[to] - y_[node], 2));
+		} else {
+			return estimate_func(nodes[node], nodes[to]);
+		}
+	};
+	auto heap_greater = [](const heap_entry_t &a, const heap_entry_t &b) -> bool {
+		return a.f > b.f;
+	};
+
+	path.clear();
+	start_search();
+	constraint_repo_ = constraint_repo;
+
+	visited_stamps_[from] = search_stamp_;
+	g_[from]              = 0.;
+	parents_[from]        = from;
+	heap_.push_back({estimate(from), from});
+
+	while (!heap_.empty()) {
+		std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+		const unsigned int node = heap_.back().node;
+		heap_.pop_back();
+
+		// stale entry, the node has been reached on a cheaper path before
+		if (closed_stamps_[node] == search_stamp_)
+			continue;
+		closed_stamps_[node] = search_stamp_;
+
+		if (node == to) {
+			for (unsigned int n = to; n != from; n = parents_[n]) {
+				path.push_back(n);
+			}
+			path.push_back(from);
+			std::reverse(path.begin(), path.end());
+			heap_.clear();
+			return g_[to] + estimate(to);
+		}
+
+		for (unsigned int a = arc_offsets_[node]; a < arc_offsets_[node + 1]; ++a) {
+			const unsigned int d = arc_targets_[a];
+			if (closed_stamps_[d] == search_stamp_)
+				continue;
+
+			float d_cost;
+			if (!arc_cost(a, default_cost, cost_func, d_cost))
+				continue;
+
+			const float g = g_[node] + d_cost;
+			if ((visited_stamps_[d] != search_stamp_) || (g < g_[d])) {
+				visited_stamps_[d] = search_stamp_;
+				g_[d]              = g;
+				parents_[d]        = node;
+				heap_.push_back({g + estimate(d), d});
+				std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+			}
+		}
+	}
+
+	return -1;
+}
+
+/** Search for the cheapest paths from one node to all other nodes.
+ * This runs Dijkstra's algorithm over the whole graph, which is
+ * considerably cheaper than a search per goal if the costs to many
+ * goals are needed. Costs and constraints are treated as in search().
+ * The cost functions are not called and the nodes of the graph are not
+ * accessed if the default cost function is passed and constraints are
+ * ignored.
+ * @param from index of the start node
+ * @param cost_func function to calculate the cost between adjacent nodes
+ * @param constraint_repo constraint repository, NULL to ignore constraints
+ * @param costs upon return contains the cost of the cheapest path to each
+ * node, -1 if the node cannot be reached
+ * @param parents upon return contains the predecessor of each node on
+ * its cheapest path, @p from for the start node and unreachable nodes
+ */
+void
+NavGraphSearchGraph::search_tree(unsigned int                  from,
+                                 const navgraph::CostFunction &cost_func,
+                                 NavGraphConstraintRepo *      constraint_repo,
+                                 std::vector<float> &          costs,
+                                 std::vector<unsigned int> &   parents)
+{
+	const bool default_cost = is_search_func(cost_func, NavGraphSearchState::euclidean_cost);
+
+	auto heap_greater = [](const heap_entry_t &a, const heap_entry_t &b) -> bool {
+		return a.f > b.f;
+	};
+
+	costs.assign(num_nodes(), -1.);
+	parents.assign(num_nodes(), from);
+	start_search();
+	constraint_repo_ = constraint_repo;
+
+	costs[from] = 0.;
+	heap_.push_back({0., from});
+
+	while (!heap_.empty()) {
+		std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+		const unsigned int node = heap_.back().node;
+		heap_.pop_back();
+
+		if (closed_stamps_[node] == search_stamp_)
+			continue;
+		closed_stamps_[node] = search_stamp_;
+
+		for (unsigned int a = arc_offsets_[node]; a < arc_offsets_[node + 1]; ++a) {
+			const unsigned int d = arc_targets_[a];
+			if (closed_stamps_[d] == search_stamp_)
+				continue;
+
+			float d_cost;
+			if (!arc_cost(a, default_cost, cost_func, d_cost))
+				continue;
+
+			const float g = costs[node] + d_cost;
+			if ((costs[d] < 0.) || (g < costs[d])) {
+				costs[d]   = g;
+				parents[d] = node;
+				heap_.push_back({g, d});
+				std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+			}
+		}
+	}
+}
+
+/** Prepare the search state for a new search.
+ * Instead of clearing the per-node arrays, a new stamp is used for
+ * each search. They are only cleared once the stamp wraps around.
+ */
+void
+NavGraphSearchGraph::start_search()
+{
+	heap_.clear();
+	if (++search_stamp_ == 0) {
+		std::fill(visited_stamps_.begin(), visited_stamps_.end(), 0);
+		std::fill(closed_stamps_.begin(), closed_stamps_.end(), 0);
+		std::fill(blocked_stamps_.begin(), blocked_stamps_.end(), 0);
+		search_stamp_ = 1;
+	}
+}
+
+/** Get cost of an arc for the current search.
+ * @param arc index of the arc
+ * @param default_cost true to use the precomputed euclidean cost
+ * @param cost_func function to calculate the cost if @p default_cost is false
+ * @param cost upon return contains the cost of the arc, including the
+ * cost factor of constraints
+ * @return false if the arc is blocked by a constraint, true otherwise
+ */
+bool
+NavGraphSearchGraph::arc_cost(unsigned int                  arc,
+                              bool                          default_cost,
+                              const navgraph::CostFunction &cost_func,
+                              float &                       cost)
+{
+	const unsigned int from = arc_sources_[arc];
+	const unsigned int to   = arc_targets_[arc];
+
+	if (constraint_repo_
+	    && (node_blocked(to) || constraint_repo_->blocks((*nodes_)[from], (*nodes_)[to]))) {
+		return false;
+	}
+
+	cost = default_cost ? arc_costs_[arc] : cost_func((*nodes_)[from], (*nodes_)[to]);
+	if (constraint_repo_) {
+		float cost_factor = 0.;
+		if (constraint_repo_->increases_cost((*nodes_)[from], (*nodes_)[to], cost_factor)) {
+			cost *= cost_factor;
+		}
+	}
+	return true;
+}
+
+/** Check if a node is blocked by a constraint.
+ * The result is determined once per search.
+ * @param node index of the node to check
+ * @return true if the node is blocked, false otherwise
+ */
+bool
+NavGraphSearchGraph::node_blocked(unsigned int node)
+{
+	if (blocked_stamps_[node] != search_stamp_) {
+		blocked_stamps_[node] = search_stamp_;
+		blocked_[node]        = (constraint_repo_->blocks((*nodes_)[node]) != NULL);
+	}
+	return blocked_[node];
+}
+
+} // end of namespace fawkes
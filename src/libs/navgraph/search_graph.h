@@ -0,0 +1,111 @@
+/***************************************************************************
+ *  search_graph.h - Compiled, index-based graph for path search
+ *
+ *  Created: Sun Oct 18 09:12:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+#define _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+
+#include <navgraph/navgraph.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphConstraintRepo;
+class NavGraphIncrementalSearch;
+
+class NavGraphSearchGraph
+{
+	friend class NavGraphIncrementalSearch;
+
+public:
+	NavGraphSearchGraph(const std::vector<NavGraphNode> &nodes,
+	                    const std::vector<NavGraphEdge> &edges);
+	~NavGraphSearchGraph();
+
+	unsigned int num_nodes() const;
+	unsigned int num_arcs() const;
+
+	bool node_index(const std::string &name, unsigned int &index) const;
+
+	float search(unsigned int                      from,
+	             unsigned int                      to,
+	             const navgraph::EstimateFunction &estimate_func,
+	             const navgraph::CostFunction &    cost_func,
+	             NavGraphConstraintRepo *          constraint_repo,
+	             std::vector<unsigned int> &       path);
+
+	void search_tree(unsigned int                  from,
+	                 const navgraph::CostFunction &cost_func,
+	                 NavGraphConstraintRepo *      constraint_repo,
+	                 std::vector<float> &          costs,
+	                 std::vector<unsigned int> &   parents);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		float        f;
+		unsigned int node;
+	} heap_entry_t;
+	/// @endcond
+
+	void start_search();
+	bool arc_cost(unsigned int                  arc,
+	              bool                          default_cost,
+	              const navgraph::CostFunction &cost_func,
+	              float &                       cost);
+	bool node_blocked(unsigned int node);
+
+	const std::vector<NavGraphNode> *nodes_;
+
+	std::unordered_map<std::string, unsigned int> node_indexes_;
+	std::vector<float>                            x_;
+	std::vector<float>                            y_;
+
+	// outgoing arcs of node i are arc_targets_[arc_offsets_[i] .. arc_offsets_[i+1]]
+	std::vector<unsigned int> arc_offsets_;
+	std::vector<unsigned int> arc_targets_;
+	std::vector<float>        arc_costs_;
+	std::vector<unsigned int> arc_sources_;
+
+	// incoming arcs of node i are in_arcs_[in_arc_offsets_[i] .. in_arc_offsets_[i+1]],
+	// given as indexes into the outgoing arc arrays
+	std::vector<unsigned int> in_arc_offsets_;
+	std::vector<unsigned int> in_arcs_;
+
+	// search state, valid for nodes with a stamp of the current search
+	unsigned int              search_stamp_;
+	std::vector<unsigned int> visited_stamps_;
+	std::vector<unsigned int> closed_stamps_;
+	std::vector<float>        g_;
+	std::vector<unsigned int> parents_;
+	std::vector<heap_entry_t> heap_;
+
+	NavGraphConstraintRepo *  constraint_repo_;
+	std::vector<unsigned int> blocked_stamps_;
+	std::vector<bool>         blocked_;
+};
+
+} // end of namespace fawkes
+
+#endif
@@ -0,0 +1,331 @@
+/***************************************************************************
+ *  spatial_index.cpp - Grid index over nodes and edges of a graph
+ *
+ *  Created: Sun Oct 18 11:21:06 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/spatial_index.h>
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace fawkes {
+
+/** Minimum cell size in meters. */
+#define MIN_CELL_SIZE 0.05
+
+/** @class NavGraphSpatialIndex <navgraph/spatial_index.h>
+ * Grid index over nodes and edges of a graph.
+ * The plane is divided into square cells. Each cell lists the nodes
+ * within and the edges whose bounding box overlaps it. Closest node and
+ * edge queries search cells in rings of increasing size around the query
+ * point and stop once no unvisited cell can contain a closer candidate.
+ * Only occupied cells are stored, in a hash map.
+ *
+ * The cell size is chosen on creation from the density of the nodes.
+ * Nodes and edges appended to the graph can be added incrementally. If
+ * nodes or edges are removed or modified, the index must be re-created.
+ * Queries return the same element as a linear scan in graph order, that
+ * is among elements with the same distance the one added first.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param nodes nodes of the graph, must outlive this instance
+ * @param edges edges of the graph, must outlive this instance
+ */
+NavGraphSpatialIndex::NavGraphSpatialIndex(const std::vector<NavGraphNode> &nodes,
+                                           const std::vector<NavGraphEdge> &edges)
+: nodes_(&nodes), edges_(&edges), built_num_nodes_(nodes.size()), empty_(true)
+{
+	float min_x = std::numeric_limits<float>::max(), max_x = -std::numeric_limits<float>::max();
+	float min_y = std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+	for (const NavGraphNode &n : nodes) {
+		min_x = std::min(min_x, n.x());
+		max_x = std::max(max_x, n.x());
+		min_y = std::min(min_y, n.y());
+		max_y = std::max(max_y, n.y());
+	}
+
+	// aim for a few nodes per cell
+	cell_size_ = 1.0;
+	if (nodes.size() > 1) {
+		const float w = max_x - min_x;
+		const float h = max_y - min_y;
+		if (w > 0 && h > 0) {
+			cell_size_ = 2 * sqrtf(w * h / nodes.size());
+		} else {
+			cell_size_ = 2 * std::max(w, h) / nodes.size();
+		}
+	}
+	cell_size_ = std::max(cell_size_, (float)MIN_CELL_SIZE);
+
+	for (unsigned int i = 0; i < nodes.size(); ++i) {
+		add_node(i);
+	}
+	for (unsigned int i = 0; i < edges.size(); ++i) {
+		add_edge(i);
+	}
+}
+
+/** Destructor. */
+NavGraphSpatialIndex::~NavGraphSpatialIndex()
+{
+}
+
+/** Add node to index.
+ * @param index index of the node in the graph's node vector
+ */
+void
+NavGraphSpatialIndex::add_node(unsigned int index)
+{
+	const NavGraphNode &n  = (*nodes_)[index];
+	const int           cx = cell_coord(n.x());
+	const int           cy = cell_coord(n.y());
+	cell(cx, cy).nodes.push_back(index);
+	update_bounds(cx, cy);
+}
+
+/** Add edge to index.
+ * The edge is indexed by the positions of its assigned nodes.
+ * @param index index of the edge in the graph's edge vector
+ */
+void
+NavGraphSpatialIndex::add_edge(unsigned int index)
+{
+	const NavGraphEdge &e      = (*edges_)[index];
+	const int           min_cx = cell_coord(std::min(e.from_node().x(), e.to_node().x()));
+	const int           max_cx = cell_coord(std::max(e.from_node().x(), e.to_node().x()));
+	const int           min_cy = cell_coord(std::min(e.from_node().y(), e.to_node().y()));
+	const int           max_cy = cell_coord(std::max(e.from_node().y(), e.to_node().y()));
+	for (int cx = min_cx; cx <= max_cx; ++cx) {
+		for (int cy = min_cy; cy <= max_cy; ++cy) {
+			cell(cx, cy).edges.push_back(index);
+		}
+	}
+	update_bounds(min_cx, min_cy);
+	update_bounds(max_cx, max_cy);
+}
+
+/** Check if the index should be re-created.
+ * This is the case if the graph has grown considerably since the index
+ * was created and the cell size no longer matches the node density.
+ * @return true if the index should be re-created
+ */
+bool
+NavGraphSpatialIndex::needs_rebuild() const
+{
+	return nodes_->size() > 2 * built_num_nodes_ + 16;
+}
+
+/** Get node closest to a point.
+ * @param x X coordinate of the point
+ * @param y Y coordinate of the point
+ * @param filter function which returns true for nodes to consider
+ * @return index of the closest node for which @p filter returned true,
+ * -1 if there is no such node
+ */
+int
+NavGraphSpatialIndex::closest_node(float                                     x,
+                                   float                                     y,
+                                   std::function<bool(const NavGraphNode &)> filter) const
+{
+	if (empty_)
+		return -1;
+
+	const std::vector<NavGraphNode> &nodes    = *nodes_;
+	int                              closest  = -1;
+	float                            min_dist = std::numeric_limits<float>::max();
+
+	const int cx    = cell_coord(x);
+	const int cy    = cell_coord(y);
+	const int limit = ring_limit(cx, cy);
+	for (int r = 0; r <= limit; ++r) {
+		visit_ring(cx, cy, r, [&](const cell_t &c) {
+			for (unsigned int i : c.nodes) {
+				const NavGraphNode &n  = nodes[i];
+				const float         dx = n.x() - x;
+				const float         dy = n.y() - y;
+				const float         d  = sqrtf(dx * dx + dy * dy);
+				if (((d < min_dist) || ((d == min_dist) && ((int)i < closest))) && filter(n)) {
+					min_dist = d;
+					closest  = i;
+				}
+			}
+		});
+		// unvisited cells are at least r cells away, allow for rounding
+		if ((closest >= 0) && (min_dist < (r - 0.01) * cell_size_))
+			break;
+	}
+	return closest;
+}
+
+/** Get edge closest to a point.
+ * Only edges are considered for which a line perpendicular to the edge
+ * goes through the point and a point on the edge, cf. NavGraph::closest_edge().
+ * @param x X coordinate of the point
+ * @param y Y coordinate of the point
+ * @return index of the closest edge, -1 if there is no such edge
+ */
+int
+NavGraphSpatialIndex::closest_edge(float x, float y) const
+{
+	if (empty_)
+		return -1;
+
+	const std::vector<NavGraphEdge> &edges    = *edges_;
+	int                              closest  = -1;
+	float                            min_dist = std::numeric_limits<float>::max();
+
+	const Eigen::Vector2f point(x, y);
+	const int             cx    = cell_coord(x);
+	const int             cy    = cell_coord(y);
+	const int             limit = ring_limit(cx, cy);
+	for (int r = 0; r <= limit; ++r) {
+		visit_ring(cx, cy, r, [&](const cell_t &c) {
+			for (unsigned int i : c.edges) {
+				const NavGraphEdge &  edge = edges[i];
+				const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
+				const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
+				const Eigen::Vector2f direction(target - origin);
+				const Eigen::Vector2f direction_norm = direction.normalized();
+				const Eigen::Vector2f diff           = point - origin;
+				const float           t              = direction.dot(diff) / direction.squaredNorm();
+
+				if (t >= 0.0 && t <= 1.0) {
+					float d = (diff - direction_norm.dot(diff) * direction_norm).norm();
+					if ((d < min_dist) || ((d == min_dist) && ((int)i < closest))) {
+						min_dist = d;
+						closest  = i;
+					}
+				}
+			}
+		});
+		if ((closest >= 0) && (min_dist < (r - 0.01) * cell_size_))
+			break;
+	}
+	return closest;
+}
+
+/** Get cell coordinate.
+ * @param v coordinate in meters
+ * @return cell coordinate
+ */
+int
+NavGraphSpatialIndex::cell_coord(float v) const
+{
+	return (int)floorf(v / cell_size_);
+}
+
+/** Get hash map key of a cell.
+ * @param cx cell X coordinate
+ * @param cy cell Y coordinate
+ * @return key
+ */
+uint64_t
+NavGraphSpatialIndex::cell_key(int cx, int cy) const
+{
+	return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+}
+
+/** Get cell, create it if it does not exist.
+ * @param cx cell X coordinate
+ * @param cy cell Y coordinate
+ * @return cell
+ */
+NavGraphSpatialIndex::cell_t &
+NavGraphSpatialIndex::cell(int cx, int cy)
+{
+	return cells_[cell_key(cx, cy)];
+}
+
+/** Extend bounds of occupied cells.
+ * @param cx cell X coordinate
+ * @param cy cell Y coordinate
+ */
+void
+NavGraphSpatialIndex::update_bounds(int cx, int cy)
+{
+	if (empty_) {
+		min_cx_ = max_cx_ = cx;
+		min_cy_ = max_cy_ = cy;
+		empty_            = false;
+	} else {
+		min_cx_ = std::min(min_cx_, cx);
+		max_cx_ = std::max(max_cx_, cx);
+		min_cy_ = std::min(min_cy_, cy);
+		max_cy_ = std::max(max_cy_, cy);
+	}
+}
+
+/** Get largest ring which contains occupied cells.
+ * @param cx cell X coordinate of the ring center
+ * @param cy cell Y coordinate of the ring center
+ * @return maximum ring radius to search
+ */
+int
+NavGraphSpatialIndex::ring_limit(int cx, int cy) const
+{
+	return std::max(std::max(abs(cx - min_cx_), abs(max_cx_ - cx)),
+	                std::max(abs(cy - min_cy_), abs(max_cy_ - cy)));
+}
+
+/** Visit all occupied cells of a ring.
+ * @param cx cell X coordinate of the ring center
+ * @param cy cell Y coordinate of the ring center
+ * @param r radius of the ring in cells
+ * @param visit function called for each occupied cell of the ring
+ */
+template <class Visitor>
+void
+NavGraphSpatialIndex::visit_ring(int cx, int cy, int r, Visitor visit) const
+{
+	auto visit_cell = [&](int x, int y) {
+		std::unordered_map<uint64_t, cell_t>::const_iterator c = cells_.find(cell_key(x, y));
+		if (c != cells_.end())
+			visit(c->second);
+	};
+
+	if (r == 0) {
+		visit_cell(cx, cy);
+		return;
+	}
+
+	// only visit the part of the ring within the bounds of occupied cells
+	const int x_from = std::max(cx - r, min_cx_);
+	const int x_to   = std::min(cx + r, max_cx_);
+	const int y_from = std::max(cy - r + 1, min_cy_);
+	const int y_to   = std::min(cy + r - 1, max_cy_);
+	for (int x = x_from; x <= x_to; ++x) {
+		if (cy - r >= min_cy_)
+			visit_cell(x, cy - r);
+		if (cy + r <= max_cy_)
+			visit_cell(x, cy + r);
+	}
+	for (int y = y_from; y <= y_to; ++y) {
+		if (cx - r >= min_cx_)
+			visit_cell(cx - r, y);
+		if (cx + r <= max_cx_)
+			visit_cell(cx + r, y);
+	}
+}
+
+} // end of namespace fawkes
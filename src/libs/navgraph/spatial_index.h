@@ -0,0 +1,82 @@
+/***************************************************************************
+ *  spatial_index.h - Grid index over nodes and edges of a graph
+ *
+ *  Created: Sun Oct 18 11:21:06 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_SPATIAL_INDEX_H_
+#define _LIBS_NAVGRAPH_SPATIAL_INDEX_H_
+
+#include <navgraph/navgraph_edge.h>
+#include <navgraph/navgraph_node.h>
+
+#include <functional>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphSpatialIndex
+{
+public:
+	NavGraphSpatialIndex(const std::vector<NavGraphNode> &nodes,
+	                     const std::vector<NavGraphEdge> &edges);
+	~NavGraphSpatialIndex();
+
+	void add_node(unsigned int index);
+	void add_edge(unsigned int index);
+
+	bool needs_rebuild() const;
+
+	int closest_node(float x, float y, std::function<bool(const NavGraphNode &)> filter) const;
+	int closest_edge(float x, float y) const;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::vector<unsigned int> nodes;
+		std::vector<unsigned int> edges;
+	} cell_t;
+	/// @endcond
+
+	int      cell_coord(float v) const;
+	uint64_t cell_key(int cx, int cy) const;
+	cell_t & cell(int cx, int cy);
+	void     update_bounds(int cx, int cy);
+	int      ring_limit(int cx, int cy) const;
+
+	template <class Visitor>
+	void visit_ring(int cx, int cy, int r, Visitor visit) const;
+
+	const std::vector<NavGraphNode> *nodes_;
+	const std::vector<NavGraphEdge> *edges_;
+
+	float        cell_size_;
+	unsigned int built_num_nodes_;
+
+	std::unordered_map<uint64_t, cell_t> cells_;
+	bool                                 empty_;
+	int                                  min_cx_, max_cx_;
+	int                                  min_cy_, max_cy_;
+};
+
+} // end of namespace fawkes
+
+#endif
@@ -45,7 +45,8 @@ public:
 	                     const std::string &listen_ipv4,
 	                     const std::string &listen_ipv6,
 	                     unsigned short int fawkes_port,
-	                     const char *       service_name);
+	                     const char *       service_name,
+	                     unsigned int       num_io_threads = 0);
 	~FawkesNetworkManager();
 
 	FawkesNetworkHub *   hub();
@@ -0,0 +1,573 @@
+
+/***************************************************************************
+ *  server_io_thread.cpp - Event-driven I/O for Fawkes network clients
+ *
+ *  Created: Fri Oct 30 10:37:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <netcomm/fawkes/server_io_thread.h>
+#include <netcomm/fawkes/server_thread.h>
+#include <netcomm/socket/stream.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+// epoll user data of the wakeup event, client IDs start at 1
+#define EVENT_ID 0
+// maximum number of messages written with one system call
+#define MAX_WRITE_MSGS 64
+#define MAX_EVENTS 64
+#define READ_BUFFER_SIZE 65536
+
+FawkesNetworkServerIOThread::Connection::Connection(StreamSocket *s)
+: socket(s), fd(s->fd()), alive(true), want_out(false), pending(false), in_bytes(0), out_offset(0)
+{
+	in_msg.payload = NULL;
+}
+
+FawkesNetworkServerIOThread::Connection::~Connection()
+{
+	free(in_msg.payload);
+	for (size_t i = 0; i < outbound.size(); ++i) {
+		outbound[i]->unref();
+	}
+	delete socket;
+}
+/// @endcond
+
+/** @class FawkesNetworkServerIOThread <netcomm/fawkes/server_io_thread.h>
+ * Event-driven I/O thread for Fawkes network clients.
+ * Instead of two threads per connected client, a small number of these
+ * threads serves all clients of a FawkesNetworkServerThread. Each thread
+ * waits for events on its connections with epoll and reads and writes
+ * without blocking.
+ *
+ * Received messages are dispatched via the parent thread, just like with
+ * per-client threads. Outbound messages are queued per connection and
+ * written with scatter/gather I/O, many messages in a single system call.
+ * A connection whose socket buffer is full is watched for writability,
+ * while the others are served in the meantime.
+ *
+ * Messages must have been packed, cf. FawkesNetworkMessage::pack(),
+ * before they are enqueued. They are shared among connections and threads
+ * and are therefore not modified afterwards.
+ *
+ * This class is only available on Linux.
+ * @ingroup NetComm
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param parent parent server thread to dispatch messages to
+ * @param index index of the thread, used in its name
+ */
+FawkesNetworkServerIOThread::FawkesNetworkServerIOThread(FawkesNetworkServerThread *parent,
+                                                         unsigned int               index)
+: Thread("FawkesNetworkServerIOThread", Thread::OPMODE_CONTINUOUS)
+{
+	set_name("FawkesNetworkServerIOThread %u", index);
+
+	parent_   = parent;
+	notified_ = false;
+	read_buffer_.resize(READ_BUFFER_SIZE);
+
+	epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd_ == -1) {
+		throw Exception(errno, "Failed to create epoll instance");
+	}
+	event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (event_fd_ == -1) {
+		int err = errno;
+		::close(epoll_fd_);
+		throw Exception(err, "Failed to create event file descriptor");
+	}
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events   = EPOLLIN;
+	ev.data.u64 = EVENT_ID;
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev) == -1) {
+		int err = errno;
+		::close(event_fd_);
+		::close(epoll_fd_);
+		throw Exception(err, "Failed to watch event file descriptor");
+	}
+
+	mutex_         = new Mutex();
+	sent_waitcond_ = new WaitCondition(mutex_);
+}
+
+/** Destructor.
+ * Closes all remaining connections.
+ */
+FawkesNetworkServerIOThread::~FawkesNetworkServerIOThread()
+{
+	for (auto &c : connections_) {
+		delete c.second;
+	}
+	::close(event_fd_);
+	::close(epoll_fd_);
+	delete sent_waitcond_;
+	delete mutex_;
+}
+
+/** Add a connection.
+ * The socket is switched to non-blocking mode and watched from now on.
+ * @param clid client ID of the connection
+ * @param s socket of the connection, ownership is transferred to this thread
+ */
+void
+FawkesNetworkServerIOThread::add_connection(unsigned int clid, StreamSocket *s)
+{
+	Connection *c = new Connection(s);
+
+	int flags = fcntl(c->fd, F_GETFL);
+	fcntl(c->fd, F_SETFL, flags | O_NONBLOCK);
+
+	MutexLocker lock(mutex_);
+	connections_[clid] = c;
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events   = EPOLLIN | EPOLLRDHUP;
+	ev.data.u64 = clid;
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, c->fd, &ev) == -1) {
+		// reported as dead client, the parent will remove it
+		c->alive = false;
+	}
+}
+
+/** Remove a connection.
+ * Closes the connection and drops all messages not sent, yet.
+ * @param clid client ID of the connection
+ */
+void
+FawkesNetworkServerIOThread::remove_connection(unsigned int clid)
+{
+	MutexLocker lock(mutex_);
+	auto        ci = connections_.find(clid);
+	if (ci == connections_.end())
+		return;
+	connection_died(ci->second);
+	delete ci->second;
+	connections_.erase(ci);
+	sent_waitcond_->wake_all();
+}
+
+/** Get dead clients.
+ * @param clids upon return the client IDs of connections which died have
+ * been appended, they should be removed with remove_connection()
+ */
+void
+FawkesNetworkServerIOThread::dead_clients(std::list<unsigned int> &clids)
+{
+	MutexLocker lock(mutex_);
+	for (auto &c : connections_) {
+		if (!c.second->alive) {
+			clids.push_back(c.first);
+		}
+	}
+}
+
+/** Check aliveness of connection.
+ * @param clid client ID of the connection
+ * @return true if the connection exists and is alive, false otherwise
+ */
+bool
+FawkesNetworkServerIOThread::alive(unsigned int clid)
+{
+	MutexLocker lock(mutex_);
+	auto        ci = connections_.find(clid);
+	return (ci != connections_.end()) && ci->second->alive;
+}
+
+/** Enqueue message for sending.
+ * The message is sent to the client given by its client ID. If there is no
+ * such client or the connection died the message is silently dropped.
+ * This method takes ownership of the message. If you want to use the
+ * message after enqueuing you must reference it explicitly.
+ * @param msg packed message to enqueue
+ */
+void
+FawkesNetworkServerIOThread::enqueue(FawkesNetworkMessage *msg)
+{
+	mutex_->lock();
+	auto ci = connections_.find(msg->clid());
+	if ((ci == connections_.end()) || !ci->second->alive) {
+		mutex_->unlock();
+		msg->unref();
+		return;
+	}
+	push(ci->first, ci->second, msg);
+	bool wake = !notified_;
+	notified_ = true;
+	mutex_->unlock();
+
+	if (wake)
+		notify();
+}
+
+/** Enqueue message for sending to all clients of this thread.
+ * This method takes ownership of the message. If you want to use the
+ * message after enqueuing you must reference it explicitly.
+ * @param msg packed message to enqueue
+ */
+void
+FawkesNetworkServerIOThread::broadcast(FawkesNetworkMessage *msg)
+{
+	bool wake = false;
+	mutex_->lock();
+	for (auto &c : connections_) {
+		if (c.second->alive) {
+			msg->ref();
+			push(c.first, c.second, msg);
+			wake = true;
+		}
+	}
+	wake      = wake && !notified_;
+	notified_ = notified_ || wake;
+	mutex_->unlock();
+	msg->unref();
+
+	if (wake)
+		notify();
+}
+
+/** Wait until all enqueued messages have been sent.
+ * Returns early for connections which die meanwhile. Must not be called
+ * from the I/O thread itself.
+ */
+void
+FawkesNetworkServerIOThread::force_send()
+{
+	MutexLocker lock(mutex_);
+	bool        have_outbound;
+	do {
+		have_outbound = false;
+		for (auto &c : connections_) {
+			if (c.second->alive && !c.second->outbound.empty()) {
+				have_outbound = true;
+				break;
+			}
+		}
+		if (have_outbound)
+			sent_waitcond_->wait();
+	} while (have_outbound);
+}
+
+/** Thread loop.
+ * Waits for events on the connections, receives and dispatches messages,
+ * and writes queued messages.
+ */
+void
+FawkesNetworkServerIOThread::loop()
+{
+	struct epoll_event events[MAX_EVENTS];
+	int                num_events = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+	if (num_events == -1) {
+		// EINTR, just try again
+		return;
+	}
+
+	// keep connections consistent, cancel only while waiting for events
+	CancelState old_cancel_state;
+	set_cancel_state(CANCEL_DISABLED, &old_cancel_state);
+
+	std::list<FawkesNetworkMessage *> inbound;
+	bool                              died = false;
+
+	mutex_->lock();
+	for (int i = 0; i < num_events; ++i) {
+		if (events[i].data.u64 == EVENT_ID) {
+			uint64_t count;
+			while (::read(event_fd_, &count, sizeof(count)) > 0) {
+			}
+			notified_ = false;
+			for (size_t p = 0; p < pending_.size(); ++p) {
+				auto ci = connections_.find(pending_[p]);
+				if (ci == connections_.end())
+					continue;
+				ci->second->pending = false;
+				if (ci->second->alive) {
+					flush(ci->second);
+					update_events(ci->first, ci->second);
+					died = died || !ci->second->alive;
+				}
+			}
+			pending_.clear();
+			continue;
+		}
+
+		unsigned int clid = events[i].data.u64;
+		auto         ci   = connections_.find(clid);
+		if ((ci == connections_.end()) || !ci->second->alive)
+			continue;
+		Connection *c = ci->second;
+
+		if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+			receive(clid, c, inbound);
+		}
+		if (c->alive && (events[i].events & EPOLLERR)) {
+			connection_died(c);
+		}
+		if (c->alive && (events[i].events & EPOLLOUT)) {
+			flush(c);
+			update_events(clid, c);
+		}
+		died = died || !c->alive;
+	}
+	sent_waitcond_->wake_all();
+	mutex_->unlock();
+
+	// dispatch without holding the lock, handlers may send replies
+	for (auto m : inbound) {
+		parent_->dispatch(m);
+		m->unref();
+	}
+	if (died || !inbound.empty()) {
+		parent_->wakeup();
+	}
+
+	set_cancel_state(old_cancel_state);
+}
+
+/** Queue message on connection.
+ * Must be called with the mutex locked. The caller must wake up the
+ * thread unless it is notified already.
+ * @param clid client ID of the connection
+ * @param c connection
+ * @param msg message to queue
+ */
+void
+FawkesNetworkServerIOThread::push(unsigned int clid, Connection *c, FawkesNetworkMessage *msg)
+{
+	c->outbound.push_back(msg);
+	// if waiting for writability the data will be sent when possible
+	if (!c->pending && !c->want_out) {
+		c->pending = true;
+		pending_.push_back(clid);
+	}
+}
+
+/** Receive messages.
+ * Reads all available data and parses it into messages.
+ * @param clid client ID of the connection
+ * @param c connection
+ * @param inbound list to append complete messages to
+ */
+void
+FawkesNetworkServerIOThread::receive(unsigned int                       clid,
+                                     Connection *                       c,
+                                     std::list<FawkesNetworkMessage *> &inbound)
+{
+	const size_t header_size = sizeof(fawkes_message_header_t);
+
+	for (;;) {
+		ssize_t bytes = ::recv(c->fd, &read_buffer_[0], read_buffer_.size(), 0);
+		if (bytes == 0) {
+			connection_died(c);
+			return;
+		} else if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+				connection_died(c);
+			return;
+		}
+
+		const unsigned char *data = &read_buffer_[0];
+		size_t               len  = bytes;
+		while (len > 0) {
+			size_t n;
+			if (c->in_bytes < header_size) {
+				n = std::min(len, header_size - c->in_bytes);
+				memcpy((char *)&c->in_msg.header + c->in_bytes, data, n);
+				c->in_bytes += n;
+				data += n;
+				len -= n;
+				if (c->in_bytes < header_size)
+					break;
+				size_t payload_size = ntohl(c->in_msg.header.payload_size);
+				if (payload_size > 0) {
+					c->in_msg.payload = malloc(payload_size);
+					if (!c->in_msg.payload) {
+						connection_died(c);
+						return;
+					}
+				}
+			} else {
+				size_t payload_size = ntohl(c->in_msg.header.payload_size);
+				n = std::min(len, header_size + payload_size - c->in_bytes);
+				memcpy((char *)c->in_msg.payload + (c->in_bytes - header_size), data, n);
+				c->in_bytes += n;
+				data += n;
+				len -= n;
+			}
+
+			if (c->in_bytes == header_size + ntohl(c->in_msg.header.payload_size)) {
+				FawkesNetworkMessage *m = new FawkesNetworkMessage(c->in_msg);
+				m->set_client_id(clid);
+				inbound.push_back(m);
+				c->in_msg.payload = NULL;
+				c->in_bytes       = 0;
+			}
+		}
+
+		if ((size_t)bytes < read_buffer_.size())
+			return;
+	}
+}
+
+/** Write queued messages.
+ * Writes as much as possible without blocking.
+ * @param c connection
+ */
+void
+FawkesNetworkServerIOThread::flush(Connection *c)
+{
+	const size_t header_size = sizeof(fawkes_message_header_t);
+	struct iovec iov[2 * MAX_WRITE_MSGS];
+
+	while (!c->outbound.empty()) {
+		int    num_iov = 0;
+		size_t skip    = c->out_offset;
+		size_t total   = 0;
+		for (size_t i = 0; (i < c->outbound.size()) && (i < MAX_WRITE_MSGS); ++i) {
+			const fawkes_message_t &f            = c->outbound[i]->fmsg();
+			size_t                  payload_size = c->outbound[i]->payload_size();
+			if (skip < header_size) {
+				iov[num_iov].iov_base = (char *)&f.header + skip;
+				iov[num_iov].iov_len  = header_size - skip;
+				total += iov[num_iov++].iov_len;
+				skip = 0;
+			} else {
+				skip -= header_size;
+			}
+			if (payload_size > skip) {
+				iov[num_iov].iov_base = (char *)f.payload + skip;
+				iov[num_iov].iov_len  = payload_size - skip;
+				total += iov[num_iov++].iov_len;
+			}
+			skip = 0;
+		}
+
+		struct msghdr mh;
+		memset(&mh, 0, sizeof(mh));
+		mh.msg_iov    = iov;
+		mh.msg_iovlen = num_iov;
+		ssize_t bytes = ::sendmsg(c->fd, &mh, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+				connection_died(c);
+			return;
+		}
+
+		size_t written = bytes;
+		while ((written > 0) && !c->outbound.empty()) {
+			FawkesNetworkMessage *m         = c->outbound.front();
+			size_t                remaining = header_size + m->payload_size() - c->out_offset;
+			if (written < remaining) {
+				c->out_offset += written;
+				break;
+			}
+			written -= remaining;
+			c->out_offset = 0;
+			m->unref();
+			c->outbound.pop_front();
+		}
+
+		if ((size_t)bytes < total) {
+			// socket buffer is full, continue when writable
+			return;
+		}
+	}
+}
+
+/** Update events watched for a connection.
+ * Watches for writability only while there is data which could not be
+ * written, yet.
+ * @param clid client ID of the connection
+ * @param c connection
+ */
+void
+FawkesNetworkServerIOThread::update_events(unsigned int clid, Connection *c)
+{
+	bool want_out = !c->outbound.empty();
+	if (!c->alive || (want_out == c->want_out))
+		return;
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events   = EPOLLIN | EPOLLRDHUP | (want_out ? EPOLLOUT : 0);
+	ev.data.u64 = clid;
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c->fd, &ev) == -1) {
+		connection_died(c);
+	} else {
+		c->want_out = want_out;
+	}
+}
+
+/** Mark connection as dead.
+ * Stops watching the connection and drops queued messages. The connection
+ * is closed when it is removed.
+ * @param c connection
+ */
+void
+FawkesNetworkServerIOThread::connection_died(Connection *c)
+{
+	if (!c->alive)
+		return;
+	c->alive = false;
+	epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, c->fd, NULL);
+	for (size_t i = 0; i < c->outbound.size(); ++i) {
+		c->outbound[i]->unref();
+	}
+	c->outbound.clear();
+	c->out_offset = 0;
+}
+
+/** Wake up the I/O thread to send queued messages. */
+void
+FawkesNetworkServerIOThread::notify()
+{
+	uint64_t one = 1;
+	if (::write(event_fd_, &one, sizeof(one)) == -1) {
+		// counter overflow only, the thread is woken up anyway
+	}
+}
+
+} // end namespace fawkes
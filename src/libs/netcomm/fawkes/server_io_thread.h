@@ -0,0 +1,113 @@
+
+/***************************************************************************
+ *  server_io_thread.h - Event-driven I/O for Fawkes network clients
+ *
+ *  Created: Fri Oct 30 10:37:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_SERVER_IO_THREAD_H_
+#define _NETCOMM_FAWKES_SERVER_IO_THREAD_H_
+
+#include <core/threading/thread.h>
+#include <netcomm/fawkes/message.h>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace fawkes {
+
+class StreamSocket;
+class FawkesNetworkServerThread;
+class Mutex;
+class WaitCondition;
+
+class FawkesNetworkServerIOThread : public Thread
+{
+public:
+	FawkesNetworkServerIOThread(FawkesNetworkServerThread *parent, unsigned int index);
+	virtual ~FawkesNetworkServerIOThread();
+
+	virtual void loop();
+
+	void add_connection(unsigned int clid, StreamSocket *s);
+	void remove_connection(unsigned int clid);
+	void dead_clients(std::list<unsigned int> &clids);
+	bool alive(unsigned int clid);
+
+	void enqueue(FawkesNetworkMessage *msg);
+	void broadcast(FawkesNetworkMessage *msg);
+	void force_send();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	/// @cond INTERNALS
+	class Connection
+	{
+	public:
+		Connection(StreamSocket *s);
+		~Connection();
+
+		StreamSocket *socket;
+		int           fd;
+		bool          alive;
+		bool          want_out;
+		bool          pending;
+
+		fawkes_message_t in_msg;
+		size_t           in_bytes;
+
+		std::deque<FawkesNetworkMessage *> outbound;
+		size_t                             out_offset;
+	};
+	/// @endcond
+
+	void push(unsigned int clid, Connection *c, FawkesNetworkMessage *msg);
+	void receive(unsigned int clid, Connection *c, std::list<FawkesNetworkMessage *> &inbound);
+	void flush(Connection *c);
+	void update_events(unsigned int clid, Connection *c);
+	void connection_died(Connection *c);
+	void notify();
+
+	FawkesNetworkServerThread *parent_;
+
+	int epoll_fd_;
+	int event_fd_;
+
+	Mutex *        mutex_;
+	WaitCondition *sent_waitcond_;
+
+	std::map<unsigned int, Connection *> connections_;
+	std::vector<unsigned int>            pending_;
+	bool                                 notified_;
+
+	std::vector<unsigned char> read_buffer_;
+};
+
+} // end namespace fawkes
+
+#endif
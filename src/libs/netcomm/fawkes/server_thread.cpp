@@ -30,6 +30,9 @@
 #include <netcomm/fawkes/message_content.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/server_client_thread.h>
+#ifdef HAVE_EPOLL
+#	include <netcomm/fawkes/server_io_thread.h>
+#endif
 #include <netcomm/fawkes/server_thread.h>
 #include <netcomm/utils/acceptor_thread.h>
 
@@ -42,6 +45,12 @@ namespace fawkes {
  * Maintains a list of clients and reacts on events triggered by the clients.
  * Also runs the acceptor thread.
  *
+ * By default, two threads are spawned for each client, one for receiving
+ * and one for sending. With many clients this means many threads and
+ * wakeups. Alternatively, a fixed number of event-driven I/O threads can
+ * serve all clients, cf. FawkesNetworkServerIOThread. This is only
+ * available on Linux, on other systems per-client threads are used.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -55,13 +64,16 @@ namespace fawkes {
  * :: to listen on any local address
  * @param fawkes_port port for Fawkes network protocol
  * @param thread_collector thread collector to register new threads with
+ * @param num_io_threads number of event-driven I/O threads serving all
+ * clients, zero to spawn threads for each client
  */
 FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_ipv4,
                                                      bool               enable_ipv6,
                                                      const std::string &listen_ipv4,
                                                      const std::string &listen_ipv6,
                                                      unsigned int       fawkes_port,
-                                                     ThreadCollector *  thread_collector)
+                                                     ThreadCollector *  thread_collector,
+                                                     unsigned int       num_io_threads)
 : Thread("FawkesNetworkServerThread", Thread::OPMODE_WAITFORWAKEUP)
 {
 	this->thread_collector = thread_collector;
@@ -69,6 +81,18 @@ FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_i
 	next_client_id   = 1;
 	inbound_messages = new FawkesNetworkMessageQueue();
 
+#ifdef HAVE_EPOLL
+	// must be running before the first connection is accepted
+	for (unsigned int i = 0; i < num_io_threads; ++i) {
+		io_threads.push_back(new FawkesNetworkServerIOThread(this, i));
+		if (thread_collector) {
+			thread_collector->add(io_threads[i]);
+		} else {
+			io_threads[i]->start();
+		}
+	}
+#endif
+
 	if (enable_ipv4) {
 		acceptor_threads.push_back(new NetworkAcceptorThread(
 		  this, Socket::IPv4, listen_ipv4, fawkes_port, "FawkesNetworkAcceptorThread"));
@@ -111,6 +135,18 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 		delete acceptor_threads[i];
 	}
 	acceptor_threads.clear();
+#ifdef HAVE_EPOLL
+	for (size_t i = 0; i < io_threads.size(); ++i) {
+		if (thread_collector) {
+			thread_collector->remove(io_threads[i]);
+		} else {
+			io_threads[i]->cancel();
+			io_threads[i]->join();
+		}
+		delete io_threads[i];
+	}
+	io_threads.clear();
+#endif
 
 	delete inbound_messages;
 }
@@ -122,18 +158,29 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 void
 FawkesNetworkServerThread::add_connection(StreamSocket *s) throw()
 {
-	FawkesNetworkServerClientThread *client = new FawkesNetworkServerClientThread(s, this);
-
-	clients.lock();
-	client->set_clid(next_client_id);
-	if (thread_collector) {
-		thread_collector->add(client);
-	} else {
-		client->start();
+	unsigned int cid;
+#ifdef HAVE_EPOLL
+	if (!io_threads.empty()) {
+		clients.lock();
+		cid = next_client_id++;
+		clients.unlock();
+		io_thread(cid)->add_connection(cid, s);
+	} else
+#endif
+	{
+		FawkesNetworkServerClientThread *client = new FawkesNetworkServerClientThread(s, this);
+
+		clients.lock();
+		client->set_clid(next_client_id);
+		if (thread_collector) {
+			thread_collector->add(client);
+		} else {
+			client->start();
+		}
+		cid          = next_client_id++;
+		clients[cid] = client;
+		clients.unlock();
 	}
-	unsigned int cid = next_client_id++;
-	clients[cid]     = client;
-	clients.unlock();
 
 	MutexLocker handlers_lock(handlers.mutex());
 	for (hit = handlers.begin(); hit != handlers.end(); ++hit) {
@@ -187,6 +234,11 @@ FawkesNetworkServerThread::loop()
 		}
 	}
 	clients.unlock();
+#ifdef HAVE_EPOLL
+	for (size_t i = 0; i < io_threads.size(); ++i) {
+		io_threads[i]->dead_clients(dead_clients);
+	}
+#endif
 
 	std::list<unsigned int>::iterator dci;
 	for (dci = dead_clients.begin(); dci != dead_clients.end(); ++dci) {
@@ -199,6 +251,11 @@ FawkesNetworkServerThread::loop()
 			}
 		}
 
+#ifdef HAVE_EPOLL
+		if (!io_threads.empty()) {
+			io_thread(clid)->remove_connection(clid);
+		} else
+#endif
 		{
 			MutexLocker clients_lock(clients.mutex());
 			if (thread_collector) {
@@ -238,6 +295,11 @@ FawkesNetworkServerThread::force_send()
 		(*cit).second->force_send();
 	}
 	clients.unlock();
+#ifdef HAVE_EPOLL
+	for (size_t i = 0; i < io_threads.size(); ++i) {
+		io_threads[i]->force_send();
+	}
+#endif
 }
 
 /** Broadcast a message.
@@ -249,6 +311,16 @@ FawkesNetworkServerThread::force_send()
 void
 FawkesNetworkServerThread::broadcast(FawkesNetworkMessage *msg)
 {
+#ifdef HAVE_EPOLL
+	if (!io_threads.empty()) {
+		// shared by all I/O threads, pack only once
+		msg->pack();
+		for (size_t i = 0; i < io_threads.size(); ++i) {
+			msg->ref();
+			io_threads[i]->broadcast(msg);
+		}
+	}
+#endif
 	clients.lock();
 	for (cit = clients.begin(); cit != clients.end(); ++cit) {
 		if ((*cit).second->alive()) {
@@ -303,6 +375,14 @@ FawkesNetworkServerThread::broadcast(unsigned short int component_id, unsigned s
 void
 FawkesNetworkServerThread::send(FawkesNetworkMessage *msg)
 {
+#ifdef HAVE_EPOLL
+	if (!io_threads.empty()) {
+		msg->pack();
+		io_thread(msg->clid())->enqueue(msg);
+		return;
+	}
+#endif
+
 	MutexLocker  lock(clients.mutex());
 	unsigned int clid = msg->clid();
 	if (clients.find(clid) != clients.end()) {
@@ -368,6 +448,16 @@ FawkesNetworkServerThread::send(unsigned int       to_clid,
 	send(m);
 }
 
+/** Get I/O thread serving a client.
+ * @param clid client ID
+ * @return I/O thread, only valid if I/O threads are used
+ */
+FawkesNetworkServerIOThread *
+FawkesNetworkServerThread::io_thread(unsigned int clid) const
+{
+	return io_threads[clid % io_threads.size()];
+}
+
 /** Dispatch messages.
  * Actually messages are just put into the inbound message queue and dispatched
  * during the next loop iteration. So after adding all the messages you have
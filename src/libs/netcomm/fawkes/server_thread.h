@@ -37,6 +37,7 @@ namespace fawkes {
 class ThreadCollector;
 class Mutex;
 class FawkesNetworkServerClientThread;
+class FawkesNetworkServerIOThread;
 class NetworkAcceptorThread;
 class FawkesNetworkHandler;
 class FawkesNetworkMessage;
@@ -53,7 +54,8 @@ public:
 	                          const std::string &listen_ipv4,
 	                          const std::string &listen_ipv6,
 	                          unsigned int       fawkes_port,
-	                          ThreadCollector *  thread_collector = 0);
+	                          ThreadCollector *  thread_collector = 0,
+	                          unsigned int       num_io_threads   = 0);
 	virtual ~FawkesNetworkServerThread();
 
 	virtual void loop();
@@ -95,6 +97,8 @@ protected:
 	}
 
 private:
+	FawkesNetworkServerIOThread *io_thread(unsigned int clid) const;
+
 	ThreadCollector *                    thread_collector;
 	unsigned int                         next_client_id;
 	std::vector<NetworkAcceptorThread *> acceptor_threads;
@@ -107,6 +111,9 @@ private:
 	LockMap<unsigned int, FawkesNetworkServerClientThread *>           clients;
 	LockMap<unsigned int, FawkesNetworkServerClientThread *>::iterator cit;
 
+	// clients are assigned to I/O threads by client ID, if any
+	std::vector<FawkesNetworkServerIOThread *> io_threads;
+
 	FawkesNetworkMessageQueue *inbound_messages;
 };
 
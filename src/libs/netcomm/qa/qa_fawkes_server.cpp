@@ -0,0 +1,247 @@
+
+/***************************************************************************
+ *  qa_fawkes_server.cpp - Fawkes QA for the Fawkes network server
+ *
+ *  Created: Fri Oct 30 15:52:41 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <netcomm/fawkes/client.h>
+#include <netcomm/fawkes/client_handler.h>
+#include <netcomm/fawkes/handler.h>
+#include <netcomm/fawkes/server_thread.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define COMPONENT_ID 1
+#define MSGID_ECHO 1
+#define MSGID_BROADCAST 2
+#define PAYLOAD_SIZE 64
+
+// echoes all messages back to the sender
+class EchoHandler : public FawkesNetworkHandler
+{
+public:
+	EchoHandler(FawkesNetworkHub *hub)
+	: FawkesNetworkHandler(COMPONENT_ID), hub_(hub), connected(0), disconnected(0)
+	{
+	}
+
+	virtual void
+	handle_network_message(FawkesNetworkMessage *msg)
+	{
+		void *payload = malloc(msg->payload_size());
+		memcpy(payload, msg->payload(), msg->payload_size());
+		hub_->send(msg->clid(), COMPONENT_ID, msg->msgid(), payload, msg->payload_size());
+	}
+
+	virtual void
+	client_connected(unsigned int clid)
+	{
+		MutexLocker lock(&mutex);
+		++connected;
+	}
+
+	virtual void
+	client_disconnected(unsigned int clid)
+	{
+		MutexLocker lock(&mutex);
+		++disconnected;
+	}
+
+	unsigned int
+	num_connected()
+	{
+		MutexLocker lock(&mutex);
+		return connected - disconnected;
+	}
+
+private:
+	FawkesNetworkHub *hub_;
+	Mutex             mutex;
+	unsigned int      connected;
+	unsigned int      disconnected;
+};
+
+// counts echoes and broadcasts, echoes must arrive in order
+class CountingHandler : public FawkesNetworkClientHandler
+{
+public:
+	CountingHandler() : echoes(0), broadcasts(0), errors(0)
+	{
+	}
+
+	virtual void
+	deregistered(unsigned int id) throw()
+	{
+	}
+
+	virtual void
+	inbound_received(FawkesNetworkMessage *m, unsigned int id) throw()
+	{
+		MutexLocker lock(&mutex);
+		if (m->payload_size() != PAYLOAD_SIZE) {
+			++errors;
+		} else if (m->msgid() == MSGID_ECHO) {
+			if (*(uint32_t *)m->payload() != echoes)
+				++errors;
+			++echoes;
+		} else if (m->msgid() == MSGID_BROADCAST) {
+			++broadcasts;
+		}
+	}
+
+	virtual void
+	connection_died(unsigned int id) throw()
+	{
+	}
+
+	virtual void
+	connection_established(unsigned int id) throw()
+	{
+	}
+
+	bool
+	done(unsigned int num_echoes, unsigned int num_broadcasts)
+	{
+		MutexLocker lock(&mutex);
+		return (echoes >= num_echoes) && (broadcasts >= num_broadcasts);
+	}
+
+	Mutex        mutex;
+	unsigned int echoes;
+	unsigned int broadcasts;
+	unsigned int errors;
+};
+
+static bool
+wait_for(std::vector<CountingHandler *> &handlers, unsigned int echoes, unsigned int broadcasts)
+{
+	for (unsigned int t = 0; t < 3000; ++t) {
+		bool done = true;
+		for (size_t i = 0; done && (i < handlers.size()); ++i) {
+			done = handlers[i]->done(echoes, broadcasts);
+		}
+		if (done)
+			return true;
+		usleep(10000);
+	}
+	return false;
+}
+
+static bool
+test_server(unsigned short int port,
+            unsigned int       num_io_threads,
+            unsigned int       num_clients,
+            unsigned int       num_msgs)
+{
+	FawkesNetworkServerThread *server =
+	  new FawkesNetworkServerThread(true, false, "127.0.0.1", "", port, 0, num_io_threads);
+	EchoHandler *echo = new EchoHandler(server);
+	server->add_handler(echo);
+	server->start();
+
+	std::vector<FawkesNetworkClient *> clients;
+	std::vector<CountingHandler *>     handlers;
+	for (unsigned int i = 0; i < num_clients; ++i) {
+		FawkesNetworkClient *c = new FawkesNetworkClient("127.0.0.1", port);
+		CountingHandler *    h = new CountingHandler();
+		c->register_handler(h, COMPONENT_ID);
+		c->connect();
+		clients.push_back(c);
+		handlers.push_back(h);
+	}
+	for (unsigned int t = 0; (t < 500) && (echo->num_connected() < num_clients); ++t) {
+		usleep(10000);
+	}
+
+	Time start;
+	for (unsigned int m = 0; m < num_msgs; ++m) {
+		for (unsigned int i = 0; i < num_clients; ++i) {
+			FawkesNetworkMessage *msg =
+			  new FawkesNetworkMessage(COMPONENT_ID, MSGID_ECHO, (size_t)PAYLOAD_SIZE);
+			memset(msg->payload(), 0, PAYLOAD_SIZE);
+			*(uint32_t *)msg->payload() = m;
+			clients[i]->enqueue(msg);
+		}
+	}
+	bool ok = wait_for(handlers, num_msgs, 0);
+	Time echoed;
+
+	for (unsigned int m = 0; m < num_msgs; ++m) {
+		server->broadcast(COMPONENT_ID, MSGID_BROADCAST, calloc(1, PAYLOAD_SIZE), PAYLOAD_SIZE);
+	}
+	ok = wait_for(handlers, num_msgs, num_msgs) && ok;
+	Time broadcasted;
+
+	unsigned int errors = 0;
+	for (unsigned int i = 0; i < num_clients; ++i) {
+		errors += handlers[i]->errors;
+		clients[i]->disconnect();
+		clients[i]->deregister_handler(COMPONENT_ID);
+		delete clients[i];
+		delete handlers[i];
+	}
+	for (unsigned int t = 0; (t < 500) && (echo->num_connected() > 0); ++t) {
+		usleep(10000);
+	}
+	ok = ok && (errors == 0) && (echo->num_connected() == 0);
+
+	printf("%2u I/O threads: %u clients x %u msgs  echo %7.1f ms  broadcast %7.1f ms  %s\n",
+	       num_io_threads,
+	       num_clients,
+	       num_msgs,
+	       (echoed - &start) * 1000.,
+	       (broadcasted - &echoed) * 1000.,
+	       ok ? "ok" : "FAILED");
+
+	server->cancel();
+	server->join();
+	server->remove_handler(echo);
+	delete server;
+	delete echo;
+
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int num_clients = (argc > 1) ? atoi(argv[1]) : 20;
+	unsigned int num_msgs    = (argc > 2) ? atoi(argv[2]) : 2000;
+
+	bool ok = test_server(1931, 0, num_clients, num_msgs);
+	ok      = test_server(1932, 2, num_clients, num_msgs) && ok;
+
+	printf("QA %s\n", ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
@@ -966,6 +966,17 @@ Socket::listening()
 	return (i == 1);
 }
 
+/** Get file descriptor.
+ * This is meant for event loops which multiplex many sockets, e.g. with
+ * epoll. Do not close the descriptor, the socket remains its owner.
+ * @return file descriptor of the socket, -1 if not initialized
+ */
+int
+Socket::fd() const
+{
+	return sock_fd;
+}
+
 /** Maximum Transfer Unit (MTU) of socket.
  * Note that this can only be retrieved of connected sockets!
  * @return MTU in bytes
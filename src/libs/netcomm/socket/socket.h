@@ -121,6 +121,8 @@ public:
 
 	virtual unsigned int mtu();
 
+	int fd() const;
+
 	/** Accept connection.
    * This method works like accept() but it ensures that the returned socket is of
    * the given type.
@@ -23,12 +23,17 @@
 #ifndef _LIBS_PCL_UTILS_TRANSFORMS_H_
 #define _LIBS_PCL_UTILS_TRANSFORMS_H_
 
+#include <core/exception.h>
 #include <pcl/common/transforms.h>
 #include <pcl/point_cloud.h>
 #include <pcl_utils/utils.h>
+#include <tf/transform_handle.h>
 #include <tf/transformer.h>
 #include <tf/types.h>
 
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
 namespace fawkes {
 namespace pcl_utils {
 
@@ -59,6 +64,60 @@ transform_pointcloud(const pcl::PointCloud<PointT> &cloud_in,
 	pcl::transformPointCloud(cloud_in, cloud_out, origin, rotation);
 }
 
+/** Apply a rigid transform to an array of points.
+ * The points are transformed in a single pass of vectorized matrix
+ * operations. Points are given as consecutive x, y, z coordinates
+ * with a given stride between the first coordinates of two points,
+ * e.g. sizeof(pcl::PointXYZ) / sizeof(float) to transform the points
+ * of a point cloud directly.
+ * @param transform a rigid transformation from tf
+ * @param points_in input coordinates
+ * @param points_out output coordinates, may be the same as points_in
+ * @param num_points number of points to transform
+ * @param stride number of floats from one point to the next
+ */
+inline void
+transform_points(const tf::Transform &transform,
+                 const float *        points_in,
+                 float *              points_out,
+                 size_t               num_points,
+                 size_t               stride = 3)
+{
+	tf::Quaternion     q = transform.getRotation();
+	Eigen::Quaternionf rotation(q.w(), q.x(), q.y(), q.z());
+	tf::Vector3        v = transform.getOrigin();
+	Eigen::Vector3f    origin(v.x(), v.y(), v.z());
+
+	typedef Eigen::Matrix<float, 3, Eigen::Dynamic>     Points;
+	Eigen::Map<const Points, 0, Eigen::OuterStride<>> in(points_in,
+	                                                      3,
+	                                                      num_points,
+	                                                      Eigen::OuterStride<>(stride));
+	Eigen::Map<Points, 0, Eigen::OuterStride<>> out(points_out,
+	                                                3,
+	                                                num_points,
+	                                                Eigen::OuterStride<>(stride));
+	// the product is evaluated into a temporary, in-place is fine
+	out = (rotation.toRotationMatrix() * in).colwise() + origin;
+}
+
+/** Apply a rigid transform to a point cloud in place.
+ * In contrast to transform_pointcloud() this transforms only the
+ * coordinates of the points in a single pass and neither copies the
+ * cloud nor touches other point fields such as normals.
+ * @param cloud_inout input and output point cloud
+ * @param transform a rigid transformation from tf
+ */
+template <typename PointT>
+void
+transform_points(pcl::PointCloud<PointT> &cloud_inout, const tf::Transform &transform)
+{
+	if (cloud_inout.points.empty())
+		return;
+	float *data = &cloud_inout.points[0].x;
+	transform_points(transform, data, data, cloud_inout.points.size(), sizeof(PointT) / sizeof(float));
+}
+
 /** Apply a rigid transform.
  * @param cloud_inout input and output point cloud
  * @param transform a rigid transformation from tf
@@ -171,6 +230,43 @@ transform_pointcloud(const std::string &      target_frame,
 	cloud_inout = tmp;
 }
 
+/** Transform a point cloud using a transform handle.
+ * The handle determines the target frame. The source frame of the
+ * handle must match the frame of the point cloud. This is preferable
+ * over the other variants if clouds of the same frame are transformed
+ * repeatedly, e.g. for every new scan.
+ * @param handle transform handle
+ * @param cloud_in input point cloud
+ * @param cloud_out output point cloud
+ * @exception tf::TransformException if transform retrieval fails
+ * @exception Exception thrown if the point cloud frame does not match
+ * the source frame of the handle
+ */
+template <typename PointT>
+void
+transform_pointcloud(tf::TransformHandle &          handle,
+                     const pcl::PointCloud<PointT> &cloud_in,
+                     pcl::PointCloud<PointT> &      cloud_out)
+{
+	if (cloud_in.header.frame_id == handle.target_frame()) {
+		cloud_out = cloud_in;
+		return;
+	}
+	if (cloud_in.header.frame_id != handle.source_frame()) {
+		throw Exception("Cloud frame %s does not match handle source frame %s",
+		                cloud_in.header.frame_id.c_str(),
+		                handle.source_frame().c_str());
+	}
+
+	fawkes::Time source_time;
+	pcl_utils::get_time(cloud_in, source_time);
+	tf::StampedTransform transform;
+	handle.lookup_transform(source_time, transform);
+
+	transform_pointcloud(cloud_in, cloud_out, transform);
+	cloud_out.header.frame_id = handle.target_frame();
+}
+
 } // end namespace pcl_utils
 } // end namespace fawkes
 
@@ -0,0 +1,239 @@
+
+/***************************************************************************
+ *  qa_syncpoint.cpp - SyncPoint release check under contention
+ *
+ *  Created: Sun Oct 18 22:16:08 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/utils/refptr.h>
+#include <libs/syncpoint/syncpoint.h>
+#include <libs/syncpoint/syncpoint_manager.h>
+#include <logging/multi.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace std;
+
+#define NUM_THREADS 32
+#define NUM_ROUNDS 500
+// a lost wakeup blocks forever, fail instead
+#define TIMEOUT_SEC 120
+
+static void
+timeout_handler(int signum)
+{
+	const char *msg = "Timeout, a waiter or emitter was not released\nQA FAILED\n";
+	if (write(STDOUT_FILENO, msg, strlen(msg)) < 0) {
+		// exiting anyway
+	}
+	_exit(1);
+}
+
+typedef struct
+{
+	SyncPointManager *manager;
+	string            component;
+	unsigned int      rounds;
+	unsigned int      num_released;
+	volatile bool *   done;
+} worker_params;
+
+/* Wait for the start syncpoint, then emit the end syncpoint. */
+static void *
+barrier_worker(void *data)
+{
+	worker_params *   p        = (worker_params *)data;
+	RefPtr<SyncPoint> sp_start = p->manager->get_syncpoint(p->component, "/qa/start");
+	RefPtr<SyncPoint> sp_end   = p->manager->get_syncpoint(p->component, "/qa/end");
+	for (unsigned int i = 0; i < p->rounds; ++i) {
+		sp_start->wait(p->component);
+		++p->num_released;
+		sp_end->emit(p->component);
+	}
+	return NULL;
+}
+
+/* All workers are released by one emit and the main thread waits until
+ * every worker has emitted, as in the main loop. */
+static unsigned int
+check_barrier(MultiLogger *logger)
+{
+	unsigned int     errors = 0;
+	SyncPointManager manager(logger);
+
+	RefPtr<SyncPoint> sp_start = manager.get_syncpoint("main", "/qa/start");
+	RefPtr<SyncPoint> sp_end   = manager.get_syncpoint("main", "/qa/end");
+	sp_start->register_emitter("main");
+
+	vector<worker_params> params(NUM_THREADS);
+	vector<pthread_t>     threads(NUM_THREADS);
+	for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "barrier %u", i);
+		params[i].manager      = &manager;
+		params[i].component    = name;
+		params[i].rounds       = NUM_ROUNDS;
+		params[i].num_released = 0;
+		sp_end->register_emitter(name);
+	}
+	for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+		pthread_create(&threads[i], NULL, barrier_worker, &params[i]);
+	}
+
+	for (unsigned int r = 0; r < NUM_ROUNDS; ++r) {
+		for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+			while (!sp_start->watcher_is_waiting(params[i].component, SyncPoint::WAIT_FOR_ONE))
+				sched_yield();
+		}
+		sp_end->lock_until_next_wait("main");
+		sp_start->emit("main");
+		sp_end->wait("main", SyncPoint::WAIT_FOR_ALL);
+
+		for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+			if (params[i].num_released != r + 1) {
+				printf("Barrier round %u: %s released %u times\n",
+				       r,
+				       params[i].component.c_str(),
+				       params[i].num_released);
+				++errors;
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+		pthread_join(threads[i], NULL);
+		sp_end->unregister_emitter(params[i].component);
+	}
+	sp_start->unregister_emitter("main");
+
+	printf("Barrier: %u threads released %u times\n", NUM_THREADS, NUM_ROUNDS);
+	return errors;
+}
+
+/* Emit concurrently until all waiters are done. */
+static void *
+emitter(void *data)
+{
+	worker_params *   p  = (worker_params *)data;
+	RefPtr<SyncPoint> sp = p->manager->get_syncpoint(p->component, "/qa/one");
+	sp->register_emitter(p->component);
+	while (!*p->done) {
+		sp->emit(p->component);
+		++p->num_released;
+		sched_yield();
+	}
+	sp->unregister_emitter(p->component);
+	return NULL;
+}
+
+static void *
+waiter(void *data)
+{
+	worker_params *   p  = (worker_params *)data;
+	RefPtr<SyncPoint> sp = p->manager->get_syncpoint(p->component, "/qa/one");
+	for (unsigned int i = 0; i < p->rounds; ++i) {
+		sp->wait_for_one(p->component);
+		++p->num_released;
+	}
+	return NULL;
+}
+
+/* Several emitters and waiters work on one syncpoint at the same time,
+ * every wait must be released by one of the following emits. */
+static unsigned int
+check_wait_for_one(MultiLogger *logger, unsigned int num_emitters, unsigned int num_waiters)
+{
+	unsigned int     errors = 0;
+	SyncPointManager manager(logger);
+	volatile bool    done = false;
+
+	vector<worker_params> emitters(num_emitters), waiters(num_waiters);
+	vector<pthread_t>     emitter_threads(num_emitters), waiter_threads(num_waiters);
+	for (unsigned int i = 0; i < num_waiters; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "waiter %u", i);
+		waiters[i].manager      = &manager;
+		waiters[i].component    = name;
+		waiters[i].rounds       = NUM_ROUNDS;
+		waiters[i].num_released = 0;
+		pthread_create(&waiter_threads[i], NULL, waiter, &waiters[i]);
+	}
+	for (unsigned int i = 0; i < num_emitters; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "emitter %u", i);
+		emitters[i].manager      = &manager;
+		emitters[i].component    = name;
+		emitters[i].num_released = 0;
+		emitters[i].done         = &done;
+		pthread_create(&emitter_threads[i], NULL, emitter, &emitters[i]);
+	}
+
+	for (unsigned int i = 0; i < num_waiters; ++i) {
+		pthread_join(waiter_threads[i], NULL);
+		if (waiters[i].num_released != NUM_ROUNDS) {
+			printf("Wait for one: %s released %u times\n",
+			       waiters[i].component.c_str(),
+			       waiters[i].num_released);
+			++errors;
+		}
+	}
+	done                   = true;
+	unsigned long num_emit = 0;
+	for (unsigned int i = 0; i < num_emitters; ++i) {
+		pthread_join(emitter_threads[i], NULL);
+		num_emit += emitters[i].num_released;
+	}
+
+	printf("Wait for one: %u emitters, %u waiters released %u times, %lu emits\n",
+	       num_emitters,
+	       num_waiters,
+	       NUM_ROUNDS,
+	       num_emit);
+	return errors;
+}
+
+int
+main(int argc, char **argv)
+{
+	signal(SIGALRM, timeout_handler);
+	alarm(TIMEOUT_SEC);
+
+	MultiLogger *logger = new MultiLogger();
+	unsigned int errors = 0;
+
+	errors += check_barrier(logger);
+	errors += check_wait_for_one(logger, 1, NUM_THREADS);
+	errors += check_wait_for_one(logger, 8, NUM_THREADS);
+
+	delete logger;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,206 @@
+/***************************************************************************
+ *  qa_syncpoint_bench.cpp - SyncPoint emit/wake latency benchmark
+ *
+ *  Created: Sun Oct 18 20:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/utils/refptr.h>
+#include <libs/syncpoint/syncpoint.h>
+#include <libs/syncpoint/syncpoint_manager.h>
+#include <logging/multi.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace std;
+
+#define NUM_LATENCY_ROUNDS 2000
+#define NUM_BARRIER_ROUNDS 1000
+
+static inline double
+now_usec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000. + ts.tv_nsec / 1000.;
+}
+
+typedef struct
+{
+	RefPtr<SyncPoint> sp;
+	string            component;
+	unsigned int      rounds;
+	volatile double   emit_time;
+	double            sum_latency;
+	double            max_latency;
+} latency_params;
+
+static void *
+latency_waiter(void *data)
+{
+	latency_params *p = (latency_params *)data;
+	for (unsigned int i = 0; i < p->rounds; ++i) {
+		p->sp->wait_for_one(p->component);
+		double latency = now_usec() - p->emit_time;
+		p->sum_latency += latency;
+		if (latency > p->max_latency)
+			p->max_latency = latency;
+	}
+	return NULL;
+}
+
+/* Time from emit() in one thread until a thread blocked in
+ * wait_for_one() on the same syncpoint runs again. */
+static void
+bench_latency(MultiLogger *logger, bool call_stats)
+{
+	SyncPointManager manager(logger);
+	manager.set_call_stats_enabled(call_stats);
+
+	latency_params p;
+	p.sp          = manager.get_syncpoint("waiter", "/bench/latency");
+	p.component   = "waiter";
+	p.rounds      = NUM_LATENCY_ROUNDS;
+	p.emit_time   = 0.;
+	p.sum_latency = 0.;
+	p.max_latency = 0.;
+	RefPtr<SyncPoint> sp = manager.get_syncpoint("emitter", "/bench/latency");
+	sp->register_emitter("emitter");
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, latency_waiter, &p);
+	for (unsigned int i = 0; i < p.rounds; ++i) {
+		while (!sp->watcher_is_waiting("waiter", SyncPoint::WAIT_FOR_ONE))
+			sched_yield();
+		p.emit_time = now_usec();
+		sp->emit("emitter");
+	}
+	pthread_join(thread, NULL);
+	sp->unregister_emitter("emitter");
+
+	printf("emit->wake   call stats %-3s  avg: %8.2f us  max: %8.2f us\n",
+	       call_stats ? "on" : "off",
+	       p.sum_latency / p.rounds,
+	       p.max_latency);
+}
+
+typedef struct
+{
+	SyncPointManager *manager;
+	string            component;
+	unsigned int      rounds;
+} barrier_params;
+
+static void *
+barrier_thread(void *data)
+{
+	barrier_params   *p        = (barrier_params *)data;
+	RefPtr<SyncPoint> sp_start = p->manager->get_syncpoint(p->component, "/bench/start");
+	RefPtr<SyncPoint> sp_end   = p->manager->get_syncpoint(p->component, "/bench/end");
+	unsigned int      id       = SyncPoint::component_id(p->component);
+	for (unsigned int i = 0; i < p->rounds; ++i) {
+		sp_start->wait(id);
+		sp_end->emit(id);
+	}
+	return NULL;
+}
+
+/* One main loop like cycle: the main thread emits a start syncpoint
+ * and waits until all threads have emitted the end syncpoint. */
+static void
+bench_barrier(MultiLogger *logger, unsigned int num_threads, bool call_stats)
+{
+	SyncPointManager manager(logger);
+	manager.set_call_stats_enabled(call_stats);
+
+	RefPtr<SyncPoint> sp_start = manager.get_syncpoint("main", "/bench/start");
+	RefPtr<SyncPoint> sp_end   = manager.get_syncpoint("main", "/bench/end");
+	sp_start->register_emitter("main");
+
+	vector<barrier_params> params(num_threads);
+	vector<pthread_t>      threads(num_threads);
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "thread %u", i);
+		params[i].manager   = &manager;
+		params[i].component = name;
+		params[i].rounds    = NUM_BARRIER_ROUNDS;
+		sp_end->register_emitter(name);
+	}
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		pthread_create(&threads[i], NULL, barrier_thread, &params[i]);
+	}
+
+	unsigned int main_id = SyncPoint::component_id("main");
+	double       sum_cycle = 0., max_cycle = 0.;
+	for (unsigned int r = 0; r < NUM_BARRIER_ROUNDS; ++r) {
+		// all threads must be blocked before the next cycle starts
+		for (unsigned int i = 0; i < num_threads; ++i) {
+			while (!sp_start->watcher_is_waiting(params[i].component, SyncPoint::WAIT_FOR_ONE))
+				sched_yield();
+		}
+		sp_end->lock_until_next_wait("main");
+		double start = now_usec();
+		sp_start->emit(main_id);
+		sp_end->wait(main_id, SyncPoint::WAIT_FOR_ALL);
+		double cycle = now_usec() - start;
+		sum_cycle += cycle;
+		if (cycle > max_cycle)
+			max_cycle = cycle;
+	}
+
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		pthread_join(threads[i], NULL);
+		sp_end->unregister_emitter(params[i].component);
+	}
+	sp_start->unregister_emitter("main");
+
+	printf("cycle %3u threads  call stats %-3s  avg: %8.2f us  max: %8.2f us\n",
+	       num_threads,
+	       call_stats ? "on" : "off",
+	       sum_cycle / NUM_BARRIER_ROUNDS,
+	       max_cycle);
+}
+
+int
+main(int argc, char **argv)
+{
+	MultiLogger *logger = new MultiLogger();
+
+	bench_latency(logger, true);
+	bench_latency(logger, false);
+
+	unsigned int num_threads[] = {1, 8, 32, 80};
+	for (unsigned int i = 0; i < sizeof(num_threads) / sizeof(unsigned int); ++i) {
+		bench_barrier(logger, num_threads[i], true);
+		bench_barrier(logger, num_threads[i], false);
+	}
+
+	delete logger;
+	return 0;
+}
+
+/// @endcond
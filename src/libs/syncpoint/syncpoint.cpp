@@ -24,13 +24,79 @@
 #include <syncpoint/syncpoint.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
+#include <climits>
 #include <pthread.h>
 #include <string.h>
+#include <time.h>
+#include <unordered_map>
+#ifdef __linux__
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+/** Polling interval of waiters if futexes are not available. */
+#define SYNCPOINT_POLL_INTERVAL_NSEC 100000
+/** Flag set in the pending emitter count while the barrier is reset. */
+#define SYNCPOINT_PENDING_RESET 0x80000000u
 
 using namespace std;
 
 namespace fawkes {
 
+/// @cond INTERNALS
+typedef struct
+{
+	Mutex                                  mutex;
+	std::unordered_map<std::string, unsigned int> ids;
+	std::vector<std::string>               names;
+} SyncPointComponentRegistry;
+
+static SyncPointComponentRegistry &
+component_registry()
+{
+	static SyncPointComponentRegistry registry;
+	return registry;
+}
+
+static inline bool
+test_bit(const uint64_t *bits, unsigned int i)
+{
+	return (__atomic_load_n(&bits[i / 64], __ATOMIC_ACQUIRE) & (1ull << (i % 64))) != 0;
+}
+
+static inline bool
+set_bit(uint64_t *bits, unsigned int i)
+{
+	uint64_t mask = 1ull << (i % 64);
+	return (__atomic_fetch_or(&bits[i / 64], mask, __ATOMIC_ACQ_REL) & mask) == 0;
+}
+
+static inline bool
+clear_bit(uint64_t *bits, unsigned int i)
+{
+	uint64_t mask = 1ull << (i % 64);
+	return (__atomic_fetch_and(&bits[i / 64], ~mask, __ATOMIC_ACQ_REL) & mask) != 0;
+}
+
+static inline void
+clear_bits(uint64_t *bits)
+{
+	for (unsigned int i = 0; i < SYNCPOINT_COMPONENT_WORDS; ++i) {
+		if (__atomic_load_n(&bits[i], __ATOMIC_RELAXED) != 0) {
+			__atomic_store_n(&bits[i], 0, __ATOMIC_RELEASE);
+		}
+	}
+}
+
+static void
+cleanup_waiting(void *num_waiting)
+{
+	__atomic_sub_fetch((unsigned int *)num_waiting, 1, __ATOMIC_SEQ_CST);
+}
+/// @endcond
+
 /** @class SyncPoint <syncpoint/syncpoint.h>
  * The SyncPoint class.
  * This class is used for dynamic synchronization of threads which depend
@@ -41,6 +107,15 @@ namespace fawkes {
  * Thread W wait()s for the SyncPoint to be emitted.
  * Once thread E is done, it emit()s the SyncPoint, which wakes up thread W.
  *
+ * Components are identified by name. Internally, each name is mapped
+ * to a process-wide integer ID (see component_id()), and watchers,
+ * waiters and emitters are tracked per ID. Components which call
+ * emit() and wait() frequently, e.g. in every main loop iteration,
+ * should look up their ID once and use the integer overloads. Emitting
+ * does not take any lock unless the barrier is released, and waiting
+ * threads are woken through a futex. Recording emit and wait calls
+ * can be disabled with set_call_stats_enabled().
+ *
  * @author Till Hofmann
  * @see SyncPointManager
  */
@@ -53,12 +128,15 @@ namespace fawkes {
  * is triggered
  * @param max_waittime_nsec the maximum number of nanoseconds to wait until a
  * timeout is triggered
+ * @param call_stats true to record emit and wait calls
  */
 SyncPoint::SyncPoint(string       identifier,
                      MultiLogger *logger,
                      uint         max_waittime_sec /* = 0 */,
-                     uint         max_waittime_nsec /* = 0 */)
+                     uint         max_waittime_nsec /* = 0 */,
+                     bool         call_stats /* = true */)
 : identifier_(identifier),
+  call_stats_(call_stats),
   emit_calls_(CircularBuffer<SyncPointCall>(1000)),
   wait_for_one_calls_(CircularBuffer<SyncPointCall>(1000)),
   wait_for_all_calls_(CircularBuffer<SyncPointCall>(1000)),
@@ -66,16 +144,26 @@ SyncPoint::SyncPoint(string       identifier,
   mutex_(new Mutex()),
   mutex_next_wait_(new Mutex()),
   cond_next_wait_(new WaitCondition(mutex_next_wait_)),
-  mutex_wait_for_one_(new Mutex()),
-  cond_wait_for_one_(new WaitCondition(mutex_wait_for_one_)),
-  mutex_wait_for_all_(new Mutex()),
-  cond_wait_for_all_(new WaitCondition(mutex_wait_for_all_)),
+  wait_for_one_seq_(0),
+  num_waiting_for_one_(0),
+  wait_for_all_seq_(0),
+  num_waiting_for_all_(0),
   wait_for_all_timer_running_(false),
+  wait_for_all_timer_owner_(-1),
   max_waittime_sec_(max_waittime_sec),
   max_waittime_nsec_(max_waittime_nsec),
   logger_(logger),
-  last_emitter_reset_(Time(0l))
+  num_emitters_(0),
+  num_pending_emitters_(0),
+  emit_locker_(-1),
+  last_emitter_reset_(0)
 {
+	memset(watchers_, 0, sizeof(watchers_));
+	memset(watchers_wait_for_one_, 0, sizeof(watchers_wait_for_one_));
+	memset(watchers_wait_for_all_, 0, sizeof(watchers_wait_for_all_));
+	memset(emitters_, 0, sizeof(emitters_));
+	memset(pending_emitters_, 0, sizeof(pending_emitters_));
+
 	if (identifier.empty()) {
 		cleanup();
 		throw SyncPointInvalidIdentifierException(identifier.c_str());
@@ -98,6 +186,72 @@ SyncPoint::~SyncPoint()
 	cleanup();
 }
 
+/** Get the ID of a component.
+ * Component names are mapped to IDs which are shared among all
+ * SyncPoints of the process. An ID is assigned the first time a name
+ * is used and remains valid for the lifetime of the process.
+ * @param component name of the component
+ * @return ID of the component
+ * @throw Exception thrown if SYNCPOINT_MAX_COMPONENTS IDs have already
+ * been assigned
+ */
+unsigned int
+SyncPoint::component_id(const std::string &component)
+{
+	SyncPointComponentRegistry &r = component_registry();
+	MutexLocker                 ml(&r.mutex);
+
+	std::unordered_map<std::string, unsigned int>::iterator i = r.ids.find(component);
+	if (i != r.ids.end()) {
+		return i->second;
+	}
+	if (r.names.size() >= SYNCPOINT_MAX_COMPONENTS) {
+		throw Exception("SyncPoints: cannot add component %s, "
+		                "maximum number of %u components reached",
+		                component.c_str(),
+		                SYNCPOINT_MAX_COMPONENTS);
+	}
+	unsigned int id = r.names.size();
+	r.names.push_back(component);
+	r.ids[component] = id;
+	return id;
+}
+
+/** Get the name of a component.
+ * @param component_id ID of the component as returned by component_id()
+ * @return name of the component
+ * @throw Exception thrown if no component with the given ID exists
+ */
+std::string
+SyncPoint::component_name(unsigned int component_id)
+{
+	SyncPointComponentRegistry &r = component_registry();
+	MutexLocker                 ml(&r.mutex);
+	if (component_id >= r.names.size()) {
+		throw Exception("SyncPoints: unknown component ID %u", component_id);
+	}
+	return r.names[component_id];
+}
+
+/** Get the ID of a component without assigning a new one.
+ * @param component name of the component
+ * @param component_id upon return set to the ID of the component
+ * @return true if the component has an ID, false otherwise
+ */
+bool
+SyncPoint::find_component_id(const std::string &component, unsigned int &component_id)
+{
+	SyncPointComponentRegistry &r = component_registry();
+	MutexLocker                 ml(&r.mutex);
+
+	std::unordered_map<std::string, unsigned int>::iterator i = r.ids.find(component);
+	if (i == r.ids.end()) {
+		return false;
+	}
+	component_id = i->second;
+	return true;
+}
+
 /**
  * @return the identifier of the SyncPoint
  */
@@ -141,41 +295,73 @@ SyncPoint::operator<(const SyncPoint &other) const
 	return identifier_ < other.get_identifier();
 }
 
+/** Enable or disable recording of calls.
+ * If enabled, the most recent emit and wait calls are recorded and can
+ * be retrieved with get_emit_calls() and get_wait_calls().
+ * @param enabled true to record calls, false to disable recording
+ */
+void
+SyncPoint::set_call_stats_enabled(bool enabled)
+{
+	__atomic_store_n(&call_stats_, enabled, __ATOMIC_RELAXED);
+}
+
+/** Check if calls are recorded.
+ * @return true if emit and wait calls are recorded, false otherwise
+ */
+bool
+SyncPoint::call_stats_enabled() const
+{
+	return __atomic_load_n(&call_stats_, __ATOMIC_RELAXED);
+}
+
 /** Wake up all components which are waiting for this SyncPoint
  * @param component The identifier of the component emitting the SyncPoint
  */
 void
 SyncPoint::emit(const std::string &component)
 {
-	emit(component, true);
+	emit(component_id(component), true);
 }
 
 /** Wake up all components which are waiting for this SyncPoint
- * @param component The identifier of the component emitting the SyncPoint
+ * @param component_id The ID of the component emitting the SyncPoint
+ * @see component_id()
+ */
+void
+SyncPoint::emit(unsigned int component_id)
+{
+	emit(component_id, true);
+}
+
+/** Wake up all components which are waiting for this SyncPoint
+ * @param component The ID of the component emitting the SyncPoint
  * @param remove_from_pending if set to true, the component will be removed
  *        from the pending emitters for this syncpoint
  */
 void
-SyncPoint::emit(const std::string &component, bool remove_from_pending)
+SyncPoint::emit(unsigned int component, bool remove_from_pending)
 {
-	mutex_next_wait_->lock();
-	if (!emit_locker_.empty()) {
-		cond_next_wait_->wait();
+	if (__atomic_load_n(&emit_locker_, __ATOMIC_ACQUIRE) >= 0) {
+		mutex_next_wait_->lock();
+		while (emit_locker_ >= 0) {
+			cond_next_wait_->wait();
+		}
+		mutex_next_wait_->unlock();
 	}
-	mutex_next_wait_->unlock();
-	MutexLocker ml(mutex_);
-	if (!watchers_.count(component)) {
-		throw SyncPointNonWatcherCalledEmitException(component.c_str(), get_identifier().c_str());
+
+	if (component >= SYNCPOINT_MAX_COMPONENTS || !test_bit(watchers_, component)) {
+		throw SyncPointNonWatcherCalledEmitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 
 	// unlock all wait_for_one waiters
-	watchers_wait_for_one_.clear();
-	mutex_wait_for_one_->lock();
-	cond_wait_for_one_->wake_all();
-	mutex_wait_for_one_->unlock();
+	clear_bits(watchers_wait_for_one_);
+	wake(&wait_for_one_seq_, &num_waiting_for_one_);
 
-	if (!emitters_.count(component)) {
-		throw SyncPointNonEmitterCalledEmitException(component.c_str(), get_identifier().c_str());
+	if (__atomic_load_n(&emitters_[component], __ATOMIC_ACQUIRE) == 0) {
+		throw SyncPointNonEmitterCalledEmitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 
 	/* 1. remember whether the component was pending; if so, it may be removed
@@ -184,28 +370,26 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
    * 2. only erase the component once; it may be registered multiple times
    */
 	bool pred_remove_from_pending = false;
-	if (remove_from_pending) {
-		multiset<string>::iterator it_pending = pending_emitters_.find(component);
-		if (it_pending != pending_emitters_.end()) {
-			pending_emitters_.erase(it_pending);
-			if (predecessor_) {
-				if (last_emitter_reset_ <= predecessor_->last_emitter_reset_) {
-					pred_remove_from_pending = true;
-				}
+	if (remove_from_pending && take_pending(component)) {
+		if (predecessor_) {
+			if (__atomic_load_n(&last_emitter_reset_, __ATOMIC_ACQUIRE)
+			    <= __atomic_load_n(&predecessor_->last_emitter_reset_, __ATOMIC_ACQUIRE)) {
+				pred_remove_from_pending = true;
 			}
+		}
 
-			// unlock all wait_for_all waiters if all pending emitters have emitted
-			if (pending_emitters_.empty()) {
-				watchers_wait_for_all_.clear();
-				mutex_wait_for_all_->lock();
-				cond_wait_for_all_->wake_all();
-				mutex_wait_for_all_->unlock();
-				reset_emitters();
-			}
+		// unlock all wait_for_all waiters if all pending emitters have emitted
+		if (release_pending()) {
+			clear_bits(watchers_wait_for_all_);
+			reset_emitters();
+			wake(&wait_for_all_seq_, &num_waiting_for_all_);
 		}
 	}
 
-	emit_calls_.push_back(SyncPointCall(component));
+	if (call_stats_enabled()) {
+		MutexLocker ml(mutex_);
+		emit_calls_.push_back(SyncPointCall(component_name(component)));
+	}
 
 	if (predecessor_) {
 		predecessor_->emit(component, pred_remove_from_pending);
@@ -241,110 +425,125 @@ SyncPoint::wait(const std::string &component,
                 uint               wait_sec /* = 0 */,
                 uint               wait_nsec /* = 0 */)
 {
-	MutexLocker ml(mutex_);
+	wait(component_id(component), type, wait_sec, wait_nsec);
+}
 
-	std::set<std::string> *        watchers;
-	WaitCondition *                cond;
+/** Wait until SyncPoint is emitted.
+ * @param component The ID of the component waiting for the SyncPoint
+ * @param type the wakeup type
+ * @param wait_sec number of seconds to wait for the SyncPoint
+ * @param wait_nsec number of nanoseconds to wait for the SyncPoint
+ * @see wait(const std::string &, WakeupType, uint, uint)
+ * @see component_id()
+ */
+void
+SyncPoint::wait(unsigned int component,
+                WakeupType   type /* = WAIT_FOR_ONE */,
+                uint         wait_sec /* = 0 */,
+                uint         wait_nsec /* = 0 */)
+{
+	uint64_t *                     watchers;
+	uint32_t *                     seq;
+	unsigned int *                 num_waiting;
 	CircularBuffer<SyncPointCall> *calls;
-	Mutex *                        mutex_cond;
-	bool *                         timer_running;
-	string *                       timer_owner;
-	// set watchers, cond and calls depending of the Wakeup type
+	// set watchers, seq and calls depending of the Wakeup type
 	if (type == WAIT_FOR_ONE) {
-		watchers      = &watchers_wait_for_one_;
-		cond          = cond_wait_for_one_;
-		mutex_cond    = mutex_wait_for_one_;
-		calls         = &wait_for_one_calls_;
-		timer_running = NULL;
+		watchers    = watchers_wait_for_one_;
+		seq         = &wait_for_one_seq_;
+		num_waiting = &num_waiting_for_one_;
+		calls       = &wait_for_one_calls_;
 	} else if (type == WAIT_FOR_ALL) {
-		watchers      = &watchers_wait_for_all_;
-		cond          = cond_wait_for_all_;
-		mutex_cond    = mutex_wait_for_all_;
-		timer_running = &wait_for_all_timer_running_;
-		timer_owner   = &wait_for_all_timer_owner_;
-		calls         = &wait_for_all_calls_;
+		watchers    = watchers_wait_for_all_;
+		seq         = &wait_for_all_seq_;
+		num_waiting = &num_waiting_for_all_;
+		calls       = &wait_for_all_calls_;
 	} else {
 		throw SyncPointInvalidTypeException();
 	}
 
-	Time start;
-	mutex_cond->lock();
+	bool call_stats = call_stats_enabled();
+	Time start(0l);
+	if (call_stats)
+		start.stamp();
+
+	MutexLocker ml(mutex_);
 
 	// check if calling component is registered for this SyncPoint
-	if (!watchers_.count(component)) {
-		mutex_cond->unlock();
-		throw SyncPointNonWatcherCalledWaitException(component.c_str(), get_identifier().c_str());
+	if (component >= SYNCPOINT_MAX_COMPONENTS || !test_bit(watchers_, component)) {
+		throw SyncPointNonWatcherCalledWaitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 	// check if calling component is not already waiting
-	if (watchers->count(component)) {
-		mutex_cond->unlock();
-		throw SyncPointMultipleWaitCallsException(component.c_str(), get_identifier().c_str());
+	if (test_bit(watchers, component)) {
+		throw SyncPointMultipleWaitCallsException(component_name(component).c_str(),
+		                                          get_identifier().c_str());
 	}
 
 	/* if type == WAIT_FOR_ALL but no emitter has registered, we can
    * immediately return
    * if type == WAIT_FOR_ONE, we always wait
    */
-	bool need_to_wait = !emitters_.empty() || type == WAIT_FOR_ONE;
+	bool     need_to_wait = __atomic_load_n(&num_emitters_, __ATOMIC_ACQUIRE) > 0 || type == WAIT_FOR_ONE;
+	uint32_t seq_value    = 0;
 	if (need_to_wait) {
-		watchers->insert(component);
+		set_bit(watchers, component);
+		// must be counted before reading the sequence, cf. wake()
+		__atomic_add_fetch(num_waiting, 1, __ATOMIC_SEQ_CST);
+		seq_value = __atomic_load_n(seq, __ATOMIC_SEQ_CST);
 	}
 
-	mutex_next_wait_->lock();
-	if (emit_locker_ == component) {
-		emit_locker_ = "";
+	if (__atomic_load_n(&emit_locker_, __ATOMIC_ACQUIRE) == (int)component) {
+		mutex_next_wait_->lock();
+		__atomic_store_n(&emit_locker_, -1, __ATOMIC_RELEASE);
 		cond_next_wait_->wake_all();
+		mutex_next_wait_->unlock();
 	}
-	mutex_next_wait_->unlock();
+
 	if (need_to_wait) {
 		if (type == WAIT_FOR_ONE) {
 			ml.unlock();
-			bool timeout;
-			pthread_cleanup_push(cleanup_mutex, mutex_cond);
-			timeout = !cond->reltimed_wait(wait_sec, wait_nsec);
-			pthread_cleanup_pop(1);
+			bool timeout = !wait_for_change(seq, seq_value, num_waiting, wait_sec, wait_nsec);
 			if (timeout) {
 				ml.relock();
 				handle_default(component, type);
 				ml.unlock();
 			}
 		} else {
-			if (*timer_running) {
+			if (wait_for_all_timer_running_) {
 				ml.unlock();
-				pthread_cleanup_push(cleanup_mutex, mutex_cond);
-				cond->wait();
-				pthread_cleanup_pop(1);
+				wait_for_change(seq, seq_value, num_waiting, 0, 0);
 			} else {
-				*timer_running = true;
-				*timer_owner   = component;
+				wait_for_all_timer_running_ = true;
+				wait_for_all_timer_owner_   = component;
 				if (wait_sec != 0 || wait_nsec != 0) {
 					max_waittime_sec_  = wait_sec;
 					max_waittime_nsec_ = wait_nsec;
 				}
+				uint timeout_sec  = max_waittime_sec_;
+				uint timeout_nsec = max_waittime_nsec_;
 				ml.unlock();
-				bool timeout;
-				pthread_cleanup_push(cleanup_mutex, mutex_cond);
-				timeout = !cond->reltimed_wait(max_waittime_sec_, max_waittime_nsec_);
-				pthread_cleanup_pop(1);
+				bool timeout = !wait_for_change(seq, seq_value, num_waiting, timeout_sec, timeout_nsec);
 				ml.relock();
-				*timer_running = false;
+				wait_for_all_timer_running_ = false;
 				if (timeout) {
-					// wait failed, handle default
+					// wait failed, handle default and release all other waiters
 					handle_default(component, type);
-					mutex_cond->lock();
-					cond->wake_all();
-					mutex_cond->unlock();
+					wake(seq, num_waiting);
 				}
 				ml.unlock();
 			}
 		}
+		// the emitter may have cleared the waiters before we were registered
+		clear_bit(watchers, component);
 	} else {
 		ml.unlock();
-		mutex_cond->unlock();
 	}
-	Time wait_time = Time() - start;
-	ml.relock();
-	calls->push_back(SyncPointCall(component, start, wait_time));
+
+	if (call_stats) {
+		Time wait_time = Time() - start;
+		ml.relock();
+		calls->push_back(SyncPointCall(component_name(component), start, wait_time));
+	}
 }
 
 /** Wait for a single emitter.
@@ -395,10 +594,14 @@ SyncPoint::reltime_wait_for_all(const string &component, uint wait_sec, uint wai
 void
 SyncPoint::unwait(const string &component)
 {
+	unsigned int id;
+	if (!find_component_id(component, id)) {
+		return;
+	}
 	MutexLocker ml(mutex_);
-	watchers_wait_for_one_.erase(component);
-	watchers_wait_for_all_.erase(component);
-	if (wait_for_all_timer_owner_ == component) {
+	clear_bit(watchers_wait_for_one_, id);
+	clear_bit(watchers_wait_for_all_, id);
+	if (wait_for_all_timer_owner_ == (int)id) {
 		// TODO: this lets the other waiting components wait indefinitely, even on
 		// a timed wait.
 		wait_for_all_timer_running_ = false;
@@ -415,16 +618,17 @@ SyncPoint::unwait(const string &component)
 void
 SyncPoint::lock_until_next_wait(const string &component)
 {
-	MutexLocker ml(mutex_);
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
 	mutex_next_wait_->lock();
-	if (emit_locker_.empty()) {
-		emit_locker_ = component;
+	if (emit_locker_ < 0) {
+		__atomic_store_n(&emit_locker_, (int)id, __ATOMIC_RELEASE);
 	} else {
 		logger_->log_warn("SyncPoints",
 		                  "%s tried to call lock_until_next_wait, "
 		                  "but %s already did the same. Ignoring.",
 		                  component.c_str(),
-		                  emit_locker_.c_str());
+		                  component_name(emit_locker_).c_str());
 	}
 	mutex_next_wait_->unlock();
 }
@@ -436,9 +640,14 @@ SyncPoint::lock_until_next_wait(const string &component)
 void
 SyncPoint::register_emitter(const string &component)
 {
-	MutexLocker ml(mutex_);
-	emitters_.insert(component);
-	pending_emitters_.insert(component);
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
+	if (find(emitter_ids_.begin(), emitter_ids_.end(), id) == emitter_ids_.end()) {
+		emitter_ids_.push_back(id);
+	}
+	__atomic_store_n(&emitters_[id], emitters_[id] + 1, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&num_emitters_, 1, __ATOMIC_ACQ_REL);
+	add_pending(id);
 	if (predecessor_) {
 		predecessor_->register_emitter(component);
 	}
@@ -454,20 +663,30 @@ void
 SyncPoint::unregister_emitter(const string &component, bool emit_if_pending)
 {
 	// TODO should this throw if the calling component is not registered?
-	multiset<string>::iterator it_emitter = emitters_.find(component);
-	if (it_emitter == emitters_.end()) {
+	unsigned int id;
+	if (!find_component_id(component, id)) {
 		// component is not an emitter
 		return;
 	}
 	MutexLocker ml(mutex_);
-	if (emit_if_pending && is_pending(component)) {
+	if (emitters_[id] == 0) {
+		// component is not an emitter
+		return;
+	}
+	if (emit_if_pending && is_pending(id)) {
 		ml.unlock();
-		emit(component);
+		emit(id);
 		ml.relock();
+		if (emitters_[id] == 0) {
+			// concurrently unregistered
+			return;
+		}
 	}
 
-	// erase a single element from the set of emitters
-	emitters_.erase(it_emitter);
+	// erase a single registration of the emitter, it remains in
+	// emitter_ids_ until the next reset as it may still be pending
+	__atomic_store_n(&emitters_[id], emitters_[id] - 1, __ATOMIC_RELEASE);
+	__atomic_sub_fetch(&num_emitters_, 1, __ATOMIC_ACQ_REL);
 	if (predecessor_) {
 		// never emit the predecessor if it's pending; it is already emitted above
 		predecessor_->unregister_emitter(component, false);
@@ -481,8 +700,12 @@ SyncPoint::unregister_emitter(const string &component, bool emit_if_pending)
 bool
 SyncPoint::is_emitter(const string &component) const
 {
+	unsigned int id;
+	if (!find_component_id(component, id)) {
+		return false;
+	}
 	MutexLocker ml(mutex_);
-	return emitters_.count(component) > 0;
+	return emitters_[id] > 0;
 }
 
 /** Check if the given component is a watch.
@@ -492,21 +715,38 @@ SyncPoint::is_emitter(const string &component) const
 bool
 SyncPoint::is_watcher(const string &component) const
 {
-	MutexLocker ml(mutex_);
-	return watchers_.count(component) > 0;
+	unsigned int id;
+	if (!find_component_id(component, id)) {
+		return false;
+	}
+	return test_bit(watchers_, id);
 }
 
 /** Add a watcher to the watch list
  *  @param watcher the new watcher
- *  @return A pair, of which the first element is an iterator that points
- *           to the possibly inserted element, and the second is a bool
- *           that is true if the element was actually inserted.
+ *  @return true if the watcher was added, false if it already was a watcher
+ */
+bool
+SyncPoint::add_watcher(const string &watcher)
+{
+	unsigned int id = component_id(watcher);
+	MutexLocker  ml(mutex_);
+	return set_bit(watchers_, id);
+}
+
+/** Remove a watcher from the watch list
+ *  @param watcher the watcher to remove
+ *  @return true if the watcher was removed, false if it was not a watcher
  */
-pair<set<string>::iterator, bool>
-SyncPoint::add_watcher(string watcher)
+bool
+SyncPoint::remove_watcher(const string &watcher)
 {
+	unsigned int id;
+	if (!find_component_id(watcher, id)) {
+		return false;
+	}
 	MutexLocker ml(mutex_);
-	return watchers_.insert(watcher);
+	return clear_bit(watchers_, id);
 }
 
 /**
@@ -515,8 +755,13 @@ SyncPoint::add_watcher(string watcher)
 std::set<std::string>
 SyncPoint::get_watchers() const
 {
-	MutexLocker ml(mutex_);
-	return watchers_;
+	std::set<std::string> watchers;
+	for (unsigned int i = 0; i < SYNCPOINT_MAX_COMPONENTS; ++i) {
+		if (test_bit(watchers_, i)) {
+			watchers.insert(component_name(i));
+		}
+	}
+	return watchers;
 }
 
 /**
@@ -542,7 +787,16 @@ SyncPoint::get_wait_calls(WakeupType type /* = WAIT_FOR_ONE */) const
 multiset<string>
 SyncPoint::get_emitters() const
 {
-	return emitters_;
+	MutexLocker      ml(mutex_);
+	multiset<string> emitters;
+	for (vector<unsigned int>::const_iterator e = emitter_ids_.begin(); e != emitter_ids_.end();
+	     ++e) {
+		std::string name = component_name(*e);
+		for (unsigned int i = 0; i < emitters_[*e]; ++i) {
+			emitters.insert(name);
+		}
+	}
+	return emitters;
 }
 
 /**
@@ -564,15 +818,13 @@ SyncPoint::get_emit_calls() const
 bool
 SyncPoint::watcher_is_waiting(std::string watcher, WakeupType type) const
 {
-	switch (type) {
-	case SyncPoint::WAIT_FOR_ONE: {
-		MutexLocker ml(*mutex_wait_for_one_);
-		return watchers_wait_for_one_.count(watcher);
-	}
-	case SyncPoint::WAIT_FOR_ALL: {
-		MutexLocker ml(*mutex_wait_for_all_);
-		return watchers_wait_for_all_.count(watcher);
+	unsigned int id;
+	if (!find_component_id(watcher, id)) {
+		return false;
 	}
+	switch (type) {
+	case SyncPoint::WAIT_FOR_ONE: return test_bit(watchers_wait_for_one_, id);
+	case SyncPoint::WAIT_FOR_ALL: return test_bit(watchers_wait_for_all_, id);
 	default: throw Exception("Unknown watch type %u for syncpoint %s", type, identifier_.c_str());
 	}
 }
@@ -580,51 +832,194 @@ SyncPoint::watcher_is_waiting(std::string watcher, WakeupType type) const
 void
 SyncPoint::reset_emitters()
 {
-	last_emitter_reset_ = Time();
-	pending_emitters_   = emitters_;
+	MutexLocker ml(mutex_);
+	__atomic_store_n(&last_emitter_reset_, Time().in_usec(), __ATOMIC_RELEASE);
+	unsigned int num_pending = 0;
+	for (vector<unsigned int>::iterator e = emitter_ids_.begin(); e != emitter_ids_.end();) {
+		if (emitters_[*e] == 0) {
+			e = emitter_ids_.erase(e);
+		} else {
+			num_pending += emitters_[*e];
+			++e;
+		}
+	}
+	// publish the total first, so that it never drops below the sum of
+	// the pending counts while they are restored
+	__atomic_store_n(&num_pending_emitters_, num_pending, __ATOMIC_RELEASE);
+	for (vector<unsigned int>::iterator e = emitter_ids_.begin(); e != emitter_ids_.end(); ++e) {
+		__atomic_store_n(&pending_emitters_[*e], emitters_[*e], __ATOMIC_RELEASE);
+	}
 }
 
 bool
-SyncPoint::is_pending(string component)
+SyncPoint::is_pending(unsigned int component)
 {
-	return pending_emitters_.count(component) > 0;
+	return __atomic_load_n(&pending_emitters_[component], __ATOMIC_ACQUIRE) > 0;
 }
 
 void
-SyncPoint::handle_default(string component, WakeupType type)
+SyncPoint::add_pending(unsigned int component)
+{
+	// must hold mutex_. If the barrier is just being released, the
+	// following reset_emitters() picks up the new emitter.
+	unsigned int num_pending = __atomic_load_n(&num_pending_emitters_, __ATOMIC_ACQUIRE);
+	do {
+		if (num_pending & SYNCPOINT_PENDING_RESET) {
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(&num_pending_emitters_,
+	                                      &num_pending,
+	                                      num_pending + 1,
+	                                      false,
+	                                      __ATOMIC_ACQ_REL,
+	                                      __ATOMIC_ACQUIRE));
+	__atomic_add_fetch(&pending_emitters_[component], 1, __ATOMIC_ACQ_REL);
+}
+
+bool
+SyncPoint::take_pending(unsigned int component)
+{
+	unsigned int pending = __atomic_load_n(&pending_emitters_[component], __ATOMIC_ACQUIRE);
+	while (pending > 0) {
+		if (__atomic_compare_exchange_n(&pending_emitters_[component],
+		                                &pending,
+		                                pending - 1,
+		                                false,
+		                                __ATOMIC_ACQ_REL,
+		                                __ATOMIC_ACQUIRE)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool
+SyncPoint::release_pending()
+{
+	// the last pending emitter marks the barrier as being reset instead
+	// of setting the count to zero, so that a concurrent register_emitter()
+	// cannot release it a second time
+	unsigned int num_pending = __atomic_load_n(&num_pending_emitters_, __ATOMIC_ACQUIRE);
+	unsigned int new_pending;
+	do {
+		new_pending = (num_pending == 1) ? SYNCPOINT_PENDING_RESET : num_pending - 1;
+	} while (!__atomic_compare_exchange_n(&num_pending_emitters_,
+	                                      &num_pending,
+	                                      new_pending,
+	                                      false,
+	                                      __ATOMIC_ACQ_REL,
+	                                      __ATOMIC_ACQUIRE));
+	return (new_pending == SYNCPOINT_PENDING_RESET);
+}
+
+bool
+SyncPoint::wait_for_change(uint32_t *    seq,
+                           uint32_t      seq_value,
+                           unsigned int *num_waiting,
+                           uint          sec,
+                           uint          nsec)
 {
-	logger_->log_warn(component.c_str(),
+	bool            changed = true;
+	bool            timed   = (sec != 0 || nsec != 0);
+	struct timespec deadline;
+	if (timed) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += sec + (deadline.tv_nsec + nsec) / 1000000000;
+		deadline.tv_nsec = (deadline.tv_nsec + nsec) % 1000000000;
+	}
+
+	pthread_cleanup_push(cleanup_waiting, num_waiting);
+	while (__atomic_load_n(seq, __ATOMIC_ACQUIRE) == seq_value) {
+		struct timespec  remaining = {0, 0};
+		struct timespec *timeout   = timed ? &remaining : NULL;
+		if (timed) {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			remaining.tv_sec  = deadline.tv_sec - now.tv_sec;
+			remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+			if (remaining.tv_nsec < 0) {
+				remaining.tv_sec -= 1;
+				remaining.tv_nsec += 1000000000;
+			}
+			if (remaining.tv_sec < 0) {
+				changed = false;
+				break;
+			}
+		}
+#ifdef __linux__
+		// A futex wait is no cancellation point. Like the cancellable system
+		// calls of the C library, allow asynchronous cancellation during the
+		// system call only, no locks are held and no memory is allocated.
+		int old_cancel_type;
+		pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &old_cancel_type);
+		syscall(SYS_futex, seq, FUTEX_WAIT_PRIVATE, seq_value, timeout, NULL, 0);
+		pthread_setcanceltype(old_cancel_type, NULL);
+#else
+		struct timespec poll_interval = {0, SYNCPOINT_POLL_INTERVAL_NSEC};
+		if (timeout && timeout->tv_sec == 0 && timeout->tv_nsec < poll_interval.tv_nsec) {
+			poll_interval = *timeout;
+		}
+		nanosleep(&poll_interval, NULL);
+		pthread_testcancel();
+#endif
+	}
+	pthread_cleanup_pop(1);
+	return changed;
+}
+
+void
+SyncPoint::wake(uint32_t *seq, unsigned int *num_waiting)
+{
+	__atomic_add_fetch(seq, 1, __ATOMIC_SEQ_CST);
+	// a waiter increments num_waiting before reading seq, so it either
+	// sees the new sequence or is counted here
+	if (__atomic_load_n(num_waiting, __ATOMIC_SEQ_CST) > 0) {
+#ifdef __linux__
+		syscall(SYS_futex, seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+	}
+}
+
+void
+SyncPoint::handle_default(unsigned int component, WakeupType type)
+{
+	std::string component_str = component_name(component);
+	logger_->log_warn(component_str.c_str(),
 	                  "Thread time limit exceeded while waiting for syncpoint '%s'. "
 	                  "Time limit: %f sec.",
 	                  get_identifier().c_str(),
 	                  max_waittime_sec_ + static_cast<float>(max_waittime_nsec_) / 1000000000.f);
-	bad_components_.insert(pending_emitters_.begin(), pending_emitters_.end());
+	for (vector<unsigned int>::iterator e = emitter_ids_.begin(); e != emitter_ids_.end(); ++e) {
+		if (is_pending(*e)) {
+			bad_components_.insert(*e);
+		}
+	}
 	if (bad_components_.size() > 1) {
 		string bad_components_string = "";
-		for (set<string>::const_iterator it = bad_components_.begin(); it != bad_components_.end();
+		for (set<unsigned int>::const_iterator it = bad_components_.begin();
+		     it != bad_components_.end();
 		     it++) {
-			bad_components_string += " " + *it;
+			bad_components_string += " " + component_name(*it);
 		}
-		logger_->log_warn(component.c_str(), "bad components:%s", bad_components_string.c_str());
+		logger_->log_warn(component_str.c_str(), "bad components:%s", bad_components_string.c_str());
 	} else if (bad_components_.size() == 1) {
-		logger_->log_warn(component.c_str(), "bad component: %s", bad_components_.begin()->c_str());
+		logger_->log_warn(component_str.c_str(),
+		                  "bad component: %s",
+		                  component_name(*bad_components_.begin()).c_str());
 	} else if (type == SyncPoint::WAIT_FOR_ALL) {
 		throw Exception("SyncPoints: component %s defaulted, "
 		                "but there is no pending emitter. This is probably a bug.",
-		                component.c_str());
+		                component_str.c_str());
 	}
 
-	watchers_wait_for_all_.erase(component);
-	watchers_wait_for_one_.erase(component);
+	clear_bit(watchers_wait_for_all_, component);
+	clear_bit(watchers_wait_for_one_, component);
 }
 
 void
 SyncPoint::cleanup()
 {
-	delete cond_wait_for_one_;
-	delete mutex_wait_for_one_;
-	delete cond_wait_for_all_;
-	delete mutex_wait_for_all_;
+	delete cond_next_wait_;
 	delete mutex_next_wait_;
 	delete mutex_;
 }
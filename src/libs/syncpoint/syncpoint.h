@@ -33,7 +33,14 @@
 
 #include <map>
 #include <set>
+#include <stdint.h>
 #include <string>
+#include <vector>
+
+/** Maximum number of distinct components using SyncPoints. */
+#define SYNCPOINT_MAX_COMPONENTS 1024
+/** Number of 64 bit words for a bitset over all components. */
+#define SYNCPOINT_COMPONENT_WORDS (SYNCPOINT_MAX_COMPONENTS / 64)
 
 namespace fawkes {
 
@@ -58,17 +65,26 @@ public:
 	SyncPoint(std::string  identifier,
 	          MultiLogger *logger,
 	          uint         max_waittime_sec  = 0,
-	          uint         max_waittime_nsec = 0);
+	          uint         max_waittime_nsec = 0,
+	          bool         call_stats        = true);
 	virtual ~SyncPoint();
 
+	static unsigned int component_id(const std::string &component);
+	static std::string  component_name(unsigned int component_id);
+
 	/** send a signal to all waiting threads */
 	virtual void emit(const std::string &component);
+	virtual void emit(unsigned int component_id);
 
 	/** wait for the sync point to be emitted by any other component */
 	virtual void wait(const std::string &component,
 	                  WakeupType     = WAIT_FOR_ONE,
 	                  uint wait_sec  = 0,
 	                  uint wait_nsec = 0);
+	virtual void wait(unsigned int component_id,
+	                  WakeupType     = WAIT_FOR_ONE,
+	                  uint wait_sec  = 0,
+	                  uint wait_nsec = 0);
 	/** abort waiting */
 	virtual void unwait(const std::string &component);
 	virtual void wait_for_one(const std::string &component);
@@ -92,6 +108,9 @@ public:
 	bool        operator==(const std::string &other) const;
 	bool        operator<(const SyncPoint &other) const;
 
+	void set_call_stats_enabled(bool enabled);
+	bool call_stats_enabled() const;
+
 	std::set<std::string>         get_watchers() const;
 	std::multiset<std::string>    get_emitters() const;
 	CircularBuffer<SyncPointCall> get_wait_calls(WakeupType type = WAIT_FOR_ONE) const;
@@ -104,20 +123,23 @@ public:
 	friend class SyncPointManager;
 
 protected:
-	std::pair<std::set<std::string>::iterator, bool> add_watcher(std::string watcher);
+	bool add_watcher(const std::string &watcher);
+	bool remove_watcher(const std::string &watcher);
 	/** send a signal to all waiting threads */
-	virtual void emit(const std::string &component, bool remove_from_pending);
+	virtual void emit(unsigned int component_id, bool remove_from_pending);
 
 protected:
 	/** The unique identifier of the SyncPoint */
 	const std::string identifier_;
-	/** Set of all components which use this SyncPoint */
-	std::set<std::string> watchers_;
-	/** Set of all components which are currently waiting for a single emitter */
-	std::set<std::string> watchers_wait_for_one_;
-	/** Set of all components which are currently waiting on the barrier */
-	std::set<std::string> watchers_wait_for_all_;
-
+	/** Bitset of all components which use this SyncPoint */
+	uint64_t watchers_[SYNCPOINT_COMPONENT_WORDS];
+	/** Bitset of all components which are currently waiting for a single emitter */
+	uint64_t watchers_wait_for_one_[SYNCPOINT_COMPONENT_WORDS];
+	/** Bitset of all components which are currently waiting on the barrier */
+	uint64_t watchers_wait_for_all_[SYNCPOINT_COMPONENT_WORDS];
+
+	/** true to record emit and wait calls */
+	bool call_stats_;
 	/** A buffer of the most recent emit calls. */
 	CircularBuffer<SyncPointCall> emit_calls_;
 	/** A buffer of the most recent wait calls of type WAIT_FOR_ONE. */
@@ -133,18 +155,18 @@ protected:
 	Mutex *mutex_next_wait_;
 	/** WaitCondition used for lock_until_next_wait */
 	WaitCondition *cond_next_wait_;
-	/** Mutex used for cond_wait_for_one_ */
-	Mutex *mutex_wait_for_one_;
-	/** WaitCondition which is used for wait_for_one() */
-	WaitCondition *cond_wait_for_one_;
-	/** Mutex used for cond_wait_for_all_ */
-	Mutex *mutex_wait_for_all_;
-	/** WaitCondition which is used for wait_for_all() */
-	WaitCondition *cond_wait_for_all_;
+	/** Sequence number incremented on every emit, wait_for_one() waits on it */
+	uint32_t wait_for_one_seq_;
+	/** Number of components blocked in wait_for_one() */
+	unsigned int num_waiting_for_one_;
+	/** Sequence number incremented whenever the barrier is released */
+	uint32_t wait_for_all_seq_;
+	/** Number of components blocked in wait_for_all() */
+	unsigned int num_waiting_for_all_;
 	/** true if the wait for all timer is running */
 	bool wait_for_all_timer_running_;
-	/** the component that started the wait-for-all timer */
-	std::string wait_for_all_timer_owner_;
+	/** the component that started the wait-for-all timer, -1 if none */
+	int wait_for_all_timer_owner_;
 	/** maximum waiting time in secs */
 	uint max_waittime_sec_;
 	/** maximum waiting time in nsecs */
@@ -155,10 +177,17 @@ protected:
 
 private:
 	void reset_emitters();
-	bool is_pending(std::string component);
-	void handle_default(std::string component, WakeupType type);
+	bool is_pending(unsigned int component_id);
+	void add_pending(unsigned int component_id);
+	bool take_pending(unsigned int component_id);
+	bool release_pending();
+	bool wait_for_change(uint32_t *seq, uint32_t seq_value, unsigned int *num_waiting, uint sec, uint nsec);
+	void wake(uint32_t *seq, unsigned int *num_waiting);
+	void handle_default(unsigned int component_id, WakeupType type);
 	void cleanup();
 
+	static bool find_component_id(const std::string &component, unsigned int &component_id);
+
 private:
 	/** The predecessor SyncPoint, which is the SyncPoint one level up
      *  e.g. "/test/sp" -> "/test"
@@ -168,14 +197,17 @@ private:
 	/** all successors */
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> successors_;
 
-	std::multiset<std::string> emitters_;
-	std::multiset<std::string> pending_emitters_;
+	unsigned int              emitters_[SYNCPOINT_MAX_COMPONENTS];
+	unsigned int              pending_emitters_[SYNCPOINT_MAX_COMPONENTS];
+	std::vector<unsigned int> emitter_ids_;
+	unsigned int              num_emitters_;
+	unsigned int              num_pending_emitters_;
 
-	std::set<std::string> bad_components_;
+	std::set<unsigned int> bad_components_;
 
-	std::string emit_locker_;
+	int emit_locker_;
 
-	Time last_emitter_reset_;
+	int64_t last_emitter_reset_;
 };
 
 } // end namespace fawkes
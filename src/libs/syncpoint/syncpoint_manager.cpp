@@ -43,7 +43,8 @@ namespace fawkes {
 /** Constructor.
  *  @param logger the logger to use for logging messages
  */
-SyncPointManager::SyncPointManager(MultiLogger *logger) : mutex_(new Mutex()), logger_(logger)
+SyncPointManager::SyncPointManager(MultiLogger *logger)
+: mutex_(new Mutex()), logger_(logger), call_stats_(true)
 {
 }
 
@@ -118,6 +119,23 @@ SyncPointManager::get_syncpoints()
 	return syncpoints_;
 }
 
+/** Enable or disable recording of calls.
+ * Applies to all existing SyncPoints and those created later on.
+ * Recording is enabled by default.
+ * @param enabled true to record emit and wait calls, false otherwise
+ * @see SyncPoint::set_call_stats_enabled()
+ */
+void
+SyncPointManager::set_call_stats_enabled(bool enabled)
+{
+	MutexLocker ml(mutex_);
+	call_stats_ = enabled;
+	for (std::set<RefPtr<SyncPoint>>::iterator sp = syncpoints_.begin(); sp != syncpoints_.end();
+	     ++sp) {
+		(*sp)->set_call_stats_enabled(enabled);
+	}
+}
+
 /** Find the prefix of the SyncPoint's identifier which is the identifier of
  *  the direct predecessor SyncPoint.
  *  The predecessor of a SyncPoint "/some/path" is "/some"
@@ -144,7 +162,8 @@ SyncPointManager::get_syncpoint_no_lock(const std::string &component, const std:
 	// insert a new SyncPoint if no SyncPoint with the same identifier exists,
 	// otherwise, use that SyncPoint
 	std::pair<std::set<RefPtr<SyncPoint>>::iterator, bool> insert_ret;
-	insert_ret = syncpoints_.insert(RefPtr<SyncPoint>(new SyncPoint(identifier, logger_)));
+	insert_ret =
+	  syncpoints_.insert(RefPtr<SyncPoint>(new SyncPoint(identifier, logger_, 0, 0, call_stats_)));
 	std::set<RefPtr<SyncPoint>>::iterator sp_it = insert_ret.first;
 
 	// add component to the set of watchers
@@ -176,7 +195,7 @@ SyncPointManager::release_syncpoint_no_lock(const std::string &component,
 		return;
 	}
 	(*sp_it)->unwait(component);
-	if (!(*sp_it)->watchers_.erase(component)) {
+	if (!(*sp_it)->remove_watcher(component)) {
 		throw SyncPointReleasedByNonWatcherException(component.c_str(),
 		                                             sync_point->get_identifier().c_str());
 	}
@@ -196,7 +215,7 @@ SyncPointManager::component_watches_any_successor(const RefPtr<SyncPoint> syncpo
 	for (std::set<RefPtr<SyncPoint>>::const_iterator it = syncpoint->successors_.begin();
 	     it != syncpoint->successors_.end();
 	     it++) {
-		if ((*it)->get_watchers().count(component)) {
+		if ((*it)->is_watcher(component)) {
 			return true;
 		}
 	}
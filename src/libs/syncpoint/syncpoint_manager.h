@@ -45,6 +45,8 @@ public:
 
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> get_syncpoints();
 
+	void set_call_stats_enabled(bool enabled);
+
 protected:
 	/** Set of all existing SyncPoints */
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> syncpoints_;
@@ -59,6 +61,7 @@ private:
 	bool         component_watches_any_successor(const RefPtr<SyncPoint> sp,
 	                                             const std::string       component) const;
 	MultiLogger *logger_;
+	bool         call_stats_;
 };
 
 } // end namespace fawkes
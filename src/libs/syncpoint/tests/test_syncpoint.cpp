@@ -1373,3 +1373,34 @@ TEST_F(SyncPointManagerTest, ReleaseBarrierWaiter)
 	sp = manager->get_syncpoint("component 1", "/test");
 	EXPECT_NO_THROW(sp->reltime_wait_for_all("component 1", 0, pow(10, 6)));
 }
+
+TEST_F(SyncPointTest, ComponentIdsAreStable)
+{
+	unsigned int id = SyncPoint::component_id("component");
+	EXPECT_EQ(id, SyncPoint::component_id("component"));
+	EXPECT_NE(id, SyncPoint::component_id("other component"));
+	EXPECT_EQ("component", SyncPoint::component_name(id));
+}
+
+TEST_F(SyncPointManagerTest, EmitAndWaitById)
+{
+	RefPtr<SyncPoint> sp = manager->get_syncpoint("emitter", "/test");
+	sp->register_emitter("emitter");
+	unsigned int id = SyncPoint::component_id("emitter");
+	sp->emit(id);
+	EXPECT_EQ(1u, sp->get_emit_calls().size());
+	EXPECT_NO_THROW(sp->wait(id, SyncPoint::WAIT_FOR_ALL, 0, pow(10, 6)));
+	EXPECT_EQ(1u, sp->get_wait_calls(SyncPoint::WAIT_FOR_ALL).size());
+}
+
+TEST_F(SyncPointManagerTest, DisabledCallStatsAreNotRecorded)
+{
+	manager->set_call_stats_enabled(false);
+	RefPtr<SyncPoint> sp = manager->get_syncpoint("emitter", "/test");
+	sp->register_emitter("emitter");
+	EXPECT_FALSE(sp->call_stats_enabled());
+	sp->emit("emitter");
+	sp->reltime_wait_for_one("emitter", 0, pow(10, 6));
+	EXPECT_EQ(0u, sp->get_emit_calls().size());
+	EXPECT_EQ(0u, sp->get_wait_calls(SyncPoint::WAIT_FOR_ONE).size());
+}
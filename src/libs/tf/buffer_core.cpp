@@ -49,6 +49,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <core/threading/read_write_lock.h>
 #include <tf/buffer_core.h>
 #include <tf/exceptions.h>
 #include <tf/time_cache.h>
@@ -56,6 +57,7 @@
 #include <tf/utils.h>
 
 #include <algorithm>
+#include <sched.h>
 #include <sstream>
 
 namespace fawkes {
@@ -123,16 +125,85 @@ BufferCore::validate_frame_id(const char *function_name_arg, const std::string &
 
 /** Constructor
  * @param cache_time How long to keep a history of transforms in nanoseconds
+ * @param cache_type type of cache to create for non-static frames
  */
-BufferCore::BufferCore(float cache_time) : cache_time_(cache_time)
+BufferCore::BufferCore(float cache_time, CacheType cache_type)
+: cache_time_(cache_time), cache_type_(cache_type), frame_table_epoch_(0), structure_version_(0)
 {
-	frameIDs_["NO_PARENT"] = 0;
-	frames_.push_back(TimeCacheInterfacePtr());
-	frameIDs_reverse.push_back("NO_PARENT");
+	frame_table_readers_[0] = frame_table_readers_[1] = 0;
+
+	frame_table_                   = new FrameTable();
+	frame_table_->ids["NO_PARENT"] = 0;
+	frame_table_->frames.push_back(TimeCacheInterfacePtr());
+	frame_table_->frame_locks.push_back(NULL);
+	frame_table_->names.push_back("NO_PARENT");
 }
 
 BufferCore::~BufferCore()
 {
+	for (size_t i = 0; i < frame_table_->frame_locks.size(); ++i) {
+		delete frame_table_->frame_locks[i];
+	}
+	delete frame_table_;
+}
+
+/** @class BufferCore::ReadSection <tf/buffer_core.h>
+ * Read-side critical section for the frame tables.
+ * While an instance exists, frame tables obtained from frame_table() are
+ * not deleted. Entering and leaving a section only increments and
+ * decrements a reader counter of the current epoch, it never blocks.
+ * Writers publishing a new table wait until the reader counts of both
+ * epochs have dropped to zero after switching the epoch.
+ */
+
+/** Constructor, enters the section.
+ * @param buffer_core buffer core whose frame tables are accessed
+ */
+BufferCore::ReadSection::ReadSection(const BufferCore *buffer_core) : buffer_core_(buffer_core)
+{
+	epoch_index_ = __atomic_load_n(&buffer_core_->frame_table_epoch_, __ATOMIC_SEQ_CST) & 1;
+	__atomic_add_fetch(&buffer_core_->frame_table_readers_[epoch_index_], 1, __ATOMIC_SEQ_CST);
+}
+
+/** Destructor, leaves the section. */
+BufferCore::ReadSection::~ReadSection()
+{
+	__atomic_sub_fetch(&buffer_core_->frame_table_readers_[epoch_index_], 1, __ATOMIC_RELEASE);
+}
+
+/** Get current frame table.
+ * Must only be called within a ReadSection or while holding frame_mutex_.
+ * @return current frame table
+ */
+const BufferCore::FrameTable *
+BufferCore::frame_table() const
+{
+	return __atomic_load_n(&frame_table_, __ATOMIC_SEQ_CST);
+}
+
+/** Publish a new frame table.
+ * Replaces the current table and deletes the old one once no reader can
+ * access it anymore. Must be called with frame_mutex_ held.
+ * @param table new frame table, ownership is taken
+ */
+void
+BufferCore::publish_frame_table(FrameTable *table)
+{
+	FrameTable *old_table = frame_table_;
+	__atomic_store_n(&frame_table_, table, __ATOMIC_SEQ_CST);
+
+	// A reader may have read the epoch just before it is switched and
+	// register with the previous index afterwards. Switching twice and
+	// waiting for both counters covers all readers that may have loaded
+	// the old table.
+	for (unsigned int i = 0; i < 2; ++i) {
+		unsigned int index = __atomic_fetch_add(&frame_table_epoch_, 1, __ATOMIC_SEQ_CST) & 1;
+		while (__atomic_load_n(&frame_table_readers_[index], __ATOMIC_SEQ_CST) != 0) {
+			sched_yield();
+		}
+	}
+
+	delete old_table;
 }
 
 /** Clear all data. */
@@ -141,14 +212,14 @@ BufferCore::clear()
 {
 	//old_tf_.clear();
 	std::unique_lock<std::mutex> lock(frame_mutex_);
-	if (frames_.size() > 1) {
-		for (std::vector<TimeCacheInterfacePtr>::iterator cache_it = frames_.begin() + 1;
-		     cache_it != frames_.end();
-		     ++cache_it) {
-			if (*cache_it)
-				(*cache_it)->clear_list();
+	for (size_t i = 1; i < frame_table_->frames.size(); ++i) {
+		if (frame_table_->frames[i]) {
+			frame_table_->frame_locks[i]->lock_for_write();
+			frame_table_->frames[i]->clear_list();
+			frame_table_->frame_locks[i]->unlock();
 		}
 	}
+	__atomic_add_fetch(&structure_version_, 1, __ATOMIC_RELEASE);
 }
 
 /** Add transform information to the tf data structure
@@ -164,9 +235,60 @@ BufferCore::set_transform(const StampedTransform &transform_in,
                           const std::string &     authority,
                           bool                    is_static)
 {
-	StampedTransform stripped = transform_in;
-	stripped.frame_id         = strip_slash(stripped.frame_id);
-	stripped.child_frame_id   = strip_slash(stripped.child_frame_id);
+	StampedTransform stripped;
+	if (!strip_and_validate(transform_in, authority, stripped))
+		return false;
+
+	std::unique_lock<std::mutex> lock(frame_mutex_);
+	return insert_transform_no_lock(stripped, authority, is_static);
+}
+
+/** Add a batch of transforms to the tf data structure.
+ * This is equivalent to calling set_transform() for each transform,
+ * but the writer lock is acquired only once for the whole batch. This
+ * is preferable when adding a snapshot of a whole tree at once.
+ * Invalid transforms are skipped and do not prevent the others from
+ * being stored.
+ * @param transforms transforms to store
+ * @param authority The source of the information for these transforms
+ * @param is_static Record the transforms as static transforms.
+ * @return number of transforms that have been stored
+ */
+unsigned int
+BufferCore::set_transforms(const std::vector<StampedTransform> &transforms,
+                           const std::string &                  authority,
+                           bool                                 is_static)
+{
+	std::vector<StampedTransform> stripped(transforms.size());
+	std::vector<bool>             valid(transforms.size());
+	for (size_t i = 0; i < transforms.size(); ++i) {
+		valid[i] = strip_and_validate(transforms[i], authority, stripped[i]);
+	}
+
+	unsigned int                 num_inserted = 0;
+	std::unique_lock<std::mutex> lock(frame_mutex_);
+	for (size_t i = 0; i < stripped.size(); ++i) {
+		if (valid[i] && insert_transform_no_lock(stripped[i], authority, is_static)) {
+			++num_inserted;
+		}
+	}
+	return num_inserted;
+}
+
+/** Strip leading slashes from frame IDs and validate transform.
+ * @param transform_in transform to check
+ * @param authority The source of the information for this transform
+ * @param stripped upon return contains the transform with stripped frame IDs
+ * @return true if the transform is valid, false otherwise
+ */
+bool
+BufferCore::strip_and_validate(const StampedTransform &transform_in,
+                               const std::string &     authority,
+                               StampedTransform &      stripped) const
+{
+	stripped                = transform_in;
+	stripped.frame_id       = strip_slash(stripped.frame_id);
+	stripped.child_frame_id = strip_slash(stripped.child_frame_id);
 
 	bool error_exists = false;
 	if (stripped.child_frame_id == stripped.frame_id) {
@@ -210,29 +332,48 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 		error_exists = true;
 	}
 
-	if (error_exists)
-		return false;
+	return !error_exists;
+}
 
-	{
-		std::unique_lock<std::mutex> lock(frame_mutex_);
-		CompactFrameID        frame_number = lookup_or_insert_frame_number(stripped.child_frame_id);
-		TimeCacheInterfacePtr frame        = get_frame(frame_number);
-		if (!frame)
-			frame = allocate_frame(frame_number, is_static);
-
-		if (frame->insert_data(TransformStorage(stripped,
-		                                        lookup_or_insert_frame_number(stripped.frame_id),
-		                                        frame_number))) {
-			frame_authority_[frame_number] = authority;
-		} else {
-			printf("TF_OLD_DATA ignoring data from the past for frame %s "
-			       "at time %g according to authority %s\n"
-			       "Possible reasons are listed at http://wiki.ros.org/tf/Errors%%20explained",
-			       stripped.child_frame_id.c_str(),
-			       stripped.stamp.in_sec(),
-			       authority.c_str());
-			return false;
-		}
+/** Insert transform into frame cache.
+ * Must be called with frame_mutex_ held.
+ * @param stripped transform with stripped frame IDs, must have been
+ * validated with strip_and_validate()
+ * @param authority The source of the information for this transform
+ * @param is_static Record this transform as a static transform.
+ * @return true if the transform has been stored, false otherwise
+ */
+bool
+BufferCore::insert_transform_no_lock(const StampedTransform &stripped,
+                                     const std::string &     authority,
+                                     bool                    is_static)
+{
+	CompactFrameID        frame_number = lookup_or_insert_frame_number(stripped.child_frame_id);
+	TimeCacheInterfacePtr frame        = get_frame(frame_number);
+	if (!frame)
+		frame = allocate_frame(frame_number, is_static);
+	CompactFrameID parent_number = lookup_or_insert_frame_number(stripped.frame_id);
+
+	ReadWriteLock *frame_lock = frame_table_->frame_locks[frame_number];
+	frame_lock->lock_for_write();
+	bool reparented = (frame->get_latest_time_and_parent().second != parent_number);
+	bool inserted   = frame->insert_data(TransformStorage(stripped, parent_number, frame_number));
+	frame_lock->unlock();
+
+	if (inserted && reparented) {
+		__atomic_add_fetch(&structure_version_, 1, __ATOMIC_RELEASE);
+	}
+
+	if (inserted) {
+		frame_authority_[frame_number] = authority;
+	} else {
+		printf("TF_OLD_DATA ignoring data from the past for frame %s "
+		       "at time %g according to authority %s\n"
+		       "Possible reasons are listed at http://wiki.ros.org/tf/Errors%%20explained",
+		       stripped.child_frame_id.c_str(),
+		       stripped.stamp.in_sec(),
+		       authority.c_str());
+		return false;
 	}
 
 	//test_transformable_requests();
@@ -241,6 +382,8 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 }
 
 /** Allocate a new frame cache.
+ * Publishes a new frame table containing the cache. Must be called with
+ * frame_mutex_ held.
  * @param cfid frame ID for which to create the frame cache
  * @param is_static true if the transforms for this frame are static, false otherwise
  * @return pointer to new cache
@@ -248,14 +391,23 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 TimeCacheInterfacePtr
 BufferCore::allocate_frame(CompactFrameID cfid, bool is_static)
 {
-	TimeCacheInterfacePtr frame_ptr = frames_[cfid];
+	TimeCacheInterfacePtr frame_ptr;
 	if (is_static) {
-		frames_[cfid] = TimeCacheInterfacePtr(new StaticCache());
+		frame_ptr = TimeCacheInterfacePtr(new StaticCache());
+	} else if (cache_type_ == CACHE_LIST) {
+		frame_ptr = TimeCacheInterfacePtr(new TimeCache(cache_time_));
 	} else {
-		frames_[cfid] = TimeCacheInterfacePtr(new TimeCache(cache_time_));
+		frame_ptr = TimeCacheInterfacePtr(new RingTimeCache(cache_time_));
+	}
+
+	FrameTable *table   = new FrameTable(*frame_table_);
+	table->frames[cfid] = frame_ptr;
+	if (!table->frame_locks[cfid]) {
+		table->frame_locks[cfid] = new ReadWriteLock();
 	}
+	publish_frame_table(table);
 
-	return frames_[cfid];
+	return frame_ptr;
 }
 
 enum WalkEnding {
@@ -328,8 +480,10 @@ BufferCore::walk_to_top_parent(F &                          f,
 	std::string extrapolation_error_string;
 	bool        extrapolation_might_have_occurred = false;
 
+	const FrameTable *table = frame_table();
+
 	while (frame != 0) {
-		TimeCacheInterfacePtr cache = get_frame(frame);
+		TimeCacheInterface *cache = (frame < table->frames.size()) ? table->frames[frame].get() : NULL;
 		if (frame_chain)
 			frame_chain->push_back(frame);
 
@@ -339,7 +493,9 @@ BufferCore::walk_to_top_parent(F &                          f,
 			break;
 		}
 
+		table->frame_locks[frame]->lock_for_read();
 		CompactFrameID parent = f.gather(cache, time, &extrapolation_error_string);
+		table->frame_locks[frame]->unlock();
 		if (parent == 0) {
 			// Just break out here... there may still be a path from source -> target
 			top_parent                        = frame;
@@ -376,7 +532,7 @@ BufferCore::walk_to_top_parent(F &                          f,
 	std::vector<CompactFrameID> reverse_frame_chain;
 
 	while (frame != top_parent) {
-		TimeCacheInterfacePtr cache = get_frame(frame);
+		TimeCacheInterface *cache = (frame < table->frames.size()) ? table->frames[frame].get() : NULL;
 		if (frame_chain)
 			reverse_frame_chain.push_back(frame);
 
@@ -384,7 +540,9 @@ BufferCore::walk_to_top_parent(F &                          f,
 			break;
 		}
 
+		table->frame_locks[frame]->lock_for_read();
 		CompactFrameID parent = f.gather(cache, time, error_string);
+		table->frame_locks[frame]->unlock();
 		if (parent == 0) {
 			if (error_string) {
 				std::stringstream ss;
@@ -476,7 +634,7 @@ struct TransformAccum
 	}
 
 	CompactFrameID
-	gather(TimeCacheInterfacePtr cache, fawkes::Time time, std::string *error_string)
+	gather(TimeCacheInterface *cache, fawkes::Time time, std::string *error_string)
 	{
 		if (!cache->get_data(time, st, error_string)) {
 			return 0;
@@ -556,7 +714,7 @@ BufferCore::lookup_transform(const std::string & target_frame,
                              const fawkes::Time &time,
                              StampedTransform &  transform) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
+	ReadSection section(this);
 
 	if (target_frame == source_frame) {
 		transform.setIdentity();
@@ -566,10 +724,14 @@ BufferCore::lookup_transform(const std::string & target_frame,
 		if (time == fawkes::Time(0, 0)) {
 			CompactFrameID        target_id = lookup_frame_number(target_frame);
 			TimeCacheInterfacePtr cache     = get_frame(target_id);
-			if (cache)
+			if (cache) {
+				ReadWriteLock *frame_lock = frame_table()->frame_locks[target_id];
+				frame_lock->lock_for_read();
 				transform.stamp = cache->get_latest_timestamp();
-			else
+				frame_lock->unlock();
+			} else {
 				transform.stamp = time;
+			}
 		} else {
 			transform.stamp = time;
 		}
@@ -628,9 +790,12 @@ BufferCore::lookup_transform(const std::string & target_frame,
                              const std::string & fixed_frame,
                              StampedTransform &  transform) const
 {
-	validate_frame_id("lookup_transform argument target_frame", target_frame);
-	validate_frame_id("lookup_transform argument source_frame", source_frame);
-	validate_frame_id("lookup_transform argument fixed_frame", fixed_frame);
+	{
+		ReadSection section(this);
+		validate_frame_id("lookup_transform argument target_frame", target_frame);
+		validate_frame_id("lookup_transform argument source_frame", source_frame);
+		validate_frame_id("lookup_transform argument fixed_frame", fixed_frame);
+	}
 
 	StampedTransform temp1, temp2;
 	lookup_transform(fixed_frame, source_frame, source_time, temp1);
@@ -641,11 +806,143 @@ BufferCore::lookup_transform(const std::string & target_frame,
 	transform.child_frame_id = source_frame;
 }
 
+/** Get version of the frame tree structure.
+ * The version is incremented whenever a frame is added, a frame
+ * receives a transform with a different parent frame than before, or
+ * the buffer is cleared. A frame chain resolved for a lookup remains
+ * valid as long as the version does not change.
+ * @return current structure version
+ */
+unsigned int
+BufferCore::structure_version() const
+{
+	return __atomic_load_n(&structure_version_, __ATOMIC_ACQUIRE);
+}
+
+/** Resolve the frame chains between two frames.
+ * Determines the frames on the paths from the source and the target
+ * frame to their closest common ancestor. Both chains start with the
+ * respective frame and end with the common ancestor. The parents are
+ * determined for the given time, or from the latest data if the time
+ * is zero. Must be called within a ReadSection.
+ * @param target_id ID of target frame
+ * @param source_id ID of source frame
+ * @param time time for which to determine the parent frames
+ * @param target_chain upon return contains the chain from the target frame
+ * @param source_chain upon return contains the chain from the source frame
+ * @return true if the chains could be resolved, false if the frames
+ * are not connected or no data was available for the given time
+ */
+bool
+BufferCore::resolve_chain(CompactFrameID               target_id,
+                          CompactFrameID               source_id,
+                          const fawkes::Time &         time,
+                          std::vector<CompactFrameID> &target_chain,
+                          std::vector<CompactFrameID> &source_chain) const
+{
+	const FrameTable *table = frame_table();
+
+	std::vector<CompactFrameID> *chains[2] = {&target_chain, &source_chain};
+	CompactFrameID               starts[2] = {target_id, source_id};
+	for (unsigned int c = 0; c < 2; ++c) {
+		chains[c]->clear();
+		CompactFrameID frame = starts[c];
+		while (frame != 0) {
+			chains[c]->push_back(frame);
+			TimeCacheInterface *cache =
+			  (frame < table->frames.size()) ? table->frames[frame].get() : NULL;
+			if (!cache) {
+				// root of the tree
+				break;
+			}
+			if (chains[c]->size() > MAX_GRAPH_DEPTH) {
+				return false;
+			}
+
+			ReadWriteLock *frame_lock = table->frame_locks[frame];
+			frame_lock->lock_for_read();
+			if (time == fawkes::Time(0, 0)) {
+				frame = cache->get_latest_time_and_parent().second;
+			} else {
+				frame = cache->get_parent(time, NULL);
+			}
+			frame_lock->unlock();
+			if (frame == 0) {
+				return false;
+			}
+		}
+	}
+
+	// Cut both chains after the closest common ancestor
+	for (size_t s = 0; s < source_chain.size(); ++s) {
+		std::vector<CompactFrameID>::iterator t =
+		  std::find(target_chain.begin(), target_chain.end(), source_chain[s]);
+		if (t != target_chain.end()) {
+			target_chain.erase(t + 1, target_chain.end());
+			source_chain.erase(source_chain.begin() + s + 1, source_chain.end());
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Lookup transform along previously resolved frame chains.
+ * Must be called within a ReadSection.
+ * @param target_chain frame chain from the target frame to the common ancestor
+ * @param source_chain frame chain from the source frame to the common ancestor
+ * @param time time for which to get the transform, must not be zero
+ * @param transform upon return contains the transform from the source
+ * to the target frame
+ * @return true if the transform was determined, false if data for the
+ * given time is not available or the chain does not match the parent
+ * frames recorded for the time
+ */
+bool
+BufferCore::lookup_chain(const std::vector<CompactFrameID> &target_chain,
+                         const std::vector<CompactFrameID> &source_chain,
+                         const fawkes::Time &               time,
+                         Transform &                        transform) const
+{
+	const FrameTable *table = frame_table();
+
+	const std::vector<CompactFrameID> *chains[2] = {&target_chain, &source_chain};
+	Quaternion                         to_top_quat[2];
+	Vector3                            to_top_vec[2];
+	TransformStorage                   st;
+	for (unsigned int c = 0; c < 2; ++c) {
+		const std::vector<CompactFrameID> &chain = *chains[c];
+		to_top_quat[c]                           = Quaternion(0.0, 0.0, 0.0, 1.0);
+		to_top_vec[c]                            = Vector3(0.0, 0.0, 0.0);
+		for (size_t i = 0; i + 1 < chain.size(); ++i) {
+			TimeCacheInterface *cache =
+			  (chain[i] < table->frames.size()) ? table->frames[chain[i]].get() : NULL;
+			if (!cache)
+				return false;
+
+			table->frame_locks[chain[i]]->lock_for_read();
+			bool have_data = cache->get_data(time, st, NULL);
+			table->frame_locks[chain[i]]->unlock();
+			if (!have_data || (st.frame_id != chain[i + 1]))
+				return false;
+
+			to_top_vec[c]  = quatRotate(st.rotation, to_top_vec[c]) + st.translation;
+			to_top_quat[c] = st.rotation * to_top_quat[c];
+		}
+	}
+
+	Quaternion inv_target_quat = to_top_quat[0].inverse();
+	Vector3    inv_target_vec  = quatRotate(inv_target_quat, -to_top_vec[0]);
+	transform.setOrigin(quatRotate(inv_target_quat, to_top_vec[1]) + inv_target_vec);
+	transform.setRotation(inv_target_quat * to_top_quat[1]);
+	return true;
+}
+
 /// @cond INTERNAL
 struct CanTransformAccum
 {
 	CompactFrameID
-	gather(TimeCacheInterfacePtr cache, fawkes::Time time, std::string *error_string)
+	gather(TimeCacheInterface *cache, fawkes::Time time, std::string *error_string)
 	{
 		return cache->get_parent(time, error_string);
 	}
@@ -665,7 +962,8 @@ struct CanTransformAccum
 /// @endcond
 
 /** Test if a transform is possible.
- * Internal check that does not lock the frame mutex.
+ * Internal check that does not enter a read section. Must be called
+ * within a ReadSection.
  * @param target_id The frame number into which to transform
  * @param source_id The frame number from which to transform
  * @param time The time at which to transform
@@ -695,7 +993,7 @@ BufferCore::can_transform_no_lock(CompactFrameID      target_id,
 }
 
 /** Test if a transform is possible.
- * Internal check that does lock the frame mutex.
+ * Internal check that enters a read section.
  * @param target_id The frame number into which to transform
  * @param source_id The frame number from which to transform
  * @param time The time at which to transform
@@ -708,7 +1006,7 @@ BufferCore::can_transform_internal(CompactFrameID      target_id,
                                    const fawkes::Time &time,
                                    std::string *       error_msg) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
+	ReadSection section(this);
 	return can_transform_no_lock(target_id, source_id, time, error_msg);
 }
 
@@ -734,7 +1032,7 @@ BufferCore::can_transform(const std::string & target_frame,
 	if (warn_frame_id("canTransform argument source_frame", source_frame))
 		return false;
 
-	std::unique_lock<std::mutex> lock(frame_mutex_);
+	ReadSection section(this);
 
 	CompactFrameID target_id = lookup_frame_number(target_frame);
 	CompactFrameID source_id = lookup_frame_number(source_frame);
@@ -772,30 +1070,34 @@ BufferCore::can_transform(const std::string & target_frame,
 
 /** Accessor to get frame cache.
  * This is an internal function which will get the pointer to the
- * frame associated with the frame id
+ * frame associated with the frame id. Must be called within a
+ * ReadSection or while holding frame_mutex_.
  * @param frame_id The frameID of the desired Reference Frame
  * @return shared pointer to time cache
  */
 TimeCacheInterfacePtr
 BufferCore::get_frame(CompactFrameID frame_id) const
 {
-	if (frame_id >= frames_.size())
+	const FrameTable *table = frame_table();
+	if (frame_id >= table->frames.size())
 		return TimeCacheInterfacePtr();
 	else {
-		return frames_[frame_id];
+		return table->frames[frame_id];
 	}
 }
 
 /** Get compact ID for frame.
+ * Must be called within a ReadSection or while holding frame_mutex_.
  * @param frameid_str frame ID string
  * @return compact frame ID, zero if frame unknown
  */
 CompactFrameID
 BufferCore::lookup_frame_number(const std::string &frameid_str) const
 {
+	const FrameTable *                       table = frame_table();
 	CompactFrameID                           retval;
-	M_StringToCompactFrameID::const_iterator map_it = frameIDs_.find(frameid_str);
-	if (map_it == frameIDs_.end()) {
+	M_StringToCompactFrameID::const_iterator map_it = table->ids.find(frameid_str);
+	if (map_it == table->ids.end()) {
 		retval = CompactFrameID(0);
 	} else
 		retval = map_it->second;
@@ -803,26 +1105,33 @@ BufferCore::lookup_frame_number(const std::string &frameid_str) const
 }
 
 /** Get compact ID for frame or create if not existant.
+ * Publishes a new frame table if the frame is added. Must be called with
+ * frame_mutex_ held.
  * @param frameid_str frame ID string
  * @return compact frame ID
  */
 CompactFrameID
 BufferCore::lookup_or_insert_frame_number(const std::string &frameid_str)
 {
-	CompactFrameID                     retval = 0;
-	M_StringToCompactFrameID::iterator map_it = frameIDs_.find(frameid_str);
-	if (map_it == frameIDs_.end()) {
-		retval = CompactFrameID(frames_.size());
-		frames_.push_back(TimeCacheInterfacePtr()); //Just a place holder for iteration
-		frameIDs_[frameid_str] = retval;
-		frameIDs_reverse.push_back(frameid_str);
+	CompactFrameID                           retval = 0;
+	M_StringToCompactFrameID::const_iterator map_it = frame_table_->ids.find(frameid_str);
+	if (map_it == frame_table_->ids.end()) {
+		FrameTable *table = new FrameTable(*frame_table_);
+		retval            = CompactFrameID(table->frames.size());
+		table->frames.push_back(TimeCacheInterfacePtr()); //Just a place holder for iteration
+		table->frame_locks.push_back(NULL);
+		table->ids[frameid_str] = retval;
+		table->names.push_back(frameid_str);
+		publish_frame_table(table);
 	} else
-		retval = frameIDs_[frameid_str];
+		retval = map_it->second;
 
 	return retval;
 }
 
 /** Get frame string for compact frame ID.
+ * Must be called within a ReadSection or while holding frame_mutex_,
+ * the returned reference is only valid until the section is left.
  * @param frame_id_num compact frame ID
  * @return string for frame ID
  * @throw LookupException thrown if compact frame ID unknown
@@ -830,10 +1139,11 @@ BufferCore::lookup_or_insert_frame_number(const std::string &frameid_str)
 const std::string &
 BufferCore::lookup_frame_string(CompactFrameID frame_id_num) const
 {
-	if (frame_id_num >= frameIDs_reverse.size()) {
+	const FrameTable *table = frame_table();
+	if (frame_id_num >= table->names.size()) {
 		throw LookupException("Reverse lookup of frame id %u failed!", frame_id_num);
 	} else
-		return frameIDs_reverse[frame_id_num];
+		return table->names[frame_id_num];
 }
 
 /** Create error string.
@@ -876,23 +1186,24 @@ BufferCore::all_frames_as_string_no_lock() const
 {
 	std::stringstream mstream;
 
-	TransformStorage temp;
-
-	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
+	TransformStorage  temp;
+	const FrameTable *table = frame_table();
 
 	///regular transforms
-	for (unsigned int counter = 1; counter < frames_.size(); counter++) {
-		TimeCacheInterfacePtr frame_ptr = get_frame(CompactFrameID(counter));
+	for (unsigned int counter = 1; counter < table->frames.size(); counter++) {
+		TimeCacheInterfacePtr frame_ptr = table->frames[counter];
 		if (frame_ptr == NULL)
 			continue;
 		CompactFrameID frame_id_num;
+		table->frame_locks[counter]->lock_for_read();
 		if (frame_ptr->get_data(fawkes::Time(0, 0), temp))
 			frame_id_num = temp.frame_id;
 		else {
 			frame_id_num = 0;
 		}
-		mstream << "Frame " << frameIDs_reverse[counter] << " exists with parent "
-		        << frameIDs_reverse[frame_id_num] << "." << std::endl;
+		table->frame_locks[counter]->unlock();
+		mstream << "Frame " << table->names[counter] << " exists with parent "
+		        << lookup_frame_string(frame_id_num) << "." << std::endl;
 	}
 
 	return mstream.str();
@@ -932,13 +1243,19 @@ BufferCore::get_latest_common_time(CompactFrameID target_id,
 	if (source_id == 0 || target_id == 0)
 		return LOOKUP_ERROR;
 
+	const FrameTable *table = frame_table();
+
 	if (source_id == target_id) {
-		TimeCacheInterfacePtr cache = get_frame(source_id);
+		TimeCacheInterface *cache =
+		  (source_id < table->frames.size()) ? table->frames[source_id].get() : NULL;
 		//Set time to latest timestamp of frameid in case of target and source frame id are the same
-		if (cache)
+		if (cache) {
+			table->frame_locks[source_id]->lock_for_read();
 			time = cache->get_latest_timestamp();
-		else
+			table->frame_locks[source_id]->unlock();
+		} else {
 			time = fawkes::Time(0, 0);
+		}
 		return NO_ERROR;
 	}
 
@@ -951,14 +1268,16 @@ BufferCore::get_latest_common_time(CompactFrameID target_id,
 	uint32_t         depth       = 0;
 	fawkes::Time     common_time = fawkes::TIME_MAX;
 	while (frame != 0) {
-		TimeCacheInterfacePtr cache = get_frame(frame);
+		TimeCacheInterface *cache = (frame < table->frames.size()) ? table->frames[frame].get() : NULL;
 
 		if (!cache) {
 			// There will be no cache for the very root of the tree
 			break;
 		}
 
+		table->frame_locks[frame]->lock_for_read();
 		P_TimeAndFrameID latest = cache->get_latest_time_and_parent();
+		table->frame_locks[frame]->unlock();
 
 		if (latest.second == 0) {
 			// Just break out here... there may still be a path from source -> target
@@ -1000,13 +1319,15 @@ BufferCore::get_latest_common_time(CompactFrameID target_id,
 	common_time                  = fawkes::TIME_MAX;
 	CompactFrameID common_parent = 0;
 	while (true) {
-		TimeCacheInterfacePtr cache = get_frame(frame);
+		TimeCacheInterface *cache = (frame < table->frames.size()) ? table->frames[frame].get() : NULL;
 
 		if (!cache) {
 			break;
 		}
 
+		table->frame_locks[frame]->lock_for_read();
 		P_TimeAndFrameID latest = cache->get_latest_time_and_parent();
+		table->frame_locks[frame]->unlock();
 
 		if (latest.second == 0) {
 			break;
@@ -1094,16 +1415,17 @@ BufferCore::all_frames_as_YAML(double current_time) const
 	std::stringstream            mstream;
 	std::unique_lock<std::mutex> lock(frame_mutex_);
 
-	TransformStorage temp;
+	TransformStorage  temp;
+	const FrameTable *table = frame_table();
 
-	if (frames_.size() == 1)
+	if (table->frames.size() == 1)
 		mstream << "[]";
 
 	mstream.precision(3);
 	mstream.setf(std::ios::fixed, std::ios::floatfield);
 
 	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
-	for (unsigned int counter = 1; counter < frames_.size();
+	for (unsigned int counter = 1; counter < table->frames.size();
 	     counter++) //one referenced for 0 is no frame
 	{
 		CompactFrameID        cfid = CompactFrameID(counter);
@@ -1132,8 +1454,8 @@ BufferCore::all_frames_as_YAML(double current_time) const
 
 		mstream << std::fixed; //fixed point notation
 		mstream.precision(3);  //3 decimal places
-		mstream << frameIDs_reverse[cfid] << ": " << std::endl;
-		mstream << "  parent: '" << frameIDs_reverse[frame_id_num] << "'" << std::endl;
+		mstream << table->names[cfid] << ": " << std::endl;
+		mstream << "  parent: '" << table->names[frame_id_num] << "'" << std::endl;
 		mstream << "  broadcaster: '" << authority << "'" << std::endl;
 		mstream << "  rate: " << rate << std::endl;
 		mstream << "  most_recent_transform: " << (cache->get_latest_timestamp()).in_sec() << std::endl;
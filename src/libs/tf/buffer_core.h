@@ -64,6 +64,8 @@
 #include <vector>
 
 namespace fawkes {
+class ReadWriteLock;
+
 namespace tf {
 
 class TimeCacheInterface;
@@ -105,12 +107,20 @@ enum ErrorValues {
  */
 class BufferCore
 {
+	friend class TransformHandle;
+
 public:
 	static const int DEFAULT_CACHE_TIME = 10; //!< The default amount of time to cache data in seconds
 	static const uint32_t MAX_GRAPH_DEPTH = 1000UL; //!< Maximum number of times to recurse before
 	                                                //! assuming the tree has a loop
 
-	BufferCore(float cache_time = DEFAULT_CACHE_TIME);
+	/** Type of cache to use for non-static frames. */
+	typedef enum {
+		CACHE_LIST, ///< TimeCache, time-sorted linked list
+		CACHE_RING  ///< RingTimeCache, time-sorted ring buffer with binary search
+	} CacheType;
+
+	BufferCore(float cache_time = DEFAULT_CACHE_TIME, CacheType cache_type = CACHE_RING);
 	virtual ~BufferCore(void);
 
 	void clear();
@@ -119,6 +129,10 @@ public:
 	                   const std::string &     authority,
 	                   bool                    is_static = false);
 
+	unsigned int set_transforms(const std::vector<StampedTransform> &transforms,
+	                            const std::string &                  authority,
+	                            bool                                 is_static = false);
+
 	/*********** Accessors *************/
 	void lookup_transform(const std::string & target_frame,
 	                      const std::string & source_frame,
@@ -148,6 +162,8 @@ public:
 	std::string all_frames_as_YAML() const;
 	std::string all_frames_as_string() const;
 
+	unsigned int structure_version() const;
+
 	/** Get the duration over which this transformer will cache.
    * @return cache length in seconds */
 	float
@@ -166,25 +182,64 @@ protected:
 
 	/// Vector data type for frame caches.
 	typedef std::vector<TimeCacheInterfacePtr> V_TimeCacheInterface;
-	/** The pointers to potential frames that the tree can be made of.
-   * The frames will be dynamically allocated at run time when set the
-   * first time. */
-	V_TimeCacheInterface frames_;
 
-	/** \brief A mutex to protect testing and allocating new frames on the above vector. */
+	/** \brief A mutex to serialize writers and to protect the frame authority map. */
 	mutable std::mutex frame_mutex_;
 
 	/** \brief A map from string frame ids to CompactFrameID */
 	typedef std::unordered_map<std::string, CompactFrameID> M_StringToCompactFrameID;
-	/// Mapping from frame string IDs to compact IDs.
-	M_StringToCompactFrameID frameIDs_;
-	/** \brief A map from CompactFrameID frame_id_numbers to string for debugging and output */
-	std::vector<std::string> frameIDs_reverse;
+
+	/** Immutable snapshot of the frame tables.
+	 * A new table is published whenever a frame is added or its cache is
+	 * allocated. Readers load the current table without locking within a
+	 * ReadSection, superseded tables are deleted once no reader can still
+	 * access them. */
+	struct FrameTable
+	{
+		/** The pointers to potential frames that the tree can be made of.
+		 * The frames will be dynamically allocated at run time when set the
+		 * first time. */
+		V_TimeCacheInterface frames;
+		/// Per-frame locks guarding the data of the frame caches.
+		std::vector<ReadWriteLock *> frame_locks;
+		/// Mapping from frame string IDs to compact IDs.
+		M_StringToCompactFrameID ids;
+		/// Mapping from compact IDs to frame string IDs.
+		std::vector<std::string> names;
+	};
+
+	/** Read-side critical section for the frame tables.
+	 * Frame tables loaded while an instance exists remain valid until it
+	 * is destroyed. Sections may be nested and never block. */
+	class ReadSection
+	{
+	public:
+		ReadSection(const BufferCore *buffer_core);
+		~ReadSection();
+
+	private:
+		const BufferCore *buffer_core_;
+		unsigned int      epoch_index_;
+	};
+
+	const FrameTable *frame_table() const;
+	void              publish_frame_table(FrameTable *table);
+
 	/** \brief A map to lookup the most recent authority for a given frame */
 	std::map<CompactFrameID, std::string> frame_authority_;
 
 	/// How long to cache transform history
 	float cache_time_;
+	/// Type of cache for non-static frames
+	CacheType cache_type_;
+
+private:
+	FrameTable *         frame_table_;
+	unsigned int         frame_table_epoch_;
+	mutable unsigned int frame_table_readers_[2];
+	unsigned int         structure_version_;
+
+protected:
 
 	/************************* Internal Functions ****************************/
 
@@ -192,6 +247,13 @@ protected:
 
 	TimeCacheInterfacePtr allocate_frame(CompactFrameID cfid, bool is_static);
 
+	bool strip_and_validate(const StampedTransform &transform_in,
+	                        const std::string &     authority,
+	                        StampedTransform &      stripped) const;
+	bool insert_transform_no_lock(const StampedTransform &stripped,
+	                              const std::string &     authority,
+	                              bool                    is_static);
+
 	bool           warn_frame_id(const char *function_name_arg, const std::string &frame_id) const;
 	CompactFrameID validate_frame_id(const char *       function_name_arg,
 	                                 const std::string &frame_id) const;
@@ -233,6 +295,16 @@ protected:
 	                            CompactFrameID      source_id,
 	                            const fawkes::Time &time,
 	                            std::string *       error_msg) const;
+	bool resolve_chain(CompactFrameID               target_id,
+	                   CompactFrameID               source_id,
+	                   const fawkes::Time &         time,
+	                   std::vector<CompactFrameID> &target_chain,
+	                   std::vector<CompactFrameID> &source_chain) const;
+	bool lookup_chain(const std::vector<CompactFrameID> &target_chain,
+	                  const std::vector<CompactFrameID> &source_chain,
+	                  const fawkes::Time &               time,
+	                  Transform &                        transform) const;
+
 	bool can_transform_no_lock(CompactFrameID      target_id,
 	                           CompactFrameID      source_id,
 	                           const fawkes::Time &time,
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *  qa_tf_batch.cpp - Check that batches spanning several chunks arrive
+ *
+ *  Created: Sun Oct 18 20:06:41 2026
+ *  Copyright  2011-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <blackboard/interface_listener.h>
+#include <blackboard/local.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <interfaces/TransformBatchInterface.h>
+#include <tf/exceptions.h>
+#include <tf/transform_listener.h>
+#include <tf/transform_publisher.h>
+#include <tf/transformer.h>
+
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+#define NUM_FRAMES 200
+#define NUM_ROUNDS 5
+#define COLLECTOR_DELAY_USEC 20000
+
+/* Asynchronous listener which only ever sees the latest data of an
+ * interface, like the coalescing consumers of batch interfaces do. It
+ * records the translation last seen for every child frame. */
+class QaBatchCollector : public BlackBoardInterfaceListener
+{
+public:
+	QaBatchCollector(std::list<TransformBatchInterface *> &tfbifs)
+	: BlackBoardInterfaceListener("QaBatchCollector"), mutex_(new Mutex())
+	{
+		std::list<TransformBatchInterface *>::iterator b;
+		for (b = tfbifs.begin(); b != tfbifs.end(); ++b) {
+			bbil_add_data_interface(*b);
+		}
+		bbil_set_async_queue(4, ASYNC_COALESCE);
+	}
+
+	~QaBatchCollector()
+	{
+		delete mutex_;
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *interface) throw()
+	{
+		usleep(COLLECTOR_DELAY_USEC);
+		TransformBatchInterface *tfbif = dynamic_cast<TransformBatchInterface *>(interface);
+		tfbif->read();
+
+		MutexLocker   lock(mutex_);
+		const char *  child_frames = tfbif->child_frames();
+		const double *translations = tfbif->translations();
+		for (unsigned int i = 0; i < tfbif->num_transforms(); ++i) {
+			const char *end = strchr(child_frames, '\n');
+			if (!end)
+				break;
+			last_x_[std::string(child_frames, end)] = translations[i * 3];
+			child_frames                            = end + 1;
+		}
+	}
+
+	unsigned int
+	num_frames_with_x(double x)
+	{
+		MutexLocker                             lock(mutex_);
+		unsigned int                            num = 0;
+		std::map<std::string, double>::iterator i;
+		for (i = last_x_.begin(); i != last_x_.end(); ++i) {
+			if (i->second == x)
+				++num;
+		}
+		return num;
+	}
+
+private:
+	Mutex *                       mutex_;
+	std::map<std::string, double> last_x_;
+};
+
+static std::vector<StampedTransform>
+snapshot(unsigned int num_frames, unsigned int round)
+{
+	std::vector<StampedTransform> transforms;
+	Time                          stamp(1000 + round, 0);
+	for (unsigned int i = 0; i < num_frames; ++i) {
+		char child[16];
+		snprintf(child, sizeof(child), "f%u", i);
+		transforms.push_back(StampedTransform(Transform(Quaternion(0, 0, 0, 1),
+		                                                Vector3(round, 0.01 * i, 0.)),
+		                                      stamp,
+		                                      "base",
+		                                      child));
+	}
+	return transforms;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int errors = 0;
+
+	BlackBoard *        bb = new LocalBlackBoard(4 * 1024 * 1024);
+	Transformer         transformer;
+	TransformListener * listener  = new TransformListener(bb, &transformer);
+	TransformPublisher *publisher = new TransformPublisher(bb, "qa");
+
+	// the first snapshot creates the chunk interfaces
+	publisher->send_transforms(snapshot(NUM_FRAMES, 0));
+
+	std::list<TransformBatchInterface *> tfbifs =
+	  bb->open_multiple_for_reading<TransformBatchInterface>("/tf/qa*");
+	const unsigned int max_transforms  = TransformBatchInterface::MAX_TRANSFORMS;
+	unsigned int       expected_chunks = (NUM_FRAMES + max_transforms - 1) / max_transforms;
+	if (tfbifs.size() != expected_chunks) {
+		printf("Expected %u batch interfaces, got %zu\n", expected_chunks, tfbifs.size());
+		++errors;
+	}
+
+	QaBatchCollector collector(tfbifs);
+	bb->register_listener(&collector, BlackBoard::BBIL_FLAG_DATA | BlackBoard::BBIL_FLAG_ASYNC);
+
+	// rounds are published faster than the collector processes them
+	for (unsigned int r = 1; r <= NUM_ROUNDS; ++r) {
+		publisher->send_transforms(snapshot(NUM_FRAMES, r));
+	}
+
+	// synchronous listener, every chunk of the last snapshot must be in the buffer
+	for (unsigned int i = 0; i < NUM_FRAMES; ++i) {
+		char child[16];
+		snprintf(child, sizeof(child), "f%u", i);
+		try {
+			StampedTransform st;
+			transformer.lookup_transform("base", child, Time(1000 + NUM_ROUNDS, 0), st);
+			if ((st.getOrigin().x() != NUM_ROUNDS) || (st.getOrigin().y() != 0.01 * i)) {
+				printf("Frame %s has unexpected translation\n", child);
+				++errors;
+			}
+		} catch (Exception &e) {
+			printf("Frame %s not available: %s\n", child, e.what_no_backtrace());
+			++errors;
+		}
+	}
+
+	// coalescing listener, the latest data of every chunk must arrive
+	unsigned int num_latest = 0;
+	for (unsigned int i = 0; (i < 100) && (num_latest < NUM_FRAMES); ++i) {
+		usleep(COLLECTOR_DELAY_USEC);
+		num_latest = collector.num_frames_with_x(NUM_ROUNDS);
+	}
+	printf("Coalescing listener has latest data for %u of %u frames (%u events coalesced)\n",
+	       num_latest,
+	       NUM_FRAMES,
+	       collector.bbil_async_num_coalesced());
+	if (num_latest != NUM_FRAMES) {
+		++errors;
+	}
+
+	// a smaller snapshot must clear the chunks it does not use anymore
+	publisher->send_transforms(snapshot(10, NUM_ROUNDS + 1));
+	std::list<TransformBatchInterface *>::iterator b;
+	unsigned int                                   num_transforms = 0;
+	for (b = tfbifs.begin(); b != tfbifs.end(); ++b) {
+		(*b)->read();
+		num_transforms += (*b)->num_transforms();
+	}
+	if (num_transforms != 10) {
+		printf("Batch interfaces hold %u transforms after shrinking, expected 10\n", num_transforms);
+		++errors;
+	}
+
+	bb->unregister_listener(&collector);
+	for (b = tfbifs.begin(); b != tfbifs.end(); ++b) {
+		bb->close(*b);
+	}
+	delete publisher;
+	delete listener;
+	delete bb;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,174 @@
+
+/***************************************************************************
+ *  qa_tf_benchmark.cpp - Benchmark tf lookups in deep frame trees
+ *
+ *  Created: Thu Oct 22 10:12:47 2026
+ *  Copyright  2011-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <tf/buffer_core.h>
+#include <tf/exceptions.h>
+#include <tf/transformer.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+/** Fill a chain of frames with transforms at a fixed rate.
+ * Frames are named f0 (root) to f<depth> (leaf).
+ */
+static void
+populate(BufferCore &buffer, unsigned int depth, unsigned int num_stamps, const Time &start)
+{
+	for (unsigned int s = 0; s < num_stamps; ++s) {
+		Time stamp = start + (double)s * 0.01;
+		for (unsigned int d = 1; d <= depth; ++d) {
+			char parent[16], child[16];
+			snprintf(parent, sizeof(parent), "f%u", d - 1);
+			snprintf(child, sizeof(child), "f%u", d);
+			Quaternion q;
+			q.setEulerZYX(0.01 * s + 0.1 * d, 0., 0.);
+			Transform        t(q, Vector3(0.1, 0.01 * d, 0.001 * s));
+			StampedTransform st(t, stamp, parent, child);
+			buffer.set_transform(st, "qa");
+		}
+	}
+}
+
+static double
+benchmark(BufferCore::CacheType type,
+          const char *          name,
+          unsigned int          depth,
+          unsigned int          num_stamps,
+          unsigned int          num_lookups,
+          StampedTransform &    last)
+{
+	BufferCore buffer(num_stamps * 0.01 + 1., type);
+	Time       start(1000, 0);
+	populate(buffer, depth, num_stamps, start);
+
+	char leaf[16];
+	snprintf(leaf, sizeof(leaf), "f%u", depth);
+
+	srand(42);
+	Time t_start;
+	for (unsigned int i = 0; i < num_lookups; ++i) {
+		// random time within the buffered range, usually between two stamps
+		Time t = start + (double)(rand() % ((num_stamps - 1) * 100)) * 0.0001;
+		buffer.lookup_transform("f0", leaf, t, last);
+	}
+	Time   t_end;
+	double secs = t_end - &t_start;
+	double rate = num_lookups / secs;
+
+	printf("%-5s depth %3u, %5u stamps: %10.0f lookups/s\n", name, depth, num_stamps, rate);
+	return rate;
+}
+
+static bool
+benchmark_handle(unsigned int depth, unsigned int num_stamps, unsigned int num_lookups)
+{
+	Transformer tf(num_stamps * 0.01 + 1.);
+	Time        start(1000, 0);
+	populate(tf, depth, num_stamps, start);
+
+	char leaf[16], mid[16];
+	snprintf(leaf, sizeof(leaf), "f%u", depth);
+	snprintf(mid, sizeof(mid), "f%u", depth / 2);
+	// leaf to middle of chain, the common ancestor is not the root
+	TransformHandle handle = tf.create_handle(mid, leaf);
+
+	std::vector<Time> times(num_lookups);
+	srand(42);
+	for (unsigned int i = 0; i < num_lookups; ++i) {
+		times[i] = start + (double)(rand() % ((num_stamps - 1) * 100)) * 0.0001;
+	}
+
+	StampedTransform result;
+	Time             t_start;
+	for (unsigned int i = 0; i < num_lookups; ++i) {
+		tf.lookup_transform(mid, leaf, times[i], result);
+	}
+	Time t_lookup;
+	for (unsigned int i = 0; i < num_lookups; ++i) {
+		handle.lookup_transform(times[i], result);
+	}
+	Time t_handle;
+
+	bool ok = true;
+	for (unsigned int i = 0; ok && i < num_lookups; i += 97) {
+		StampedTransform expected, actual;
+		tf.lookup_transform(mid, leaf, times[i], expected);
+		handle.lookup_transform(times[i], actual);
+		ok = (expected.getOrigin().distance(actual.getOrigin()) < 1e-9)
+		     && (std::fabs(expected.getRotation().dot(actual.getRotation())) > 1. - 1e-9);
+	}
+
+	double lookup_rate = num_lookups / (t_lookup - &t_start);
+	double handle_rate = num_lookups / (t_handle - &t_lookup);
+	printf("handle depth %3u, %5u stamps: %10.0f lookups/s (regular %10.0f, speedup %.2f)%s\n",
+	       depth,
+	       num_stamps,
+	       handle_rate,
+	       lookup_rate,
+	       handle_rate / lookup_rate,
+	       ok ? "" : " RESULTS DIFFER");
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int num_lookups = (argc > 1) ? atoi(argv[1]) : 20000;
+
+	const unsigned int depths[] = {10, 50};
+	const unsigned int stamps[] = {100, 1000};
+	bool               ok       = true;
+
+	for (unsigned int d = 0; d < sizeof(depths) / sizeof(depths[0]); ++d) {
+		for (unsigned int s = 0; s < sizeof(stamps) / sizeof(stamps[0]); ++s) {
+			StampedTransform list_result, ring_result;
+			double           list_rate, ring_rate;
+			list_rate =
+			  benchmark(BufferCore::CACHE_LIST, "list", depths[d], stamps[s], num_lookups, list_result);
+			ring_rate =
+			  benchmark(BufferCore::CACHE_RING, "ring", depths[d], stamps[s], num_lookups, ring_result);
+			printf("      speedup %.2f\n", ring_rate / list_rate);
+
+			if (list_result.getOrigin().distance(ring_result.getOrigin()) > 1e-9
+			    || std::fabs(list_result.getRotation().dot(ring_result.getRotation())) < 1. - 1e-9) {
+				printf("Results of list and ring cache differ\n");
+				ok = false;
+			}
+
+			ok = benchmark_handle(depths[d], stamps[s], num_lookups) && ok;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
+
+/// @endcond
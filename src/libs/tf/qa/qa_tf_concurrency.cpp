@@ -0,0 +1,189 @@
+
+/***************************************************************************
+ *  qa_tf_concurrency.cpp - Stress test concurrent tf lookups and inserts
+ *
+ *  Created: Thu Oct 22 15:36:08 2026
+ *  Copyright  2011-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <core/threading/thread.h>
+#include <tf/exceptions.h>
+#include <tf/transformer.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+#define DEPTH 20
+
+class QaTfWriterThread : public Thread
+{
+public:
+	QaTfWriterThread(Transformer *tf)
+	: Thread("QaTfWriterThread", Thread::OPMODE_CONTINUOUS), count(0), tf_(tf), stamp_(1000, 0)
+	{
+		insert();
+	}
+
+	virtual void
+	loop()
+	{
+		insert();
+		// add a frame now and then to force publishing new frame tables
+		if (count % (DEPTH * 1000) == 0) {
+			char child[32];
+			snprintf(child, sizeof(child), "extra%lu", count / (DEPTH * 1000));
+			StampedTransform st(Transform(Quaternion(0, 0, 0, 1), Vector3(0, 0, 1)),
+			                    stamp_,
+			                    "f0",
+			                    child);
+			tf_->set_transform(st, "qa");
+		}
+	}
+
+	unsigned long count;
+
+private:
+	void
+	insert()
+	{
+		stamp_ += 0.01;
+		for (unsigned int d = 1; d <= DEPTH; ++d) {
+			char parent[16], child[16];
+			snprintf(parent, sizeof(parent), "f%u", d - 1);
+			snprintf(child, sizeof(child), "f%u", d);
+			Quaternion q;
+			q.setEulerZYX(0.001 * count + 0.1 * d, 0., 0.);
+			StampedTransform st(Transform(q, Vector3(0.1, 0.01 * d, 0.)), stamp_, parent, child);
+			tf_->set_transform(st, "qa");
+			++count;
+		}
+	}
+
+	Transformer *tf_;
+	Time         stamp_;
+};
+
+class QaTfReaderThread : public Thread
+{
+public:
+	QaTfReaderThread(Transformer *tf, bool global_lock)
+	: Thread("QaTfReaderThread", Thread::OPMODE_CONTINUOUS),
+	  count(0),
+	  errors(0),
+	  tf_(tf),
+	  global_lock_(global_lock)
+	{
+		snprintf(leaf_, sizeof(leaf_), "f%u", DEPTH);
+	}
+
+	virtual void
+	loop()
+	{
+		for (unsigned int i = 0; i < 100; ++i) {
+			StampedTransform result;
+			// emulate a single mutex serializing all accesses
+			if (global_lock_)
+				tf_->lock();
+			try {
+				tf_->lookup_transform("f0", leaf_, result);
+			} catch (TransformException &e) {
+				++errors;
+			}
+			if (global_lock_)
+				tf_->unlock();
+			++count;
+		}
+	}
+
+	unsigned long count;
+	unsigned long errors;
+
+private:
+	Transformer *tf_;
+	bool         global_lock_;
+	char         leaf_[16];
+};
+
+static bool
+run(const char *mode, bool global_lock, unsigned int num_readers, unsigned int duration_sec)
+{
+	Transformer tf(10.);
+
+	QaTfWriterThread *              writer = new QaTfWriterThread(&tf);
+	std::vector<QaTfReaderThread *> readers;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers.push_back(new QaTfReaderThread(&tf, global_lock));
+	}
+
+	Time start;
+	writer->start();
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers[i]->start();
+	}
+	sleep(duration_sec);
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers[i]->cancel();
+		readers[i]->join();
+	}
+	writer->cancel();
+	writer->join();
+	Time   end;
+	double secs = end - &start;
+
+	unsigned long lookups = 0, errors = 0;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		lookups += readers[i]->count;
+		errors += readers[i]->errors;
+		delete readers[i];
+	}
+	printf("%-9s readers: %2u  inserts/s: %10.0f  lookups/s: %10.0f  errors: %lu\n",
+	       mode,
+	       num_readers,
+	       writer->count / secs,
+	       lookups / secs,
+	       errors);
+
+	delete writer;
+	return errors == 0;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int duration_sec = (argc > 1) ? atoi(argv[1]) : 2;
+
+	bool               ok            = true;
+	const unsigned int num_readers[] = {1, 2, 4, 8};
+	for (unsigned int i = 0; i < sizeof(num_readers) / sizeof(num_readers[0]); ++i) {
+		ok = run("global", true, num_readers[i], duration_sec) && ok;
+		ok = run("lock-free", false, num_readers[i], duration_sec) && ok;
+	}
+
+	printf("QA %s\n", ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
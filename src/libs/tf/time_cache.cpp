@@ -300,11 +300,17 @@ TimeCache::find_closest(TransformStorage *&one,
 	return 2;
 }
 
-void
-TimeCache::interpolate(const TransformStorage &one,
-                       const TransformStorage &two,
-                       fawkes::Time            time,
-                       TransformStorage &      output)
+/** Interpolate between two transforms.
+ * @param one older transform
+ * @param two newer transform
+ * @param time time to interpolate for
+ * @param output upon return contains the interpolated transform
+ */
+static inline void
+interpolate_storage(const TransformStorage &one,
+                    const TransformStorage &two,
+                    fawkes::Time            time,
+                    TransformStorage &      output)
 {
 	// Check for zero distance case
 	if (two.stamp == one.stamp) {
@@ -325,6 +331,15 @@ TimeCache::interpolate(const TransformStorage &one,
 	output.child_frame_id = one.child_frame_id;
 }
 
+void
+TimeCache::interpolate(const TransformStorage &one,
+                       const TransformStorage &two,
+                       fawkes::Time            time,
+                       TransformStorage &      output)
+{
+	interpolate_storage(one, two, time, output);
+}
+
 TimeCacheInterfacePtr
 TimeCache::clone(const fawkes::Time &look_back_until) const
 {
@@ -462,5 +477,277 @@ TimeCache::prune_list()
 	}
 }
 
+/** @class RingTimeCache <tf/time_cache.h>
+ * Time based transform cache on a ring buffer.
+ * Drop-in replacement for TimeCache. Transforms are kept in a contiguous
+ * ring buffer ordered by time, oldest first. Transforms usually arrive in
+ * time order and are appended in constant time, pruning old entries only
+ * advances the start of the ring. Lookups find the bracketing transforms
+ * by binary search instead of walking a linked list. The ring grows by
+ * doubling its capacity when full.
+ */
+
+/** Constructor.
+ * @param max_storage_time maximum time in seconds to cache
+ */
+RingTimeCache::RingTimeCache(float max_storage_time)
+: ring_(INITIAL_CAPACITY),
+  head_(0),
+  size_(0),
+  mask_(INITIAL_CAPACITY - 1),
+  max_storage_time_(max_storage_time)
+{
+}
+
+/** Destructor. */
+RingTimeCache::~RingTimeCache()
+{
+}
+
+/** Find position of first transform younger than the given time.
+ * @param time time to search for
+ * @return position of first element with a stamp larger than time, size_
+ * if there is no such element
+ */
+size_t
+RingTimeCache::upper_bound(const fawkes::Time &time) const
+{
+	size_t first = 0;
+	size_t count = size_;
+	while (count > 0) {
+		size_t step = count / 2;
+		if (at(first + step).stamp <= time) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+	return first;
+}
+
+/// A helper function for get_data and get_parent
+uint8_t
+RingTimeCache::find_closest(TransformStorage *&one,
+                            TransformStorage *&two,
+                            fawkes::Time       target_time,
+                            std::string *      error_str)
+{
+	if (size_ == 0) {
+		if (error_str)
+			*error_str = "Transform cache storage is empty";
+		return 0;
+	}
+
+	TransformStorage &latest = at(size_ - 1);
+
+	//If time == 0 return the latest
+	if (target_time.is_zero()) {
+		one = &latest;
+		return 1;
+	}
+
+	if (size_ == 1) {
+		if (latest.stamp == target_time) {
+			one = &latest;
+			return 1;
+		} else {
+			create_extrapolation_exception1(target_time, latest.stamp, error_str);
+			return 0;
+		}
+	}
+
+	TransformStorage &earliest = at(0);
+
+	if (target_time == latest.stamp) {
+		one = &latest;
+		return 1;
+	} else if (target_time == earliest.stamp) {
+		one = &earliest;
+		return 1;
+	} else if (target_time > latest.stamp) {
+		create_extrapolation_exception2(target_time, latest.stamp, error_str);
+		return 0;
+	} else if (target_time < earliest.stamp) {
+		create_extrapolation_exception3(target_time, earliest.stamp, error_str);
+		return 0;
+	}
+
+	// earliest < target_time < latest, hence 1 <= pos <= size_ - 1
+	size_t pos = upper_bound(target_time);
+	one        = &at(pos - 1); //Older
+	two        = &at(pos);     //Newer
+	return 2;
+}
+
+TimeCacheInterfacePtr
+RingTimeCache::clone(const fawkes::Time &look_back_until) const
+{
+	RingTimeCache *copy = new RingTimeCache(max_storage_time_);
+	size_t         pos  = look_back_until.is_zero() ? 0 : upper_bound(look_back_until);
+	while (copy->ring_.size() < size_ - pos) {
+		copy->grow();
+	}
+	for (size_t i = pos; i < size_; ++i) {
+		copy->ring_[copy->size_++] = at(i);
+	}
+	return std::shared_ptr<TimeCacheInterface>(copy);
+}
+
+bool
+RingTimeCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str)
+{
+	TransformStorage *p_temp_1 = NULL;
+	TransformStorage *p_temp_2 = NULL;
+
+	int num_nodes = find_closest(p_temp_1, p_temp_2, time, error_str);
+	if (num_nodes == 0) {
+		return false;
+	} else if (num_nodes == 1) {
+		data_out = *p_temp_1;
+	} else if (num_nodes == 2) {
+		if (p_temp_1->frame_id == p_temp_2->frame_id) {
+			interpolate_storage(*p_temp_1, *p_temp_2, time, data_out);
+		} else {
+			data_out = *p_temp_1;
+		}
+	}
+
+	return true;
+}
+
+CompactFrameID
+RingTimeCache::get_parent(fawkes::Time time, std::string *error_str)
+{
+	TransformStorage *p_temp_1 = NULL;
+	TransformStorage *p_temp_2 = NULL;
+
+	int num_nodes = find_closest(p_temp_1, p_temp_2, time, error_str);
+	if (num_nodes == 0) {
+		return 0;
+	}
+
+	return p_temp_1->frame_id;
+}
+
+/** Double the capacity of the ring.
+ * Elements are moved such that the oldest one is at the start of the
+ * new buffer.
+ */
+void
+RingTimeCache::grow()
+{
+	std::vector<TransformStorage> new_ring(ring_.size() * 2);
+	for (size_t i = 0; i < size_; ++i) {
+		new_ring[i] = at(i);
+	}
+	ring_.swap(new_ring);
+	head_ = 0;
+	mask_ = ring_.size() - 1;
+}
+
+bool
+RingTimeCache::insert_data(const TransformStorage &new_data)
+{
+	if (size_ > 0 && at(size_ - 1).stamp > new_data.stamp + max_storage_time_) {
+		return false;
+	}
+
+	if (size_ == ring_.size()) {
+		grow();
+	}
+
+	if (size_ == 0 || at(size_ - 1).stamp <= new_data.stamp) {
+		// common case, data arrives in order
+		at(size_++) = new_data;
+	} else {
+		// insert after all elements not younger than the new one, like
+		// TimeCache does, and shift the younger ones towards the end
+		size_t pos = upper_bound(new_data.stamp);
+		for (size_t i = size_; i > pos; --i) {
+			at(i) = at(i - 1);
+		}
+		at(pos) = new_data;
+		++size_;
+	}
+
+	prune_list();
+	return true;
+}
+
+void
+RingTimeCache::clear_list()
+{
+	head_ = 0;
+	size_ = 0;
+}
+
+unsigned int
+RingTimeCache::get_list_length() const
+{
+	return size_;
+}
+
+/** Get storage list.
+ * The list is created on each call, ordered from the latest to the oldest
+ * transform like the one of TimeCache. It is only valid until the next call.
+ * @return reference to list of storage elements
+ */
+const TimeCacheInterface::L_TransformStorage &
+RingTimeCache::get_storage() const
+{
+	storage_as_list_ = get_storage_copy();
+	return storage_as_list_;
+}
+
+TimeCacheInterface::L_TransformStorage
+RingTimeCache::get_storage_copy() const
+{
+	L_TransformStorage rv;
+	for (size_t i = size_; i > 0; --i) {
+		rv.push_back(at(i - 1));
+	}
+	return rv;
+}
+
+P_TimeAndFrameID
+RingTimeCache::get_latest_time_and_parent()
+{
+	if (size_ == 0) {
+		return std::make_pair(fawkes::Time(), 0);
+	}
+
+	const TransformStorage &ts = at(size_ - 1);
+	return std::make_pair(ts.stamp, ts.frame_id);
+}
+
+fawkes::Time
+RingTimeCache::get_latest_timestamp() const
+{
+	if (size_ == 0)
+		return fawkes::Time(0, 0); //empty list case
+	return at(size_ - 1).stamp;
+}
+
+fawkes::Time
+RingTimeCache::get_oldest_timestamp() const
+{
+	if (size_ == 0)
+		return fawkes::Time(0, 0); //empty list case
+	return at(0).stamp;
+}
+
+/** Prune storage based on maximum cache lifetime. */
+void
+RingTimeCache::prune_list()
+{
+	fawkes::Time latest_time = at(size_ - 1).stamp;
+
+	while (size_ > 0 && at(0).stamp + max_storage_time_ < latest_time) {
+		head_ = (head_ + 1) & mask_;
+		--size_;
+	}
+}
+
 } // end namespace tf
 } // end namespace fawkes
@@ -58,6 +58,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace fawkes {
 namespace tf {
@@ -138,6 +139,68 @@ private:
 	void prune_list();
 };
 
+class RingTimeCache : public TimeCacheInterface
+{
+public:
+	/// Initial number of transforms the ring buffer can hold.
+	static const unsigned int INITIAL_CAPACITY = 64;
+
+	RingTimeCache(float max_storage_time = TimeCache::DEFAULT_MAX_STORAGE_TIME);
+	virtual ~RingTimeCache();
+
+	virtual TimeCacheInterfacePtr clone(const fawkes::Time &look_back_until = fawkes::Time(0,
+	                                                                                       0)) const;
+	virtual bool get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str = 0);
+	virtual bool insert_data(const TransformStorage &new_data);
+	virtual void clear_list();
+	virtual CompactFrameID   get_parent(fawkes::Time time, std::string *error_str);
+	virtual P_TimeAndFrameID get_latest_time_and_parent();
+
+	virtual const L_TransformStorage &get_storage() const;
+	virtual L_TransformStorage        get_storage_copy() const;
+
+	virtual unsigned int get_list_length() const;
+	virtual fawkes::Time get_latest_timestamp() const;
+	virtual fawkes::Time get_oldest_timestamp() const;
+
+private:
+	/** Get element by position in time order.
+	 * @param i position, 0 is the oldest element
+	 * @return element at the given position
+	 */
+	inline TransformStorage &
+	at(size_t i)
+	{
+		return ring_[(head_ + i) & mask_];
+	}
+	/** Get element by position in time order.
+	 * @param i position, 0 is the oldest element
+	 * @return element at the given position
+	 */
+	inline const TransformStorage &
+	at(size_t i) const
+	{
+		return ring_[(head_ + i) & mask_];
+	}
+
+	inline size_t  upper_bound(const fawkes::Time &time) const;
+	inline uint8_t find_closest(TransformStorage *&one,
+	                            TransformStorage *&two,
+	                            fawkes::Time       target_time,
+	                            std::string *      error_str);
+	void           grow();
+	void           prune_list();
+
+	std::vector<TransformStorage> ring_;
+	size_t                        head_;
+	size_t                        size_;
+	size_t                        mask_;
+
+	float max_storage_time_;
+
+	mutable L_TransformStorage storage_as_list_;
+};
+
 class StaticCache : public TimeCacheInterface
 {
 public:
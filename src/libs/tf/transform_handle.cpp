@@ -0,0 +1,199 @@
+
+/***************************************************************************
+ *  transform_handle.cpp - Cached lookups of a fixed pair of frames
+ *
+ *  Created: Fri Oct 23 11:02:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <tf/exceptions.h>
+#include <tf/transform_handle.h>
+#include <tf/transformer.h>
+#include <tf/utils.h>
+
+#include <cmath>
+
+namespace fawkes {
+namespace tf {
+
+/** @class TransformHandle <tf/transform_handle.h>
+ * Repeated lookups of the transform between a fixed pair of frames.
+ * A regular lookup walks the tree from both frames to their common
+ * ancestor on every call. The handle resolves this chain of frames
+ * once and afterwards only interpolates the transforms along the
+ * chain. The chain is resolved again once the structure of the tree
+ * changes, i.e. when frames are added or re-parented (cf.
+ * BufferCore::structure_version()).
+ *
+ * Additionally, the last result is kept and returned for lookups for
+ * times that are within a given tolerance of its time stamp, as long
+ * as the tree structure remains unchanged. Transforms that arrive
+ * in the meantime are not considered for such lookups. With a
+ * tolerance of zero only lookups for the very same time are served
+ * from the cache.
+ *
+ * Lookups for the latest common time, i.e. with a zero time, are
+ * passed on to Transformer::lookup_transform().
+ *
+ * A handle is meant to be used by a single thread. It must not be used
+ * after the transformer has been destroyed.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * The frames need not exist at construction time.
+ * @param transformer transformer to query for transforms
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @param tolerance_sec time in seconds within which a previous
+ * lookup result is returned instead of computing a new one
+ */
+TransformHandle::TransformHandle(const Transformer *transformer,
+                                 const std::string &target_frame,
+                                 const std::string &source_frame,
+                                 float              tolerance_sec)
+: transformer_(transformer),
+  target_frame_(strip_slash(target_frame)),
+  source_frame_(strip_slash(source_frame)),
+  tolerance_(tolerance_sec),
+  target_id_(0),
+  source_id_(0),
+  chain_valid_(false),
+  chain_version_(0),
+  have_cached_(false)
+{
+}
+
+/** Invalidate cached chain and transform.
+ * The next lookup will resolve the chain again.
+ */
+void
+TransformHandle::invalidate()
+{
+	chain_valid_ = false;
+	have_cached_ = false;
+}
+
+/** Resolve frame chain.
+ * Must be called within a read section of the transformer.
+ * @param time time for which to resolve the chain
+ * @return true if the chain has been resolved, false otherwise
+ */
+bool
+TransformHandle::resolve(const fawkes::Time &time)
+{
+	const BufferCore *core = transformer_;
+	// frame IDs never change once assigned
+	if (target_id_ == 0)
+		target_id_ = core->lookup_frame_number(target_frame_);
+	if (source_id_ == 0)
+		source_id_ = core->lookup_frame_number(source_frame_);
+	if (target_id_ == 0 || source_id_ == 0)
+		return false;
+
+	return core->resolve_chain(target_id_, source_id_, time, target_chain_, source_chain_);
+}
+
+/** Lookup transform.
+ * @param time time for which to get the transform, set to (0,0) to get
+ * the latest common time frame
+ * @param transform upon return contains the transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException at least one of the two given frames is
+ * unknown
+ * @exception DisabledException thrown if the transformer is disabled
+ */
+void
+TransformHandle::lookup_transform(const fawkes::Time &time, StampedTransform &transform)
+{
+	if (!transformer_->is_enabled()) {
+		throw DisabledException("Transformer has been disabled");
+	}
+
+	if ((time == fawkes::Time(0, 0)) || (target_frame_ == source_frame_)) {
+		transformer_->lookup_transform(target_frame_, source_frame_, time, transform);
+		return;
+	}
+
+	const BufferCore *core    = transformer_;
+	unsigned int      version = core->structure_version();
+	if (chain_valid_ && (version == chain_version_) && have_cached_
+	    && (std::fabs(time - &cached_.stamp) <= tolerance_)) {
+		transform = cached_;
+		return;
+	}
+
+	{
+		BufferCore::ReadSection section(core);
+		if (!chain_valid_ || (version != chain_version_)) {
+			have_cached_   = false;
+			chain_valid_   = resolve(time);
+			chain_version_ = version;
+		}
+
+		if (chain_valid_ && core->lookup_chain(target_chain_, source_chain_, time, transform)) {
+			transform.stamp          = time;
+			transform.frame_id       = target_frame_;
+			transform.child_frame_id = source_frame_;
+			cached_                  = transform;
+			have_cached_             = true;
+			return;
+		}
+	}
+
+	// The chain does not match the data for this time or the data is
+	// not available at all. The full lookup either finds another path
+	// or throws a descriptive exception.
+	invalidate();
+	transformer_->lookup_transform(target_frame_, source_frame_, time, transform);
+}
+
+/** Transform points from the source into the target frame.
+ * The transform is looked up once and applied to all points.
+ * @param time time for which to get the transform
+ * @param points_in points in the source frame
+ * @param points_out upon return contains the points in the target
+ * frame, may be the same vector as points_in
+ * @exception TransformException thrown if the transform cannot be
+ * determined, cf. lookup_transform()
+ */
+void
+TransformHandle::transform_points(const fawkes::Time &      time,
+                                  const std::vector<Point> &points_in,
+                                  std::vector<Point> &      points_out)
+{
+	StampedTransform transform;
+	lookup_transform(time, transform);
+
+	const Matrix3x3 &basis  = transform.getBasis();
+	const Vector3 &  origin = transform.getOrigin();
+	const Vector3 &  row0 = basis[0], &row1 = basis[1], &row2 = basis[2];
+
+	points_out.resize(points_in.size());
+	for (size_t i = 0; i < points_in.size(); ++i) {
+		const Point &p = points_in[i];
+		points_out[i].setValue(row0.dot(p) + origin.x(),
+		                       row1.dot(p) + origin.y(),
+		                       row2.dot(p) + origin.z());
+	}
+}
+
+} // end namespace tf
+} // end namespace fawkes
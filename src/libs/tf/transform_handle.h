@@ -0,0 +1,91 @@
+
+/***************************************************************************
+ *  transform_handle.h - Cached lookups of a fixed pair of frames
+ *
+ *  Created: Fri Oct 23 11:02:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_TF_TRANSFORM_HANDLE_H_
+#define _LIBS_TF_TRANSFORM_HANDLE_H_
+
+#include <tf/types.h>
+#include <utils/time/time.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+namespace tf {
+
+class Transformer;
+
+class TransformHandle
+{
+public:
+	TransformHandle(const Transformer *transformer,
+	                const std::string &target_frame,
+	                const std::string &source_frame,
+	                float              tolerance_sec = 0.);
+
+	void lookup_transform(const fawkes::Time &time, StampedTransform &transform);
+	void transform_points(const fawkes::Time &       time,
+	                      const std::vector<Point> &points_in,
+	                      std::vector<Point> &      points_out);
+
+	void invalidate();
+
+	/** Get target frame.
+	 * @return target frame ID */
+	const std::string &
+	target_frame() const
+	{
+		return target_frame_;
+	}
+
+	/** Get source frame.
+	 * @return source frame ID */
+	const std::string &
+	source_frame() const
+	{
+		return source_frame_;
+	}
+
+private:
+	bool resolve(const fawkes::Time &time);
+
+private:
+	const Transformer *transformer_;
+	std::string        target_frame_;
+	std::string        source_frame_;
+	double             tolerance_;
+
+	CompactFrameID              target_id_;
+	CompactFrameID              source_id_;
+	bool                        chain_valid_;
+	unsigned int                chain_version_;
+	std::vector<CompactFrameID> target_chain_;
+	std::vector<CompactFrameID> source_chain_;
+
+	bool             have_cached_;
+	StampedTransform cached_;
+};
+
+} // end namespace tf
+} // end namespace fawkes
+
+#endif
@@ -50,11 +50,13 @@
  */
 
 #include <blackboard/blackboard.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <tf/transform_listener.h>
 #include <tf/transformer.h>
 
 #include <cstring>
+#include <vector>
 
 namespace fawkes {
 namespace tf {
@@ -63,8 +65,9 @@ namespace tf {
  * Receive transforms and answer queries.
  * This class connects to the blackboard and listens to all interfaces
  * publishing transforms. It opens all interfaces of type
- * TransformInterface with a TF prefix. The data is internally
- * cached. Queries are then resolved based on the received
+ * TransformInterface and TransformBatchInterface with a TF prefix.
+ * The transforms of a batch are added to the transformer at once.
+ * The data is internally cached. Queries are then resolved based on the received
  * information.
  * @author Tim Niemueller
  */
@@ -89,9 +92,16 @@ TransformListener::TransformListener(BlackBoard *bb, Transformer *tf_transformer
 			// update data once we
 			bb_interface_data_changed(*i);
 		}
+		tfbifs_ = bb_->open_multiple_for_reading<TransformBatchInterface>("/tf*");
+		std::list<TransformBatchInterface *>::iterator b;
+		for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+			bbil_add_data_interface(*b);
+			bb_interface_data_changed(*b);
+		}
 		bb_->register_listener(this);
 
 		bbio_add_observed_create("TransformInterface", "/tf*");
+		bbio_add_observed_create("TransformBatchInterface", "/tf*");
 		bb_->register_observer(this);
 		tf_transformer->set_enabled(true);
 	} else {
@@ -111,18 +121,36 @@ TransformListener::~TransformListener()
 			bb_->close(*i);
 		}
 		tfifs_.clear();
+
+		std::list<TransformBatchInterface *>::iterator b;
+		for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+			bb_->close(*b);
+		}
+		tfbifs_.clear();
 	}
 }
 
 void
 TransformListener::bb_interface_created(const char *type, const char *id) throw()
 {
-	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) != 0)
-		return;
+	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) == 0) {
+		open_created(id, tfifs_);
+	} else if (strncmp(type, "TransformBatchInterface", INTERFACE_TYPE_SIZE_) == 0) {
+		open_created(id, tfbifs_);
+	}
+}
 
-	TransformInterface *tfif;
+/** Open a newly created interface and add it to the listener.
+ * @param id ID of the interface
+ * @param ifaces list to add the opened interface to
+ */
+template <class InterfaceType>
+void
+TransformListener::open_created(const char *id, std::list<InterfaceType *> &ifaces) throw()
+{
+	InterfaceType *tfif;
 	try {
-		tfif = bb_->open_for_reading<TransformInterface>(id, "TF-Listener");
+		tfif = bb_->open_for_reading<InterfaceType>(id, "TF-Listener");
 	} catch (Exception &e) {
 		// ignored
 		return;
@@ -133,7 +161,7 @@ TransformListener::bb_interface_created(const char *type, const char *id) throw(
 	try {
 		bbil_add_data_interface(tfif);
 		bb_->update_listener(this);
-		tfifs_.push_back(tfif);
+		ifaces.push_back(tfif);
 	} catch (Exception &e) {
 		bb_->close(tfif);
 		return;
@@ -160,42 +188,65 @@ TransformListener::conditional_close(Interface *interface) throw()
 	if (bb_is_remote_) {
 		return;
 	}
-	// Verify it's a TransformInterface
-	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
-		return;
+	// Verify it's one of our interfaces
+	if (dynamic_cast<TransformInterface *>(interface)) {
+		conditional_close(interface, tfifs_);
+	} else if (dynamic_cast<TransformBatchInterface *>(interface)) {
+		conditional_close(interface, tfbifs_);
+	}
+}
 
-	std::list<TransformInterface *>::iterator i;
-	for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
+/** Close interface if we are the only one left using it.
+ * @param interface interface to close
+ * @param ifaces list of interfaces of this type to remove it from
+ */
+template <class InterfaceType>
+void
+TransformListener::conditional_close(Interface *                 interface,
+                                     std::list<InterfaceType *> &ifaces) throw()
+{
+	typename std::list<InterfaceType *>::iterator i;
+	for (i = ifaces.begin(); i != ifaces.end(); ++i) {
 		if (*interface == **i) {
 			if (!interface->has_writer() && (interface->num_readers() == 1)) {
 				// It's only us
 				bbil_remove_data_interface(*i);
 				bb_->update_listener(this);
 				bb_->close(*i);
-				tfifs_.erase(i);
+				ifaces.erase(i);
 				break;
 			}
 		}
 	}
 }
 
+/** Get authority to record for transforms received through an interface.
+ * @param interface interface the transforms were received on
+ * @return authority string
+ */
+std::string
+TransformListener::authority(Interface *interface) const
+{
+	if (bb_is_remote_) {
+		return "remote";
+	} else {
+		return interface->writer();
+	}
+}
+
 void
 TransformListener::bb_interface_data_changed(Interface *interface) throw()
 {
 	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
+	if (!tfif) {
+		TransformBatchInterface *tfbif = dynamic_cast<TransformBatchInterface *>(interface);
+		if (tfbif)
+			batch_data_changed(tfbif);
 		return;
+	}
 
 	tfif->read();
 
-	std::string authority;
-	if (bb_is_remote_) {
-		authority = "remote";
-	} else {
-		std::string authority = tfif->writer();
-	}
-
 	double *          translation    = tfif->translation();
 	double *          rotation       = tfif->rotation();
 	const Time *      time           = tfif->timestamp();
@@ -210,11 +261,66 @@ TransformListener::bb_interface_data_changed(Interface *interface) throw()
 
 		StampedTransform str(tr, *time, frame_id, child_frame_id);
 
-		tf_transformer_->set_transform(str, authority, tfif->is_static_transform());
+		tf_transformer_->set_transform(str, authority(tfif), tfif->is_static_transform());
 	} catch (InvalidArgumentException &e) {
 		// ignore invalid, might just be not initialized, yet.
 	}
 }
 
+/** Add transforms of a batch to the transformer.
+ * @param tfbif batch interface whose data has changed
+ */
+void
+TransformListener::batch_data_changed(TransformBatchInterface *tfbif) throw()
+{
+	tfbif->read();
+
+	unsigned int num_transforms = tfbif->num_transforms();
+	if (num_transforms > TransformBatchInterface::MAX_TRANSFORMS) {
+		num_transforms = TransformBatchInterface::MAX_TRANSFORMS;
+	}
+
+	const char *   frames       = tfbif->frames();
+	const char *   child_frames = tfbif->child_frames();
+	const int64_t *stamps       = tfbif->stamps();
+	const double * translations = tfbif->translations();
+	const double * rotations    = tfbif->rotations();
+
+	std::vector<StampedTransform> transforms;
+	transforms.reserve(num_transforms);
+	for (unsigned int i = 0; i < num_transforms; ++i) {
+		const char *frame_end       = strchr(frames, '\n');
+		const char *child_frame_end = strchr(child_frames, '\n');
+		if (!frame_end || !child_frame_end) {
+			// truncated or not initialized, yet
+			break;
+		}
+
+		try {
+			Vector3    t(translations[i * 3], translations[i * 3 + 1], translations[i * 3 + 2]);
+			Quaternion r(rotations[i * 4],
+			             rotations[i * 4 + 1],
+			             rotations[i * 4 + 2],
+			             rotations[i * 4 + 3]);
+			assert_quaternion_valid(r);
+
+			Time stamp((long int)(stamps[i] / 1000000), (long int)(stamps[i] % 1000000));
+			transforms.push_back(StampedTransform(Transform(r, t),
+			                                      stamp,
+			                                      std::string(frames, frame_end),
+			                                      std::string(child_frames, child_frame_end)));
+		} catch (InvalidArgumentException &e) {
+			// ignore invalid, might just be not initialized, yet.
+		}
+
+		frames       = frame_end + 1;
+		child_frames = child_frame_end + 1;
+	}
+
+	if (!transforms.empty()) {
+		tf_transformer_->set_transforms(transforms, authority(tfbif), tfbif->is_static_transforms());
+	}
+}
+
 } // end namespace tf
 } // end namespace fawkes
@@ -57,11 +57,13 @@
 #include <tf/types.h>
 
 #include <list>
+#include <string>
 
 namespace fawkes {
 
 class BlackBoard;
 class TransformInterface;
+class TransformBatchInterface;
 
 namespace tf {
 
@@ -85,13 +87,20 @@ public:
 
 private:
 	void conditional_close(Interface *interface) throw();
+	template <class InterfaceType>
+	void conditional_close(Interface *interface, std::list<InterfaceType *> &ifaces) throw();
+	template <class InterfaceType>
+	void open_created(const char *id, std::list<InterfaceType *> &ifaces) throw();
+	void batch_data_changed(TransformBatchInterface *tfbif) throw();
+	std::string authority(Interface *interface) const;
 
 private:
 	BlackBoard * bb_;
 	Transformer *tf_transformer_;
 	bool         bb_is_remote_;
 
-	std::list<TransformInterface *> tfifs_;
+	std::list<TransformInterface *>      tfifs_;
+	std::list<TransformBatchInterface *> tfbifs_;
 };
 
 } // end namespace tf
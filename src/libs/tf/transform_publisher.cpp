@@ -52,6 +52,7 @@
 #include <blackboard/blackboard.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <tf/transform_publisher.h>
 
@@ -65,6 +66,17 @@ namespace tf {
  * that interface. Assuming that the event-based listener is used
  * it will catch all updates even though we might send them in quick
  * succession.
+ *
+ * A whole set of transforms, for example a snapshot of a robot's
+ * kinematic tree, can be sent at once with send_transforms(). These
+ * are published through a TransformBatchInterface with the same ID,
+ * which is opened on first use. A batch requires only a single
+ * interface write and is added to the listener's buffer with a single
+ * lock acquisition. Batches which do not fit into one interface are
+ * split into chunks, each written to its own interface with the chunk
+ * index appended to the ID (e.g. "/tf/robot#1"). Consumers which only
+ * process the latest data of an interface therefore still receive all
+ * chunks.
  * @author Tim Niemueller
  *
  * @fn   void TransformPublisher::send_transform(const Transform &transform, const fawkes::Time &time, const std::string frame, const std::string child_frame, const bool is_static = false)
@@ -87,11 +99,11 @@ namespace tf {
  * opened TransformInterface. Note that the name is prefixed with "/tf/".
  */
 TransformPublisher::TransformPublisher(BlackBoard *bb, const char *bb_iface_id)
-: bb_(bb), mutex_(new Mutex())
+: bb_(bb), tfif_(NULL), num_chunks_written_(0), mutex_(new Mutex())
 {
 	if (bb_) {
-		std::string bbid = (bb_iface_id[0] == '/') ? bb_iface_id : std::string("/tf/") + bb_iface_id;
-		tfif_            = bb_->open_for_writing<TransformInterface>(bbid.c_str());
+		bbid_ = (bb_iface_id[0] == '/') ? bb_iface_id : std::string("/tf/") + bb_iface_id;
+		tfif_ = bb_->open_for_writing<TransformInterface>(bbid_.c_str());
 		tfif_->set_auto_timestamping(false);
 	}
 }
@@ -102,8 +114,12 @@ TransformPublisher::TransformPublisher(BlackBoard *bb, const char *bb_iface_id)
  */
 TransformPublisher::~TransformPublisher()
 {
-	if (bb_)
+	if (bb_) {
 		bb_->close(tfif_);
+		for (size_t i = 0; i < tfbifs_.size(); ++i) {
+			bb_->close(tfbifs_[i]);
+		}
+	}
 	delete mutex_;
 }
 
@@ -140,5 +156,134 @@ TransformPublisher::send_transform(const StampedTransform &transform, bool is_st
 	tfif_->write();
 }
 
+/** Publish a batch of transforms.
+ * The transforms are written in chunks of at most
+ * TransformBatchInterface::MAX_TRANSFORMS transforms, the n-th chunk
+ * to the n-th batch interface. Listeners add each chunk to their
+ * buffer at once. Within a batch the transforms may have different
+ * time stamps. Chunk interfaces used by a previous, larger batch are
+ * cleared, so that their transforms are not republished.
+ * @param transforms transforms to publish
+ * @param is_static true to mark all transforms as static, false otherwise
+ */
+void
+TransformPublisher::send_transforms(const std::vector<StampedTransform> &transforms, bool is_static)
+{
+	if (!bb_) {
+		throw DisabledException("TransformPublisher is disabled");
+	}
+
+	MutexLocker lock(mutex_);
+
+	const size_t max_frames_len = batch_interface(0)->maxlenof_frames() - 1;
+	size_t       chunk = 0, first = 0, frames_len = 0, child_frames_len = 0;
+	for (size_t i = 0; i < transforms.size(); ++i) {
+		size_t f_len = transforms[i].frame_id.length() + 1;
+		size_t c_len = transforms[i].child_frame_id.length() + 1;
+		if ((f_len > max_frames_len) || (c_len > max_frames_len)) {
+			throw Exception("Frame ID of transform %s -> %s too long",
+			                transforms[i].frame_id.c_str(),
+			                transforms[i].child_frame_id.c_str());
+		}
+		if ((i - first == TransformBatchInterface::MAX_TRANSFORMS)
+		    || (frames_len + f_len > max_frames_len)
+		    || (child_frames_len + c_len > max_frames_len)) {
+			write_batch(batch_interface(chunk++), transforms, first, i, is_static);
+			first            = i;
+			frames_len       = 0;
+			child_frames_len = 0;
+		}
+		frames_len += f_len;
+		child_frames_len += c_len;
+	}
+	if (first < transforms.size()) {
+		write_batch(batch_interface(chunk++), transforms, first, transforms.size(), is_static);
+	}
+
+	for (size_t i = chunk; i < num_chunks_written_; ++i) {
+		tfbifs_[i]->set_num_transforms(0);
+		tfbifs_[i]->write();
+	}
+	num_chunks_written_ = chunk;
+}
+
+/** Get batch interface for a chunk.
+ * Must be called with the mutex held. The interface is opened if it
+ * has not been used before. The first chunk is written to the
+ * interface with the publisher's ID, any further chunk to an
+ * interface with the chunk index appended to the ID.
+ * @param chunk index of chunk within the batch
+ * @return batch interface to write the chunk to
+ */
+TransformBatchInterface *
+TransformPublisher::batch_interface(size_t chunk)
+{
+	while (tfbifs_.size() <= chunk) {
+		std::string id = bbid_;
+		if (!tfbifs_.empty()) {
+			id += "#" + std::to_string(tfbifs_.size());
+		}
+		TransformBatchInterface *tfbif = bb_->open_for_writing<TransformBatchInterface>(id.c_str());
+		tfbif->set_auto_timestamping(false);
+		tfbifs_.push_back(tfbif);
+	}
+	return tfbifs_[chunk];
+}
+
+/** Write a chunk of transforms to a batch interface.
+ * Must be called with the mutex held. The chunk must fit into the
+ * interface.
+ * @param tfbif batch interface to write to
+ * @param transforms transforms to publish
+ * @param first index of first transform to write
+ * @param last index after the last transform to write
+ * @param is_static true to mark transforms as static, false otherwise
+ */
+void
+TransformPublisher::write_batch(TransformBatchInterface *            tfbif,
+                                const std::vector<StampedTransform> &transforms,
+                                size_t                               first,
+                                size_t                               last,
+                                bool                                 is_static)
+{
+	std::string          frames, child_frames;
+	std::vector<int64_t> stamps(tfbif->maxlenof_stamps(), 0);
+	std::vector<double>  translations(tfbif->maxlenof_translations(), 0.);
+	std::vector<double>  rotations(tfbif->maxlenof_rotations(), 0.);
+
+	const Time *latest = &transforms[first].stamp;
+	for (size_t i = first; i < last; ++i) {
+		const StampedTransform &transform = transforms[i];
+		const size_t            n         = i - first;
+
+		frames += transform.frame_id + "\n";
+		child_frames += transform.child_frame_id + "\n";
+		stamps[n] = transform.stamp.in_usec();
+		if (transform.stamp > *latest)
+			latest = &transform.stamp;
+
+		const Vector3 &t        = transform.getOrigin();
+		translations[n * 3]     = t.x();
+		translations[n * 3 + 1] = t.y();
+		translations[n * 3 + 2] = t.z();
+		Quaternion r            = transform.getRotation();
+		assert_quaternion_valid(r);
+		rotations[n * 4]     = r.x();
+		rotations[n * 4 + 1] = r.y();
+		rotations[n * 4 + 2] = r.z();
+		rotations[n * 4 + 3] = r.w();
+	}
+
+	tfbif->set_timestamp(latest);
+	tfbif->set_num_transforms(last - first);
+	tfbif->set_static_transforms(is_static);
+	tfbif->set_frames(frames.c_str());
+	tfbif->set_child_frames(child_frames.c_str());
+	tfbif->set_stamps(&stamps[0]);
+	tfbif->set_translations(&translations[0]);
+	tfbif->set_rotations(&rotations[0]);
+	tfbif->write();
+}
+
 } // end namespace tf
 } // end namespace fawkes
@@ -55,10 +55,14 @@
 #include <tf/types.h>
 #include <utils/time/time.h>
 
+#include <string>
+#include <vector>
+
 namespace fawkes {
 
 class BlackBoard;
 class TransformInterface;
+class TransformBatchInterface;
 class Mutex;
 
 namespace tf {
@@ -81,10 +85,24 @@ public:
 		send_transform(StampedTransform(transform, time, frame, child_frame), is_static);
 	}
 
+	virtual void send_transforms(const std::vector<StampedTransform> &transforms,
+	                             const bool                           is_static = false);
+
+private:
+	TransformBatchInterface *batch_interface(size_t chunk);
+	void                     write_batch(TransformBatchInterface *            tfbif,
+	                                     const std::vector<StampedTransform> &transforms,
+	                                     size_t                               first,
+	                                     size_t                               last,
+	                                     bool                                 is_static);
+
 private:
-	BlackBoard *        bb_;
-	TransformInterface *tfif_;
-	Mutex *             mutex_;
+	BlackBoard *                           bb_;
+	std::string                            bbid_;
+	TransformInterface *                   tfif_;
+	std::vector<TransformBatchInterface *> tfbifs_;
+	size_t                                 num_chunks_written_;
+	Mutex *                                mutex_;
 };
 
 } // end namespace tf
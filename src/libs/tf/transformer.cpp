@@ -95,8 +95,10 @@ namespace tf {
 
 /** Constructor.
  * @param cache_time time in seconds to cache incoming transforms
+ * @param cache_type type of cache to use for non-static frames
  */
-Transformer::Transformer(float cache_time) : BufferCore(cache_time), enabled_(true)
+Transformer::Transformer(float cache_time, BufferCore::CacheType cache_type)
+: BufferCore(cache_time, cache_type), enabled_(true)
 {
 }
 
@@ -131,8 +133,8 @@ Transformer::get_cache_time() const
 }
 
 /** Lock transformer.
- * No new transforms can be added and no lookups can be performed
- * while the lock is held.
+ * No new transforms can be added while the lock is held. Lookups do
+ * not take the lock and may still be performed concurrently.
  */
 void
 Transformer::lock()
@@ -165,9 +167,9 @@ Transformer::unlock()
 bool
 Transformer::frame_exists(const std::string &frame_id_str) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
+	ReadSection section(this);
 
-	return (frameIDs_.count(frame_id_str) > 0);
+	return (frame_table()->ids.count(frame_id_str) > 0);
 }
 
 /** Get cache for specific frame.
@@ -177,6 +179,7 @@ Transformer::frame_exists(const std::string &frame_id_str) const
 TimeCacheInterfacePtr
 Transformer::get_frame_cache(const std::string &frame_id) const
 {
+	ReadSection section(this);
 	return get_frame(lookup_frame_number(frame_id));
 }
 
@@ -186,7 +189,8 @@ Transformer::get_frame_cache(const std::string &frame_id) const
 std::vector<TimeCacheInterfacePtr>
 Transformer::get_frame_caches() const
 {
-	return frames_;
+	ReadSection section(this);
+	return frame_table()->frames;
 }
 
 /** Get mappings from frame ID to names.
@@ -195,7 +199,8 @@ Transformer::get_frame_caches() const
 std::vector<std::string>
 Transformer::get_frame_id_mappings() const
 {
-	return frameIDs_reverse;
+	ReadSection section(this);
+	return frame_table()->names;
 }
 
 /** Test if a transform is possible.
@@ -627,6 +632,21 @@ Transformer::transform_pose(const std::string &  target_frame,
 	stamped_out.frame_id = target_frame;
 }
 
+/** Create handle for repeated lookups of the same pair of frames.
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @param tolerance_sec time in seconds within which a previous lookup
+ * result may be returned, cf. TransformHandle
+ * @return transform handle
+ */
+TransformHandle
+Transformer::create_handle(const std::string &target_frame,
+                           const std::string &source_frame,
+                           float              tolerance_sec) const
+{
+	return TransformHandle(this, target_frame, source_frame, tolerance_sec);
+}
+
 /** Get DOT graph of all frames.
  * @param print_time true to add the time of the transform as graph label
  * @param time if not NULL will be assigned the time of the graph generation
@@ -651,16 +671,17 @@ Transformer::all_frames_as_dot(bool print_time, fawkes::Time *time) const
 	}
 	mstream << "]; node [fontsize=12]; edge [fontsize=12]; " << std::endl;
 
-	TransformStorage temp;
+	TransformStorage  temp;
+	const FrameTable *table = frame_table();
 
-	if (frames_.size() == 1)
+	if (table->frames.size() == 1)
 		mstream << "\"no tf data received\"";
 
 	mstream.precision(3);
 	mstream.setf(std::ios::fixed, std::ios::floatfield);
 
 	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
-	for (unsigned int cnt = 1; cnt < frames_.size(); ++cnt) //one referenced for 0 is no frame
+	for (unsigned int cnt = 1; cnt < table->frames.size(); ++cnt) //one referenced for 0 is no frame
 	{
 		std::shared_ptr<TimeCacheInterface> cache = get_frame(cnt);
 		if (!cache)
@@ -683,9 +704,9 @@ Transformer::all_frames_as_dot(bool print_time, fawkes::Time *time) const
 			                          - cache->get_oldest_timestamp().in_sec()),
 			                         0.0001);
 
-			mstream << "\"" << frameIDs_reverse[frame_id_num] << "\""
+			mstream << "\"" << table->names[frame_id_num] << "\""
 			        << " -> "
-			        << "\"" << frameIDs_reverse[cnt] << "\""
+			        << "\"" << table->names[cnt] << "\""
 			        << "[label=\"";
 
 			std::shared_ptr<StaticCache> static_cache = std::dynamic_pointer_cast<StaticCache>(cache);
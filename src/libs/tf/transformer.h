@@ -53,6 +53,7 @@
 #define _LIBS_TF_TRANSFORMER_H_
 
 #include <tf/buffer_core.h>
+#include <tf/transform_handle.h>
 #include <tf/types.h>
 
 namespace fawkes {
@@ -64,7 +65,8 @@ typedef std::shared_ptr<TimeCacheInterface> TimeCacheInterfacePtr;
 class Transformer : public BufferCore
 {
 public:
-	Transformer(float cache_time_sec = BufferCore::DEFAULT_CACHE_TIME);
+	Transformer(float                 cache_time_sec = BufferCore::DEFAULT_CACHE_TIME,
+	            BufferCore::CacheType cache_type     = BufferCore::CACHE_RING);
 	virtual ~Transformer(void);
 
 	void set_enabled(bool enabled);
@@ -147,6 +149,10 @@ public:
 	                    const std::string &  fixed_frame,
 	                    Stamped<Pose> &      stamped_out) const;
 
+	TransformHandle create_handle(const std::string &target_frame,
+	                              const std::string &source_frame,
+	                              float              tolerance_sec = 0.) const;
+
 	std::string all_frames_as_dot(bool print_time, fawkes::Time *time = 0) const;
 
 private:
@@ -0,0 +1,241 @@
+
+/***************************************************************************
+ *  latency_histogram.cpp - Lock-free log-linear latency histogram
+ *
+ *  Created: Mon Oct 19 09:12:41 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/time/latency_histogram.h>
+
+#include <cmath>
+
+namespace fawkes {
+
+/** @class LatencyHistogram <utils/time/latency_histogram.h>
+ * Lock-free log-linear latency histogram.
+ * Records durations in microseconds with a bounded relative error in
+ * the style of an HDR histogram. Values below 2^SUB_BUCKET_BITS are
+ * counted exactly, larger values fall into one of 16 equally sized
+ * sub-buckets per power of two, i.e. with a relative error below 6.25%.
+ *
+ * Recording only uses atomic increments and is therefore safe to be
+ * called concurrently and from real-time critical code. Reading while
+ * values are recorded yields a consistent enough view for statistics,
+ * count() and the bucket counts may however differ by a few samples.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+/** Copy constructor.
+ * @param other histogram to copy
+ */
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other)
+{
+	*this = other;
+}
+
+/** Assignment operator.
+ * @param other histogram to copy
+ * @return reference to this instance
+ */
+LatencyHistogram &
+LatencyHistogram::operator=(const LatencyHistogram &other)
+{
+	if (this != &other) {
+		for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+			counts_[i] = __atomic_load_n(&other.counts_[i], __ATOMIC_RELAXED);
+		}
+		count_ = __atomic_load_n(&other.count_, __ATOMIC_RELAXED);
+		sum_   = __atomic_load_n(&other.sum_, __ATOMIC_RELAXED);
+		max_   = __atomic_load_n(&other.max_, __ATOMIC_RELAXED);
+	}
+	return *this;
+}
+
+/** Record a value.
+ * @param usec duration in microseconds
+ */
+void
+LatencyHistogram::record(uint64_t usec)
+{
+	__atomic_fetch_add(&counts_[bucket_index(usec)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&count_, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&sum_, usec, __ATOMIC_RELAXED);
+
+	uint64_t max = __atomic_load_n(&max_, __ATOMIC_RELAXED);
+	while (usec > max
+	       && !__atomic_compare_exchange_n(
+	         &max_, &max, usec, /* weak */ true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+/** Reset all counts. */
+void
+LatencyHistogram::reset()
+{
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		__atomic_store_n(&counts_[i], 0, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&count_, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&sum_, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&max_, 0, __ATOMIC_RELAXED);
+}
+
+/** Get number of recorded values.
+ * @return number of recorded values
+ */
+unsigned int
+LatencyHistogram::count() const
+{
+	return __atomic_load_n(&count_, __ATOMIC_RELAXED);
+}
+
+/** Get sum of all recorded values.
+ * @return sum of all recorded values in microseconds
+ */
+uint64_t
+LatencyHistogram::sum() const
+{
+	return __atomic_load_n(&sum_, __ATOMIC_RELAXED);
+}
+
+/** Get largest recorded value.
+ * @return largest recorded value in microseconds, 0 if none recorded
+ */
+uint64_t
+LatencyHistogram::max() const
+{
+	return __atomic_load_n(&max_, __ATOMIC_RELAXED);
+}
+
+/** Get mean of recorded values.
+ * @return mean of the recorded values in microseconds, 0 if none recorded
+ */
+float
+LatencyHistogram::mean() const
+{
+	unsigned int count = this->count();
+	return (count > 0) ? (float)sum() / count : 0.;
+}
+
+/** Get percentile of recorded values.
+ * The value is the upper bound of the bucket which contains the
+ * percentile, but never more than the largest recorded value.
+ * @param percentile percentile in the range [0, 100]
+ * @return value in microseconds below or equal to which the given
+ * percentage of recorded values lies, 0 if none recorded
+ */
+uint64_t
+LatencyHistogram::percentile(float percentile) const
+{
+	unsigned int count = 0;
+	unsigned int counts[NUM_BUCKETS];
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		counts[i] = __atomic_load_n(&counts_[i], __ATOMIC_RELAXED);
+		count += counts[i];
+	}
+	if (count == 0)
+		return 0;
+
+	if (percentile < 0.)
+		percentile = 0.;
+	if (percentile > 100.)
+		percentile = 100.;
+	unsigned int target = (unsigned int)ceilf(percentile / 100. * count);
+	if (target == 0)
+		target = 1;
+
+	uint64_t     max        = this->max();
+	unsigned int cumulative = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		cumulative += counts[i];
+		if (cumulative >= target) {
+			uint64_t upper = bucket_upper_bound(i);
+			return (upper < max) ? upper : max;
+		}
+	}
+	return max;
+}
+
+/** Count values above a limit.
+ * Values are compared on bucket granularity, i.e. values in the same
+ * bucket as the limit are not counted.
+ * @param usec limit in microseconds
+ * @return number of recorded values larger than the limit
+ */
+unsigned int
+LatencyHistogram::count_above(uint64_t usec) const
+{
+	unsigned int count = 0;
+	for (unsigned int i = bucket_index(usec) + 1; i < NUM_BUCKETS; ++i) {
+		count += __atomic_load_n(&counts_[i], __ATOMIC_RELAXED);
+	}
+	return count;
+}
+
+/** Get count of a single bucket.
+ * @param bucket bucket index, must be less than NUM_BUCKETS
+ * @return number of values recorded into the bucket
+ */
+unsigned int
+LatencyHistogram::bucket_count(unsigned int bucket) const
+{
+	return __atomic_load_n(&counts_[bucket], __ATOMIC_RELAXED);
+}
+
+/** Get the bucket for a value.
+ * Values larger than the range of the histogram are put into the last bucket.
+ * @param usec value in microseconds
+ * @return bucket index
+ */
+unsigned int
+LatencyHistogram::bucket_index(uint64_t usec)
+{
+	if (usec < (1u << SUB_BUCKET_BITS))
+		return usec;
+
+	// the leading SUB_BUCKET_BITS bits of the value select the bucket
+	unsigned int msb   = 63 - __builtin_clzll(usec);
+	unsigned int shift = msb - (SUB_BUCKET_BITS - 1);
+	unsigned int index = shift * (1u << (SUB_BUCKET_BITS - 1)) + (unsigned int)(usec >> shift);
+	return (index < NUM_BUCKETS) ? index : NUM_BUCKETS - 1;
+}
+
+/** Get the largest value of a bucket.
+ * @param bucket bucket index
+ * @return largest value in microseconds which is recorded into the bucket
+ */
+uint64_t
+LatencyHistogram::bucket_upper_bound(unsigned int bucket)
+{
+	const unsigned int half = 1u << (SUB_BUCKET_BITS - 1);
+	if (bucket < 2 * half)
+		return bucket;
+
+	unsigned int shift = bucket / half - 1;
+	uint64_t     sub   = half + bucket % half;
+	return ((sub + 1) << shift) - 1;
+}
+
+} // end namespace fawkes
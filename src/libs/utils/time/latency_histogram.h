@@ -0,0 +1,67 @@
+
+/***************************************************************************
+ *  latency_histogram.h - Lock-free log-linear latency histogram
+ *
+ *  Created: Mon Oct 19 09:12:41 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_LATENCY_HISTOGRAM_H_
+#define _UTILS_TIME_LATENCY_HISTOGRAM_H_
+
+#include <stdint.h>
+
+namespace fawkes {
+
+class LatencyHistogram
+{
+public:
+	/** Number of bits of a value which determine its sub-bucket. */
+	static const unsigned int SUB_BUCKET_BITS = 5;
+	/** Number of buckets, covers values up to 2^36 usec. */
+	static const unsigned int NUM_BUCKETS = 528;
+
+	LatencyHistogram();
+	LatencyHistogram(const LatencyHistogram &other);
+	LatencyHistogram &operator=(const LatencyHistogram &other);
+
+	void record(uint64_t usec);
+	void reset();
+
+	unsigned int count() const;
+	uint64_t     sum() const;
+	uint64_t     max() const;
+	float        mean() const;
+	uint64_t     percentile(float percentile) const;
+	unsigned int count_above(uint64_t usec) const;
+
+	unsigned int bucket_count(unsigned int bucket) const;
+
+	static unsigned int bucket_index(uint64_t usec);
+	static uint64_t     bucket_upper_bound(unsigned int bucket);
+
+private:
+	unsigned int counts_[NUM_BUCKETS];
+	unsigned int count_;
+	uint64_t     sum_;
+	uint64_t     max_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -160,7 +160,9 @@ BBLogFile::read_file_header()
 	uint32_t version;
 	if ((fread(&magic, sizeof(uint32_t), 1, f_) == 1)
 	    && (fread(&version, sizeof(uint32_t), 1, f_) == 1)) {
-		if ((ntohl(magic) == BBLOGGER_FILE_MAGIC) && (ntohl(version) == BBLOGGER_FILE_VERSION)) {
+		if ((ntohl(magic) == BBLOGGER_FILE_MAGIC)
+		    && ((ntohl(version) == BBLOGGER_FILE_VERSION)
+		        || (ntohl(version) == BBLOGGER_FILE_VERSION_LEGACY))) {
 			::rewind(f_);
 			if (fread(header_, sizeof(bblog_file_header), 1, f_) != 1) {
 				throw FileReadException(filename_, errno, "Failed to read file header");
@@ -169,8 +171,8 @@ BBLogFile::read_file_header()
 			throw Exception("File magic/version %X/%u does not match (expected %X/%u)",
 			                ntohl(magic),
 			                ntohl(version),
-			                BBLOGGER_FILE_VERSION,
-			                BBLOGGER_FILE_MAGIC);
+			                BBLOGGER_FILE_MAGIC,
+			                BBLOGGER_FILE_VERSION);
 		}
 	} else {
 		throw Exception(filename_, errno, "Failed to read magic/version from file");
@@ -219,12 +221,7 @@ BBLogFile::sanity_check()
 		throw e;
 	}
 
-#if BYTE_ORDER_ == LITTLE_ENDIAN_
-	if (header_->endianess == 1)
-#else
-	if (header_->endianess == 0)
-#endif
-	{
+	if (!host_endianess()) {
 		Exception e("File %s has incompatible endianess", filename_);
 		e.set_type_id("bblogfile-endianess-mismatch");
 		throw e;
@@ -344,12 +341,7 @@ BBLogFile::repair()
 	Exception success("Successfully repaired file");
 	success.set_type_id("repair-success");
 
-#if BYTE_ORDER_ == LITTLE_ENDIAN_
-	if (header_->endianess == 1)
-#else
-	if (header_->endianess == 0)
-#endif
-	{
+	if (!host_endianess()) {
 		throw Exception("File %s has incompatible endianess. Cannot repair.", filename_);
 	}
 
@@ -405,6 +397,25 @@ BBLogFile::repair()
 	}
 }
 
+/** Check if the file data is stored in the byte order of this host.
+ * Writers of file version 1 always set the endianess field to big endian.
+ * Such files are assumed to have been written by a host with the same
+ * byte order, there is no way to tell otherwise.
+ * @return true if the file data can be used without conversion
+ */
+bool
+BBLogFile::host_endianess() const
+{
+	if (ntohl(header_->file_version) == BBLOGGER_FILE_VERSION_LEGACY) {
+		return true;
+	}
+#if BYTE_ORDER == LITTLE_ENDIAN
+	return (header_->endianess == BBLOG_LITTLE_ENDIAN);
+#else
+	return (header_->endianess == BBLOG_BIG_ENDIAN);
+#endif
+}
+
 /** Print file meta info.
  * @param line_prefix a prefix printed before each line
  * @param outf file handle to print to
@@ -433,7 +444,7 @@ BBLogFile::print_info(const char *line_prefix, FILE *outf)
 	        "%sStart time: %s\n",
 	        line_prefix,
 	        ntohl(header_->file_version),
-	        (header_->endianess == 1) ? "Big" : "Little",
+	        is_big_endian() ? "Big" : "Little",
 	        line_prefix,
 	        header_->num_data_items,
 	        header_->data_size,
@@ -531,7 +542,15 @@ BBLogFile::file_version() const
 bool
 BBLogFile::is_big_endian() const
 {
-	return (header_->endianess == 1);
+	if (ntohl(header_->file_version) == BBLOGGER_FILE_VERSION_LEGACY) {
+		// legacy writers did not set the endianess field, see host_endianess()
+#if BYTE_ORDER == BIG_ENDIAN
+		return true;
+#else
+		return false;
+#endif
+	}
+	return (header_->endianess == BBLOG_BIG_ENDIAN);
 }
 
 /** Get number of data items in file.
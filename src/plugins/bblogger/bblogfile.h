@@ -96,6 +96,7 @@ private: // methods
 	void read_file_header();
 	void sanity_check();
 	void repair();
+	bool host_endianess() const;
 
 private: // members
 	FILE *             f_;
@@ -23,6 +23,7 @@
 #include "bblogger_plugin.h"
 
 #include "log_thread.h"
+#include "mlog_thread.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -32,13 +33,16 @@
 #include <cstring>
 #include <set>
 #include <unistd.h>
+#include <vector>
 
 using namespace fawkes;
 
 /** @class BlackBoardLoggerPlugin "bblogger_plugin.h"
  * BlackBoard logger plugin.
  * This plugin logs one or more (or even all) interfaces to data files
- * for later replay or analyzing.
+ * for later replay or analyzing. In the "single" format, one thread and
+ * one file is used per interface. In the "multi" format, a single thread
+ * writes all interfaces to a single chunked and optionally compressed file.
  *
  * @author Tim Niemueller
  */
@@ -71,13 +75,31 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 	std::string scenario_prefix = prefix + scenario + "/";
 	std::string ifaces_prefix   = scenario_prefix + "interfaces/";
 
-	std::string logdir    = LOGDIR;
-	bool        buffering = true;
-	bool        flushing  = false;
+	std::string  logdir     = LOGDIR;
+	std::string  format     = "single";
+	bool         buffering  = true;
+	bool         flushing   = false;
+	unsigned int chunk_size = 65536;
+	bool         compress   = true;
 	try {
 		logdir = config->get_string((scenario_prefix + "logdir").c_str());
 	} catch (Exception &e) { /* ignored, use default set above */
 	}
+	try {
+		format = config->get_string((scenario_prefix + "format").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	if ((format != "single") && (format != "multi")) {
+		throw Exception("Invalid log format '%s', must be single or multi", format.c_str());
+	}
+	try {
+		chunk_size = config->get_uint((scenario_prefix + "chunk_size").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	try {
+		compress = config->get_bool((scenario_prefix + "compress").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
 	try {
 		buffering = config->get_bool((scenario_prefix + "buffering").c_str());
 	} catch (Exception &e) { /* ignored, use default set above */
@@ -110,11 +132,18 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 	strftime(date, 21, "%F-%H-%M-%S", tmp);
 	std::string replay_cfg_prefix = replay_prefix + scenario + "-" + date + "/logs/";
 
+	std::vector<std::string> uids;
+
 	Configuration::ValueIterator *i = config->search(ifaces_prefix.c_str());
 	while (i->next()) {
 		std::string iface_name = std::string(i->path()).substr(ifaces_prefix.length());
 		iface_name             = iface_name.substr(0, iface_name.find("/"));
 
+		if (format == "multi") {
+			uids.push_back(i->get_string());
+			continue;
+		}
+
 		//printf("Adding sync thread for peer %s\n", peer.c_str());
 		BBLoggerThread *log_thread = new BBLoggerThread(
 		  i->get_string().c_str(), logdir.c_str(), buffering, flushing, scenario.c_str(), &start);
@@ -126,6 +155,23 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 	}
 	delete i;
 
+	if (format == "multi") {
+		if (uids.empty()) {
+			throw Exception("No interfaces configured for logging, aborting");
+		}
+
+		std::string filename = scenario + "-" + date + ".bbmlog";
+		thread_list.push_back(new BBMultiLoggerThread(uids,
+		                                              (logdir + "/" + filename).c_str(),
+		                                              chunk_size,
+		                                              compress,
+		                                              flushing,
+		                                              scenario.c_str(),
+		                                              &start));
+		config->set_string((replay_cfg_prefix + scenario + "/file").c_str(), filename);
+		return;
+	}
+
 	if (thread_list.empty()) {
 		throw Exception("No interfaces configured for logging, aborting");
 	}
@@ -23,8 +23,10 @@
 
 #include "bblogreplay_plugin.h"
 
+#include "bbmlogfile.h"
 #include "logreplay_bt_thread.h"
 #include "logreplay_thread.h"
+#include "mlogreplay_thread.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -125,6 +127,7 @@ BlackBoardLogReplayPlugin::BlackBoardLogReplayPlugin(Configuration *config) : Pl
 			bool        loop_replay  = scenario_loop_replay;
 			bool        non_blocking = scenario_non_blocking;
 			float       grace_period = scenario_grace_period;
+			float       start_offset = 0.;
 			std::string hook_str;
 
 			try {
@@ -143,8 +146,21 @@ BlackBoardLogReplayPlugin::BlackBoardLogReplayPlugin(Configuration *config) : Pl
 				grace_period = config->get_float((log_prefix + "grace_period").c_str());
 			} catch (Exception &e) {
 			} // ignored, assume enabled
+			try {
+				start_offset = config->get_float((log_prefix + "start_offset").c_str());
+			} catch (Exception &e) {
+			} // ignored, start at beginning
+
+			std::string path = logdir + "/" + i->get_string();
+			if (BBMultiLogFile::is_multi_log(path.c_str())) {
+				if (hook_str != "") {
+					throw Exception("Multi-interface log %s cannot be replayed in a hook",
+					                i->get_string().c_str());
+				}
+				thread_list.push_back(new BBMultiLogReplayThread(
+				  i->get_string().c_str(), logdir.c_str(), grace_period, loop_replay, start_offset));
 
-			if (hook_str != "") {
+			} else if (hook_str != "") {
 				BlockedTimingAspect::WakeupHook hook;
 				hook = BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP;
 
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *  bbmlogconvert.cpp - Convert single-interface logs to a multi-interface log
+ *
+ *  Created: Sun Oct 18 19:14:03 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "bbmlogconvert.h"
+
+#include "bblogfile.h"
+#include "bbmlogwriter.h"
+
+#include <interface/interface.h>
+#include <utils/time/time.h>
+
+#include <stdint.h>
+
+using namespace fawkes;
+
+/** Merge single-interface logs into a multi-interface log.
+ * The interfaces of all files are added to the writer and the entries of
+ * all files are appended in order of time. The writer is not closed.
+ * @param files files to merge, the read position of each file must be at
+ * its first entry
+ * @param start_time start time of the writer, entry offsets of all files
+ * are made relative to this time. It must not be later than the start time
+ * of any of the files.
+ * @param writer writer to append the entries to
+ */
+void
+bbmlog_merge(const std::vector<std::shared_ptr<BBLogFile>> &files,
+             const Time &                                   start_time,
+             BBMultiLogWriter &                             writer)
+{
+	std::vector<uint64_t> start_diff_usec(files.size());
+	std::vector<uint64_t> next_usec(files.size());
+	std::vector<bool>     has_next(files.size());
+	for (size_t i = 0; i < files.size(); ++i) {
+		writer.add_interface(files[i]->interface());
+		Time diff          = files[i]->start_time() - start_time;
+		start_diff_usec[i] = (uint64_t)diff.get_sec() * 1000000 + diff.get_usec();
+		has_next[i]        = files[i]->has_next();
+		if (has_next[i]) {
+			files[i]->read_next();
+			const Time &o = files[i]->entry_offset();
+			next_usec[i]  = start_diff_usec[i] + (uint64_t)o.get_sec() * 1000000 + o.get_usec();
+		}
+	}
+
+	while (true) {
+		size_t next = files.size();
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (has_next[i] && ((next == files.size()) || (next_usec[i] < next_usec[next]))) {
+				next = i;
+			}
+		}
+		if (next == files.size())
+			break;
+
+		if (writer.append(next, next_usec[next], files[next]->interface()->datachunk())) {
+			writer.write_pending();
+		}
+
+		has_next[next] = files[next]->has_next();
+		if (has_next[next]) {
+			files[next]->read_next();
+			const Time &o   = files[next]->entry_offset();
+			next_usec[next] = start_diff_usec[next] + (uint64_t)o.get_sec() * 1000000 + o.get_usec();
+		}
+	}
+}
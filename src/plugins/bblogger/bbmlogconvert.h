@@ -0,0 +1,39 @@
+/***************************************************************************
+ *  bbmlogconvert.h - Convert single-interface logs to a multi-interface log
+ *
+ *  Created: Sun Oct 18 19:12:40 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_BBMLOGCONVERT_H_
+#define _PLUGINS_BBLOGGER_BBMLOGCONVERT_H_
+
+#include <memory>
+#include <vector>
+
+namespace fawkes {
+class Time;
+}
+
+class BBLogFile;
+class BBMultiLogWriter;
+
+void bbmlog_merge(const std::vector<std::shared_ptr<BBLogFile>> &files,
+                  const fawkes::Time &                           start_time,
+                  BBMultiLogWriter &                             writer);
+
+#endif
@@ -0,0 +1,797 @@
+/***************************************************************************
+ *  bbmlogfile.cpp - BlackBoard multi-interface log file access class
+ *
+ *  Created: Tue Oct 20 11:52:16 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "bbmlogfile.h"
+
+#include <blackboard/internal/instance_factory.h>
+#include <core/exceptions/software.h>
+#include <core/exceptions/system.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#ifdef __FreeBSD__
+#	include <sys/endian.h>
+#elif defined(__MACH__) && defined(__APPLE__)
+#	include <sys/_endian.h>
+#else
+#	include <endian.h>
+#endif
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef HAVE_ZLIB
+#	include <zlib.h>
+#endif
+#include <unistd.h>
+
+using namespace fawkes;
+
+/// @cond INTERNALS
+static void
+pread_all(int fd, void *buf, size_t size, uint64_t offset, const char *filename)
+{
+	char *b = (char *)buf;
+	while (size > 0) {
+		ssize_t bytes_read = pread(fd, b, size, offset);
+		if (bytes_read == -1) {
+			if (errno == EINTR)
+				continue;
+			throw FileReadException(filename, errno);
+		} else if (bytes_read == 0) {
+			throw FileReadException(filename, "Unexpected end of file");
+		}
+		b += bytes_read;
+		size -= bytes_read;
+		offset += bytes_read;
+	}
+}
+/// @endcond
+
+/** @class BBMultiLogFile "bbmlogfile.h"
+ * Class to access bblogger multi-interface log files.
+ * A multi-interface log contains the data of several interfaces in chunks.
+ * On opening, the interface declarations and the chunk index are read. If
+ * the file has not been closed properly, e.g. because it is still being
+ * written or the logger crashed, the index is reconstructed by scanning the
+ * chunk headers. The index allows to jump to an entry or a point in time by
+ * reading a single chunk.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * Opens the given file and reads the interface declarations and the index.
+ * @param filename log file to open
+ * @exception CouldNotOpenFileException thrown if file cannot be opened
+ * @exception FileReadException some error occured while reading data from
+ * the file
+ * @exception Exception thrown if the file is not a multi-interface log or
+ * has an incompatible endianess
+ */
+BBMultiLogFile::BBMultiLogFile(const char *filename)
+{
+	fd_ = open(filename, O_RDONLY);
+	if (fd_ == -1) {
+		throw CouldNotOpenFileException(filename, errno);
+	}
+	filename_ = filename;
+
+	try {
+		read_file_header();
+		read_blocks();
+		if (has_index_) {
+			try {
+				read_index_block();
+			} catch (Exception &e) {
+				// index is broken, e.g. because the file was truncated, scan instead
+				has_index_ = false;
+				interfaces_.clear();
+				read_blocks();
+			}
+		}
+	} catch (Exception &e) {
+		close(fd_);
+		throw;
+	}
+
+	ifaces_.resize(interfaces_.size(), NULL);
+	own_ifaces_.resize(interfaces_.size(), false);
+
+	rewind();
+}
+
+/** Destructor. */
+BBMultiLogFile::~BBMultiLogFile()
+{
+	for (size_t i = 0; i < ifaces_.size(); ++i) {
+		if (own_ifaces_[i])
+			instance_factory_->delete_interface_instance(ifaces_[i]);
+	}
+	close(fd_);
+}
+
+/** Check if a file is a multi-interface log.
+ * @param filename file to check
+ * @return true if the file starts with the multi-interface log magic,
+ * false otherwise or if the file cannot be read
+ */
+bool
+BBMultiLogFile::is_multi_log(const char *filename)
+{
+	int fd = open(filename, O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	uint32_t magic;
+	bool     rv = (read(fd, &magic, sizeof(magic)) == sizeof(magic))
+	          && (ntohl(magic) == BBLOGGER_MFILE_MAGIC);
+	close(fd);
+	return rv;
+}
+
+/** Read file header. */
+void
+BBMultiLogFile::read_file_header()
+{
+	pread_all(fd_, &header_, sizeof(header_), 0, filename_.c_str());
+
+	if ((ntohl(header_.file_magic) != BBLOGGER_MFILE_MAGIC)
+	    || (ntohl(header_.file_version) != BBLOGGER_MFILE_VERSION)) {
+		throw Exception("File magic/version %X/%u does not match (expected %X/%u)",
+		                ntohl(header_.file_magic),
+		                ntohl(header_.file_version),
+		                BBLOGGER_MFILE_MAGIC,
+		                BBLOGGER_MFILE_VERSION);
+	}
+
+#if BYTE_ORDER == LITTLE_ENDIAN
+	if (header_.endianess == 1)
+#else
+	if (header_.endianess == 0)
+#endif
+	{
+		Exception e("File %s has incompatible endianess", filename_.c_str());
+		e.set_type_id("bblogfile-endianess-mismatch");
+		throw e;
+	}
+
+	has_index_ = (header_.index_offset != 0);
+	start_time_.set_time(header_.start_time_sec, header_.start_time_usec);
+}
+
+/** Read blocks following the header.
+ * Reads all interface declarations. If the file has no index, the chunk
+ * index is reconstructed from the chunk headers. Reading stops at the first
+ * incomplete block, e.g. one which is just being written.
+ */
+void
+BBMultiLogFile::read_blocks()
+{
+	struct stat fs;
+	if (fstat(fd_, &fs) != 0) {
+		throw Exception(errno, "Failed to stat file %s", filename_.c_str());
+	}
+
+	num_data_items_ = 0;
+	uint64_t offset = sizeof(bblog_mfile_header);
+	while (offset + sizeof(bblog_block_header) <= (uint64_t)fs.st_size) {
+		bblog_block_header bh;
+		pread_all(fd_, &bh, sizeof(bh), offset, filename_.c_str());
+		if ((bh.block_magic != BBLOGGER_BLOCK_MAGIC)
+		    || (offset + sizeof(bh) + bh.size > (uint64_t)fs.st_size)) {
+			break;
+		}
+
+		if (bh.block_type == BBLOG_BLOCK_INTERFACE) {
+			bblog_interface_info info;
+			if (bh.size != sizeof(info)) {
+				throw Exception("Invalid interface block in %s", filename_.c_str());
+			}
+			pread_all(fd_, &info, sizeof(info), offset + sizeof(bh), filename_.c_str());
+			if (info.interface_index != interfaces_.size()) {
+				throw Exception("Unexpected interface index %u in %s (expected %zu)",
+				                info.interface_index,
+				                filename_.c_str(),
+				                interfaces_.size());
+			}
+			info.interface_type[BBLOG_INTERFACE_TYPE_SIZE - 1] = 0;
+			info.interface_id[BBLOG_INTERFACE_ID_SIZE - 1]     = 0;
+			interfaces_.push_back(info);
+
+		} else if (bh.block_type == BBLOG_BLOCK_CHUNK) {
+			// with an index we only need the interface declarations
+			if (has_index_)
+				break;
+
+			bblog_index_entry ie;
+			ie.block_offset      = offset;
+			ie.first_offset_usec = bh.first_offset_usec;
+			ie.last_offset_usec  = bh.last_offset_usec;
+			ie.num_entries       = bh.num_entries;
+			ie.reserved          = 0;
+			index_.push_back(ie);
+			num_data_items_ += bh.num_entries;
+
+		} else {
+			break;
+		}
+
+		offset += sizeof(bh) + bh.size;
+	}
+
+	data_end_ = offset;
+}
+
+/** Read the index block. */
+void
+BBMultiLogFile::read_index_block()
+{
+	bblog_block_header bh;
+	pread_all(fd_, &bh, sizeof(bh), header_.index_offset, filename_.c_str());
+	if ((bh.block_magic != BBLOGGER_BLOCK_MAGIC) || (bh.block_type != BBLOG_BLOCK_INDEX)
+	    || (bh.size != bh.num_entries * sizeof(bblog_index_entry))) {
+		throw Exception("Invalid index block in %s, try to repair the file", filename_.c_str());
+	}
+
+	index_.resize(bh.num_entries);
+	if (bh.num_entries > 0) {
+		pread_all(fd_, &index_[0], bh.size, header_.index_offset + sizeof(bh), filename_.c_str());
+	}
+
+	num_data_items_ = 0;
+	for (const bblog_index_entry &ie : index_) {
+		num_data_items_ += ie.num_entries;
+	}
+	data_end_ = header_.index_offset;
+}
+
+/** Read and decompress a chunk.
+ * Positions the read cursor at the first entry of the chunk.
+ * @param chunk index of the chunk to read
+ */
+void
+BBMultiLogFile::read_chunk(size_t chunk)
+{
+	const bblog_index_entry &ie = index_[chunk];
+
+	bblog_block_header bh;
+	pread_all(fd_, &bh, sizeof(bh), ie.block_offset, filename_.c_str());
+	if ((bh.block_magic != BBLOGGER_BLOCK_MAGIC) || (bh.block_type != BBLOG_BLOCK_CHUNK)) {
+		throw Exception("Invalid chunk %zu in %s", chunk, filename_.c_str());
+	}
+
+	stored_.resize(bh.size);
+	pread_all(fd_, &stored_[0], bh.size, ie.block_offset + sizeof(bh), filename_.c_str());
+
+	if (bh.compression == BBLOG_COMPRESSION_NONE) {
+		chunk_.swap(stored_);
+	} else if (bh.compression == BBLOG_COMPRESSION_DEFLATE) {
+#ifdef HAVE_ZLIB
+		chunk_.resize(bh.raw_size);
+		uLongf raw_size = bh.raw_size;
+		if ((uncompress((Bytef *)&chunk_[0], &raw_size, (const Bytef *)&stored_[0], bh.size) != Z_OK)
+		    || (raw_size != bh.raw_size)) {
+			throw Exception("Failed to decompress chunk %zu in %s", chunk, filename_.c_str());
+		}
+#else
+		throw Exception("Chunk %zu in %s is compressed, but zlib is not available",
+		                chunk,
+		                filename_.c_str());
+#endif
+	} else {
+		throw Exception("Unknown compression %u of chunk %zu in %s",
+		                bh.compression,
+		                chunk,
+		                filename_.c_str());
+	}
+
+	chunk_index_ = chunk + 1;
+	chunk_pos_   = 0;
+}
+
+/** Check if another entry is available.
+ * @return true if a consecutive read_next() will succeed, false otherwise
+ */
+bool
+BBMultiLogFile::has_next()
+{
+	return (chunk_pos_ < chunk_.size()) || (chunk_index_ < index_.size());
+}
+
+/** Read next entry.
+ * The data is stored in the interface of the entry.
+ * @return index of the interface the entry belongs to
+ * @exception Exception thrown if reading fails, for example because no more
+ * entries are left.
+ */
+unsigned int
+BBMultiLogFile::read_next()
+{
+	if (chunk_pos_ >= chunk_.size()) {
+		if (chunk_index_ >= index_.size()) {
+			throw Exception("No more entries in %s", filename_.c_str());
+		}
+		read_chunk(chunk_index_);
+	}
+
+	bblog_mentry_header ehead;
+	if (chunk_pos_ + sizeof(ehead) > chunk_.size()) {
+		throw Exception("Truncated entry in chunk %zu of %s", chunk_index_ - 1, filename_.c_str());
+	}
+	memcpy(&ehead, &chunk_[chunk_pos_], sizeof(ehead));
+	check_interface_index(ehead.interface_index);
+	size_t data_size = interfaces_[ehead.interface_index].data_size;
+	if (chunk_pos_ + sizeof(ehead) + data_size > chunk_.size()) {
+		throw Exception("Truncated entry in chunk %zu of %s", chunk_index_ - 1, filename_.c_str());
+	}
+
+	interface(ehead.interface_index)->set_from_chunk(&chunk_[chunk_pos_ + sizeof(ehead)]);
+	entry_offset_.set_time(ehead.rel_time_usec / 1000000, ehead.rel_time_usec % 1000000);
+	entry_interface_ = ehead.interface_index;
+
+	chunk_pos_ += sizeof(ehead) + data_size;
+	return entry_interface_;
+}
+
+/** Read entry at particular index.
+ * Only the chunk containing the entry is read.
+ * @param index index of entry, 0-based
+ */
+void
+BBMultiLogFile::read_index(uint64_t index)
+{
+	uint64_t first = 0;
+	for (size_t c = 0; c < index_.size(); ++c) {
+		if (index < first + index_[c].num_entries) {
+			read_chunk(c);
+			for (uint64_t i = first; i < index; ++i) {
+				bblog_mentry_header ehead;
+				memcpy(&ehead, &chunk_[chunk_pos_], sizeof(ehead));
+				check_interface_index(ehead.interface_index);
+				chunk_pos_ += sizeof(ehead) + interfaces_[ehead.interface_index].data_size;
+			}
+			read_next();
+			return;
+		}
+		first += index_[c].num_entries;
+	}
+	throw OutOfBoundsException("Invalid entry index", index, 0, num_data_items_);
+}
+
+/** Seek to a point in time.
+ * The read cursor is positioned before the first entry recorded at or
+ * after the given offset. The index is used to find the chunk, so only
+ * that single chunk is read.
+ * @param offset offset from start time to seek to
+ */
+void
+BBMultiLogFile::seek(const fawkes::Time &offset)
+{
+	uint64_t usec = (offset.in_usec() > 0) ? offset.in_usec() : 0;
+
+	std::vector<bblog_index_entry>::iterator c =
+	  std::lower_bound(index_.begin(),
+	                   index_.end(),
+	                   usec,
+	                   [](const bblog_index_entry &ie, uint64_t usec) {
+		                   return ie.last_offset_usec < usec;
+	                   });
+
+	if (c == index_.end()) {
+		chunk_.clear();
+		chunk_pos_   = 0;
+		chunk_index_ = index_.size();
+		return;
+	}
+
+	read_chunk(c - index_.begin());
+	while (chunk_pos_ + sizeof(bblog_mentry_header) <= chunk_.size()) {
+		bblog_mentry_header ehead;
+		memcpy(&ehead, &chunk_[chunk_pos_], sizeof(ehead));
+		if (ehead.rel_time_usec >= usec)
+			break;
+		check_interface_index(ehead.interface_index);
+		chunk_pos_ += sizeof(ehead) + interfaces_[ehead.interface_index].data_size;
+	}
+}
+
+/** Rewind file to start.
+ * This moves the read cursor immediately before the first entry.
+ */
+void
+BBMultiLogFile::rewind()
+{
+	chunk_.clear();
+	chunk_pos_       = 0;
+	chunk_index_     = 0;
+	entry_interface_ = 0;
+	entry_offset_.set_time(0, 0);
+}
+
+/** Get current entry offset.
+ * @return offset from start time of current entry (may be 0 if no entry has
+ * been read, yet, or after rewind()).
+ */
+const fawkes::Time &
+BBMultiLogFile::entry_offset() const
+{
+	return entry_offset_;
+}
+
+/** Get interface of current entry.
+ * @return index of the interface of the last entry read
+ */
+unsigned int
+BBMultiLogFile::entry_interface() const
+{
+	return entry_interface_;
+}
+
+/** Check an interface index.
+ * @param index interface index to check
+ * @exception OutOfBoundsException thrown if the index is invalid
+ */
+void
+BBMultiLogFile::check_interface_index(unsigned int index) const
+{
+	if (index >= interfaces_.size()) {
+		throw OutOfBoundsException("Invalid interface index", index, 0, interfaces_.size());
+	}
+}
+
+/** Get interface instance.
+ * If no interface has been set for the given index, an instance is created
+ * that is not tied to a blackboard.
+ * @param index interface index
+ * @return interface which receives the data of entries of the given index
+ */
+fawkes::Interface *
+BBMultiLogFile::interface(unsigned int index)
+{
+	check_interface_index(index);
+	if (!ifaces_[index]) {
+		if (!instance_factory_)
+			instance_factory_.reset(new BlackBoardInstanceFactory());
+		ifaces_[index] = instance_factory_->new_interface_instance(interfaces_[index].interface_type,
+		                                                           interfaces_[index].interface_id);
+		own_ifaces_[index] = true;
+	}
+	return ifaces_[index];
+}
+
+/** Set an interface.
+ * @param index interface index
+ * @param interface an interface matching the type, ID, and hash of the
+ * interface with the given index in the log file
+ * @exception TypeMismatchException thrown if the interface does not match
+ */
+void
+BBMultiLogFile::set_interface(unsigned int index, fawkes::Interface *interface)
+{
+	check_interface_index(index);
+	const bblog_interface_info &info = interfaces_[index];
+	if ((strcmp(interface->type(), info.interface_type) == 0)
+	    && (strcmp(interface->id(), info.interface_id) == 0)
+	    && (memcmp(interface->hash(), info.interface_hash, INTERFACE_HASH_SIZE_) == 0)) {
+		if (own_ifaces_[index]) {
+			instance_factory_->delete_interface_instance(ifaces_[index]);
+			own_ifaces_[index] = false;
+		}
+		ifaces_[index] = interface;
+	} else {
+		throw TypeMismatchException("Interfaces incompatible");
+	}
+}
+
+/** Repair file.
+ * @param filename file to repair
+ * @see repair()
+ */
+void
+BBMultiLogFile::repair_file(const char *filename)
+{
+	BBMultiLogFile file(filename);
+	file.repair();
+}
+
+/** Repair a file which has not been closed properly.
+ * Incomplete blocks at the end of the file are removed and the index is
+ * written from the scanned chunk headers.
+ * On success, an exception is thrown with a type_id of "repair-success", which
+ * will have an entry for each successful operation.
+ */
+void
+BBMultiLogFile::repair()
+{
+	if (has_index_)
+		return;
+
+	int fd = open(filename_.c_str(), O_RDWR);
+	if (fd == -1) {
+		throw CouldNotOpenFileException(filename_.c_str(), errno, "Reopening for repair failed");
+	}
+
+	Exception success("Successfully repaired file");
+	success.set_type_id("repair-success");
+
+	struct stat fs;
+	if (fstat(fd, &fs) != 0) {
+		close(fd);
+		throw Exception(errno, "Failed to stat file %s", filename_.c_str());
+	}
+	if ((uint64_t)fs.st_size > data_end_) {
+		success.append("FIXING: incomplete block at end of file, truncating by %zu b",
+		               (size_t)(fs.st_size - data_end_));
+		if (ftruncate(fd, data_end_) == -1) {
+			close(fd);
+			throw Exception(errno, "Failed to truncate file %s", filename_.c_str());
+		}
+	}
+
+	bblog_block_header bh;
+	memset(&bh, 0, sizeof(bh));
+	bh.block_magic = BBLOGGER_BLOCK_MAGIC;
+	bh.block_type  = BBLOG_BLOCK_INDEX;
+	bh.size        = index_.size() * sizeof(bblog_index_entry);
+	bh.raw_size    = bh.size;
+	bh.num_entries = index_.size();
+	if (!index_.empty()) {
+		bh.first_offset_usec = index_.front().first_offset_usec;
+		bh.last_offset_usec  = index_.back().last_offset_usec;
+	}
+
+	header_.num_interfaces = interfaces_.size();
+	header_.num_data_items = num_data_items_;
+	header_.index_offset   = data_end_;
+
+	if ((pwrite(fd, &bh, sizeof(bh), data_end_) != sizeof(bh))
+	    || (!index_.empty()
+	        && (pwrite(fd, &index_[0], bh.size, data_end_ + sizeof(bh)) != (ssize_t)bh.size))
+	    || (pwrite(fd, &header_, sizeof(header_), 0) != sizeof(header_))) {
+		close(fd);
+		throw FileWriteException(filename_.c_str(), errno, "Failed to write index");
+	}
+	close(fd);
+	has_index_ = true;
+
+	success.append("FIXING: wrote index of %zu chunks with %lu data items",
+	               index_.size(),
+	               (unsigned long)num_data_items_);
+	throw success;
+}
+
+/** Print file meta info.
+ * @param line_prefix a prefix printed before each line
+ * @param outf file handle to print to
+ */
+void
+BBMultiLogFile::print_info(const char *line_prefix, FILE *outf)
+{
+	struct stat fs;
+	if (fstat(fd_, &fs) != 0) {
+		throw Exception(errno, "Failed to get stat file");
+	}
+
+	uint64_t stored_size = 0, raw_size = 0;
+	for (const bblog_index_entry &ie : index_) {
+		bblog_block_header bh;
+		pread_all(fd_, &bh, sizeof(bh), ie.block_offset, filename_.c_str());
+		stored_size += bh.size;
+		raw_size += bh.raw_size;
+	}
+
+	fprintf(outf,
+	        "%sFile version: %-10u  Endianess: %s Endian\n"
+	        "%s# data items: %-10lu  # chunks: %zu (%s)\n"
+	        "%sData size:    %lu bytes, %lu bytes stored   File size: %li bytes\n"
+	        "%s\n"
+	        "%sScenario:   %s\n"
+	        "%sStart time: %s\n"
+	        "%sDuration:   %f sec\n"
+	        "%s\n"
+	        "%sInterfaces:\n",
+	        line_prefix,
+	        ntohl(header_.file_version),
+	        (header_.endianess == 1) ? "Big" : "Little",
+	        line_prefix,
+	        (unsigned long)num_data_items_,
+	        index_.size(),
+	        has_index_ ? "indexed" : "not indexed",
+	        line_prefix,
+	        (unsigned long)raw_size,
+	        (unsigned long)stored_size,
+	        (long int)fs.st_size,
+	        line_prefix,
+	        line_prefix,
+	        header_.scenario,
+	        line_prefix,
+	        start_time_.str(),
+	        line_prefix,
+	        duration().in_sec(),
+	        line_prefix,
+	        line_prefix);
+
+	for (const bblog_interface_info &info : interfaces_) {
+		char interface_hash[BBLOG_INTERFACE_HASH_SIZE * 2 + 1];
+		for (unsigned int i = 0; i < BBLOG_INTERFACE_HASH_SIZE; ++i) {
+			snprintf(&interface_hash[i * 2], 3, "%02X", info.interface_hash[i]);
+		}
+		fprintf(outf,
+		        "%s  %3u: %s::%s (%s, %u bytes)\n",
+		        line_prefix,
+		        info.interface_index,
+		        info.interface_type,
+		        info.interface_id,
+		        interface_hash,
+		        info.data_size);
+	}
+}
+
+/** Print an entry.
+ * Verbose print of the last entry read.
+ * @param outf file handle to print to
+ */
+void
+BBMultiLogFile::print_entry(FILE *outf)
+{
+	Interface *iface = interface(entry_interface_);
+	fprintf(outf, "Time Offset: %f  Interface: %s\n", entry_offset_.in_sec(), iface->uid());
+
+	InterfaceFieldIterator i;
+	for (i = iface->fields(); i != iface->fields_end(); ++i) {
+		char *typesize;
+		if (i.get_length() > 1) {
+			if (asprintf(&typesize, "%s[%zu]", i.get_typename(), i.get_length()) == -1) {
+				throw Exception("Out of memory");
+			}
+		} else {
+			if (asprintf(&typesize, "%s", i.get_typename()) == -1) {
+				throw Exception("Out of memory");
+			}
+		}
+		fprintf(outf, "%-16s %-18s: %s\n", i.get_name(), typesize, i.get_value_string());
+		free(typesize);
+	}
+}
+
+/** Get file version.
+ * @return file version
+ */
+uint32_t
+BBMultiLogFile::file_version() const
+{
+	return ntohl(header_.file_version);
+}
+
+/** Get number of data items in file.
+ * @return number of data items in all chunks
+ */
+uint64_t
+BBMultiLogFile::num_data_items() const
+{
+	return num_data_items_;
+}
+
+/** Get number of chunks in file.
+ * @return number of chunks
+ */
+size_t
+BBMultiLogFile::num_chunks() const
+{
+	return index_.size();
+}
+
+/** Check if the file has an index.
+ * Files without an index have not been closed properly. They can be
+ * read nevertheless, but must be scanned on opening.
+ * @return true if the file has an index, false otherwise
+ */
+bool
+BBMultiLogFile::has_index() const
+{
+	return has_index_;
+}
+
+/** Get scenario identifier.
+ * @return scenario identifier
+ */
+const char *
+BBMultiLogFile::scenario() const
+{
+	return header_.scenario;
+}
+
+/** Get start time.
+ * @return starting time of log
+ */
+fawkes::Time &
+BBMultiLogFile::start_time()
+{
+	return start_time_;
+}
+
+/** Get duration of log.
+ * @return offset of the last entry from the start time
+ */
+fawkes::Time
+BBMultiLogFile::duration() const
+{
+	Time d((long)0);
+	if (!index_.empty()) {
+		d.set_time(index_.back().last_offset_usec / 1000000, index_.back().last_offset_usec % 1000000);
+	}
+	return d;
+}
+
+/** Get number of interfaces.
+ * @return number of interfaces in the log
+ */
+unsigned int
+BBMultiLogFile::num_interfaces() const
+{
+	return interfaces_.size();
+}
+
+/** Get interface type.
+ * @param index interface index
+ * @return type of logged interface
+ */
+const char *
+BBMultiLogFile::interface_type(unsigned int index) const
+{
+	check_interface_index(index);
+	return interfaces_[index].interface_type;
+}
+
+/** Get interface ID.
+ * @param index interface index
+ * @return ID of logged interface
+ */
+const char *
+BBMultiLogFile::interface_id(unsigned int index) const
+{
+	check_interface_index(index);
+	return interfaces_[index].interface_id;
+}
+
+/** Get interface hash.
+ * @param index interface index
+ * @return hash of logged interface
+ */
+const unsigned char *
+BBMultiLogFile::interface_hash(unsigned int index) const
+{
+	check_interface_index(index);
+	return interfaces_[index].interface_hash;
+}
+
+/** Get data size.
+ * @param index interface index
+ * @return size of the data part of entries of the interface
+ */
+uint32_t
+BBMultiLogFile::data_size(unsigned int index) const
+{
+	check_interface_index(index);
+	return interfaces_[index].data_size;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *  bbmlogfile.h - BlackBoard multi-interface log file access class
+ *
+ *  Created: Tue Oct 20 11:37:52 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_BBMLOGFILE_H_
+#define _PLUGINS_BBLOGGER_BBMLOGFILE_H_
+
+#include "file.h"
+
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Interface;
+class BlackBoardInstanceFactory;
+} // namespace fawkes
+
+class BBMultiLogFile
+{
+public:
+	BBMultiLogFile(const char *filename);
+	~BBMultiLogFile();
+
+	static bool is_multi_log(const char *filename);
+	static void repair_file(const char *filename);
+
+	bool         has_next();
+	unsigned int read_next();
+	void         read_index(uint64_t index);
+	void         seek(const fawkes::Time &offset);
+	void         rewind();
+
+	const fawkes::Time &entry_offset() const;
+	unsigned int        entry_interface() const;
+	void                print_entry(FILE *outf = stdout);
+	void                print_info(const char *line_prefix = "", FILE *outf = stdout);
+
+	// Header information
+	uint32_t      file_version() const;
+	uint64_t      num_data_items() const;
+	size_t        num_chunks() const;
+	bool          has_index() const;
+	const char *  scenario() const;
+	fawkes::Time &start_time();
+	fawkes::Time  duration() const;
+
+	// Interface information
+	unsigned int         num_interfaces() const;
+	const char *         interface_type(unsigned int index) const;
+	const char *         interface_id(unsigned int index) const;
+	const unsigned char *interface_hash(unsigned int index) const;
+	uint32_t             data_size(unsigned int index) const;
+
+	fawkes::Interface *interface(unsigned int index);
+	void               set_interface(unsigned int index, fawkes::Interface *interface);
+
+private: // methods
+	void read_file_header();
+	void read_blocks();
+	void read_index_block();
+	void read_chunk(size_t chunk);
+	void check_interface_index(unsigned int index) const;
+	void repair();
+
+private: // members
+	int                fd_;
+	std::string        filename_;
+	bblog_mfile_header header_;
+	bool               has_index_;
+	uint64_t           data_end_;
+	uint64_t           num_data_items_;
+
+	std::vector<bblog_interface_info> interfaces_;
+	std::vector<bblog_index_entry>    index_;
+
+	std::vector<fawkes::Interface *>                   ifaces_;
+	std::vector<bool>                                  own_ifaces_;
+	std::unique_ptr<fawkes::BlackBoardInstanceFactory> instance_factory_;
+
+	std::vector<char> chunk_;
+	std::vector<char> stored_;
+	size_t            chunk_index_;
+	size_t            chunk_pos_;
+
+	fawkes::Time start_time_;
+	fawkes::Time entry_offset_;
+	unsigned int entry_interface_;
+};
+
+#endif
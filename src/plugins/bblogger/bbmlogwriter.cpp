@@ -0,0 +1,539 @@
+/***************************************************************************
+ *  bbmlogwriter.cpp - BlackBoard multi-interface log file writer
+ *
+ *  Created: Tue Oct 20 10:21:07 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "bbmlogwriter.h"
+
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <interface/interface.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#ifdef __FreeBSD__
+#	include <sys/endian.h>
+#elif defined(__MACH__) && defined(__APPLE__)
+#	include <sys/_endian.h>
+#else
+#	include <endian.h>
+#endif
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#ifdef HAVE_ZLIB
+#	include <zlib.h>
+#endif
+#include <unistd.h>
+
+using namespace fawkes;
+
+/** @class BBMultiLogWriter "bbmlogwriter.h"
+ * Writer for multi-interface BlackBoard log files.
+ * All data is appended to a single file in chunks. Entries are collected
+ * in memory by append() until a chunk reaches the configured size. Then the
+ * chunk is sealed and written by the next call to write_pending(), which
+ * compresses all sealed chunks (if enabled and zlib is available) and
+ * writes them with a single writev() call. On close() an index of all
+ * chunks is appended which allows readers to seek to a point in time
+ * without scanning the file.
+ *
+ * append() and seal() may be called from any thread and only copy data.
+ * The methods which write to the file, i.e. write_pending(), flush(), and
+ * close() are meant to be called from a single writer thread.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param filename name of the file to create, the file may not exist
+ * @param scenario ID of the log scenario
+ * @param start_time time to use as start time for the log, entry offsets
+ * are relative to this time
+ * @param chunk_size size in bytes after which a chunk is sealed
+ * @param compress true to compress chunks, ignored if zlib is not available
+ * @exception CouldNotOpenFileException thrown if the file cannot be created
+ * @exception FileWriteException thrown if the header cannot be written
+ */
+BBMultiLogWriter::BBMultiLogWriter(const char * filename,
+                                   const char * scenario,
+                                   const Time & start_time,
+                                   size_t       chunk_size,
+                                   bool         compress)
+{
+	mode_t m = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+	fd_      = open(filename, O_WRONLY | O_CREAT | O_EXCL, m);
+	if (fd_ == -1) {
+		throw CouldNotOpenFileException(filename, errno, "Failed to create multi log");
+	}
+
+	filename_       = strdup(filename);
+	chunk_size_     = chunk_size;
+	compress_       = compress;
+	file_offset_    = 0;
+	chunk_mutex_    = new Mutex();
+	write_mutex_    = new Mutex();
+	current_        = NULL;
+	chunks_started_ = false;
+
+	memset(&header_, 0, sizeof(header_));
+	header_.file_magic   = htonl(BBLOGGER_MFILE_MAGIC);
+	header_.file_version = htonl(BBLOGGER_MFILE_VERSION);
+#if BYTE_ORDER == BIG_ENDIAN
+	header_.endianess = BBLOG_BIG_ENDIAN;
+#else
+	header_.endianess = BBLOG_LITTLE_ENDIAN;
+#endif
+	strncpy(header_.scenario, scenario, BBLOG_SCENARIO_SIZE - 1);
+	long start_time_sec, start_time_usec;
+	start_time.get_timestamp(start_time_sec, start_time_usec);
+	header_.start_time_sec  = start_time_sec;
+	header_.start_time_usec = start_time_usec;
+
+	struct iovec iov;
+	iov.iov_base = &header_;
+	iov.iov_len  = sizeof(header_);
+	try {
+		write_iovec(&iov, 1);
+	} catch (Exception &e) {
+		::close(fd_);
+		free(filename_);
+		delete chunk_mutex_;
+		delete write_mutex_;
+		throw;
+	}
+}
+
+/** Destructor.
+ * Closes the file if that has not been done, yet.
+ */
+BBMultiLogWriter::~BBMultiLogWriter()
+{
+	if (fd_ != -1) {
+		try {
+			close();
+		} catch (Exception &e) {
+		} // ignored, nothing we can do about it here
+	}
+
+	delete current_;
+	for (Chunk *c : sealed_)
+		delete c;
+	for (Chunk *c : free_)
+		delete c;
+
+	free(filename_);
+	delete chunk_mutex_;
+	delete write_mutex_;
+}
+
+/** Add an interface to the log.
+ * All interfaces must be added before the first entry is appended.
+ * @param type interface type
+ * @param id interface ID
+ * @param hash interface hash, INTERFACE_HASH_SIZE_ bytes
+ * @param data_size size of the interface data chunk
+ * @return index of the interface to pass to append()
+ * @exception Exception thrown if entries have already been appended
+ */
+unsigned int
+BBMultiLogWriter::add_interface(const char *         type,
+                                const char *         id,
+                                const unsigned char *hash,
+                                size_t               data_size)
+{
+	MutexLocker lock(write_mutex_);
+	if (chunks_started_) {
+		throw Exception("Cannot add interface %s::%s to %s after logging started",
+		                type,
+		                id,
+		                filename_);
+	}
+
+	bblog_interface_info info;
+	memset(&info, 0, sizeof(info));
+	info.interface_index = interfaces_.size();
+	info.data_size       = data_size;
+	strncpy(info.interface_type, type, BBLOG_INTERFACE_TYPE_SIZE - 1);
+	strncpy(info.interface_id, id, BBLOG_INTERFACE_ID_SIZE - 1);
+	memcpy(info.interface_hash, hash, BBLOG_INTERFACE_HASH_SIZE);
+
+	bblog_block_header header;
+	memset(&header, 0, sizeof(header));
+	header.block_magic = BBLOGGER_BLOCK_MAGIC;
+	header.block_type  = BBLOG_BLOCK_INTERFACE;
+	header.compression = BBLOG_COMPRESSION_NONE;
+	header.size        = sizeof(info);
+	header.raw_size    = sizeof(info);
+	header.num_entries = 1;
+	write_block(header, &info);
+
+	interfaces_.push_back(info);
+	header_.num_interfaces = interfaces_.size();
+	return info.interface_index;
+}
+
+/** Add an interface to the log.
+ * @param interface interface to add, only its meta data is used
+ * @return index of the interface to pass to append()
+ * @exception Exception thrown if entries have already been appended
+ */
+unsigned int
+BBMultiLogWriter::add_interface(Interface *interface)
+{
+	return add_interface(interface->type(),
+	                     interface->id(),
+	                     interface->hash(),
+	                     interface->datasize());
+}
+
+/** Get a chunk to fill.
+ * Must be called with the chunk mutex locked.
+ * @return empty chunk, re-used if possible
+ */
+BBMultiLogWriter::Chunk *
+BBMultiLogWriter::get_chunk()
+{
+	Chunk *chunk;
+	if (!free_.empty()) {
+		chunk = free_.front();
+		free_.pop_front();
+	} else {
+		chunk = new Chunk();
+		chunk->data.reserve(chunk_size_ + 1024);
+	}
+	chunk->data.clear();
+	memset(&chunk->header, 0, sizeof(chunk->header));
+	chunk->header.block_magic = BBLOGGER_BLOCK_MAGIC;
+	chunk->header.block_type  = BBLOG_BLOCK_CHUNK;
+	return chunk;
+}
+
+/** Append an entry.
+ * The data is copied into the current chunk. If the chunk has reached
+ * the configured chunk size it is sealed.
+ * @param interface_index index of the interface as returned by add_interface()
+ * @param rel_time_usec time since start time of the log in microseconds
+ * @param data interface data chunk
+ * @return true if a chunk has been sealed and write_pending() should be
+ * called, false otherwise
+ */
+bool
+BBMultiLogWriter::append(unsigned int interface_index, uint64_t rel_time_usec, const void *data)
+{
+	if (interface_index >= interfaces_.size()) {
+		throw Exception("Invalid interface index %u for %s", interface_index, filename_);
+	}
+	chunks_started_ = true;
+
+	bblog_mentry_header ehead;
+	ehead.rel_time_usec   = rel_time_usec;
+	ehead.interface_index = interface_index;
+	size_t data_size      = interfaces_[interface_index].data_size;
+
+	MutexLocker lock(chunk_mutex_);
+	if (!current_)
+		current_ = get_chunk();
+
+	bblog_block_header &h = current_->header;
+	if (h.num_entries == 0) {
+		h.first_offset_usec = rel_time_usec;
+		h.last_offset_usec  = rel_time_usec;
+	} else {
+		// data changes of different interfaces may race for the chunk
+		if (rel_time_usec < h.first_offset_usec)
+			h.first_offset_usec = rel_time_usec;
+		if (rel_time_usec > h.last_offset_usec)
+			h.last_offset_usec = rel_time_usec;
+	}
+	h.num_entries += 1;
+
+	std::vector<char> &d = current_->data;
+	d.insert(d.end(), (const char *)&ehead, (const char *)&ehead + sizeof(ehead));
+	d.insert(d.end(), (const char *)data, (const char *)data + data_size);
+
+	if (d.size() >= chunk_size_) {
+		sealed_.push_back(current_);
+		current_ = NULL;
+		return true;
+	}
+	return false;
+}
+
+/** Seal the current chunk.
+ * The chunk is written on the next call to write_pending(). Nothing
+ * happens if the current chunk is empty.
+ */
+void
+BBMultiLogWriter::seal()
+{
+	MutexLocker lock(chunk_mutex_);
+	if (current_ && current_->header.num_entries > 0) {
+		sealed_.push_back(current_);
+		current_ = NULL;
+	}
+}
+
+/** Write all sealed chunks. */
+void
+BBMultiLogWriter::write_pending()
+{
+	MutexLocker wlock(write_mutex_);
+
+	std::list<Chunk *> chunks;
+	chunk_mutex_->lock();
+	chunks.swap(sealed_);
+	chunk_mutex_->unlock();
+
+	if (chunks.empty())
+		return;
+
+	try {
+		write_chunks(chunks);
+	} catch (Exception &) {
+		MutexLocker lock(chunk_mutex_);
+		free_.splice(free_.end(), chunks);
+		throw;
+	}
+
+	MutexLocker lock(chunk_mutex_);
+	free_.splice(free_.end(), chunks);
+}
+
+/** Compress a chunk.
+ * Sets the header's size and compression fields. The data is stored
+ * uncompressed if compression is disabled, not available, or does not
+ * reduce the size.
+ * @param chunk chunk to compress
+ */
+void
+BBMultiLogWriter::compress_chunk(Chunk *chunk)
+{
+	chunk->header.raw_size    = chunk->data.size();
+	chunk->header.size        = chunk->data.size();
+	chunk->header.compression = BBLOG_COMPRESSION_NONE;
+
+#ifdef HAVE_ZLIB
+	if (compress_) {
+		uLongf compressed_size = compressBound(chunk->data.size());
+		chunk->compressed.resize(compressed_size);
+		if ((compress2((Bytef *)&chunk->compressed[0],
+		               &compressed_size,
+		               (const Bytef *)&chunk->data[0],
+		               chunk->data.size(),
+		               Z_BEST_SPEED)
+		     == Z_OK)
+		    && (compressed_size < chunk->data.size())) {
+			chunk->header.size        = compressed_size;
+			chunk->header.compression = BBLOG_COMPRESSION_DEFLATE;
+		}
+	}
+#endif
+}
+
+/** Write chunks to file.
+ * Must be called with the write mutex locked.
+ * @param chunks chunks to write
+ */
+void
+BBMultiLogWriter::write_chunks(std::list<Chunk *> &chunks)
+{
+	std::vector<struct iovec> iov;
+	iov.reserve(chunks.size() * 2);
+
+	uint64_t num_data_items = 0;
+	uint64_t offset         = file_offset_;
+	size_t   first_index    = index_.size();
+	for (Chunk *c : chunks) {
+		compress_chunk(c);
+
+		bblog_index_entry ie;
+		ie.block_offset      = offset;
+		ie.first_offset_usec = c->header.first_offset_usec;
+		ie.last_offset_usec  = c->header.last_offset_usec;
+		ie.num_entries       = c->header.num_entries;
+		ie.reserved          = 0;
+		index_.push_back(ie);
+
+		struct iovec hiov, piov;
+		hiov.iov_base = &c->header;
+		hiov.iov_len  = sizeof(bblog_block_header);
+		piov.iov_base = (c->header.compression == BBLOG_COMPRESSION_NONE) ? &c->data[0]
+		                                                                 : &c->compressed[0];
+		piov.iov_len  = c->header.size;
+		iov.push_back(hiov);
+		iov.push_back(piov);
+
+		offset += sizeof(bblog_block_header) + c->header.size;
+		num_data_items += c->header.num_entries;
+	}
+
+	try {
+		for (size_t i = 0; i < iov.size(); i += IOV_MAX) {
+			write_iovec(&iov[i], std::min(iov.size() - i, (size_t)IOV_MAX));
+		}
+	} catch (Exception &e) {
+		index_.resize(first_index);
+		throw;
+	}
+
+	header_.num_data_items += num_data_items;
+}
+
+/** Write a single block.
+ * Must be called with the write mutex locked.
+ * @param header block header
+ * @param payload block payload of header.size bytes
+ */
+void
+BBMultiLogWriter::write_block(bblog_block_header &header, const void *payload)
+{
+	struct iovec iov[2];
+	iov[0].iov_base = &header;
+	iov[0].iov_len  = sizeof(header);
+	iov[1].iov_base = const_cast<void *>(payload);
+	iov[1].iov_len  = header.size;
+	write_iovec(iov, 2);
+}
+
+/** Write data to the file.
+ * Partial writes are continued until all data has been written. The
+ * file offset is advanced accordingly.
+ * @param iov I/O vector, modified on partial writes
+ * @param iovcnt number of elements in iov
+ */
+void
+BBMultiLogWriter::write_iovec(struct iovec *iov, int iovcnt)
+{
+	while (iovcnt > 0) {
+		ssize_t written = writev(fd_, iov, iovcnt);
+		if (written == -1) {
+			if (errno == EINTR)
+				continue;
+			throw FileWriteException(filename_, errno, "Failed to write multi log");
+		}
+		file_offset_ += written;
+		while ((iovcnt > 0) && ((size_t)written >= iov->iov_len)) {
+			written -= iov->iov_len;
+			++iov;
+			--iovcnt;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + written;
+			iov->iov_len -= written;
+		}
+	}
+}
+
+/** Write the updated header.
+ * Must be called with the write mutex locked.
+ */
+void
+BBMultiLogWriter::update_header()
+{
+	if (pwrite(fd_, &header_, sizeof(header_), 0) != sizeof(header_)) {
+		throw FileWriteException(filename_, errno, "Failed to update multi log header");
+	}
+}
+
+/** Write all data.
+ * Seals the current chunk, writes all sealed chunks, and updates the
+ * number of data items in the header.
+ */
+void
+BBMultiLogWriter::flush()
+{
+	seal();
+	write_pending();
+	MutexLocker lock(write_mutex_);
+	update_header();
+}
+
+/** Close the file.
+ * Writes all data, appends the chunk index, and finalizes the header.
+ */
+void
+BBMultiLogWriter::close()
+{
+	if (fd_ == -1)
+		return;
+
+	flush();
+
+	MutexLocker lock(write_mutex_);
+
+	bblog_block_header header;
+	memset(&header, 0, sizeof(header));
+	header.block_magic = BBLOGGER_BLOCK_MAGIC;
+	header.block_type  = BBLOG_BLOCK_INDEX;
+	header.compression = BBLOG_COMPRESSION_NONE;
+	header.size        = index_.size() * sizeof(bblog_index_entry);
+	header.raw_size    = header.size;
+	header.num_entries = index_.size();
+	if (!index_.empty()) {
+		header.first_offset_usec = index_.front().first_offset_usec;
+		header.last_offset_usec  = index_.back().last_offset_usec;
+	}
+
+	uint64_t index_offset = file_offset_;
+	try {
+		write_block(header, index_.empty() ? NULL : &index_[0]);
+		header_.index_offset = index_offset;
+		update_header();
+	} catch (Exception &e) {
+		::close(fd_);
+		fd_ = -1;
+		throw;
+	}
+
+	::close(fd_);
+	fd_ = -1;
+}
+
+/** Get file name.
+ * @return name of the file written to
+ */
+const char *
+BBMultiLogWriter::filename() const
+{
+	return filename_;
+}
+
+/** Get number of written data items.
+ * @return number of data items written to the file so far
+ */
+uint64_t
+BBMultiLogWriter::num_data_items() const
+{
+	return header_.num_data_items;
+}
+
+/** Get number of written chunks.
+ * @return number of chunks written to the file so far
+ */
+size_t
+BBMultiLogWriter::num_chunks() const
+{
+	return index_.size();
+}
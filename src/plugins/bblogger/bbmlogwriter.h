@@ -0,0 +1,99 @@
+/***************************************************************************
+ *  bbmlogwriter.h - BlackBoard multi-interface log file writer
+ *
+ *  Created: Tue Oct 20 10:14:32 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_BBMLOGWRITER_H_
+#define _PLUGINS_BBLOGGER_BBMLOGWRITER_H_
+
+#include "file.h"
+
+#include <list>
+#include <stdint.h>
+#include <vector>
+
+namespace fawkes {
+class Interface;
+class Mutex;
+class Time;
+} // namespace fawkes
+
+class BBMultiLogWriter
+{
+public:
+	BBMultiLogWriter(const char *        filename,
+	                 const char *        scenario,
+	                 const fawkes::Time &start_time,
+	                 size_t              chunk_size = 65536,
+	                 bool                compress   = true);
+	~BBMultiLogWriter();
+
+	unsigned int add_interface(const char *         type,
+	                           const char *         id,
+	                           const unsigned char *hash,
+	                           size_t               data_size);
+	unsigned int add_interface(fawkes::Interface *interface);
+
+	bool append(unsigned int interface_index, uint64_t rel_time_usec, const void *data);
+	void seal();
+	void write_pending();
+	void flush();
+	void close();
+
+	const char *filename() const;
+	uint64_t    num_data_items() const;
+	size_t      num_chunks() const;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		bblog_block_header header;
+		std::vector<char>  data;
+		std::vector<char>  compressed;
+	} Chunk;
+	/// @endcond
+
+	Chunk *get_chunk();
+	void   compress_chunk(Chunk *chunk);
+	void   write_chunks(std::list<Chunk *> &chunks);
+	void   write_block(bblog_block_header &header, const void *payload);
+	void   write_iovec(struct iovec *iov, int iovcnt);
+	void   update_header();
+
+private:
+	int                fd_;
+	char *             filename_;
+	bblog_mfile_header header_;
+	size_t             chunk_size_;
+	bool               compress_;
+	uint64_t           file_offset_;
+
+	std::vector<bblog_interface_info> interfaces_;
+	std::vector<bblog_index_entry>    index_;
+
+	fawkes::Mutex *    chunk_mutex_;
+	fawkes::Mutex *    write_mutex_;
+	Chunk *            current_;
+	std::list<Chunk *> sealed_;
+	std::list<Chunk *> free_;
+	bool               chunks_started_;
+};
+
+#endif
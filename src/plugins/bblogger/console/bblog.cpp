@@ -21,6 +21,9 @@
  */
 
 #include "../bblogfile.h"
+#include "../bbmlogconvert.h"
+#include "../bbmlogfile.h"
+#include "../bbmlogwriter.h"
 
 #include <arpa/inet.h>
 #include <blackboard/internal/instance_factory.h>
@@ -38,7 +41,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <unistd.h>
+#include <vector>
 
 using namespace fawkes;
 
@@ -47,7 +52,7 @@ print_usage(const char *program_name)
 {
 	printf("Usage: %s [-h] [-r host:port] <COMMAND> <logfile>\n"
 	       "       %s print <logfile> <index> [index ...]\n"
-	       "       %s convert <infile> <outfile> <format>\n"
+	       "       %s convert <infile> <outfile> <format> [infile ...]\n"
 	       "\n"
 	       " -h  Print this usage information\n"
 	       "COMMANDS:\n"
@@ -63,7 +68,9 @@ print_usage(const char *program_name)
 	       "           <infile>  input log file\n"
 	       "           <outfile> converted output file\n"
 	       "           <format>  format to convert to, currently supported:\n"
-	       "             - csv  Comma-separated values\n",
+	       "             - csv     Comma-separated values\n"
+	       "             - bbmlog  Multi-interface log, any number of log files\n"
+	       "                       of the same run can be given as input\n",
 	       program_name,
 	       program_name,
 	       program_name);
@@ -73,8 +80,13 @@ int
 print_info(std::string &filename)
 {
 	try {
-		BBLogFile bf(filename.c_str());
-		bf.print_info();
+		if (BBMultiLogFile::is_multi_log(filename.c_str())) {
+			BBMultiLogFile bf(filename.c_str());
+			bf.print_info();
+		} else {
+			BBLogFile bf(filename.c_str());
+			bf.print_info();
+		}
 		return 0;
 	} catch (Exception &e) {
 		printf("Failed to print info, exception follows\n");
@@ -87,7 +99,11 @@ int
 repair_file(std::string &filename)
 {
 	try {
-		BBLogFile::repair_file(filename.c_str());
+		if (BBMultiLogFile::is_multi_log(filename.c_str())) {
+			BBMultiLogFile::repair_file(filename.c_str());
+		} else {
+			BBLogFile::repair_file(filename.c_str());
+		}
 		printf("Nothing to repair, files are fine\n");
 		return 0;
 	} catch (Exception &e) {
@@ -107,10 +123,18 @@ int
 print_indexes(std::string &filename, std::vector<unsigned int> &indexes)
 {
 	try {
-		BBLogFile bf(filename.c_str());
-		for (unsigned int i = 0; i < indexes.size(); ++i) {
-			bf.read_index(indexes[i]);
-			bf.print_entry();
+		if (BBMultiLogFile::is_multi_log(filename.c_str())) {
+			BBMultiLogFile bf(filename.c_str());
+			for (unsigned int i = 0; i < indexes.size(); ++i) {
+				bf.read_index(indexes[i]);
+				bf.print_entry();
+			}
+		} else {
+			BBLogFile bf(filename.c_str());
+			for (unsigned int i = 0; i < indexes.size(); ++i) {
+				bf.read_index(indexes[i]);
+				bf.print_entry();
+			}
 		}
 		return 0;
 	} catch (Exception &e) {
@@ -122,11 +146,11 @@ print_indexes(std::string &filename, std::vector<unsigned int> &indexes)
 	return 0;
 }
 
+template <class LogFile>
 int
-replay_file(std::string &filename)
+replay_file(LogFile &bf)
 {
 	try {
-		BBLogFile bf(filename.c_str());
 
 		Time last_offset((long)0);
 
@@ -158,6 +182,25 @@ replay_file(std::string &filename)
 
 	return 0;
 }
+
+int
+replay_file(std::string &filename)
+{
+	try {
+		if (BBMultiLogFile::is_multi_log(filename.c_str())) {
+			BBMultiLogFile bf(filename.c_str());
+			return replay_file(bf);
+		} else {
+			BBLogFile bf(filename.c_str());
+			return replay_file(bf);
+		}
+	} catch (Exception &e) {
+		printf("Failed to open log file, exception follows\n");
+		e.print_trace();
+		return -1;
+	}
+}
+
 /// @cond INTERNAL
 
 class BBLogWatcher : public FamListener, public SignalHandler
@@ -218,6 +261,11 @@ private:
 int
 watch_file(std::string &filename)
 {
+	if (BBMultiLogFile::is_multi_log(filename.c_str())) {
+		printf("Watching multi-interface log files is not supported\n");
+		return -1;
+	}
+
 	BBLogFile file(filename.c_str(), NULL, false);
 	if (file.remaining_entries() > 0) {
 		// jump to end of file
@@ -279,6 +327,37 @@ convert_file_csv(BBLogFile &bf, FILE *outf)
 	}
 }
 
+int
+convert_file_bbmlog(std::vector<std::string> &infiles, std::string &outfile)
+{
+	try {
+		std::vector<std::shared_ptr<BBLogFile>> files;
+		Time                                    start_time;
+		for (const std::string &f : infiles) {
+			std::shared_ptr<BBLogFile> bf(new BBLogFile(f.c_str()));
+			if (files.empty() || (bf->start_time() < start_time)) {
+				start_time = bf->start_time();
+			}
+			files.push_back(bf);
+		}
+
+		BBMultiLogWriter writer(outfile.c_str(), files[0]->scenario(), start_time);
+		bbmlog_merge(files, start_time, writer);
+		writer.close();
+		printf("Converted %zu files with %lu entries into %zu chunks\n",
+		       files.size(),
+		       (unsigned long)writer.num_data_items(),
+		       writer.num_chunks());
+
+	} catch (Exception &e) {
+		printf("Failed to convert log file: %s\n", e.what());
+		e.print_trace();
+		return 4;
+	}
+
+	return 0;
+}
+
 int
 convert_file(std::string &infile, std::string &outfile, std::string &format)
 {
@@ -382,13 +461,25 @@ main(int argc, char **argv)
 		return rv;
 
 	} else if (command == "convert") {
-		if (argp.num_items() != 4) {
+		if (argp.num_items() < 4) {
 			printf("Invalid number of arguments\n");
 			print_usage(argv[0]);
 			exit(7);
 		}
 		std::string outfile = argp.items()[2];
 		std::string format  = argp.items()[3];
+		if (format == "bbmlog") {
+			std::vector<std::string> infiles;
+			infiles.push_back(file);
+			for (size_t i = 4; i < argp.num_items(); ++i) {
+				infiles.push_back(argp.items()[i]);
+			}
+			return convert_file_bbmlog(infiles, outfile);
+		} else if (argp.num_items() != 4) {
+			printf("Invalid number of arguments\n");
+			print_usage(argv[0]);
+			exit(7);
+		}
 		return convert_file(file, outfile, format);
 
 	} else {
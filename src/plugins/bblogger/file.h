@@ -28,7 +28,8 @@
 #include <stdint.h>
 
 #define BBLOGGER_FILE_MAGIC 0xffbbffbb
-#define BBLOGGER_FILE_VERSION 1
+#define BBLOGGER_FILE_VERSION 2
+#define BBLOGGER_FILE_VERSION_LEGACY 1
 
 #pragma pack(push, 4)
 
@@ -48,6 +49,9 @@
  * The file_version is stored in network byte order. Anything beyond this is
  * stored in the native system format, read the endianess field to check whether
  * you must do data conversion.
+ * Writers of version 1 (BBLOGGER_FILE_VERSION_LEGACY) always set the endianess
+ * field to big endian, the data of such files is in the byte order of the host
+ * that wrote the file.
  */
 typedef struct
 {
@@ -78,6 +82,95 @@ typedef struct
 	uint32_t rel_time_usec; /**< time since start time, microseconds */
 } bblog_entry_header;
 
+#define BBLOGGER_MFILE_MAGIC 0xffbbffbd
+#define BBLOGGER_MFILE_VERSION 1
+#define BBLOGGER_BLOCK_MAGIC 0xbb10c4bb
+
+/** BBLogger multi-interface file header definition.
+ * A multi-interface log stores the data of any number of interfaces in a
+ * single append-only file. The header is followed by blocks, each starting
+ * with a bblog_block_header. All interface blocks precede the first chunk
+ * block, the index block (if any) is the last block of the file.
+ * The file_version is stored in network byte order. Anything beyond this is
+ * stored in the native system format, read the endianess field to check whether
+ * you must do data conversion.
+ */
+typedef struct
+{
+	uint32_t file_magic;                    /**< Magic value to identify file,
+				 * must be 0xFFBBFFBD (big endian) */
+	uint32_t file_version;                  /**< File version, set to BBLOGGER_MFILE_VERSION on
+				 * write and verify on read (big endian) */
+	uint32_t endianess : 1;                 /**< Endianess, 0 little endian, 1 big endian */
+	uint32_t reserved : 31;                 /**< Reserved for future use */
+	uint32_t num_interfaces;                /**< Number of interface blocks */
+	uint64_t num_data_items;                /**< Number of data items in all chunks */
+	uint64_t index_offset;                  /**< File offset of the index block, zero if
+				 * the index has not been written, yet */
+	char     scenario[BBLOG_SCENARIO_SIZE]; /**< Scenario as defined in config */
+	uint64_t start_time_sec;                /**< Start time, timestamp seconds */
+	uint64_t start_time_usec;               /**< Start time, timestamp microseconds */
+} bblog_mfile_header;
+
+/** Block type of a multi-interface log block. */
+typedef enum {
+	BBLOG_BLOCK_INTERFACE = 1, /**< interface declaration, payload is a bblog_interface_info */
+	BBLOG_BLOCK_CHUNK     = 2, /**< data chunk, payload is a sequence of
+	                            *   bblog_mentry_header and data, possibly compressed */
+	BBLOG_BLOCK_INDEX     = 3  /**< chunk index, payload is an array of bblog_index_entry */
+} bblog_block_type;
+
+/** Compression of a chunk block payload. */
+typedef enum {
+	BBLOG_COMPRESSION_NONE    = 0, /**< payload is stored uncompressed */
+	BBLOG_COMPRESSION_DEFLATE = 1  /**< payload is compressed with zlib */
+} bblog_compression;
+
+/** BBLogger multi-interface block header.
+ * This header is written before every block.
+ */
+typedef struct
+{
+	uint32_t block_magic;       /**< Magic value, must be BBLOGGER_BLOCK_MAGIC */
+	uint16_t block_type;        /**< Type of block, one of bblog_block_type */
+	uint16_t compression;       /**< Compression of payload, one of bblog_compression */
+	uint32_t size;              /**< Size of the stored payload following the header */
+	uint32_t raw_size;          /**< Size of the uncompressed payload */
+	uint32_t num_entries;       /**< Number of entries in the payload */
+	uint32_t reserved;          /**< Reserved for future use */
+	uint64_t first_offset_usec; /**< Time since start time of the first entry, usec */
+	uint64_t last_offset_usec;  /**< Time since start time of the last entry, usec */
+} bblog_block_header;
+
+/** Interface declaration in a multi-interface log. */
+typedef struct
+{
+	uint32_t      interface_index;                           /**< Index used in entries */
+	uint32_t      data_size;                                 /**< size of one data block */
+	char          interface_type[BBLOG_INTERFACE_TYPE_SIZE]; /**< Interface type */
+	char          interface_id[BBLOG_INTERFACE_ID_SIZE];     /**< Interface ID */
+	unsigned char interface_hash[BBLOG_INTERFACE_HASH_SIZE]; /**< Interface Hash */
+} bblog_interface_info;
+
+/** Entry header in a multi-interface log chunk.
+ * This header is written before every data block within a chunk.
+ */
+typedef struct
+{
+	uint64_t rel_time_usec;   /**< time since start time, microseconds */
+	uint32_t interface_index; /**< index of the interface the data belongs to */
+} bblog_mentry_header;
+
+/** Index entry of a multi-interface log, one per chunk block. */
+typedef struct
+{
+	uint64_t block_offset;      /**< File offset of the chunk block header */
+	uint64_t first_offset_usec; /**< Time since start time of the first entry, usec */
+	uint64_t last_offset_usec;  /**< Time since start time of the last entry, usec */
+	uint32_t num_entries;       /**< Number of entries in the chunk */
+	uint32_t reserved;          /**< Reserved for future use */
+} bblog_index_entry;
+
 #pragma pack(pop)
 
 #endif
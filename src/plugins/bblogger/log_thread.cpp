@@ -263,7 +263,7 @@ BBLoggerThread::write_header()
 	memset(&header, 0, sizeof(header));
 	header.file_magic   = htonl(BBLOGGER_FILE_MAGIC);
 	header.file_version = htonl(BBLOGGER_FILE_VERSION);
-#if BYTE_ORDER_ == BIG_ENDIAN_
+#if BYTE_ORDER == BIG_ENDIAN
 	header.endianess = BBLOG_BIG_ENDIAN;
 #else
 	header.endianess = BBLOG_LITTLE_ENDIAN;
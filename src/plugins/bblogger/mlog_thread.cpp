@@ -0,0 +1,253 @@
+/***************************************************************************
+ *  mlog_thread.cpp - BB Logger Thread for multi-interface logs
+ *
+ *  Created: Tue Oct 20 14:11:26 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "mlog_thread.h"
+
+#include "bbmlogwriter.h"
+
+#include <blackboard/blackboard.h>
+#include <interfaces/SwitchInterface.h>
+#include <logging/logger.h>
+#include <utils/time/time.h>
+
+using namespace fawkes;
+
+/** @class BBMultiLoggerThread "mlog_thread.h"
+ * BlackBoard logger thread for multi-interface logs.
+ * A single instance of this thread logs all configured interfaces into a
+ * single file. During the data changed event the interface data is only
+ * copied into the current chunk of the BBMultiLogWriter. Once a chunk is
+ * full the thread is woken up to compress and write it. This avoids one
+ * thread, one file, and many small writes per logged interface.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param iface_uids UIDs of interfaces to log
+ * @param filename name of the log file to create
+ * @param chunk_size size in bytes after which a chunk is written
+ * @param compress true to compress chunks
+ * @param flushing true to write each entry immediately, this produces
+ * chunks with a single entry and therefore defeats most benefits of
+ * this log format
+ * @param scenario ID of the log scenario
+ * @param start_time time to use as start time for the log
+ */
+BBMultiLoggerThread::BBMultiLoggerThread(const std::vector<std::string> &iface_uids,
+                                         const char *                    filename,
+                                         size_t                          chunk_size,
+                                         bool                            compress,
+                                         bool                            flushing,
+                                         const char *                    scenario,
+                                         fawkes::Time *                  start_time)
+: Thread("BBMultiLoggerThread", Thread::OPMODE_WAITFORWAKEUP),
+  BlackBoardInterfaceListener("BBMultiLoggerThread")
+{
+	set_coalesce_wakeups(true);
+
+	uids_       = iface_uids;
+	filename_   = filename;
+	scenario_   = scenario;
+	chunk_size_ = chunk_size;
+	compress_   = compress;
+	flushing_   = flushing;
+	start_      = new Time(start_time);
+	enabled_    = true;
+	writer_     = NULL;
+	switch_if_  = NULL;
+}
+
+/** Destructor. */
+BBMultiLoggerThread::~BBMultiLoggerThread()
+{
+	delete start_;
+}
+
+void
+BBMultiLoggerThread::init()
+{
+	flush_ = false;
+
+	writer_ = new BBMultiLogWriter(
+	  filename_.c_str(), scenario_.c_str(), *start_, chunk_size_, compress_);
+
+	try {
+		for (const std::string &uid : uids_) {
+			std::string type, id;
+			Interface::parse_uid(uid.c_str(), type, id);
+			Interface *iface = blackboard->open_for_reading(type.c_str(), id.c_str());
+			ifaces_.push_back(iface);
+			iface_index_[iface] = writer_->add_interface(iface);
+
+			bbil_add_data_interface(iface);
+			bbil_add_writer_interface(iface);
+		}
+
+		switch_if_ = blackboard->open_for_writing<SwitchInterface>("BBLogger");
+		switch_if_->set_enabled(enabled_);
+		switch_if_->write();
+		bbil_add_message_interface(switch_if_);
+	} catch (Exception &e) {
+		close_interfaces();
+		delete writer_;
+		throw;
+	}
+
+	blackboard->register_listener(this);
+
+	logger->log_info(name(), "Logging %zu interfaces to %s", ifaces_.size(), filename_.c_str());
+}
+
+void
+BBMultiLoggerThread::finalize()
+{
+	blackboard->unregister_listener(this);
+
+	try {
+		writer_->close();
+		logger->log_info(name(),
+		                 "Wrote %lu entries in %zu chunks",
+		                 (unsigned long)writer_->num_data_items(),
+		                 writer_->num_chunks());
+	} catch (Exception &e) {
+		logger->log_error(name(), "Failed to close log %s", filename_.c_str());
+		logger->log_error(name(), e);
+	}
+	delete writer_;
+	writer_ = NULL;
+
+	close_interfaces();
+}
+
+void
+BBMultiLoggerThread::close_interfaces()
+{
+	for (Interface *iface : ifaces_) {
+		blackboard->close(iface);
+	}
+	ifaces_.clear();
+	iface_index_.clear();
+
+	if (switch_if_) {
+		blackboard->close(switch_if_);
+		switch_if_ = NULL;
+	}
+}
+
+/** Get filename.
+ * @return file name, the file is created in init()
+ */
+const char *
+BBMultiLoggerThread::get_filename() const
+{
+	return filename_.c_str();
+}
+
+/** Enable or disable logging.
+ * @param enabled true to enable logging, false to disable
+ */
+void
+BBMultiLoggerThread::set_enabled(bool enabled)
+{
+	if (enabled && !enabled_) {
+		logger->log_info(name(), "Logging enabled");
+	} else if (!enabled && enabled_) {
+		logger->log_info(name(),
+		                 "Logging disabled (wrote %lu entries), flushing",
+		                 (unsigned long)writer_->num_data_items());
+		flush_ = true;
+		wakeup();
+	}
+
+	enabled_ = enabled;
+}
+
+void
+BBMultiLoggerThread::loop()
+{
+	try {
+		if (flush_) {
+			flush_ = false;
+			writer_->flush();
+		} else {
+			writer_->write_pending();
+		}
+	} catch (Exception &e) {
+		logger->log_warn(name(), "Failed to write chunks");
+		logger->log_warn(name(), e);
+	}
+}
+
+bool
+BBMultiLoggerThread::bb_interface_message_received(Interface *interface, Message *message) throw()
+{
+	if (dynamic_cast<SwitchInterface::EnableSwitchMessage *>(message) != NULL) {
+		set_enabled(true);
+	} else if (dynamic_cast<SwitchInterface::DisableSwitchMessage *>(message) != NULL) {
+		set_enabled(false);
+	} else {
+		logger->log_debug(name(),
+		                  "Unhandled message type: %s via %s",
+		                  message->type(),
+		                  interface->uid());
+	}
+
+	switch_if_->set_enabled(enabled_);
+	switch_if_->write();
+
+	return false;
+}
+
+void
+BBMultiLoggerThread::bb_interface_data_changed(Interface *interface) throw()
+{
+	if (!enabled_)
+		return;
+
+	try {
+		interface->read();
+
+		Time     now(clock);
+		Time     d             = now - *start_;
+		uint64_t rel_time_usec = (uint64_t)d.get_sec() * 1000000 + (uint64_t)d.get_usec();
+
+		// the map is not modified while the listener is registered
+		unsigned int index = iface_index_.find(interface)->second;
+		if (writer_->append(index, rel_time_usec, interface->datachunk())) {
+			wakeup();
+		} else if (flushing_) {
+			writer_->seal();
+			wakeup();
+		}
+	} catch (Exception &e) {
+		logger->log_error(name(), "Exception when data changed");
+		logger->log_error(name(), e);
+	}
+}
+
+void
+BBMultiLoggerThread::bb_interface_writer_removed(Interface *  interface,
+                                                 unsigned int instance_serial) throw()
+{
+	logger->log_info(name(), "Writer of %s removed, flushing", interface->uid());
+	flush_ = true;
+	wakeup();
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *  mlog_thread.h - BB Logger Thread for multi-interface logs
+ *
+ *  Created: Tue Oct 20 14:03:41 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_MLOG_THREAD_H_
+#define _PLUGINS_BBLOGGER_MLOG_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/clock.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <blackboard/interface_listener.h>
+#include <core/threading/thread.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Interface;
+class SwitchInterface;
+class Time;
+} // namespace fawkes
+
+class BBMultiLogWriter;
+
+class BBMultiLoggerThread : public fawkes::Thread,
+                            public fawkes::LoggingAspect,
+                            public fawkes::ConfigurableAspect,
+                            public fawkes::ClockAspect,
+                            public fawkes::BlackBoardAspect,
+                            public fawkes::BlackBoardInterfaceListener
+{
+public:
+	BBMultiLoggerThread(const std::vector<std::string> &iface_uids,
+	                    const char *                    filename,
+	                    size_t                          chunk_size,
+	                    bool                            compress,
+	                    bool                            flushing,
+	                    const char *                    scenario,
+	                    fawkes::Time *                  start_time);
+	virtual ~BBMultiLoggerThread();
+
+	const char *get_filename() const;
+	void        set_enabled(bool enabled);
+
+	virtual void init();
+	virtual void finalize();
+	virtual void loop();
+
+	virtual bool bb_interface_message_received(fawkes::Interface *interface,
+	                                           fawkes::Message *  message) throw();
+	virtual void bb_interface_data_changed(fawkes::Interface *interface) throw();
+	virtual void bb_interface_writer_removed(fawkes::Interface *interface,
+	                                         unsigned int       instance_serial) throw();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void close_interfaces();
+
+private:
+	std::vector<std::string> uids_;
+	std::string              filename_;
+	std::string              scenario_;
+	size_t                   chunk_size_;
+	bool                     compress_;
+	bool                     flushing_;
+	bool                     enabled_;
+	bool                     flush_;
+
+	fawkes::Time *    start_;
+	BBMultiLogWriter *writer_;
+
+	std::vector<fawkes::Interface *>            ifaces_;
+	std::map<fawkes::Interface *, unsigned int> iface_index_;
+	fawkes::SwitchInterface *                   switch_if_;
+};
+
+#endif
@@ -0,0 +1,174 @@
+/***************************************************************************
+ *  mlogreplay_thread.cpp - BB Log Replay Thread for multi-interface logs
+ *
+ *  Created: Tue Oct 20 15:37:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "mlogreplay_thread.h"
+
+#include "bbmlogfile.h"
+
+#include <blackboard/blackboard.h>
+#include <core/threading/wait_condition.h>
+#include <logging/logger.h>
+
+using namespace fawkes;
+
+/** @class BBMultiLogReplayThread "mlogreplay_thread.h"
+ * BlackBoard log replay thread for multi-interface logs.
+ * Writes the data of all interfaces of the log into the respective
+ * blackboard interfaces, considering the time-step differences between
+ * the entries. Replay can start at an arbitrary offset into the log, which
+ * is found using the index of the log without reading preceding data.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param logfile_name filename of the log to be replayed
+ * @param logdir directory containing the logfile
+ * @param grace_period time in seconds that desired offset and loop offset may
+ * diverge to still write the new data
+ * @param loop_replay specifies if the replay should be looped
+ * @param start_offset time in seconds from the start of the log at which
+ * to start replaying, also when looping
+ */
+BBMultiLogReplayThread::BBMultiLogReplayThread(const char *logfile_name,
+                                               const char *logdir,
+                                               float       grace_period,
+                                               bool        loop_replay,
+                                               float       start_offset)
+: Thread("BBMultiLogReplayThread", Thread::OPMODE_CONTINUOUS),
+  cfg_start_offset_((double)start_offset)
+{
+	set_name("BBMultiLogReplayThread(%s)", logfile_name);
+	set_prepfin_conc_loop(true);
+
+	filename_         = std::string(logdir) + "/" + logfile_name;
+	cfg_grace_period_ = grace_period;
+	cfg_loop_replay_  = loop_replay;
+	logfile_          = NULL;
+}
+
+/** Destructor. */
+BBMultiLogReplayThread::~BBMultiLogReplayThread()
+{
+}
+
+void
+BBMultiLogReplayThread::init()
+{
+	logfile_ = new BBMultiLogFile(filename_.c_str());
+
+	try {
+		if (logfile_->num_data_items() == 0) {
+			throw Exception("Log file %s does not have any entries", filename_.c_str());
+		}
+		if (cfg_start_offset_.in_sec() > logfile_->duration().in_sec()) {
+			throw Exception("Start offset %f beyond end of log file %s (%f sec)",
+			                cfg_start_offset_.in_sec(),
+			                filename_.c_str(),
+			                logfile_->duration().in_sec());
+		}
+
+		for (unsigned int i = 0; i < logfile_->num_interfaces(); ++i) {
+			Interface *iface =
+			  blackboard->open_for_writing(logfile_->interface_type(i), logfile_->interface_id(i));
+			interfaces_.push_back(iface);
+			logfile_->set_interface(i, iface);
+		}
+	} catch (Exception &e) {
+		finalize();
+		throw;
+	}
+
+	logger->log_info(name(),
+	                 "Replaying %u interfaces from %s%s",
+	                 logfile_->num_interfaces(),
+	                 filename_.c_str(),
+	                 logfile_->has_index() ? "" : " (not indexed)");
+}
+
+void
+BBMultiLogReplayThread::finalize()
+{
+	for (Interface *iface : interfaces_) {
+		blackboard->close(iface);
+	}
+	interfaces_.clear();
+	delete logfile_;
+	logfile_ = NULL;
+}
+
+/** Position the log at the start offset and write the first entry. */
+void
+BBMultiLogReplayThread::start_replay()
+{
+	if (cfg_start_offset_.in_usec() > 0) {
+		logfile_->seek(cfg_start_offset_);
+	} else {
+		logfile_->rewind();
+	}
+
+	// Write first immediately, skip first offset
+	logfile_->read_next();
+	interfaces_[logfile_->entry_interface()]->write();
+	last_offset_ = logfile_->entry_offset();
+	if (logfile_->has_next()) {
+		logfile_->read_next();
+		offsetdiff_  = logfile_->entry_offset() - last_offset_;
+		last_offset_ = logfile_->entry_offset();
+	}
+	last_loop_.stamp();
+}
+
+void
+BBMultiLogReplayThread::once()
+{
+	start_replay();
+}
+
+void
+BBMultiLogReplayThread::loop()
+{
+	if (logfile_->has_next()) {
+		// check if there is time left to wait
+		now_.stamp();
+		loopdiff_ = now_ - last_loop_;
+		if ((offsetdiff_.in_sec() - loopdiff_.in_sec()) > cfg_grace_period_) {
+			waittime_ = offsetdiff_ - loopdiff_;
+			waittime_.wait();
+		}
+
+		interfaces_[logfile_->entry_interface()]->write();
+		logfile_->read_next();
+
+		last_loop_.stamp();
+		offsetdiff_  = logfile_->entry_offset() - last_offset_;
+		last_offset_ = logfile_->entry_offset();
+
+	} else {
+		if (cfg_loop_replay_) {
+			logger->log_info(name(), "replay finished, looping");
+			start_replay();
+		} else {
+			logger->log_info(name(), "replay finished, sleeping");
+			WaitCondition waitcond;
+			waitcond.wait();
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *  mlogreplay_thread.h - BB Log Replay Thread for multi-interface logs
+ *
+ *  Created: Tue Oct 20 15:28:40 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_MLOGREPLAY_THREAD_H_
+#define _PLUGINS_BBLOGGER_MLOGREPLAY_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/clock.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <core/threading/thread.h>
+#include <utils/time/time.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Interface;
+}
+
+class BBMultiLogFile;
+
+class BBMultiLogReplayThread : public fawkes::Thread,
+                               public fawkes::LoggingAspect,
+                               public fawkes::ConfigurableAspect,
+                               public fawkes::ClockAspect,
+                               public fawkes::BlackBoardAspect
+{
+public:
+	BBMultiLogReplayThread(const char *logfile_name,
+	                       const char *logdir,
+	                       float       grace_period,
+	                       bool        loop_replay,
+	                       float       start_offset);
+	virtual ~BBMultiLogReplayThread();
+
+	virtual void init();
+	virtual void finalize();
+	virtual void loop();
+	virtual void once();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void start_replay();
+
+private:
+	std::string  filename_;
+	float        cfg_grace_period_;
+	bool         cfg_loop_replay_;
+	fawkes::Time cfg_start_offset_;
+
+	BBMultiLogFile *                 logfile_;
+	std::vector<fawkes::Interface *> interfaces_;
+
+	fawkes::Time last_offset_;
+	fawkes::Time offsetdiff_;
+	fawkes::Time loopdiff_;
+	fawkes::Time waittime_;
+	fawkes::Time last_loop_;
+	fawkes::Time now_;
+};
+
+#endif
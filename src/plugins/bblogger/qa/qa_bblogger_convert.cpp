@@ -0,0 +1,168 @@
+/***************************************************************************
+ *  qa_bblogger_convert.cpp - Convert legacy logs to a multi-interface log QA
+ *
+ *  Created: Sun Oct 18 19:31:26 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../bblogfile.h"
+#include "../bbmlogconvert.h"
+#include "../bbmlogfile.h"
+#include "../bbmlogwriter.h"
+
+#include <arpa/inet.h>
+#include <blackboard/internal/instance_factory.h>
+#include <core/exception.h>
+#include <interfaces/TestInterface.h>
+#include <utils/time/time.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_ENTRIES 1000
+
+/* Write a log as the bblogger of file version 1 did, which always set the
+ * endianess field to big endian and stored all data in host byte order. */
+static void
+write_legacy_log(const char *   filename,
+                 TestInterface *ti,
+                 const Time &   start,
+                 unsigned int   first_value)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f) {
+		throw Exception(errno, "Failed to open %s", filename);
+	}
+
+	bblog_file_header header;
+	memset(&header, 0, sizeof(header));
+	header.file_magic     = htonl(BBLOGGER_FILE_MAGIC);
+	header.file_version   = htonl(BBLOGGER_FILE_VERSION_LEGACY);
+	header.endianess      = BBLOG_BIG_ENDIAN;
+	header.num_data_items = NUM_ENTRIES;
+	strncpy(header.scenario, "qa", BBLOG_SCENARIO_SIZE - 1);
+	strncpy(header.interface_type, ti->type(), BBLOG_INTERFACE_TYPE_SIZE - 1);
+	strncpy(header.interface_id, ti->id(), BBLOG_INTERFACE_ID_SIZE - 1);
+	memcpy(header.interface_hash, ti->hash(), BBLOG_INTERFACE_HASH_SIZE);
+	header.data_size       = ti->datasize();
+	header.start_time_sec  = start.get_sec();
+	header.start_time_usec = start.get_usec();
+	bool ok                = (fwrite(&header, sizeof(header), 1, f) == 1);
+
+	for (unsigned int i = 0; ok && (i < NUM_ENTRIES); ++i) {
+		bblog_entry_header eh;
+		eh.rel_time_sec  = (i * 2000) / 1000000;
+		eh.rel_time_usec = (i * 2000) % 1000000;
+		ti->set_test_int(first_value + 2 * i);
+		ti->set_test_uint(first_value + 2 * i);
+		ok = (fwrite(&eh, sizeof(eh), 1, f) == 1)
+		     && (fwrite(ti->datachunk(), ti->datasize(), 1, f) == 1);
+	}
+	fclose(f);
+	if (!ok) {
+		throw Exception("Failed to write %s", filename);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *file_a  = "/tmp/qa_bblogger_convert_A.log";
+	const char *file_b  = "/tmp/qa_bblogger_convert_B.log";
+	const char *outfile = "/tmp/qa_bblogger_convert.bbmlog";
+	unlink(outfile);
+
+	BlackBoardInstanceFactory factory;
+	TestInterface *ti_a = (TestInterface *)factory.new_interface_instance("TestInterface", "A");
+	TestInterface *ti_b = (TestInterface *)factory.new_interface_instance("TestInterface", "B");
+
+	try {
+		// A holds the even, B the odd values, B starts 1 ms later and
+		// its entries lie between those of A once merged
+		Time start_a(1000, 0);
+		Time start_b(1000, 1000);
+		write_legacy_log(file_a, ti_a, start_a, 0);
+		write_legacy_log(file_b, ti_b, start_b, 1);
+
+		std::vector<std::shared_ptr<BBLogFile>> files;
+		files.push_back(std::shared_ptr<BBLogFile>(new BBLogFile(file_a)));
+		files.push_back(std::shared_ptr<BBLogFile>(new BBLogFile(file_b)));
+		if (files[0]->file_version() != BBLOGGER_FILE_VERSION_LEGACY) {
+			throw Exception("Unexpected file version %u", files[0]->file_version());
+		}
+#if BYTE_ORDER == LITTLE_ENDIAN
+		if (files[0]->is_big_endian()) {
+			throw Exception("Legacy file not reported in host byte order");
+		}
+#endif
+
+		BBMultiLogWriter writer(outfile, files[0]->scenario(), start_a, 4096, true);
+		bbmlog_merge(files, start_a, writer);
+		writer.close();
+
+		BBMultiLogFile bf(outfile);
+		if (bf.num_data_items() != 2 * NUM_ENTRIES) {
+			throw Exception("Converted log has %lu entries, expected %u",
+			                (unsigned long)bf.num_data_items(),
+			                2 * NUM_ENTRIES);
+		}
+
+		unsigned int n = 0;
+		while (bf.has_next()) {
+			unsigned int   idx = bf.read_next();
+			TestInterface *ti  = (TestInterface *)bf.interface(idx);
+			if ((ti->test_int() != (int)n) || (ti->test_uint() != n)
+			    || (strcmp(ti->id(), (n % 2 == 0) ? "A" : "B") != 0)
+			    || (bf.entry_offset().in_usec() != (long)n * 1000)) {
+				throw Exception("Entry %u does not match (%s: %i at %li usec)",
+				                n,
+				                ti->id(),
+				                ti->test_int(),
+				                bf.entry_offset().in_usec());
+			}
+			++n;
+		}
+		if (n != 2 * NUM_ENTRIES) {
+			throw Exception("Read %u entries, expected %u", n, 2 * NUM_ENTRIES);
+		}
+		printf("Converted %u entries of two legacy logs\n", n);
+	} catch (Exception &e) {
+		printf("QA failed\n");
+		e.print_trace();
+		return 1;
+	}
+
+	factory.delete_interface_instance(ti_a);
+	factory.delete_interface_instance(ti_b);
+	unlink(file_a);
+	unlink(file_b);
+	unlink(outfile);
+
+	printf("QA passed\n");
+	return 0;
+}
+
+/// @endcond
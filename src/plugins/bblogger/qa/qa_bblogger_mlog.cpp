@@ -0,0 +1,167 @@
+
+/***************************************************************************
+ *  qa_bblogger_mlog.cpp - Multi-interface log write/read QA
+ *
+ *  Created: Tue Oct 20 17:02:55 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../bbmlogfile.h"
+#include "../bbmlogwriter.h"
+
+#include <blackboard/internal/instance_factory.h>
+#include <core/exception.h>
+#include <interfaces/TestInterface.h>
+#include <utils/time/time.h>
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define NUM_ENTRIES 10000
+
+int
+main(int argc, char **argv)
+{
+	const char *filename = (argc > 1) ? argv[1] : "/tmp/qa_bblogger_mlog.bbmlog";
+	unlink(filename);
+
+	BlackBoardInstanceFactory factory;
+	TestInterface *ti_a = (TestInterface *)factory.new_interface_instance("TestInterface", "A");
+	TestInterface *ti_b = (TestInterface *)factory.new_interface_instance("TestInterface", "B");
+
+	try {
+		Time start;
+		Time wstart;
+
+		BBMultiLogWriter writer(filename, "qa", start, 16384, true);
+		unsigned int     idx_a = writer.add_interface(ti_a);
+		unsigned int     idx_b = writer.add_interface(ti_b);
+
+		for (unsigned int i = 0; i < NUM_ENTRIES; ++i) {
+			TestInterface *ti = (i % 3 == 0) ? ti_b : ti_a;
+			ti->set_test_int(i);
+			ti->set_test_uint(i * 2);
+			bool sealed = writer.append((ti == ti_a) ? idx_a : idx_b, i * 1000, ti->datachunk());
+			if (sealed)
+				writer.write_pending();
+		}
+		writer.close();
+
+		Time wend;
+		printf("Wrote %lu entries in %zu chunks in %f sec\n",
+		       (unsigned long)writer.num_data_items(),
+		       writer.num_chunks(),
+		       (wend - wstart).in_sec());
+
+		BBMultiLogFile bf(filename);
+		bf.print_info();
+		if (!bf.has_index() || (bf.num_data_items() != NUM_ENTRIES)) {
+			throw Exception("Unexpected index or number of entries");
+		}
+
+		unsigned int n = 0;
+		Time         rstart;
+		while (bf.has_next()) {
+			unsigned int   idx = bf.read_next();
+			TestInterface *ti  = (TestInterface *)bf.interface(idx);
+			if ((ti->test_int() != (int)n) || (ti->test_uint() != n * 2)
+			    || (strcmp(ti->id(), (n % 3 == 0) ? "B" : "A") != 0)
+			    || (bf.entry_offset().in_usec() != (long)n * 1000)) {
+				throw Exception("Entry %u does not match", n);
+			}
+			++n;
+		}
+		Time rend;
+		if (n != NUM_ENTRIES) {
+			throw Exception("Read %u entries, expected %u", n, NUM_ENTRIES);
+		}
+		printf("Read %u entries in %f sec\n", n, (rend - rstart).in_sec());
+
+		Time seek_offset(7.5005);
+		bf.seek(seek_offset);
+		bf.read_next();
+		TestInterface *ti = (TestInterface *)bf.interface(bf.entry_interface());
+		if (ti->test_int() != 7501) {
+			throw Exception("Seek returned entry %i, expected 7501", ti->test_int());
+		}
+
+		bf.read_index(1234);
+		ti = (TestInterface *)bf.interface(bf.entry_interface());
+		if (ti->test_int() != 1234) {
+			throw Exception("Index read returned entry %i, expected 1234", ti->test_int());
+		}
+
+		// simulate an unfinished log by cutting off the index and part of a chunk
+		off_t index_size = sizeof(bblog_block_header) + bf.num_chunks() * sizeof(bblog_index_entry);
+		struct stat fs;
+		if ((stat(filename, &fs) != 0) || (truncate(filename, fs.st_size - index_size - 100) != 0)) {
+			throw Exception(errno, "Failed to truncate %s", filename);
+		}
+	} catch (Exception &e) {
+		printf("QA failed\n");
+		e.print_trace();
+		return 1;
+	}
+
+	try {
+		BBMultiLogFile::repair_file(filename);
+		printf("Repair did not do anything\n");
+		return 2;
+	} catch (Exception &e) {
+		if (strcmp(e.type_id(), "repair-success") != 0) {
+			printf("Repair failed\n");
+			e.print_trace();
+			return 3;
+		}
+	}
+
+	try {
+		BBMultiLogFile bf(filename);
+		unsigned int   n = 0;
+		while (bf.has_next()) {
+			bf.read_next();
+			++n;
+		}
+		printf("Read %u of %u entries after repair\n", n, NUM_ENTRIES);
+		if (!bf.has_index() || (n != bf.num_data_items()) || (n >= NUM_ENTRIES) || (n == 0)) {
+			throw Exception("Unexpected result after repair");
+		}
+	} catch (Exception &e) {
+		printf("QA failed\n");
+		e.print_trace();
+		return 4;
+	}
+
+	factory.delete_interface_instance(ti_a);
+	factory.delete_interface_instance(ti_b);
+	unlink(filename);
+
+	printf("QA passed\n");
+	return 0;
+}
+
+/// @endcond
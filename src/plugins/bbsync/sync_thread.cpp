@@ -77,6 +77,13 @@ BlackBoardSynchronizationThread::init()
 		throw;
 	}
 
+	compress_ = false;
+	try {
+		compress_ = config->get_bool((peer_cfg_prefix_ + "compress").c_str());
+	} catch (Exception &e) {
+		// ignored, use default
+	}
+
 	try {
 		check_interval = config->get_uint((peer_cfg_prefix_ + "check_interval").c_str());
 		logger->log_debug(name(), "Peer check interval set, overriding default.");
@@ -147,7 +154,9 @@ BlackBoardSynchronizationThread::check_connection()
 		}
 
 		try {
-			remote_bb_ = new RemoteBlackBoard(host_.c_str(), port_);
+			RemoteBlackBoard *rbb = new RemoteBlackBoard(host_.c_str(), port_);
+			rbb->set_delta_encoding(true, compress_);
+			remote_bb_ = rbb;
 			logger->log_info(name(),
 			                 "Successfully connected via remote BB to %s (%s:%u)",
 			                 peer_.c_str(),
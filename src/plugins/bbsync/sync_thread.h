@@ -148,6 +148,7 @@ private:
 
 	std::string  host_;
 	unsigned int port_;
+	bool         compress_;
 
 	fawkes::TimeWait *timewait_;
 
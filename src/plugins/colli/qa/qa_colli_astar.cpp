@@ -0,0 +1,380 @@
+
+/***************************************************************************
+ *  qa_colli_astar.cpp - Compare colli's A* search against the original one
+ *
+ *  Created: Sun Oct 18 21:37:05 2026
+ *  Copyright  2002  Stefan Jacobs
+ *             2013-2014  Bahram Maleki-Fard
+ *             2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../search/astar.h"
+#include "../search/og_laser.h"
+
+#include <blackboard/local.h>
+#include <config/yaml.h>
+#include <core/exception.h>
+#include <interfaces/Laser360Interface.h>
+#include <logging/console.h>
+#include <tf/transformer.h>
+#include <utils/system/argparser.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <queue>
+#include <vector>
+
+using namespace fawkes;
+
+#define BLACKBOARD_MEMSIZE 2 * 1024 * 1024
+#define DEFAULT_NUM_SCENES 2000
+#define MAX_OBSTACLES 40
+
+/* The A* search as it was before the per-cell arrays and the flat heap
+ * replaced the state objects, the map closed list and the priority queue.
+ * The new search must find the very same plans. */
+class ReferenceAStar
+{
+public:
+	ReferenceAStar(LaserOccupancyGrid *occ_grid, int max_states)
+	: occ_grid_(occ_grid), max_states_(max_states), state_count_(0)
+	{
+		width_      = occ_grid_->get_width() - 1;
+		height_     = occ_grid_->get_height() - 1;
+		cell_costs_ = occ_grid_->get_cell_costs();
+		states_.resize(max_states_);
+	}
+
+	void
+	solve(const point_t &robo_pos, const point_t &target_pos, std::vector<point_t> &solution)
+	{
+		reset();
+		solution.clear();
+		target_ = target_pos;
+
+		State *initial      = &states_[++state_count_];
+		initial->x          = robo_pos.x;
+		initial->y          = robo_pos.y;
+		initial->father     = NULL;
+		initial->past_cost  = 0;
+		initial->total_cost = heuristic(initial->x, initial->y);
+		open_list_.push(initial);
+
+		for (State *s = search(); s != NULL; s = s->father) {
+			solution.insert(solution.begin(), point_t(s->x, s->y));
+		}
+	}
+
+	point_t
+	remove_target_from_obstacle(int target_x, int target_y, int step_x, int step_y)
+	{
+		reset();
+		State *initial      = &states_[++state_count_];
+		initial->x          = target_x;
+		initial->y          = target_y;
+		initial->total_cost = 0;
+		open_list_.push(initial);
+
+		while (!open_list_.empty() && (state_count_ < max_states_ - 6)) {
+			State *father = open_list_.top();
+			open_list_.pop();
+			int key = calculate_key(father->x, father->y);
+			if (closed_list_.find(key) != closed_list_.end())
+				continue;
+			closed_list_[key] = key;
+
+			if ((father->x > 1) && (father->x < width_ - 2)) {
+				State *child      = &states_[++state_count_];
+				child->x          = father->x + step_x;
+				child->y          = father->y;
+				child->total_cost = father->total_cost + 1;
+				if (occ_grid_->get_prob(child->x, child->y) == cell_costs_.near)
+					return point_t(child->x, child->y);
+				else if (closed_list_.find(calculate_key(child->x, child->y)) == closed_list_.end())
+					open_list_.push(child);
+			}
+
+			if ((father->y > 1) && (father->y < height_ - 2)) {
+				State *child      = &states_[++state_count_];
+				child->x          = father->x;
+				child->y          = father->y + step_y;
+				child->total_cost = father->total_cost + 1;
+				if (occ_grid_->get_prob(child->x, child->y) == cell_costs_.near)
+					return point_t(child->x, child->y);
+				else if (closed_list_.find(calculate_key(child->x, child->y)) == closed_list_.end())
+					open_list_.push(child);
+			}
+		}
+		return point_t(target_x, target_y);
+	}
+
+private:
+	struct State
+	{
+		int    x;
+		int    y;
+		State *father;
+		int    past_cost;
+		int    total_cost;
+	};
+
+	struct cmp
+	{
+		bool
+		operator()(const State *a1, const State *a2) const
+		{
+			return (a1->total_cost > a2->total_cost);
+		}
+	};
+
+	void
+	reset()
+	{
+		state_count_ = 0;
+		open_list_   = std::priority_queue<State *, std::vector<State *>, cmp>();
+		closed_list_.clear();
+	}
+
+	int
+	calculate_key(int x, int y)
+	{
+		return (x << 15) | y;
+	}
+
+	int
+	heuristic(int x, int y)
+	{
+		return abs(x - target_.x) + abs(y - target_.y);
+	}
+
+	State *
+	search()
+	{
+		while (!open_list_.empty()) {
+			State *best = open_list_.top();
+			open_list_.pop();
+
+			if ((best->x == target_.x) && (best->y == target_.y)) {
+				return best;
+			} else if (state_count_ > max_states_ - 6) {
+				max_states_ += (int)(max_states_ / 3.0);
+				states_.clear();
+				states_.resize(max_states_);
+				return NULL;
+			}
+
+			if (best->y > 0)
+				generate_child(best, best->x, best->y - 1);
+			if (best->y < height_)
+				generate_child(best, best->x, best->y + 1);
+			if (best->x > 0)
+				generate_child(best, best->x - 1, best->y);
+			if (best->x < width_)
+				generate_child(best, best->x + 1, best->y);
+		}
+		return NULL;
+	}
+
+	void
+	generate_child(State *father, int x, int y)
+	{
+		float prob = occ_grid_->get_prob(x, y);
+		if (prob == cell_costs_.occ)
+			return;
+		int key = calculate_key(x, y);
+		if (closed_list_.find(key) != closed_list_.end())
+			return;
+		State *child      = &states_[++state_count_];
+		child->x          = x;
+		child->y          = y;
+		child->father     = father;
+		child->past_cost  = father->past_cost + (int)prob;
+		child->total_cost = child->past_cost + heuristic(x, y);
+		open_list_.push(child);
+		closed_list_[key] = key;
+	}
+
+	LaserOccupancyGrid *occ_grid_;
+	colli_cell_cost_t   cell_costs_;
+	int                 width_;
+	int                 height_;
+	int                 max_states_;
+	int                 state_count_;
+	point_t             target_;
+
+	std::vector<State>                                      states_;
+	std::priority_queue<State *, std::vector<State *>, cmp> open_list_;
+	std::map<int, int>                                      closed_list_;
+};
+
+/* Fill the grid with square obstacles surrounded by the near, mid and far
+ * rings the laser occupancy grid puts around obstacles. */
+static void
+random_scene(LaserOccupancyGrid *occ_grid, const colli_cell_cost_t &costs)
+{
+	int width  = occ_grid->get_width();
+	int height = occ_grid->get_height();
+	for (int x = 0; x < width; ++x) {
+		for (int y = 0; y < height; ++y) {
+			(*occ_grid)(x, y) = costs.free;
+		}
+	}
+
+	unsigned int ring_costs[] = {costs.near, costs.mid, costs.far};
+	int          num          = rand() % MAX_OBSTACLES;
+	for (int o = 0; o < num; ++o) {
+		int cx = rand() % width, cy = rand() % height, r = 2 + rand() % 8;
+		for (int x = std::max(cx - r - 3, 0); x <= std::min(cx + r + 3, width - 1); ++x) {
+			for (int y = std::max(cy - r - 3, 0); y <= std::min(cy + r + 3, height - 1); ++y) {
+				int          d    = std::max(abs(x - cx), abs(y - cy));
+				unsigned int cost = (d <= r) ? costs.occ : ring_costs[d - r - 1];
+				// the more expensive cost wins where obstacles overlap
+				if ((*occ_grid)(x, y) < cost)
+					(*occ_grid)(x, y) = cost;
+			}
+		}
+	}
+}
+
+static void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-n scenes] [-s seed]\n"
+	       " -n scenes  number of random scenes to search (default: %u)\n"
+	       " -s seed    seed of the random scenes (default: 42)\n"
+	       "Searches paths in random occupancy grids with colli's A* search and with\n"
+	       "the original implementation, and checks that both find the same plans.\n",
+	       program_name,
+	       DEFAULT_NUM_SCENES);
+}
+
+int
+main(int argc, char **argv)
+{
+	ArgumentParser argp(argc, argv, "hn:s:");
+	if (argp.has_arg("h")) {
+		print_usage(argp.program_name());
+		return 0;
+	}
+	unsigned int num_scenes = argp.has_arg("n") ? argp.parse_int("n") : DEFAULT_NUM_SCENES;
+	srand(argp.has_arg("s") ? argp.parse_int("s") : 42);
+
+	ConsoleLogger     logger(Logger::LL_WARN);
+	YamlConfiguration config(CONFDIR);
+	try {
+		config.load("config.yaml");
+	} catch (Exception &e) {
+		printf("Failed to load config: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+
+	// the grid needs a laser interface, it is not updated though
+	BlackBoard *       bb       = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+	Laser360Interface *if_laser = bb->open_for_writing<Laser360Interface>("QA Laser");
+	tf::Transformer    tf_listener;
+
+	// grid and search are set up as in ColliThread::initialize_modules()
+	std::string         cfg_prefix = "/plugins/colli/";
+	LaserOccupancyGrid *occ_grid = new LaserOccupancyGrid(if_laser, &logger, &config, &tf_listener);
+	float occ_grid_width         = config.get_float((cfg_prefix + "occ_grid/width").c_str());
+	float occ_grid_height        = config.get_float((cfg_prefix + "occ_grid/height").c_str());
+	occ_grid->set_cell_width(config.get_int((cfg_prefix + "occ_grid/cell_width").c_str()));
+	occ_grid->set_width((int)((occ_grid_width * 100) / occ_grid->get_cell_width()));
+	occ_grid->set_cell_height(config.get_int((cfg_prefix + "occ_grid/cell_height").c_str()));
+	occ_grid->set_height((int)((occ_grid_height * 100) / occ_grid->get_cell_height()));
+	int max_states = config.get_int((cfg_prefix + "search/a_star/max_states").c_str());
+
+	AStarColli        astar(occ_grid, &logger, &config);
+	ReferenceAStar    reference(occ_grid, max_states);
+	colli_cell_cost_t costs  = occ_grid->get_cell_costs();
+	int               width  = occ_grid->get_width();
+	int               height = occ_grid->get_height();
+
+	unsigned int         errors = 0, num_plans = 0;
+	double               astar_time = 0., reference_time = 0.;
+	std::vector<point_t> plan, reference_plan;
+	for (unsigned int i = 0; i < num_scenes; ++i) {
+		random_scene(occ_grid, costs);
+		point_t robo_pos(10 + rand() % (width - 20), 10 + rand() % (height - 20));
+		point_t target_pos(2 + rand() % (width - 4), 2 + rand() % (height - 4));
+		(*occ_grid)(robo_pos.x, robo_pos.y) = costs.free;
+		int step_x                          = (robo_pos.x < target_pos.x) ? -1 : 1;
+		int step_y                          = (robo_pos.y < target_pos.y) ? -1 : 1;
+
+		point_t reference_target = target_pos;
+		Time    start;
+		if (occ_grid->get_prob(target_pos.x, target_pos.y) == costs.occ) {
+			reference_target =
+			  reference.remove_target_from_obstacle(target_pos.x, target_pos.y, step_x, step_y);
+		}
+		reference.solve(robo_pos, reference_target, reference_plan);
+		Time reference_done;
+		if (occ_grid->get_prob(target_pos.x, target_pos.y) == costs.occ) {
+			target_pos = astar.remove_target_from_obstacle(target_pos.x, target_pos.y, step_x, step_y);
+		}
+		astar.solve(robo_pos, target_pos, plan);
+		Time astar_done;
+
+		reference_time += reference_done - &start;
+		astar_time += astar_done - &reference_done;
+		if (!plan.empty())
+			++num_plans;
+
+		if ((target_pos.x != reference_target.x) || (target_pos.y != reference_target.y)) {
+			printf("Scene %u: target moved to (%i,%i), expected (%i,%i)\n",
+			       i,
+			       target_pos.x,
+			       target_pos.y,
+			       reference_target.x,
+			       reference_target.y);
+			++errors;
+		} else if (plan.size() != reference_plan.size()
+		           || !std::equal(plan.begin(),
+		                          plan.end(),
+		                          reference_plan.begin(),
+		                          [](const point_t &a, const point_t &b) {
+			                          return (a.x == b.x) && (a.y == b.y);
+		                          })) {
+			printf("Scene %u: plan from (%i,%i) to (%i,%i) differs, %zu instead of %zu cells\n",
+			       i,
+			       robo_pos.x,
+			       robo_pos.y,
+			       target_pos.x,
+			       target_pos.y,
+			       plan.size(),
+			       reference_plan.size());
+			++errors;
+		}
+	}
+
+	printf("%u scenes on %i x %i grid, %u plans found\n", num_scenes, width, height, num_plans);
+	printf("reference  %8.3f ms per search\n", reference_time * 1000. / num_scenes);
+	printf("a*         %8.3f ms per search\n", astar_time * 1000. / num_scenes);
+
+	delete occ_grid;
+	bb->close(if_laser);
+	delete bb;
+
+	printf("QA %s (%u errors)\n", errors == 0 ? "passed" : "FAILED", errors);
+	return errors == 0 ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,197 @@
+
+/***************************************************************************
+ *  qa_colli_replay.cpp - Replay recorded laser data through colli's grid and search
+ *
+ *  Created: Sun Oct 18 18:04:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../../bblogger/bblogfile.h"
+#include "../search/astar_search.h"
+#include "../search/og_laser.h"
+
+#include <blackboard/local.h>
+#include <config/yaml.h>
+#include <core/exception.h>
+#include <interfaces/Laser360Interface.h>
+#include <logging/console.h>
+#include <tf/transformer.h>
+#include <utils/system/argparser.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace fawkes;
+
+#define BLACKBOARD_MEMSIZE 2 * 1024 * 1024
+
+static void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-f] [-t x,y] <laser360.log>\n"
+	       " -f       replay as fast as possible, not at the recorded rate\n"
+	       " -t x,y   target relative to the robot in m (default: 3,0)\n"
+	       "Replays recorded Laser360Interface data and measures the time colli\n"
+	       "needs per cycle to update its occupancy grid and to search a path.\n"
+	       "The robot is assumed to stand still at the origin of the odometry frame.\n",
+	       program_name);
+}
+
+int
+main(int argc, char **argv)
+{
+	ArgumentParser argp(argc, argv, "hft:");
+	if (argp.has_arg("h") || argp.num_items() != 1) {
+		print_usage(argp.program_name());
+		return argp.has_arg("h") ? 0 : 1;
+	}
+
+	float target_x = 3.0, target_y = 0.0;
+	if (argp.has_arg("t") && sscanf(argp.arg("t"), "%f,%f", &target_x, &target_y) != 2) {
+		print_usage(argp.program_name());
+		return 1;
+	}
+
+	ConsoleLogger     logger(Logger::LL_WARN);
+	YamlConfiguration config(CONFDIR);
+	BBLogFile *       log = NULL;
+	try {
+		config.load("config.yaml");
+		log = new BBLogFile(argp.items()[0]);
+	} catch (Exception &e) {
+		printf("Failed to initialize: %s\n", e.what_no_backtrace());
+		return 1;
+	}
+
+	if (strcmp(log->interface_type(), "Laser360Interface") != 0) {
+		printf("Log contains %s, not Laser360Interface data\n", log->interface_type());
+		delete log;
+		return 1;
+	}
+
+	// colli reads the laser data from the blackboard, so do we
+	BlackBoard *       bb        = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+	Laser360Interface *if_writer = bb->open_for_writing<Laser360Interface>(log->interface_id());
+	Laser360Interface *if_laser  = bb->open_for_reading<Laser360Interface>(log->interface_id());
+
+	// static robot, laser and odometry frames coincide
+	std::string     cfg_prefix     = "/plugins/colli/";
+	std::string     odometry_frame = config.get_string((cfg_prefix + "frame/odometry").c_str());
+	std::string     laser_frame    = config.get_string((cfg_prefix + "frame/laser").c_str());
+	tf::Transformer tf_listener;
+	tf::Transform   identity(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
+	tf::StampedTransform laser_to_odometry(identity, Time(0, 0), odometry_frame, laser_frame);
+	tf_listener.set_transform(laser_to_odometry, "qa", /* static */ true);
+
+	// grid and search are set up as in ColliThread::initialize_modules()
+	LaserOccupancyGrid *occ_grid = new LaserOccupancyGrid(if_laser, &logger, &config, &tf_listener);
+	float occ_grid_width  = config.get_float((cfg_prefix + "occ_grid/width").c_str());
+	float occ_grid_height = config.get_float((cfg_prefix + "occ_grid/height").c_str());
+	occ_grid->set_cell_width(config.get_int((cfg_prefix + "occ_grid/cell_width").c_str()));
+	occ_grid->set_width((int)((occ_grid_width * 100) / occ_grid->get_cell_width()));
+	occ_grid->set_cell_height(config.get_int((cfg_prefix + "occ_grid/cell_height").c_str()));
+	occ_grid->set_height((int)((occ_grid_height * 100) / occ_grid->get_cell_height()));
+	Search *search = new Search(occ_grid, &logger, &config);
+
+	// grid positions as in ColliThread::update_modules() without motion
+	int laserpos_x    = std::max(occ_grid->get_width() / 2, 10);
+	int laserpos_y    = occ_grid->get_height() / 2;
+	int robopos_x     = laserpos_x;
+	int robopos_y     = laserpos_y;
+	int target_grid_x = robopos_x + (int)((target_x * 100.f) / (float)occ_grid->get_cell_width());
+	int target_grid_y = robopos_y + (int)((target_y * 100.f) / (float)occ_grid->get_cell_height());
+	target_grid_x     = std::min(std::max(target_grid_x, 2), occ_grid->get_width() - 2);
+	target_grid_y     = std::min(std::max(target_grid_y, 2), occ_grid->get_height() - 2);
+
+	std::vector<double> grid_times, search_times;
+	unsigned int        num_plans = 0;
+	Time                start;
+	while (log->has_next()) {
+		log->read_next();
+		if (!argp.has_arg("f")) {
+			double remaining = log->entry_offset().in_sec() - (Time() - &start);
+			if (remaining > 0.)
+				Time(remaining).wait();
+		}
+
+		// written data is stamped with the current time, which keeps the
+		// history of the grid working as with live data
+		if_writer->copy_values(log->interface());
+		if (laser_frame != if_writer->frame()) {
+			if_writer->set_frame(laser_frame.c_str());
+		}
+		if_writer->write();
+
+		Time cycle_start;
+		occ_grid->update_occ_grid(laserpos_x, laserpos_y, 0.f, 0.f, 0.f);
+		Time grid_done;
+		search->update(robopos_x, robopos_y, target_grid_x, target_grid_y);
+		Time search_done;
+
+		grid_times.push_back((grid_done - &cycle_start) * 1000.);
+		search_times.push_back((search_done - &grid_done) * 1000.);
+		if (search->updated_successful())
+			++num_plans;
+	}
+
+	if (grid_times.empty()) {
+		printf("Log contains no data\n");
+	} else {
+		std::vector<double> cycle_times;
+		for (size_t i = 0; i < grid_times.size(); ++i) {
+			cycle_times.push_back(grid_times[i] + search_times[i]);
+		}
+		printf("%zu cycles on %i x %i grid, %u plans found\n",
+		       cycle_times.size(),
+		       occ_grid->get_width(),
+		       occ_grid->get_height(),
+		       num_plans);
+		const char *         names[] = {"grid", "search", "cycle"};
+		std::vector<double> *times[] = {&grid_times, &search_times, &cycle_times};
+		for (unsigned int i = 0; i < 3; ++i) {
+			std::vector<double> &t   = *times[i];
+			double               sum = 0.;
+			for (double v : t) {
+				sum += v;
+			}
+			std::sort(t.begin(), t.end());
+			printf("%-6s  mean %8.3f ms  median %8.3f ms  95%% %8.3f ms  max %8.3f ms\n",
+			       names[i],
+			       sum / t.size(),
+			       t[t.size() / 2],
+			       t[(t.size() * 95) / 100],
+			       t.back());
+		}
+	}
+
+	delete search;
+	delete occ_grid;
+	bb->close(if_laser);
+	bb->close(if_writer);
+	delete bb;
+	delete log;
+
+	return 0;
+}
+
+/// @endcond
@@ -26,7 +26,9 @@
 
 #include <config/config.h>
 #include <logging/logger.h>
-#include <utils/math/types.h>
+
+#include <algorithm>
+#include <cstdlib>
 
 using namespace std;
 
@@ -36,15 +38,21 @@ namespace fawkes {
  * This is a high efficient implementation. Therefore this code
  * does not always look very nice here. So be patient and try to
  * understand what I was trying to implement here.
+ *
+ * The states of the search are the cells of the occupancy grid. Instead
+ * of state objects, the past costs, the fathers and the closed list are
+ * arrays indexed like the cells of the grid. The closed list marks cells
+ * with the number of the current search, so nothing needs to be cleared
+ * or allocated per search.
  */
 
 /** Constructor.
  *  This constructor does several things ;-)
  *  It gets an occupancy grid for the local pointer to garant fast access,
  *   and queries the settings for the grid.
- *  After that several states are initialized. This is done for speed purposes
- *   again, cause only here new is called in this code..
- *  Afterwards the Openlist, closedlist and states for A* are initialized.
+ *  After that the per-cell arrays and the openlist are allocated. This is
+ *   done for speed purposes again, cause only here memory is allocated in
+ *   this code..
  * @param occGrid is a pointer to an LaserOccupancyGrid to search through.
  * @param logger The fawkes logger
  * @param config The fawkes configuration
@@ -57,43 +65,31 @@ AStarColli::AStarColli(LaserOccupancyGrid *occGrid, Logger *logger, Configuratio
 	max_states_ = config->get_int("/plugins/colli/search/a_star/max_states");
 
 	occ_grid_ = occGrid;
-	width_    = occ_grid_->get_width() - 1;
-	height_   = occ_grid_->get_height() - 1;
+	width_    = 0;
+	height_   = 0;
+	stride_   = 0;
 
 	cell_costs_ = occ_grid_->get_cell_costs();
 
 	astar_state_count_ = 0;
-	astar_states_.reserve(max_states_);
-
-	for (int i = 0; i < max_states_; i++) {
-		AStarState *state = new AStarState();
-		astar_states_[i]  = state;
-	}
-
-	while (open_list_.size() > 0)
-		open_list_.pop();
-
-	closed_list_.clear();
+	search_stamp_      = 0;
+	open_list_.reserve(max_states_);
+	init_search();
 
 	logger_->log_debug("AStar", "(Constructor): Initializing AStar done");
 }
 
-/** Destructor.
- *  This destructor deletes all the states allocated during construction.
- */
+/** Destructor. */
 AStarColli::~AStarColli()
 {
 	logger_->log_debug("AStar", "(Destructor): Destroying AStar");
-	for (int i = 0; i < max_states_; i++)
-		delete astar_states_[i];
-	logger_->log_debug("AStar", "(Destructor): Destroying AStar done");
 }
 
 /** solve.
  *  solve is the externally called method to solve the assignment by A*.
- *  It generates an initial state, and sets its values accordingly.
- *  This state is put on the openlist, and then  the search is called, after which
- *  the solution sequence is generated by the pointers in all states.
+ *  It puts the initial state on the openlist, and then the search is
+ *  called, after which the solution sequence is generated by following
+ *  the fathers of the cells.
  * @param robo_pos The position of the robot in the grid
  * @param target_pos The position of the target in the grid
  * @param solution a vector that will be filled with the found path
@@ -101,94 +97,133 @@ AStarColli::~AStarColli()
 void
 AStarColli::solve(const point_t &robo_pos, const point_t &target_pos, vector<point_t> &solution)
 {
-	// initialize counter, vectors/lists/queues
-	astar_state_count_ = 0;
-	while (open_list_.size() > 0)
-		open_list_.pop();
-	closed_list_.clear();
+	// initialize counter, arrays and lists
+	init_search();
 	solution.clear();
 
-	// setting start coordinates
-	robo_pos_.x_     = robo_pos.x;
-	robo_pos_.y_     = robo_pos.y;
-	target_state_.x_ = target_pos.x;
-	target_state_.y_ = target_pos.y;
+	if ((robo_pos.x < 0) || (robo_pos.x > (int)width_) || (robo_pos.y < 0)
+	    || (robo_pos.y > (int)height_)) {
+		logger_->log_debug("AStar", "Robot position is outside of the grid");
+		return;
+	}
+
+	// setting target coordinates
+	target_pos_ = target_pos;
 
-	// generating initialstate
-	AStarState *initial_state  = astar_states_[++astar_state_count_];
-	initial_state->x_          = robo_pos_.x_;
-	initial_state->y_          = robo_pos_.y_;
-	initial_state->father_     = 0;
-	initial_state->past_cost_  = 0;
-	initial_state->total_cost_ = heuristic(initial_state);
+	// generating initialstate, it is not put on the closed list
+	int start          = occ_grid_->get_index(robo_pos.x, robo_pos.y);
+	astar_state_count_ = 1;
+	past_costs_[start] = 0;
+	fathers_[start]    = -1;
 
 	// performing search
-	open_list_.push(initial_state);
-	get_solution_sequence(search(), solution);
+	push_open(heuristic(robo_pos.x, robo_pos.y), robo_pos.x, robo_pos.y);
+	int goal = search();
+	if (goal >= 0)
+		get_solution_sequence(start, goal, solution);
 }
 
 /* =========================================== */
 /* *************** PRIVATE PART ************** */
 /* =========================================== */
 
+/** init_search.
+ *  Resizes the per-cell arrays if the grid has changed, starts a new
+ *  closed list and empties the openlist.
+ */
+void
+AStarColli::init_search()
+{
+	if ((width_ != (unsigned int)occ_grid_->get_width() - 1)
+	    || (height_ != (unsigned int)occ_grid_->get_height() - 1)
+	    || (stride_ != occ_grid_->get_stride())) {
+		width_  = occ_grid_->get_width() - 1;
+		height_ = occ_grid_->get_height() - 1;
+		stride_ = occ_grid_->get_stride();
+
+		size_t cells = (size_t)occ_grid_->get_width() * stride_;
+		past_costs_.assign(cells, 0);
+		fathers_.assign(cells, -1);
+		closed_stamps_.assign(cells, 0);
+		search_stamp_ = 0;
+	}
+
+	if (++search_stamp_ == 0) {
+		// stamps wrapped around, old stamps would appear closed
+		std::fill(closed_stamps_.begin(), closed_stamps_.end(), 0);
+		search_stamp_ = 1;
+	}
+
+	open_list_.clear();
+	astar_state_count_ = 0;
+}
+
 /** search.
  *  This is the magic A* algorithm.
  *  Its really easy, you can find it like this everywhere.
+ * @return index of the goal cell, -1 if no path was found
  */
-AStarState *
+int
 AStarColli::search()
 {
-	AStarState *best = 0;
-
 	// while the openlist not is empty
-	while (open_list_.size() > 0) {
+	while (!open_list_.empty()) {
 		// get best state
-		if (open_list_.size() > 0) {
-			best = open_list_.top();
-			open_list_.pop();
-		} else
-			return 0;
+		open_state_t best = pop_open();
 
 		// check if its a goal.
-		if (is_goal(best))
-			return best;
+		if ((best.x == target_pos_.x) && (best.y == target_pos_.y))
+			return occ_grid_->get_index(best.x, best.y);
 		else if (astar_state_count_ > max_states_ - 6) {
 			logger_->log_warn("AStar", "**** Warning: Out of states! Increasing A* MaxStates!");
-
-			for (int i = 0; i < max_states_; i++)
-				delete astar_states_[i];
-
 			max_states_ += (int)(max_states_ / 3.0);
-
-			astar_states_.clear();
-			astar_states_.resize(max_states_);
-			for (int i = 0; i < max_states_; i++) {
-				best             = new AStarState();
-				astar_states_[i] = best;
-			}
+			open_list_.reserve(max_states_);
 			logger_->log_warn("AStar", "**** Increasing done!");
-			return 0;
+			return -1;
 		}
 
 		// generate all its children
 		generate_children(best);
 	}
 
-	return 0;
+	return -1;
 }
 
-/** calculate_key.
- *  This method produces one unique key for a state for
- *    putting this on the closed list.
- *    It has to be really fast, so the function is not so readable.
- *    What it does is the following: x * 2^14 + y. This is unique,
- *    because first it does a bit shift for 14 bits, and adds (or)
- *    afterwards a number that is smaller tham 14 bits!
+/** push_open.
+ *  Puts a state on the openlist. The openlist is a heap ordered like a
+ *  std::priority_queue with the same comparison, the states are thus
+ *  expanded in the very same order.
  */
-int
-AStarColli::calculate_key(int x, int y)
+inline void
+AStarColli::push_open(int total_cost, int x, int y)
+{
+	open_state_t state;
+	state.total_cost = total_cost;
+	state.x          = x;
+	state.y          = y;
+	open_list_.push_back(state);
+	std::push_heap(open_list_.begin(), open_list_.end(), cmp());
+}
+
+/** pop_open.
+ *  Removes the state with the lowest total cost from the openlist.
+ */
+inline AStarColli::open_state_t
+AStarColli::pop_open()
+{
+	std::pop_heap(open_list_.begin(), open_list_.end(), cmp());
+	open_state_t best = open_list_.back();
+	open_list_.pop_back();
+	return best;
+}
+
+/** is_closed.
+ *  Checks if a cell is on the closed list of the current search.
+ */
+inline bool
+AStarColli::is_closed(int cell)
 {
-	return (x << 15) | y; // This line is a crime! But fast ;-)
+	return closed_stamps_[cell] == search_stamp_;
 }
 
 /** generate_children.
@@ -197,109 +232,50 @@ AStarColli::calculate_key(int x, int y)
  *   Afterwards these children are put on the openlist.
  */
 void
-AStarColli::generate_children(AStarState *father)
+AStarColli::generate_children(const open_state_t &father)
 {
-	AStarState *child;
-	int         key;
-
-	float prob;
-
-	if (father->y_ > 0) {
-		prob = occ_grid_->get_prob(father->x_, father->y_ - 1);
-		if (prob != cell_costs_.occ) {
-			child     = astar_states_[++astar_state_count_];
-			child->x_ = father->x_;
-			child->y_ = father->y_ - 1;
-			key       = calculate_key(child->x_, child->y_);
-			if (closed_list_.find(key) == closed_list_.end()) {
-				child->father_     = father;
-				child->past_cost_  = father->past_cost_ + (int)prob;
-				child->total_cost_ = child->past_cost_ + heuristic(child);
-				open_list_.push(child);
-				closed_list_[key] = key;
-
-			} else
-				--astar_state_count_;
-		}
-	}
+	int father_cell = occ_grid_->get_index(father.x, father.y);
 
-	if (father->y_ < (signed int)height_) {
-		prob = occ_grid_->get_prob(father->x_, father->y_ + 1);
-		if (prob != cell_costs_.occ) {
-			child     = astar_states_[++astar_state_count_];
-			child->x_ = father->x_;
-			child->y_ = father->y_ + 1;
-			key       = calculate_key(child->x_, child->y_);
-			if (closed_list_.find(key) == closed_list_.end()) {
-				child->father_     = father;
-				child->past_cost_  = father->past_cost_ + (int)prob;
-				child->total_cost_ = child->past_cost_ + heuristic(child);
-				open_list_.push(child);
-				closed_list_[key] = key;
-
-			} else
-				--astar_state_count_;
-		}
-	}
+	if (father.y > 0)
+		generate_child(father_cell, father.x, father.y - 1);
 
-	if (father->x_ > 0) {
-		prob = occ_grid_->get_prob(father->x_ - 1, father->y_);
-		if (prob != cell_costs_.occ) {
-			child     = astar_states_[++astar_state_count_];
-			child->x_ = father->x_ - 1;
-			child->y_ = father->y_;
-			key       = calculate_key(child->x_, child->y_);
-			if (closed_list_.find(key) == closed_list_.end()) {
-				child->father_     = father;
-				child->past_cost_  = father->past_cost_ + (int)prob;
-				child->total_cost_ = child->past_cost_ + heuristic(child);
-				open_list_.push(child);
-				closed_list_[key] = key;
-
-			} else
-				--astar_state_count_;
-		}
-	}
+	if (father.y < (signed int)height_)
+		generate_child(father_cell, father.x, father.y + 1);
 
-	if (father->x_ < (signed int)width_) {
-		prob = occ_grid_->get_prob(father->x_ + 1, father->y_);
-		if (prob != cell_costs_.occ) {
-			child     = astar_states_[++astar_state_count_];
-			child->x_ = father->x_ + 1;
-			child->y_ = father->y_;
-			key       = calculate_key(child->x_, child->y_);
-			if (closed_list_.find(key) == closed_list_.end()) {
-				child->father_     = father;
-				child->past_cost_  = father->past_cost_ + (int)prob;
-				child->total_cost_ = child->past_cost_ + heuristic(child);
-				open_list_.push(child);
-				closed_list_[key] = key;
-
-			} else
-				--astar_state_count_;
-		}
-	}
+	if (father.x > 0)
+		generate_child(father_cell, father.x - 1, father.y);
+
+	if (father.x < (signed int)width_)
+		generate_child(father_cell, father.x + 1, father.y);
 }
 
-/** heuristic.
- *  This method calculates the heuristic value for a given
- *    state. This is done by the manhatten distance here,
- *    because we are calculating on a grid...
+/** generate_child.
+ *  Puts a child on the openlist and the closed list, unless it is
+ *   occupied or already closed.
  */
-int
-AStarColli::heuristic(AStarState *state)
+inline void
+AStarColli::generate_child(int father, int x, int y)
 {
-	//  return (int)( abs( state->x_ - target_state_.x_ ));
-	return (int)(abs(state->x_ - target_state_.x_) + abs(state->y_ - target_state_.y_));
+	int   child = occ_grid_->get_index(x, y);
+	float prob  = occ_grid_->get_prob(child);
+	if ((prob != cell_costs_.occ) && !is_closed(child)) {
+		++astar_state_count_;
+		fathers_[child]       = father;
+		past_costs_[child]    = past_costs_[father] + (int)prob;
+		closed_stamps_[child] = search_stamp_;
+		push_open(past_costs_[child] + heuristic(x, y), x, y);
+	}
 }
 
-/** is_goal.
- *  This method checks, if a state is a goal state.
+/** heuristic.
+ *  This method calculates the heuristic value for a given
+ *    cell. This is done by the manhatten distance here,
+ *    because we are calculating on a grid...
  */
-bool
-AStarColli::is_goal(AStarState *state)
+inline int
+AStarColli::heuristic(int x, int y)
 {
-	return ((target_state_.x_ == state->x_) && (target_state_.y_ == state->y_));
+	return abs(x - target_pos_.x) + abs(y - target_pos_.y);
 }
 
 /** get_solution_sequence.
@@ -307,13 +283,13 @@ AStarColli::is_goal(AStarState *state)
  *    tree into the solution/plan vector.
  */
 void
-AStarColli::get_solution_sequence(AStarState *node, vector<point_t> &solution)
+AStarColli::get_solution_sequence(int start, int goal, vector<point_t> &solution)
 {
-	AStarState *state = node;
-	while (state != 0) {
-		solution.insert(solution.begin(), point_t(state->x_, state->y_));
-		state = state->father_;
+	for (int cell = goal; cell != start; cell = fathers_[cell]) {
+		solution.push_back(point_t(cell / stride_, cell % stride_));
 	}
+	solution.push_back(point_t(start / stride_, start % stride_));
+	std::reverse(solution.begin(), solution.end());
 	//logger_->log_debug("AStar", "(get_solution_sequence): Solutionsize=%u  , Used states=%i",
 	//                   solution.size(), astar_state_count_);
 }
@@ -334,52 +310,40 @@ point_t
 AStarColli::remove_target_from_obstacle(int target_x, int target_y, int step_x, int step_y)
 {
 	// initializing lists...
-	while (open_list_.size() > 0)
-		open_list_.pop();
+	init_search();
+
+	if ((target_x < 0) || (target_x > (int)width_) || (target_y < 0) || (target_y > (int)height_))
+		return point_t(target_x, target_y);
 
-	closed_list_.clear();
-	astar_state_count_ = 0;
 	// starting fill algorithm by putting first state in openlist
-	AStarState *initial_state  = astar_states_[++astar_state_count_];
-	initial_state->x_          = target_x;
-	initial_state->y_          = target_y;
-	initial_state->total_cost_ = 0;
-	open_list_.push(initial_state);
-	// search algorithm by gridfilling
-	AStarState *child;
-	AStarState *father;
+	astar_state_count_ = 1;
+	push_open(0, target_x, target_y);
 
+	// search algorithm by gridfilling
 	while (!(open_list_.empty()) && (astar_state_count_ < max_states_ - 6)) {
-		father = open_list_.top();
-		open_list_.pop();
-		int key = calculate_key(father->x_, father->y_);
+		open_state_t father = pop_open();
+		int          cell   = occ_grid_->get_index(father.x, father.y);
 
-		if (closed_list_.find(key) == closed_list_.end()) {
-			closed_list_[key] = key;
+		if (!is_closed(cell)) {
+			closed_stamps_[cell] = search_stamp_;
 			// generiere zwei kinder. wenn besetzt, pack sie an das ende
 			//   der openlist mit kosten + 1, sonst return den Knoten
-			if ((father->x_ > 1) && (father->x_ < (signed)width_ - 2)) {
-				child              = astar_states_[++astar_state_count_];
-				child->x_          = father->x_ + step_x;
-				child->y_          = father->y_;
-				child->total_cost_ = father->total_cost_ + 1;
-				key                = calculate_key(child->x_, child->y_);
-				if (occ_grid_->get_prob(child->x_, child->y_) == cell_costs_.near)
-					return point_t(child->x_, child->y_);
-				else if (closed_list_.find(key) == closed_list_.end())
-					open_list_.push(child);
+			if ((father.x > 1) && (father.x < (signed)width_ - 2)) {
+				++astar_state_count_;
+				int x = father.x + step_x;
+				if (occ_grid_->get_prob(x, father.y) == cell_costs_.near)
+					return point_t(x, father.y);
+				else if (!is_closed(occ_grid_->get_index(x, father.y)))
+					push_open(father.total_cost + 1, x, father.y);
 			}
 
-			if ((father->y_ > 1) && (father->y_ < (signed)height_ - 2)) {
-				child              = astar_states_[++astar_state_count_];
-				child->x_          = father->x_;
-				child->y_          = father->y_ + step_y;
-				child->total_cost_ = father->total_cost_ + 1;
-				key                = calculate_key(child->x_, child->y_);
-				if (occ_grid_->get_prob(child->x_, child->y_) == cell_costs_.near)
-					return point_t(child->x_, child->y_);
-				else if (closed_list_.find(key) == closed_list_.end())
-					open_list_.push(child);
+			if ((father.y > 1) && (father.y < (signed)height_ - 2)) {
+				++astar_state_count_;
+				int y = father.y + step_y;
+				if (occ_grid_->get_prob(father.x, y) == cell_costs_.near)
+					return point_t(father.x, y);
+				else if (!is_closed(occ_grid_->get_index(father.x, y)))
+					push_open(father.total_cost + 1, father.x, y);
 			}
 		}
 	}
@@ -24,10 +24,9 @@
 #define _PLUGINS_COLLI_SEARCH_ASTAR_H_
 
 #include "../common/types.h"
-#include "astar_state.h"
 
-#include <map>
-#include <queue>
+#include <utils/math/types.h>
+
 #include <vector>
 
 namespace fawkes {
@@ -36,8 +35,6 @@ class LaserOccupancyGrid;
 class Logger;
 class Configuration;
 
-typedef struct point_struct point_t;
-
 /** Class AStar.
  *  This is an implementation of the A* search algorithm in a
  *    highly efficient way (I hope ;-).
@@ -71,59 +68,76 @@ private:
 	LaserOccupancyGrid *occ_grid_;
 	unsigned int        width_;
 	unsigned int        height_;
+	int                 stride_;
 
 	// Costs for the cells in grid
 	colli_cell_cost_t cell_costs_;
 
-	// this is the local robot position and target point.
-	AStarState robo_pos_;
-	AStarState target_state_;
-
-	// This is a state vector...
-	// It is for speed purposes. So I do not have to do a new each time
-	//   I have to malloc a new one each time.
-	std::vector<AStarState *> astar_states_;
+	// this is the target point.
+	point_t target_pos_;
 
 	// maximum number of states available for a* and current index
 	int max_states_;
 	int astar_state_count_;
 
-	// this is AStars openlist
+	// A state is a cell of the grid, the per-state data is kept in arrays
+	// indexed like the cells of the occupancy grid, cf. OccupancyGrid::get_index().
+	// A cell is on the closed list if its stamp equals search_stamp_, this
+	// way the arrays need not be cleared for each search.
+	std::vector<int>          past_costs_;
+	std::vector<int>          fathers_;
+	std::vector<unsigned int> closed_stamps_;
+	unsigned int              search_stamp_;
+
+	// this is AStars openlist, a heap kept in a vector reserved once
+	typedef struct
+	{
+		int total_cost;
+		int x;
+		int y;
+	} open_state_t;
+
 	struct cmp
 	{
 		bool
-		operator()(AStarState *a1, AStarState *a2) const
+		operator()(const open_state_t &a1, const open_state_t &a2) const
 		{
-			return (a1->total_cost_ > a2->total_cost_);
+			return (a1.total_cost > a2.total_cost);
 		}
 	};
 
-	std::priority_queue<AStarState *, std::vector<AStarState *>, cmp> open_list_;
-
-	// this is AStars closedList
-	std::map<int, int> closed_list_;
+	std::vector<open_state_t> open_list_;
 
 	/* =========================================== */
 	/* ************ PRIVATE METHODS ************** */
 	/* =========================================== */
 
+	// Prepare arrays and lists for a new search
+	void init_search();
+
 	// search with AStar through the OccGrid
-	AStarState *search();
+	int search();
 
-	// Calculate a unique key for a given coordinate
-	int calculate_key(int x, int y);
+	// Put a state on the openlist
+	void push_open(int total_cost, int x, int y);
 
-	// Check if the state is a goal
-	bool is_goal(AStarState *state);
+	// Take the best state from the openlist
+	open_state_t pop_open();
 
-	// Calculate heuristic for a given state
-	int heuristic(AStarState *state);
+	// Check if a cell is on the closed list
+	bool is_closed(int cell);
+
+	// Calculate heuristic for a given cell
+	int heuristic(int x, int y);
 
 	// Generate all children for a given State
-	void generate_children(AStarState *father);
+	void generate_children(const open_state_t &father);
+
+	// Generate a child if it is not blocked or closed
+	void generate_child(int father, int x, int y);
 
 	// Generates a solution sequence for a given state
-	void get_solution_sequence(AStarState *node, std::vector<point_t> &solution);
+	void get_solution_sequence(int start, int goal, std::vector<point_t> &solution);
 };
 
 } // namespace fawkes
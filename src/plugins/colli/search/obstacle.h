@@ -46,7 +46,7 @@ public:
 	/** Return the occupied cells with their values
    * @return vector containing the occupied cells (alternating x and y coordinates)
    */
-	inline const std::vector<int>
+	inline const std::vector<int> &
 	get_obstacle()
 	{
 		return occupied_cells_;
@@ -44,7 +44,7 @@ public:
 		obstacles_.clear();
 	}
 
-	const std::vector<int> get_obstacle(int width, int height, bool obstacle_increasement = true);
+	const std::vector<int> &get_obstacle(int width, int height, bool obstacle_increasement = true);
 
 private:
 	std::map<unsigned int, ColliFastObstacle *> obstacles_;
@@ -68,7 +68,7 @@ inline ColliObstacleMap::ColliObstacleMap(colli_cell_cost_t cell_costs, bool is_
  * @param obstacle_increasement Enable obstacle increasement?
  * @return vector with pairwise cell coordinates (x,y), that are occupied by such an obstacle
  */
-inline const std::vector<int>
+inline const std::vector<int> &
 ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement)
 {
 	unsigned int key = ((unsigned int)width << 16) | (unsigned int)height;
@@ -87,7 +87,7 @@ ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement
 
 	} else {
 		// obstacle found in p (previously created obstacles)
-		return obstacles_[key]->get_obstacle();
+		return p->second->get_obstacle();
 	}
 }
 
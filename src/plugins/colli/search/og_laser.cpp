@@ -33,6 +33,7 @@
 #include <utils/math/coord.h>
 #include <utils/time/clock.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace fawkes {
@@ -389,9 +390,8 @@ LaserOccupancyGrid::update_occ_grid(int midX, int midY, float inc, float vx, flo
 	laser_pos_.x = midX;
 	laser_pos_.y = midY;
 
-	for (int y = 0; y < width_; ++y)
-		for (int x = 0; x < height_; ++x)
-			occupancy_probs_[x][y] = cell_costs_.free;
+	Probability free_cost = cell_costs_.free;
+	std::fill(occupancy_probs_, occupancy_probs_ + width_ * stride_, free_cost);
 
 	update_laser();
 
@@ -590,7 +590,8 @@ LaserOccupancyGrid::integrate_new_readings(int                   midX,
 void
 LaserOccupancyGrid::integrate_obstacle(int x, int y, int width, int height)
 {
-	std::vector<int> fast_obstacle = obstacle_map_->get_obstacle(width, height, cfg_obstacle_inc_);
+	const std::vector<int> &fast_obstacle =
+	  obstacle_map_->get_obstacle(width, height, cfg_obstacle_inc_);
 
 	// i = x offset, i+1 = y offset, i+2 is cost
 	for (unsigned int i = 0; i < fast_obstacle.size(); i += 3) {
@@ -602,9 +603,10 @@ LaserOccupancyGrid::integrate_obstacle(int x, int y, int width, int height)
 		int posX = x + fast_obstacle[i] + offset_base_.x;
 		int posY = y + fast_obstacle[i + 1] + offset_base_.y;
 
-		if ((posX > 0) && (posX < height_) && (posY > 0) && (posY < width_)
-		    && (occupancy_probs_[posX][posY] < fast_obstacle[i + 2])) {
-			occupancy_probs_[posX][posY] = fast_obstacle[i + 2];
+		if ((posX > 0) && (posX < width_) && (posY > 0) && (posY < height_)) {
+			Probability &cell = occupancy_probs_[posX * stride_ + posY];
+			if (cell < fast_obstacle[i + 2])
+				cell = fast_obstacle[i + 2];
 		}
 	}
 }
@@ -22,6 +22,11 @@
 
 #include "occupancygrid.h"
 
+#include <core/exceptions/system.h>
+
+#include <algorithm>
+#include <cstdlib>
+
 namespace fawkes {
 
 /** @class OccupancyGrid <plugins/colli/utils/occupancygrid/occupancygrid.h>
@@ -29,8 +34,18 @@ namespace fawkes {
  * exist, which are usually used instead of this general class.
  * Note: the coord system is assumed to map x onto width an y onto
  * height, with x being the first coordinate !
+ *
+ * The cells are stored in a single buffer aligned to cache lines. The
+ * cells of a column are stored consecutively, and each column starts on
+ * a cache line of its own, cf. get_index() and get_stride().
  */
 
+/// @cond INTERNALS
+// cells are aligned to and columns padded to cache lines
+static const size_t CELL_ALIGNMENT = 64;
+static const int    COLUMN_PADDING = CELL_ALIGNMENT / sizeof(Probability);
+/// @endcond
+
 /** Constructs an empty occupancy grid
  *
  * @param width the width of the grid in # of cells
@@ -39,6 +54,7 @@ namespace fawkes {
  * @param cell_height the cell height in cm
  */
 OccupancyGrid::OccupancyGrid(int width, int height, int cell_width, int cell_height)
+: occupancy_probs_(NULL)
 {
 	width_       = width;
 	height_      = height;
@@ -51,7 +67,7 @@ OccupancyGrid::OccupancyGrid(int width, int height, int cell_width, int cell_hei
 /** Destructor */
 OccupancyGrid::~OccupancyGrid()
 {
-	occupancy_probs_.clear();
+	free(occupancy_probs_);
 }
 
 /** Get the cell width
@@ -137,7 +153,7 @@ void
 OccupancyGrid::set_prob(int x, int y, Probability prob)
 {
 	if ((x < width_) && (y < height_) && ((isProb(prob)) || (prob == 2.f)))
-		occupancy_probs_[x][y] = prob;
+		occupancy_probs_[x * stride_ + y] = prob;
 }
 
 /** Resets all occupancy probabilities
@@ -147,48 +163,26 @@ void
 OccupancyGrid::fill(Probability prob)
 {
 	if ((isProb(prob)) || (prob == -1.f)) {
-		for (int x = 0; x < width_; x++) {
-			for (int y = 0; y < height_; y++) {
-				occupancy_probs_[x][y] = prob;
-			}
-		}
-	}
-}
-
-/** Get the occupancy probability of a cell
- * @param x the x-position of the cell
- * @param y the y-position of the cell
- * @return the occupancy probability of cell (x,y)
- */
-Probability
-OccupancyGrid::get_prob(int x, int y)
-{
-	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
-		return occupancy_probs_[x][y];
-	} else {
-		return 1;
+		// padding cells are never read, fill them as well to keep this a single pass
+		std::fill(occupancy_probs_, occupancy_probs_ + width_ * stride_, prob);
 	}
 }
 
-/** Operator (), get occupancy probability of a cell
- * @param x the x-position of the cell
- * @param y the y-position of the cell
- * @return the occupancy probability of cell (x,y)
- */
-Probability &
-OccupancyGrid::operator()(const int x, const int y)
-{
-	return occupancy_probs_[x][y];
-}
-
 /** Init a new empty grid with the predefined parameters */
 void
 OccupancyGrid::init_grid()
 {
-	occupancy_probs_.clear();
-	std::vector<Probability> column;
-	column.resize(height_, 0.f);
-	occupancy_probs_.resize(width_, column);
+	free(occupancy_probs_);
+	occupancy_probs_ = NULL;
+
+	stride_ = ((height_ + COLUMN_PADDING - 1) / COLUMN_PADDING) * COLUMN_PADDING;
+
+	void * cells;
+	size_t size = (size_t)std::max(width_ * stride_, 1) * sizeof(Probability);
+	if (posix_memalign(&cells, CELL_ALIGNMENT, size) != 0) {
+		throw OutOfMemoryException("OccupancyGrid: cannot allocate %i x %i cells", width_, height_);
+	}
+	occupancy_probs_ = (Probability *)cells;
 	fill(0.f);
 }
 
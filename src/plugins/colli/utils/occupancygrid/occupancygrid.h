@@ -25,8 +25,6 @@
 
 #include "probability.h"
 
-#include <vector>
-
 namespace fawkes {
 
 /** Occupancy threshold. */
@@ -38,6 +36,9 @@ public:
 	OccupancyGrid(int width, int height, int cell_width = 5, int cell_height = 5);
 	virtual ~OccupancyGrid();
 
+	OccupancyGrid(const OccupancyGrid &) = delete;
+	OccupancyGrid &operator=(const OccupancyGrid &) = delete;
+
 	///\brief Get the cell width (in cm)
 	int get_cell_width();
 
@@ -74,19 +75,93 @@ public:
 	///\brief Get the occupancy probability of a cell
 	Probability &operator()(const int x, const int y);
 
+	///\brief Get the index of a cell in the cell buffer
+	int get_index(int x, int y);
+
+	///\brief Get the distance of neighbouring columns in the cell buffer
+	int get_stride();
+
+	///\brief Get the occupancy probability of a cell by its index
+	Probability get_prob(int index);
+
 	///\brief Init a new empty grid with the predefined parameters */
 	void init_grid();
 
-	/// The occupancy probability of the cells in a 2D array
-	std::vector<std::vector<Probability>> occupancy_probs_;
-
 protected:
+	/** The occupancy probability of the cells. The cells of a column
+	 * (same x) are stored consecutively, columns are stride_ cells apart. */
+	Probability *occupancy_probs_;
+
 	int cell_width_;  /**< Cell width in cm */
 	int cell_height_; /**< Cell height in cm */
 	int width_;       /**< Width of the grid in # cells */
 	int height_;      /**< Height of the grid in # cells */
+	int stride_;      /**< Distance of neighbouring columns in # cells */
 };
 
+/* ************************************************************************** */
+/* ***********************  IMPLEMENTATION DETAILS  ************************* */
+/* ************************************************************************** */
+
+/** Get the occupancy probability of a cell
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @return the occupancy probability of cell (x,y), 1 for cells outside of the grid
+ */
+inline Probability
+OccupancyGrid::get_prob(int x, int y)
+{
+	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
+		return occupancy_probs_[x * stride_ + y];
+	} else {
+		return 1;
+	}
+}
+
+/** Operator (), get occupancy probability of a cell
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @return the occupancy probability of cell (x,y)
+ */
+inline Probability &
+OccupancyGrid::operator()(const int x, const int y)
+{
+	return occupancy_probs_[x * stride_ + y];
+}
+
+/** Get the index of a cell in the cell buffer.
+ * Neighbouring cells in y direction have consecutive indexes.
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @return index of cell (x,y)
+ */
+inline int
+OccupancyGrid::get_index(int x, int y)
+{
+	return x * stride_ + y;
+}
+
+/** Get the distance of neighbouring columns in the cell buffer.
+ * Cell (x+1,y) has an index stride larger than cell (x,y).
+ * @return the stride in # of cells
+ */
+inline int
+OccupancyGrid::get_stride()
+{
+	return stride_;
+}
+
+/** Get the occupancy probability of a cell by its index.
+ * The index is not checked, cf. get_index().
+ * @param index index of the cell
+ * @return the occupancy probability of the cell
+ */
+inline Probability
+OccupancyGrid::get_prob(int index)
+{
+	return occupancy_probs_[index];
+}
+
 } // namespace fawkes
 
 #endif
@@ -0,0 +1,198 @@
+/***************************************************************************
+ *  loop-profiler-thread.cpp - Publish the main loop profile
+ *
+ *  Created: Mon Oct 19 12:04:26 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "loop-profiler-thread.h"
+
+#include <interfaces/LoopProfileInterface.h>
+#include <utils/time/latency_histogram.h>
+#include <utils/time/wait.h>
+
+#include <cmath>
+#include <list>
+
+using namespace fawkes;
+
+#define CFG_PREFIX "/fawkes/loop-profiler/"
+#define MAIN_LOOP_ID "Main Loop"
+#define THREAD_ID_PREFIX "Thread "
+
+/** @class LoopProfilerThread "loop-profiler-thread.h"
+ * Publish the main loop profile to the blackboard.
+ * Periodically copies the statistics of the always-on main loop profiler
+ * into one LoopProfileInterface for the main loop and one per thread
+ * with the BlockedTimingAspect. The thread runs continuously and does
+ * not take part in the main loop it profiles.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+LoopProfilerThread::LoopProfilerThread() : Thread("LoopProfilerThread", Thread::OPMODE_CONTINUOUS)
+{
+	time_wait_ = NULL;
+	main_if_   = NULL;
+}
+
+/** Destructor. */
+LoopProfilerThread::~LoopProfilerThread()
+{
+}
+
+void
+LoopProfilerThread::init()
+{
+	float interval = 1.0;
+	try {
+		interval = config->get_float(CFG_PREFIX "interval");
+	} catch (Exception &e) {
+	} // ignored, use default
+	if (interval <= 0.) {
+		throw Exception("Invalid publishing interval %f sec", interval);
+	}
+
+	budget_usec_ = 0;
+	try {
+		budget_usec_ = config->get_uint("/fawkes/mainapp/desired_loop_time");
+	} catch (Exception &e) {
+	} // ignored, no budget
+
+	main_if_   = blackboard->open_for_writing<LoopProfileInterface>(MAIN_LOOP_ID);
+	time_wait_ = new TimeWait(clock, (long int)roundf(interval * 1000000.));
+}
+
+void
+LoopProfilerThread::finalize()
+{
+	for (std::map<std::string, LoopProfileInterface *>::iterator i = thread_ifs_.begin();
+	     i != thread_ifs_.end();
+	     ++i) {
+		blackboard->close(i->second);
+	}
+	thread_ifs_.clear();
+	blackboard->close(main_if_);
+	delete time_wait_;
+}
+
+void
+LoopProfilerThread::loop()
+{
+	time_wait_->mark_start();
+
+	while (!main_if_->msgq_empty()) {
+		if (main_if_->msgq_first_is<LoopProfileInterface::ResetMessage>()) {
+			logger->log_info(name(), "Resetting main loop profile");
+			blocked_timing_profiler->reset();
+		}
+		main_if_->msgq_pop();
+	}
+
+	publish();
+
+	time_wait_->wait_systime();
+}
+
+/** Convert histogram to interface durations.
+ * @param histogram histogram with values in usec
+ * @param values array of four values to fill with mean, median,
+ * 99th percentile, and maximum in ms
+ */
+void
+LoopProfilerThread::durations(const LatencyHistogram &histogram, float *values)
+{
+	values[0] = histogram.mean() / 1000.;
+	values[1] = histogram.percentile(50.) / 1000.;
+	values[2] = histogram.percentile(99.) / 1000.;
+	values[3] = histogram.max() / 1000.;
+}
+
+void
+LoopProfilerThread::publish()
+{
+	float values[4];
+
+	LatencyHistogram cycle_time = blocked_timing_profiler->cycle_time();
+	durations(cycle_time, values);
+	main_if_->set_cycles(cycle_time.count());
+	main_if_->set_budget(budget_usec_ / 1000.);
+	main_if_->set_overruns(budget_usec_ > 0 ? cycle_time.count_above(budget_usec_) : 0);
+	main_if_->set_loop_time(values);
+	for (unsigned int i = 0; i < BlockedTimingProfiler::NUM_HOOKS; ++i) {
+		LatencyHistogram hook_time =
+		  blocked_timing_profiler->hook_time((BlockedTimingAspect::WakeupHook)i);
+		main_if_->set_hook_time(i, hook_time.percentile(99.) / 1000.);
+	}
+
+	std::list<BlockedTimingProfiler::CycleTrace> worst = blocked_timing_profiler->worst_cycles();
+	if (!worst.empty()) {
+		main_if_->set_worst_cycle_time(worst.front().cycle_usec / 1000.);
+		main_if_->set_worst_cycle_thread(
+		  worst.front().threads.empty() ? "" : worst.front().threads.front().thread.c_str());
+	} else {
+		main_if_->set_worst_cycle_time(0.);
+		main_if_->set_worst_cycle_thread("");
+	}
+	main_if_->write();
+
+	std::map<std::string, LoopProfileInterface *> old_ifs;
+	old_ifs.swap(thread_ifs_);
+
+	std::list<BlockedTimingThreadProfile> profiles = blocked_timing_profiler->thread_profiles();
+	for (std::list<BlockedTimingThreadProfile>::iterator p = profiles.begin(); p != profiles.end();
+	     ++p) {
+		std::string id = std::string(THREAD_ID_PREFIX + p->name()).substr(0, INTERFACE_ID_SIZE_ - 1);
+
+		LoopProfileInterface *iface;
+		if (old_ifs.find(id) != old_ifs.end()) {
+			iface = old_ifs[id];
+			old_ifs.erase(id);
+		} else if (thread_ifs_.find(id) != thread_ifs_.end()) {
+			// truncated name clashes with another thread's
+			continue;
+		} else {
+			try {
+				iface = blackboard->open_for_writing<LoopProfileInterface>(id.c_str());
+			} catch (Exception &e) {
+				logger->log_warn(name(), "Failed to open profile interface for %s", p->name().c_str());
+				logger->log_warn(name(), e);
+				continue;
+			}
+		}
+		thread_ifs_[id] = iface;
+
+		iface->set_hook(BlockedTimingAspect::blocked_timing_hook_to_string(p->hook()));
+		iface->set_cycles(p->loop_time().count());
+		iface->set_budget(budget_usec_ / 1000.);
+		iface->set_overruns(budget_usec_ > 0 ? p->loop_time().count_above(budget_usec_) : 0);
+		durations(p->loop_time(), values);
+		iface->set_loop_time(values);
+		durations(p->wake_latency(), values);
+		iface->set_wake_latency(values);
+		durations(p->barrier_wait(), values);
+		iface->set_barrier_wait(values);
+		iface->write();
+	}
+
+	// threads which have been removed
+	for (std::map<std::string, LoopProfileInterface *>::iterator i = old_ifs.begin();
+	     i != old_ifs.end();
+	     ++i) {
+		blackboard->close(i->second);
+	}
+}
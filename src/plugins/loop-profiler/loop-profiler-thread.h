@@ -0,0 +1,76 @@
+/***************************************************************************
+ *  loop-profiler-thread.h - Publish the main loop profile
+ *
+ *  Created: Mon Oct 19 12:04:26 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_LOOP_PROFILER_LOOP_PROFILER_THREAD_H_
+#define _PLUGINS_LOOP_PROFILER_LOOP_PROFILER_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/blocked_timing_profiler.h>
+#include <aspect/clock.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <core/threading/thread.h>
+
+#include <map>
+#include <string>
+
+namespace fawkes {
+class LatencyHistogram;
+class LoopProfileInterface;
+class TimeWait;
+} // namespace fawkes
+
+class LoopProfilerThread : public fawkes::Thread,
+                           public fawkes::LoggingAspect,
+                           public fawkes::ConfigurableAspect,
+                           public fawkes::ClockAspect,
+                           public fawkes::BlackBoardAspect,
+                           public fawkes::BlockedTimingProfilerAspect
+{
+public:
+	LoopProfilerThread();
+	virtual ~LoopProfilerThread();
+
+	virtual void init();
+	virtual void loop();
+	virtual void finalize();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void        publish();
+	static void durations(const fawkes::LatencyHistogram &histogram, float *values);
+
+private:
+	fawkes::TimeWait *time_wait_;
+	unsigned int      budget_usec_;
+
+	fawkes::LoopProfileInterface *                        main_if_;
+	std::map<std::string, fawkes::LoopProfileInterface *> thread_ifs_;
+};
+
+#endif
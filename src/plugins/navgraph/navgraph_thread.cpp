@@ -23,6 +23,7 @@
 
 #include <core/utils/lockptr.h>
 #include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/incremental_search.h>
 #include <navgraph/yaml_navgraph.h>
 #include <tf/utils.h>
 #include <utils/math/angle.h>
@@ -97,6 +98,12 @@ NavGraphThread::init()
 	} catch (Exception &e) {
 	} // ignored
 
+	cfg_incremental_replanning_ = false;
+	try {
+		cfg_incremental_replanning_ = config->get_bool("/navgraph/incremental_replanning");
+	} catch (Exception &e) {
+	} // ignored
+
 	cfg_enable_path_execution_ = true;
 	try {
 		cfg_enable_path_execution_ = config->get_bool("/navgraph/path_execution");
@@ -155,6 +162,10 @@ NavGraphThread::init()
 	}
 
 	navgraph_aspect_inifin_.set_navgraph(graph_);
+	incremental_search_ = NULL;
+	if (cfg_incremental_replanning_) {
+		incremental_search_ = new NavGraphIncrementalSearch(*graph_);
+	}
 	if (cfg_log_graph_) {
 		log_graph();
 	}
@@ -206,6 +217,7 @@ NavGraphThread::finalize()
 		graph_->remove_change_listener(vt_);
 	}
 #endif
+	delete incremental_search_;
 	graph_.clear();
 	if (cfg_enable_path_execution_) {
 		blackboard->close(pp_nav_if_);
@@ -599,10 +611,24 @@ NavGraphThread::replan(const NavGraphNode &start, const NavGraphNode &goal)
 		act_goal      = close_to_goal;
 	}
 
-	NavGraphPath new_path = graph_->search_path(start,
-	                                            act_goal,
-	                                            /* use constraints */ true,
-	                                            /* compute constraints */ false);
+	NavGraphPath new_path;
+	if (incremental_search_) {
+		new_path = incremental_search_->search_path(start,
+		                                            act_goal,
+		                                            /* use constraints */ true,
+		                                            /* compute constraints */ false);
+		logger->log_debug(name(),
+		                  "Re-planning took %.2f ms (%s, %u changed arcs, %u expansions)",
+		                  incremental_search_->last_duration() * 1000.,
+		                  incremental_search_->last_full_search() ? "full" : "incremental",
+		                  incremental_search_->last_changed_arcs(),
+		                  incremental_search_->last_expansions());
+	} else {
+		new_path = graph_->search_path(start,
+		                               act_goal,
+		                               /* use constraints */ true,
+		                               /* compute constraints */ false);
+	}
 
 	if (!new_path.empty()) {
 		// get cost of current plan
@@ -42,6 +42,7 @@
 
 namespace fawkes {
 class Time;
+class NavGraphIncrementalSearch;
 }
 
 class NavGraphThread : public fawkes::Thread,
@@ -113,12 +114,14 @@ private:
 	bool  cfg_abort_on_error_;
 	bool  cfg_enable_path_execution_;
 	bool  cfg_allow_multi_graph_;
+	bool  cfg_incremental_replanning_;
 
 	fawkes::NavigatorInterface *nav_if_;
 	fawkes::NavigatorInterface *pp_nav_if_;
 	fawkes::NavPathInterface *  path_if_;
 
 	fawkes::LockPtr<fawkes::NavGraph> graph_;
+	fawkes::NavGraphIncrementalSearch *incremental_search_;
 
 	fawkes::tf::Stamped<fawkes::tf::Pose> pose_;
 	bool                                  exec_active_;
@@ -35,6 +35,7 @@
 #endif
 #include <fvcams/shmem.h>
 #include <fvutils/color/conversions.h>
+#include <fvutils/color/fused_converter.h>
 #include <interfaces/SwitchInterface.h>
 #include <logging/logger.h>
 
@@ -47,6 +48,12 @@
 #include <cstring>
 #include <string>
 
+// Number of images kept in each shared memory image buffer. Vision
+// threads copying the image do not block the acquisition thread.
+#ifndef FVBASE_SHM_IMAGE_SLOTS
+#	define FVBASE_SHM_IMAGE_SLOTS 3
+#endif
+
 using namespace fawkes;
 using namespace firevision;
 
@@ -90,14 +97,17 @@ FvAcquisitionThread::FvAcquisitionThread(const char *id,
 	mode_    = AqtContinuous;
 	enabled_ = false;
 
+	converter_ = new FusedConverter(colorspace_, width_, height_);
+
 #ifdef FVBASE_TIMETRACKER
-	tt_          = new TimeTracker();
-	loop_count_  = 0;
-	ttc_capture_ = tt_->add_class("Capture");
-	ttc_lock_    = tt_->add_class("Lock");
-	ttc_convert_ = tt_->add_class("Convert");
-	ttc_unlock_  = tt_->add_class("Unlock");
-	ttc_dispose_ = tt_->add_class("Dispose");
+	tt_                = new TimeTracker();
+	loop_count_        = 0;
+	ttc_capture_       = tt_->add_class("Capture");
+	ttc_lock_          = tt_->add_class("Lock");
+	ttc_convert_       = tt_->add_class("Convert");
+	ttc_convert_fused_ = tt_->add_class("Convert (fused)");
+	ttc_unlock_        = tt_->add_class("Unlock");
+	ttc_dispose_       = tt_->add_class("Dispose");
 #endif
 }
 
@@ -111,6 +121,7 @@ FvAcquisitionThread::~FvAcquisitionThread()
 	}
 	shm_.clear();
 
+	delete converter_;
 	delete vision_threads;
 	delete camera_;
 	free(image_id_);
@@ -192,7 +203,8 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 				throw OutOfMemoryException("FvAcqThread::camera_instance(): Could not create image ID");
 			}
 			img_id       = tmp;
-			shm_[cspace] = new SharedMemoryImageBuffer(img_id, cspace, width_, height_);
+			shm_[cspace] =
+			  new SharedMemoryImageBuffer(img_id, cspace, width_, height_, FVBASE_SHM_IMAGE_SLOTS);
 		} else {
 			img_id = shm_[cspace]->image_id();
 		}
@@ -264,6 +276,28 @@ FvAcquisitionThread::set_enabled(bool enabled)
 	enabled_ = enabled;
 }
 
+/** Set how images are converted to the requested colorspaces.
+ * With fused conversion, the camera image is converted to all requested
+ * colorspaces in a single pass over horizontal stripes of the image, which
+ * reads the camera image from memory only once. Otherwise, the image is
+ * converted to one colorspace after the other.
+ * Note that this may only be called on a stopped thread.
+ * @param fused true to enable fused conversion
+ * @param parallel true to convert stripes in parallel, only has an effect
+ * with fused conversion and if built with OpenMP support
+ * @see FusedConverter
+ */
+void
+FvAcquisitionThread::set_conversion_mode(bool fused, bool parallel)
+{
+	delete converter_;
+	converter_ = NULL;
+	if (fused) {
+		converter_ = new FusedConverter(colorspace_, width_, height_);
+		converter_->set_parallel(parallel);
+	}
+}
+
 /** Get acquisition thread mode.
  * @return acquisition thread mode.
  */
@@ -319,26 +353,8 @@ FvAcquisitionThread::loop()
 			tt_->ping_start(ttc_capture_);
 			camera_->capture();
 			tt_->ping_end(ttc_capture_);
-
-			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
-					continue;
-				tt_->ping_start(ttc_lock_);
-				shmit_->second->lock_for_write();
-				tt_->ping_end(ttc_lock_);
-				tt_->ping_start(ttc_convert_);
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
-				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
-				} catch (NotImplementedException &e) {
-					// ignored
-				}
-				tt_->ping_end(ttc_convert_);
-				tt_->ping_start(ttc_unlock_);
-				shmit_->second->unlock();
-				tt_->ping_end(ttc_unlock_);
-			}
+			Time *capture_time = camera_capture_time();
+			convert_images(capture_time);
 		}
 	} catch (Exception &e) {
 		logger->log_error(name(), "Cannot convert image data");
@@ -358,19 +374,8 @@ FvAcquisitionThread::loop()
 	try {
 		if (enabled_) {
 			camera_->capture();
-			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
-					continue;
-				shmit_->second->lock_for_write();
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
-				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
-				} catch (NotImplementedException &e) {
-					// ignored
-				}
-				shmit_->second->unlock();
-			}
+			Time *capture_time = camera_capture_time();
+			convert_images(capture_time);
 		}
 	} catch (Exception &e) {
 		logger->log_error(name(), e);
@@ -393,6 +398,84 @@ FvAcquisitionThread::loop()
 	}
 }
 
+/** Convert current camera image to all shared memory image buffers.
+ * @param capture_time capture time of the image, may be NULL
+ */
+void
+FvAcquisitionThread::convert_images(Time *capture_time)
+{
+	conv_to_.clear();
+	conv_dst_.clear();
+	conv_shm_.clear();
+	for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
+		if (shmit_->first == CS_UNKNOWN)
+			continue;
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_start(ttc_lock_);
+#endif
+		conv_dst_.push_back(shmit_->second->begin_write());
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_end(ttc_lock_);
+#endif
+		conv_to_.push_back(shmit_->first);
+		conv_shm_.push_back(shmit_->second);
+	}
+	if (conv_to_.empty())
+		return;
+
+	try {
+		if (converter_) {
+#ifdef FVBASE_TIMETRACKER
+			tt_->ping_start(ttc_convert_fused_);
+#endif
+			converter_->convert(camera_->buffer(), conv_to_.size(), &conv_to_[0], &conv_dst_[0]);
+#ifdef FVBASE_TIMETRACKER
+			tt_->ping_end(ttc_convert_fused_);
+#endif
+		} else {
+			for (size_t i = 0; i < conv_to_.size(); ++i) {
+#ifdef FVBASE_TIMETRACKER
+				tt_->ping_start(ttc_convert_);
+#endif
+				convert(colorspace_, conv_to_[i], camera_->buffer(), conv_dst_[i], width_, height_);
+#ifdef FVBASE_TIMETRACKER
+				tt_->ping_end(ttc_convert_);
+#endif
+			}
+		}
+	} catch (Exception &e) {
+		// do not leave buffers locked for writing
+		for (size_t i = 0; i < conv_shm_.size(); ++i) {
+			conv_shm_[i]->end_write(capture_time);
+		}
+		throw;
+	}
+
+	for (size_t i = 0; i < conv_shm_.size(); ++i) {
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_start(ttc_unlock_);
+#endif
+		conv_shm_[i]->end_write(capture_time);
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_end(ttc_unlock_);
+#endif
+	}
+}
+
+/** Get capture time of the current image.
+ * @return capture time of the camera, NULL if the camera does not
+ * provide capture times
+ */
+Time *
+FvAcquisitionThread::camera_capture_time()
+{
+	try {
+		return camera_->capture_time();
+	} catch (NotImplementedException &e) {
+		return NULL;
+	}
+}
+
 bool
 FvAcquisitionThread::bb_interface_message_received(Interface *interface, Message *message) throw()
 {
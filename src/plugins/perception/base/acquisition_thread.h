@@ -31,6 +31,7 @@
 #include <fvutils/color/colorspaces.h>
 
 #include <map>
+#include <vector>
 
 namespace fawkes {
 class Logger;
@@ -38,13 +39,15 @@ class Clock;
 class Mutex;
 class WaitCondition;
 class SwitchInterface;
+class Time;
 #ifdef FVBASE_TIMETRACKER
 class TimeTracker;
 #endif
 } // namespace fawkes
 namespace firevision {
 class SharedMemoryImageBuffer;
-}
+class FusedConverter;
+} // namespace firevision
 class FvBaseThread;
 class FvAqtVisionThreads;
 
@@ -80,6 +83,7 @@ public:
 
 	void set_vt_prepfin_hold(bool hold);
 	void set_enabled(bool enabled);
+	void set_conversion_mode(bool fused, bool parallel);
 
 public:
 	/** Vision threads assigned to this acquisition thread. To be used only by the
@@ -101,6 +105,9 @@ private:
 	virtual bool bb_interface_message_received(fawkes::Interface *interface,
 	                                           fawkes::Message *  message) throw();
 
+	fawkes::Time *camera_capture_time();
+	void          convert_images(fawkes::Time *capture_time);
+
 private:
 	bool                   enabled_;
 	fawkes::Mutex *        enabled_mutex_;
@@ -120,12 +127,18 @@ private:
 
 	fawkes::SwitchInterface *enabled_if_;
 
+	firevision::FusedConverter *                       converter_;
+	std::vector<firevision::colorspace_t>              conv_to_;
+	std::vector<unsigned char *>                       conv_dst_;
+	std::vector<firevision::SharedMemoryImageBuffer *> conv_shm_;
+
 #ifdef FVBASE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         loop_count_;
 	unsigned int         ttc_capture_;
 	unsigned int         ttc_lock_;
 	unsigned int         ttc_convert_;
+	unsigned int         ttc_convert_fused_;
 	unsigned int         ttc_unlock_;
 	unsigned int         ttc_dispose_;
 #endif
@@ -75,6 +75,10 @@ FvBaseThread::init()
 	// that are orphaned
 	SharedMemoryImageBuffer::cleanup(/* use lister */ false);
 	SharedMemoryLookupTable::cleanup(/* use lister */ false);
+
+	cfg_fused_conversion_ = config->get_bool_or_default("/firevision/base/fused_conversion", true);
+	cfg_parallel_conversion_ =
+	  config->get_bool_or_default("/firevision/base/parallel_conversion", false);
 }
 
 void
@@ -256,6 +260,7 @@ FvBaseThread::register_for_camera(const char *camera_string, Thread *thread, col
 			}
 
 			FvAcquisitionThread *aqt = new FvAcquisitionThread(id.c_str(), cam, logger, clock);
+			aqt->set_conversion_mode(cfg_fused_conversion_, cfg_parallel_conversion_);
 
 			c = aqt->camera_instance(cspace,
 			                         (vision_thread->vision_thread_mode() == VisionAspect::CONTINUOUS));
@@ -96,6 +96,8 @@ private:
 	fawkes::LockMap<std::string, FvAcquisitionThread *>           aqts_;
 	fawkes::LockMap<std::string, FvAcquisitionThread *>::iterator ait_;
 	unsigned int                                                  aqt_timeout_;
+	bool                                                          cfg_fused_conversion_;
+	bool                                                          cfg_parallel_conversion_;
 
 	fawkes::LockList<firevision::CameraControl *>    owned_controls_;
 	fawkes::LockMap<Thread *, FvAcquisitionThread *> started_threads_;
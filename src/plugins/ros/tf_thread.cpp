@@ -92,11 +92,19 @@ RosTfThread::init()
 		bbil_add_reader_interface(*i);
 		bbil_add_writer_interface(*i);
 	}
+	tfbifs_ = blackboard->open_multiple_for_reading<TransformBatchInterface>("/tf*");
+	std::list<TransformBatchInterface *>::iterator b;
+	for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+		bbil_add_data_interface(*b);
+		bbil_add_reader_interface(*b);
+		bbil_add_writer_interface(*b);
+	}
 	blackboard->register_listener(this);
 
 	publish_static_transforms_to_ros();
 
 	bbio_add_observed_create("TransformInterface", "/tf*");
+	bbio_add_observed_create("TransformBatchInterface", "/tf*");
 	blackboard->register_observer(this);
 }
 
@@ -114,6 +122,12 @@ RosTfThread::finalize()
 		blackboard->close(*i);
 	}
 	tfifs_.clear();
+
+	std::list<TransformBatchInterface *>::iterator b;
+	for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+		blackboard->close(*b);
+	}
+	tfbifs_.clear();
 }
 
 void
@@ -165,6 +179,32 @@ RosTfThread::loop()
 void
 RosTfThread::bb_interface_data_changed(fawkes::Interface *interface) throw()
 {
+	TransformBatchInterface *tfbif = dynamic_cast<TransformBatchInterface *>(interface);
+	if (tfbif) {
+		tfbif->read();
+		if (tfbif->is_static_transforms()) {
+			if (cfg_use_tf2_) {
+				publish_static_transforms_to_ros();
+			} else {
+				fawkes::Time    timestamp = fawkes::Time(clock) + (cfg_update_interval_ * 1.1);
+				::tf::tfMessage tmsg;
+				append_transforms_stamped(tfbif, tmsg.transforms, &timestamp);
+				pub_tf_.publish(tmsg);
+			}
+		} else if (cfg_use_tf2_) {
+#ifdef HAVE_TF2_MSGS
+			tf2_msgs::TFMessage tmsg;
+			append_transforms_stamped(tfbif, tmsg.transforms);
+			pub_tf_.publish(tmsg);
+#endif
+		} else {
+			::tf::tfMessage tmsg;
+			append_transforms_stamped(tfbif, tmsg.transforms);
+			pub_tf_.publish(tmsg);
+		}
+		return;
+	}
+
 	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
 	if (!tfif)
 		return;
@@ -199,19 +239,29 @@ RosTfThread::bb_interface_data_changed(fawkes::Interface *interface) throw()
 void
 RosTfThread::bb_interface_created(const char *type, const char *id) throw()
 {
-	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) != 0)
-		return;
+	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) == 0) {
+		open_created(type, id, tfifs_);
+	} else if (strncmp(type, "TransformBatchInterface", INTERFACE_TYPE_SIZE_) == 0) {
+		open_created(type, id, tfbifs_);
+	}
+}
 
+template <class InterfaceType>
+void
+RosTfThread::open_created(const char *                type,
+                          const char *                id,
+                          std::list<InterfaceType *> &ifaces) throw()
+{
 	for (const auto &f : ros_frames_) {
 		// ignore interfaces that we publish ourself
 		if (f == id)
 			return;
 	}
 
-	TransformInterface *tfif;
+	InterfaceType *tfif;
 	try {
 		//logger->log_info(name(), "Opening %s:%s", type, id);
-		tfif = blackboard->open_for_reading<TransformInterface>(id);
+		tfif = blackboard->open_for_reading<InterfaceType>(id);
 	} catch (Exception &e) {
 		// ignored
 		logger->log_warn(name(), "Failed to open %s:%s: %s", type, id, e.what());
@@ -223,7 +273,7 @@ RosTfThread::bb_interface_created(const char *type, const char *id) throw()
 		bbil_add_reader_interface(tfif);
 		bbil_add_writer_interface(tfif);
 		blackboard->update_listener(this);
-		tfifs_.push_back(tfif);
+		ifaces.push_back(tfif);
 	} catch (Exception &e) {
 		blackboard->close(tfif);
 		logger->log_warn(name(), "Failed to register for %s:%s: %s", type, id, e.what());
@@ -248,13 +298,20 @@ RosTfThread::bb_interface_reader_removed(fawkes::Interface *interface,
 void
 RosTfThread::conditional_close(Interface *interface) throw()
 {
-	// Verify it's a TransformInterface
-	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
-		return;
+	// Verify it's one of our interfaces
+	if (dynamic_cast<TransformInterface *>(interface)) {
+		conditional_close(interface, tfifs_);
+	} else if (dynamic_cast<TransformBatchInterface *>(interface)) {
+		conditional_close(interface, tfbifs_);
+	}
+}
 
-	std::list<TransformInterface *>::iterator i;
-	for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
+template <class InterfaceType>
+void
+RosTfThread::conditional_close(Interface *interface, std::list<InterfaceType *> &ifaces) throw()
+{
+	typename std::list<InterfaceType *>::iterator i;
+	for (i = ifaces.begin(); i != ifaces.end(); ++i) {
 		if (*interface == **i) {
 			if (!interface->has_writer() && (interface->num_readers() == 1)) {
 				// It's only us
@@ -264,7 +321,7 @@ RosTfThread::conditional_close(Interface *interface) throw()
 				bbil_remove_writer_interface(*i);
 				blackboard->update_listener(this);
 				blackboard->close(*i);
-				tfifs_.erase(i);
+				ifaces.erase(i);
 				break;
 			}
 		}
@@ -304,11 +361,59 @@ RosTfThread::create_transform_stamped(TransformInterface *tfif, const Time *time
 	return ts;
 }
 
+void
+RosTfThread::append_transforms_stamped(TransformBatchInterface *                     tfbif,
+                                       std::vector<geometry_msgs::TransformStamped> &transforms,
+                                       const Time *                                  time)
+{
+	unsigned int num_transforms = tfbif->num_transforms();
+	if (num_transforms > TransformBatchInterface::MAX_TRANSFORMS) {
+		num_transforms = TransformBatchInterface::MAX_TRANSFORMS;
+	}
+
+	const char *   frames       = tfbif->frames();
+	const char *   child_frames = tfbif->child_frames();
+	const int64_t *stamps       = tfbif->stamps();
+	const double * translations = tfbif->translations();
+	const double * rotations    = tfbif->rotations();
+
+	for (unsigned int i = 0; i < num_transforms; ++i) {
+		const char *frame_end       = strchr(frames, '\n');
+		const char *child_frame_end = strchr(child_frames, '\n');
+		if (!frame_end || !child_frame_end)
+			break;
+
+		geometry_msgs::TransformStamped ts;
+		seq_num_mutex_->lock();
+		ts.header.seq = ++seq_num_;
+		seq_num_mutex_->unlock();
+		if (time) {
+			ts.header.stamp = ros::Time(time->get_sec(), time->get_nsec());
+		} else {
+			ts.header.stamp = ros::Time(stamps[i] / 1000000, (stamps[i] % 1000000) * 1000);
+		}
+		ts.header.frame_id         = std::string(frames, frame_end);
+		ts.child_frame_id          = std::string(child_frames, child_frame_end);
+		ts.transform.translation.x = translations[i * 3];
+		ts.transform.translation.y = translations[i * 3 + 1];
+		ts.transform.translation.z = translations[i * 3 + 2];
+		ts.transform.rotation.x    = rotations[i * 4];
+		ts.transform.rotation.y    = rotations[i * 4 + 1];
+		ts.transform.rotation.z    = rotations[i * 4 + 2];
+		ts.transform.rotation.w    = rotations[i * 4 + 3];
+		transforms.push_back(ts);
+
+		frames       = frame_end + 1;
+		child_frames = child_frame_end + 1;
+	}
+}
+
 void
 RosTfThread::publish_static_transforms_to_ros()
 {
-	std::list<fawkes::TransformInterface *>::iterator t;
-	fawkes::Time                                      now(clock);
+	std::list<fawkes::TransformInterface *>::iterator      t;
+	std::list<fawkes::TransformBatchInterface *>::iterator b;
+	fawkes::Time                                           now(clock);
 
 	if (cfg_use_tf2_) {
 #ifdef HAVE_TF2_MSGS
@@ -320,6 +425,12 @@ RosTfThread::publish_static_transforms_to_ros()
 				tmsg.transforms.push_back(create_transform_stamped(tfif, &now));
 			}
 		}
+		for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+			(*b)->read();
+			if ((*b)->is_static_transforms()) {
+				append_transforms_stamped(*b, tmsg.transforms, &now);
+			}
+		}
 		pub_static_tf_.publish(tmsg);
 #endif
 	} else {
@@ -335,6 +446,12 @@ RosTfThread::publish_static_transforms_to_ros()
 				tmsg.transforms.push_back(create_transform_stamped(tfif, &timestamp));
 			}
 		}
+		for (b = tfbifs_.begin(); b != tfbifs_.end(); ++b) {
+			(*b)->read();
+			if ((*b)->is_static_transforms()) {
+				append_transforms_stamped(*b, tmsg.transforms, &timestamp);
+			}
+		}
 		pub_tf_.publish(tmsg);
 	}
 }
@@ -32,11 +32,13 @@
 #include <blackboard/interface_observer.h>
 #include <core/threading/mutex.h>
 #include <core/threading/thread.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <plugins/ros/aspect/ros.h>
 
 #include <list>
 #include <queue>
+#include <vector>
 
 // from ROS
 #include <ros/common.h>
@@ -84,11 +86,18 @@ private:
 #endif
 
 	void conditional_close(fawkes::Interface *interface) throw();
+	template <class InterfaceType>
+	void conditional_close(fawkes::Interface *interface, std::list<InterfaceType *> &ifaces) throw();
+	template <class InterfaceType>
+	void open_created(const char *type, const char *id, std::list<InterfaceType *> &ifaces) throw();
 	void publish_static_transforms_to_ros();
 	void publish_transform_to_fawkes(const geometry_msgs::TransformStamped &ts,
 	                                 bool                                   static_tf = false);
 	geometry_msgs::TransformStamped create_transform_stamped(fawkes::TransformInterface *tfif,
 	                                                         const fawkes::Time *        time = NULL);
+	void append_transforms_stamped(fawkes::TransformBatchInterface *             tfbif,
+	                               std::vector<geometry_msgs::TransformStamped> &transforms,
+	                               const fawkes::Time *                          time = NULL);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -103,7 +112,8 @@ private:
 	float cfg_update_interval_;
 
 	std::list<std::string>                  ros_frames_;
-	std::list<fawkes::TransformInterface *> tfifs_;
+	std::list<fawkes::TransformInterface *>      tfifs_;
+	std::list<fawkes::TransformBatchInterface *> tfbifs_;
 
 	ros::Subscriber sub_tf_;
 	ros::Subscriber sub_static_tf_;
@@ -24,13 +24,10 @@
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <core/threading/wait_condition.h>
-#include <fvcams/shmem.h>
-#include <fvutils/color/conversions.h>
-#include <fvutils/compression/jpeg_compressor.h>
+#include <fvutils/ipc/shm_image.h>
+#include <logging/liblogger.h>
 #include <utils/time/wait.h>
 
-#include <cstdlib>
-
 using namespace firevision;
 
 namespace fawkes {
@@ -40,18 +37,17 @@ namespace fawkes {
  */
 
 /** Constructor.
- * @param data data buffer
- * @param size size in bytes of @p data
+ * @param frame compressed frame, shared with other users of the image cache
  */
-WebviewJpegStreamProducer::Buffer::Buffer(unsigned char *data, size_t size)
-: data_(data), size_(size)
+WebviewJpegStreamProducer::Buffer::Buffer(
+  std::shared_ptr<const firevision::CompressedImageCache::Frame> frame)
+: frame_(frame)
 {
 }
 
 /** Destructor. */
 WebviewJpegStreamProducer::Buffer::~Buffer()
 {
-	free(data_);
 }
 
 /** @class WebviewJpegStreamProducer::Subscriber "jpeg_stream_producer.h"
@@ -72,6 +68,8 @@ WebviewJpegStreamProducer::Subscriber::~Subscriber()
  * This class takes an image ID and some parameters and then creates a stream
  * of JPEG buffers that is either passed to subscribers or can be queried
  * using the wait_for_next_frame() method.
+ * Images are compressed by the process-wide CompressedImageCache, producers
+ * and other clients of the same image and parameters share the result.
  * @author Tim Niemueller
  */
 
@@ -150,15 +148,10 @@ WebviewJpegStreamProducer::wait_for_next_frame()
 void
 WebviewJpegStreamProducer::init()
 {
-	cam_  = new SharedMemoryCamera(image_id_.c_str(), /* deep copy */ false);
-	jpeg_ = new JpegImageCompressor(quality_);
-	jpeg_->set_image_dimensions(cam_->pixel_width(), cam_->pixel_height());
-	jpeg_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
-	if (jpeg_->supports_vflip())
-		jpeg_->set_vflip(vflip_);
-
-	in_buffer_ = malloc_buffer(YUV422_PLANAR, cam_->pixel_width(), cam_->pixel_height());
-	jpeg_->set_image_buffer(YUV422_PLANAR, in_buffer_);
+	if (!SharedMemoryImageBuffer::exists(image_id_.c_str())) {
+		throw Exception("Shared memory image buffer %s does not exist", image_id_.c_str());
+	}
+	image_cache_ = CompressedImageCache::instance();
 
 	long int loop_time = (long int)roundf((1. / fps_) * 1000000.);
 	timewait_          = new TimeWait(clock, loop_time);
@@ -173,23 +166,17 @@ WebviewJpegStreamProducer::loop()
 
 	timewait_->mark_start();
 
-	size_t         size   = jpeg_->recommended_compressed_buffer_size();
-	unsigned char *buffer = (unsigned char *)malloc(size);
-	jpeg_->set_destination_buffer(buffer, size);
-
-	cam_->lock_for_read();
-	cam_->capture();
-	firevision::convert(cam_->colorspace(),
-	                    YUV422_PLANAR,
-	                    cam_->buffer(),
-	                    in_buffer_,
-	                    cam_->pixel_width(),
-	                    cam_->pixel_height());
-	jpeg_->compress();
-	cam_->dispose_buffer();
-	cam_->unlock();
-
-	std::shared_ptr<Buffer> shared_buf = std::make_shared<Buffer>(buffer, jpeg_->compressed_size());
+	std::shared_ptr<Buffer> shared_buf;
+	try {
+		shared_buf = std::make_shared<Buffer>(
+		  image_cache_->get(image_id_.c_str(), CompressedImageCache::FORMAT_JPEG, quality_, vflip_));
+	} catch (Exception &e) {
+		LibLogger::log_warn(name(), "Failed to get image: %s", e.what_no_backtrace());
+		timewait_->wait_systime();
+		wakeup();
+		return;
+	}
+
 	subs_.lock();
 #if (__GNUC__ * 10000 + __GNUC_MINOR__ * 100) > 40600
 	for (auto &s : subs_) {
@@ -217,10 +204,8 @@ WebviewJpegStreamProducer::loop()
 void
 WebviewJpegStreamProducer::finalize()
 {
-	delete jpeg_;
-	delete cam_;
 	delete timewait_;
-	free(in_buffer_);
+	image_cache_.reset();
 }
 
 } // end namespace fawkes
@@ -25,15 +25,11 @@
 #include <aspect/clock.h>
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
+#include <fvutils/compression/compressed_image_cache.h>
 
 #include <memory>
 #include <string>
 
-namespace firevision {
-class SharedMemoryCamera;
-class JpegImageCompressor;
-} // namespace firevision
-
 namespace fawkes {
 
 class TimeWait;
@@ -46,7 +42,7 @@ public:
 	class Buffer
 	{
 	public:
-		Buffer(unsigned char *data, size_t size);
+		Buffer(std::shared_ptr<const firevision::CompressedImageCache::Frame> frame);
 		~Buffer();
 
 		/** Get data buffer.
@@ -54,7 +50,7 @@ public:
 		const unsigned char *
 		data() const
 		{
-			return data_;
+			return frame_->data();
 		}
 
 		/** Get buffer size.
@@ -62,12 +58,11 @@ public:
 		size_t
 		size() const
 		{
-			return size_;
+			return frame_->size();
 		}
 
 	private:
-		unsigned char *data_;
-		size_t         size_;
+		std::shared_ptr<const firevision::CompressedImageCache::Frame> frame_;
 	};
 
 	class Subscriber
@@ -93,17 +88,15 @@ public:
 	virtual void finalize();
 
 private:
-	std::string    image_id_;
-	unsigned int   quality_;
-	float          fps_;
-	bool           vflip_;
-	unsigned char *in_buffer_;
+	std::string  image_id_;
+	unsigned int quality_;
+	float        fps_;
+	bool         vflip_;
 
 	TimeWait *timewait_;
 
-	firevision::SharedMemoryCamera * cam_;
-	fawkes::LockList<Subscriber *>   subs_;
-	firevision::JpegImageCompressor *jpeg_;
+	fawkes::LockList<Subscriber *>                    subs_;
+	std::shared_ptr<firevision::CompressedImageCache> image_cache_;
 
 	std::shared_ptr<Buffer> last_buf_;
 	fawkes::Mutex *         last_buf_mutex_;
@@ -0,0 +1,184 @@
+
+/****************************************************************************
+ *  CycleTrace
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "CycleTrace.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+CycleTrace::CycleTrace()
+{
+}
+
+CycleTrace::CycleTrace(const std::string &json)
+{
+	from_json(json);
+}
+
+CycleTrace::CycleTrace(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+CycleTrace::~CycleTrace()
+{
+}
+
+std::string
+CycleTrace::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+CycleTrace::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (cycle_) {
+		rapidjson::Value v_cycle;
+		v_cycle.SetInt64(*cycle_);
+		v.AddMember("cycle", v_cycle, allocator);
+	}
+	if (start_) {
+		rapidjson::Value v_start;
+		v_start.SetString(*start_, allocator);
+		v.AddMember("start", v_start, allocator);
+	}
+	if (cycle_time_) {
+		rapidjson::Value v_cycle_time;
+		v_cycle_time.SetFloat(*cycle_time_);
+		v.AddMember("cycle_time", v_cycle_time, allocator);
+	}
+	rapidjson::Value v_hook_times(rapidjson::kArrayType);
+	v_hook_times.Reserve(hook_times_.size(), allocator);
+	for (const auto &e : hook_times_) {
+		rapidjson::Value v;
+		v.SetFloat(e);
+		v_hook_times.PushBack(v, allocator);
+	}
+	v.AddMember("hook_times", v_hook_times, allocator);
+	rapidjson::Value v_threads(rapidjson::kArrayType);
+	v_threads.Reserve(threads_.size(), allocator);
+	for (const auto &e : threads_) {
+		rapidjson::Value v(rapidjson::kObjectType);
+		e->to_json_value(d, v);
+		v_threads.PushBack(v, allocator);
+	}
+	v.AddMember("threads", v_threads, allocator);
+}
+
+void
+CycleTrace::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+CycleTrace::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("cycle") && d["cycle"].IsInt64()) {
+		cycle_ = d["cycle"].GetInt64();
+	}
+	if (d.HasMember("start") && d["start"].IsString()) {
+		start_ = d["start"].GetString();
+	}
+	if (d.HasMember("cycle_time") && d["cycle_time"].IsFloat()) {
+		cycle_time_ = d["cycle_time"].GetFloat();
+	}
+	if (d.HasMember("hook_times") && d["hook_times"].IsArray()) {
+		const rapidjson::Value &a = d["hook_times"];
+		hook_times_               = std::vector<float>{};
+
+		hook_times_.reserve(a.Size());
+		for (auto &v : a.GetArray()) {
+			hook_times_.push_back(v.GetFloat());
+		}
+	}
+	if (d.HasMember("threads") && d["threads"].IsArray()) {
+		const rapidjson::Value &a = d["threads"];
+		threads_                  = std::vector<std::shared_ptr<ThreadSample>>{};
+
+		threads_.reserve(a.Size());
+		for (auto &v : a.GetArray()) {
+			std::shared_ptr<ThreadSample> nv{new ThreadSample()};
+			nv->from_json_value(v);
+			threads_.push_back(std::move(nv));
+		}
+	}
+}
+
+void
+CycleTrace::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!cycle_) {
+		missing.push_back("cycle");
+	}
+	if (!start_) {
+		missing.push_back("start");
+	}
+	if (!cycle_time_) {
+		missing.push_back("cycle_time");
+	}
+	for (size_t i = 0; i < threads_.size(); ++i) {
+		if (!threads_[i]) {
+			missing.push_back("threads[" + std::to_string(i) + "]");
+		} else {
+			try {
+				threads_[i]->validate(true);
+			} catch (std::vector<std::string> &subcall_missing) {
+				for (const auto &s : subcall_missing) {
+					missing.push_back("threads[" + std::to_string(i) + "]." + s);
+				}
+			}
+		}
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("CycleTrace is missing " + s);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+
+/****************************************************************************
+ *  Profiler -- Schema CycleTrace
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#pragma once
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include "ThreadSample.h"
+
+#include <rapidjson/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** CycleTrace representation for JSON transfer. */
+class CycleTrace
+{
+public:
+	/** Constructor. */
+	CycleTrace();
+	/** Constructor from JSON.
+	 * @param json JSON string to initialize from
+	 */
+	CycleTrace(const std::string &json);
+	/** Constructor from JSON.
+	 * @param v RapidJSON value object to initialize from.
+	 */
+	CycleTrace(const rapidjson::Value &v);
+
+	/** Destructor. */
+	virtual ~CycleTrace();
+
+	/** Get version of implemented API.
+	 * @return string representation of version
+	 */
+	static std::string
+	api_version()
+	{
+		return "v1beta1";
+	}
+
+	/** Render object to JSON.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return JSON string
+	 */
+	virtual std::string to_json(bool pretty = false) const;
+	/** Render object to JSON.
+	 * @param d RapidJSON document to retrieve allocator from
+	 * @param v RapidJSON value to add data to
+	 */
+	virtual void to_json_value(rapidjson::Document &d, rapidjson::Value &v) const;
+	/** Retrieve data from JSON string.
+	 * @param json JSON representation suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json(const std::string &json);
+	/** Retrieve data from JSON string.
+	 * @param v RapidJSON value suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json_value(const rapidjson::Value &v);
+
+	/** Validate if all required fields have been set.
+	 * @param subcall true if this is called from another class, e.g.,
+	 * a sub-class or array holder. Will modify the kind of exception thrown.
+	 * @exception std::vector<std::string> thrown if required information is
+	 * missing and @p subcall is set to true. Contains a list of missing fields.
+	 * @exception std::runtime_error informative message describing the missing
+	 * fields
+	 */
+	virtual void validate(bool subcall = false) const;
+
+	// Schema: CycleTrace
+public:
+	/** Get cycle value.
+   * @return cycle value
+   */
+	std::optional<int64_t>
+	cycle() const
+	{
+		return cycle_;
+	}
+
+	/** Set cycle value.
+	 * @param cycle new value
+	 */
+	void
+	set_cycle(const int64_t &cycle)
+	{
+		cycle_ = cycle;
+	}
+	/** Get start value.
+   * @return start value
+   */
+	std::optional<std::string>
+	start() const
+	{
+		return start_;
+	}
+
+	/** Set start value.
+	 * @param start new value
+	 */
+	void
+	set_start(const std::string &start)
+	{
+		start_ = start;
+	}
+	/** Duration of the cycle in ms.
+   * @return cycle_time value
+   */
+	std::optional<float>
+	cycle_time() const
+	{
+		return cycle_time_;
+	}
+
+	/** Set cycle_time value.
+	 * @param cycle_time new value
+	 */
+	void
+	set_cycle_time(const float &cycle_time)
+	{
+		cycle_time_ = cycle_time;
+	}
+	/** Duration of each hook in ms, in hook order.
+   * @return hook_times value
+   */
+	std::vector<float>
+	hook_times() const
+	{
+		return hook_times_;
+	}
+
+	/** Set hook_times value.
+	 * @param hook_times new value
+	 */
+	void
+	set_hook_times(const std::vector<float> &hook_times)
+	{
+		hook_times_ = hook_times;
+	}
+	/** Add element to hook_times array.
+	 * @param hook_times new value
+	 */
+	void
+	addto_hook_times(const float &&hook_times)
+	{
+		hook_times_.push_back(std::move(hook_times));
+	}
+
+	/** Add element to hook_times array.
+	 * The move-semantics version (std::move) should be preferred.
+	 * @param hook_times new value
+	 */
+	void
+	addto_hook_times(const float &hook_times)
+	{
+		hook_times_.push_back(hook_times);
+	}
+	/** Slowest threads of the cycle, slowest first.
+   * @return threads value
+   */
+	std::vector<std::shared_ptr<ThreadSample>>
+	threads() const
+	{
+		return threads_;
+	}
+
+	/** Set threads value.
+	 * @param threads new value
+	 */
+	void
+	set_threads(const std::vector<std::shared_ptr<ThreadSample>> &threads)
+	{
+		threads_ = threads;
+	}
+	/** Add element to threads array.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const std::shared_ptr<ThreadSample> &&threads)
+	{
+		threads_.push_back(std::move(threads));
+	}
+
+	/** Add element to threads array.
+	 * The move-semantics version (std::move) should be preferred.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const std::shared_ptr<ThreadSample> &threads)
+	{
+		threads_.push_back(threads);
+	}
+	/** Add element to threads array.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const ThreadSample &&threads)
+	{
+		threads_.push_back(std::make_shared<ThreadSample>(std::move(threads)));
+	}
+
+private:
+	std::optional<int64_t>                     cycle_;
+	std::optional<std::string>                 start_;
+	std::optional<float>                       cycle_time_;
+	std::vector<float>                         hook_times_;
+	std::vector<std::shared_ptr<ThreadSample>> threads_;
+};
\ No newline at end of file
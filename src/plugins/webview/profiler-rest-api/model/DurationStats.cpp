@@ -0,0 +1,168 @@
+
+/****************************************************************************
+ *  DurationStats
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "DurationStats.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+DurationStats::DurationStats()
+{
+}
+
+DurationStats::DurationStats(const std::string &json)
+{
+	from_json(json);
+}
+
+DurationStats::DurationStats(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+DurationStats::~DurationStats()
+{
+}
+
+std::string
+DurationStats::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+DurationStats::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (count_) {
+		rapidjson::Value v_count;
+		v_count.SetInt64(*count_);
+		v.AddMember("count", v_count, allocator);
+	}
+	if (mean_) {
+		rapidjson::Value v_mean;
+		v_mean.SetFloat(*mean_);
+		v.AddMember("mean", v_mean, allocator);
+	}
+	if (median_) {
+		rapidjson::Value v_median;
+		v_median.SetFloat(*median_);
+		v.AddMember("median", v_median, allocator);
+	}
+	if (p90_) {
+		rapidjson::Value v_p90;
+		v_p90.SetFloat(*p90_);
+		v.AddMember("p90", v_p90, allocator);
+	}
+	if (p99_) {
+		rapidjson::Value v_p99;
+		v_p99.SetFloat(*p99_);
+		v.AddMember("p99", v_p99, allocator);
+	}
+	if (max_) {
+		rapidjson::Value v_max;
+		v_max.SetFloat(*max_);
+		v.AddMember("max", v_max, allocator);
+	}
+}
+
+void
+DurationStats::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+DurationStats::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("count") && d["count"].IsInt64()) {
+		count_ = d["count"].GetInt64();
+	}
+	if (d.HasMember("mean") && d["mean"].IsFloat()) {
+		mean_ = d["mean"].GetFloat();
+	}
+	if (d.HasMember("median") && d["median"].IsFloat()) {
+		median_ = d["median"].GetFloat();
+	}
+	if (d.HasMember("p90") && d["p90"].IsFloat()) {
+		p90_ = d["p90"].GetFloat();
+	}
+	if (d.HasMember("p99") && d["p99"].IsFloat()) {
+		p99_ = d["p99"].GetFloat();
+	}
+	if (d.HasMember("max") && d["max"].IsFloat()) {
+		max_ = d["max"].GetFloat();
+	}
+}
+
+void
+DurationStats::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!count_) {
+		missing.push_back("count");
+	}
+	if (!mean_) {
+		missing.push_back("mean");
+	}
+	if (!median_) {
+		missing.push_back("median");
+	}
+	if (!p90_) {
+		missing.push_back("p90");
+	}
+	if (!p99_) {
+		missing.push_back("p99");
+	}
+	if (!max_) {
+		missing.push_back("max");
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("DurationStats is missing " + s);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+
+/****************************************************************************
+ *  Profiler -- Schema DurationStats
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#pragma once
+
+#define RAPIDJSON_HAS_STDSTRING 1
+
+#include <rapidjson/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** DurationStats representation for JSON transfer. */
+class DurationStats
+{
+public:
+	/** Constructor. */
+	DurationStats();
+	/** Constructor from JSON.
+	 * @param json JSON string to initialize from
+	 */
+	DurationStats(const std::string &json);
+	/** Constructor from JSON.
+	 * @param v RapidJSON value object to initialize from.
+	 */
+	DurationStats(const rapidjson::Value &v);
+
+	/** Destructor. */
+	virtual ~DurationStats();
+
+	/** Get version of implemented API.
+	 * @return string representation of version
+	 */
+	static std::string
+	api_version()
+	{
+		return "v1beta1";
+	}
+
+	/** Render object to JSON.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return JSON string
+	 */
+	virtual std::string to_json(bool pretty = false) const;
+	/** Render object to JSON.
+	 * @param d RapidJSON document to retrieve allocator from
+	 * @param v RapidJSON value to add data to
+	 */
+	virtual void to_json_value(rapidjson::Document &d, rapidjson::Value &v) const;
+	/** Retrieve data from JSON string.
+	 * @param json JSON representation suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json(const std::string &json);
+	/** Retrieve data from JSON string.
+	 * @param v RapidJSON value suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json_value(const rapidjson::Value &v);
+
+	/** Validate if all required fields have been set.
+	 * @param subcall true if this is called from another class, e.g.,
+	 * a sub-class or array holder. Will modify the kind of exception thrown.
+	 * @exception std::vector<std::string> thrown if required information is
+	 * missing and @p subcall is set to true. Contains a list of missing fields.
+	 * @exception std::runtime_error informative message describing the missing
+	 * fields
+	 */
+	virtual void validate(bool subcall = false) const;
+
+	// Schema: DurationStats
+public:
+	/** Get count value.
+   * @return count value
+   */
+	std::optional<int64_t>
+	count() const
+	{
+		return count_;
+	}
+
+	/** Set count value.
+	 * @param count new value
+	 */
+	void
+	set_count(const int64_t &count)
+	{
+		count_ = count;
+	}
+	/** Get mean value.
+   * @return mean value
+   */
+	std::optional<float>
+	mean() const
+	{
+		return mean_;
+	}
+
+	/** Set mean value.
+	 * @param mean new value
+	 */
+	void
+	set_mean(const float &mean)
+	{
+		mean_ = mean;
+	}
+	/** Get median value.
+   * @return median value
+   */
+	std::optional<float>
+	median() const
+	{
+		return median_;
+	}
+
+	/** Set median value.
+	 * @param median new value
+	 */
+	void
+	set_median(const float &median)
+	{
+		median_ = median;
+	}
+	/** Get p90 value.
+   * @return p90 value
+   */
+	std::optional<float>
+	p90() const
+	{
+		return p90_;
+	}
+
+	/** Set p90 value.
+	 * @param p90 new value
+	 */
+	void
+	set_p90(const float &p90)
+	{
+		p90_ = p90;
+	}
+	/** Get p99 value.
+   * @return p99 value
+   */
+	std::optional<float>
+	p99() const
+	{
+		return p99_;
+	}
+
+	/** Set p99 value.
+	 * @param p99 new value
+	 */
+	void
+	set_p99(const float &p99)
+	{
+		p99_ = p99;
+	}
+	/** Get max value.
+   * @return max value
+   */
+	std::optional<float>
+	max() const
+	{
+		return max_;
+	}
+
+	/** Set max value.
+	 * @param max new value
+	 */
+	void
+	set_max(const float &max)
+	{
+		max_ = max;
+	}
+
+private:
+	std::optional<int64_t> count_;
+	std::optional<float>   mean_;
+	std::optional<float>   median_;
+	std::optional<float>   p90_;
+	std::optional<float>   p99_;
+	std::optional<float>   max_;
+};
\ No newline at end of file
@@ -0,0 +1,125 @@
+
+/****************************************************************************
+ *  HookProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "HookProfile.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+HookProfile::HookProfile()
+{
+}
+
+HookProfile::HookProfile(const std::string &json)
+{
+	from_json(json);
+}
+
+HookProfile::HookProfile(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+HookProfile::~HookProfile()
+{
+}
+
+std::string
+HookProfile::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+HookProfile::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (name_) {
+		rapidjson::Value v_name;
+		v_name.SetString(*name_, allocator);
+		v.AddMember("name", v_name, allocator);
+	}
+	if (time_) {
+		rapidjson::Value v_time(rapidjson::kObjectType);
+		time_->to_json_value(d, v_time);
+		v.AddMember("time", v_time, allocator);
+	}
+}
+
+void
+HookProfile::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+HookProfile::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("name") && d["name"].IsString()) {
+		name_ = d["name"].GetString();
+	}
+	if (d.HasMember("time") && d["time"].IsObject()) {
+		std::shared_ptr<DurationStats> nv{new DurationStats(d["time"])};
+		time_ = std::move(nv);
+	}
+}
+
+void
+HookProfile::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!name_) {
+		missing.push_back("name");
+	}
+	if (!time_) {
+		missing.push_back("time");
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("HookProfile is missing " + s);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+
+/****************************************************************************
+ *  Profiler -- Schema HookProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#pragma once
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include "DurationStats.h"
+
+#include <rapidjson/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** HookProfile representation for JSON transfer. */
+class HookProfile
+{
+public:
+	/** Constructor. */
+	HookProfile();
+	/** Constructor from JSON.
+	 * @param json JSON string to initialize from
+	 */
+	HookProfile(const std::string &json);
+	/** Constructor from JSON.
+	 * @param v RapidJSON value object to initialize from.
+	 */
+	HookProfile(const rapidjson::Value &v);
+
+	/** Destructor. */
+	virtual ~HookProfile();
+
+	/** Get version of implemented API.
+	 * @return string representation of version
+	 */
+	static std::string
+	api_version()
+	{
+		return "v1beta1";
+	}
+
+	/** Render object to JSON.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return JSON string
+	 */
+	virtual std::string to_json(bool pretty = false) const;
+	/** Render object to JSON.
+	 * @param d RapidJSON document to retrieve allocator from
+	 * @param v RapidJSON value to add data to
+	 */
+	virtual void to_json_value(rapidjson::Document &d, rapidjson::Value &v) const;
+	/** Retrieve data from JSON string.
+	 * @param json JSON representation suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json(const std::string &json);
+	/** Retrieve data from JSON string.
+	 * @param v RapidJSON value suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json_value(const rapidjson::Value &v);
+
+	/** Validate if all required fields have been set.
+	 * @param subcall true if this is called from another class, e.g.,
+	 * a sub-class or array holder. Will modify the kind of exception thrown.
+	 * @exception std::vector<std::string> thrown if required information is
+	 * missing and @p subcall is set to true. Contains a list of missing fields.
+	 * @exception std::runtime_error informative message describing the missing
+	 * fields
+	 */
+	virtual void validate(bool subcall = false) const;
+
+	// Schema: HookProfile
+public:
+	/** Get name value.
+   * @return name value
+   */
+	std::optional<std::string>
+	name() const
+	{
+		return name_;
+	}
+
+	/** Set name value.
+	 * @param name new value
+	 */
+	void
+	set_name(const std::string &name)
+	{
+		name_ = name;
+	}
+	/** Get time value.
+   * @return time value
+   */
+	std::shared_ptr<DurationStats>
+	time() const
+	{
+		return time_;
+	}
+
+	/** Set time value.
+	 * @param time new value
+	 */
+	void
+	set_time(const std::shared_ptr<DurationStats> &time)
+	{
+		time_ = time;
+	}
+
+private:
+	std::optional<std::string>     name_;
+	std::shared_ptr<DurationStats> time_;
+};
\ No newline at end of file
@@ -0,0 +1,259 @@
+
+/****************************************************************************
+ *  LoopProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "LoopProfile.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+LoopProfile::LoopProfile()
+{
+}
+
+LoopProfile::LoopProfile(const std::string &json)
+{
+	from_json(json);
+}
+
+LoopProfile::LoopProfile(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+LoopProfile::~LoopProfile()
+{
+}
+
+std::string
+LoopProfile::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+LoopProfile::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (kind_) {
+		rapidjson::Value v_kind;
+		v_kind.SetString(*kind_, allocator);
+		v.AddMember("kind", v_kind, allocator);
+	}
+	if (apiVersion_) {
+		rapidjson::Value v_apiVersion;
+		v_apiVersion.SetString(*apiVersion_, allocator);
+		v.AddMember("apiVersion", v_apiVersion, allocator);
+	}
+	if (cycles_) {
+		rapidjson::Value v_cycles;
+		v_cycles.SetInt64(*cycles_);
+		v.AddMember("cycles", v_cycles, allocator);
+	}
+	if (budget_) {
+		rapidjson::Value v_budget;
+		v_budget.SetFloat(*budget_);
+		v.AddMember("budget", v_budget, allocator);
+	}
+	if (overruns_) {
+		rapidjson::Value v_overruns;
+		v_overruns.SetInt64(*overruns_);
+		v.AddMember("overruns", v_overruns, allocator);
+	}
+	if (cycle_time_) {
+		rapidjson::Value v_cycle_time(rapidjson::kObjectType);
+		cycle_time_->to_json_value(d, v_cycle_time);
+		v.AddMember("cycle_time", v_cycle_time, allocator);
+	}
+	rapidjson::Value v_hooks(rapidjson::kArrayType);
+	v_hooks.Reserve(hooks_.size(), allocator);
+	for (const auto &e : hooks_) {
+		rapidjson::Value v(rapidjson::kObjectType);
+		e->to_json_value(d, v);
+		v_hooks.PushBack(v, allocator);
+	}
+	v.AddMember("hooks", v_hooks, allocator);
+	rapidjson::Value v_threads(rapidjson::kArrayType);
+	v_threads.Reserve(threads_.size(), allocator);
+	for (const auto &e : threads_) {
+		rapidjson::Value v(rapidjson::kObjectType);
+		e->to_json_value(d, v);
+		v_threads.PushBack(v, allocator);
+	}
+	v.AddMember("threads", v_threads, allocator);
+	rapidjson::Value v_worst_cycles(rapidjson::kArrayType);
+	v_worst_cycles.Reserve(worst_cycles_.size(), allocator);
+	for (const auto &e : worst_cycles_) {
+		rapidjson::Value v(rapidjson::kObjectType);
+		e->to_json_value(d, v);
+		v_worst_cycles.PushBack(v, allocator);
+	}
+	v.AddMember("worst_cycles", v_worst_cycles, allocator);
+}
+
+void
+LoopProfile::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+LoopProfile::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("kind") && d["kind"].IsString()) {
+		kind_ = d["kind"].GetString();
+	}
+	if (d.HasMember("apiVersion") && d["apiVersion"].IsString()) {
+		apiVersion_ = d["apiVersion"].GetString();
+	}
+	if (d.HasMember("cycles") && d["cycles"].IsInt64()) {
+		cycles_ = d["cycles"].GetInt64();
+	}
+	if (d.HasMember("budget") && d["budget"].IsFloat()) {
+		budget_ = d["budget"].GetFloat();
+	}
+	if (d.HasMember("overruns") && d["overruns"].IsInt64()) {
+		overruns_ = d["overruns"].GetInt64();
+	}
+	if (d.HasMember("cycle_time") && d["cycle_time"].IsObject()) {
+		std::shared_ptr<DurationStats> nv{new DurationStats(d["cycle_time"])};
+		cycle_time_ = std::move(nv);
+	}
+	if (d.HasMember("hooks") && d["hooks"].IsArray()) {
+		const rapidjson::Value &a = d["hooks"];
+		hooks_                    = std::vector<std::shared_ptr<HookProfile>>{};
+
+		hooks_.reserve(a.Size());
+		for (auto &v : a.GetArray()) {
+			std::shared_ptr<HookProfile> nv{new HookProfile()};
+			nv->from_json_value(v);
+			hooks_.push_back(std::move(nv));
+		}
+	}
+	if (d.HasMember("threads") && d["threads"].IsArray()) {
+		const rapidjson::Value &a = d["threads"];
+		threads_                  = std::vector<std::shared_ptr<ThreadProfile>>{};
+
+		threads_.reserve(a.Size());
+		for (auto &v : a.GetArray()) {
+			std::shared_ptr<ThreadProfile> nv{new ThreadProfile()};
+			nv->from_json_value(v);
+			threads_.push_back(std::move(nv));
+		}
+	}
+	if (d.HasMember("worst_cycles") && d["worst_cycles"].IsArray()) {
+		const rapidjson::Value &a = d["worst_cycles"];
+		worst_cycles_             = std::vector<std::shared_ptr<CycleTrace>>{};
+
+		worst_cycles_.reserve(a.Size());
+		for (auto &v : a.GetArray()) {
+			std::shared_ptr<CycleTrace> nv{new CycleTrace()};
+			nv->from_json_value(v);
+			worst_cycles_.push_back(std::move(nv));
+		}
+	}
+}
+
+void
+LoopProfile::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!kind_) {
+		missing.push_back("kind");
+	}
+	if (!apiVersion_) {
+		missing.push_back("apiVersion");
+	}
+	if (!cycles_) {
+		missing.push_back("cycles");
+	}
+	if (!cycle_time_) {
+		missing.push_back("cycle_time");
+	}
+	for (size_t i = 0; i < hooks_.size(); ++i) {
+		if (!hooks_[i]) {
+			missing.push_back("hooks[" + std::to_string(i) + "]");
+		} else {
+			try {
+				hooks_[i]->validate(true);
+			} catch (std::vector<std::string> &subcall_missing) {
+				for (const auto &s : subcall_missing) {
+					missing.push_back("hooks[" + std::to_string(i) + "]." + s);
+				}
+			}
+		}
+	}
+	for (size_t i = 0; i < threads_.size(); ++i) {
+		if (!threads_[i]) {
+			missing.push_back("threads[" + std::to_string(i) + "]");
+		} else {
+			try {
+				threads_[i]->validate(true);
+			} catch (std::vector<std::string> &subcall_missing) {
+				for (const auto &s : subcall_missing) {
+					missing.push_back("threads[" + std::to_string(i) + "]." + s);
+				}
+			}
+		}
+	}
+	for (size_t i = 0; i < worst_cycles_.size(); ++i) {
+		if (!worst_cycles_[i]) {
+			missing.push_back("worst_cycles[" + std::to_string(i) + "]");
+		} else {
+			try {
+				worst_cycles_[i]->validate(true);
+			} catch (std::vector<std::string> &subcall_missing) {
+				for (const auto &s : subcall_missing) {
+					missing.push_back("worst_cycles[" + std::to_string(i) + "]." + s);
+				}
+			}
+		}
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("LoopProfile is missing " + s);
+		}
+	}
+}
\ No newline at end of file
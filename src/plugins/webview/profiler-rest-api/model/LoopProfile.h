@@ -0,0 +1,335 @@
+
+/****************************************************************************
+ *  Profiler -- Schema LoopProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#pragma once
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include "CycleTrace.h"
+#include "DurationStats.h"
+#include "HookProfile.h"
+#include "ThreadProfile.h"
+
+#include <rapidjson/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** LoopProfile representation for JSON transfer. */
+class LoopProfile
+{
+public:
+	/** Constructor. */
+	LoopProfile();
+	/** Constructor from JSON.
+	 * @param json JSON string to initialize from
+	 */
+	LoopProfile(const std::string &json);
+	/** Constructor from JSON.
+	 * @param v RapidJSON value object to initialize from.
+	 */
+	LoopProfile(const rapidjson::Value &v);
+
+	/** Destructor. */
+	virtual ~LoopProfile();
+
+	/** Get version of implemented API.
+	 * @return string representation of version
+	 */
+	static std::string
+	api_version()
+	{
+		return "v1beta1";
+	}
+
+	/** Render object to JSON.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return JSON string
+	 */
+	virtual std::string to_json(bool pretty = false) const;
+	/** Render object to JSON.
+	 * @param d RapidJSON document to retrieve allocator from
+	 * @param v RapidJSON value to add data to
+	 */
+	virtual void to_json_value(rapidjson::Document &d, rapidjson::Value &v) const;
+	/** Retrieve data from JSON string.
+	 * @param json JSON representation suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json(const std::string &json);
+	/** Retrieve data from JSON string.
+	 * @param v RapidJSON value suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json_value(const rapidjson::Value &v);
+
+	/** Validate if all required fields have been set.
+	 * @param subcall true if this is called from another class, e.g.,
+	 * a sub-class or array holder. Will modify the kind of exception thrown.
+	 * @exception std::vector<std::string> thrown if required information is
+	 * missing and @p subcall is set to true. Contains a list of missing fields.
+	 * @exception std::runtime_error informative message describing the missing
+	 * fields
+	 */
+	virtual void validate(bool subcall = false) const;
+
+	// Schema: LoopProfile
+public:
+	/** Get kind value.
+   * @return kind value
+   */
+	std::optional<std::string>
+	kind() const
+	{
+		return kind_;
+	}
+
+	/** Set kind value.
+	 * @param kind new value
+	 */
+	void
+	set_kind(const std::string &kind)
+	{
+		kind_ = kind;
+	}
+	/** Get apiVersion value.
+   * @return apiVersion value
+   */
+	std::optional<std::string>
+	apiVersion() const
+	{
+		return apiVersion_;
+	}
+
+	/** Set apiVersion value.
+	 * @param apiVersion new value
+	 */
+	void
+	set_apiVersion(const std::string &apiVersion)
+	{
+		apiVersion_ = apiVersion;
+	}
+	/** Get cycles value.
+   * @return cycles value
+   */
+	std::optional<int64_t>
+	cycles() const
+	{
+		return cycles_;
+	}
+
+	/** Set cycles value.
+	 * @param cycles new value
+	 */
+	void
+	set_cycles(const int64_t &cycles)
+	{
+		cycles_ = cycles;
+	}
+	/** Desired loop time in ms.
+   * @return budget value
+   */
+	std::optional<float>
+	budget() const
+	{
+		return budget_;
+	}
+
+	/** Set budget value.
+	 * @param budget new value
+	 */
+	void
+	set_budget(const float &budget)
+	{
+		budget_ = budget;
+	}
+	/** Number of cycles exceeding the budget.
+   * @return overruns value
+   */
+	std::optional<int64_t>
+	overruns() const
+	{
+		return overruns_;
+	}
+
+	/** Set overruns value.
+	 * @param overruns new value
+	 */
+	void
+	set_overruns(const int64_t &overruns)
+	{
+		overruns_ = overruns;
+	}
+	/** Get cycle_time value.
+   * @return cycle_time value
+   */
+	std::shared_ptr<DurationStats>
+	cycle_time() const
+	{
+		return cycle_time_;
+	}
+
+	/** Set cycle_time value.
+	 * @param cycle_time new value
+	 */
+	void
+	set_cycle_time(const std::shared_ptr<DurationStats> &cycle_time)
+	{
+		cycle_time_ = cycle_time;
+	}
+	/** Get hooks value.
+   * @return hooks value
+   */
+	std::vector<std::shared_ptr<HookProfile>>
+	hooks() const
+	{
+		return hooks_;
+	}
+
+	/** Set hooks value.
+	 * @param hooks new value
+	 */
+	void
+	set_hooks(const std::vector<std::shared_ptr<HookProfile>> &hooks)
+	{
+		hooks_ = hooks;
+	}
+	/** Add element to hooks array.
+	 * @param hooks new value
+	 */
+	void
+	addto_hooks(const std::shared_ptr<HookProfile> &&hooks)
+	{
+		hooks_.push_back(std::move(hooks));
+	}
+
+	/** Add element to hooks array.
+	 * The move-semantics version (std::move) should be preferred.
+	 * @param hooks new value
+	 */
+	void
+	addto_hooks(const std::shared_ptr<HookProfile> &hooks)
+	{
+		hooks_.push_back(hooks);
+	}
+	/** Add element to hooks array.
+	 * @param hooks new value
+	 */
+	void
+	addto_hooks(const HookProfile &&hooks)
+	{
+		hooks_.push_back(std::make_shared<HookProfile>(std::move(hooks)));
+	}
+	/** Get threads value.
+   * @return threads value
+   */
+	std::vector<std::shared_ptr<ThreadProfile>>
+	threads() const
+	{
+		return threads_;
+	}
+
+	/** Set threads value.
+	 * @param threads new value
+	 */
+	void
+	set_threads(const std::vector<std::shared_ptr<ThreadProfile>> &threads)
+	{
+		threads_ = threads;
+	}
+	/** Add element to threads array.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const std::shared_ptr<ThreadProfile> &&threads)
+	{
+		threads_.push_back(std::move(threads));
+	}
+
+	/** Add element to threads array.
+	 * The move-semantics version (std::move) should be preferred.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const std::shared_ptr<ThreadProfile> &threads)
+	{
+		threads_.push_back(threads);
+	}
+	/** Add element to threads array.
+	 * @param threads new value
+	 */
+	void
+	addto_threads(const ThreadProfile &&threads)
+	{
+		threads_.push_back(std::make_shared<ThreadProfile>(std::move(threads)));
+	}
+	/** Get worst_cycles value.
+   * @return worst_cycles value
+   */
+	std::vector<std::shared_ptr<CycleTrace>>
+	worst_cycles() const
+	{
+		return worst_cycles_;
+	}
+
+	/** Set worst_cycles value.
+	 * @param worst_cycles new value
+	 */
+	void
+	set_worst_cycles(const std::vector<std::shared_ptr<CycleTrace>> &worst_cycles)
+	{
+		worst_cycles_ = worst_cycles;
+	}
+	/** Add element to worst_cycles array.
+	 * @param worst_cycles new value
+	 */
+	void
+	addto_worst_cycles(const std::shared_ptr<CycleTrace> &&worst_cycles)
+	{
+		worst_cycles_.push_back(std::move(worst_cycles));
+	}
+
+	/** Add element to worst_cycles array.
+	 * The move-semantics version (std::move) should be preferred.
+	 * @param worst_cycles new value
+	 */
+	void
+	addto_worst_cycles(const std::shared_ptr<CycleTrace> &worst_cycles)
+	{
+		worst_cycles_.push_back(worst_cycles);
+	}
+	/** Add element to worst_cycles array.
+	 * @param worst_cycles new value
+	 */
+	void
+	addto_worst_cycles(const CycleTrace &&worst_cycles)
+	{
+		worst_cycles_.push_back(std::make_shared<CycleTrace>(std::move(worst_cycles)));
+	}
+
+private:
+	std::optional<std::string>                  kind_;
+	std::optional<std::string>                  apiVersion_;
+	std::optional<int64_t>                      cycles_;
+	std::optional<float>                        budget_;
+	std::optional<int64_t>                      overruns_;
+	std::shared_ptr<DurationStats>              cycle_time_;
+	std::vector<std::shared_ptr<HookProfile>>   hooks_;
+	std::vector<std::shared_ptr<ThreadProfile>> threads_;
+	std::vector<std::shared_ptr<CycleTrace>>    worst_cycles_;
+};
\ No newline at end of file
@@ -0,0 +1,168 @@
+
+/****************************************************************************
+ *  ThreadProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "ThreadProfile.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+ThreadProfile::ThreadProfile()
+{
+}
+
+ThreadProfile::ThreadProfile(const std::string &json)
+{
+	from_json(json);
+}
+
+ThreadProfile::ThreadProfile(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+ThreadProfile::~ThreadProfile()
+{
+}
+
+std::string
+ThreadProfile::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+ThreadProfile::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (name_) {
+		rapidjson::Value v_name;
+		v_name.SetString(*name_, allocator);
+		v.AddMember("name", v_name, allocator);
+	}
+	if (hook_) {
+		rapidjson::Value v_hook;
+		v_hook.SetString(*hook_, allocator);
+		v.AddMember("hook", v_hook, allocator);
+	}
+	if (overruns_) {
+		rapidjson::Value v_overruns;
+		v_overruns.SetInt64(*overruns_);
+		v.AddMember("overruns", v_overruns, allocator);
+	}
+	if (loop_time_) {
+		rapidjson::Value v_loop_time(rapidjson::kObjectType);
+		loop_time_->to_json_value(d, v_loop_time);
+		v.AddMember("loop_time", v_loop_time, allocator);
+	}
+	if (wake_latency_) {
+		rapidjson::Value v_wake_latency(rapidjson::kObjectType);
+		wake_latency_->to_json_value(d, v_wake_latency);
+		v.AddMember("wake_latency", v_wake_latency, allocator);
+	}
+	if (barrier_wait_) {
+		rapidjson::Value v_barrier_wait(rapidjson::kObjectType);
+		barrier_wait_->to_json_value(d, v_barrier_wait);
+		v.AddMember("barrier_wait", v_barrier_wait, allocator);
+	}
+}
+
+void
+ThreadProfile::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+ThreadProfile::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("name") && d["name"].IsString()) {
+		name_ = d["name"].GetString();
+	}
+	if (d.HasMember("hook") && d["hook"].IsString()) {
+		hook_ = d["hook"].GetString();
+	}
+	if (d.HasMember("overruns") && d["overruns"].IsInt64()) {
+		overruns_ = d["overruns"].GetInt64();
+	}
+	if (d.HasMember("loop_time") && d["loop_time"].IsObject()) {
+		std::shared_ptr<DurationStats> nv{new DurationStats(d["loop_time"])};
+		loop_time_ = std::move(nv);
+	}
+	if (d.HasMember("wake_latency") && d["wake_latency"].IsObject()) {
+		std::shared_ptr<DurationStats> nv{new DurationStats(d["wake_latency"])};
+		wake_latency_ = std::move(nv);
+	}
+	if (d.HasMember("barrier_wait") && d["barrier_wait"].IsObject()) {
+		std::shared_ptr<DurationStats> nv{new DurationStats(d["barrier_wait"])};
+		barrier_wait_ = std::move(nv);
+	}
+}
+
+void
+ThreadProfile::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!name_) {
+		missing.push_back("name");
+	}
+	if (!hook_) {
+		missing.push_back("hook");
+	}
+	if (!loop_time_) {
+		missing.push_back("loop_time");
+	}
+	if (!wake_latency_) {
+		missing.push_back("wake_latency");
+	}
+	if (!barrier_wait_) {
+		missing.push_back("barrier_wait");
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("ThreadProfile is missing " + s);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+
+/****************************************************************************
+ *  Profiler -- Schema ThreadProfile
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#pragma once
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include "DurationStats.h"
+#include "DurationStats.h"
+#include "DurationStats.h"
+
+#include <rapidjson/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** ThreadProfile representation for JSON transfer. */
+class ThreadProfile
+{
+public:
+	/** Constructor. */
+	ThreadProfile();
+	/** Constructor from JSON.
+	 * @param json JSON string to initialize from
+	 */
+	ThreadProfile(const std::string &json);
+	/** Constructor from JSON.
+	 * @param v RapidJSON value object to initialize from.
+	 */
+	ThreadProfile(const rapidjson::Value &v);
+
+	/** Destructor. */
+	virtual ~ThreadProfile();
+
+	/** Get version of implemented API.
+	 * @return string representation of version
+	 */
+	static std::string
+	api_version()
+	{
+		return "v1beta1";
+	}
+
+	/** Render object to JSON.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return JSON string
+	 */
+	virtual std::string to_json(bool pretty = false) const;
+	/** Render object to JSON.
+	 * @param d RapidJSON document to retrieve allocator from
+	 * @param v RapidJSON value to add data to
+	 */
+	virtual void to_json_value(rapidjson::Document &d, rapidjson::Value &v) const;
+	/** Retrieve data from JSON string.
+	 * @param json JSON representation suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json(const std::string &json);
+	/** Retrieve data from JSON string.
+	 * @param v RapidJSON value suitable for this object.
+	 * Will allow partial assignment and not validate automaticaly.
+	 * @see validate()
+	 */
+	virtual void from_json_value(const rapidjson::Value &v);
+
+	/** Validate if all required fields have been set.
+	 * @param subcall true if this is called from another class, e.g.,
+	 * a sub-class or array holder. Will modify the kind of exception thrown.
+	 * @exception std::vector<std::string> thrown if required information is
+	 * missing and @p subcall is set to true. Contains a list of missing fields.
+	 * @exception std::runtime_error informative message describing the missing
+	 * fields
+	 */
+	virtual void validate(bool subcall = false) const;
+
+	// Schema: ThreadProfile
+public:
+	/** Get name value.
+   * @return name value
+   */
+	std::optional<std::string>
+	name() const
+	{
+		return name_;
+	}
+
+	/** Set name value.
+	 * @param name new value
+	 */
+	void
+	set_name(const std::string &name)
+	{
+		name_ = name;
+	}
+	/** Get hook value.
+   * @return hook value
+   */
+	std::optional<std::string>
+	hook() const
+	{
+		return hook_;
+	}
+
+	/** Set hook value.
+	 * @param hook new value
+	 */
+	void
+	set_hook(const std::string &hook)
+	{
+		hook_ = hook;
+	}
+	/** Number of loops exceeding the budget.
+   * @return overruns value
+   */
+	std::optional<int64_t>
+	overruns() const
+	{
+		return overruns_;
+	}
+
+	/** Set overruns value.
+	 * @param overruns new value
+	 */
+	void
+	set_overruns(const int64_t &overruns)
+	{
+		overruns_ = overruns;
+	}
+	/** Get loop_time value.
+   * @return loop_time value
+   */
+	std::shared_ptr<DurationStats>
+	loop_time() const
+	{
+		return loop_time_;
+	}
+
+	/** Set loop_time value.
+	 * @param loop_time new value
+	 */
+	void
+	set_loop_time(const std::shared_ptr<DurationStats> &loop_time)
+	{
+		loop_time_ = loop_time;
+	}
+	/** Get wake_latency value.
+   * @return wake_latency value
+   */
+	std::shared_ptr<DurationStats>
+	wake_latency() const
+	{
+		return wake_latency_;
+	}
+
+	/** Set wake_latency value.
+	 * @param wake_latency new value
+	 */
+	void
+	set_wake_latency(const std::shared_ptr<DurationStats> &wake_latency)
+	{
+		wake_latency_ = wake_latency;
+	}
+	/** Get barrier_wait value.
+   * @return barrier_wait value
+   */
+	std::shared_ptr<DurationStats>
+	barrier_wait() const
+	{
+		return barrier_wait_;
+	}
+
+	/** Set barrier_wait value.
+	 * @param barrier_wait new value
+	 */
+	void
+	set_barrier_wait(const std::shared_ptr<DurationStats> &barrier_wait)
+	{
+		barrier_wait_ = barrier_wait;
+	}
+
+private:
+	std::optional<std::string>     name_;
+	std::optional<std::string>     hook_;
+	std::optional<int64_t>         overruns_;
+	std::shared_ptr<DurationStats> loop_time_;
+	std::shared_ptr<DurationStats> wake_latency_;
+	std::shared_ptr<DurationStats> barrier_wait_;
+};
\ No newline at end of file
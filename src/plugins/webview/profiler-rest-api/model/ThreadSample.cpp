@@ -0,0 +1,146 @@
+
+/****************************************************************************
+ *  ThreadSample
+ *  (auto-generated, do not modify directly)
+ *
+ *  Fawkes Main Loop Profiler REST API.
+ *  Timing statistics of the main loop and of all threads with the
+ *  BlockedTimingAspect, and traces of the slowest main loop cycles.
+ *
+ *  API Contact: Tim Niemueller <niemueller@kbsg.rwth-aachen.de>
+ *  API Version: v1beta1
+ *  API License: Apache 2.0
+ ****************************************************************************/
+
+#include "ThreadSample.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sstream>
+
+ThreadSample::ThreadSample()
+{
+}
+
+ThreadSample::ThreadSample(const std::string &json)
+{
+	from_json(json);
+}
+
+ThreadSample::ThreadSample(const rapidjson::Value &v)
+{
+	from_json_value(v);
+}
+
+ThreadSample::~ThreadSample()
+{
+}
+
+std::string
+ThreadSample::to_json(bool pretty) const
+{
+	rapidjson::Document d;
+
+	to_json_value(d, d);
+
+	rapidjson::StringBuffer buffer;
+	if (pretty) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		d.Accept(writer);
+	}
+
+	return buffer.GetString();
+}
+
+void
+ThreadSample::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
+{
+	rapidjson::Document::AllocatorType &allocator = d.GetAllocator();
+	v.SetObject();
+	// Avoid unused variable warnings
+	(void)allocator;
+
+	if (name_) {
+		rapidjson::Value v_name;
+		v_name.SetString(*name_, allocator);
+		v.AddMember("name", v_name, allocator);
+	}
+	if (hook_) {
+		rapidjson::Value v_hook;
+		v_hook.SetString(*hook_, allocator);
+		v.AddMember("hook", v_hook, allocator);
+	}
+	if (loop_time_) {
+		rapidjson::Value v_loop_time;
+		v_loop_time.SetFloat(*loop_time_);
+		v.AddMember("loop_time", v_loop_time, allocator);
+	}
+	if (finished_) {
+		rapidjson::Value v_finished;
+		v_finished.SetBool(*finished_);
+		v.AddMember("finished", v_finished, allocator);
+	}
+}
+
+void
+ThreadSample::from_json(const std::string &json)
+{
+	rapidjson::Document d;
+	d.Parse(json);
+
+	from_json_value(d);
+}
+
+void
+ThreadSample::from_json_value(const rapidjson::Value &d)
+{
+	if (d.HasMember("name") && d["name"].IsString()) {
+		name_ = d["name"].GetString();
+	}
+	if (d.HasMember("hook") && d["hook"].IsString()) {
+		hook_ = d["hook"].GetString();
+	}
+	if (d.HasMember("loop_time") && d["loop_time"].IsFloat()) {
+		loop_time_ = d["loop_time"].GetFloat();
+	}
+	if (d.HasMember("finished") && d["finished"].IsBool()) {
+		finished_ = d["finished"].GetBool();
+	}
+}
+
+void
+ThreadSample::validate(bool subcall) const
+{
+	std::vector<std::string> missing;
+	if (!name_) {
+		missing.push_back("name");
+	}
+	if (!hook_) {
+		missing.push_back("hook");
+	}
+	if (!loop_time_) {
+		missing.push_back("loop_time");
+	}
+	if (!finished_) {
+		missing.push_back("finished");
+	}
+
+	if (!missing.empty()) {
+		if (subcall) {
+			throw missing;
+		} else {
+			std::string s =
+			  std::accumulate(std::next(missing.begin()),
+			                  missing.end(),
+			                  missing.front(),
+			                  [](std::string &s, const std::string &n) { return s + ", " + n; });
+			throw std::runtime_error("ThreadSample is missing " + s);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/***************************************************************************
+ *  profiler-rest-api.cpp -  Main Loop Profiler REST API
+ *
+ *  Created: Mon Oct 19 13:12:09 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "profiler-rest-api.h"
+
+#include <utils/time/latency_histogram.h>
+#include <utils/time/time.h>
+#include <webview/rest_api_manager.h>
+
+using namespace fawkes;
+
+/** @class ProfilerRestApi "profiler-rest-api.h"
+ * REST API backend for the main loop profiler.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+ProfilerRestApi::ProfilerRestApi() : Thread("ProfilerRestApi", Thread::OPMODE_WAITFORWAKEUP)
+{
+}
+
+/** Destructor. */
+ProfilerRestApi::~ProfilerRestApi()
+{
+}
+
+void
+ProfilerRestApi::init()
+{
+	budget_usec_ = 0;
+	try {
+		budget_usec_ = config->get_uint("/fawkes/mainapp/desired_loop_time");
+	} catch (Exception &e) {
+	} // ignored, no budget
+
+	rest_api_ = new WebviewRestApi("profiler", logger);
+	rest_api_->add_handler<LoopProfile>(WebRequest::METHOD_GET,
+	                                    "/?",
+	                                    std::bind(&ProfilerRestApi::cb_get_profile, this));
+	rest_api_->add_handler<LoopProfile>(WebRequest::METHOD_POST,
+	                                    "/reset",
+	                                    std::bind(&ProfilerRestApi::cb_reset_profile, this));
+	webview_rest_api_manager->register_api(rest_api_);
+}
+
+void
+ProfilerRestApi::finalize()
+{
+	webview_rest_api_manager->unregister_api(rest_api_);
+	delete rest_api_;
+}
+
+void
+ProfilerRestApi::loop()
+{
+}
+
+DurationStats
+ProfilerRestApi::duration_stats(const LatencyHistogram &histogram)
+{
+	DurationStats s;
+	s.set_count(histogram.count());
+	s.set_mean(histogram.mean() / 1000.);
+	s.set_median(histogram.percentile(50.) / 1000.);
+	s.set_p90(histogram.percentile(90.) / 1000.);
+	s.set_p99(histogram.percentile(99.) / 1000.);
+	s.set_max(histogram.max() / 1000.);
+	return s;
+}
+
+LoopProfile
+ProfilerRestApi::cb_get_profile()
+{
+	LoopProfile profile;
+	profile.set_kind("LoopProfile");
+	profile.set_apiVersion(LoopProfile::api_version());
+
+	LatencyHistogram cycle_time = blocked_timing_profiler->cycle_time();
+	profile.set_cycles(cycle_time.count());
+	profile.set_cycle_time(std::make_shared<DurationStats>(duration_stats(cycle_time)));
+	if (budget_usec_ > 0) {
+		profile.set_budget(budget_usec_ / 1000.);
+		profile.set_overruns(cycle_time.count_above(budget_usec_));
+	}
+
+	for (unsigned int i = 0; i < BlockedTimingProfiler::NUM_HOOKS; ++i) {
+		BlockedTimingAspect::WakeupHook hook = (BlockedTimingAspect::WakeupHook)i;
+		HookProfile                     h;
+		h.set_name(BlockedTimingAspect::blocked_timing_hook_to_string(hook));
+		h.set_time(
+		  std::make_shared<DurationStats>(duration_stats(blocked_timing_profiler->hook_time(hook))));
+		profile.addto_hooks(std::move(h));
+	}
+
+	for (const auto &p : blocked_timing_profiler->thread_profiles()) {
+		ThreadProfile t;
+		t.set_name(p.name());
+		t.set_hook(BlockedTimingAspect::blocked_timing_hook_to_string(p.hook()));
+		if (budget_usec_ > 0) {
+			t.set_overruns(p.loop_time().count_above(budget_usec_));
+		}
+		t.set_loop_time(std::make_shared<DurationStats>(duration_stats(p.loop_time())));
+		t.set_wake_latency(std::make_shared<DurationStats>(duration_stats(p.wake_latency())));
+		t.set_barrier_wait(std::make_shared<DurationStats>(duration_stats(p.barrier_wait())));
+		profile.addto_threads(std::move(t));
+	}
+
+	for (const auto &c : blocked_timing_profiler->worst_cycles()) {
+		CycleTrace trace;
+		trace.set_cycle(c.cycle);
+		trace.set_start(Time(&c.start).str());
+		trace.set_cycle_time(c.cycle_usec / 1000.);
+		for (unsigned int i = 0; i < BlockedTimingProfiler::NUM_HOOKS; ++i) {
+			trace.addto_hook_times(c.hook_usec[i] / 1000.);
+		}
+		for (const auto &s : c.threads) {
+			ThreadSample sample;
+			sample.set_name(s.thread);
+			sample.set_hook(BlockedTimingAspect::blocked_timing_hook_to_string(s.hook));
+			sample.set_loop_time(s.loop_usec / 1000.);
+			sample.set_finished(s.finished);
+			trace.addto_threads(std::move(sample));
+		}
+		profile.addto_worst_cycles(std::move(trace));
+	}
+
+	return profile;
+}
+
+LoopProfile
+ProfilerRestApi::cb_reset_profile()
+{
+	logger->log_info(name(), "Resetting main loop profile");
+	blocked_timing_profiler->reset();
+	return cb_get_profile();
+}
@@ -0,0 +1,59 @@
+/***************************************************************************
+ *  profiler-rest-api.h -  Main Loop Profiler REST API
+ *
+ *  Created: Mon Oct 19 13:12:09 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#pragma once
+
+#include "model/LoopProfile.h"
+
+#include <aspect/blocked_timing_profiler.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <aspect/webview.h>
+#include <core/threading/thread.h>
+#include <webview/rest_api.h>
+
+namespace fawkes {
+class LatencyHistogram;
+}
+
+class ProfilerRestApi : public fawkes::Thread,
+                        public fawkes::ConfigurableAspect,
+                        public fawkes::LoggingAspect,
+                        public fawkes::WebviewAspect,
+                        public fawkes::BlockedTimingProfilerAspect
+{
+public:
+	ProfilerRestApi();
+	~ProfilerRestApi();
+
+	virtual void init();
+	virtual void loop();
+	virtual void finalize();
+
+private:
+	LoopProfile cb_get_profile();
+	LoopProfile cb_reset_profile();
+
+	static DurationStats duration_stats(const fawkes::LatencyHistogram &histogram);
+
+private:
+	fawkes::WebviewRestApi *rest_api_;
+	unsigned int            budget_usec_;
+};